@@ -11,6 +11,7 @@
 #include "Core/Env/Types.h"
 #include "Core/Math/Conversions.h"
 #include "Core/Mem/Mem.h"
+#include "Core/Mem/MemArena.h"
 
 // Array
 //------------------------------------------------------------------------------
@@ -51,6 +52,10 @@ public:
     void Clear();
     void Swap( Array< T > & other );
 
+    // Allocate from the calling thread's MemArena (when there is one) from now on
+    // (NOTE: The Array must not outlive the MemArenaScope)
+    inline void UseThreadArena() { m_CapacityAndFlags |= USE_THREAD_ARENA_FLAG; }
+
     // sorting
     void Sort() { ShellSort( m_Begin, m_Begin + m_Size, AscendingCompare() ); }
     void SortDeref() { ShellSort( m_Begin, m_Begin + m_Size, AscendingCompareDeref() ); }
@@ -94,15 +99,18 @@ public:
 
 protected:
     void Grow();
-    inline T * Allocate( size_t numElements ) const;
+    inline T * Allocate( size_t numElements, uint32_t & outCapacityAndFlags ) const;
     inline void Deallocate( T * ptr ) const;
 
     // High bit of Capacity is set when memory should not be freed
-    // (allocated on the stack for example)
+    // (allocated on the stack or from a MemArena for example)
+    // Next bit is set when allocations should come from the thread's MemArena
+    // (this belongs to the Array and is not transferred when moving memory)
     enum : uint32_t
     {
         DO_NOT_FREE_MEMORY_FLAG = 0x80000000,
-        CAPACITY_MASK = 0x7FFFFFFF,
+        USE_THREAD_ARENA_FLAG = 0x40000000,
+        CAPACITY_MASK = 0x3FFFFFFF,
     };
 
     T *         m_Begin;
@@ -163,12 +171,12 @@ Array< T >::Array( Array< T > && other )
         // Move
         m_Begin = other.m_Begin;
         m_Size = other.m_Size;
-        m_CapacityAndFlags = other.m_CapacityAndFlags;
+        m_CapacityAndFlags = ( other.m_CapacityAndFlags & ~USE_THREAD_ARENA_FLAG );
 
         // Clear other
         other.m_Begin = nullptr;
         other.m_Size = 0;
-        other.m_CapacityAndFlags = 0;
+        other.m_CapacityAndFlags &= USE_THREAD_ARENA_FLAG;
     }
 }
 
@@ -191,9 +199,9 @@ Array< T >::Array( size_t initialCapacity, bool resizeable )
         #if defined( ASSERTS_ENABLED )
             m_Resizeable = true; // allow initial allocation
         #endif
-        m_Begin = Allocate( initialCapacity );
+        m_CapacityAndFlags = 0;
+        m_Begin = Allocate( initialCapacity, m_CapacityAndFlags );
         m_Size = 0;
-        m_CapacityAndFlags = (uint32_t)initialCapacity;
     }
     else
     {
@@ -238,7 +246,7 @@ void Array< T >::Destruct()
     Deallocate( m_Begin );
     m_Begin = nullptr;
     m_Size = 0;
-    m_CapacityAndFlags = 0;
+    m_CapacityAndFlags &= USE_THREAD_ARENA_FLAG;
 }
 
 // SetCapacity
@@ -251,7 +259,8 @@ void Array< T >::SetCapacity( size_t capacity )
         return;
     }
 
-    T * newMem = Allocate( capacity );
+    uint32_t newCapacityAndFlags;
+    T * newMem = Allocate( capacity, newCapacityAndFlags );
 
     // transfer and items across and destroy all the originals
     T * src = m_Begin;
@@ -270,7 +279,7 @@ void Array< T >::SetCapacity( size_t capacity )
 
     // hook up to new memory
     m_Begin = newMem;
-    m_CapacityAndFlags = (uint32_t)capacity;
+    m_CapacityAndFlags = newCapacityAndFlags;
 }
 
 // SetSize
@@ -347,6 +356,10 @@ void Array< T >::Swap( Array< T > & other )
     ASSERT( ( m_CapacityAndFlags & DO_NOT_FREE_MEMORY_FLAG ) == 0 );
     ASSERT( ( other.m_CapacityAndFlags & DO_NOT_FREE_MEMORY_FLAG ) == 0 );
 
+    // Arena use belongs to each array rather than the memory
+    const uint32_t arenaFlag = ( m_CapacityAndFlags & USE_THREAD_ARENA_FLAG );
+    const uint32_t otherArenaFlag = ( other.m_CapacityAndFlags & USE_THREAD_ARENA_FLAG );
+
     T * tmpBegin = m_Begin;
     uint32_t tmpSize = m_Size;
     uint32_t tmpCapacityAndFlags = m_CapacityAndFlags;
@@ -355,13 +368,13 @@ void Array< T >::Swap( Array< T > & other )
     #endif
     m_Begin = other.m_Begin;
     m_Size = other.m_Size;
-    m_CapacityAndFlags = other.m_CapacityAndFlags;
+    m_CapacityAndFlags = ( ( other.m_CapacityAndFlags & ~USE_THREAD_ARENA_FLAG ) | arenaFlag );
     #if defined( ASSERTS_ENABLED )
         m_Resizeable = other.m_Resizeable;
     #endif
     other.m_Begin = tmpBegin;
     other.m_Size = tmpSize;
-    other.m_CapacityAndFlags = tmpCapacityAndFlags;
+    other.m_CapacityAndFlags = ( ( tmpCapacityAndFlags & ~USE_THREAD_ARENA_FLAG ) | otherArenaFlag );
     #if defined( ASSERTS_ENABLED )
         other.m_Resizeable = tmpResizeable;
     #endif
@@ -573,8 +586,7 @@ Array< T > & Array< T >::operator = ( const Array< T > & other )
     if ( GetCapacity() < otherSize )
     {
         Deallocate( m_Begin );
-        m_Begin = Allocate( otherSize );
-        m_CapacityAndFlags = (uint32_t)otherSize;
+        m_Begin = Allocate( otherSize, m_CapacityAndFlags );
     }
 
     m_Size = (uint32_t)otherSize;
@@ -611,8 +623,7 @@ Array< T > & Array< T >::operator = ( Array< T > && other )
         if ( GetCapacity() < otherSize )
         {
             Deallocate( m_Begin );
-            m_Begin = Allocate( otherSize );
-            m_CapacityAndFlags = (uint32_t)otherSize;
+            m_Begin = Allocate( otherSize, m_CapacityAndFlags );
         }
 
         // Move elements
@@ -634,18 +645,19 @@ Array< T > & Array< T >::operator = ( Array< T > && other )
     else
     {
         // Move
+        const uint32_t arenaFlag = ( m_CapacityAndFlags & USE_THREAD_ARENA_FLAG );
         if ( ( m_CapacityAndFlags & DO_NOT_FREE_MEMORY_FLAG ) == 0 )
         {
             Destruct(); // Free our own memory
         }
         m_Begin = other.m_Begin;
         m_Size = other.m_Size;
-        m_CapacityAndFlags = other.m_CapacityAndFlags;
+        m_CapacityAndFlags = ( ( other.m_CapacityAndFlags & ~USE_THREAD_ARENA_FLAG ) | arenaFlag );
 
         // Clear other as we now own the memory
         other.m_Begin = nullptr;
         other.m_Size = 0;
-        other.m_CapacityAndFlags = 0;
+        other.m_CapacityAndFlags &= USE_THREAD_ARENA_FLAG;
     }
 
     return *this;
@@ -662,7 +674,8 @@ void Array< T >::Grow()
     size_t currentCapacity = GetCapacity();
     size_t size = GetSize();
     size_t newCapacity = ( currentCapacity + ( currentCapacity >> 1 ) + 1 );
-    T * newMem = Allocate( newCapacity );
+    uint32_t newCapacityAndFlags;
+    T * newMem = Allocate( newCapacity, newCapacityAndFlags );
 
     T * src = m_Begin;
     T * dst = newMem;
@@ -677,16 +690,28 @@ void Array< T >::Grow()
     Deallocate( m_Begin );
     m_Begin = newMem;
     m_Size = (uint32_t)size;
-    m_CapacityAndFlags = (uint32_t)newCapacity;
+    m_CapacityAndFlags = newCapacityAndFlags;
 }
 
 // Allocate
 //------------------------------------------------------------------------------
 template < class T >
-T * Array< T >::Allocate( size_t numElements ) const
+T * Array< T >::Allocate( size_t numElements, uint32_t & outCapacityAndFlags ) const
 {
     ASSERT( m_Resizeable );
+    ASSERT( numElements <= CAPACITY_MASK );
     const size_t align = __alignof( T ) > sizeof( void * ) ? __alignof( T ) : sizeof( void * );
+    const uint32_t arenaFlag = ( m_CapacityAndFlags & USE_THREAD_ARENA_FLAG );
+    if ( arenaFlag )
+    {
+        MemArena * arena = MemArena::GetThreadArena();
+        if ( arena )
+        {
+            outCapacityAndFlags = ( (uint32_t)numElements | arenaFlag | DO_NOT_FREE_MEMORY_FLAG );
+            return static_cast< T * >( arena->Alloc( sizeof( T ) * numElements, align ) );
+        }
+    }
+    outCapacityAndFlags = ( (uint32_t)numElements | arenaFlag );
     return static_cast< T * >( ALLOC( sizeof( T ) * numElements, align ) );
 }
 
@@ -18,9 +18,13 @@ int main( int, char *[] )
     REGISTER_TESTGROUP( TestFileStream )
     REGISTER_TESTGROUP( TestHash )
     REGISTER_TESTGROUP( TestLevenshteinDistance )
+    REGISTER_TESTGROUP( TestMappedFile )
+    REGISTER_TESTGROUP( TestMemArena )
     REGISTER_TESTGROUP( TestMemPoolBlock )
     REGISTER_TESTGROUP( TestMutex )
     REGISTER_TESTGROUP( TestPathUtils )
+    REGISTER_TESTGROUP( TestProcess )
+    REGISTER_TESTGROUP( TestProfile )
     REGISTER_TESTGROUP( TestReflection )
     REGISTER_TESTGROUP( TestSemaphore )
     REGISTER_TESTGROUP( TestSharedMemory )
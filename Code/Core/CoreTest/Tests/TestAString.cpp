@@ -42,6 +42,7 @@ private:
     void TrimEnd() const;
     void MoveConstructor() const;
     void MoveAssignment() const;
+    void ShortStrings() const;
 
     // Helpers
     template <class SRC, class DST, uint32_t EXPECTED_ALLOCS, class SRC_CAST = SRC>
@@ -77,6 +78,7 @@ REGISTER_TESTS_BEGIN( TestAString )
     REGISTER_TEST( TrimEnd )
     REGISTER_TEST( MoveConstructor )
     REGISTER_TEST( MoveAssignment )
+    REGISTER_TEST( ShortStrings )
 REGISTER_TESTS_END
 
 // AStringConstructors
@@ -100,18 +102,41 @@ void TestAString::AStringConstructors() const
         TEST_ASSERT( empty.MemoryMustBeFreed() == true );
     }
     {
-        // AString from char *
+        // AString with small reserve capacity argument (stored inline)
+        AString empty( 4 );
+        TEST_ASSERT( empty.GetLength() == 0 );
+        TEST_ASSERT( empty.GetReserved() >= 4 );
+        TEST_ASSERT( empty.IsEmpty() == true );
+        TEST_ASSERT( empty.MemoryMustBeFreed() == false );
+    }
+    {
+        // AString from char * (short strings are stored inline)
         AString fromCharStar( "hello" );
         TEST_ASSERT( fromCharStar.GetLength() == 5 );
         TEST_ASSERT( fromCharStar.GetReserved() >= 5 );
         TEST_ASSERT( fromCharStar.IsEmpty() == false );
-        TEST_ASSERT( fromCharStar.MemoryMustBeFreed() == true );
+        TEST_ASSERT( fromCharStar.MemoryMustBeFreed() == false );
 
         // AString from AString
         AString fromAString( fromCharStar );
         TEST_ASSERT( fromAString.GetLength() == 5 );
         TEST_ASSERT( fromAString.GetReserved() >= 5 );
         TEST_ASSERT( fromAString.IsEmpty() == false );
+        TEST_ASSERT( fromAString.MemoryMustBeFreed() == false );
+    }
+    {
+        // AString from char * (longer strings are allocated)
+        AString fromCharStar( "hellohellohello" );
+        TEST_ASSERT( fromCharStar.GetLength() == 15 );
+        TEST_ASSERT( fromCharStar.GetReserved() >= 15 );
+        TEST_ASSERT( fromCharStar.IsEmpty() == false );
+        TEST_ASSERT( fromCharStar.MemoryMustBeFreed() == true );
+
+        // AString from AString
+        AString fromAString( fromCharStar );
+        TEST_ASSERT( fromAString.GetLength() == 15 );
+        TEST_ASSERT( fromAString.GetReserved() >= 15 );
+        TEST_ASSERT( fromAString.IsEmpty() == false );
         TEST_ASSERT( fromAString.MemoryMustBeFreed() == true );
     }
     {
@@ -120,7 +145,13 @@ void TestAString::AStringConstructors() const
         TEST_ASSERT( fromCharStarPair.GetLength() == 5 );
         TEST_ASSERT( fromCharStarPair.GetReserved() >= 5 );
         TEST_ASSERT( fromCharStarPair.IsEmpty() == false );
-        TEST_ASSERT( fromCharStarPair.MemoryMustBeFreed() == true );
+        TEST_ASSERT( fromCharStarPair.MemoryMustBeFreed() == false );
+
+        AString fromCharStarPair2( hello, hello + 15 );
+        TEST_ASSERT( fromCharStarPair2.GetLength() == 15 );
+        TEST_ASSERT( fromCharStarPair2.GetReserved() >= 15 );
+        TEST_ASSERT( fromCharStarPair2.IsEmpty() == false );
+        TEST_ASSERT( fromCharStarPair2.MemoryMustBeFreed() == true );
     }
 }
 
@@ -129,27 +160,34 @@ void TestAString::AStringConstructors() const
 void TestAString::AStringAssignment() const
 {
     AString str;
-    str = "test";
-    TEST_ASSERT( str.GetLength() == 4 );
-    TEST_ASSERT( str.GetReserved() >= 4 );
+    str = "test-test-test";
+    TEST_ASSERT( str.GetLength() == 14 );
+    TEST_ASSERT( str.GetReserved() >= 14 );
     TEST_ASSERT( str.IsEmpty() == false );
     TEST_ASSERT( str.MemoryMustBeFreed() == true );
 
     AString str2;
     str2 = str;
-    TEST_ASSERT( str2.GetLength() == 4 );
-    TEST_ASSERT( str2.GetReserved() >= 4 );
+    TEST_ASSERT( str2.GetLength() == 14 );
+    TEST_ASSERT( str2.GetReserved() >= 14 );
     TEST_ASSERT( str2.IsEmpty() == false );
     TEST_ASSERT( str2.MemoryMustBeFreed() == true );
 
     const char * testData = "hellozzzzzzzzz";
     AString str3;
-    str3.Assign( testData, testData + 5 );
-    TEST_ASSERT( str3.GetLength() == 5 );
-    TEST_ASSERT( str3.GetReserved() >= 5 );
+    str3.Assign( testData, testData + 12 );
+    TEST_ASSERT( str3.GetLength() == 12 );
+    TEST_ASSERT( str3.GetReserved() >= 12 );
     TEST_ASSERT( str3.IsEmpty() == false );
     TEST_ASSERT( str3.MemoryMustBeFreed() == true );
 
+    // short strings are stored inline
+    AString str4;
+    str4.Assign( testData, testData + 5 );
+    TEST_ASSERT( str4.GetLength() == 5 );
+    TEST_ASSERT( str4 == "hello" );
+    TEST_ASSERT( str4.MemoryMustBeFreed() == false );
+
     // assign empty
     {
         AString dst;
@@ -270,6 +308,39 @@ void TestAString::Compare() const
     TEST_ASSERT( 0 == str.CompareI( AStackString<>( "hEllO" ) ) );
     TEST_ASSERT( 0 != str.CompareI( "goodbye" ) );
     TEST_ASSERT( 0 != str.CompareI( AStackString<>( "goodbye" ) ) );
+
+    // Long strings, with differences at every position
+    const AStackString<> longStr( "Engine/Source/Runtime/Core/Public/CoreMinimal.h" );
+    AStackString<> upper( longStr );
+    upper.ToUpper();
+    AStackString<> lower( longStr );
+    lower.ToLower();
+    TEST_ASSERT( lower == "engine/source/runtime/core/public/coreminimal.h" );
+    TEST_ASSERT( 0 == longStr.CompareI( upper ) );
+    TEST_ASSERT( longStr.EqualsI( upper ) );
+    TEST_ASSERT( longStr.BeginsWithI( upper ) );
+    TEST_ASSERT( longStr.EndsWithI( upper ) );
+    for ( uint32_t i = 0; i < longStr.GetLength(); ++i )
+    {
+        AStackString<> other( longStr );
+        other[ i ] = '~'; // sorts after all other characters in the string
+        TEST_ASSERT( longStr.CompareI( other ) < 0 );
+        TEST_ASSERT( other.CompareI( longStr ) > 0 );
+        TEST_ASSERT( longStr.EqualsI( other ) == false );
+        TEST_ASSERT( ( longStr == other ) == false );
+        TEST_ASSERT( longStr.BeginsWith( other ) == false );
+        TEST_ASSERT( longStr.BeginsWithI( other ) == false );
+        TEST_ASSERT( longStr.EndsWith( other ) == false );
+        TEST_ASSERT( longStr.EndsWithI( other ) == false );
+
+        // Prefixes and suffixes of every length
+        AStackString<> prefix( longStr.Get(), longStr.Get() + i );
+        TEST_ASSERT( longStr.CompareI( prefix ) > 0 );
+        TEST_ASSERT( prefix.CompareI( longStr ) < 0 );
+        TEST_ASSERT( upper.BeginsWithI( prefix ) );
+        AStackString<> suffix( longStr.Get() + i );
+        TEST_ASSERT( upper.EndsWithI( suffix ) );
+    }
 }
 
 // Concatenation
@@ -837,7 +908,7 @@ template <class SRC, class DST, uint32_t EXPECTED_ALLOCS, class SRC_CAST>
 void TestAString::MoveConstructorHelper() const
 {
     // Create the source string
-    SRC stringA( "string" );
+    SRC stringA( "string too long to be inline" );
 
     // Take note of memory state before
     TEST_MEMORY_SNAPSHOT( s1 );
@@ -880,7 +951,7 @@ void TestAString::MoveAssignmentHelper() const
     // Empty destination
     {
         // Create the source string
-        SRC stringA( "string" );
+        SRC stringA( "string too long to be inline" );
 
         // Create the destination
         DST stringB;
@@ -905,7 +976,7 @@ void TestAString::MoveAssignmentHelper() const
 
         {
             // Create the source string
-            SRC stringA( "string" );
+            SRC stringA( "string too long to be inline" );
 
             // Create the destination
             DST stringB;
@@ -942,4 +1013,99 @@ void TestAString::MoveAssignment() const
     MoveAssignmentHelper<AStackString<>, AString,        1,     AString>(); // Src as AString, behave the same
 }
 
+// ShortStrings
+//------------------------------------------------------------------------------
+void TestAString::ShortStrings() const
+{
+    // Short strings don't need any allocations
+    {
+        TEST_MEMORY_SNAPSHOT( s1 );
+
+        AString a( "short" );
+        AString b( a );
+        AString c( Move( a ) );
+        AString d;
+        d = b;
+        d += "s";
+        AString e( 4 );
+        e = "012345"; // Largest inline string
+
+        TEST_EXPECT_ALLOCATION_EVENTS( s1, 0 )
+
+        TEST_ASSERT( a.IsEmpty() );
+        TEST_ASSERT( b == "short" );
+        TEST_ASSERT( c == "short" );
+        TEST_ASSERT( d == "shorts" );
+        TEST_ASSERT( e == "012345" );
+    }
+
+    // Growing beyond the inline storage moves contents to the heap
+    {
+        AString a( "short" );
+        TEST_ASSERT( a.MemoryMustBeFreed() == false );
+
+        TEST_MEMORY_SNAPSHOT( s1 );
+        a += " string which is longer";
+        TEST_EXPECT_ALLOCATION_EVENTS( s1, 1 )
+
+        TEST_ASSERT( a.MemoryMustBeFreed() == true );
+        TEST_ASSERT( a == "short string which is longer" );
+
+        // and stays there when shrinking
+        a = "short";
+        TEST_ASSERT( a.MemoryMustBeFreed() == true );
+        TEST_ASSERT( a == "short" );
+    }
+
+    // Inline strings can be modified in place
+    {
+        AString a( "abc" );
+        a[ 0 ] = 'x';
+        a.Get()[ 1 ] = 'y';
+        *a.Find( 'c' ) = 'z';
+        TEST_ASSERT( a == "xyz" );
+        a.ToUpper();
+        a.Replace( 'Y', '_' );
+        a += "12";
+        TEST_ASSERT( a == "X_Z12" );
+        TEST_ASSERT( a.GetEnd() == ( a.Get() + 5 ) );
+        a.Trim( 1, 1 );
+        TEST_ASSERT( a == "_Z1" );
+        a.SetLength( 1 );
+        TEST_ASSERT( a == "_" );
+        TEST_ASSERT( a.MemoryMustBeFreed() == false );
+
+        // and keep their contents when growing onto the heap
+        a.SetReserved( 64 );
+        TEST_ASSERT( a.MemoryMustBeFreed() == true );
+        TEST_ASSERT( a == "_" );
+    }
+
+    // Moving an inline string copies it
+    {
+        Array< AString > strings;
+        for ( uint32_t i = 0; i < 100; ++i )
+        {
+            AStackString<> s;
+            s.Format( "%u", i );
+            strings.EmplaceBack( s );
+        }
+        for ( uint32_t i = 0; i < 100; ++i )
+        {
+            AStackString<> s;
+            s.Format( "%u", i );
+            TEST_ASSERT( strings[ i ] == s );
+            TEST_ASSERT( AString::StrLen( strings[ i ].Get() ) == strings[ i ].GetLength() );
+        }
+    }
+
+    // AStackString still uses its own storage
+    {
+        AStackString< 32 > a( "short" );
+        TEST_ASSERT( a.GetReserved() == 32 );
+        a += " string which is longer";
+        TEST_ASSERT( a.MemoryMustBeFreed() == false );
+    }
+}
+
 //------------------------------------------------------------------------------
@@ -1340,7 +1340,7 @@ void TestArray::EmplaceBack() const
 
         TEST_MEMORY_SNAPSHOT( s1 ); // Take note of memory state before
 
-        array.EmplaceBack( "string1" );
+        array.EmplaceBack( "string1 - too long to be inline" );
 
         TEST_EXPECT_ALLOCATION_EVENTS( s1, 1 ) // Check expected amount of allocs occurred
 
@@ -1348,7 +1348,7 @@ void TestArray::EmplaceBack() const
         TEST_ASSERT( array.IsEmpty() == false );
         TEST_ASSERT( array.GetSize() == 1 );
         TEST_ASSERT( array.GetCapacity() >= 1 );
-        TEST_ASSERT( array[ 0 ] == "string1" );
+        TEST_ASSERT( array[ 0 ] == "string1 - too long to be inline" );
     }
     {
         // Emplace one item (Move)
@@ -1356,7 +1356,7 @@ void TestArray::EmplaceBack() const
 
         TEST_MEMORY_SNAPSHOT( s1 ); // Take note of memory state before
 
-        array.EmplaceBack( Move( AString( "string1" ) ) );
+        array.EmplaceBack( Move( AString( "string1 - too long to be inline" ) ) );
 
         TEST_EXPECT_ALLOCATION_EVENTS( s1, 1 ) // Check expected amount of allocs occurred
 
@@ -1364,7 +1364,7 @@ void TestArray::EmplaceBack() const
         TEST_ASSERT( array.IsEmpty() == false );
         TEST_ASSERT( array.GetSize() == 1 );
         TEST_ASSERT( array.GetCapacity() >= 1 );
-        TEST_ASSERT( array[ 0 ] == "string1" );
+        TEST_ASSERT( array[ 0 ] == "string1 - too long to be inline" );
     }
     {
         // Emplace several items
@@ -1372,9 +1372,9 @@ void TestArray::EmplaceBack() const
 
         TEST_MEMORY_SNAPSHOT( s1 ); // Take note of memory state before
 
-        array.EmplaceBack( "string1" );
-        array.EmplaceBack( "string2" );
-        array.EmplaceBack( "string3" );
+        array.EmplaceBack( "string1 - too long to be inline" );
+        array.EmplaceBack( "string2 - too long to be inline" );
+        array.EmplaceBack( "string3 - too long to be inline" );
 
         TEST_EXPECT_ALLOCATION_EVENTS( s1, 3 ) // Check expected amount of allocs occurred
 
@@ -1382,8 +1382,8 @@ void TestArray::EmplaceBack() const
         TEST_ASSERT( array.IsEmpty() == false );
         TEST_ASSERT( array.GetSize() == 3 );
         TEST_ASSERT( array.GetCapacity() >= 3 ); // Capacity unchanged
-        TEST_ASSERT( array[ 0 ] == "string1" );
-        TEST_ASSERT( array[ 2 ] == "string3" );
+        TEST_ASSERT( array[ 0 ] == "string1 - too long to be inline" );
+        TEST_ASSERT( array[ 2 ] == "string3 - too long to be inline" );
     }
 }
 
@@ -1998,12 +1998,12 @@ void TestArray::MoveAssignment() const
 void TestArray::MoveWhenGrowing() const
 {
     Array<AString> array( 4, true );
-    array.Append( AString( "string1" ) );
-    array.Append( AString( "string2" ) );
-    array.Append( AString( "string3" ) );
-    array.Append( AString( "string4" ) );
+    array.Append( AString( "string1 - too long to be inline" ) );
+    array.Append( AString( "string2 - too long to be inline" ) );
+    array.Append( AString( "string3 - too long to be inline" ) );
+    array.Append( AString( "string4 - too long to be inline" ) );
 
-    const AString string5( "string4" );
+    const AString string5( "string4 - too long to be inline" );
 
     // Take note of memory state before
     TEST_MEMORY_SNAPSHOT( s1 );
@@ -2022,7 +2022,7 @@ void TestArray::MoveWhenGrowing() const
 //------------------------------------------------------------------------------
 void TestArray::MoveAppend() const
 {
-    AString string( "string4" );
+    AString string( "string4 - too long to be inline" );
     Array<AString> array( 1, false );
 
     // Take note of memory state before
@@ -2042,7 +2042,7 @@ void TestArray::MoveSetCapacity() const
 {
     // Create array with something in it
     Array<AString> array( 1, true );
-    array.Append( AString( "string1" ) );
+    array.Append( AString( "string1 - too long to be inline" ) );
 
     // Take note of memory state before
     TEST_MEMORY_SNAPSHOT( s1 );
@@ -2061,8 +2061,8 @@ void TestArray::MovePopFront() const
 {
     // Create array with something in it
     Array<AString> array( 2, false );
-    array.Append( AString( "string1" ) );
-    array.Append( AString( "string2string2" ) ); // Larger than string 1
+    array.Append( AString( "string1 - too long to be inline" ) );
+    array.Append( AString( "string2string2 - too long to be inline" ) ); // Larger than string 1
 
     // Take note of memory state before
     TEST_MEMORY_SNAPSHOT( s1 );
@@ -2081,8 +2081,8 @@ void TestArray::MoveErase() const
 {
     // Create array with something in it
     Array<AString> array( 2, false );
-    array.Append( AString( "string1" ) );
-    array.Append( AString( "string2string2" ) ); // Larger than string 1
+    array.Append( AString( "string1 - too long to be inline" ) );
+    array.Append( AString( "string2string2 - too long to be inline" ) ); // Larger than string 1
 
     // Take note of memory state before
     TEST_MEMORY_SNAPSHOT( s1 );
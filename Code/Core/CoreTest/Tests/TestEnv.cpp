@@ -7,8 +7,12 @@
 
 // Core
 #include <Core/Env/Env.h>
+#include <Core/Mem/Mem.h>
 #include <Core/Strings/AStackString.h>
 
+// system
+#include <string.h> // for memset
+
 // TestEnv
 //------------------------------------------------------------------------------
 class TestEnv : public UnitTest
@@ -18,6 +22,7 @@ private:
 
     void GetCommandLine() const;
     void GetExePath() const;
+    void GetProcessMemoryUsage() const;
 };
 
 // Register Tests
@@ -25,6 +30,7 @@ private:
 REGISTER_TESTS_BEGIN( TestEnv )
     REGISTER_TEST( GetCommandLine )
     REGISTER_TEST( GetExePath )
+    REGISTER_TEST( GetProcessMemoryUsage )
 REGISTER_TESTS_END
 
 // GetCommandLine
@@ -49,4 +55,20 @@ void TestEnv::GetExePath() const
     #endif
 }
 
+// GetProcessMemoryUsage
+//------------------------------------------------------------------------------
+void TestEnv::GetProcessMemoryUsage() const
+{
+    const uint64_t before = Env::GetProcessMemoryUsage();
+    TEST_ASSERT( before > 0 );
+
+    // touching a large allocation should increase it
+    const size_t size( 64 * 1024 * 1024 );
+    char * mem = (char *)ALLOC( size );
+    memset( mem, 1, size );
+    const uint64_t after = Env::GetProcessMemoryUsage();
+    FREE( mem );
+    TEST_ASSERT( after > before );
+}
+
 //------------------------------------------------------------------------------
@@ -20,6 +20,7 @@ private:
 
     void WriteOnly() const;
     void ReadOnly() const;
+    void Append() const;
 
     // Helpers
     mutable uint32_t m_TempFileId = 0;
@@ -31,6 +32,7 @@ private:
 REGISTER_TESTS_BEGIN( TestFileStream )
     REGISTER_TEST( WriteOnly )
     REGISTER_TEST( ReadOnly )
+    REGISTER_TEST( Append )
 REGISTER_TESTS_END
 
 // WriteOnly
@@ -111,6 +113,42 @@ void TestFileStream::ReadOnly() const
     TEST_ASSERT( FileIO::FileDelete( fileName.Get() ) );
 }
 
+// Append
+//------------------------------------------------------------------------------
+void TestFileStream::Append() const
+{
+    AStackString<> fileName;
+    GenerateTempFileName( fileName );
+
+    const AStackString<> data( "Some Data To Store In A File" );
+
+    // Append creates the file if needed, then adds to the end of it
+    for ( uint32_t i = 0; i < 2; ++i )
+    {
+        FileStream f;
+        TEST_ASSERT( f.Open( fileName.Get(), FileStream::APPEND ) == true );
+        TEST_ASSERT( f.WriteBuffer( data.Get(), data.GetLength() ) == data.GetLength() );
+        TEST_ASSERT( f.GetFileSize() == ( data.GetLength() * ( i + 1 ) ) );
+    }
+
+    // Check both writes are present
+    {
+        FileStream f;
+        TEST_ASSERT( f.Open( fileName.Get(), FileStream::READ_ONLY ) == true );
+        TEST_ASSERT( f.GetFileSize() == ( data.GetLength() * 2 ) );
+
+        AStackString<> buffer;
+        buffer.SetLength( data.GetLength() * 2 );
+        TEST_ASSERT( f.ReadBuffer( buffer.Get(), buffer.GetLength() ) == buffer.GetLength() );
+        AStackString<> expected( data );
+        expected += data;
+        TEST_ASSERT( buffer == expected );
+    }
+
+    // Clean up
+    TEST_ASSERT( FileIO::FileDelete( fileName.Get() ) );
+}
+
 // GenerateTempFileName
 //------------------------------------------------------------------------------
 void TestFileStream::GenerateTempFileName( AString & outTempFileName ) const
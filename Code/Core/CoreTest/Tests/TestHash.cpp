@@ -7,6 +7,8 @@
 
 #include "Core/Containers/AutoPtr.h"
 #include "Core/Math/CRC32.h"
+#include "Core/Math/CRC32C.h"
+#include "Core/Math/Conversions.h"
 #include "Core/Math/Random.h"
 #include "Core/Math/xxHash.h"
 #include "Core/Strings/AStackString.h"
@@ -24,6 +26,10 @@ private:
 
     void CompareHashTimes_Large() const;
     void CompareHashTimes_Small() const;
+    void CRC32CValues() const;
+    void CRC32CValuesHelper() const;
+    void xxHash3Values() const;
+    void AccumulatorValues() const;
 };
 
 // Register Tests
@@ -31,6 +37,9 @@ private:
 REGISTER_TESTS_BEGIN( TestHash )
     REGISTER_TEST( CompareHashTimes_Large )
     REGISTER_TEST( CompareHashTimes_Small )
+    REGISTER_TEST( CRC32CValues )
+    REGISTER_TEST( xxHash3Values )
+    REGISTER_TEST( AccumulatorValues )
 REGISTER_TESTS_END
 
 // CompareHashTimes_Large
@@ -103,6 +112,72 @@ void TestHash::CompareHashTimes_Large() const
         OUTPUT( "xxHash-64       : %2.3fs @ %6.3f GiB/s (hash: %016" PRIx64 ")\n", (double)time, (double)speed, crc );
     }
 
+    // xxHash3-64
+    {
+        Timer t;
+        uint64_t crc = xxHash3::Calc64( data.Get(), dataSize );
+        float time = t.GetElapsed();
+        float speed = ( (float)dataSize / (float)( 1024 * 1024 * 1024 ) ) / time;
+        OUTPUT( "xxHash3-64      : %2.3fs @ %6.3f GiB/s (hash: %016" PRIx64 ")\n", (double)time, (double)speed, crc );
+    }
+
+    // xxHash3-128
+    {
+        Timer t;
+        xxHash3::Hash128 crc = xxHash3::Calc128( data.Get(), dataSize );
+        float time = t.GetElapsed();
+        float speed = ( (float)dataSize / (float)( 1024 * 1024 * 1024 ) ) / time;
+        OUTPUT( "xxHash3-128     : %2.3fs @ %6.3f GiB/s (hash: %016" PRIx64 "%016" PRIx64 ")\n", (double)time, (double)speed, crc.m_High, crc.m_Low );
+    }
+
+    // xxHash64 - accumulated in 64 KiB pieces (as when hashing data while it is read)
+    {
+        Timer t;
+        xxHash64Accumulator acc;
+        const size_t pieceSize = ( 64 * 1024 );
+        for ( size_t offset = 0; offset < dataSize; offset += pieceSize )
+        {
+            acc.Update( (const char *)data.Get() + offset, pieceSize );
+        }
+        uint64_t crc = acc.Digest();
+        float time = t.GetElapsed();
+        float speed = ( (float)dataSize / (float)( 1024 * 1024 * 1024 ) ) / time;
+        OUTPUT( "xxHash-64 Acc   : %2.3fs @ %6.3f GiB/s (hash: %016" PRIx64 ")\n", (double)time, (double)speed, crc );
+    }
+
+    // xxHash3-64 - accumulated in 64 KiB pieces
+    {
+        Timer t;
+        xxHash3Accumulator acc;
+        const size_t pieceSize = ( 64 * 1024 );
+        for ( size_t offset = 0; offset < dataSize; offset += pieceSize )
+        {
+            acc.Update( (const char *)data.Get() + offset, pieceSize );
+        }
+        uint64_t crc = acc.Digest64();
+        float time = t.GetElapsed();
+        float speed = ( (float)dataSize / (float)( 1024 * 1024 * 1024 ) ) / time;
+        OUTPUT( "xxHash3-64 Acc  : %2.3fs @ %6.3f GiB/s (hash: %016" PRIx64 ")\n", (double)time, (double)speed, crc );
+    }
+
+    // CRC32C
+    {
+        Timer t;
+        uint32_t crc = CRC32C::Calc( data.Get(), dataSize );
+        float time = t.GetElapsed();
+        float speed = ( (float)dataSize / (float)( 1024 * 1024 * 1024 ) ) / time;
+        OUTPUT( "CRC32C (%s)     : %2.3fs @ %6.3f GiB/s (hash: 0x%x)\n", CRC32C::IsHardwareAccelerated() ? "HW" : "SW", (double)time, (double)speed, crc );
+    }
+
+    // CRC32C Lower
+    {
+        Timer t;
+        uint32_t crc = CRC32C::CalcLower( data.Get(), dataSize );
+        float time = t.GetElapsed();
+        float speed = ( (float)dataSize / (float)( 1024 * 1024 * 1024 ) ) / time;
+        OUTPUT( "CRC32CLower (%s): %2.3fs @ %6.3f GiB/s (hash: 0x%x)\n", CRC32C::IsHardwareAccelerated() ? "HW" : "SW", (double)time, (double)speed, crc );
+    }
+
     // CRC32 - 8x8 slicing
     {
         Timer t;
@@ -191,6 +266,54 @@ void TestHash::CompareHashTimes_Small() const
         OUTPUT( "xxHash-64       : %2.3fs @ %6.3f GiB/s (hash: %016" PRIx64 ")\n", (double)time, (double)speed, crc );
     }
 
+    // xxHash3 - 64
+    {
+        Timer t;
+        uint64_t crc( 0 );
+        for ( size_t j = 0; j < numIterations; ++j )
+        {
+            for ( size_t i = 0; i < numStrings; ++i )
+            {
+                crc += xxHash3::Calc64( strings[ i ].Get(), strings[ i ].GetLength() );
+            }
+        }
+        float time = t.GetElapsed();
+        float speed = ( (float)dataSize / (float)( 1024 * 1024 * 1024 ) ) / time;
+        OUTPUT( "xxHash3-64      : %2.3fs @ %6.3f GiB/s (hash: %016" PRIx64 ")\n", (double)time, (double)speed, crc );
+    }
+
+    // CRC32C
+    {
+        Timer t;
+        uint32_t crc( 0 );
+        for ( size_t j = 0; j < numIterations; ++j )
+        {
+            for ( size_t i = 0; i < numStrings; ++i )
+            {
+                crc += CRC32C::Calc( strings[ i ].Get(), strings[ i ].GetLength() );
+            }
+        }
+        float time = t.GetElapsed();
+        float speed = ( (float)dataSize / (float)( 1024 * 1024 * 1024 ) ) / time;
+        OUTPUT( "CRC32C (%s)     : %2.3fs @ %6.3f GiB/s (hash: 0x%x)\n", CRC32C::IsHardwareAccelerated() ? "HW" : "SW", (double)time, (double)speed, crc );
+    }
+
+    // CRC32C Lower
+    {
+        Timer t;
+        uint32_t crc( 0 );
+        for ( size_t j = 0; j < numIterations; ++j )
+        {
+            for ( size_t i = 0; i < numStrings; ++i )
+            {
+                crc += CRC32C::CalcLower( strings[ i ].Get(), strings[ i ].GetLength() );
+            }
+        }
+        float time = t.GetElapsed();
+        float speed = ( (float)dataSize / (float)( 1024 * 1024 * 1024 ) ) / time;
+        OUTPUT( "CRC32CLower (%s): %2.3fs @ %6.3f GiB/s (hash: 0x%x)\n", CRC32C::IsHardwareAccelerated() ? "HW" : "SW", (double)time, (double)speed, crc );
+    }
+
     // CRC32 - 8x8 slicing
     {
         Timer t;
@@ -243,4 +366,157 @@ void TestHash::CompareHashTimes_Small() const
     }
 }
 
+// CRC32CValues
+//------------------------------------------------------------------------------
+void TestHash::CRC32CValues() const
+{
+    // Check the version used on this machine
+    CRC32CValuesHelper();
+
+    // And the table driven version, if hardware acceleration would otherwise be used
+    if ( CRC32C::IsHardwareAccelerated() )
+    {
+        CRC32C::SetForceSoftware( true );
+        TEST_ASSERT( CRC32C::IsHardwareAccelerated() == false );
+        CRC32CValuesHelper();
+        CRC32C::SetForceSoftware( false );
+        TEST_ASSERT( CRC32C::IsHardwareAccelerated() );
+    }
+}
+
+// CRC32CValuesHelper
+//------------------------------------------------------------------------------
+void TestHash::CRC32CValuesHelper() const
+{
+    // Standard check value
+    TEST_ASSERT( CRC32C::Calc( "123456789", 9 ) == 0xE3069283 );
+    TEST_ASSERT( CRC32C::Calc( "", 0 ) == 0 );
+
+    // Compare with a bit-at-a-time implementation for all lengths and alignments
+    // which the implementation handles differently
+    Random r( 0x12345678 );
+    uint8_t data[ 256 ];
+    for ( size_t i = 0; i < sizeof( data ); ++i )
+    {
+        data[ i ] = (uint8_t)r.GetRand();
+    }
+    for ( size_t offset = 0; offset < 8; ++offset )
+    {
+        for ( size_t len = 0; len < ( sizeof( data ) - offset ); ++len )
+        {
+            uint32_t expected = 0xFFFFFFFF;
+            for ( size_t i = 0; i < len; ++i )
+            {
+                expected ^= data[ offset + i ];
+                for ( size_t bit = 0; bit < 8; ++bit )
+                {
+                    expected = ( expected >> 1 ) ^ ( 0x82F63B78 & ( 0 - ( expected & 1 ) ) );
+                }
+            }
+            expected ^= 0xFFFFFFFF;
+            TEST_ASSERT( CRC32C::Calc( data + offset, len ) == expected );
+
+            // Incremental calculation gives the same result
+            const size_t split = ( len / 3 );
+            uint32_t crc = CRC32C::Start();
+            crc = CRC32C::Update( crc, data + offset, split );
+            crc = CRC32C::Update( crc, data + offset + split, len - split );
+            TEST_ASSERT( CRC32C::Stop( crc ) == expected );
+        }
+    }
+
+    // CalcLower is equivalent to lowering the string first (including non-ASCII chars)
+    for ( size_t len = 0; len < sizeof( data ); ++len )
+    {
+        AStackString<> str( (const char *)data, (const char *)data + len );
+        for ( size_t i = 0; i < len; ++i )
+        {
+            if ( str[ i ] == 0 )
+            {
+                str[ i ] = 'Q'; // Avoid embedded nulls
+            }
+        }
+        AStackString<> lower( str );
+        lower.ToLower();
+        TEST_ASSERT( CRC32C::CalcLower( str ) == CRC32C::Calc( lower ) );
+        TEST_ASSERT( CRC32C::CalcLower( lower ) == CRC32C::Calc( lower ) );
+    }
+    TEST_ASSERT( CRC32C::CalcLower( AStackString<>( "C:\\Windows\\System32\\File.DAT[@`{" ) ) ==
+                 CRC32C::Calc( AStackString<>( "c:\\windows\\system32\\file.dat[@`{" ) ) );
+}
+
+// xxHash3Values
+//------------------------------------------------------------------------------
+void TestHash::xxHash3Values() const
+{
+    // Reference values for empty input
+    TEST_ASSERT( xxHash3::Calc64( "", 0 ) == 0x2D06800538D394C2ULL );
+    const xxHash3::Hash128 empty128 = xxHash3::Calc128( "", 0 );
+    TEST_ASSERT( empty128.m_High == 0x99AA06D3014798D8ULL );
+    TEST_ASSERT( empty128.m_Low == 0x6001C324468D497FULL );
+
+    // Existing hashes are unchanged
+    TEST_ASSERT( xxHash::Calc32( "", 0 ) == 0x02CC5D05 );
+    TEST_ASSERT( xxHash::Calc64( "", 0 ) == 0xEF46DB3751D8E999ULL );
+
+    // Lower and upper halves of 128 bit hash are not trivially related
+    const AStackString<> str( "c:\\files\\subdir\\project\\thing\\stuff.cpp" );
+    const xxHash3::Hash128 hash128 = xxHash3::Calc128( str );
+    TEST_ASSERT( hash128.m_Low != hash128.m_High );
+    TEST_ASSERT( hash128 != empty128 );
+    TEST_ASSERT( xxHash3::Calc64( str ) != xxHash::Calc64( str ) );
+}
+
+// AccumulatorValues
+//------------------------------------------------------------------------------
+void TestHash::AccumulatorValues() const
+{
+    // Data spanning several internal blocks of each algorithm
+    Random r( 0x87654321 );
+    const size_t dataSize = ( 64 * 1024 ) + 17;
+    AutoPtr< uint8_t > data( (uint8_t *)ALLOC( dataSize ) );
+    for ( size_t i = 0; i < dataSize; ++i )
+    {
+        data.Get()[ i ] = (uint8_t)r.GetRand();
+    }
+
+    // Accumulating in various piece sizes gives the same results as hashing in one go
+    const size_t lengths[] = { 0, 1, 31, 32, 240, 241, 1024, 4096, dataSize };
+    const size_t pieceSizes[] = { 1, 7, 64, 1000, dataSize };
+    for ( const size_t len : lengths )
+    {
+        const uint64_t expected64 = xxHash::Calc64( data.Get(), len );
+        const uint64_t expected3_64 = xxHash3::Calc64( data.Get(), len );
+        const xxHash3::Hash128 expected3_128 = xxHash3::Calc128( data.Get(), len );
+
+        for ( const size_t pieceSize : pieceSizes )
+        {
+            xxHash64Accumulator acc64;
+            xxHash3Accumulator acc3;
+            for ( size_t offset = 0; offset < len; offset += pieceSize )
+            {
+                const size_t thisPiece = Math::Min( pieceSize, len - offset );
+                acc64.Update( data.Get() + offset, thisPiece );
+                acc3.Update( data.Get() + offset, thisPiece );
+            }
+            TEST_ASSERT( acc64.Digest() == expected64 );
+            TEST_ASSERT( acc3.Digest64() == expected3_64 );
+            TEST_ASSERT( acc3.Digest128() == expected3_128 );
+
+            // Reset allows reuse
+            acc64.Reset();
+            acc64.Update( data.Get(), len );
+            TEST_ASSERT( acc64.Digest() == expected64 );
+            acc3.Reset();
+            acc3.Update( data.Get(), len );
+            TEST_ASSERT( acc3.Digest64() == expected3_64 );
+        }
+    }
+
+    // Accumulator state doesn't need any particular alignment
+    AutoPtr< xxHash3Accumulator, DeleteDeletor > heapAcc( FNEW( xxHash3Accumulator ) );
+    heapAcc.Get()->Update( data.Get(), dataSize );
+    TEST_ASSERT( heapAcc.Get()->Digest64() == xxHash3::Calc64( data.Get(), dataSize ) );
+}
+
 //------------------------------------------------------------------------------
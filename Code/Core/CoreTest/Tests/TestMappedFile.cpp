@@ -0,0 +1,158 @@
+// TestMappedFile.cpp
+//------------------------------------------------------------------------------
+
+// Includes
+//------------------------------------------------------------------------------
+#include "TestFramework/UnitTest.h"
+
+// Core
+#include "Core/FileIO/FileIO.h"
+#include "Core/FileIO/FileStream.h"
+#include "Core/FileIO/MappedFile.h"
+#include "Core/Mem/Mem.h"
+#include "Core/Process/Process.h"
+#include "Core/Strings/AStackString.h"
+
+// System
+#include <string.h>
+
+// TestMappedFile
+//------------------------------------------------------------------------------
+class TestMappedFile : public UnitTest
+{
+private:
+    DECLARE_TESTS
+
+    void Map() const;
+    void MapEmptyFile() const;
+    void MapLargeFile() const;
+    void MapMissingFile() const;
+
+    // Helpers
+    mutable uint32_t m_TempFileId = 0;
+    void GenerateTempFile( const void * data, size_t dataSize, AString & outTempFileName ) const;
+};
+
+// Register Tests
+//------------------------------------------------------------------------------
+REGISTER_TESTS_BEGIN( TestMappedFile )
+    REGISTER_TEST( Map )
+    REGISTER_TEST( MapEmptyFile )
+    REGISTER_TEST( MapLargeFile )
+    REGISTER_TEST( MapMissingFile )
+REGISTER_TESTS_END
+
+// Map
+//------------------------------------------------------------------------------
+void TestMappedFile::Map() const
+{
+    const AStackString<> data( "Some Data To Store In A File" );
+    AStackString<> fileName;
+    GenerateTempFile( data.Get(), data.GetLength(), fileName );
+
+    {
+        MappedFile f;
+        TEST_ASSERT( f.IsOpen() == false );
+        TEST_ASSERT( f.Open( fileName.Get() ) == true );
+        TEST_ASSERT( f.IsOpen() == true );
+        TEST_ASSERT( f.GetSize() == data.GetLength() );
+        TEST_ASSERT( memcmp( f.GetData(), data.Get(), data.GetLength() ) == 0 );
+
+        // A file can be mapped while it is open for reading elsewhere
+        FileStream fs;
+        TEST_ASSERT( fs.Open( fileName.Get(), FileStream::READ_ONLY ) == true );
+        MappedFile f2;
+        TEST_ASSERT( f2.Open( fileName.Get() ) == true );
+        TEST_ASSERT( memcmp( f2.GetData(), f.GetData(), f.GetSize() ) == 0 );
+
+        f.Close();
+        TEST_ASSERT( f.IsOpen() == false );
+        TEST_ASSERT( f.GetSize() == 0 );
+    }
+
+    // Clean up
+    TEST_ASSERT( FileIO::FileDelete( fileName.Get() ) );
+}
+
+// MapEmptyFile
+//------------------------------------------------------------------------------
+void TestMappedFile::MapEmptyFile() const
+{
+    AStackString<> fileName;
+    GenerateTempFile( nullptr, 0, fileName );
+
+    {
+        MappedFile f;
+        TEST_ASSERT( f.Open( fileName.Get() ) == true );
+        TEST_ASSERT( f.IsOpen() == true );
+        TEST_ASSERT( f.GetSize() == 0 );
+        TEST_ASSERT( f.GetData() != nullptr ); // Safe to pass to memcpy etc
+    }
+
+    // Clean up
+    TEST_ASSERT( FileIO::FileDelete( fileName.Get() ) );
+}
+
+// MapLargeFile
+//------------------------------------------------------------------------------
+void TestMappedFile::MapLargeFile() const
+{
+    // A file spanning many pages, with a size which is not a multiple of the page size
+    const size_t dataSize = ( 1024 * 1024 ) + 7;
+    char * data = (char *)ALLOC( dataSize );
+    for ( size_t i = 0; i < dataSize; ++i )
+    {
+        data[ i ] = (char)( i * 31 );
+    }
+    AStackString<> fileName;
+    GenerateTempFile( data, dataSize, fileName );
+
+    {
+        MappedFile f;
+        TEST_ASSERT( f.Open( fileName.Get() ) == true );
+        TEST_ASSERT( f.GetSize() == dataSize );
+        TEST_ASSERT( memcmp( f.GetData(), data, dataSize ) == 0 );
+    }
+    FREE( data );
+
+    // Clean up
+    TEST_ASSERT( FileIO::FileDelete( fileName.Get() ) );
+}
+
+// MapMissingFile
+//------------------------------------------------------------------------------
+void TestMappedFile::MapMissingFile() const
+{
+    AStackString<> fileName;
+    VERIFY( FileIO::GetTempDir( fileName ) );
+
+    // Directories can't be mapped
+    MappedFile f;
+    TEST_ASSERT( f.Open( fileName.Get() ) == false );
+    TEST_ASSERT( f.IsOpen() == false );
+
+    // Nor can files that don't exist
+    fileName.AppendFormat( "TestMappedFile.%u.DoesNotExist", Process::GetCurrentId() );
+    TEST_ASSERT( f.Open( fileName.Get() ) == false );
+    TEST_ASSERT( f.IsOpen() == false );
+}
+
+// GenerateTempFile
+//------------------------------------------------------------------------------
+void TestMappedFile::GenerateTempFile( const void * data, size_t dataSize, AString & outTempFileName ) const
+{
+    // Get system temp folder
+    VERIFY( FileIO::GetTempDir( outTempFileName ) );
+
+    // add process unique identifier
+    outTempFileName.AppendFormat( "TestMappedFile.%u.%u", Process::GetCurrentId(), m_TempFileId++ );
+
+    FileStream f;
+    TEST_ASSERT( f.Open( outTempFileName.Get(), FileStream::WRITE_ONLY ) == true );
+    if ( dataSize > 0 )
+    {
+        TEST_ASSERT( f.WriteBuffer( data, dataSize ) == dataSize );
+    }
+}
+
+//------------------------------------------------------------------------------
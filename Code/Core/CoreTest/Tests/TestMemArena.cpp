@@ -0,0 +1,214 @@
+// TestMemArena.cpp
+//------------------------------------------------------------------------------
+
+// Includes
+//------------------------------------------------------------------------------
+#include "TestFramework/UnitTest.h"
+
+#include "Core/Containers/Array.h"
+#include "Core/Mem/MemArena.h"
+#include "Core/Strings/AString.h"
+
+// System
+#include <string.h>
+
+// TestMemArena
+//------------------------------------------------------------------------------
+class TestMemArena : public UnitTest
+{
+private:
+    DECLARE_TESTS
+
+    void TestUnused() const;
+    void TestAllocs() const;
+    void TestReset() const;
+    void TestLargeAllocs() const;
+    void TestArray() const;
+    void TestArrayNoScope() const;
+    void TestArrayMove() const;
+    void TestAString() const;
+};
+
+// Register Tests
+//------------------------------------------------------------------------------
+REGISTER_TESTS_BEGIN( TestMemArena )
+    REGISTER_TEST( TestUnused )
+    REGISTER_TEST( TestAllocs )
+    REGISTER_TEST( TestReset )
+    REGISTER_TEST( TestLargeAllocs )
+    REGISTER_TEST( TestArray )
+    REGISTER_TEST( TestArrayNoScope )
+    REGISTER_TEST( TestArrayMove )
+    REGISTER_TEST( TestAString )
+REGISTER_TESTS_END
+
+// TestUnused
+//------------------------------------------------------------------------------
+void TestMemArena::TestUnused() const
+{
+    // Create a MemArena but don't do anything with it
+    MemArena arena;
+    arena.Reset();
+    TEST_ASSERT( arena.GetNumChunkAllocations() == 0 );
+}
+
+// TestAllocs
+//------------------------------------------------------------------------------
+void TestMemArena::TestAllocs() const
+{
+    MemArena arena( 1024 );
+
+    // Allocations of various sizes and alignments
+    const size_t alignments[] = { 1, 4, 8, 16, 64 };
+    char * prev = nullptr;
+    for ( size_t i = 0; i < 64; ++i )
+    {
+        const size_t alignment = alignments[ i % 5 ];
+        char * mem = static_cast< char * >( arena.Alloc( i + 1, alignment ) );
+        TEST_ASSERT( mem );
+        TEST_ASSERT( ( (size_t)mem % alignment ) == 0 );
+        TEST_ASSERT( mem != prev );
+        memset( mem, (int)i, i + 1 ); // Ensure memory is writable
+        prev = mem;
+    }
+    TEST_ASSERT( arena.GetNumAllocations() == 64 );
+    TEST_ASSERT( arena.GetNumChunkAllocations() > 1 ); // 2080+ bytes don't fit in a 1 KiB chunk
+}
+
+// TestReset
+//------------------------------------------------------------------------------
+void TestMemArena::TestReset() const
+{
+    MemArena arena( 1024 );
+
+    // Memory of a single chunk is reused
+    void * a = arena.Alloc( 100 );
+    arena.Reset();
+    void * b = arena.Alloc( 100 );
+    TEST_ASSERT( a == b );
+    TEST_ASSERT( arena.GetNumChunkAllocations() == 1 );
+    arena.Reset();
+
+    // Using several chunks grows the arena to cover the usage next time
+    for ( size_t i = 0; i < 10; ++i )
+    {
+        arena.Alloc( 512 );
+    }
+    arena.Reset();
+    TEST_ASSERT( arena.GetPeakBytesUsed() >= ( 10 * 512 ) );
+    const uint64_t numChunkAllocs = arena.GetNumChunkAllocations();
+    for ( size_t i = 0; i < 10; ++i )
+    {
+        arena.Alloc( 512 );
+    }
+    arena.Reset();
+    TEST_ASSERT( arena.GetNumChunkAllocations() == ( numChunkAllocs + 1 ) );
+}
+
+// TestLargeAllocs
+//------------------------------------------------------------------------------
+void TestMemArena::TestLargeAllocs() const
+{
+    MemArena arena( 1024 );
+
+    // Allocations bigger than the chunk size get a chunk of their own
+    char * a = static_cast< char * >( arena.Alloc( 4096, 64 ) );
+    TEST_ASSERT( ( (size_t)a % 64 ) == 0 );
+    memset( a, 0, 4096 );
+    char * b = static_cast< char * >( arena.Alloc( 16 ) );
+    memset( b, 0, 16 );
+    TEST_ASSERT( ( b >= ( a + 4096 ) ) || ( ( b + 16 ) <= a ) );
+}
+
+// TestArray
+//------------------------------------------------------------------------------
+void TestMemArena::TestArray() const
+{
+    MemArena arena;
+    {
+        MemArenaScope scope( &arena );
+
+        Array< uint32_t > array;
+        array.UseThreadArena();
+        for ( uint32_t i = 0; i < 1000; ++i )
+        {
+            array.Append( i );
+        }
+        for ( uint32_t i = 0; i < 1000; ++i )
+        {
+            TEST_ASSERT( array[ i ] == i );
+        }
+        TEST_ASSERT( arena.GetNumAllocations() > 0 );
+    }
+    TEST_ASSERT( MemArena::GetThreadArena() == nullptr );
+}
+
+// TestArrayNoScope
+//------------------------------------------------------------------------------
+void TestMemArena::TestArrayNoScope() const
+{
+    // Without a current arena, opted-in Arrays use the heap
+    Array< uint32_t > array;
+    array.UseThreadArena();
+    for ( uint32_t i = 0; i < 1000; ++i )
+    {
+        array.Append( i );
+    }
+    TEST_ASSERT( array.GetSize() == 1000 );
+    TEST_ASSERT( array[ 999 ] == 999 );
+}
+
+// TestArrayMove
+//------------------------------------------------------------------------------
+void TestMemArena::TestArrayMove() const
+{
+    Array< AString > persistent;
+
+    MemArena arena;
+    {
+        MemArenaScope scope( &arena );
+
+        Array< AString > transient;
+        transient.UseThreadArena();
+        transient.SetCapacity( 128 );
+        transient.EmplaceBack( "a" );
+        transient.EmplaceBack( "b" );
+
+        // Moving out of arena memory must copy into memory owned by the destination
+        persistent = Move( transient );
+    }
+
+    // Arena has been reset (and memory filled in debug), so contents must be intact
+    TEST_ASSERT( persistent.GetSize() == 2 );
+    TEST_ASSERT( persistent.GetCapacity() == 2 );
+    TEST_ASSERT( persistent[ 0 ] == "a" );
+    TEST_ASSERT( persistent[ 1 ] == "b" );
+}
+
+// TestAString
+//------------------------------------------------------------------------------
+void TestMemArena::TestAString() const
+{
+    MemArena arena;
+    AString persistent;
+    {
+        MemArenaScope scope( &arena );
+
+        AString transient;
+        transient.UseThreadArena();
+        for ( size_t i = 0; i < 100; ++i )
+        {
+            transient += "0123456789";
+        }
+        TEST_ASSERT( transient.GetLength() == 1000 );
+        TEST_ASSERT( arena.GetNumAllocations() > 0 );
+
+        // Copying takes a heap copy
+        persistent = transient;
+    }
+    TEST_ASSERT( persistent.GetLength() == 1000 );
+    TEST_ASSERT( persistent.BeginsWith( "0123456789" ) );
+    TEST_ASSERT( persistent.EndsWith( "0123456789" ) );
+}
+
+//------------------------------------------------------------------------------
@@ -82,10 +82,20 @@ void TestPathUtils::TestPathBeginsWith() const
         DOCHECK( "/anotherfolder/subFolder", "/folder", false )
     #endif
 
+    // Long paths
+    #if defined( __WINDOWS__)
+        DOCHECK( "c:\\UnrealEngine\\Engine\\Source\\Runtime\\Core\\Public\\", "C:\\UNREALENGINE\\ENGINE\\SOURCE\\RUNTIME\\", true )
+        DOCHECK( "c:\\UnrealEngine\\Engine\\Source\\Runtime\\Core\\Public\\", "c:\\UnrealEngine\\Engine\\Source\\Developer\\", false )
+    #else
+        DOCHECK( "/UnrealEngine/Engine/Source/Runtime/Core/Public/", "/UnrealEngine/Engine/Source/Runtime/", true )
+        DOCHECK( "/UnrealEngine/Engine/Source/Runtime/Core/Public/", "/UnrealEngine/Engine/Source/Developer/", false )
+    #endif
+
     #if defined( __LINUX__ )
         // Case sensitivity checks
         DOCHECK( "/FOLDER/subFolder/", "/folder/", false )
         DOCHECK( "/FOLDER/subFolder", "/folder", false )
+        DOCHECK( "/UnrealEngine/Engine/Source/Runtime/Core/Public/", "/UnrealEngine/Engine/Source/RUNTIME/", false )
     #endif
 
     #undef DOCHECK
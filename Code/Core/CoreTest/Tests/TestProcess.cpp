@@ -0,0 +1,156 @@
+// TestProcess.cpp
+//------------------------------------------------------------------------------
+
+// Includes
+//------------------------------------------------------------------------------
+#include "TestFramework/UnitTest.h"
+
+#include "Core/FileIO/FileIO.h"
+#include "Core/Process/Process.h"
+#include "Core/Strings/AStackString.h"
+#include "Core/Time/Timer.h"
+#include "Core/Tracing/Tracing.h"
+
+// TestProcess
+//------------------------------------------------------------------------------
+class TestProcess : public UnitTest
+{
+private:
+    DECLARE_TESTS
+
+    void Spawn() const;
+    void SpawnFailure() const;
+    void ReadLargeOutput() const;
+    void ReadTimeOut() const;
+
+    // Helper functions
+    static void     SpawnAndCheck( bool useFork );
+    static float    TimeRead( uint32_t size, bool reserve );
+};
+
+// Register Tests
+//------------------------------------------------------------------------------
+REGISTER_TESTS_BEGIN( TestProcess )
+    REGISTER_TEST( Spawn )
+    REGISTER_TEST( SpawnFailure )
+    REGISTER_TEST( ReadLargeOutput )
+    REGISTER_TEST( ReadTimeOut )
+REGISTER_TESTS_END
+
+// Spawn
+//------------------------------------------------------------------------------
+void TestProcess::Spawn() const
+{
+    #if defined( __LINUX__ ) || defined( __APPLE__ )
+        SpawnAndCheck( false ); // posix_spawn
+        SpawnAndCheck( true );  // fork
+    #endif
+}
+
+// SpawnFailure
+//------------------------------------------------------------------------------
+void TestProcess::SpawnFailure() const
+{
+    #if defined( __LINUX__ )
+        // Failure to start is reported directly
+        Process p;
+        TEST_ASSERT( p.Spawn( "/DoesNotExist/Executable", nullptr, nullptr, nullptr ) == false );
+    #endif
+}
+
+// ReadLargeOutput
+//------------------------------------------------------------------------------
+void TestProcess::ReadLargeOutput() const
+{
+    #if defined( __LINUX__ ) || defined( __APPLE__ )
+        #if defined( DEBUG )
+            const uint32_t sizeMiB( 16 );
+        #else
+            const uint32_t sizeMiB( 128 );
+        #endif
+
+        // Output can be very large (when preprocessing for example) and
+        // reserving space up front avoids re-allocation
+        const float timeGrow = TimeRead( sizeMiB * MEGABYTE, false );
+        const float timeReserved = TimeRead( sizeMiB * MEGABYTE, true );
+        OUTPUT( "Read %u MiB output : %2.3f ms (grow), %2.3f ms (reserved)\n",
+                sizeMiB,
+                (double)( timeGrow * 1000.0f ),
+                (double)( timeReserved * 1000.0f ) );
+    #endif
+}
+
+// ReadTimeOut
+//------------------------------------------------------------------------------
+void TestProcess::ReadTimeOut() const
+{
+    #if defined( __LINUX__ ) || defined( __APPLE__ )
+        // A process which produces no output must still time out
+        Process p;
+        TEST_ASSERT( p.Spawn( "/bin/sh", "-c \"sleep 10\"", nullptr, nullptr ) );
+        Timer t;
+        AString out;
+        AString err;
+        TEST_ASSERT( p.ReadAllData( out, err, 100 ) == false );
+        TEST_ASSERT( t.GetElapsed() < 5.0f );
+        p.WaitForExit();
+    #endif
+}
+
+// SpawnAndCheck
+//------------------------------------------------------------------------------
+/*static*/ void TestProcess::SpawnAndCheck( bool useFork )
+{
+    // working dir and environment must be applied
+    AStackString<> workingDir;
+    TEST_ASSERT( FileIO::GetTempDir( workingDir ) );
+    if ( workingDir.EndsWith( '/' ) )
+    {
+        workingDir.SetLength( workingDir.GetLength() - 1 );
+    }
+    const char environment[] = "TEST_PROCESS_VAR=Hello\0";
+
+    Process p;
+    if ( useFork )
+    {
+        p.SetUseFork();
+    }
+    TEST_ASSERT( p.Spawn( "/bin/sh", "-c \"pwd;echo $TEST_PROCESS_VAR\"", workingDir.Get(), environment ) );
+
+    AString out;
+    AString err;
+    TEST_ASSERT( p.ReadAllData( out, err ) );
+    TEST_ASSERT( p.WaitForExit() == 0 );
+
+    AStackString<> expected;
+    expected.Format( "%s\nHello\n", workingDir.Get() );
+    TEST_ASSERT( out.EndsWith( expected ) ); // working dir might be a symlink
+}
+
+// TimeRead
+//------------------------------------------------------------------------------
+/*static*/ float TestProcess::TimeRead( uint32_t size, bool reserve )
+{
+    AStackString<> args;
+    args.Format( "-c \"head -c %u /dev/zero\"", size );
+
+    Timer timer;
+    Process p;
+    TEST_ASSERT( p.Spawn( "/bin/sh", args.Get(), nullptr, nullptr ) );
+    AString out;
+    AString err;
+    if ( reserve )
+    {
+        out.SetReserved( size );
+    }
+    TEST_ASSERT( p.ReadAllData( out, err ) );
+    TEST_ASSERT( p.WaitForExit() == 0 );
+    const float time = timer.GetElapsed();
+
+    // all output must be received
+    TEST_ASSERT( out.GetLength() == size );
+    TEST_ASSERT( err.IsEmpty() );
+    return time;
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,195 @@
+// TestProfile.cpp
+//------------------------------------------------------------------------------
+
+// Includes
+//------------------------------------------------------------------------------
+#include "TestFramework/UnitTest.h"
+
+#include "Core/FileIO/FileIO.h"
+#include "Core/FileIO/FileStream.h"
+#include "Core/Process/Process.h"
+#include "Core/Profile/Profile.h"
+#include "Core/Strings/AStackString.h"
+#include "Core/Time/Timer.h"
+#include "Core/Tracing/Tracing.h"
+
+// TestProfile
+//------------------------------------------------------------------------------
+class TestProfile : public UnitTest
+{
+private:
+    DECLARE_TESTS
+
+    void Disabled() const;
+    void Enabled() const;
+    void Overflow() const;
+
+    // Helper functions
+    static float    TimeSections( const uint32_t numSections );
+    static void     GetTempFileName( const char * name, AString & outFileName );
+    static void     CountEvents( const AString & fileName, uint32_t & outNumBegin, uint32_t & outNumEnd );
+};
+
+// Register Tests
+//------------------------------------------------------------------------------
+REGISTER_TESTS_BEGIN( TestProfile )
+    REGISTER_TEST( Disabled )
+    REGISTER_TEST( Enabled )
+    REGISTER_TEST( Overflow )
+REGISTER_TESTS_END
+
+// Disabled
+//------------------------------------------------------------------------------
+void TestProfile::Disabled() const
+{
+    #if defined( PROFILING_ENABLED )
+        TEST_ASSERT( ProfileManager::IsEnabled() == false );
+
+        #if defined( DEBUG )
+            const uint32_t numSections( 1000 * 1000 );
+        #else
+            const uint32_t numSections( 10 * 1000 * 1000 );
+        #endif
+
+        const float time = TimeSections( numSections );
+
+        // output
+        OUTPUT( "Profiling disabled : %2.3fs - %u sections @ %2.2f ns/section\n", (double)time, numSections, (double)( time * 1000000000.0f / (float)numSections ) );
+    #endif
+}
+
+// Enabled
+//------------------------------------------------------------------------------
+void TestProfile::Enabled() const
+{
+    #if defined( PROFILING_ENABLED )
+        AStackString<> fileName;
+        GetTempFileName( "Enabled", fileName );
+
+        #if defined( DEBUG )
+            const uint32_t numSections( 100 * 1000 );
+        #else
+            const uint32_t numSections( 1000 * 1000 );
+        #endif
+
+        // Record sections in batches small enough for the ring buffer to
+        // hold, giving the background thread time to write them
+        const uint32_t batchSize( 1000 );
+        float time = 0.0f;
+        ProfileManager::Enable( fileName.Get() );
+        TEST_ASSERT( ProfileManager::IsEnabled() );
+        const uint32_t numDroppedBefore = ProfileManager::GetNumDroppedEvents();
+        for ( uint32_t i = 0; i < numSections; i += batchSize )
+        {
+            time += TimeSections( batchSize );
+            ProfileManager::SynchronizeNoTag();
+        }
+        TEST_ASSERT( ProfileManager::GetNumDroppedEvents() == numDroppedBefore );
+        ProfileManager::Disable();
+        TEST_ASSERT( ProfileManager::IsEnabled() == false );
+
+        // output
+        OUTPUT( "Profiling enabled  : %2.3fs - %u sections @ %2.2f ns/section\n", (double)time, numSections, (double)( time * 1000000000.0f / (float)numSections ) );
+
+        // Check all events were written
+        uint32_t numBegin;
+        uint32_t numEnd;
+        CountEvents( fileName, numBegin, numEnd );
+        TEST_ASSERT( numBegin == numSections );
+        TEST_ASSERT( numEnd == numSections );
+
+        FileIO::FileDelete( fileName.Get() );
+    #endif
+}
+
+// Overflow
+//------------------------------------------------------------------------------
+void TestProfile::Overflow() const
+{
+    #if defined( PROFILING_ENABLED )
+        AStackString<> fileName;
+        GetTempFileName( "Overflow", fileName );
+
+        ProfileManager::Enable( fileName.Get() );
+        const uint32_t numDroppedBefore = ProfileManager::GetNumDroppedEvents();
+
+        // Record many more nested sections than a thread's buffer can hold
+        // without giving the background thread a chance to write them
+        {
+            PROFILE_SECTION( "Outer" )
+            for ( uint32_t i = 0; i < ( 64 * 1024 ); ++i )
+            {
+                PROFILE_SECTION( "Middle" )
+                {
+                    PROFILE_SECTION( "Inner" )
+                }
+            }
+        }
+
+        ProfileManager::Disable();
+        TEST_ASSERT( ProfileManager::GetNumDroppedEvents() > numDroppedBefore );
+
+        // Every section written must be closed
+        uint32_t numBegin;
+        uint32_t numEnd;
+        CountEvents( fileName, numBegin, numEnd );
+        TEST_ASSERT( numBegin > 0 );
+        TEST_ASSERT( numBegin == numEnd );
+
+        FileIO::FileDelete( fileName.Get() );
+    #endif
+}
+
+// TimeSections
+//------------------------------------------------------------------------------
+/*static*/ float TestProfile::TimeSections( const uint32_t numSections )
+{
+    Timer timer;
+    for ( uint32_t i = 0; i < numSections; ++i )
+    {
+        PROFILE_SECTION( "TestProfile" )
+    }
+    return timer.GetElapsed();
+}
+
+// GetTempFileName
+//------------------------------------------------------------------------------
+/*static*/ void TestProfile::GetTempFileName( const char * name, AString & outFileName )
+{
+    VERIFY( FileIO::GetTempDir( outFileName ) );
+    AStackString<> buffer;
+    buffer.Format( "TestProfile.%s.%u.json", name, Process::GetCurrentId() );
+    outFileName += buffer;
+}
+
+// CountEvents
+//------------------------------------------------------------------------------
+/*static*/ void TestProfile::CountEvents( const AString & fileName, uint32_t & outNumBegin, uint32_t & outNumEnd )
+{
+    outNumBegin = 0;
+    outNumEnd = 0;
+
+    FileStream f;
+    TEST_ASSERT( f.Open( fileName.Get(), FileStream::READ_ONLY ) );
+    AString contents;
+    contents.SetLength( (uint32_t)f.GetFileSize() );
+    TEST_ASSERT( f.ReadBuffer( contents.Get(), contents.GetLength() ) == contents.GetLength() );
+    f.Close();
+
+    TEST_ASSERT( contents.BeginsWith( "[ " ) );
+    const char * pos = contents.Get();
+    while ( ( pos = contents.Find( "\"ph\":\"", pos ) ) != nullptr )
+    {
+        pos += 6;
+        if ( *pos == 'B' )
+        {
+            ++outNumBegin;
+        }
+        else if ( *pos == 'E' )
+        {
+            ++outNumEnd;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
@@ -6,6 +6,7 @@
 #include "TestFramework/UnitTest.h"
 
 #include "Core/Containers/Array.h"
+#include "Core/Math/Conversions.h"
 #include "Core/Math/Random.h"
 #include "Core/Mem/Mem.h"
 #include "Core/Mem/SmallBlockAllocator.h"
@@ -25,6 +26,8 @@ private:
 
     void SingleThreaded() const;
     void MultiThreaded() const;
+    void MultiThreadedThroughput() const;
+    void CrossThreadFree() const;
 
     // struct for managing threads
     class ThreadInfo
@@ -36,12 +39,26 @@ private:
         float                   m_TimeTaken         = 0.0f;
     };
 
+    // struct for threads allocating and freeing on behalf of each other
+    class CrossThreadInfo
+    {
+    public:
+        Thread::ThreadHandle    m_ThreadHandle      = INVALID_THREAD_HANDLE;
+        Array< uint32_t > *     m_AllocationSizes   = nullptr;
+        Array< void * > *       m_Allocs            = nullptr; // allocs to fill or free
+        uint32_t                m_Marker            = 0;       // written to (and checked in) allocs
+        bool                    m_Valid             = true;
+    };
+
     // Helper functions
     static void     GetRandomAllocSizes( const uint32_t numAllocs, Array< uint32_t> & allocSizes );
     static float    AllocateFromSystemAllocator( const Array< uint32_t > & allocSizes, const uint32_t repeatCount );
     static float    AllocateFromSmallBlockAllocator( const Array< uint32_t > & allocSizes, const uint32_t repeatCount, const bool threadSafe = true );
+    static float    RunThreads( Thread::ThreadEntryFunction func, ThreadInfo * info, const size_t numThreads );
     static uint32_t ThreadFunction_System( void * userData );
     static uint32_t ThreadFunction_SmallBlock( void * userData );
+    static uint32_t ThreadFunction_CrossThreadAlloc( void * userData );
+    static uint32_t ThreadFunction_CrossThreadFree( void * userData );
 };
 
 // Register Tests
@@ -49,6 +66,8 @@ private:
 REGISTER_TESTS_BEGIN( TestSmallBlockAllocator )
     REGISTER_TEST( SingleThreaded )
     REGISTER_TEST( MultiThreaded )
+    REGISTER_TEST( MultiThreadedThroughput )
+    REGISTER_TEST( CrossThreadFree )
 REGISTER_TESTS_END
 
 // SingleThreaded
@@ -145,6 +164,104 @@ void TestSmallBlockAllocator::MultiThreaded() const
     OUTPUT( "SmallBlockAllocator    : %2.3fs - %u allocs @ %u allocs/sec\n", (double)time2, ( numAllocs * repeatCount ), (uint32_t)( float( numAllocs * repeatCount ) / time2 ) );
 }
 
+// MultiThreadedThroughput
+//------------------------------------------------------------------------------
+void TestSmallBlockAllocator::MultiThreadedThroughput() const
+{
+    #if defined( DEBUG )
+        const uint32_t numAllocs( 10 * 1000 );
+    #else
+        const uint32_t numAllocs( 100 * 1000 );
+    #endif
+    const uint32_t repeatCount( 10 );
+
+    Array< uint32_t > allocSizes( 0, true );
+    GetRandomAllocSizes( numAllocs, allocSizes );
+
+    // Measure the combined throughput of an increasing number of threads
+    // all allocating and freeing at the same time
+    const size_t maxThreads = 8;
+    OUTPUT( "Threads | System (malloc) allocs/sec | SmallBlockAllocator allocs/sec\n" );
+    for ( size_t numThreads = 1; numThreads <= maxThreads; numThreads *= 2 )
+    {
+        ThreadInfo info[ maxThreads ];
+        for ( size_t i = 0; i < numThreads; ++i )
+        {
+            info[ i ].m_AllocationSizes = &allocSizes;
+            info[ i ].m_RepeatCount = repeatCount;
+        }
+
+        const float time1 = RunThreads( ThreadFunction_System, info, numThreads );
+        const float time2 = RunThreads( ThreadFunction_SmallBlock, info, numThreads );
+
+        const float totalAllocs = float( numThreads * numAllocs * repeatCount );
+        OUTPUT( "%7u | %26u | %30u\n", (uint32_t)numThreads, (uint32_t)( totalAllocs / time1 ), (uint32_t)( totalAllocs / time2 ) );
+    }
+}
+
+// CrossThreadFree
+//------------------------------------------------------------------------------
+void TestSmallBlockAllocator::CrossThreadFree() const
+{
+    #if defined( DEBUG )
+        const uint32_t numAllocs( 10 * 1000 );
+    #else
+        const uint32_t numAllocs( 100 * 1000 );
+    #endif
+    const uint32_t repeatCount( 10 );
+    const size_t numThreads = 4;
+
+    Array< uint32_t > allocSizes( 0, true );
+    GetRandomAllocSizes( numAllocs, allocSizes );
+
+    Array< void * > allocs[ numThreads ];
+    CrossThreadInfo info[ numThreads ];
+    for ( size_t i = 0; i < numThreads; ++i )
+    {
+        allocs[ i ].SetCapacity( numAllocs );
+        info[ i ].m_AllocationSizes = &allocSizes;
+    }
+
+    Timer timer;
+    for ( uint32_t r = 0; r < repeatCount; ++r )
+    {
+        // Each thread allocates a set of blocks, tagging them
+        for ( size_t i = 0; i < numThreads; ++i )
+        {
+            info[ i ].m_Allocs = &allocs[ i ];
+            info[ i ].m_Marker = (uint32_t)( ( r * numThreads + i ) * numAllocs );
+            info[ i ].m_ThreadHandle = Thread::CreateThread( ThreadFunction_CrossThreadAlloc, "SmallBlock", ( 64 * KILOBYTE ), (void*)&info[ i ] );
+            TEST_ASSERT( info[ i ].m_ThreadHandle != INVALID_THREAD_HANDLE );
+        }
+        for ( size_t i = 0; i < numThreads; ++i )
+        {
+            Thread::WaitForThread( info[ i ].m_ThreadHandle );
+            Thread::CloseHandle( info[ i ].m_ThreadHandle );
+        }
+
+        // Another thread checks the tags (to detect blocks handed out twice) and frees them
+        for ( size_t i = 0; i < numThreads; ++i )
+        {
+            const size_t other = ( ( i + 1 ) % numThreads );
+            info[ i ].m_Allocs = &allocs[ other ];
+            info[ i ].m_Marker = (uint32_t)( ( r * numThreads + other ) * numAllocs );
+            info[ i ].m_ThreadHandle = Thread::CreateThread( ThreadFunction_CrossThreadFree, "SmallBlock", ( 64 * KILOBYTE ), (void*)&info[ i ] );
+            TEST_ASSERT( info[ i ].m_ThreadHandle != INVALID_THREAD_HANDLE );
+        }
+        for ( size_t i = 0; i < numThreads; ++i )
+        {
+            Thread::WaitForThread( info[ i ].m_ThreadHandle );
+            Thread::CloseHandle( info[ i ].m_ThreadHandle );
+            TEST_ASSERT( info[ i ].m_Valid );
+        }
+    }
+    const float time = timer.GetElapsed();
+
+    // output
+    const uint32_t totalAllocs = (uint32_t)( numThreads * numAllocs * repeatCount );
+    OUTPUT( "SmallBlockAllocator (cross-thread free) : %2.3fs - %u allocs @ %u allocs/sec\n", (double)time, totalAllocs, (uint32_t)( float( totalAllocs ) / time ) );
+}
+
 // GetRandomAllocSizes
 //------------------------------------------------------------------------------
 /*static*/ void TestSmallBlockAllocator::GetRandomAllocSizes( const uint32_t numAllocs, Array< uint32_t > & allocSizes )
@@ -234,6 +351,31 @@ void TestSmallBlockAllocator::MultiThreaded() const
     return timer.GetElapsed();
 }
 
+// RunThreads
+//------------------------------------------------------------------------------
+/*static*/ float TestSmallBlockAllocator::RunThreads( Thread::ThreadEntryFunction func, ThreadInfo * info, const size_t numThreads )
+{
+    Timer timer;
+
+    // Create some threads
+    for ( size_t i = 0; i < numThreads; ++i )
+    {
+        info[ i ].m_ThreadHandle = Thread::CreateThread( func, "SmallBlock", ( 64 * KILOBYTE ), (void*)&info[ i ] );
+        TEST_ASSERT( info[ i ].m_ThreadHandle != INVALID_THREAD_HANDLE );
+    }
+
+    // Join the threads
+    for ( size_t i = 0; i < numThreads; ++i )
+    {
+        bool timedOut;
+        Thread::WaitForThread( info[ i ].m_ThreadHandle, 500 * 1000, timedOut );
+        Thread::CloseHandle( info[ i ].m_ThreadHandle );
+        TEST_ASSERT( timedOut == false );
+    }
+
+    return timer.GetElapsed();
+}
+
 // ThreadFunction_System
 //------------------------------------------------------------------------------
 /*static*/ uint32_t TestSmallBlockAllocator::ThreadFunction_System( void * userData )
@@ -252,4 +394,43 @@ void TestSmallBlockAllocator::MultiThreaded() const
     return 0;
 }
 
+// ThreadFunction_CrossThreadAlloc
+//------------------------------------------------------------------------------
+/*static*/ uint32_t TestSmallBlockAllocator::ThreadFunction_CrossThreadAlloc( void * userData )
+{
+    CrossThreadInfo & info = *( reinterpret_cast< CrossThreadInfo * >( userData ) );
+    const Array< uint32_t > & allocSizes = *info.m_AllocationSizes;
+    const size_t numAllocs = allocSizes.GetSize();
+
+    for ( uint32_t i = 0; i < numAllocs; ++i )
+    {
+        const size_t size = Math::Max< size_t >( allocSizes[ i ], sizeof( uint32_t ) );
+        uint32_t * mem = (uint32_t *)ALLOC( size );
+        *mem = ( info.m_Marker + i );
+        info.m_Allocs->Append( mem );
+    }
+    return 0;
+}
+
+// ThreadFunction_CrossThreadFree
+//------------------------------------------------------------------------------
+/*static*/ uint32_t TestSmallBlockAllocator::ThreadFunction_CrossThreadFree( void * userData )
+{
+    CrossThreadInfo & info = *( reinterpret_cast< CrossThreadInfo * >( userData ) );
+    Array< void * > & allocs = *info.m_Allocs;
+    const size_t numAllocs = allocs.GetSize();
+
+    for ( uint32_t i = 0; i < numAllocs; ++i )
+    {
+        uint32_t * mem = (uint32_t *)allocs[ i ];
+        if ( *mem != ( info.m_Marker + i ) )
+        {
+            info.m_Valid = false;
+        }
+        FREE( mem );
+    }
+    allocs.Clear();
+    return 0;
+}
+
 //------------------------------------------------------------------------------
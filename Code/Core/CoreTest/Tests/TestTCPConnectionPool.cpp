@@ -51,6 +51,7 @@ private:
     static uint32_t TestConnectionStuckDuringSend_ThreadFunc( void * userData );
 
     void TestConnectionFailure() const;
+    void TestUnframed() const;
 };
 
 // Helper Macros
@@ -75,6 +76,7 @@ REGISTER_TESTS_BEGIN( TestTestTCPConnectionPool )
     REGISTER_TEST( TestDataTransfer )
     REGISTER_TEST( TestConnectionStuckDuringSend )
     REGISTER_TEST( TestConnectionFailure )
+    REGISTER_TEST( TestUnframed )
 REGISTER_TESTS_END
 
 // TestOneServerMultipleClients
@@ -344,4 +346,63 @@ void TestTestTCPConnectionPool::TestConnectionFailure() const
     client.ShutdownAllConnections();
 }
 
+// TestUnframed
+//------------------------------------------------------------------------------
+void TestTestTCPConnectionPool::TestUnframed() const
+{
+    // a server which replies to a text request once it is complete
+    class TestServer : public TCPConnectionPool
+    {
+    public:
+        TestServer() { SetUnframed(); }
+        ~TestServer() { ShutdownAllConnections(); }
+        virtual void OnReceive( const ConnectionInfo * connection, void * data, uint32_t size, bool & )
+        {
+            m_Request.Append( (const char *)data, size );
+            if ( m_Request.EndsWith( "\n\n" ) )
+            {
+                Send( connection, "Reply", 5 );
+            }
+        }
+        AString m_Request;
+    };
+
+    // a client which receives raw text
+    class TestClient : public TCPConnectionPool
+    {
+    public:
+        TestClient() { SetUnframed(); }
+        ~TestClient() { ShutdownAllConnections(); }
+        virtual void OnReceive( const ConnectionInfo *, void * data, uint32_t size, bool & )
+        {
+            m_Reply.Append( (const char *)data, size );
+            m_ReplyReceivedSemaphore.Signal();
+        }
+        AString m_Reply;
+        Semaphore m_ReplyReceivedSemaphore;
+    };
+
+    const uint16_t testPort( TEST_PORT );
+
+    TestServer server;
+    TEST_ASSERT( server.Listen( testPort, true ) ); // loopback only
+
+    TestClient client;
+    const ConnectionInfo * ci = client.Connect( AStackString<>( "127.0.0.1" ), testPort );
+    TEST_ASSERT( ci );
+
+    // send a request in pieces, with no size headers
+    TEST_ASSERT( client.Send( ci, "Request", 7 ) );
+    Thread::Sleep( 50 );
+    TEST_ASSERT( client.Send( ci, "\n\n", 2 ) );
+
+    // wait for reply
+    while ( client.m_Reply.GetLength() < 5 )
+    {
+        client.m_ReplyReceivedSemaphore.Wait();
+    }
+    TEST_ASSERT( client.m_Reply == "Reply" );
+    TEST_ASSERT( server.m_Request == "Request\n\n" );
+}
+
 //------------------------------------------------------------------------------
@@ -13,6 +13,7 @@
 #if defined( __WINDOWS__ )
     #include "Core/Env/WindowsHeader.h"
     #include <Lmcons.h>
+    #include <psapi.h>
     #include <stdio.h>
 #endif
 
@@ -28,6 +29,7 @@
 #endif
 
 #if defined( __APPLE__ )
+    #include <mach/mach.h>
     #include <mach-o/dyld.h>
     extern "C"
     {
@@ -318,6 +320,46 @@ static bool IsStdOutRedirectedInternal()
     #endif
 }
 
+// GetProcessMemoryUsage
+//------------------------------------------------------------------------------
+/*static*/ uint64_t Env::GetProcessMemoryUsage()
+{
+    #if defined( __WINDOWS__ )
+        PROCESS_MEMORY_COUNTERS counters;
+        if ( ::GetProcessMemoryInfo( ::GetCurrentProcess(), &counters, sizeof( counters ) ) == FALSE )
+        {
+            return 0;
+        }
+        return counters.WorkingSetSize;
+    #elif defined( __APPLE__ )
+        mach_task_basic_info_data_t info;
+        mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+        if ( task_info( mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count ) != KERN_SUCCESS )
+        {
+            return 0;
+        }
+        return info.resident_size;
+    #elif defined( __LINUX__ )
+        // second value is the resident set size in pages
+        FILE * f = fopen( "/proc/self/statm", "r" );
+        if ( f == nullptr )
+        {
+            return 0;
+        }
+        unsigned long long size = 0;
+        unsigned long long resident = 0;
+        const int numRead = fscanf( f, "%llu %llu", &size, &resident );
+        fclose( f );
+        if ( numRead != 2 )
+        {
+            return 0;
+        }
+        return ( (uint64_t)resident * (uint64_t)sysconf( _SC_PAGESIZE ) );
+    #else
+        #error Unknown platform
+    #endif
+}
+
 // IsStdOutRedirected
 //------------------------------------------------------------------------------
 /*static*/ bool Env::IsStdOutRedirected( const bool recheck )
@@ -36,6 +36,7 @@ public:
     static void GetExePath( AString & path );
     static bool IsStdOutRedirected( const bool recheck = false );
     static bool GetLocalUserName( AString & outUserName );
+    static uint64_t GetProcessMemoryUsage(); // physical memory (working set) of this process in bytes
 
     static uint32_t GetLastErr();
     static const char * AllocEnvironmentString( const Array< AString > & environment );
@@ -74,6 +74,12 @@ bool FileStream::Open( const char * fileName, uint32_t fileMode )
             shareMode           |= FILE_SHARE_READ; // allow other readers
             creationDisposition |= CREATE_ALWAYS; // overwrite existing
         }
+        else if ( ( fileMode & APPEND ) != 0 )
+        {
+            desiredAccess       |= ( FILE_APPEND_DATA | FILE_READ_ATTRIBUTES ); // writes always go to the end
+            shareMode           |= FILE_SHARE_READ; // allow other readers
+            creationDisposition |= OPEN_ALWAYS; // keep existing
+        }
         else
         {
             ASSERT( false ); // must specify an access mode
@@ -134,6 +140,10 @@ bool FileStream::Open( const char * fileName, uint32_t fileMode )
         {
             flags |= ( O_WRONLY | O_CREAT | O_TRUNC );
         }
+        else if ( ( fileMode & APPEND ) != 0 )
+        {
+            flags |= ( O_WRONLY | O_CREAT | O_APPEND );
+        }
         else
         {
             ASSERT( false ); // must specify an access mode
@@ -19,6 +19,7 @@ public:
         WRITE_ONLY                    = 0x2,
         TEMP                          = 0x4,
         NO_RETRY_ON_SHARING_VIOLATION = 0x80,
+        APPEND                        = 0x100, // write to end of file, creating it if needed
     };
 
     bool Open( const char * fileName, uint32_t mode = FileStream::READ_ONLY );
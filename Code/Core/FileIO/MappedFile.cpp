@@ -0,0 +1,154 @@
+// MappedFile - Read-only view of the contents of a file, mapped into memory
+//------------------------------------------------------------------------------
+
+// Includes
+//------------------------------------------------------------------------------
+#include "MappedFile.h"
+
+// Core
+#include "Core/Env/Assert.h"
+
+// system
+#include <stdint.h> // SIZE_MAX
+#if defined( __WINDOWS__ )
+    #include "Core/Env/WindowsHeader.h"
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+// Static Data
+//------------------------------------------------------------------------------
+static const char s_EmptyFileData = 0; // Empty files can't be mapped, so point here instead
+
+// CONSTRUCTOR
+//------------------------------------------------------------------------------
+MappedFile::MappedFile()
+    : m_Data( nullptr )
+    , m_Size( 0 )
+    , m_IsOpen( false )
+{
+}
+
+// DESTRUCTOR
+//------------------------------------------------------------------------------
+MappedFile::~MappedFile()
+{
+    if ( IsOpen() )
+    {
+        Close();
+    }
+}
+
+// Open
+//------------------------------------------------------------------------------
+bool MappedFile::Open( const char * fileName )
+{
+    ASSERT( !IsOpen() );
+
+    #if defined( __WINDOWS__ )
+        HANDLE h = CreateFile( fileName,                // _In_     LPCTSTR lpFileName,
+                               GENERIC_READ,            // _In_     DWORD dwDesiredAccess,
+                               FILE_SHARE_READ,         // _In_     DWORD dwShareMode,
+                               nullptr,                 // _In_opt_ LPSECURITY_ATTRIBUTES lpSecurityAttributes,
+                               OPEN_EXISTING,           // _In_     DWORD dwCreationDisposition,
+                               FILE_ATTRIBUTE_NORMAL,   // _In_     DWORD dwFlagsAndAttributes,
+                               nullptr );               // _In_opt_ HANDLE hTemplateFile
+        if ( h == INVALID_HANDLE_VALUE )
+        {
+            return false;
+        }
+
+        LARGE_INTEGER fileSize;
+        if ( ( GetFileSizeEx( h, &fileSize ) == FALSE ) ||
+             ( (uint64_t)fileSize.QuadPart > (uint64_t)SIZE_MAX ) ) // can't map files bigger than the address space
+        {
+            VERIFY( CloseHandle( h ) );
+            return false;
+        }
+
+        // Empty files can't be mapped, but are valid
+        const void * data = &s_EmptyFileData;
+        if ( fileSize.QuadPart > 0 )
+        {
+            HANDLE mapping = CreateFileMapping( h, nullptr, PAGE_READONLY, 0, 0, nullptr );
+            data = mapping ? MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 ) : nullptr;
+            if ( mapping )
+            {
+                VERIFY( CloseHandle( mapping ) ); // view keeps the mapping alive
+            }
+            if ( data == nullptr )
+            {
+                VERIFY( CloseHandle( h ) );
+                return false;
+            }
+        }
+        VERIFY( CloseHandle( h ) ); // view keeps the file open
+        const size_t size = (size_t)fileSize.QuadPart;
+    #elif defined( __APPLE__ ) || defined( __LINUX__ )
+        const int fd = open( fileName, O_RDONLY | O_CLOEXEC ); // Ensure handles are not inherited by child processes
+        if ( fd == -1 )
+        {
+            return false;
+        }
+
+        // Ensure this is a file (not a directory etc)
+        struct stat s;
+        if ( ( fstat( fd, &s ) != 0 ) || ( S_ISREG( s.st_mode ) == false ) ||
+             ( (uint64_t)s.st_size > (uint64_t)SIZE_MAX ) ) // can't map files bigger than the address space
+        {
+            close( fd );
+            return false;
+        }
+
+        // Empty files can't be mapped, but are valid
+        const void * data = &s_EmptyFileData;
+        if ( s.st_size > 0 )
+        {
+            void * mem = mmap( nullptr, (size_t)s.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+            if ( mem == MAP_FAILED )
+            {
+                close( fd );
+                return false;
+            }
+            data = mem;
+        }
+        close( fd ); // view keeps the file open
+        const size_t size = (size_t)s.st_size;
+    #else
+        #error Unknown platform
+    #endif
+
+    m_Data = data;
+    m_Size = size;
+    m_IsOpen = true;
+    return true;
+}
+
+// Close
+//------------------------------------------------------------------------------
+void MappedFile::Close()
+{
+    ASSERT( IsOpen() );
+    if ( m_Size > 0 ) // Empty files are not mapped
+    {
+        #if defined( __WINDOWS__ )
+            VERIFY( UnmapViewOfFile( m_Data ) );
+        #elif defined( __APPLE__ ) || defined( __LINUX__ )
+            VERIFY( munmap( const_cast< void * >( m_Data ), m_Size ) == 0 );
+        #else
+            #error Unknown platform
+        #endif
+    }
+    else
+    {
+        ASSERT( m_Data == &s_EmptyFileData );
+    }
+    m_Data = nullptr;
+    m_Size = 0;
+    m_IsOpen = false;
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,36 @@
+// MappedFile - Read-only view of the contents of a file, mapped into memory
+//------------------------------------------------------------------------------
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+#include "Core/Env/Types.h"
+
+// MappedFile
+//  - Contents are accessed directly from the OS file cache, avoiding the
+//    copy made by reading into a buffer
+//  - The view is read-only. Writing to it is an access violation
+//  - An empty file maps successfully, with a size of zero
+//------------------------------------------------------------------------------
+class MappedFile
+{
+public:
+    explicit MappedFile();
+    ~MappedFile();
+
+    bool Open( const char * fileName );
+    void Close();
+
+    inline bool             IsOpen() const  { return m_IsOpen; }
+
+    // Access the view
+    inline const void *     GetData() const { return m_Data; }
+    inline size_t           GetSize() const { return m_Size; }
+
+private:
+    const void *    m_Data;
+    size_t          m_Size;
+    bool            m_IsOpen;
+};
+
+//------------------------------------------------------------------------------
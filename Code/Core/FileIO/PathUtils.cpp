@@ -49,7 +49,7 @@
 
     #if defined( __WINDOWS__ ) || defined( __OSX__ )
         // Case Insensitive
-        return ( cleanPathA.CompareI( cleanPathB ) == 0 );
+        return cleanPathA.EqualsI( cleanPathB );
     #endif
 }
 
@@ -0,0 +1,222 @@
+// CRC32C
+//------------------------------------------------------------------------------
+
+// Includes
+//------------------------------------------------------------------------------
+#include "CRC32C.h"
+
+// system
+#include <string.h>
+#if defined( _M_X64 ) || defined( _M_IX86 ) || defined( __x86_64__ ) || defined( __i386__ )
+    #define CRC32C_SSE42 // availability checked at runtime
+    #if defined( _MSC_VER )
+        #include <intrin.h>
+    #endif
+    #include <nmmintrin.h>
+#elif defined( __ARM_FEATURE_CRC32 )
+    #define CRC32C_ARMV8 // availability guaranteed by compiler target
+    #include <arm_acle.h>
+#endif
+
+// Defines
+//------------------------------------------------------------------------------
+#define CRC32C_POLY 0x82F63B78 // reversed 0x1EDC6F41
+
+// Intrinsics can only be used in functions compiled for SSE 4.2 (except with MSVC)
+#if defined( CRC32C_SSE42 ) && ( defined( __clang__ ) || defined( __GNUC__ ) )
+    #define CRC32C_TARGET_HARDWARE __attribute__(( target( "sse4.2" ) ))
+#else
+    #define CRC32C_TARGET_HARDWARE
+#endif
+
+// Tables for slicing-by-8
+//------------------------------------------------------------------------------
+class CRC32CTables
+{
+public:
+    CRC32CTables()
+    {
+        for ( uint32_t i = 0; i < 256; ++i )
+        {
+            uint32_t crc = i;
+            for ( uint32_t j = 0; j < 8; ++j )
+            {
+                crc = ( crc >> 1 ) ^ ( CRC32C_POLY & ( 0 - ( crc & 1 ) ) );
+            }
+            m_Table[ 0 ][ i ] = crc;
+        }
+        for ( uint32_t i = 0; i < 256; ++i )
+        {
+            uint32_t crc = m_Table[ 0 ][ i ];
+            for ( uint32_t j = 1; j < 8; ++j )
+            {
+                crc = m_Table[ 0 ][ crc & 0xFF ] ^ ( crc >> 8 );
+                m_Table[ j ][ i ] = crc;
+            }
+        }
+    }
+
+    uint32_t m_Table[ 8 ][ 256 ];
+};
+
+static const CRC32CTables & GetTables()
+{
+    static const CRC32CTables s_Tables; // thread-safe initialization on first use
+    return s_Tables;
+}
+
+// Helpers
+//------------------------------------------------------------------------------
+static inline uint64_t Read64( const uint8_t * pos )
+{
+    uint64_t value;
+    memcpy( &value, pos, sizeof( value ) ); // may be unaligned
+    return value;
+}
+
+static inline uint8_t ToLower8( uint8_t c )
+{
+    return ( ( c >= 'A' ) && ( c <= 'Z' ) ) ? (uint8_t)( c + ( 'a' - 'A' ) ) : c;
+}
+
+// Convert 8 characters to lower case at once
+static inline uint64_t ToLower64( uint64_t v )
+{
+    const uint64_t ones = 0x0101010101010101ULL;
+    const uint64_t lowBits = ( v & ( ones * 0x7F ) );
+    const uint64_t aboveA = lowBits + ( ones * ( 0x80 - 'A' ) );      // top bit set if >= 'A'
+    const uint64_t aboveZ = lowBits + ( ones * ( 0x80 - 'Z' - 1 ) );  // top bit set if > 'Z'
+    const uint64_t isUpper = ( aboveA ^ aboveZ ) & ~v & ( ones * 0x80 ); // excluding non-ASCII
+    return ( v | ( isUpper >> 2 ) ); // 0x80 -> 0x20
+}
+
+#if defined( CRC32C_SSE42 )
+    static bool HasHardwareSupport()
+    {
+        #if defined( _MSC_VER )
+            int info[ 4 ];
+            __cpuid( info, 1 );
+            return ( ( info[ 2 ] & ( 1 << 20 ) ) != 0 ); // ECX bit 20 : SSE 4.2
+        #else
+            __builtin_cpu_init();
+            return ( __builtin_cpu_supports( "sse4.2" ) != 0 );
+        #endif
+    }
+    static const bool g_CRC32CHardware = HasHardwareSupport();
+#elif defined( CRC32C_ARMV8 )
+    static const bool g_CRC32CHardware = true;
+#else
+    static const bool g_CRC32CHardware = false;
+#endif
+static bool g_CRC32CForceSoftware = false;
+
+// UpdateSoftware
+//------------------------------------------------------------------------------
+static uint32_t UpdateSoftware( uint32_t crc, const uint8_t * pos, size_t len, bool toLower )
+{
+    const uint32_t ( & t )[ 8 ][ 256 ] = GetTables().m_Table;
+
+    for ( ; len >= 8; len -= 8, pos += 8 )
+    {
+        uint64_t v = Read64( pos );
+        if ( toLower )
+        {
+            v = ToLower64( v );
+        }
+        const uint32_t lo = (uint32_t)v ^ crc;
+        const uint32_t hi = (uint32_t)( v >> 32 );
+        crc = t[ 7 ][ lo & 0xFF ] ^
+              t[ 6 ][ ( lo >> 8 ) & 0xFF ] ^
+              t[ 5 ][ ( lo >> 16 ) & 0xFF ] ^
+              t[ 4 ][ lo >> 24 ] ^
+              t[ 3 ][ hi & 0xFF ] ^
+              t[ 2 ][ ( hi >> 8 ) & 0xFF ] ^
+              t[ 1 ][ ( hi >> 16 ) & 0xFF ] ^
+              t[ 0 ][ hi >> 24 ];
+    }
+
+    for ( ; len > 0; --len, ++pos )
+    {
+        const uint8_t c = toLower ? ToLower8( *pos ) : *pos;
+        crc = t[ 0 ][ ( crc ^ c ) & 0xFF ] ^ ( crc >> 8 );
+    }
+    return crc;
+}
+
+// UpdateHardware
+//------------------------------------------------------------------------------
+#if defined( CRC32C_SSE42 ) || defined( CRC32C_ARMV8 )
+    CRC32C_TARGET_HARDWARE
+    static uint32_t UpdateHardware( uint32_t crc, const uint8_t * pos, size_t len, bool toLower )
+    {
+        for ( ; len >= 8; len -= 8, pos += 8 )
+        {
+            uint64_t v = Read64( pos );
+            if ( toLower )
+            {
+                v = ToLower64( v );
+            }
+            #if defined( CRC32C_ARMV8 )
+                crc = __crc32cd( crc, v );
+            #elif defined( _M_X64 ) || defined( __x86_64__ )
+                crc = (uint32_t)_mm_crc32_u64( crc, v );
+            #else
+                crc = _mm_crc32_u32( crc, (uint32_t)v );
+                crc = _mm_crc32_u32( crc, (uint32_t)( v >> 32 ) );
+            #endif
+        }
+
+        for ( ; len > 0; --len, ++pos )
+        {
+            const uint8_t c = toLower ? ToLower8( *pos ) : *pos;
+            #if defined( CRC32C_ARMV8 )
+                crc = __crc32cb( crc, c );
+            #else
+                crc = _mm_crc32_u8( crc, c );
+            #endif
+        }
+        return crc;
+    }
+#endif
+
+// Update
+//------------------------------------------------------------------------------
+/*static*/ uint32_t CRC32C::Update( uint32_t crc32c, const void * buffer, size_t len )
+{
+    #if defined( CRC32C_SSE42 ) || defined( CRC32C_ARMV8 )
+        if ( g_CRC32CHardware && ( g_CRC32CForceSoftware == false ) )
+        {
+            return UpdateHardware( crc32c, (const uint8_t *)buffer, len, false );
+        }
+    #endif
+    return UpdateSoftware( crc32c, (const uint8_t *)buffer, len, false );
+}
+
+// UpdateLower
+//------------------------------------------------------------------------------
+/*static*/ uint32_t CRC32C::UpdateLower( uint32_t crc32c, const void * buffer, size_t len )
+{
+    #if defined( CRC32C_SSE42 ) || defined( CRC32C_ARMV8 )
+        if ( g_CRC32CHardware && ( g_CRC32CForceSoftware == false ) )
+        {
+            return UpdateHardware( crc32c, (const uint8_t *)buffer, len, true );
+        }
+    #endif
+    return UpdateSoftware( crc32c, (const uint8_t *)buffer, len, true );
+}
+
+// IsHardwareAccelerated
+//------------------------------------------------------------------------------
+/*static*/ bool CRC32C::IsHardwareAccelerated()
+{
+    return ( g_CRC32CHardware && ( g_CRC32CForceSoftware == false ) );
+}
+
+// SetForceSoftware
+//------------------------------------------------------------------------------
+/*static*/ void CRC32C::SetForceSoftware( bool forceSoftware )
+{
+    g_CRC32CForceSoftware = forceSoftware;
+}
+
+//------------------------------------------------------------------------------
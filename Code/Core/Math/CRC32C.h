@@ -0,0 +1,38 @@
+// CRC32C.h
+//------------------------------------------------------------------------------
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+#include "Core/Env/Types.h"
+#include "Core/Strings/AString.h"
+
+// CRC32C
+//  - CRC-32C (Castagnoli polynomial), which has hardware support on most CPUs
+//    (SSE 4.2 and ARMv8), unlike CRC32. A table driven version is used when
+//    that is not available.
+//  - Produces different values to CRC32, so can't replace it where hashes are
+//    persisted
+//------------------------------------------------------------------------------
+class CRC32C
+{
+public:
+    static inline uint32_t  Start() { return 0xFFFFFFFF; }
+    static uint32_t         Update( uint32_t crc32c, const void * buffer, size_t len );
+    static uint32_t         UpdateLower( uint32_t crc32c, const void * buffer, size_t len );
+    static inline uint32_t  Stop( uint32_t crc32c ) { return ( crc32c ^ 0xFFFFFFFF ); }
+
+    inline static uint32_t  Calc( const void * buffer, size_t len )         { return Stop( Update( Start(), buffer, len ) ); }
+    inline static uint32_t  CalcLower( const void * buffer, size_t len )    { return Stop( UpdateLower( Start(), buffer, len ) ); }
+
+    inline static uint32_t  Calc( const AString & string )      { return Calc( string.Get(), string.GetLength() ); }
+    inline static uint32_t  CalcLower( const AString & string ) { return CalcLower( string.Get(), string.GetLength() ); }
+
+    static bool             IsHardwareAccelerated();
+
+    // Use the table driven version even when hardware support is available
+    // (internal, so tests can check both versions on the same machine)
+    static void             SetForceSoftware( bool forceSoftware );
+};
+
+//------------------------------------------------------------------------------
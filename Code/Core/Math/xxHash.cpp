@@ -0,0 +1,111 @@
+// xxHash.cpp
+//------------------------------------------------------------------------------
+
+// Includes
+//------------------------------------------------------------------------------
+#include "xxHash.h"
+
+// Core
+#include "Core/Env/Assert.h"
+
+// External
+#define XXH_STATIC_LINKING_ONLY
+#include "xxhash.h"
+
+// Calc128
+//------------------------------------------------------------------------------
+/*static*/ xxHash3::Hash128 xxHash3::Calc128( const void * buffer, size_t len )
+{
+    const XXH128_hash_t hash = XXH3_128bits( buffer, len );
+    Hash128 result;
+    result.m_Low = hash.low64;
+    result.m_High = hash.high64;
+    return result;
+}
+
+// xxHash64Accumulator CONSTRUCTOR
+//------------------------------------------------------------------------------
+xxHash64Accumulator::xxHash64Accumulator()
+{
+    // Opaque state storage must be compatible with the real type
+    static_assert( sizeof( m_State ) >= sizeof( XXH64_state_t ), "Increase m_State size" );
+    static_assert( __alignof( uint64_t ) >= __alignof( XXH64_state_t ), "Incompatible alignment" );
+
+    Reset();
+}
+
+// Reset
+//------------------------------------------------------------------------------
+void xxHash64Accumulator::Reset()
+{
+    VERIFY( XXH64_reset( (XXH64_state_t *)m_State, xxHash::XXHASH_SEED ) == XXH_OK );
+}
+
+// Update
+//------------------------------------------------------------------------------
+void xxHash64Accumulator::Update( const void * buffer, size_t len )
+{
+    VERIFY( XXH64_update( (XXH64_state_t *)m_State, buffer, len ) == XXH_OK );
+}
+
+// Digest
+//------------------------------------------------------------------------------
+uint64_t xxHash64Accumulator::Digest() const
+{
+    return XXH64_digest( (const XXH64_state_t *)m_State );
+}
+
+// xxHash3Accumulator CONSTRUCTOR
+//------------------------------------------------------------------------------
+xxHash3Accumulator::xxHash3Accumulator()
+{
+    // Opaque state storage must be compatible with the real type
+    static_assert( STATE_SIZE >= sizeof( XXH3_state_t ), "Increase STATE_SIZE" );
+    static_assert( STATE_ALIGNMENT >= __alignof( XXH3_state_t ), "Increase STATE_ALIGNMENT" );
+
+    Reset();
+}
+
+// Reset
+//------------------------------------------------------------------------------
+void xxHash3Accumulator::Reset()
+{
+    // The 64 and 128 bit variants share the same state and update logic, so
+    // either digest can be obtained
+    VERIFY( XXH3_64bits_reset( (XXH3_state_t *)GetState() ) == XXH_OK );
+}
+
+// Update
+//------------------------------------------------------------------------------
+void xxHash3Accumulator::Update( const void * buffer, size_t len )
+{
+    VERIFY( XXH3_64bits_update( (XXH3_state_t *)GetState(), buffer, len ) == XXH_OK );
+}
+
+// Digest64
+//------------------------------------------------------------------------------
+uint64_t xxHash3Accumulator::Digest64() const
+{
+    return XXH3_64bits_digest( (const XXH3_state_t *)GetState() );
+}
+
+// Digest128
+//------------------------------------------------------------------------------
+xxHash3::Hash128 xxHash3Accumulator::Digest128() const
+{
+    const XXH128_hash_t hash = XXH3_128bits_digest( (const XXH3_state_t *)GetState() );
+    xxHash3::Hash128 result;
+    result.m_Low = hash.low64;
+    result.m_High = hash.high64;
+    return result;
+}
+
+// GetState
+//------------------------------------------------------------------------------
+void * xxHash3Accumulator::GetState() const
+{
+    const size_t pos = (size_t)m_State;
+    return (void *)( ( pos + ( STATE_ALIGNMENT - 1 ) ) & ~( STATE_ALIGNMENT - 1 ) );
+}
+
+//------------------------------------------------------------------------------
@@ -10,8 +10,9 @@
 // avoid including xxhash header directly
 extern "C"
 {
-    unsigned int XXH32( const void * input, size_t length, unsigned seed );
-    unsigned long long XXH64( const void * input, size_t length, unsigned long long seed );
+    uint32_t XXH32( const void * input, size_t length, uint32_t seed );
+    uint64_t XXH64( const void * input, size_t length, uint64_t seed );
+    uint64_t XXH3_64bits( const void * input, size_t length );
 };
 
 // xxHash
@@ -25,9 +26,73 @@ public:
     inline static uint32_t  Calc32( const AString & string ) { return Calc32( string.Get(), string.GetLength() ); }
     inline static uint64_t  Calc64( const AString & string ) { return Calc64( string.Get(), string.GetLength() ); }
 private:
+    friend class xxHash64Accumulator;
     enum { XXHASH_SEED = 0x0 }; // arbitrarily chosen random seed
 };
 
+// xxHash3
+//  - Faster than xxHash (particularly for short inputs) but produces different
+//    values, so can't replace it where hashes are persisted or shared between
+//    machines (build database, cache keys, etc.)
+//------------------------------------------------------------------------------
+class xxHash3
+{
+public:
+    struct Hash128
+    {
+        uint64_t m_Low;
+        uint64_t m_High;
+
+        inline bool operator == ( const Hash128 & other ) const { return ( m_Low == other.m_Low ) && ( m_High == other.m_High ); }
+        inline bool operator != ( const Hash128 & other ) const { return !( *this == other ); }
+    };
+
+    inline static uint64_t  Calc64( const void * buffer, size_t len );
+    static Hash128          Calc128( const void * buffer, size_t len );
+
+    inline static uint64_t  Calc64( const AString & string ) { return Calc64( string.Get(), string.GetLength() ); }
+    inline static Hash128   Calc128( const AString & string ) { return Calc128( string.Get(), string.GetLength() ); }
+};
+
+// xxHash64Accumulator
+//  - Calculates xxHash::Calc64 for data provided in pieces (for example, as it
+//    is read) without gathering it into a single buffer
+//------------------------------------------------------------------------------
+class xxHash64Accumulator
+{
+public:
+    xxHash64Accumulator();
+
+    void        Reset();
+    void        Update( const void * buffer, size_t len );
+    uint64_t    Digest() const; // can be called at any time and doesn't end accumulation
+
+private:
+    uint64_t    m_State[ 11 ]; // XXH64_state_t (size checked in xxHash.cpp)
+};
+
+// xxHash3Accumulator
+//  - As xxHash64Accumulator, but for xxHash3::Calc64 and xxHash3::Calc128
+//------------------------------------------------------------------------------
+class xxHash3Accumulator
+{
+public:
+    xxHash3Accumulator();
+
+    void                Reset();
+    void                Update( const void * buffer, size_t len );
+    uint64_t            Digest64() const;
+    xxHash3::Hash128    Digest128() const;
+
+private:
+    void *              GetState() const;
+
+    // XXH3_state_t requires 64 byte alignment, which heap allocations can't
+    // provide, so the state is aligned within this buffer (size checked in xxHash.cpp)
+    enum : size_t { STATE_SIZE = 576, STATE_ALIGNMENT = 64 };
+    uint8_t             m_State[ STATE_SIZE + STATE_ALIGNMENT - 1 ];
+};
+
 // Calc32
 //------------------------------------------------------------------------------
 /*static*/ uint32_t xxHash::Calc32( const void * buffer, size_t len )
@@ -42,4 +107,11 @@ private:
     return XXH64( buffer, len, XXHASH_SEED );
 }
 
+// Calc64
+//------------------------------------------------------------------------------
+/*static*/ uint64_t xxHash3::Calc64( const void * buffer, size_t len )
+{
+    return XXH3_64bits( buffer, len );
+}
+
 //------------------------------------------------------------------------------
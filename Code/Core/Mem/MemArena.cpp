@@ -0,0 +1,159 @@
+// MemArena - Linear allocator for transient data, released in one step
+//------------------------------------------------------------------------------
+
+// Includes
+//------------------------------------------------------------------------------
+#include "MemArena.h"
+
+// Core
+#include "Core/Env/Assert.h"
+#include "Core/Math/Conversions.h"
+#include "Core/Mem/Mem.h"
+#include "Core/Mem/MemDebug.h"
+
+// Static Data
+//------------------------------------------------------------------------------
+static THREAD_LOCAL MemArena * s_ThreadArena = nullptr;
+
+// CONSTRUCTOR
+//------------------------------------------------------------------------------
+MemArena::MemArena( size_t chunkSize )
+    : m_Chunks( nullptr )
+    , m_Pos( nullptr )
+    , m_End( nullptr )
+    , m_ChunkSize( chunkSize )
+    , m_BytesUsed( 0 )
+    , m_PeakBytesUsed( 0 )
+    , m_NumAllocations( 0 )
+    , m_NumChunkAllocations( 0 )
+{
+    ASSERT( chunkSize > 0 );
+}
+
+// DESTRUCTOR
+//------------------------------------------------------------------------------
+MemArena::~MemArena()
+{
+    ASSERT( s_ThreadArena != this ); // Destroyed while in use by a MemArenaScope?
+    FreeChunks();
+}
+
+// Alloc
+//------------------------------------------------------------------------------
+void * MemArena::Alloc( size_t size, size_t alignment )
+{
+    ++m_NumAllocations;
+
+    // Carve from the current chunk if possible
+    char * mem = (char *)Math::RoundUp( (size_t)m_Pos, alignment );
+    if ( m_Pos && ( mem + size <= m_End ) )
+    {
+        m_Pos = ( mem + size );
+        return mem;
+    }
+
+    return AllocFromNewChunk( size, alignment );
+}
+
+// Reset
+//------------------------------------------------------------------------------
+void MemArena::Reset()
+{
+    if ( m_Chunks == nullptr )
+    {
+        return; // Nothing was allocated
+    }
+
+    const size_t bytesUsed = m_BytesUsed + (size_t)( m_Pos - (char *)( m_Chunks + 1 ) );
+    m_PeakBytesUsed = Math::Max( m_PeakBytesUsed, bytesUsed );
+
+    if ( m_Chunks->m_Next == nullptr )
+    {
+        // Everything fitted in one chunk, so keep it for reuse
+        m_Pos = (char *)( m_Chunks + 1 );
+        #if defined( MEM_FILL_FREED_ALLOCATIONS )
+            MemDebug::FillMem( m_Pos, m_Chunks->m_Size, MemDebug::MEM_FILL_FREED_ALLOCATION_PATTERN );
+        #endif
+        return;
+    }
+
+    // Several chunks were needed. Replace them with a single chunk big enough
+    // for the same usage next time (allocated on demand)
+    FreeChunks();
+    m_ChunkSize = Math::Min< size_t >( Math::Max( m_ChunkSize, Math::RoundUp< size_t >( bytesUsed, 64 * 1024 ) ), MAX_RETAINED_CHUNK_SIZE );
+}
+
+// GetThreadArena
+//------------------------------------------------------------------------------
+/*static*/ MemArena * MemArena::GetThreadArena()
+{
+    return s_ThreadArena;
+}
+
+// AllocFromNewChunk
+//------------------------------------------------------------------------------
+void * MemArena::AllocFromNewChunk( size_t size, size_t alignment )
+{
+    // Account for the unused tail of the chunk being retired
+    if ( m_Chunks )
+    {
+        m_BytesUsed += (size_t)( m_Pos - (char *)( m_Chunks + 1 ) );
+    }
+
+    // Oversized allocations get a chunk of their own
+    const size_t chunkSize = Math::Max( m_ChunkSize, size + alignment );
+    Chunk * chunk = (Chunk *)ALLOC( sizeof( Chunk ) + chunkSize );
+    ++m_NumChunkAllocations;
+    chunk->m_Next = m_Chunks;
+    chunk->m_Size = chunkSize;
+    m_Chunks = chunk;
+    m_End = (char *)( chunk + 1 ) + chunkSize;
+
+    char * mem = (char *)Math::RoundUp( (size_t)( chunk + 1 ), alignment );
+    ASSERT( mem + size <= m_End );
+    m_Pos = ( mem + size );
+    return mem;
+}
+
+// FreeChunks
+//------------------------------------------------------------------------------
+void MemArena::FreeChunks()
+{
+    Chunk * chunk = m_Chunks;
+    while ( chunk )
+    {
+        Chunk * next = chunk->m_Next;
+        FREE( chunk );
+        chunk = next;
+    }
+    m_Chunks = nullptr;
+    m_Pos = nullptr;
+    m_End = nullptr;
+    m_BytesUsed = 0;
+}
+
+// MemArenaScope (CONSTRUCTOR)
+//------------------------------------------------------------------------------
+MemArenaScope::MemArenaScope( MemArena * arena )
+    : m_Arena( arena )
+{
+    if ( m_Arena )
+    {
+        ASSERT( s_ThreadArena == nullptr ); // Scopes can't be nested
+        s_ThreadArena = m_Arena;
+    }
+}
+
+// MemArenaScope (DESTRUCTOR)
+//------------------------------------------------------------------------------
+MemArenaScope::~MemArenaScope()
+{
+    if ( m_Arena )
+    {
+        ASSERT( s_ThreadArena == m_Arena );
+        s_ThreadArena = nullptr;
+        m_Arena->Reset();
+    }
+}
+
+//------------------------------------------------------------------------------
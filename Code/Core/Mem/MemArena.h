@@ -0,0 +1,72 @@
+// MemArena - Linear allocator for transient data, released in one step
+//------------------------------------------------------------------------------
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+#include "Core/Env/Types.h"
+
+// MemArena
+//  - Allocations are carved linearly from chunks and are never freed individually
+//  - Reset releases everything at once. The memory is kept for reuse, sized to
+//    cover the peak usage since the last Reset, so steady state use makes no
+//    calls to the system allocator at all
+//  - Arrays and AStrings which opt-in with UseThreadArena() allocate from the
+//    arena made current on the calling thread by a MemArenaScope
+//------------------------------------------------------------------------------
+class MemArena
+{
+public:
+    explicit MemArena( size_t chunkSize = DEFAULT_CHUNK_SIZE );
+    ~MemArena();
+
+    void *          Alloc( size_t size, size_t alignment = sizeof( void * ) );
+    void            Reset();
+
+    // Stats
+    inline uint64_t GetNumAllocations() const   { return m_NumAllocations; }
+    inline uint64_t GetNumChunkAllocations() const { return m_NumChunkAllocations; }
+    inline size_t   GetPeakBytesUsed() const    { return m_PeakBytesUsed; }
+
+    // The arena for the calling thread (or nullptr)
+    static MemArena * GetThreadArena();
+
+    enum : uint32_t { DEFAULT_CHUNK_SIZE = ( 256 * 1024 ) };
+    enum : uint32_t { MAX_RETAINED_CHUNK_SIZE = ( 16 * 1024 * 1024 ) };
+
+protected:
+    friend class MemArenaScope;
+
+    NO_INLINE void * AllocFromNewChunk( size_t size, size_t alignment );
+    void            FreeChunks();
+
+    struct Chunk
+    {
+        Chunk *     m_Next;
+        size_t      m_Size;     // usable size, excluding this header
+    };
+
+    Chunk *         m_Chunks;       // most recent first
+    char *          m_Pos;          // next free byte in most recent chunk
+    char *          m_End;          // end of most recent chunk
+    size_t          m_ChunkSize;    // size for new chunks
+    size_t          m_BytesUsed;    // bytes in chunks prior to the most recent one
+    size_t          m_PeakBytesUsed;
+    uint64_t        m_NumAllocations;
+    uint64_t        m_NumChunkAllocations;
+};
+
+// MemArenaScope - make an arena current for the calling thread, releasing all
+//                 allocations made from it when the scope ends
+//------------------------------------------------------------------------------
+class MemArenaScope
+{
+public:
+    explicit MemArenaScope( MemArena * arena ); // arena can be nullptr (no-op)
+    ~MemArenaScope();
+
+private:
+    MemArena *      m_Arena;
+};
+
+//------------------------------------------------------------------------------
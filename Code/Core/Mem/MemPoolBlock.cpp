@@ -92,6 +92,47 @@ void MemPoolBlock::Free( void * ptr )
     #endif
 }
 
+// AllocChain
+//------------------------------------------------------------------------------
+void * MemPoolBlock::AllocChain( uint32_t maxCount, uint32_t & outCount )
+{
+    ASSERT( maxCount > 0 );
+
+    if ( m_FreeBlockChain == nullptr )
+    {
+        if ( AllocPage() == false )
+        {
+            outCount = 0;
+            return nullptr;
+        }
+        ASSERT( m_FreeBlockChain );
+    }
+
+    // Detach up to maxCount blocks from the front of the free chain
+    FreeBlock * const firstBlock = m_FreeBlockChain;
+    FreeBlock * lastBlock = firstBlock;
+    uint32_t count = 1;
+    while ( ( count < maxCount ) && lastBlock->m_Next )
+    {
+        lastBlock = lastBlock->m_Next;
+        ++count;
+    }
+    m_FreeBlockChain = lastBlock->m_Next;
+    lastBlock->m_Next = nullptr;
+
+    #ifdef DEBUG
+        m_NumActiveAllocations += count;
+        m_NumLifetimeAllocations = ( m_NumLifetimeAllocations < ( 0xFFFFFFFF - count ) ) ? ( m_NumLifetimeAllocations + count ) : 0xFFFFFFFF;
+        if ( m_NumActiveAllocations > m_PeakActiveAllocations )
+        {
+            m_PeakActiveAllocations = m_NumActiveAllocations;
+        }
+    #endif
+
+    outCount = count;
+    return static_cast< void * >( firstBlock );
+}
+
 // AlocPage
 //------------------------------------------------------------------------------
 NO_INLINE bool MemPoolBlock::AllocPage()
@@ -17,6 +17,9 @@ public:
     void *  Alloc();
     void    Free( void * ptr );
 
+    // Allocate up to maxCount blocks at once, linked through their first word
+    void *  AllocChain( uint32_t maxCount, uint32_t & outCount );
+
     enum { MEMPOOLBLOCK_PAGE_SIZE = 64 * 1024 };
 
 protected:
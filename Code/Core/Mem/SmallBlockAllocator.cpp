@@ -40,6 +40,7 @@
 /*static*/ uint64_t                             SmallBlockAllocator::s_BucketMemBucketMemory[ BUCKET_NUM_BUCKETS * sizeof( MemBucket ) / sizeof (uint64_t) ];
 /*static*/ SmallBlockAllocator::MemBucket *     SmallBlockAllocator::s_Buckets( nullptr );
 /*static*/ uint8_t                              SmallBlockAllocator::s_BucketMappingTable[ BUCKET_MAPPING_TABLE_SIZE ] = { 0 };
+/*static*/ THREAD_LOCAL SmallBlockAllocator::ThreadCache SmallBlockAllocator::s_ThreadCache = { { nullptr }, { 0 }, false };
 
 // InitBuckets
 //------------------------------------------------------------------------------
@@ -90,6 +91,7 @@ NO_INLINE void SmallBlockAllocator::InitBuckets()
         for ( uint32_t i = 0; i < BUCKET_NUM_BUCKETS; ++i )
         {
             MemBucket & bucket = s_Buckets[ i ];
+            // NOTE: Blocks held in thread caches are counted as active
             const uint32_t numLive = bucket.m_NumActiveAllocations; //GetNumActiveAllocations();
             const uint32_t blockSize = bucket.m_BlockSize; //GetBlockSize();
             const uint32_t numPeak = bucket.m_PeakActiveAllocations;
@@ -148,17 +150,8 @@ void * SmallBlockAllocator::Alloc( size_t size, size_t align )
     #endif
 
     // Alloc
-    if ( s_ThreadSafeAllocs )
-    {
-        bucket.m_Mutex.Lock();
-    }
-
-    void * ptr = bucket.Alloc();
-
-    if ( s_ThreadSafeAllocs )
-    {
-        bucket.m_Mutex.Unlock();
-    }
+    void * ptr = s_ThreadSafeAllocs ? AllocFromThreadCache( bucketIndex )
+                                    : bucket.Alloc();
 
     // Debug fill
     #if defined( MEM_FILL_NEW_ALLOCATIONS )
@@ -202,14 +195,11 @@ bool SmallBlockAllocator::Free( void * ptr )
     // Free it
     if ( s_ThreadSafeAllocs )
     {
-        bucket.m_Mutex.Lock();
+        FreeToThreadCache( bucketIndex, ptr );
     }
-
-    bucket.Free( ptr );
-
-    if ( s_ThreadSafeAllocs )
+    else
     {
-        bucket.m_Mutex.Unlock();
+        bucket.Free( ptr );
     }
 
     return true;
@@ -245,6 +235,143 @@ bool SmallBlockAllocator::Free( void * ptr )
     s_ThreadSafeAllocs = ( !singleThreadedMode );
 }
 
+// ReleaseThreadCache
+//------------------------------------------------------------------------------
+/*static*/ void SmallBlockAllocator::ReleaseThreadCache()
+{
+    ThreadCache & cache = s_ThreadCache;
+    cache.m_Released = true;
+
+    for ( size_t i = 0; i < BUCKET_NUM_BUCKETS; ++i )
+    {
+        if ( cache.m_NumBlocks[ i ] > 0 )
+        {
+            FlushThreadCache( i, cache.m_NumBlocks[ i ] );
+        }
+    }
+}
+
+// AllocFromThreadCache
+//------------------------------------------------------------------------------
+/*static*/ void * SmallBlockAllocator::AllocFromThreadCache( size_t bucketIndex )
+{
+    ThreadCache & cache = s_ThreadCache;
+
+    MemBucket::FreeBlock * block = cache.m_Blocks[ bucketIndex ];
+    if ( block == nullptr )
+    {
+        block = RefillThreadCache( bucketIndex );
+        if ( block == nullptr )
+        {
+            return nullptr; // Out of bucket memory
+        }
+    }
+
+    // Take first block from the cache
+    cache.m_Blocks[ bucketIndex ] = block->m_Next;
+    --cache.m_NumBlocks[ bucketIndex ];
+    return static_cast< void * >( block );
+}
+
+// FreeToThreadCache
+//------------------------------------------------------------------------------
+/*static*/ void SmallBlockAllocator::FreeToThreadCache( size_t bucketIndex, void * ptr )
+{
+    ThreadCache & cache = s_ThreadCache;
+
+    // Insert block into head of the cache, regardless of which thread allocated it
+    MemBucket::FreeBlock * block = static_cast< MemBucket::FreeBlock * >( ptr );
+    block->m_Next = cache.m_Blocks[ bucketIndex ];
+    cache.m_Blocks[ bucketIndex ] = block;
+    const uint32_t numBlocks = ++cache.m_NumBlocks[ bucketIndex ];
+
+    // Return excess blocks to the bucket
+    if ( cache.m_Released )
+    {
+        FlushThreadCache( bucketIndex, numBlocks );
+    }
+    else if ( numBlocks >= THREAD_CACHE_MAX_SIZE )
+    {
+        FlushThreadCache( bucketIndex, THREAD_CACHE_BATCH_SIZE );
+    }
+}
+
+// RefillThreadCache
+//------------------------------------------------------------------------------
+/*static*/ NO_INLINE SmallBlockAllocator::MemBucket::FreeBlock * SmallBlockAllocator::RefillThreadCache( size_t bucketIndex )
+{
+    ThreadCache & cache = s_ThreadCache;
+    ASSERT( cache.m_Blocks[ bucketIndex ] == nullptr );
+    ASSERT( cache.m_NumBlocks[ bucketIndex ] == 0 );
+    MemBucket & bucket = s_Buckets[ bucketIndex ];
+
+    // Once this thread has released its cache, blocks are taken one at a
+    // time so nothing is left cached
+    const uint32_t batchSize = cache.m_Released ? 1 : THREAD_CACHE_BATCH_SIZE;
+
+    bucket.m_Mutex.Lock();
+
+    // Reuse blocks returned by thread caches before committing new pages
+    if ( ( bucket.m_FreeBlockChain == nullptr ) && AtomicLoadRelaxed( &bucket.m_RemoteFreeChain ) )
+    {
+        bucket.m_FreeBlockChain = AtomicExchange( &bucket.m_RemoteFreeChain, (MemBucket::FreeBlock *)nullptr );
+
+        // Blocks which were in thread caches are no longer active
+        #if defined( DEBUG )
+            for ( const MemBucket::FreeBlock * block = bucket.m_FreeBlockChain; block; block = block->m_Next )
+            {
+                --bucket.m_NumActiveAllocations;
+            }
+        #endif
+    }
+
+    uint32_t numBlocks;
+    MemBucket::FreeBlock * first = static_cast< MemBucket::FreeBlock * >( bucket.AllocChain( batchSize, numBlocks ) );
+
+    bucket.m_Mutex.Unlock();
+
+    cache.m_Blocks[ bucketIndex ] = first;
+    cache.m_NumBlocks[ bucketIndex ] = numBlocks;
+    return first;
+}
+
+// FlushThreadCache
+//------------------------------------------------------------------------------
+/*static*/ NO_INLINE void SmallBlockAllocator::FlushThreadCache( size_t bucketIndex, uint32_t numBlocks )
+{
+    ThreadCache & cache = s_ThreadCache;
+    ASSERT( ( numBlocks > 0 ) && ( numBlocks <= cache.m_NumBlocks[ bucketIndex ] ) );
+
+    // Detach blocks from the head of the cache
+    MemBucket::FreeBlock * const first = cache.m_Blocks[ bucketIndex ];
+    MemBucket::FreeBlock * last = first;
+    for ( uint32_t i = 1; i < numBlocks; ++i )
+    {
+        last = last->m_Next;
+    }
+    cache.m_Blocks[ bucketIndex ] = last->m_Next;
+    cache.m_NumBlocks[ bucketIndex ] -= numBlocks;
+
+    PushRemoteFreeChain( s_Buckets[ bucketIndex ], first, last );
+}
+
+// PushRemoteFreeChain
+//------------------------------------------------------------------------------
+/*static*/ void SmallBlockAllocator::PushRemoteFreeChain( MemBucket & bucket, MemBucket::FreeBlock * first, MemBucket::FreeBlock * last )
+{
+    // Only whole chains are ever removed (by exchanging the head with null) so
+    // pushing with compare-exchange is not susceptible to ABA problems
+    for ( ;; )
+    {
+        MemBucket::FreeBlock * head = AtomicLoadRelaxed( &bucket.m_RemoteFreeChain );
+        last->m_Next = head;
+        if ( AtomicCompareExchange( &bucket.m_RemoteFreeChain, head, first ) )
+        {
+            return;
+        }
+    }
+}
+
 // AllocateMemoryForPage
 //------------------------------------------------------------------------------
 /*virtual*/ void * SmallBlockAllocator::MemBucket::AllocateMemoryForPage()
@@ -19,6 +19,7 @@
 
 // Includes
 //------------------------------------------------------------------------------
+#include "Core/Env/Types.h"
 #include "Core/Mem/MemPoolBlock.h"
 #include "Core/Process/Mutex.h"
 
@@ -36,6 +37,10 @@
         // Hint when operating only on a single thread as we can greatly reduce allocation cost
         static void     SetSingleThreadedMode( bool singleThreadedMode );
 
+        // Return blocks cached by the calling thread so other threads can use them.
+        // Called automatically on exit by threads created with Thread::CreateThread.
+        static void     ReleaseThreadCache();
+
         #if defined( DEBUG )
             static void DumpStats();
         #endif
@@ -66,10 +71,36 @@
 
             friend class SmallBlockAllocator;
             Mutex           m_Mutex;
+
+            // Blocks returned by thread caches, pushed and taken without the lock
+            FreeBlock * volatile m_RemoteFreeChain = nullptr;
         };
 
         friend class MemBucket;
 
+        // Per-thread caches
+        //  - In thread-safe mode, each thread allocates from and frees to its own
+        //    list of blocks for each bucket without any locking or atomics
+        //  - Empty lists are refilled with a batch of blocks from the bucket
+        //  - Lists which grow too long (for example on a thread freeing memory
+        //    allocated by another) return a batch to the bucket lock-free, which
+        //    the bucket reuses once it runs out of its own free blocks
+        static const uint32_t THREAD_CACHE_BATCH_SIZE = 32;
+        static const uint32_t THREAD_CACHE_MAX_SIZE = ( THREAD_CACHE_BATCH_SIZE * 2 );
+
+        struct ThreadCache
+        {
+            MemBucket::FreeBlock *  m_Blocks[ BUCKET_NUM_BUCKETS ];
+            uint32_t                m_NumBlocks[ BUCKET_NUM_BUCKETS ];
+            bool                    m_Released; // Thread is exiting - don't cache anything else
+        };
+
+        static void *       AllocFromThreadCache( size_t bucketIndex );
+        static void         FreeToThreadCache( size_t bucketIndex, void * ptr );
+        static MemBucket::FreeBlock * RefillThreadCache( size_t bucketIndex );
+        static void         FlushThreadCache( size_t bucketIndex, uint32_t numBlocks );
+        static void         PushRemoteFreeChain( MemBucket & bucket, MemBucket::FreeBlock * first, MemBucket::FreeBlock * last );
+
         // Single Threaded Mode
         static bool         s_ThreadSafeAllocs;
         #if defined( DEBUG )
@@ -85,6 +116,9 @@
         static uint64_t     s_BucketMemBucketMemory[ BUCKET_NUM_BUCKETS * sizeof( MemBucket ) / sizeof (uint64_t) ];
         static MemBucket *  s_Buckets;
 
+        // Cache for the current thread
+        static THREAD_LOCAL ThreadCache s_ThreadCache;
+
         // A table to allow 0(1) conversion of any address to the bucket that owns it
         static uint8_t      s_BucketMappingTable[ BUCKET_MAPPING_TABLE_SIZE ];
     };
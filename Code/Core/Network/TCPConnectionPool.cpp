@@ -149,6 +149,9 @@ TCPConnectionPool::TCPConnectionPool()
     : m_ListenConnection( nullptr )
     , m_Connections( 8, true )
     , m_ShuttingDown( false )
+    , m_Unframed( false )
+    , m_BytesSent( 0 )
+    , m_BytesReceived( 0 )
 {
 }
 
@@ -211,7 +214,7 @@ void TCPConnectionPool::ShutdownAllConnections()
 
 // Listen
 //------------------------------------------------------------------------------
-bool TCPConnectionPool::Listen( uint16_t port )
+bool TCPConnectionPool::Listen( uint16_t port, bool loopbackOnly )
 {
     // must not be listening already
     ASSERT( m_ListenConnection == nullptr );
@@ -233,7 +236,7 @@ bool TCPConnectionPool::Listen( uint16_t port )
     memset( &addrInfo, 0, sizeof( addrInfo ) );
     addrInfo.sin_family = AF_INET;
     addrInfo.sin_port = htons( port );
-    addrInfo.sin_addr.s_addr = INADDR_ANY;
+    addrInfo.sin_addr.s_addr = loopbackOnly ? htonl( INADDR_LOOPBACK ) : INADDR_ANY;
 
     // bind
     if ( bind( sockfd, (struct sockaddr *)&addrInfo, sizeof( addrInfo ) ) != 0 )
@@ -499,6 +502,14 @@ size_t TCPConnectionPool::GetNumConnections() const
 //------------------------------------------------------------------------------
 bool TCPConnectionPool::Send( const ConnectionInfo * connection, const void * data, size_t size, uint32_t timeoutMS )
 {
+    if ( m_Unframed )
+    {
+        SendBuffer buffer;
+        buffer.size = (uint32_t)size;
+        buffer.data = data;
+        return SendInternal( connection, &buffer, 1, timeoutMS );
+    }
+
     SendBuffer buffers[ 2 ]; // size + data
 
     // size
@@ -516,6 +527,8 @@ bool TCPConnectionPool::Send( const ConnectionInfo * connection, const void * da
 //------------------------------------------------------------------------------
 bool TCPConnectionPool::Send( const ConnectionInfo * connection, const void * data, size_t size, const void * payloadData, size_t payloadSize, uint32_t timeoutMS )
 {
+    ASSERT( m_Unframed == false ); // payloads can't be separated without size headers
+
     SendBuffer buffers[ 4 ]; // size + data + payloadSize + payloadData
 
     // size
@@ -644,6 +657,7 @@ bool TCPConnectionPool::SendInternal( const ConnectionInfo * connection, const T
         }
         bytesSent += sent;
     }
+    AtomicAddU64( &m_BytesSent, bytesSent );
 
     #ifdef DEBUG
         connection->m_InUse = false;
@@ -689,6 +703,11 @@ bool TCPConnectionPool::HandleRead( ConnectionInfo * ci )
 {
     PROFILE_FUNCTION
 
+    if ( m_Unframed )
+    {
+        return HandleReadUnframed( ci );
+    }
+
     // work out how many bytes there are
     uint32_t size( 0 );
     uint32_t bytesToRead = 4;
@@ -745,6 +764,7 @@ bool TCPConnectionPool::HandleRead( ConnectionInfo * ci )
         bytesRemaining -= numBytes;
         dest += numBytes;
     }
+    AtomicAddU64( &m_BytesReceived, (int64_t)size + sizeof( size ) );
 
     // tell user the data is in their buffer
     bool keepMemory = false;
@@ -757,6 +777,54 @@ bool TCPConnectionPool::HandleRead( ConnectionInfo * ci )
     return true;
 }
 
+// HandleReadUnframed
+//------------------------------------------------------------------------------
+bool TCPConnectionPool::HandleReadUnframed( ConnectionInfo * ci )
+{
+    PROFILE_FUNCTION
+
+    // read whatever is available
+    const uint32_t maxSize( 64 * 1024 );
+    void * buffer = AllocBuffer( maxSize );
+    ASSERT( buffer );
+
+    int numBytes;
+    for ( ;; )
+    {
+        numBytes = (int)recv( ci->m_Socket, (char *)buffer, (int32_t)maxSize, 0 );
+        if ( numBytes > 0 )
+        {
+            break;
+        }
+        if ( ( numBytes < 0 ) && WouldBlock() )
+        {
+            if ( AtomicLoadAcquire( &ci->m_ThreadQuitNotification ) || AtomicLoadRelaxed( &m_ShuttingDown ) )
+            {
+                FreeBuffer( buffer );
+                return false;
+            }
+
+            Thread::Sleep( 1 );
+            continue;
+        }
+        // 0 bytes is a graceful disconnection
+        TCPDEBUG( "recv() failed (C). Error: %s (Read: %i, Socket: %x)\n", LAST_NETWORK_ERROR_STR, numBytes, (uint32_t)( ci->m_Socket ) );
+        FreeBuffer( buffer );
+        return false;
+    }
+    AtomicAddU64( &m_BytesReceived, numBytes );
+
+    // tell user the data is in their buffer
+    bool keepMemory = false;
+    OnReceive( ci, buffer, (uint32_t)numBytes, keepMemory );
+    if ( !keepMemory )
+    {
+        FreeBuffer( buffer );
+    }
+
+    return true;
+}
+
 // GetLastNetworkError
 //------------------------------------------------------------------------------
 int TCPConnectionPool::GetLastNetworkError() const
@@ -8,6 +8,7 @@
 
 #include "Core/Containers/Array.h"
 #include "Core/Env/Types.h"
+#include "Core/Process/Atomic.h"
 #include "Core/Process/Mutex.h"
 #include "Core/Process/Semaphore.h"
 #include "Core/Process/Thread.h"
@@ -64,8 +65,12 @@ public:
     // Must be called explicitly before destruction
     void ShutdownAllConnections();
 
+    // Send and receive data without size headers, for text based protocols such as HTTP.
+    // Received data is passed to OnReceive as it arrives. Must be set before connecting.
+    void SetUnframed() { m_Unframed = true; }
+
     // manage connections
-    bool Listen( uint16_t port );
+    bool Listen( uint16_t port, bool loopbackOnly = false );
     void StopListening();
     const ConnectionInfo * Connect( const AString & host, uint16_t port, uint32_t timeout = 2000, void * userData = nullptr );
     const ConnectionInfo * Connect( uint32_t hostIP, uint16_t port, uint32_t timeout = 2000, void * userData = nullptr );
@@ -75,6 +80,10 @@ public:
     // query connection state
     size_t GetNumConnections() const;
 
+    // total traffic over all connections (including size headers)
+    uint64_t GetBytesSent() const       { return AtomicLoadRelaxed( &m_BytesSent ); }
+    uint64_t GetBytesReceived() const   { return AtomicLoadRelaxed( &m_BytesReceived ); }
+
     // transmit data
     bool Send( const ConnectionInfo * connection, const void * data, size_t size, uint32_t timeoutMS = 30000 );
     bool Send( const ConnectionInfo * connection, const void * data, size_t size, const void * payloadData, size_t payloadSize, uint32_t timeoutMS = 30000 );
@@ -95,6 +104,7 @@ protected:
 private:
     // helper functions
     bool        HandleRead( ConnectionInfo * ci );
+    bool        HandleReadUnframed( ConnectionInfo * ci );
 
     // platform specific abstraction
     int         GetLastNetworkError() const;
@@ -140,6 +150,9 @@ private:
     Array< ConnectionInfo * >   m_Connections;
 
     bool                        m_ShuttingDown;
+    bool                        m_Unframed;
+    volatile uint64_t           m_BytesSent;
+    volatile uint64_t           m_BytesReceived;
     Semaphore                   m_ShutdownSemaphore;
 
     // object to manage network subsystem lifetime
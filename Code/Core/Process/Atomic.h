@@ -105,6 +105,28 @@ inline void AtomicStoreRelease( T * volatile * x, T * value )
         #error Unknown compiler
     #endif
 }
+template < class T >
+inline T * AtomicExchange( T * volatile * x, T * value )
+{
+    #if defined( __GNUC__ ) || defined( __clang__ )
+        return __atomic_exchange_n( x, value, __ATOMIC_SEQ_CST );
+    #elif defined( _MSC_VER )
+        return static_cast< T * >( InterlockedExchangePointer( reinterpret_cast< void * volatile * >( x ), value ) );
+    #else
+        #error Unknown compiler
+    #endif
+}
+template < class T >
+inline bool AtomicCompareExchange( T * volatile * x, T * expected, T * value )
+{
+    #if defined( __GNUC__ ) || defined( __clang__ )
+        return __atomic_compare_exchange_n( x, &expected, value, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST );
+    #elif defined( _MSC_VER )
+        return ( InterlockedCompareExchangePointer( reinterpret_cast< void * volatile * >( x ), value, expected ) == expected );
+    #else
+        #error Unknown compiler
+    #endif
+}
 
 // 32bit
 //------------------------------------------------------------------------------
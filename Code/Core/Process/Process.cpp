@@ -25,7 +25,9 @@
 #if defined( __LINUX__ ) || defined( __APPLE__ )
     #include <errno.h>
     #include <fcntl.h>
+    #include <poll.h>
     #include <signal.h>
+    #include <spawn.h>
     #include <stdio.h>
     #include <stdlib.h>
     #include <string.h>
@@ -33,6 +35,100 @@
     #include <unistd.h>
 #endif
 
+#if defined( __APPLE__ )
+    #include <crt_externs.h> // for _NSGetEnviron
+#endif
+
+// Defines
+//------------------------------------------------------------------------------
+// posix_spawn can only change the working dir of the child with this extension
+#if defined( __LINUX__ ) && defined( __GLIBC__ ) && ( ( __GLIBC__ > 2 ) || ( ( __GLIBC__ == 2 ) && ( __GLIBC_MINOR__ >= 29 ) ) )
+    #define PROCESS_POSIX_SPAWN_CHDIR_SUPPORTED
+#endif
+#if defined( __LINUX__ ) || defined( __APPLE__ )
+    // How long to wait for output before checking abort flags and timeouts
+    #define PROCESS_POLL_INTERVAL_MS ( 10 )
+    // Smallest amount of space to read into (capacity is grown geometrically)
+    #define PROCESS_MIN_READ_SIZE ( 64 * KILOBYTE )
+#endif
+
+// Helpers
+//------------------------------------------------------------------------------
+#if defined( __LINUX__ ) || defined( __APPLE__ )
+    // SpawnWithPosixSpawn
+    //  - posix_spawn avoids duplicating the page tables of this process (which
+    //    can be large) for each child, unlike fork (glibc uses CLONE_VFORK)
+    //  - failures, including exec failures, are reported to the caller
+    //------------------------------------------------------------------------------
+    static pid_t SpawnWithPosixSpawn( const char * executable,
+                                      char * const * argV,
+                                      char * const * envV,
+                                      const char * workingDir,
+                                      const int stdOutPipeFDs[ 2 ],
+                                      const int stdErrPipeFDs[ 2 ] )
+    {
+        posix_spawn_file_actions_t fileActions;
+        if ( posix_spawn_file_actions_init( &fileActions ) != 0 )
+        {
+            return -1;
+        }
+        posix_spawnattr_t attr;
+        if ( posix_spawnattr_init( &attr ) != 0 )
+        {
+            posix_spawn_file_actions_destroy( &fileActions );
+            return -1;
+        }
+
+        bool ok = true;
+
+        // Put child process into its own process group (see fork path)
+        ok = ok && ( posix_spawnattr_setpgroup( &attr, 0 ) == 0 );
+        ok = ok && ( posix_spawnattr_setflags( &attr, POSIX_SPAWN_SETPGROUP ) == 0 );
+
+        ok = ok && ( posix_spawn_file_actions_adddup2( &fileActions, stdOutPipeFDs[ 1 ], STDOUT_FILENO ) == 0 );
+        ok = ok && ( posix_spawn_file_actions_adddup2( &fileActions, stdErrPipeFDs[ 1 ], STDERR_FILENO ) == 0 );
+        ok = ok && ( posix_spawn_file_actions_addclose( &fileActions, stdOutPipeFDs[ 0 ] ) == 0 );
+        ok = ok && ( posix_spawn_file_actions_addclose( &fileActions, stdOutPipeFDs[ 1 ] ) == 0 );
+        ok = ok && ( posix_spawn_file_actions_addclose( &fileActions, stdErrPipeFDs[ 0 ] ) == 0 );
+        ok = ok && ( posix_spawn_file_actions_addclose( &fileActions, stdErrPipeFDs[ 1 ] ) == 0 );
+
+        if ( workingDir )
+        {
+            #if defined( PROCESS_POSIX_SPAWN_CHDIR_SUPPORTED )
+                ok = ok && ( posix_spawn_file_actions_addchdir_np( &fileActions, workingDir ) == 0 );
+            #else
+                ASSERT( false ); // caller should use fork path
+                ok = false;
+            #endif
+        }
+
+        // inherit our environment if not specified
+        if ( envV == nullptr )
+        {
+            #if defined( __APPLE__ )
+                envV = *_NSGetEnviron();
+            #else
+                envV = environ;
+            #endif
+        }
+
+        pid_t childProcessPid = -1;
+        if ( ok )
+        {
+            const int result = posix_spawn( &childProcessPid, executable, &fileActions, &attr, argV, envV );
+            if ( result != 0 )
+            {
+                errno = result; // posix_spawn returns the error instead of setting errno
+                childProcessPid = -1;
+            }
+        }
+
+        posix_spawnattr_destroy( &attr );
+        posix_spawn_file_actions_destroy( &fileActions );
+        return childProcessPid;
+    }
+#endif
+
 // Static Data
 //------------------------------------------------------------------------------
 
@@ -50,6 +146,7 @@ Process::Process( const volatile bool * masterAbortFlag,
 #endif
 #if defined( __LINUX__ ) || defined( __APPLE__ )
     , m_ChildPID( -1 )
+    , m_UseFork( false )
     , m_HasAlreadyWaitTerminated( false )
 #endif
     , m_HasAborted( false )
@@ -340,6 +437,40 @@ bool Process::Spawn( const char * executable,
         }
         envVector.Append( nullptr ); // env must be terminated with a nullptr
 
+        char * const * argV = (char * const *)argVector.Begin();
+        char * const * envV = environment ? (char * const *)envVector.Begin() : nullptr;
+
+        // Use posix_spawn where possible
+        #if defined( PROCESS_POSIX_SPAWN_CHDIR_SUPPORTED )
+            const bool usePosixSpawn = ( m_UseFork == false );
+        #else
+            const bool usePosixSpawn = ( m_UseFork == false ) && ( workingDir == nullptr );
+        #endif
+        if ( usePosixSpawn )
+        {
+            const pid_t childProcessPid = SpawnWithPosixSpawn( executable, argV, envV, workingDir, stdOutPipeFDs, stdErrPipeFDs );
+
+            // close write pipes (we never write anything)
+            VERIFY( close( stdOutPipeFDs[ 1 ] ) == 0 );
+            VERIFY( close( stdErrPipeFDs[ 1 ] ) == 0 );
+
+            if ( childProcessPid == -1 )
+            {
+                // failed to start (missing executable, bad working dir etc)
+                VERIFY( close( stdOutPipeFDs[ 0 ] ) == 0 );
+                VERIFY( close( stdErrPipeFDs[ 0 ] ) == 0 );
+                return false;
+            }
+
+            // keep pipes for reading child process
+            m_StdOutRead = stdOutPipeFDs[ 0 ];
+            m_StdErrRead = stdErrPipeFDs[ 0 ];
+            m_ChildPID = (int)childProcessPid;
+            m_Started = true;
+            m_HasAlreadyWaitTerminated = false;
+            return true;
+        }
+
         // fork the process
         const pid_t childProcessPid = fork();
         if ( childProcessPid == -1 )
@@ -376,10 +507,8 @@ bool Process::Spawn( const char * executable,
             }
 
             // transfer execution to new executable
-            char * const * argV = (char * const *)argVector.Begin();
-            if ( environment )
+            if ( envV )
             {
-                char * const * envV = (char * const *)envVector.Begin();
                 execve( executable, argV, envV );
             }
             else
@@ -576,44 +705,32 @@ bool Process::ReadAllData( AString & outMem,
 {
     Timer t;
 
-    #if defined( __LINUX__ )
-        // Start with a short sleep interval to allow rapid termination of
-        // short-lived processes. The timeout increases during periods of
-        // no output and reset when receiving output to balance responsiveness
-        // with overhead.
-        uint32_t sleepIntervalMS = 1;
-    #endif
-
-    bool processExited = false;
-    for ( ;; )
-    {
-        const bool masterAbort = ( m_MasterAbortFlag && AtomicLoadRelaxed( m_MasterAbortFlag ) );
-        const bool abort = ( m_AbortFlag && AtomicLoadRelaxed( m_AbortFlag ) );
-        if ( abort || masterAbort )
+    #if defined( __WINDOWS__ )
+        bool processExited = false;
+        for ( ;; )
         {
-            PROFILE_SECTION( "Abort" )
-            KillProcessTree();
-            m_HasAborted = true;
-            break;
-        }
+            const bool masterAbort = ( m_MasterAbortFlag && AtomicLoadRelaxed( m_MasterAbortFlag ) );
+            const bool abort = ( m_AbortFlag && AtomicLoadRelaxed( m_AbortFlag ) );
+            if ( abort || masterAbort )
+            {
+                PROFILE_SECTION( "Abort" )
+                KillProcessTree();
+                m_HasAborted = true;
+                break;
+            }
 
-        const uint32_t prevOutSize = outMem.GetLength();
-        const uint32_t prevErrSize = errMem.GetLength();
-        Read( m_StdOutRead, outMem );
-        Read( m_StdErrRead, errMem );
+            const uint32_t prevOutSize = outMem.GetLength();
+            const uint32_t prevErrSize = errMem.GetLength();
+            Read( m_StdOutRead, outMem );
+            Read( m_StdErrRead, errMem );
 
-        // did we get some data?
-        if ( ( prevOutSize != outMem.GetLength() ) || ( prevErrSize != errMem.GetLength() ) )
-        {
-            #if defined( __LINUX__ )
-                // Reset sleep interval            
-                sleepIntervalMS = 1;
-            #endif
-            continue; // try reading again right away incase there is more
-        }
+            // did we get some data?
+            if ( ( prevOutSize != outMem.GetLength() ) || ( prevErrSize != errMem.GetLength() ) )
+            {
+                continue; // try reading again right away incase there is more
+            }
 
-        // nothing to read right now
-        #if defined( __WINDOWS__ )
+            // nothing to read right now
             if ( processExited == false )
             {
                 DWORD result = WaitForSingleObject( GetProcessInfo().hProcess, 15 );
@@ -634,43 +751,132 @@ bool Process::ReadAllData( AString & outMem,
                     ASSERT( result == WAIT_OBJECT_0 );
                 }
             }
-        #else
-            if ( IsRunning() )
+
+            // process exited - is this the first time to this point?
+            if ( processExited == false )
             {
-                // Check if timeout is hit
-                if ( ( timeOutMS > 0 ) && ( t.GetElapsedMS() >= timeOutMS ) )
+                processExited = true;
+                continue; // get remaining output
+            }
+
+            break; // all done
+        }
+    #else
+        // Wait on both pipes, waking as soon as there is output or the pipes
+        // are closed (when the process exits) instead of sleeping between reads
+        bool stdOutOpen = true;
+        bool stdErrOpen = true;
+        while ( stdOutOpen || stdErrOpen )
+        {
+            const bool masterAbort = ( m_MasterAbortFlag && AtomicLoadRelaxed( m_MasterAbortFlag ) );
+            const bool abort = ( m_AbortFlag && AtomicLoadRelaxed( m_AbortFlag ) );
+            if ( abort || masterAbort )
+            {
+                PROFILE_SECTION( "Abort" )
+                KillProcessTree();
+                m_HasAborted = true;
+                break;
+            }
+
+            // Check if timeout is hit
+            int waitMS = PROCESS_POLL_INTERVAL_MS;
+            if ( timeOutMS > 0 )
+            {
+                const float elapsedMS = t.GetElapsedMS();
+                if ( elapsedMS >= (float)timeOutMS )
                 {
                     Terminate();
                     return false; // Timed out
                 }
+                waitMS = Math::Min( waitMS, (int)( (float)timeOutMS - elapsedMS ) + 1 );
+            }
 
-                // no data available, but process is still going, so wait
-                #if defined( __OSX__ )
-                    // On OSX there seems to be no way to set the pipe bufffer
-                    // size so we must instead wake up frequently to avoid the
-                    // writer being blocked.
-                    Thread::Sleep( 2 );
-                #else
-                    // TODO:C Investigate waiting on an event when process terminates
-                    // to reduce overall process spawn time
-                    Thread::Sleep( sleepIntervalMS );
-
-                    // Increase sleep interval upto limit
-                    sleepIntervalMS = Math::Min<uint32_t>( sleepIntervalMS * 2, 8 );
-                #endif
-                continue;
+            pollfd fds[ 2 ];
+            nfds_t numFDs = 0;
+            if ( stdOutOpen )
+            {
+                fds[ numFDs ].fd = m_StdOutRead;
+                fds[ numFDs ].events = POLLIN;
+                fds[ numFDs ].revents = 0;
+                ++numFDs;
+            }
+            if ( stdErrOpen )
+            {
+                fds[ numFDs ].fd = m_StdErrRead;
+                fds[ numFDs ].events = POLLIN;
+                fds[ numFDs ].revents = 0;
+                ++numFDs;
             }
-        #endif
 
-        // process exited - is this the first time to this point?
-        if ( processExited == false )
-        {
-            processExited = true;
-            continue; // get remaining output
+            const int ret = poll( fds, numFDs, waitMS );
+            if ( ret == -1 )
+            {
+                if ( errno == EINTR )
+                {
+                    continue; // Try again
+                }
+                ASSERT( false ); // usage error?
+                break;
+            }
+
+            if ( ret == 0 )
+            {
+                // The process can exit while something it started (a compiler
+                // server for example) keeps the pipes open, so stop waiting
+                // for them to close once the process has gone
+                if ( IsRunning() == false )
+                {
+                    // get any remaining output
+                    // (readable pipes would have woken the poll, but the process might have written more since)
+                    if ( stdOutOpen ) { ReadAvailable( m_StdOutRead, outMem ); }
+                    if ( stdErrOpen ) { ReadAvailable( m_StdErrRead, errMem ); }
+                    break;
+                }
+                continue; // still running
+            }
+
+            // read from whichever pipes are ready (or closed)
+            for ( nfds_t i = 0; i < numFDs; ++i )
+            {
+                if ( fds[ i ].revents == 0 )
+                {
+                    continue;
+                }
+                if ( fds[ i ].fd == m_StdOutRead )
+                {
+                    stdOutOpen = Read( m_StdOutRead, outMem );
+                }
+                else
+                {
+                    stdErrOpen = Read( m_StdErrRead, errMem );
+                }
+            }
         }
 
-        break; // all done
-    }
+        // The pipes are closed as the process exits, which can be just before
+        // it has finished exiting, so wait for that as callers expect
+        if ( m_HasAborted == false )
+        {
+            while ( IsRunning() )
+            {
+                const bool masterAbort = ( m_MasterAbortFlag && AtomicLoadRelaxed( m_MasterAbortFlag ) );
+                const bool abort = ( m_AbortFlag && AtomicLoadRelaxed( m_AbortFlag ) );
+                if ( abort || masterAbort )
+                {
+                    PROFILE_SECTION( "Abort" )
+                    KillProcessTree();
+                    m_HasAborted = true;
+                    break;
+                }
+                if ( ( timeOutMS > 0 ) && ( t.GetElapsedMS() >= (float)timeOutMS ) )
+                {
+                    Terminate();
+                    return false; // Timed out
+                }
+                Thread::Sleep( 1 );
+            }
+        }
+    #endif
 
     return true;
 }
@@ -717,45 +923,67 @@ bool Process::ReadAllData( AString & outMem,
 // Read
 //------------------------------------------------------------------------------
 #if defined( __LINUX__ ) || defined( __APPLE__ )
-    void Process::Read( int handle, AString & buffer )
+    bool Process::Read( int handle, AString & buffer )
     {
-        // any data available?
-        timeval timeout;
-        timeout.tv_sec = 0;
-        timeout.tv_usec = 0;
-        fd_set fdSet;
-        FD_ZERO( &fdSet );
-        FD_SET( handle, &fdSet );
-        int ret = select( handle+1, &fdSet, nullptr, nullptr, &timeout );
-        if ( ret == -1 )
-        {
-            ASSERT( false ); // usage error?
-            return;
-        }
-        if ( ret == 0 )
-        {
-            return; // no data available
-        }
-
-        // how much space do we have left for reading into?
+        // Ensure a reasonable amount of space to read into. Capacity grows
+        // geometrically so large outputs (which can be 100s of MiB when
+        // preprocessing) are copied as few times as possible. Callers can
+        // avoid copies entirely by reserving space before reading.
         const uint32_t spaceInBuffer = ( buffer.GetReserved() - buffer.GetLength() );
-        if ( spaceInBuffer == 0 )
+        if ( spaceInBuffer < PROCESS_MIN_READ_SIZE )
         {
-            // Expand buffer for new data in large chunks
-            const uint32_t newBufferSize = ( buffer.GetReserved() + ( 16 * MEGABYTE ) );
+            const uint32_t newBufferSize = Math::Max< uint32_t >( buffer.GetReserved() * 2,
+                                                                  buffer.GetLength() + PROCESS_MIN_READ_SIZE );
             buffer.SetReserved( newBufferSize );
         }
 
         // read the new data
-        ssize_t result = read( handle, buffer.Get() + buffer.GetLength(), spaceInBuffer );
-        if ( result == -1 )
+        for ( ;; )
         {
+            const ssize_t result = read( handle, buffer.Get() + buffer.GetLength(), buffer.GetReserved() - buffer.GetLength() );
+            if ( result > 0 )
+            {
+                // Update length
+                buffer.SetLength( buffer.GetLength() + (uint32_t)result );
+                return true;
+            }
+            if ( result == 0 )
+            {
+                return false; // pipe closed
+            }
+            if ( errno == EINTR )
+            {
+                continue; // Try again
+            }
+            if ( errno == EAGAIN )
+            {
+                return true; // nothing to read
+            }
             ASSERT( false ); // error!
-            result = 0; // no bytes read
+            return false;
+        }
+    }
+
+    // ReadAvailable
+    //------------------------------------------------------------------------------
+    void Process::ReadAvailable( int handle, AString & buffer )
+    {
+        for ( ;; )
+        {
+            // any data available?
+            pollfd fd;
+            fd.fd = handle;
+            fd.events = POLLIN;
+            fd.revents = 0;
+            if ( poll( &fd, 1, 0 ) != 1 )
+            {
+                return; // no data available
+            }
+            if ( Read( handle, buffer ) == false )
+            {
+                return; // pipe closed
+            }
         }
-        
-        // Update length
-        buffer.SetLength( buffer.GetLength() + (uint32_t)result );
     }
 #endif
 
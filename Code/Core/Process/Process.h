@@ -30,6 +30,9 @@ public:
     void KillProcessTree();
 
     // Read all data from the process until it exits
+    //  - Data is appended to the supplied buffers, which are grown as needed.
+    //    If the output size is known (from a previous run for example), reserving
+    //    it beforehand avoids re-allocation and copying as output is received.
     // NOTE: Owner must free the returned memory!
     bool ReadAllData( AString & memOut,
                       AString & errOut,
@@ -38,6 +41,9 @@ public:
     #if defined( __WINDOWS__ )
         // Prevent handles being redirected
         inline void DisableHandleRedirection() { m_RedirectHandles = false; }
+    #else
+        // Spawn with fork() instead of posix_spawn() (for comparison)
+        inline void SetUseFork() { m_UseFork = true; }
     #endif
     bool HasAborted() const { return m_HasAborted; }
     static uint32_t GetCurrentId();
@@ -50,7 +56,8 @@ private:
         static uint64_t GetProcessCreationTime( const void * hProc ); // HANDLE
         void Read( void * handle, AString & buffer );
     #else
-        void Read( int handle, AString & buffer );
+        bool Read( int handle, AString & buffer ); // returns false once pipe is closed
+        void ReadAvailable( int handle, AString & buffer );
     #endif
 
     void Terminate();
@@ -81,6 +88,7 @@ private:
 
     #if defined( __LINUX__ ) || defined( __APPLE__ )
         int m_ChildPID;
+        bool m_UseFork;
         mutable bool m_HasAlreadyWaitTerminated;
         mutable int m_ReturnStatus;
         int m_StdOutRead;
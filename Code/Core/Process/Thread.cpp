@@ -6,6 +6,7 @@
 #include "Thread.h"
 #include "Core/Env/Assert.h"
 #include "Core/Mem/Mem.h"
+#include "Core/Mem/SmallBlockAllocator.h"
 #include "Core/Profile/Profile.h"
 
 // system
@@ -77,10 +78,17 @@ public:
         FDELETE( originalInfo );
 
         // enter into real thread function
+        const uint32_t result = (*realFunction)( realUserData );
+
+        // give back memory cached by this thread
+        #if defined( SMALL_BLOCK_ALLOCATOR_ENABLED )
+            SmallBlockAllocator::ReleaseThreadCache();
+        #endif
+
         #if defined( __WINDOWS__ )
-            return (*realFunction)( realUserData );
+            return result;
         #else
-            return (void *)(size_t)( (*realFunction)( realUserData ) );
+            return (void *)(size_t)result;
         #endif
     }
 };
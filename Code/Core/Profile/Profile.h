@@ -13,6 +13,8 @@
     #define PROFILE_FUNCTION
     #define PROFILE_SECTION( sectionName )
     #define PROFILE_SYNCHRONIZE
+    #define PROFILE_ENABLE( fileName )
+    #define PROFILE_DISABLE
 #else
     #define PROFILE_SET_THREAD_NAME( threadName ) ProfileManager::SetThreadName( threadName );
 
@@ -24,19 +26,32 @@
 
     #define PROFILE_SYNCHRONIZE ProfileManager::Synchronize();
 
+    #define PROFILE_ENABLE( fileName ) ProfileManager::Enable( fileName );
+    #define PROFILE_DISABLE ProfileManager::Disable();
+
     // RAII helper to manage Start/Stop of a profile section
+    //  - when profiling is not enabled, this is a single test
+    //  - the Stop always matches the Start, even if profiling is toggled in between
     class ProfileHelper
     {
     public:
-        inline ProfileHelper( const char * id )
+        inline explicit ProfileHelper( const char * id )
+            : m_Active( ProfileManager::IsEnabled() )
         {
-            ProfileManager::Start( id );
+            if ( m_Active )
+            {
+                ProfileManager::Start( id );
+            }
         }
         inline ~ProfileHelper()
         {
-            ProfileManager::Stop();
+            if ( m_Active )
+            {
+                ProfileManager::Stop();
+            }
         }
     private:
+        bool m_Active;
     };
 #endif // PROFILING_ENABLED
 
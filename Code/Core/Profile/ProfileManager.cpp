@@ -8,44 +8,110 @@
 #ifdef PROFILING_ENABLED
 
 #include "Core/FileIO/FileStream.h"
-#include "Core/Math/xxHash.h"
+#include "Core/Math/Conversions.h"
 #include "Core/Mem/Mem.h"
+#include "Core/Process/Atomic.h"
 #include "Core/Process/Mutex.h"
+#include "Core/Process/Semaphore.h"
 #include "Core/Process/Thread.h"
 #include "Core/Profile/Profile.h"
 #include "Core/Strings/AStackString.h"
 #include "Core/Time/Timer.h"
 #include "Core/Tracing/Tracing.h"
 
-// Static Data
-//------------------------------------------------------------------------------
-/*static*/ Array< ProfileManager::ProfileEventInfo > ProfileManager::s_ProfileEventInfo( 0, true );
+#if defined( _MSC_VER ) && ( defined( _M_X64 ) || defined( _M_IX86 ) )
+    #include <intrin.h>
+    #define PROFILE_USE_TSC
+#elif ( defined( __GNUC__ ) || defined( __clang__ ) ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+    #include <x86intrin.h>
+    #define PROFILE_USE_TSC
+#endif
 
-// Global Data
+// Defines
 //------------------------------------------------------------------------------
-Mutex g_ProfileManagerMutex;
-FileStream g_ProfileEventLog;
+#define PROFILE_EVENTS_PER_THREAD       ( 16 * 1024 )   // must be a power of 2 (256KiB per thread)
+#define PROFILE_DUMP_INTERVAL_MS        ( 100 )
+#define PROFILE_CALIBRATION_TIME_MS     ( 5.0f )
+#define PROFILE_WRITE_BUFFER_SIZE       ( 8192 )
 
 // ProfileEvent
 //------------------------------------------------------------------------------
 struct ProfileEvent
 {
-    const char *    m_Id;
-    int64_t         m_TimeStamp;
+    const char *    m_Id;           // nullptr for the end of a section
+    uint64_t        m_TimeStamp;
 };
 
+// ProfileEventBuffer
+//  - A ring buffer written only by the owning thread and read only by the
+//    thread writing the events to disk, so neither side needs a lock
+//------------------------------------------------------------------------------
+struct ProfileEventBuffer
+{
+    inline bool Push( const char * id, uint32_t numReserved );
+
+    ProfileEvent            m_Events[ PROFILE_EVENTS_PER_THREAD ];
+    volatile uint64_t       m_WritePos;     // written by owning thread
+    volatile uint64_t       m_ReadPos;      // written by dump thread
+    uint32_t                m_Depth;        // sections open on the owning thread
+    uint32_t                m_DroppedDepth; // depth of the outermost section being dropped (0 if none)
+    uint32_t                m_ThreadIndex;
+    bool                    m_ThreadNameWritten; // protected by g_ProfileManagerMutex
+    enum { MAX_THREAD_NAME_LEN = 31 };
+    char                    m_ThreadName[ MAX_THREAD_NAME_LEN + 1 ]; // protected by g_ProfileManagerMutex once published
+    ProfileEventBuffer *    m_Next;         // immutable once the buffer is published
+};
+
+// Per-Thread data
+//------------------------------------------------------------------------------
+struct ProfileThreadData
+{
+    ProfileEventBuffer *    m_Buffer;       // created on first use when profiling is enabled
+    char                    m_ThreadName[ ProfileEventBuffer::MAX_THREAD_NAME_LEN + 1 ];
+};
+THREAD_LOCAL ProfileThreadData tls_ProfileThreadData = { nullptr, "" };
+
+// Static Data
+//------------------------------------------------------------------------------
+/*static*/ volatile bool ProfileManager::s_Enabled = false;
+
+// Global Data
+//------------------------------------------------------------------------------
+Mutex g_ProfileManagerMutex; // Enable/Disable, buffer creation and writing
+FileStream g_ProfileEventLog;
+ProfileEventBuffer * volatile g_ProfileEventBuffers = nullptr;
+uint32_t g_ProfileNumEventBuffers = 0;
+volatile uint32_t g_ProfileNumDroppedEvents = 0;
+uint64_t g_ProfileBaseTimeStamp = 0;
+double g_ProfileTimeStampsPerUS = 0.0; // calibrated on first Enable
+Thread::ThreadHandle g_ProfileDumpThread = INVALID_THREAD_HANDLE;
+Semaphore g_ProfileDumpThreadSemaphore;
+Semaphore g_ProfileDumpThreadStarted;
+volatile bool g_ProfileDumpThreadExit = false;
+
+// GetTimeStamp
+//------------------------------------------------------------------------------
+static inline uint64_t GetTimeStamp()
+{
+    #if defined( PROFILE_USE_TSC )
+        return __rdtsc(); // Assumes an invariant TSC, as on all modern x86 cpus
+    #else
+        return (uint64_t)Timer::GetNow();
+    #endif
+}
+
 // FormatU64
 //------------------------------------------------------------------------------
 void FormatU64( uint64_t value, char * outBuffer )
 {
     char tmp[ 24 ]; // 20 bytes needed for max U64 value: 18,446,744,073,709,551,615
     char * pos = tmp;
-    while ( value )
+    do
     {
         *pos = ( '0' + (uint8_t)( value % 10 ) );
         ++pos;
         value /= 10;
-    }
+    } while ( value );
     while ( pos > tmp )
     {
         --pos;
@@ -55,153 +121,211 @@ void FormatU64( uint64_t value, char * outBuffer )
     *outBuffer = 0;
 }
 
-// Per-Thread structure
+// ProfileEventBuffer::Push
 //------------------------------------------------------------------------------
-struct ProfileEventBuffer
+bool ProfileEventBuffer::Push( const char * id, uint32_t numReserved )
 {
-    inline void Start( const char * profileId );
-    inline void Stop();
-    inline void SetThreadName( const char * threadName );
-
-    NO_INLINE ProfileEvent * AllocateEventStorage();
-
-    size_t          m_CurrentDepth;
-
-    // keep an exapanding buffer of events
-    ProfileEvent *  m_Begin;
-    ProfileEvent *  m_Current;
-    ProfileEvent *  m_MaxEnd;
-
-    enum { MAX_THREAD_NAME_LEN = 31 };
-    char                m_ThreadName[ MAX_THREAD_NAME_LEN + 1 ];
-
-    // when allocating memory to track events, do it in blocks
-    enum{ NUM_EVENTS_PER_BLOCK = 8192 }; // 64KiB pages with 8 bytes events
-};
-THREAD_LOCAL ProfileEventBuffer tls_ProfileEventBuffer = { 0, nullptr, nullptr, nullptr, "" };
-
-// ProfileEventBuffer::Start
-//------------------------------------------------------------------------------
-void ProfileEventBuffer::Start( const char * id )
-{
-    // ensure we have enough space
-    ProfileEvent * e = m_Current;
-    if ( e == m_MaxEnd )
+    // Events are never overwritten before being read. Space is reserved
+    // so that the end of every open section can always be recorded.
+    const uint64_t writePos = m_WritePos;
+    const uint64_t readPos = AtomicLoadAcquire( &m_ReadPos );
+    if ( ( writePos - readPos + numReserved ) >= PROFILE_EVENTS_PER_THREAD )
     {
-        e = AllocateEventStorage();
+        return false;
     }
 
-    m_CurrentDepth++;
-
-    e->m_Id = id;
-    e->m_TimeStamp =  Timer::GetNow();
+    ProfileEvent & e = m_Events[ writePos & ( PROFILE_EVENTS_PER_THREAD - 1 ) ];
+    e.m_Id = id;
+    e.m_TimeStamp = GetTimeStamp();
 
-    ++e;
-    m_Current = e;
+    AtomicStoreRelease( &m_WritePos, writePos + 1 ); // publish to dump thread
+    return true;
 }
 
-// Stop
+// Enable
 //------------------------------------------------------------------------------
-void ProfileEventBuffer::Stop()
+/*static*/ void ProfileManager::Enable( const char * fileName )
 {
-    ASSERT( m_CurrentDepth > 0 );
+    MutexHolder mh( g_ProfileManagerMutex );
 
-    ProfileEvent * e = m_Current;
-    if ( e == m_MaxEnd )
+    if ( AtomicLoadRelaxed( &s_Enabled ) )
     {
-        e = AllocateEventStorage();
+        return;
     }
 
-    e->m_Id = nullptr;
-    e->m_TimeStamp = Timer::GetNow();
+    if ( g_ProfileEventLog.Open( fileName, FileStream::WRITE_ONLY | FileStream::NO_RETRY_ON_SHARING_VIOLATION ) == false )
+    {
+        OUTPUT( "Failed to open profile output '%s'\n", fileName );
+        return;
+    }
+    g_ProfileEventLog.WriteBuffer( "[ ", 2 ); // json array opening tag
 
-    ++e;
-    m_Current = e;
+    // Calibrate time stamps against the high resolution timer (once)
+    if ( g_ProfileTimeStampsPerUS == 0.0 )
+    {
+        const int64_t startTime = Timer::GetNow();
+        const uint64_t startTimeStamp = GetTimeStamp();
+        const Timer t;
+        while ( t.GetElapsedMS() < PROFILE_CALIBRATION_TIME_MS )
+        {
+        }
+        const int64_t endTime = Timer::GetNow();
+        const uint64_t endTimeStamp = GetTimeStamp();
+        const double elapsedUS = ( (double)( endTime - startTime ) * 1000000.0 / (double)Timer::GetFrequency() );
+        g_ProfileTimeStampsPerUS = ( (double)( endTimeStamp - startTimeStamp ) / elapsedUS );
+    }
+    g_ProfileBaseTimeStamp = GetTimeStamp();
 
-    // push events if back to root
-    size_t currentDepth = m_CurrentDepth;
-    if ( --currentDepth == 0 )
+    // Discard anything left from a previous session
+    for ( ProfileEventBuffer * buffer = g_ProfileEventBuffers; buffer; buffer = buffer->m_Next )
     {
-        ProfileEvent * events = m_Begin;
-        ProfileManager::PushThreadEvents( events, (size_t)( m_Current - events ), m_ThreadName );
-        m_Begin = nullptr;
-        m_Current = nullptr;
-        m_MaxEnd = nullptr;
+        AtomicStoreRelease( &buffer->m_ReadPos, AtomicLoadAcquire( &buffer->m_WritePos ) );
+        buffer->m_ThreadNameWritten = false;
     }
-    m_CurrentDepth = currentDepth;
+
+    AtomicStoreRelaxed( &g_ProfileDumpThreadExit, false );
+    MEMTRACKER_DISABLE_THREAD
+    g_ProfileDumpThread = Thread::CreateThread( DumpThreadFunc, "ProfileDump" );
+    MEMTRACKER_ENABLE_THREAD
+
+    // Wait for the thread to finish starting, which frees memory. Otherwise that
+    // could happen while the main thread has put the allocator in single threaded mode.
+    g_ProfileDumpThreadStarted.Wait();
+
+    AtomicStoreRelaxed( &s_Enabled, true );
 }
 
-// ProfileEventBuffer::AllocateEventStorage
+// Disable
 //------------------------------------------------------------------------------
-ProfileEvent * ProfileEventBuffer::AllocateEventStorage()
+/*static*/ void ProfileManager::Disable()
 {
-    // do we have any events accumulated
-    ProfileEvent * events = m_Begin;
-    if ( events )
     {
-        // ProfileManager now owns the memory
-        ProfileManager::PushThreadEvents( events, (size_t)( m_Current - events ), m_ThreadName );
+        MutexHolder mh( g_ProfileManagerMutex );
+        if ( AtomicLoadRelaxed( &s_Enabled ) == false )
+        {
+            return;
+        }
+        AtomicStoreRelaxed( &s_Enabled, false );
     }
 
-    // allocate a fresh block
-    MEMTRACKER_DISABLE_THREAD
-    {
-        events = FNEW_ARRAY( ProfileEvent[ NUM_EVENTS_PER_BLOCK ] );
-    }
-    MEMTRACKER_ENABLE_THREAD
-    m_Begin = events;
-    m_Current = events;
-    m_MaxEnd = events + NUM_EVENTS_PER_BLOCK;
+    // Stop the dump thread, which writes any remaining events
+    AtomicStoreRelaxed( &g_ProfileDumpThreadExit, true );
+    g_ProfileDumpThreadSemaphore.Signal();
+    Thread::WaitForThread( g_ProfileDumpThread );
+    Thread::CloseHandle( g_ProfileDumpThread );
+    g_ProfileDumpThread = INVALID_THREAD_HANDLE;
 
-    return events;
+    MutexHolder mh( g_ProfileManagerMutex );
+    g_ProfileEventLog.Close();
 }
 
 // Start
 //------------------------------------------------------------------------------
 /*static*/ void ProfileManager::Start( const char * id )
 {
-    ProfileEventBuffer & buffer = tls_ProfileEventBuffer;
-    buffer.Start( id );
+    if ( AtomicLoadRelaxed( &s_Enabled ) == false )
+    {
+        return;
+    }
+
+    ProfileEventBuffer * buffer = tls_ProfileThreadData.m_Buffer;
+    if ( buffer == nullptr )
+    {
+        buffer = CreateThreadBuffer();
+    }
+
+    const uint32_t depth = ++buffer->m_Depth;
+    if ( buffer->m_DroppedDepth != 0 )
+    {
+        return; // within a dropped section
+    }
+
+    // Reserve space for the Stop of this and all enclosing sections
+    if ( buffer->Push( id, depth ) == false )
+    {
+        buffer->m_DroppedDepth = depth;
+        AtomicIncU32( &g_ProfileNumDroppedEvents );
+    }
 }
 
 // Stop
 //------------------------------------------------------------------------------
 /*static*/ void ProfileManager::Stop()
 {
-    ProfileEventBuffer & buffer = tls_ProfileEventBuffer;
-    buffer.Stop();
+    // NOTE: not dependent on s_Enabled so that sections are always closed
+
+    ProfileEventBuffer * buffer = tls_ProfileThreadData.m_Buffer;
+    if ( ( buffer == nullptr ) || ( buffer->m_Depth == 0 ) )
+    {
+        return; // Start was called before profiling was enabled
+    }
+
+    if ( buffer->m_DroppedDepth == 0 )
+    {
+        VERIFY( buffer->Push( nullptr, 0 ) ); // space was reserved by Start
+    }
+    else if ( buffer->m_DroppedDepth == buffer->m_Depth )
+    {
+        buffer->m_DroppedDepth = 0; // end of the dropped section
+    }
+
+    --buffer->m_Depth;
 }
 
 // SetThreadName
 //------------------------------------------------------------------------------
 /*static*/ void ProfileManager::SetThreadName( const char * threadName )
 {
-    ProfileEventBuffer & buffer = tls_ProfileEventBuffer;
-
     // Take a copy of the name
-    AString::Copy( threadName, buffer.m_ThreadName, Math::Min< size_t >( AString::StrLen( threadName ), ProfileEventBuffer::MAX_THREAD_NAME_LEN ) );
+    ProfileThreadData & data = tls_ProfileThreadData;
+    AString::Copy( threadName, data.m_ThreadName, Math::Min< size_t >( AString::StrLen( threadName ), ProfileEventBuffer::MAX_THREAD_NAME_LEN ) );
+    if ( data.m_Buffer )
+    {
+        // The dump thread reads the name while holding the lock
+        MutexHolder mh( g_ProfileManagerMutex );
+        AString::Copy( data.m_ThreadName, data.m_Buffer->m_ThreadName, AString::StrLen( data.m_ThreadName ) );
+        data.m_Buffer->m_ThreadNameWritten = false; // write the new name
+    }
+}
+
+// GetNumDroppedEvents
+//------------------------------------------------------------------------------
+/*static*/ uint32_t ProfileManager::GetNumDroppedEvents()
+{
+    return AtomicLoadRelaxed( &g_ProfileNumDroppedEvents );
 }
 
+// CreateThreadBuffer
 //------------------------------------------------------------------------------
-/*static*/ void ProfileManager::PushThreadEvents( const ProfileEvent * events, size_t num, const char * threadName )
+/*static*/ ProfileEventBuffer * ProfileManager::CreateThreadBuffer()
 {
+    // Buffers are never freed, as the dump thread cannot know when a thread has exited
+    ProfileEventBuffer * buffer;
     MEMTRACKER_DISABLE_THREAD
     {
-        MutexHolder mh( g_ProfileManagerMutex );
-
-        if ( s_ProfileEventInfo.GetCapacity() == 0 )
-        {
-            s_ProfileEventInfo.SetCapacity( 64 );
-        }
-
-        ProfileEventInfo pfi;
-        pfi.m_ThreadId = Thread::GetCurrentThreadId();
-        pfi.m_ThreadName = threadName;
-        pfi.m_Events = events;
-        pfi.m_NumEvents = num;
-        s_ProfileEventInfo.Append( pfi );
+        buffer = FNEW( ProfileEventBuffer );
     }
     MEMTRACKER_ENABLE_THREAD
+    buffer->m_WritePos = 0;
+    buffer->m_ReadPos = 0;
+    buffer->m_Depth = 0;
+    buffer->m_DroppedDepth = 0;
+    buffer->m_ThreadNameWritten = false;
+    AString::Copy( tls_ProfileThreadData.m_ThreadName, buffer->m_ThreadName, AString::StrLen( tls_ProfileThreadData.m_ThreadName ) );
+    if ( ( buffer->m_ThreadName[ 0 ] == 0 ) && Thread::IsMainThread() )
+    {
+        AString::Copy( "_MainThread", buffer->m_ThreadName, 11 );
+    }
+
+    {
+        MutexHolder mh( g_ProfileManagerMutex );
+        buffer->m_ThreadIndex = g_ProfileNumEventBuffers++;
+        buffer->m_Next = g_ProfileEventBuffers;
+        AtomicStoreRelease( &g_ProfileEventBuffers, buffer );
+    }
+
+    tls_ProfileThreadData.m_Buffer = buffer;
+    return buffer;
 }
 
 // Synchronize
@@ -216,105 +340,125 @@ ProfileEvent * ProfileEventBuffer::AllocateEventStorage()
 //------------------------------------------------------------------------------
 /*static*/ void ProfileManager::SynchronizeNoTag()
 {
-    Array< ProfileEventInfo > infos( 0, true );
+    if ( AtomicLoadRelaxed( &s_Enabled ) == false )
     {
-        MutexHolder mh( g_ProfileManagerMutex );
-        infos.Swap( s_ProfileEventInfo );
+        return;
     }
 
-    // first time? open log file
-    if ( g_ProfileEventLog.IsOpen() == false )
+    WriteEvents();
+}
+
+// DumpThreadFunc
+//------------------------------------------------------------------------------
+/*static*/ uint32_t ProfileManager::DumpThreadFunc( void * )
+{
+    MEMTRACKER_DISABLE_THREAD
+
+    g_ProfileDumpThreadStarted.Signal();
+
+    // NOTE: Avoid allocating from here on, as this thread runs while the
+    //       allocator may be in single threaded mode (see SmallBlockAllocator)
+    for ( ;; )
     {
-        if ( g_ProfileEventLog.Open( "profile.json", FileStream::WRITE_ONLY | FileStream::NO_RETRY_ON_SHARING_VIOLATION ) )
+        g_ProfileDumpThreadSemaphore.Wait( PROFILE_DUMP_INTERVAL_MS );
+
+        const bool exit = AtomicLoadRelaxed( &g_ProfileDumpThreadExit );
+
+        WriteEvents();
+
+        if ( exit )
         {
-            g_ProfileEventLog.WriteBuffer( "[ ", 2 ); // json array opening tag
+            break;
         }
     }
 
-    // write all the events we have
-    const ProfileEventInfo * const end = infos.End();
-    AStackString< 8192 > buffer;
-    const double freqMul = ( Timer::GetFrequencyInvFloatMS() * 1000.0 );
-    if ( g_ProfileEventLog.IsOpen() )
+    MEMTRACKER_ENABLE_THREAD
+    return 0;
+}
+
+// WriteEvents
+//------------------------------------------------------------------------------
+/*static*/ void ProfileManager::WriteEvents()
+{
+    MutexHolder mh( g_ProfileManagerMutex );
+
+    if ( g_ProfileEventLog.IsOpen() == false )
+    {
+        return;
+    }
+
+    AStackString< PROFILE_WRITE_BUFFER_SIZE > buffer;
+    char threadIndexAsString[ 24 ];
+    char eventTimeBuffer[ 24 ];
+
+    for ( ProfileEventBuffer * eventBuffer = AtomicLoadAcquire( &g_ProfileEventBuffers );
+          eventBuffer;
+          eventBuffer = eventBuffer->m_Next )
     {
-        for ( const ProfileEventInfo * it = infos.Begin(); it != end; ++it )
+        FormatU64( eventBuffer->m_ThreadIndex, threadIndexAsString );
+
+        const uint64_t readPos = eventBuffer->m_ReadPos;
+        const uint64_t writePos = AtomicLoadAcquire( &eventBuffer->m_WritePos );
+        if ( readPos == writePos )
+        {
+            continue;
+        }
+
+        // SetThreadName event
+        // {"name": "thread_name", "ph": "M", "pid": 0, "tid": 164, "args": { "name" : "ThreadName" }},
+        if ( ( eventBuffer->m_ThreadNameWritten == false ) && ( eventBuffer->m_ThreadName[ 0 ] != 0 ) )
+        {
+            buffer += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":";
+            buffer += threadIndexAsString;
+            buffer += ", \"args\":{\"name\":\"";
+            buffer += eventBuffer->m_ThreadName;
+            buffer += "\"}},\n";
+            eventBuffer->m_ThreadNameWritten = true;
+        }
+
+        for ( uint64_t pos = readPos; pos != writePos; ++pos )
         {
-            const ProfileEventInfo & info = *it;
-            uint64_t threadId = (uint64_t)info.m_ThreadId;
-            char threadIsAsString[ 32 ];
+            const ProfileEvent & e = eventBuffer->m_Events[ pos & ( PROFILE_EVENTS_PER_THREAD - 1 ) ];
 
-            // Thread Name
-            if ( ( info.m_ThreadName.IsEmpty() == false ) || ( info.m_ThreadId == Thread::GetMainThreadId() ) )
+            // {"name": "Asub", "ph": "B", "pid": 22630, "tid": 22630, "ts": 829},
+            if ( e.m_Id )
             {
-                if ( info.m_ThreadName.IsEmpty() == false )
-                {
-                    threadId = xxHash::Calc32( info.m_ThreadName );
-                }
-                FormatU64( threadId, threadIsAsString );
-
-                // SetThreadName event
-                // {"name": "thread_name", "ph": "M", "pid": 0, "tid": 164, "args": { "name" : "ThreadName" }},
-                buffer += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":";
-                buffer += threadIsAsString;
-                buffer += ", \"args\":{\"name\":\"";
-                buffer += info.m_ThreadName.IsEmpty() ? "_MainThread" : info.m_ThreadName.Get();
-                buffer += "\"}},\n";
-
-                if ( buffer.GetLength() > ( 8192 - 256 ) )
-                {
-                    g_ProfileEventLog.WriteBuffer( buffer.Get(), buffer.GetLength() );
-                    buffer.Clear();
-                }
+                buffer += "{\"name\":\"";
+                buffer += e.m_Id;
+                buffer += "\",\"ph\":\"B\",\"pid\":0,\"tid\":";
             }
             else
             {
-                FormatU64( threadId, threadIsAsString );
+                buffer += "{\"name\":\"\",\"ph\":\"E\",\"pid\":0,\"tid\":";
             }
-
-            const size_t numEvents( info.m_NumEvents );
-            for ( size_t i = 0; i < numEvents; ++i )
+            buffer += threadIndexAsString;
+            buffer += ",\"ts\":";
+            const uint64_t timeStamp = ( e.m_TimeStamp > g_ProfileBaseTimeStamp ) ? ( e.m_TimeStamp - g_ProfileBaseTimeStamp ) : 0;
+            const uint64_t eventTimeNS = (uint64_t)( (double)timeStamp * 1000.0 / g_ProfileTimeStampsPerUS );
+            FormatU64( eventTimeNS / 1000, eventTimeBuffer );
+            buffer += eventTimeBuffer;
+            buffer += '.';
+            const uint32_t fraction = (uint32_t)( eventTimeNS % 1000 );
+            buffer += (char)( '0' + ( fraction / 100 ) );
+            buffer += (char)( '0' + ( ( fraction / 10 ) % 10 ) );
+            buffer += (char)( '0' + ( fraction % 10 ) );
+            buffer += "},\n";
+
+            if ( buffer.GetLength() > ( PROFILE_WRITE_BUFFER_SIZE - 256 ) )
             {
-                const ProfileEvent & e = info.m_Events[ i ];
-
-                // {"name": "Asub", "ph": "B", "pid": 22630, "tid": 22630, "ts": 829},
-                if ( e.m_Id )
-                {
-                    buffer += "{\"name\":\"";
-                    buffer += e.m_Id;
-                    buffer += "\",\"ph\":\"B\",\"pid\":0,\"tid\":";
-                }
-                else
-                {
-                    buffer += "{\"name\":\"\",\"ph\":\"E\",\"pid\":0,\"tid\":";
-                }
-                buffer += threadIsAsString;
-                buffer += ",\"ts\":";
-                const uint64_t eventTime = (uint64_t)( (double)e.m_TimeStamp * freqMul );
-                char eventTimeBuffer[ 32 ];
-                FormatU64( eventTime, eventTimeBuffer );
-                buffer += eventTimeBuffer;
-                buffer += "},\n";
-
-                if ( buffer.GetLength() > ( 8192 - 256 ) )
-                {
-                    g_ProfileEventLog.WriteBuffer( buffer.Get(), buffer.GetLength() );
-                    buffer.Clear();
-                }
+                g_ProfileEventLog.WriteBuffer( buffer.Get(), buffer.GetLength() );
+                buffer.Clear();
             }
         }
 
-        // Flush remaining
-        if ( buffer.GetLength() > 0 )
-        {
-            g_ProfileEventLog.WriteBuffer( buffer.Get(), buffer.GetLength() );
-            buffer.Clear();
-        }
+        // release the space to the owning thread
+        AtomicStoreRelease( &eventBuffer->m_ReadPos, writePos );
     }
 
-    for ( const ProfileEventInfo * it = infos.Begin(); it != end; ++it )
+    // Flush remaining
+    if ( buffer.GetLength() > 0 )
     {
-        const ProfileEventInfo & info = *it;
-        FDELETE[] info.m_Events;
+        g_ProfileEventLog.WriteBuffer( buffer.Get(), buffer.GetLength() );
     }
 }
 
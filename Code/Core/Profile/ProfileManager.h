@@ -4,26 +4,36 @@
 
 // Master Define
 //------------------------------------------------------------------------------
-#ifdef PROFILING_ENABLED // defined globally through build system
+// Profiling is compiled in unless explicitly disabled through the build system,
+// and is recorded only once enabled at runtime (see ProfileManager::Enable)
+#if !defined( PROFILING_DISABLED ) && !defined( PROFILING_ENABLED )
+    #define PROFILING_ENABLED
+#endif
+
+#ifdef PROFILING_ENABLED
 
 // Includes
 //------------------------------------------------------------------------------
-#include "Core/Containers/Array.h"
 #include "Core/Env/Types.h"
-#include "Core/Process/Thread.h"
-#include "Core/Strings/AStackString.h"
 
 // Forward Declarations
 //------------------------------------------------------------------------------
-struct ProfileSection;
-struct ProfileEvent;
+struct ProfileEventBuffer;
 
 // ProfileManager
 //------------------------------------------------------------------------------
 class ProfileManager
 {
 public:
-    // call once per frame (or other synchronization point)
+    // Start recording events, which are written to the file by a background thread
+    static void Enable( const char * fileName = "profile.json" );
+
+    // Stop recording, then flush remaining events and close the file
+    static void Disable();
+
+    inline static bool IsEnabled() { return s_Enabled; }
+
+    // flush recorded events to the file now (e.g. once per frame)
     static void Synchronize();
     static void SynchronizeNoTag(); // don't push a tag around synchronization
 
@@ -35,23 +45,18 @@ public:
     // Assign human readable name to current thread
     static void SetThreadName( const char * threadName );
 
+    // Events discarded because a thread's buffer was full
+    static uint32_t GetNumDroppedEvents();
+
 private:
-    // when a thread is finished with an event buffer (full or forced syncrhonization)
-    // it's passed to the ProfileManager to
-    friend struct ProfileEventBuffer;
-    static void PushThreadEvents( const ProfileEvent * events, size_t num, const char * threadName );
-
-    struct ProfileEventInfo
-    {
-        Thread::ThreadId        m_ThreadId;
-        AStackString< 32 >      m_ThreadName;
-        const ProfileEvent *    m_Events;
-        size_t                  m_NumEvents;
-    };
-    static Array< ProfileEventInfo > s_ProfileEventInfo;
+    static ProfileEventBuffer * CreateThreadBuffer();
+    static uint32_t DumpThreadFunc( void * param );
+    static void WriteEvents();
+
+    static volatile bool s_Enabled; // checked without a lock, set under the manager mutex
 };
 
 //------------------------------------------------------------------------------
-#endif // PROFILING_ENBLED
+#endif // PROFILING_ENABLED
 
 //------------------------------------------------------------------------------
@@ -6,6 +6,8 @@
 #include "AString.h"
 #include "AStackString.h"
 #include "Core/Math/Conversions.h"
+#include "Core/Mem/MemArena.h"
+#include "Core/Strings/StringSIMD.h"
 
 #include <stdarg.h>
 #include <stdio.h>
@@ -14,9 +16,26 @@
 
 // Static
 //------------------------------------------------------------------------------
+static_assert( sizeof( AString ) == 16, "AString should stay small (short strings overlay m_Contents)" );
 /*static*/ const char * const AString::s_EmptyString( "" );
 /*static*/ const AString AString::s_EmptyAString;
 
+// Helpers
+//------------------------------------------------------------------------------
+// As ( StrNCmp( a, b, num ) == 0 ), but vectorized
+static inline bool StrNEq( const char * a, const char * b, size_t num )
+{
+    const size_t i = StringSIMD::Mismatch( a, b, num );
+    return ( ( i == num ) || ( a[ i ] == b[ i ] ) ); // identical, or both strings ended
+}
+
+// As ( StrNCmpI( a, b, num ) == 0 ), but vectorized
+static inline bool StrNEqI( const char * a, const char * b, size_t num )
+{
+    const size_t i = StringSIMD::MismatchI( a, b, num );
+    return ( ( i == num ) || ( a[ i ] == b[ i ] ) ); // identical, or both strings ended
+}
+
 // CONSTRUCTOR
 //------------------------------------------------------------------------------
 AString::AString()
@@ -29,29 +48,29 @@ AString::AString()
 // CONSTRUCTOR (uint32_t)
 //------------------------------------------------------------------------------
 AString::AString( uint32_t reserve )
+    : m_Contents( const_cast<char *>( s_EmptyString ) ) // cast to allow pointing to protected string
+    , m_Length( 0 )
+    , m_ReservedAndFlags( 0 )
 {
-    char * mem = const_cast<char *>( s_EmptyString ); // cast to allow pointing to protected string
     if ( reserve > 0 )
     {
-        reserve = Math::RoundUp( reserve, (uint32_t)2 );
-        mem = (char *)ALLOC( reserve + 1 );
-        mem[ 0 ] = '\000';
+        GrowNoCopy( reserve );
+        Get()[ 0 ] = '\000';
     }
-    m_Contents = mem;
-    m_Length = 0;
-    SetReserved( reserve, true );
 }
 
 // CONSTRUCTOR (const AString &)
 //------------------------------------------------------------------------------
 AString::AString( const AString & string )
+    : m_ReservedAndFlags( 0 )
 {
     uint32_t len = string.GetLength();
     m_Length = len;
     uint32_t reserved = Math::RoundUp( len, (uint32_t)2 );
-    m_Contents = (char *)ALLOC( reserved + 1 );
-    SetReserved( reserved, true );
-    Copy( string.Get(), m_Contents, len ); // handles terminator (NOTE: Using len to support embedded nuls)
+    bool mustBeFreed;
+    char * contents = AllocContents( reserved, mustBeFreed );
+    SetContents( contents, reserved, mustBeFreed );
+    Copy( string.Get(), Get(), len ); // handles terminator (NOTE: Using len to support embedded nuls)
 }
 
 // CONSTRUCTOR (AString &&)
@@ -59,6 +78,7 @@ AString::AString( const AString & string )
 AString::AString( AString && string )
 {
     // If source string memory can't be freed, it can't be moved
+    // (this includes short strings in the inline buffer)
     if ( string.MemoryMustBeFreed() == false )
     {
         // Copy
@@ -72,40 +92,44 @@ AString::AString( AString && string )
         // Move
         m_Contents = string.m_Contents;
         m_Length = string.m_Length;
-        m_ReservedAndFlags = string.m_ReservedAndFlags;
+        m_ReservedAndFlags = ( string.m_ReservedAndFlags & ~USE_THREAD_ARENA_FLAG );
     }
 
     // Clear other string
     string.m_Contents = const_cast<char*>( s_EmptyString );
     string.m_Length = 0;
-    string.m_ReservedAndFlags = 0;
+    string.m_ReservedAndFlags &= USE_THREAD_ARENA_FLAG;
 }
 
 // CONSTRUCTOR (const char *)
 //------------------------------------------------------------------------------
 AString::AString( const char * string )
+    : m_ReservedAndFlags( 0 )
 {
     ASSERT( string );
     uint32_t len = (uint32_t)StrLen( string );
     m_Length = len;
     uint32_t reserved = Math::RoundUp( len, (uint32_t)2 );
-    m_Contents = (char *)ALLOC( reserved + 1 );
-    SetReserved( reserved, true );
-    Copy( string, m_Contents ); // copy handles terminator
+    bool mustBeFreed;
+    char * contents = AllocContents( reserved, mustBeFreed );
+    SetContents( contents, reserved, mustBeFreed );
+    Copy( string, Get() ); // copy handles terminator
 }
 
 // CONSTRUCTOR (const char *, const char *)
 //------------------------------------------------------------------------------
 AString::AString( const char * start, const char * end )
+    : m_ReservedAndFlags( 0 )
 {
     ASSERT( start );
     ASSERT( end >= start );
     uint32_t len = uint32_t( end - start );
     m_Length = len;
     uint32_t reserved = Math::RoundUp( len, (uint32_t)2 );
-    m_Contents = (char *)ALLOC( reserved + 1 );
-    SetReserved( reserved, true );
-    Copy( start, m_Contents, len ); // copy handles terminator
+    bool mustBeFreed;
+    char * contents = AllocContents( reserved, mustBeFreed );
+    SetContents( contents, reserved, mustBeFreed );
+    Copy( start, Get(), len ); // copy handles terminator
 }
 
 // DESTRUCTOR
@@ -128,9 +152,15 @@ AString::~AString()
         // if we don't own the memory, either:
         // a) We are an empty string, pointing to the special global empty string
         // OR:
-        // b) We are a StackString, and we should point to our internal buffer
-        ASSERT( ( m_Contents == s_EmptyString ) ||
-                ( (void *)m_Contents == (void *)( (char *)this + sizeof( AString ) ) ) );
+        // b) We are a short string in our inline buffer
+        // OR:
+        // c) We are a StackString, and we should point to our internal buffer
+        // OR:
+        // d) Our memory belongs to a MemArena
+        ASSERT( IsInline() ||
+                ( m_Contents == s_EmptyString ) ||
+                ( (void *)m_Contents == (void *)( (char *)this + sizeof( AString ) ) ) ||
+                ( m_ReservedAndFlags & USE_THREAD_ARENA_FLAG ) );
     }
 }
 
@@ -138,7 +168,7 @@ AString::~AString()
 //------------------------------------------------------------------------------
 bool AString::operator == ( const char * other ) const
 {
-    const char * thisPos = m_Contents;
+    const char * thisPos = Get();
     const char * otherPos = other;
 
 loop:
@@ -166,21 +196,21 @@ bool AString::operator == ( const AString & other ) const
         return false;
     }
 
-    return ( *this == other.Get() );
+    return StrNEq( Get(), other.Get(), m_Length );
 }
 
 // Compare
 //------------------------------------------------------------------------------
 int32_t AString::Compare( const AString & other ) const
 {
-    return strcmp( m_Contents, other.Get() );
+    return strcmp( Get(), other.Get() );
 }
 
 // Compare
 //------------------------------------------------------------------------------
 int32_t AString::Compare( const char * other ) const
 {
-    return strcmp( m_Contents, other );
+    return strcmp( Get(), other );
 }
 
 // CompareI
@@ -188,9 +218,21 @@ int32_t AString::Compare( const char * other ) const
 int32_t AString::CompareI( const AString & other ) const
 {
     #if defined( __WINDOWS__ )
-        return _stricmp( m_Contents, other.Get() );
+        // _stricmp is locale aware and scalar. Lengths are known, so find the
+        // first difference in bulk instead. The terminator of the shorter string
+        // is included, so a difference is always found.
+        const size_t len = ( ( m_Length < other.GetLength() ) ? m_Length : other.GetLength() ) + 1;
+        const size_t i = StringSIMD::MismatchI( Get(), other.Get(), len );
+        ASSERT( i < len );
+
+        // Same relationship as _stricmp
+        uint8_t a = (uint8_t)Get()[ i ];
+        uint8_t b = (uint8_t)other.Get()[ i ];
+        a = ( ( a >= 'A' ) && ( a <= 'Z' ) ) ? (uint8_t)( a + ( 'a' - 'A' ) ) : a;
+        b = ( ( b >= 'A' ) && ( b <= 'Z' ) ) ? (uint8_t)( b + ( 'a' - 'A' ) ) : b;
+        return ( (int32_t)a - (int32_t)b );
     #elif defined( __APPLE__ ) || defined( __LINUX__ )
-        return strcasecmp( m_Contents, other.Get() );
+        return strcasecmp( Get(), other.Get() ); // already vectorized by libc
     #else
         #error Unknown platform
     #endif
@@ -201,14 +243,25 @@ int32_t AString::CompareI( const AString & other ) const
 int32_t AString::CompareI( const char * other ) const
 {
     #if defined( __WINDOWS__ )
-        return _stricmp( m_Contents, other );
+        return _stricmp( Get(), other );
     #elif defined( __APPLE__ ) || defined( __LINUX__ )
-        return strcasecmp( m_Contents, other );
+        return strcasecmp( Get(), other );
     #else
         #error Unknown platform
     #endif
 }
 
+// EqualsI
+//------------------------------------------------------------------------------
+bool AString::EqualsI( const AString & other ) const
+{
+    if ( other.GetLength() != GetLength() )
+    {
+        return false;
+    }
+    return StrNEqI( Get(), other.Get(), m_Length );
+}
+
 // Format
 //------------------------------------------------------------------------------
 AString & AString::Format( MSVC_SAL_PRINTF const char * fmtString, ... )
@@ -380,13 +433,13 @@ void AString::Assign( const char * start, const char * end )
     {
         GrowNoCopy( len );
     }
-    else if ( m_Contents == s_EmptyString )
+    else if ( Get() == s_EmptyString )
     {
         // if we are the special empty string, and we
         // didn't resize then the passed in string is empty too
         return;
     }
-    Copy( start, m_Contents, len ); // handles terminator
+    Copy( start, Get(), len ); // handles terminator
     m_Length = len;
 }
 
@@ -399,13 +452,13 @@ void AString::Assign( const AString & string )
     {
         GrowNoCopy( len );
     }
-    else if ( m_Contents == s_EmptyString )
+    else if ( Get() == s_EmptyString )
     {
         // if we are the special empty string, and we
         // didn't resize then the passed in string is empty too
         return;
     }
-    Copy( string.Get(), m_Contents, len ); // handles terminator (NOTE: Using len to support embedded nuls)
+    Copy( string.Get(), Get(), len ); // handles terminator (NOTE: Using len to support embedded nuls)
     m_Length = len;
 }
 
@@ -427,13 +480,13 @@ void AString::Assign( AString && string )
         }
         m_Contents = string.m_Contents;
         m_Length = string.m_Length;
-        m_ReservedAndFlags = string.m_ReservedAndFlags;
+        m_ReservedAndFlags = ( ( string.m_ReservedAndFlags & ~USE_THREAD_ARENA_FLAG ) | ( m_ReservedAndFlags & USE_THREAD_ARENA_FLAG ) );
     }
 
     // Clear other string
     string.m_Contents = const_cast<char*>( s_EmptyString );
     string.m_Length = 0;
-    string.m_ReservedAndFlags = 0;
+    string.m_ReservedAndFlags &= USE_THREAD_ARENA_FLAG;
 }
 
 // Clear
@@ -441,13 +494,13 @@ void AString::Assign( AString && string )
 void AString::Clear()
 {
     // handle the special case empty string with no mem usage
-    if ( m_Contents == s_EmptyString )
+    if ( Get() == s_EmptyString )
     {
         return;
     }
 
     // truncate, but don't free the memory
-    m_Contents[ 0 ] = '\000';
+    Get()[ 0 ] = '\000';
     m_Length = 0;
 }
 
@@ -476,9 +529,9 @@ void AString::SetLength( uint32_t len )
 
     // Gracefully handle SetLength( 0 ) on already empty string pointing to the
     // global storage.
-    if ( m_Contents != s_EmptyString )
+    if ( Get() != s_EmptyString )
     {
-        m_Contents[ len ] = '\000';
+        Get()[ len ] = '\000';
     }
     m_Length = len;
 
@@ -495,8 +548,8 @@ AString & AString::operator += ( char c )
     {
         Grow( m_Length + 1 );
     }
-    m_Contents[ m_Length++ ] = c;
-    m_Contents[ m_Length ] = '\000';
+    Get()[ m_Length++ ] = c;
+    Get()[ m_Length ] = '\000';
 
     return *this;
 }
@@ -514,7 +567,7 @@ AString & AString::operator += ( const char * string )
             Grow( newLen );
         }
 
-        Copy( string, m_Contents + m_Length ); // handles terminator
+        Copy( string, Get() + m_Length ); // handles terminator
         m_Length += suffixLen;
     }
     return *this;
@@ -533,7 +586,7 @@ AString & AString::operator += ( const AString & string )
             Grow( newLen );
         }
 
-        Copy( string.Get(), m_Contents + m_Length, suffixLen ); // handles terminator (NOTE: Using suffixLen to support embedded nuls)
+        Copy( string.Get(), Get() + m_Length, suffixLen ); // handles terminator (NOTE: Using suffixLen to support embedded nuls)
         m_Length += suffixLen;
     }
     return *this;
@@ -551,7 +604,7 @@ AString & AString::Append( const char * string, size_t len )
             Grow( newLen );
         }
 
-        Copy( string, m_Contents + m_Length, len ); // handles terminator
+        Copy( string, Get() + m_Length, len ); // handles terminator
         m_Length = newLen;
     }
 
@@ -578,8 +631,8 @@ AString & AString::AppendFormat( MSVC_SAL_PRINTF const char * fmtString, ... )
 uint32_t AString::Replace( char from, char to, uint32_t maxReplaces )
 {
     uint32_t replaceCount = 0;
-    char * pos = m_Contents;
-    const char * end = m_Contents + m_Length;
+    char * pos = Get();
+    const char * end = Get() + m_Length;
     while ( pos < end )
     {
         if ( *pos == from )
@@ -600,26 +653,15 @@ uint32_t AString::Replace( char from, char to, uint32_t maxReplaces )
 //------------------------------------------------------------------------------
 void AString::ToLower()
 {
-    char * pos = m_Contents;
-    char * end = m_Contents + m_Length;
-    while ( pos < end )
-    {
-        char c = *pos;
-        if ( ( c >= 'A' ) && ( c <= 'Z' ) )
-        {
-            c = 'a' + ( c - 'A' );
-            *pos = c;
-        }
-        pos++;
-    }
+    StringSIMD::ToLower( Get(), m_Length );
 }
 
 // ToUpper
 //------------------------------------------------------------------------------
 void AString::ToUpper()
 {
-    char * pos = m_Contents;
-    char * end = m_Contents + m_Length;
+    char * pos = Get();
+    char * end = Get() + m_Length;
     while ( pos < end )
     {
         char c = *pos;
@@ -660,8 +702,8 @@ void AString::Trim( uint32_t startCharsToTrim, uint32_t endCharsToTrim )
 void AString::TrimStart( char charToTrimFromStart )
 {
     uint32_t nbrCharsToRemoveFromStart = 0;
-    const char * pos = m_Contents;
-    const char * end = m_Contents + m_Length;
+    const char * pos = Get();
+    const char * end = Get() + m_Length;
     for ( ; pos < end && *pos == charToTrimFromStart; ++pos, ++nbrCharsToRemoveFromStart ) 
     {
     }
@@ -674,8 +716,8 @@ void AString::TrimStart( char charToTrimFromStart )
 void AString::TrimEnd( char charToTrimFromEnd )
 {
     uint32_t nbrCharsToRemoveFromEnd = 0;
-    const char * pos = m_Contents + m_Length - 1;
-    const char * end = m_Contents;
+    const char * pos = Get() + m_Length - 1;
+    const char * end = Get();
     for ( ; pos >= end && *pos == charToTrimFromEnd; --pos, ++nbrCharsToRemoveFromEnd ) 
     {
     }
@@ -698,8 +740,8 @@ uint32_t AString::Replace( const char * from, const char * to, uint32_t maxRepla
     uint32_t replaceCount = 0;
 
     // loop until the last possible position for a potential match
-    const char * pos = m_Contents;
-    const char * end = m_Contents + m_Length;
+    const char * pos = Get();
+    const char * end = Get() + m_Length;
     while ( pos <= ( end - fromLength ) )
     {
         if ( StrNCmp( pos, from, fromLength ) == 0 )
@@ -742,14 +784,14 @@ const char * AString::Find( char c, const char * startPos, const char * endPos )
 {
     // if startPos is provided, validate it
     // (deliberately allow startPos to point one past end of string)
-    ASSERT( ( startPos == nullptr ) || ( startPos >= m_Contents ) );
-    ASSERT( ( startPos == nullptr ) || ( startPos <= m_Contents + GetLength() ) );
+    ASSERT( ( startPos == nullptr ) || ( startPos >= Get() ) );
+    ASSERT( ( startPos == nullptr ) || ( startPos <= Get() + GetLength() ) );
 
-    const char * pos = startPos ? startPos : m_Contents;
-    const char * end = endPos ? endPos : m_Contents + m_Length;
+    const char * pos = startPos ? startPos : Get();
+    const char * end = endPos ? endPos : Get() + m_Length;
 
     ASSERT( end >= pos );
-    ASSERT( end <= m_Contents + GetLength() );
+    ASSERT( end <= Get() + GetLength() );
 
     while ( pos < end )
     {
@@ -768,17 +810,17 @@ const char * AString::Find( const char * subString, const char * startPos, const
 {
     // if startPos is provided, validate it
     // (deliberately allow startPos to point one past end of string)
-    ASSERT( ( startPos == nullptr ) || ( startPos >= m_Contents ) );
-    ASSERT( ( startPos == nullptr ) || ( startPos <= m_Contents + GetLength() ) );
+    ASSERT( ( startPos == nullptr ) || ( startPos >= Get() ) );
+    ASSERT( ( startPos == nullptr ) || ( startPos <= Get() + GetLength() ) );
 
     const size_t subStrLen = StrLen( subString );
 
-    const char * pos = startPos ? startPos : m_Contents;
-    const char * end = endPos ? endPos : m_Contents + m_Length;
+    const char * pos = startPos ? startPos : Get();
+    const char * end = endPos ? endPos : Get() + m_Length;
     ASSERT( end >= pos );
     end -= subStrLen;
 
-    ASSERT( end <= m_Contents + GetLength() );
+    ASSERT( end <= Get() + GetLength() );
 
     while ( pos <= end )
     {
@@ -797,17 +839,17 @@ const char * AString::Find( const AString & subString, const char * startPos, co
 {
     // if startPos is provided, validate it
     // (deliberately allow startPos to point one past end of string)
-    ASSERT( ( startPos == nullptr ) || ( startPos >= m_Contents ) );
-    ASSERT( ( startPos == nullptr ) || ( startPos <= m_Contents + GetLength() ) );
+    ASSERT( ( startPos == nullptr ) || ( startPos >= Get() ) );
+    ASSERT( ( startPos == nullptr ) || ( startPos <= Get() + GetLength() ) );
 
     const size_t subStrLen = subString.GetLength();
 
-    const char * pos = startPos ? startPos : m_Contents;
-    const char * end = endPos ? endPos : m_Contents + m_Length;
+    const char * pos = startPos ? startPos : Get();
+    const char * end = endPos ? endPos : Get() + m_Length;
     ASSERT( end >= pos );
     end -= subStrLen;
 
-    ASSERT( end <= m_Contents + GetLength() );
+    ASSERT( end <= Get() + GetLength() );
 
     while ( pos <= end )
     {
@@ -826,14 +868,14 @@ const char * AString::FindI( char c, const char * startPos, const char * endPos
 {
     // if startPos is provided, validate it
     // (deliberately allow startPos to point one past end of string)
-    ASSERT( ( startPos == nullptr ) || ( startPos >= m_Contents ) );
-    ASSERT( ( startPos == nullptr ) || ( startPos <= m_Contents + GetLength() ) );
+    ASSERT( ( startPos == nullptr ) || ( startPos >= Get() ) );
+    ASSERT( ( startPos == nullptr ) || ( startPos <= Get() + GetLength() ) );
 
-    const char * pos = startPos ? startPos : m_Contents;
-    const char * end = endPos ? endPos : m_Contents + m_Length;
+    const char * pos = startPos ? startPos : Get();
+    const char * end = endPos ? endPos : Get() + m_Length;
 
     ASSERT( end >= pos );
-    ASSERT( end <= m_Contents + GetLength() );
+    ASSERT( end <= Get() + GetLength() );
 
     char a1 = c;
     if ( ( a1 >= 'A' ) && ( a1 <= 'Z' ) )
@@ -863,17 +905,17 @@ const char * AString::FindI( const char * subString, const char * startPos, cons
 {
     // if startPos is provided, validate it
     // (deliberately allow startPos to point one past end of string)
-    ASSERT( ( startPos == nullptr ) || ( startPos >= m_Contents ) );
-    ASSERT( ( startPos == nullptr ) || ( startPos <= m_Contents + GetLength() ) );
+    ASSERT( ( startPos == nullptr ) || ( startPos >= Get() ) );
+    ASSERT( ( startPos == nullptr ) || ( startPos <= Get() + GetLength() ) );
 
     const size_t subStrLen = StrLen( subString );
 
-    const char * pos = startPos ? startPos : m_Contents;
-    const char * end = endPos ? endPos : m_Contents + m_Length;
+    const char * pos = startPos ? startPos : Get();
+    const char * end = endPos ? endPos : Get() + m_Length;
     ASSERT( end >= pos );
     end -= subStrLen;
 
-    ASSERT( end <= m_Contents + GetLength() );
+    ASSERT( end <= Get() + GetLength() );
 
     while ( pos <= end )
     {
@@ -892,17 +934,17 @@ const char * AString::FindI( const AString & subString, const char * startPos, c
 {
     // if startPos is provided, validate it
     // (deliberately allow startPos to point one past end of string)
-    ASSERT( ( startPos == nullptr ) || ( startPos >= m_Contents ) );
-    ASSERT( ( startPos == nullptr ) || ( startPos <= m_Contents + GetLength() ) );
+    ASSERT( ( startPos == nullptr ) || ( startPos >= Get() ) );
+    ASSERT( ( startPos == nullptr ) || ( startPos <= Get() + GetLength() ) );
 
     const size_t subStrLen = subString.GetLength();
 
-    const char * pos = startPos ? startPos : m_Contents;
-    const char * end = endPos ? endPos : m_Contents + m_Length;
+    const char * pos = startPos ? startPos : Get();
+    const char * end = endPos ? endPos : Get() + m_Length;
     ASSERT( end >= pos );
     end -= subStrLen;
 
-    ASSERT( end <= m_Contents + GetLength() );
+    ASSERT( end <= Get() + GetLength() );
 
     while ( pos <= end )
     {
@@ -921,11 +963,11 @@ const char * AString::FindLast( char c, const char * startPos, const char * endP
 {
     // if startPos is provided, validate it
     // (deliberately allow startPos to point one past end of string)
-    ASSERT( ( startPos == nullptr ) || ( startPos >= m_Contents ) );
-    ASSERT( ( startPos == nullptr ) || ( startPos <= m_Contents + GetLength() ) );
+    ASSERT( ( startPos == nullptr ) || ( startPos >= Get() ) );
+    ASSERT( ( startPos == nullptr ) || ( startPos <= Get() + GetLength() ) );
 
-    const char * pos = startPos ? startPos : ( m_Contents + m_Length - 1 );
-    const char * end = endPos ? endPos : m_Contents;
+    const char * pos = startPos ? startPos : ( Get() + m_Length - 1 );
+    const char * end = endPos ? endPos : Get();
     while ( pos >= end )
     {
         if ( *pos == c )
@@ -943,14 +985,14 @@ const char * AString::FindLast( const char * subString, const char * startPos, c
 {
     // if startPos is provided, validate it
     // (deliberately allow startPos to point one past end of string)
-    ASSERT( ( startPos == nullptr ) || ( startPos >= m_Contents ) );
-    ASSERT( ( startPos == nullptr ) || ( startPos <= m_Contents + GetLength() ) );
+    ASSERT( ( startPos == nullptr ) || ( startPos >= Get() ) );
+    ASSERT( ( startPos == nullptr ) || ( startPos <= Get() + GetLength() ) );
 
     const size_t subStrLen = StrLen( subString );
 
-    const char * pos = startPos ? startPos : ( m_Contents + m_Length - subStrLen );
-    const char * end = endPos ? endPos : m_Contents;
-    ASSERT( ( end <= pos ) && ( end >= m_Contents ) );
+    const char * pos = startPos ? startPos : ( Get() + m_Length - subStrLen );
+    const char * end = endPos ? endPos : Get();
+    ASSERT( ( end <= pos ) && ( end >= Get() ) );
 
     while ( pos >= end )
     {
@@ -969,14 +1011,14 @@ const char * AString::FindLast( const AString & subString, const char * startPos
 {
     // if startPos is provided, validate it
     // (deliberately allow startPos to point one past end of string)
-    ASSERT( ( startPos == nullptr ) || ( startPos >= m_Contents ) );
-    ASSERT( ( startPos == nullptr ) || ( startPos <= m_Contents + GetLength() ) );
+    ASSERT( ( startPos == nullptr ) || ( startPos >= Get() ) );
+    ASSERT( ( startPos == nullptr ) || ( startPos <= Get() + GetLength() ) );
 
     const size_t subStrLen = subString.GetLength();
 
-    const char * pos = startPos ? startPos : ( m_Contents + m_Length - subStrLen );
-    const char * end = endPos ? endPos : m_Contents;
-    ASSERT( ( end <= pos ) && ( end >= m_Contents ) );
+    const char * pos = startPos ? startPos : ( Get() + m_Length - subStrLen );
+    const char * end = endPos ? endPos : Get();
+    ASSERT( ( end <= pos ) && ( end >= Get() ) );
 
     while ( pos >= end )
     {
@@ -995,11 +1037,11 @@ const char * AString::FindLastI( char c, const char * startPos, const char * end
 {
     // if startPos is provided, validate it
     // (deliberately allow startPos to point one past end of string)
-    ASSERT( ( startPos == nullptr ) || ( startPos >= m_Contents ) );
-    ASSERT( ( startPos == nullptr ) || ( startPos <= m_Contents + GetLength() ) );
+    ASSERT( ( startPos == nullptr ) || ( startPos >= Get() ) );
+    ASSERT( ( startPos == nullptr ) || ( startPos <= Get() + GetLength() ) );
 
-    const char * pos = startPos ? startPos : ( m_Contents + m_Length - 1 );
-    const char * end = endPos ? endPos : m_Contents;
+    const char * pos = startPos ? startPos : ( Get() + m_Length - 1 );
+    const char * end = endPos ? endPos : Get();
 
     char a1 = c;
     if ( ( a1 >= 'A' ) && ( a1 <= 'Z' ) )
@@ -1029,14 +1071,14 @@ const char * AString::FindLastI( const char * subString, const char * startPos,
 {
     // if startPos is provided, validate it
     // (deliberately allow startPos to point one past end of string)
-    ASSERT( ( startPos == nullptr ) || ( startPos >= m_Contents ) );
-    ASSERT( ( startPos == nullptr ) || ( startPos <= m_Contents + GetLength() ) );
+    ASSERT( ( startPos == nullptr ) || ( startPos >= Get() ) );
+    ASSERT( ( startPos == nullptr ) || ( startPos <= Get() + GetLength() ) );
 
     const size_t subStrLen = StrLen( subString );
 
-    const char * pos = startPos ? startPos : ( m_Contents + m_Length - subStrLen );
-    const char * end = endPos ? endPos : m_Contents;
-    ASSERT( ( end <= pos ) && ( end >= m_Contents ) );
+    const char * pos = startPos ? startPos : ( Get() + m_Length - subStrLen );
+    const char * end = endPos ? endPos : Get();
+    ASSERT( ( end <= pos ) && ( end >= Get() ) );
 
     while ( pos >= end )
     {
@@ -1055,14 +1097,14 @@ const char * AString::FindLastI( const AString & subString, const char * startPo
 {
     // if startPos is provided, validate it
     // (deliberately allow startPos to point one past end of string)
-    ASSERT( ( startPos == nullptr ) || ( startPos >= m_Contents ) );
-    ASSERT( ( startPos == nullptr ) || ( startPos <= m_Contents + GetLength() ) );
+    ASSERT( ( startPos == nullptr ) || ( startPos >= Get() ) );
+    ASSERT( ( startPos == nullptr ) || ( startPos <= Get() + GetLength() ) );
 
     const size_t subStrLen = subString.GetLength();
 
-    const char * pos = startPos ? startPos : ( m_Contents + m_Length - subStrLen );
-    const char * end = endPos ? endPos : m_Contents;
-    ASSERT( ( end <= pos ) && ( end >= m_Contents ) );
+    const char * pos = startPos ? startPos : ( Get() + m_Length - subStrLen );
+    const char * end = endPos ? endPos : Get();
+    ASSERT( ( end <= pos ) && ( end >= Get() ) );
 
     while ( pos >= end )
     {
@@ -1084,7 +1126,7 @@ bool AString::EndsWith( char c ) const
     {
         return false;
     }
-    return ( m_Contents[ len - 1 ] == c );
+    return ( Get()[ len - 1 ] == c );
 }
 
 // EndsWith
@@ -1092,12 +1134,12 @@ bool AString::EndsWith( char c ) const
 bool AString::EndsWith( const char * string ) const
 {
     const size_t stringLen = StrLen( string );
-    const char * possiblePos = m_Contents + m_Length - stringLen;
-    if ( possiblePos < m_Contents )
+    const char * possiblePos = Get() + m_Length - stringLen;
+    if ( possiblePos < Get() )
     {
         return false; // string to search is longer than this string
     }
-    return ( StrNCmp( possiblePos, string, stringLen ) == 0 );
+    return StrNEq( possiblePos, string, stringLen );
 }
 
 // EndsWith
@@ -1109,7 +1151,7 @@ bool AString::EndsWith( const AString & other ) const
     {
         return false;
     }
-    return ( StrNCmp( GetEnd() - otherLen, other.Get(), otherLen ) == 0 );
+    return StrNEq( GetEnd() - otherLen, other.Get(), otherLen );
 }
 
 // EndsWithI
@@ -1121,7 +1163,7 @@ bool AString::EndsWithI( const char * other ) const
     {
         return false;
     }
-    return ( StrNCmpI( GetEnd() - otherLen, other, otherLen ) == 0 );
+    return StrNEqI( GetEnd() - otherLen, other, otherLen );
 }
 
 // EnsWithI
@@ -1133,7 +1175,7 @@ bool AString::EndsWithI( const AString & other ) const
     {
         return false;
     }
-    return ( StrNCmpI( GetEnd() - otherLen, other.Get(), otherLen ) == 0 );
+    return StrNEqI( GetEnd() - otherLen, other.Get(), otherLen );
 }
 
 // BeginsWith
@@ -1144,7 +1186,7 @@ bool AString::BeginsWith( char c ) const
     {
         return false;
     }
-    return ( m_Contents[ 0 ] == c );
+    return ( Get()[ 0 ] == c );
 }
 
 // BeginsWith
@@ -1156,7 +1198,7 @@ bool AString::BeginsWith( const char * string ) const
     {
         return false;
     }
-    return ( StrNCmp( m_Contents, string, otherLen ) == 0 );
+    return StrNEq( Get(), string, otherLen );
 }
 
 // BeginsWith
@@ -1168,7 +1210,7 @@ bool AString::BeginsWith( const AString & string ) const
     {
         return false;
     }
-    return ( StrNCmp( m_Contents, string.Get(), otherLen ) == 0 );
+    return StrNEq( Get(), string.Get(), otherLen );
 }
 
 // BeginsWithI
@@ -1180,7 +1222,7 @@ bool AString::BeginsWithI( const char * string ) const
     {
         return false;
     }
-    return ( StrNCmpI( m_Contents, string, otherLen ) == 0 );
+    return StrNEqI( Get(), string, otherLen );
 }
 
 // BeginsWithI
@@ -1192,7 +1234,7 @@ bool AString::BeginsWithI( const AString & string ) const
     {
         return false;
     }
-    return ( StrNCmpI( m_Contents, string.Get(), otherLen ) == 0 );
+    return StrNEqI( Get(), string.Get(), otherLen );
 }
 
 // Match
@@ -1386,19 +1428,22 @@ void AString::Grow( uint32_t newLength )
 {
     // allocate space, rounded up to multiple of 2
     const uint32_t amortizedReserve = ( GetReserved() * 2 );
-    const uint32_t reserve = Math::RoundUp( Math::Max( amortizedReserve, newLength ),(uint32_t)2 );
-    char * newMem = (char *)ALLOC( reserve + 1 ); // also allocate for \0 terminator
+    uint32_t reserve = Math::RoundUp( Math::Max( amortizedReserve, newLength ),(uint32_t)2 );
+    bool mustBeFreed;
+    char * newMem = AllocContents( reserve, mustBeFreed );
 
     // transfer existing string data
-    Copy( m_Contents, newMem, m_Length ); // copy handles terminator
+    // (old contents pointer is read first, as an inline newMem overlays it)
+    char * oldMem = Get();
+    const bool oldMustBeFreed = MemoryMustBeFreed();
+    Copy( oldMem, newMem, m_Length ); // copy handles terminator
 
-    if ( MemoryMustBeFreed() )
+    if ( oldMustBeFreed )
     {
-        FREE( m_Contents );
+        FREE( oldMem );
     }
 
-    m_Contents = newMem;
-    SetReserved( reserve, true );
+    SetContents( newMem, reserve, mustBeFreed );
 }
 
 // GrowNoCopy
@@ -1412,8 +1457,53 @@ void AString::GrowNoCopy( uint32_t newLength )
 
     // allocate space, rounded up to multiple of 2
     uint32_t reserve = Math::RoundUp( newLength, (uint32_t)2 );
-    m_Contents = (char *)ALLOC( reserve + 1 ); // also allocate for \0 terminator
-    SetReserved( reserve, true );
+    bool mustBeFreed;
+    char * contents = AllocContents( reserve, mustBeFreed );
+    SetContents( contents, reserve, mustBeFreed );
+}
+
+// AllocContents
+//------------------------------------------------------------------------------
+char * AString::AllocContents( uint32_t & inOutReserve, bool & outMustBeFreed )
+{
+    const uint32_t reserve = inOutReserve;
+
+    // Short strings don't need an allocation
+    if ( reserve <= INLINE_RESERVED )
+    {
+        inOutReserve = INLINE_RESERVED;
+        outMustBeFreed = false;
+        return m_Inline;
+    }
+
+    if ( m_ReservedAndFlags & USE_THREAD_ARENA_FLAG )
+    {
+        MemArena * arena = MemArena::GetThreadArena();
+        if ( arena )
+        {
+            outMustBeFreed = false; // released with the arena
+            return (char *)arena->Alloc( reserve + 1, sizeof( char ) ); // also allocate for \0 terminator
+        }
+    }
+    outMustBeFreed = true;
+    return (char *)ALLOC( reserve + 1 ); // also allocate for \0 terminator
+}
+
+// SetContents
+//------------------------------------------------------------------------------
+void AString::SetContents( char * contents, uint32_t reserved, bool mustFreeMemory )
+{
+    SetReserved( reserved, mustFreeMemory );
+
+    // Inline contents are found via the flag, as they overlay the pointer
+    if ( contents == m_Inline )
+    {
+        m_ReservedAndFlags |= INLINE_FLAG;
+    }
+    else
+    {
+        m_Contents = contents;
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -38,12 +38,12 @@ public:
     inline bool         IsEmpty() const     { return ( m_Length == 0 ); }
 
     // C-style compatibility
-    inline char *       Get()               { return m_Contents; }
-    inline const char * Get() const         { return m_Contents; }
-    inline char *       GetEnd()            { return ( m_Contents + m_Length ); }
-    inline const char * GetEnd() const      { return ( m_Contents + m_Length ); }
-    inline char &       operator [] ( size_t index )        { ASSERT( index < m_Length ); return m_Contents[ index ]; }
-    inline const char & operator [] ( size_t index )  const { ASSERT( index < m_Length ); return m_Contents[ index ]; }
+    inline char *       Get()               { return IsInline() ? m_Inline : m_Contents; }
+    inline const char * Get() const         { return IsInline() ? m_Inline : m_Contents; }
+    inline char *       GetEnd()            { return ( Get() + m_Length ); }
+    inline const char * GetEnd() const      { return ( Get() + m_Length ); }
+    inline char &       operator [] ( size_t index )        { ASSERT( index < m_Length ); return Get()[ index ]; }
+    inline const char & operator [] ( size_t index )  const { ASSERT( index < m_Length ); return Get()[ index ]; }
 
     // a pre-constructed global empty string for convenience
     static const AString & GetEmpty() { return s_EmptyAString; }
@@ -59,6 +59,10 @@ public:
     void Clear();
     void SetReserved( size_t capacity );
 
+    // Allocate from the calling thread's MemArena (when there is one) from now on
+    // (NOTE: The string must not outlive the MemArenaScope)
+    inline void UseThreadArena() { m_ReservedAndFlags |= USE_THREAD_ARENA_FLAG; }
+
     // manually set length - NOTE: caller is responsible for making string contents valid
     void SetLength( uint32_t len );
 
@@ -82,7 +86,7 @@ public:
     inline bool Equals( const char * other ) const { return (*this == other ); }
     inline bool Equals( const AString & other ) const { return (*this == other ); }
     inline bool EqualsI( const char * other ) const { return ( CompareI( other ) == 0 ); }
-    inline bool EqualsI( const AString & other ) const { return ( CompareI( other ) == 0 ); }
+    bool EqualsI( const AString & other ) const;
     inline bool operator < ( const AString & other ) const { return ( Compare( other ) < 0 ); }
     inline bool operator > ( const AString & other ) const { return ( Compare( other ) > 0 ); }
 
@@ -149,9 +153,9 @@ public:
 
     // pattern matching
     static bool     Match( const char * pattern, const char * string );
-    inline bool     Matches( const char * pattern ) const { return Match( pattern, m_Contents ); }
+    inline bool     Matches( const char * pattern ) const { return Match( pattern, Get() ); }
     static bool     MatchI( const char * pattern, const char * string );
-    inline bool     MatchesI( const char * pattern ) const { return MatchI( pattern, m_Contents ); }
+    inline bool     MatchesI( const char * pattern ) const { return MatchI( pattern, Get() ); }
 
     // string manipulation helpers
     static void Copy( const char * src, char * dst );
@@ -162,19 +166,29 @@ public:
 
 protected:
     enum : uint32_t { MEM_MUST_BE_FREED_FLAG    = 0x00000001 };
-    enum : uint32_t { RESERVED_MASK             = 0xFFFFFFFE };
+    enum : uint32_t { INLINE_FLAG               = 0x40000000 }; // Contents are in m_Inline (overlaying m_Contents)
+    enum : uint32_t { USE_THREAD_ARENA_FLAG     = 0x80000000 }; // Belongs to the string, not the memory, so never moved
+    enum : uint32_t { RESERVED_MASK             = 0x3FFFFFFE };
+    enum : uint32_t { INLINE_RESERVED           = 6 };          // Strings up to this length are stored in m_Inline
 
     inline void SetReserved( uint32_t reserved, bool mustFreeMemory )
     {
-        ASSERT( ( reserved & MEM_MUST_BE_FREED_FLAG ) == 0 ); // ensure reserved does not use lower bit
-        m_ReservedAndFlags = ( reserved ^ ( mustFreeMemory ? (uint32_t)MEM_MUST_BE_FREED_FLAG : 0 ) );
+        ASSERT( ( reserved & ~RESERVED_MASK ) == 0 ); // ensure reserved does not use flag bits
+        m_ReservedAndFlags = ( reserved | ( mustFreeMemory ? (uint32_t)MEM_MUST_BE_FREED_FLAG : 0 ) | ( m_ReservedAndFlags & USE_THREAD_ARENA_FLAG ) );
     }
+    inline bool IsInline() const { return ( ( m_ReservedAndFlags & INLINE_FLAG ) != 0 ); }
+    void SetContents( char * contents, uint32_t reserved, bool mustFreeMemory );
     NO_INLINE void Grow( uint32_t newLen );     // Grow capacity, transferring existing string data (for concatenation)
     NO_INLINE void GrowNoCopy( uint32_t newLen ); // Grow capacity, discarding existing string data (for assignment/construction)
+    char * AllocContents( uint32_t & inOutReserve, bool & outMustBeFreed );
 
-    char *      m_Contents;         // always points to valid null terminated string (even when empty)
+    union
+    {
+        char *  m_Contents;         // always points to valid null terminated string (even when empty)
+        char    m_Inline[ 8 ];      // or, when INLINE_FLAG is set, holds a short string in place of the pointer
+    };
     uint32_t    m_Length;           // length in characters
-    uint32_t    m_ReservedAndFlags; // reserved space in characters (even) and least significant bit used for static flag
+    uint32_t    m_ReservedAndFlags; // reserved space in characters (even) and least/two most significant bits used for static/inline/arena flags
 
     static const char * const   s_EmptyString;
     static const AString    s_EmptyAString;
@@ -0,0 +1,229 @@
+// StringSIMD - Vectorized character scanning for strings and paths
+//------------------------------------------------------------------------------
+
+// Includes
+//------------------------------------------------------------------------------
+#include "StringSIMD.h"
+
+// Core
+#include "Core/Env/Assert.h"
+#include "Core/FileIO/PathUtils.h"
+
+// system
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+    #define STRINGSIMD_SSE2
+    #include <emmintrin.h>
+    #if defined( __WINDOWS__ )
+        #include <intrin.h>
+    #endif
+#endif
+
+// Helpers
+//------------------------------------------------------------------------------
+static inline char ToLowerASCII( char c )
+{
+    return ( ( c >= 'A' ) && ( c <= 'Z' ) ) ? (char)( c + ( 'a' - 'A' ) ) : c;
+}
+
+#if defined( STRINGSIMD_SSE2 )
+    // Index of the lowest set bit (mask must be non-zero)
+    static inline uint32_t LowestSetBit( uint32_t mask )
+    {
+        ASSERT( mask != 0 );
+        #if defined( __WINDOWS__ )
+            unsigned long index;
+            _BitScanForward( &index, mask );
+            return (uint32_t)index;
+        #else
+            return (uint32_t)__builtin_ctz( mask );
+        #endif
+    }
+
+    // Convert 'A'-'Z' to 'a'-'z' by setting bit 0x20. Offsetting the characters
+    // moves 'A'-'Z' to the bottom of the signed range, so a single signed
+    // comparison finds them.
+    static inline __m128i ToLowerASCII( __m128i v )
+    {
+        const __m128i offset = _mm_add_epi8( v, _mm_set1_epi8( (char)( 0x80 - 'A' ) ) );
+        const __m128i isUpper = _mm_cmplt_epi8( offset, _mm_set1_epi8( (char)( 0x80 + 26 ) ) );
+        return _mm_or_si128( v, _mm_and_si128( isUpper, _mm_set1_epi8( 0x20 ) ) );
+    }
+#endif
+
+// Mismatch
+//------------------------------------------------------------------------------
+/*static*/ size_t StringSIMD::Mismatch( const char * a, const char * b, size_t len )
+{
+    size_t i = 0;
+
+    #if defined( STRINGSIMD_SSE2 )
+        if ( len >= 16 )
+        {
+            const __m128i zero = _mm_setzero_si128();
+            for ( ;; )
+            {
+                const __m128i va = _mm_loadu_si128( (const __m128i *)( a + i ) );
+                const __m128i vb = _mm_loadu_si128( (const __m128i *)( b + i ) );
+                const uint32_t equal = (uint32_t)_mm_movemask_epi8( _mm_cmpeq_epi8( va, vb ) );
+                const uint32_t nulls = (uint32_t)_mm_movemask_epi8( _mm_cmpeq_epi8( va, zero ) );
+                const uint32_t stop = ( equal ^ 0xFFFF ) | nulls;
+                if ( stop )
+                {
+                    return ( i + LowestSetBit( stop ) );
+                }
+                if ( i == ( len - 16 ) )
+                {
+                    return len;
+                }
+
+                // Last block overlaps the previous one (already known to match)
+                i = ( ( i + 32 ) <= len ) ? ( i + 16 ) : ( len - 16 );
+            }
+        }
+    #endif
+
+    for ( ; i < len; ++i )
+    {
+        if ( ( a[ i ] != b[ i ] ) || ( a[ i ] == '\0' ) )
+        {
+            return i;
+        }
+    }
+    return len;
+}
+
+// MismatchI
+//------------------------------------------------------------------------------
+/*static*/ size_t StringSIMD::MismatchI( const char * a, const char * b, size_t len )
+{
+    size_t i = 0;
+
+    #if defined( STRINGSIMD_SSE2 )
+        if ( len >= 16 )
+        {
+            const __m128i zero = _mm_setzero_si128();
+            for ( ;; )
+            {
+                const __m128i va = _mm_loadu_si128( (const __m128i *)( a + i ) );
+                const __m128i vb = _mm_loadu_si128( (const __m128i *)( b + i ) );
+                const uint32_t equal = (uint32_t)_mm_movemask_epi8( _mm_cmpeq_epi8( ToLowerASCII( va ), ToLowerASCII( vb ) ) );
+                const uint32_t nulls = (uint32_t)_mm_movemask_epi8( _mm_cmpeq_epi8( va, zero ) );
+                const uint32_t stop = ( equal ^ 0xFFFF ) | nulls;
+                if ( stop )
+                {
+                    return ( i + LowestSetBit( stop ) );
+                }
+                if ( i == ( len - 16 ) )
+                {
+                    return len;
+                }
+
+                // Last block overlaps the previous one (already known to match)
+                i = ( ( i + 32 ) <= len ) ? ( i + 16 ) : ( len - 16 );
+            }
+        }
+    #endif
+
+    for ( ; i < len; ++i )
+    {
+        if ( ( ToLowerASCII( a[ i ] ) != ToLowerASCII( b[ i ] ) ) || ( a[ i ] == '\0' ) )
+        {
+            return i;
+        }
+    }
+    return len;
+}
+
+// CopyPath
+//------------------------------------------------------------------------------
+/*static*/ size_t StringSIMD::CopyPath( char * dst, const char * src, size_t len, bool afterSlash )
+{
+    if ( afterSlash && ( len > 0 ) && ( src[ 0 ] == '.' ) )
+    {
+        return 0; // possible "./" or "../"
+    }
+
+    size_t i = 0;
+
+    #if defined( STRINGSIMD_SSE2 )
+        const __m128i nativeSlash = _mm_set1_epi8( NATIVE_SLASH );
+        const __m128i otherSlash = _mm_set1_epi8( OTHER_SLASH );
+        const __m128i dot = _mm_set1_epi8( '.' );
+        for ( ; ( i + 16 ) <= len; i += 16 )
+        {
+            // Each character, and the one following it (reads at most src[ len ])
+            const __m128i v = _mm_loadu_si128( (const __m128i *)( src + i ) );
+            const __m128i next = _mm_loadu_si128( (const __m128i *)( src + i + 1 ) );
+
+            const __m128i isOtherSlash = _mm_cmpeq_epi8( v, otherSlash );
+            const __m128i isSlash = _mm_or_si128( _mm_cmpeq_epi8( v, nativeSlash ), isOtherSlash );
+            const __m128i nextIsSpecial = _mm_or_si128( _mm_or_si128( _mm_cmpeq_epi8( next, nativeSlash ),
+                                                                      _mm_cmpeq_epi8( next, otherSlash ) ),
+                                                        _mm_cmpeq_epi8( next, dot ) );
+
+            // Store the whole block with slashes fixed. Anything beyond a stopping
+            // point will be overwritten by the caller.
+            const __m128i fixed = _mm_or_si128( _mm_andnot_si128( isOtherSlash, v ),
+                                                _mm_and_si128( isOtherSlash, nativeSlash ) );
+            _mm_storeu_si128( (__m128i *)( dst + i ), fixed );
+
+            const uint32_t stop = (uint32_t)_mm_movemask_epi8( _mm_and_si128( isSlash, nextIsSpecial ) );
+            if ( stop )
+            {
+                return ( i + LowestSetBit( stop ) );
+            }
+        }
+    #endif
+
+    for ( ; i < len; ++i )
+    {
+        const char c = src[ i ];
+        if ( ( c == NATIVE_SLASH ) || ( c == OTHER_SLASH ) )
+        {
+            const char next = src[ i + 1 ];
+            if ( ( next == NATIVE_SLASH ) || ( next == OTHER_SLASH ) || ( next == '.' ) )
+            {
+                return i;
+            }
+            dst[ i ] = NATIVE_SLASH;
+        }
+        else
+        {
+            dst[ i ] = c;
+        }
+    }
+    return len;
+}
+
+// ToLower
+//------------------------------------------------------------------------------
+/*static*/ void StringSIMD::ToLower( char * pos, size_t len )
+{
+    size_t i = 0;
+
+    #if defined( STRINGSIMD_SSE2 )
+        if ( len >= 16 )
+        {
+            for ( ; ( i + 16 ) <= len; i += 16 )
+            {
+                const __m128i v = _mm_loadu_si128( (const __m128i *)( pos + i ) );
+                _mm_storeu_si128( (__m128i *)( pos + i ), ToLowerASCII( v ) );
+            }
+
+            // Last block overlaps the previous one (converting again is harmless)
+            if ( i < len )
+            {
+                const __m128i v = _mm_loadu_si128( (const __m128i *)( pos + len - 16 ) );
+                _mm_storeu_si128( (__m128i *)( pos + len - 16 ), ToLowerASCII( v ) );
+            }
+            return;
+        }
+    #endif
+
+    for ( ; i < len; ++i )
+    {
+        pos[ i ] = ToLowerASCII( pos[ i ] );
+    }
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,37 @@
+// StringSIMD - Vectorized character scanning for strings and paths
+//------------------------------------------------------------------------------
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+#include "Core/Env/Types.h"
+
+// StringSIMD
+//  - Processes 16 characters at a time using SSE2 when available, with a
+//    scalar fallback for other targets and for the tail of each range
+//  - Only characters inside the given ranges are ever read, so these are safe
+//    to use at the end of a buffer
+//  - Case insensitivity applies to ASCII only (as with StrNCmpI)
+//------------------------------------------------------------------------------
+class StringSIMD
+{
+public:
+    // Index of the first character in [0, len) which differs between a and b
+    // or is a null terminator in a, or len if there is no such character.
+    // Matches the stopping point of strncmp (or StrNCmpI for MismatchI)
+    static size_t Mismatch( const char * a, const char * b, size_t len );
+    static size_t MismatchI( const char * a, const char * b, size_t len );
+
+    // Copy path characters from src to dst, converting OTHER_SLASH to NATIVE_SLASH,
+    // until reaching something needing further cleaning: a slash followed by
+    // another slash or a '.', or a leading '.' when the path so far ends in a
+    // slash (afterSlash). Returns the number of characters copied.
+    //  - src[ len ] must be readable (normally the null terminator)
+    //  - dst must have room for len characters and not be ahead of src
+    static size_t CopyPath( char * dst, const char * src, size_t len, bool afterSlash );
+
+    // Convert ASCII A-Z to lower case in place
+    static void ToLower( char * pos, size_t len );
+};
+
+//------------------------------------------------------------------------------
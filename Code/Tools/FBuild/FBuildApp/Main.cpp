@@ -60,7 +60,7 @@ int main( int argc, char * argv[] )
 {
     // This wrapper is purely for profiling scope
     int result = Main( argc, argv );
-    PROFILE_SYNCHRONIZE // make sure no tags are active and do one final sync
+    PROFILE_DISABLE // make sure no tags are active and do one final flush
     return result;
 }
 
@@ -138,6 +138,11 @@ int Main( int argc, char * argv[] )
         return WrapperMainProcess( options.m_Args, options, finalProcess );
     }
 
+    if ( options.m_EnableProfiling )
+    {
+        PROFILE_ENABLE( "profile.json" )
+    }
+
     ASSERT( ( wrapperMode == FBuildOptions::WRAPPER_MODE_NONE ) ||
             ( wrapperMode == FBuildOptions::WRAPPER_MODE_FINAL_PROCESS ) );
 
@@ -202,6 +207,10 @@ int Main( int argc, char * argv[] )
     {
         result = fBuild.CacheTrim();
     }
+    else if ( options.m_DisplayHistory )
+    {
+        result = fBuild.DisplayHistory();
+    }
     else
     {
         result = fBuild.Build( options.m_Targets );
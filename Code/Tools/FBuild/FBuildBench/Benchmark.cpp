@@ -0,0 +1,60 @@
+// Benchmark.cpp
+//------------------------------------------------------------------------------
+
+// Includes
+//------------------------------------------------------------------------------
+#include "Benchmark.h"
+
+// FBuildCore
+#include "Tools/FBuild/FBuildCore/FBuild.h"
+
+// Core
+#include "Core/FileIO/FileIO.h"
+#include "Core/FileIO/FileStream.h"
+#include "Core/FileIO/PathUtils.h"
+#include "Core/Strings/AString.h"
+
+// Static Data
+//------------------------------------------------------------------------------
+static volatile uint64_t g_ConsumedValue = 0;
+
+// Consume
+//------------------------------------------------------------------------------
+/*static*/ void Benchmark::Consume( uint64_t value )
+{
+    g_ConsumedValue = ( g_ConsumedValue + value );
+}
+
+// Scale
+//------------------------------------------------------------------------------
+/*static*/ uint32_t Benchmark::Scale( uint32_t fullSize, uint32_t quickSize )
+{
+    return BenchmarkManager::Get().IsQuick() ? quickSize : fullSize;
+}
+
+// Fail
+//------------------------------------------------------------------------------
+/*static*/ void Benchmark::Fail( const char * reason )
+{
+    BenchmarkManager::Get().RecordFailure( reason );
+}
+
+// GetTempDir
+//------------------------------------------------------------------------------
+/*static*/ void Benchmark::GetTempDir( const char * subDir, AString & outPath )
+{
+    VERIFY( FBuild::GetTempDir( outPath ) );
+    outPath.AppendFormat( "FBuildBench%c%s%c", NATIVE_SLASH, subDir, NATIVE_SLASH );
+}
+
+// WriteFile
+//------------------------------------------------------------------------------
+/*static*/ void Benchmark::WriteFile( const AString & fileName, const AString & contents )
+{
+    VERIFY( FileIO::EnsurePathExistsForFile( fileName ) );
+    FileStream f;
+    VERIFY( f.Open( fileName.Get(), FileStream::WRITE_ONLY ) );
+    VERIFY( f.WriteBuffer( contents.Get(), contents.GetLength() ) == contents.GetLength() );
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,112 @@
+// Benchmark.h - interface for a group of benchmarks
+//------------------------------------------------------------------------------
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+#include "BenchmarkManager.h"
+
+// Core
+#include "Core/Env/Types.h"
+#include "Core/Mem/Mem.h"
+#include "Core/Time/Timer.h"
+
+// Forward Declarations
+//------------------------------------------------------------------------------
+class AString;
+
+// Benchmark - Benchmark groups derive from this interface
+//------------------------------------------------------------------------------
+class Benchmark
+{
+protected:
+    explicit        Benchmark() { m_NextGroup = nullptr; }
+    inline virtual ~Benchmark() = default;
+
+    virtual void RunBenchmarks() = 0;
+    virtual const char * GetName() const = 0;
+
+    // Prevent results of benchmarked code being optimized away
+    static void Consume( uint64_t value );
+
+    // Workload sizes (reduced with -quick)
+    static uint32_t Scale( uint32_t fullSize, uint32_t quickSize );
+
+    // Report that the benchmarked code failed (the benchmark stops and no
+    // result is recorded for it)
+    static void Fail( const char * reason );
+
+    // Helpers for generated files
+    static void GetTempDir( const char * subDir, AString & outPath );
+    static void WriteFile( const AString & fileName, const AString & contents );
+
+private:
+    friend class BenchmarkManager;
+    Benchmark * m_NextGroup;
+};
+
+// BenchmarkTimer
+//  - Times the section of a benchmark it is in scope for. Setup outside of
+//    this scope is not included in the results.
+//  - numItems/itemType are used to report throughput (bytes, nodes etc)
+//------------------------------------------------------------------------------
+class BenchmarkTimer
+{
+public:
+    explicit BenchmarkTimer( uint64_t numItems = 0, const char * itemType = nullptr )
+        : m_NumItems( numItems )
+        , m_ItemType( itemType )
+    {}
+    ~BenchmarkTimer()
+    {
+        BenchmarkManager::Get().RecordRun( m_Timer.GetElapsed(), m_NumItems, m_ItemType );
+    }
+
+private:
+    Timer           m_Timer;
+    uint64_t        m_NumItems;
+    const char *    m_ItemType;
+};
+
+// Benchmark Declarations
+//------------------------------------------------------------------------------
+#define DECLARE_BENCHMARKS                                          \
+    virtual void RunBenchmarks();                                   \
+    virtual const char * GetName() const;
+
+#define REGISTER_BENCHMARKS_BEGIN( groupName )                      \
+    void groupName##Register()                                      \
+    {                                                               \
+        BenchmarkManager::RegisterGroup( FNEW( groupName ) );       \
+    }                                                               \
+    const char * groupName::GetName() const                         \
+    {                                                               \
+        return #groupName;                                          \
+    }                                                               \
+    void groupName::RunBenchmarks()                                 \
+    {                                                               \
+        BenchmarkManager & bm = BenchmarkManager::Get();            \
+        (void)bm;
+
+// Each benchmark function is called repeatedly and must time exactly one
+// section of its work with a BenchmarkTimer each time (benchmarks which can't
+// run return without a BenchmarkTimer on the first call to be skipped, and
+// benchmarks whose code fails call Fail)
+#define REGISTER_BENCHMARK( benchmarkFunction )                     \
+        if ( bm.BenchmarkBegin( this, #benchmarkFunction ) )        \
+        {                                                           \
+            do                                                      \
+            {                                                       \
+                benchmarkFunction();                                \
+            } while ( bm.BenchmarkRepeat() );                       \
+            bm.BenchmarkEnd();                                      \
+        }
+
+#define REGISTER_BENCHMARKS_END                                     \
+    }
+
+#define REGISTER_BENCHMARKGROUP( groupName )                        \
+        extern void groupName##Register();                          \
+        groupName##Register();
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,451 @@
+// BenchmarkManager.cpp
+//------------------------------------------------------------------------------
+
+// Includes
+//------------------------------------------------------------------------------
+#include "BenchmarkManager.h"
+#include "Benchmark.h"
+
+// FBuildCore
+#include "Tools/FBuild/FBuildCore/FBuildVersion.h"
+
+// Core
+#include "Core/Env/Assert.h"
+#include "Core/Env/Env.h"
+#include "Core/Math/Conversions.h"
+#include "Core/Mem/Mem.h"
+#include "Core/Strings/AStackString.h"
+#include "Core/Tracing/Tracing.h"
+
+// system
+#include <stdlib.h> // for strtod
+#include <string.h> // for strstr
+
+// Defines
+//------------------------------------------------------------------------------
+#define MAX_BENCHMARK_TIME_S ( 30.0f ) // stop repeating long running benchmarks after this
+
+// Static Data
+//------------------------------------------------------------------------------
+/*static*/ BenchmarkManager * BenchmarkManager::s_Instance = nullptr;
+/*static*/ Benchmark * BenchmarkManager::s_FirstGroup = nullptr;
+
+// Helpers
+//------------------------------------------------------------------------------
+namespace
+{
+    // Find a value in a single line result in the JSON written by WriteJSON
+    bool GetJSONValue( const char * line, const char * lineEnd, const char * key, AString & outValue )
+    {
+        AStackString<> search;
+        search.Format( "\"%s\":", key );
+        const char * pos = strstr( line, search.Get() );
+        if ( ( pos == nullptr ) || ( pos >= lineEnd ) )
+        {
+            return false;
+        }
+        pos += search.GetLength();
+        const bool quoted = ( *pos == '"' );
+        if ( quoted )
+        {
+            ++pos;
+        }
+        const char * end = pos;
+        while ( ( end < lineEnd ) && ( quoted ? ( *end != '"' ) : ( ( *end != ',' ) && ( *end != '}' ) ) ) )
+        {
+            ++end;
+        }
+        outValue.Assign( pos, end );
+        return true;
+    }
+
+    // Find the median time of a benchmark in the JSON written by WriteJSON
+    bool FindMedian( const AString & json, const AString & group, const AString & name, double & outMedianMS )
+    {
+        const char * line = json.Get();
+        while ( *line )
+        {
+            const char * lineEnd = strchr( line, '\n' );
+            lineEnd = lineEnd ? lineEnd : json.GetEnd();
+
+            AStackString<> lineGroup;
+            AStackString<> lineName;
+            AStackString<> median;
+            if ( GetJSONValue( line, lineEnd, "group", lineGroup ) &&
+                 GetJSONValue( line, lineEnd, "name", lineName ) &&
+                 GetJSONValue( line, lineEnd, "medianMS", median ) &&
+                 ( lineGroup == group ) && ( lineName == name ) )
+            {
+                outMedianMS = strtod( median.Get(), nullptr );
+                return true;
+            }
+
+            line = ( *lineEnd ) ? ( lineEnd + 1 ) : lineEnd;
+        }
+        return false;
+    }
+}
+
+// CONSTRUCTOR
+//------------------------------------------------------------------------------
+BenchmarkManager::BenchmarkManager()
+    : m_Quick( false )
+    , m_Verbose( false )
+    , m_Repetitions( 5 )
+    , m_Filter( nullptr )
+    , m_NumFailures( 0 )
+    , m_Results( 256, true )
+{
+    // manage singleton
+    ASSERT( s_Instance == nullptr );
+    s_Instance = this;
+}
+
+// DESTRUCTOR
+//------------------------------------------------------------------------------
+BenchmarkManager::~BenchmarkManager()
+{
+    // free all registered groups
+    Benchmark * group = s_FirstGroup;
+    while ( group )
+    {
+        Benchmark * next = group->m_NextGroup;
+        FDELETE group;
+        group = next;
+    }
+    s_FirstGroup = nullptr;
+
+    // manage singleton
+    ASSERT( s_Instance == this );
+    s_Instance = nullptr;
+}
+
+// Get
+//------------------------------------------------------------------------------
+/*static*/ BenchmarkManager & BenchmarkManager::Get()
+{
+    ASSERT( s_Instance );
+    return *s_Instance;
+}
+
+// RegisterGroup
+//------------------------------------------------------------------------------
+/*static*/ void BenchmarkManager::RegisterGroup( Benchmark * group )
+{
+    // first ever group? place as head of list
+    if ( s_FirstGroup == nullptr )
+    {
+        s_FirstGroup = group;
+        return;
+    }
+
+    // link to end of list
+    Benchmark * thisGroup = s_FirstGroup;
+    while ( thisGroup->m_NextGroup )
+    {
+        thisGroup = thisGroup->m_NextGroup;
+    }
+    thisGroup->m_NextGroup = group;
+}
+
+// RunBenchmarks
+//------------------------------------------------------------------------------
+void BenchmarkManager::RunBenchmarks( const char * filter )
+{
+    m_Filter = filter;
+    m_Results.Clear();
+
+    Benchmark * group = s_FirstGroup;
+    while ( group )
+    {
+        group->RunBenchmarks();
+        group = group->m_NextGroup;
+    }
+
+    OUTPUT( "------------------------------------------------------------------------------\n" );
+    OUTPUT( "%-40s %10s %10s %10s %s\n", "Benchmark", "Min (ms)", "Med (ms)", "Mean (ms)", "Throughput" );
+    OUTPUT( "------------------------------------------------------------------------------\n" );
+    for ( const Result & result : m_Results )
+    {
+        AStackString<> name;
+        name.Format( "%s.%s", result.m_Group, result.m_Name );
+
+        AStackString<> throughput;
+        const float median = result.GetMedian();
+        if ( result.m_NumItems && ( median > 0.0f ) )
+        {
+            const float perSecond = (float)result.m_NumItems / median;
+            if ( perSecond >= 1000000.0f )
+            {
+                throughput.Format( "%.3f M %s/s", (double)( perSecond / 1000000.0f ), result.m_ItemType );
+            }
+            else if ( perSecond >= 1000.0f )
+            {
+                throughput.Format( "%.3f K %s/s", (double)( perSecond / 1000.0f ), result.m_ItemType );
+            }
+            else
+            {
+                throughput.Format( "%.3f %s/s", (double)perSecond, result.m_ItemType );
+            }
+        }
+
+        OUTPUT( "%-40s %10.3f %10.3f %10.3f %s\n",
+                name.Get(),
+                (double)( result.GetMin() * 1000.0f ),
+                (double)( median * 1000.0f ),
+                (double)( result.GetMean() * 1000.0f ),
+                throughput.Get() );
+    }
+    OUTPUT( "------------------------------------------------------------------------------\n" );
+}
+
+// WriteJSON
+//------------------------------------------------------------------------------
+void BenchmarkManager::WriteJSON( AString & outJSON ) const
+{
+    #if defined( DEBUG )
+        const char * config = "Debug";
+    #else
+        const char * config = "Release";
+    #endif
+
+    outJSON.Format( "{\n\"version\":\"%s\",\"platform\":\"%s\",\"config\":\"%s\",\"cpus\":%u,\"quick\":%s,\"benchmarks\":[\n",
+                    FBUILD_VERSION_STRING,
+                    FBUILD_VERSION_PLATFORM,
+                    config,
+                    Env::GetNumProcessors(),
+                    m_Quick ? "true" : "false" );
+
+    for ( size_t i = 0; i < m_Results.GetSize(); ++i )
+    {
+        const Result & result = m_Results[ i ];
+        const float median = result.GetMedian();
+        const double itemsPerSecond = ( median > 0.0f ) ? ( (double)result.m_NumItems / (double)median ) : 0.0;
+        outJSON.AppendFormat( "{\"group\":\"%s\",\"name\":\"%s\",\"runs\":%u,\"minMS\":%.4f,\"medianMS\":%.4f,\"meanMS\":%.4f,\"items\":%" PRIu64 ",\"itemType\":\"%s\",\"itemsPerSecond\":%.1f}%s\n",
+                              result.m_Group,
+                              result.m_Name,
+                              result.m_NumRuns,
+                              (double)( result.GetMin() * 1000.0f ),
+                              (double)( median * 1000.0f ),
+                              (double)( result.GetMean() * 1000.0f ),
+                              result.m_NumItems,
+                              result.m_ItemType ? result.m_ItemType : "",
+                              itemsPerSecond,
+                              ( i + 1 < m_Results.GetSize() ) ? "," : "" );
+    }
+
+    outJSON += "]\n}\n";
+}
+
+// Compare
+//------------------------------------------------------------------------------
+/*static*/ bool BenchmarkManager::Compare( const AString & baselineJSON,
+                                           const AString & currentJSON,
+                                           uint32_t thresholdPercent )
+{
+    OUTPUT( "------------------------------------------------------------------------------\n" );
+    OUTPUT( "%-40s %10s %10s %8s\n", "Benchmark", "Base (ms)", "New (ms)", "Change" );
+    OUTPUT( "------------------------------------------------------------------------------\n" );
+
+    uint32_t numRegressions = 0;
+    const char * line = currentJSON.Get();
+    while ( *line )
+    {
+        const char * lineEnd = strchr( line, '\n' );
+        lineEnd = lineEnd ? lineEnd : currentJSON.GetEnd();
+
+        AStackString<> group;
+        AStackString<> name;
+        AStackString<> median;
+        if ( GetJSONValue( line, lineEnd, "group", group ) &&
+             GetJSONValue( line, lineEnd, "name", name ) &&
+             GetJSONValue( line, lineEnd, "medianMS", median ) )
+        {
+            AStackString<> fullName;
+            fullName.Format( "%s.%s", group.Get(), name.Get() );
+
+            const double currentMS = strtod( median.Get(), nullptr );
+            double baselineMS = 0.0;
+            if ( FindMedian( baselineJSON, group, name, baselineMS ) == false )
+            {
+                OUTPUT( "%-40s %10s %10.3f %8s\n", fullName.Get(), "-", currentMS, "new" );
+            }
+            else
+            {
+                const double change = ( baselineMS > 0.0 ) ? ( ( currentMS - baselineMS ) * 100.0 / baselineMS ) : 0.0;
+                const bool regression = ( change > (double)thresholdPercent );
+                numRegressions += regression ? 1 : 0;
+                OUTPUT( "%-40s %10.3f %10.3f %+7.1f%%%s\n", fullName.Get(), baselineMS, currentMS, change, regression ? " REGRESSION" : "" );
+            }
+        }
+
+        line = ( *lineEnd ) ? ( lineEnd + 1 ) : lineEnd;
+    }
+
+    OUTPUT( "------------------------------------------------------------------------------\n" );
+    OUTPUT( "%u regression(s) above %u%%\n", numRegressions, thresholdPercent );
+    return ( numRegressions == 0 );
+}
+
+// BenchmarkBegin
+//------------------------------------------------------------------------------
+bool BenchmarkManager::BenchmarkBegin( Benchmark * group, const char * name )
+{
+    // filtered out?
+    if ( m_Filter )
+    {
+        AStackString<> fullName;
+        fullName.Format( "%s.%s", group->GetName(), name );
+        if ( fullName.FindI( m_Filter ) == nullptr )
+        {
+            return false;
+        }
+    }
+
+    OUTPUT( "Benchmark: %s.%s\n", group->GetName(), name );
+
+    Result result;
+    result.m_Group = group->GetName();
+    result.m_Name = name;
+    result.m_NumRuns = 0;
+    result.m_NumItems = 0;
+    result.m_ItemType = nullptr;
+    result.m_Failure = nullptr;
+    m_Results.Append( result );
+
+    if ( m_Verbose == false )
+    {
+        Tracing::AddCallbackOutput( SuppressOutputCallback );
+    }
+
+    m_BenchmarkTimer.Start();
+    return true;
+}
+
+// BenchmarkRepeat
+//------------------------------------------------------------------------------
+bool BenchmarkManager::BenchmarkRepeat()
+{
+    const Result & result = m_Results.Top();
+    if ( ( result.m_NumRuns == 0 ) || result.m_Failure )
+    {
+        return false; // benchmark was skipped (not supported on this platform for example) or failed
+    }
+
+    const uint32_t repetitions = m_Quick ? 1 : Math::Min< uint32_t >( m_Repetitions, MAX_REPETITIONS );
+    if ( result.m_NumRuns >= repetitions )
+    {
+        return false;
+    }
+
+    // avoid repeating benchmarks which take a long time too many times
+    if ( ( result.m_NumRuns >= 3 ) && ( m_BenchmarkTimer.GetElapsed() > MAX_BENCHMARK_TIME_S ) )
+    {
+        return false;
+    }
+
+    return true;
+}
+
+// BenchmarkEnd
+//------------------------------------------------------------------------------
+void BenchmarkManager::BenchmarkEnd()
+{
+    if ( m_Verbose == false )
+    {
+        Tracing::RemoveCallbackOutput( SuppressOutputCallback );
+    }
+
+    const Result & result = m_Results.Top();
+    if ( result.m_Failure )
+    {
+        OUTPUT( " - FAILED: %s\n", result.m_Failure );
+        ++m_NumFailures;
+        m_Results.Pop();
+        return;
+    }
+    if ( result.m_NumRuns == 0 )
+    {
+        OUTPUT( " - Skipped\n" );
+        m_Results.Pop();
+        return;
+    }
+    OUTPUT( " - %u run(s), median %.3f ms\n", result.m_NumRuns, (double)( result.GetMedian() * 1000.0f ) );
+}
+
+// RecordRun
+//------------------------------------------------------------------------------
+void BenchmarkManager::RecordRun( float timeTaken, uint64_t numItems, const char * itemType )
+{
+    Result & result = m_Results.Top();
+    if ( result.m_Failure )
+    {
+        return; // timings of failed runs are meaningless
+    }
+    ASSERT( result.m_NumRuns < MAX_REPETITIONS );
+    result.m_Times[ result.m_NumRuns++ ] = timeTaken;
+    result.m_NumItems = numItems;
+    result.m_ItemType = itemType;
+}
+
+// RecordFailure
+//------------------------------------------------------------------------------
+void BenchmarkManager::RecordFailure( const char * reason )
+{
+    Result & result = m_Results.Top();
+    if ( result.m_Failure == nullptr )
+    {
+        result.m_Failure = reason; // keep the first
+    }
+}
+
+// SuppressOutputCallback
+//------------------------------------------------------------------------------
+/*static*/ bool BenchmarkManager::SuppressOutputCallback( const char * /*message*/ )
+{
+    return false; // don't output
+}
+
+// Result::GetMin
+//------------------------------------------------------------------------------
+float BenchmarkManager::Result::GetMin() const
+{
+    float minTime = m_NumRuns ? m_Times[ 0 ] : 0.0f;
+    for ( uint32_t i = 1; i < m_NumRuns; ++i )
+    {
+        minTime = Math::Min( minTime, m_Times[ i ] );
+    }
+    return minTime;
+}
+
+// Result::GetMedian
+//------------------------------------------------------------------------------
+float BenchmarkManager::Result::GetMedian() const
+{
+    if ( m_NumRuns == 0 )
+    {
+        return 0.0f;
+    }
+    Array< float > sorted( m_NumRuns, false );
+    for ( uint32_t i = 0; i < m_NumRuns; ++i )
+    {
+        sorted.Append( m_Times[ i ] );
+    }
+    sorted.Sort();
+    return ( m_NumRuns % 2 ) ? sorted[ m_NumRuns / 2 ]
+                             : ( ( sorted[ ( m_NumRuns / 2 ) - 1 ] + sorted[ m_NumRuns / 2 ] ) * 0.5f );
+}
+
+// Result::GetMean
+//------------------------------------------------------------------------------
+float BenchmarkManager::Result::GetMean() const
+{
+    float total = 0.0f;
+    for ( uint32_t i = 0; i < m_NumRuns; ++i )
+    {
+        total += m_Times[ i ];
+    }
+    return m_NumRuns ? ( total / (float)m_NumRuns ) : 0.0f;
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,90 @@
+// BenchmarkManager
+//------------------------------------------------------------------------------
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+#include "Core/Containers/Array.h"
+#include "Core/Env/Types.h"
+#include "Core/Strings/AString.h"
+#include "Core/Time/Timer.h"
+
+// Forward Declarations
+//------------------------------------------------------------------------------
+class Benchmark;
+
+// BenchmarkManager
+//------------------------------------------------------------------------------
+class BenchmarkManager
+{
+public:
+    BenchmarkManager();
+    ~BenchmarkManager();
+
+    // settings
+    inline void SetRepetitions( uint32_t repetitions )  { m_Repetitions = repetitions; }
+    inline void SetQuick( bool quick )                  { m_Quick = quick; }
+    inline bool IsQuick() const                         { return m_Quick; }
+    inline void SetVerbose( bool verbose )              { m_Verbose = verbose; }
+
+    // run all benchmarks, or those whose "Group.Name" contains the filter
+    void RunBenchmarks( const char * filter = nullptr );
+
+    // machine readable results (one benchmark per line, for comparison)
+    void WriteJSON( AString & outJSON ) const;
+
+    // compare results of two runs, returning false if there are regressions
+    static bool Compare( const AString & baselineJSON,
+                         const AString & currentJSON,
+                         uint32_t thresholdPercent );
+
+    // singleton behaviour
+    static BenchmarkManager & Get();
+
+    // benchmark groups register (using the declaration macros) via this interface
+    static void RegisterGroup( Benchmark * group );
+
+    // When benchmarks are executed, they are wrapped with these
+    bool BenchmarkBegin( Benchmark * group, const char * name );
+    bool BenchmarkRepeat();
+    void BenchmarkEnd();
+
+    // BenchmarkTimer records results via this interface
+    void RecordRun( float timeTaken, uint64_t numItems, const char * itemType );
+
+    // benchmarks report failures via this interface
+    void RecordFailure( const char * reason );
+    inline uint32_t GetNumFailures() const { return m_NumFailures; }
+
+private:
+    enum : uint32_t { MAX_REPETITIONS = 32 };
+    struct Result
+    {
+        const char *    m_Group;
+        const char *    m_Name;
+        uint32_t        m_NumRuns;
+        float           m_Times[ MAX_REPETITIONS ];
+        uint64_t        m_NumItems;
+        const char *    m_ItemType;
+        const char *    m_Failure;
+
+        float GetMin() const;
+        float GetMedian() const;
+        float GetMean() const;
+    };
+
+    static bool SuppressOutputCallback( const char * message );
+
+    bool            m_Quick;
+    bool            m_Verbose;          // show output of benchmarked code (from FBuild for example)
+    uint32_t        m_Repetitions;
+    const char *    m_Filter;
+    uint32_t        m_NumFailures;
+    Timer           m_BenchmarkTimer;   // total time in current benchmark
+    Array< Result > m_Results;
+
+    static BenchmarkManager * s_Instance;
+    static Benchmark * s_FirstGroup;
+};
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,202 @@
+// BenchBFF.cpp - BFF parsing and dependency graph serialization
+//------------------------------------------------------------------------------
+
+// Includes
+//------------------------------------------------------------------------------
+#include "Tools/FBuild/FBuildBench/Benchmark.h"
+#include "Tools/FBuild/FBuildBench/FakeCompiler.h"
+
+// FBuildCore
+#include "Tools/FBuild/FBuildCore/BFF/BFFParser.h"
+#include "Tools/FBuild/FBuildCore/BFF/Tokenizer/BFFTokenizer.h"
+#include "Tools/FBuild/FBuildCore/FBuild.h"
+#include "Tools/FBuild/FBuildCore/Graph/NodeGraph.h"
+
+// Core
+#include "Core/Env/Env.h"
+#include "Core/FileIO/ConstMemoryStream.h"
+#include "Core/FileIO/MemoryStream.h"
+#include "Core/Strings/AStackString.h"
+#include "Core/Strings/AString.h"
+
+// BenchBFF
+//------------------------------------------------------------------------------
+class BenchBFF : public Benchmark
+{
+private:
+    DECLARE_BENCHMARKS
+
+    void Tokenize() const;
+    void Parse() const;
+    void NodeGraphSave() const;
+    void NodeGraphLoad() const;
+
+    // Helpers
+    static void GenerateBFF( uint32_t numModules, AString & outBFF );
+    static void GetBFF( AString & outBFFFile, AString & outBFF );
+};
+
+// Register Benchmarks
+//------------------------------------------------------------------------------
+REGISTER_BENCHMARKS_BEGIN( BenchBFF )
+    REGISTER_BENCHMARK( Tokenize )
+    REGISTER_BENCHMARK( Parse )
+    REGISTER_BENCHMARK( NodeGraphSave )
+    REGISTER_BENCHMARK( NodeGraphLoad )
+REGISTER_BENCHMARKS_END
+
+// Tokenize
+//------------------------------------------------------------------------------
+void BenchBFF::Tokenize() const
+{
+    AStackString<> bffFile;
+    AString bff;
+    GetBFF( bffFile, bff );
+
+    BenchmarkTimer timer( bff.GetLength(), "bytes" );
+    BFFTokenizer tokenizer;
+    if ( tokenizer.TokenizeFromString( bffFile, bff ) == false )
+    {
+        Fail( "Tokenize failed" );
+        return;
+    }
+    Consume( tokenizer.GetTokens().GetSize() );
+}
+
+// Parse
+//------------------------------------------------------------------------------
+void BenchBFF::Parse() const
+{
+    AStackString<> bffFile;
+    AString bff;
+    GetBFF( bffFile, bff );
+
+    FBuild fBuild;
+    NodeGraph ng;
+    BenchmarkTimer timer( bff.GetLength(), "bytes" );
+    BFFParser p( ng );
+    if ( p.ParseFromString( bffFile.Get(), bff.Get() ) == false )
+    {
+        Fail( "Parse failed" );
+        return;
+    }
+    Consume( ng.GetNodeCount() );
+}
+
+// NodeGraphSave
+//------------------------------------------------------------------------------
+void BenchBFF::NodeGraphSave() const
+{
+    AStackString<> bffFile;
+    AString bff;
+    GetBFF( bffFile, bff );
+
+    FBuildOptions options;
+    options.m_ConfigFile = bffFile;
+    FBuild fBuild( options );
+    if ( fBuild.Initialize() == false )
+    {
+        Fail( "Initialize failed" );
+        return;
+    }
+
+    MemoryStream ms;
+    BenchmarkTimer timer;
+    fBuild.SaveDependencyGraph( ms, "bench.fdb" );
+    Consume( ms.GetFileSize() );
+}
+
+// NodeGraphLoad
+//------------------------------------------------------------------------------
+void BenchBFF::NodeGraphLoad() const
+{
+    AStackString<> bffFile;
+    AString bff;
+    GetBFF( bffFile, bff );
+
+    MemoryStream ms;
+    FBuildOptions options;
+    options.m_ConfigFile = bffFile;
+    FBuild fBuild( options );
+    if ( fBuild.Initialize() == false )
+    {
+        Fail( "Initialize failed" );
+        return;
+    }
+    fBuild.SaveDependencyGraph( ms, "bench.fdb" );
+
+    ConstMemoryStream cms( ms.GetData(), ms.GetFileSize() );
+    NodeGraph ng;
+    BenchmarkTimer timer( ms.GetFileSize(), "bytes" );
+    if ( ng.Load( cms, "bench.fdb" ) != NodeGraph::LoadResult::OK )
+    {
+        Fail( "Load failed" );
+        return;
+    }
+    Consume( ng.GetNodeCount() );
+}
+
+// GenerateBFF
+//  - A configuration similar to that of a large project: shared settings via
+//    structs and Using, many ObjectLists and Aliases, and loops
+//------------------------------------------------------------------------------
+/*static*/ void BenchBFF::GenerateBFF( uint32_t numModules, AString & outBFF )
+{
+    AStackString<> compiler;
+    Env::GetExePath( compiler );
+    AStackString<> compilerOptions;
+    FakeCompiler::GetCompilerOptions( 0, compilerOptions );
+
+    outBFF.Format( "Compiler( 'FakeCompiler' )\n"
+                   "{\n"
+                   "    .Executable = '%s'\n"
+                   "    .CompilerFamily = 'custom'\n"
+                   "}\n"
+                   ".BaseConfig =\n"
+                   "[\n"
+                   "    .Compiler = 'FakeCompiler'\n"
+                   "    .CompilerOptions = '%s'\n"
+                   "    .Defines = ' -DBENCHMARK -DNDEBUG'\n"
+                   "]\n"
+                   ".ModuleNames = {}\n",
+                   compiler.Get(),
+                   compilerOptions.Get() );
+
+    for ( uint32_t i = 0; i < numModules; ++i )
+    {
+        outBFF.AppendFormat( ".Module%u =\n"
+                             "[\n"
+                             "    Using( .BaseConfig )\n"
+                             "    .ModuleName = 'Module%u'\n"
+                             "    .CompilerOptions + .Defines + ' -DMODULE%u'\n"
+                             "    .CompilerInputFiles = { 'src/Module%u/A.cpp', 'src/Module%u/B.cpp', 'src/Module%u/C.cpp', 'src/Module%u/D.cpp' }\n"
+                             "    .CompilerOutputPath = 'out/Module%u/'\n"
+                             "]\n"
+                             "ObjectList( 'Module%u-Objs' )\n"
+                             "{\n"
+                             "    Using( .Module%u )\n"
+                             "}\n"
+                             ".ModuleNames + 'Module%u'\n",
+                             i, i, i, i, i, i, i, i, i, i, i );
+    }
+
+    outBFF += "ForEach( .ModuleName in .ModuleNames )\n"
+              "{\n"
+              "    Alias( '$ModuleName$' ) { .Targets = { '$ModuleName$-Objs' } }\n"
+              "}\n"
+              "Alias( 'all' ) { .Targets = .ModuleNames }\n";
+}
+
+// GetBFF
+//------------------------------------------------------------------------------
+/*static*/ void BenchBFF::GetBFF( AString & outBFFFile, AString & outBFF )
+{
+    GenerateBFF( Scale( 5000, 500 ), outBFF );
+
+    // Written to disk so the graph can be loaded and saved
+    GetTempDir( "BFF", outBFFFile );
+    outBFFFile += "fbuild.bff";
+    WriteFile( outBFFFile, outBFF );
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,492 @@
+// BenchBuild.cpp - End-to-end builds using the fake compiler
+//------------------------------------------------------------------------------
+
+// Includes
+//------------------------------------------------------------------------------
+#include "Tools/FBuild/FBuildBench/Benchmark.h"
+#include "Tools/FBuild/FBuildBench/FakeCompiler.h"
+
+// FBuildCore
+#include "Tools/FBuild/FBuildCore/Cache/LightCache.h"
+#include "Tools/FBuild/FBuildCore/FBuild.h"
+#include "Tools/FBuild/FBuildCore/FBuildOptions.h"
+#include "Tools/FBuild/FBuildCore/Graph/NodeGraph.h"
+#include "Tools/FBuild/FBuildCore/Graph/ObjectNode.h"
+
+// Core
+#include "Core/Env/Env.h"
+#include "Core/FileIO/FileIO.h"
+#include "Core/Math/Random.h"
+#include "Core/Strings/AStackString.h"
+#include "Core/Strings/AString.h"
+
+// FBuildForBench
+//  - Access to internals for benchmarking
+//------------------------------------------------------------------------------
+class FBuildForBench : public FBuild
+{
+public:
+    explicit FBuildForBench( const FBuildOptions & options )
+        : FBuild( options ) {}
+
+    NodeGraph & GetGraph() const { return *m_DependencyGraph; }
+};
+
+// BenchBuild
+//------------------------------------------------------------------------------
+class BenchBuild : public Benchmark
+{
+public:
+    BenchBuild();
+
+private:
+    DECLARE_BENCHMARKS
+
+    void FakeCompilerCleanBuild() const;
+    void UpToDateBuild() const;
+    void JobQueueThroughput() const;
+    void LightCacheHash() const;
+    void LibraryFullRebuild() const;
+    void LibraryUpdateInPlace() const;
+    void LibrarySharded() const;
+
+    // Helpers
+    enum LibraryMode : uint32_t
+    {
+        LIBRARY_FULL,
+        LIBRARY_UPDATE_IN_PLACE,
+        LIBRARY_SHARDED,
+
+        NUM_LIBRARY_MODES
+    };
+    void LibraryIncremental( LibraryMode mode ) const;
+    static void GenerateObjectsProject( const char * name,
+                                        uint32_t numFiles,
+                                        const char * extraSettings,
+                                        AString & outBFFFile );
+    static void GenerateSource( const AString & fileName, uint32_t version, const char * includes = "" );
+    static void GetOptions( const AString & bffFile, bool clean, FBuildOptions & outOptions );
+    static void GetDBFile( const AString & bffFile, AString & outDBFile );
+    static bool CleanBuild( const AString & bffFile );
+
+    mutable bool        m_UpToDateReady;
+    mutable bool        m_LibraryReady[ NUM_LIBRARY_MODES ];
+    mutable uint32_t    m_LibraryVersion;
+};
+
+// Register Benchmarks
+//------------------------------------------------------------------------------
+REGISTER_BENCHMARKS_BEGIN( BenchBuild )
+    REGISTER_BENCHMARK( FakeCompilerCleanBuild )
+    REGISTER_BENCHMARK( UpToDateBuild )
+    REGISTER_BENCHMARK( JobQueueThroughput )
+    REGISTER_BENCHMARK( LightCacheHash )
+    REGISTER_BENCHMARK( LibraryFullRebuild )
+    REGISTER_BENCHMARK( LibraryUpdateInPlace )
+    REGISTER_BENCHMARK( LibrarySharded )
+REGISTER_BENCHMARKS_END
+
+// CONSTRUCTOR
+//------------------------------------------------------------------------------
+BenchBuild::BenchBuild()
+    : m_UpToDateReady( false )
+    , m_LibraryVersion( 0 )
+{
+    for ( bool & ready : m_LibraryReady )
+    {
+        ready = false;
+    }
+}
+
+// FakeCompilerCleanBuild
+//  - Scheduling of many short jobs which spawn processes
+//------------------------------------------------------------------------------
+void BenchBuild::FakeCompilerCleanBuild() const
+{
+    const uint32_t numFiles = Scale( 2000, 200 );
+    AStackString<> bffFile;
+    GenerateObjectsProject( "CleanBuild", numFiles, "", bffFile );
+
+    FBuildOptions options;
+    GetOptions( bffFile, true, options );
+    FBuild fBuild( options );
+    if ( fBuild.Initialize() == false )
+    {
+        Fail( "Initialize failed" );
+        return;
+    }
+
+    BenchmarkTimer timer( numFiles, "jobs" );
+    if ( fBuild.Build( "all" ) == false )
+    {
+        Fail( "Build failed" );
+    }
+}
+
+// UpToDateBuild
+//  - Build passes over a graph where everything is up-to-date
+//------------------------------------------------------------------------------
+void BenchBuild::UpToDateBuild() const
+{
+    const uint32_t numFiles = Scale( 10000, 1000 );
+    AStackString<> bffFile;
+    if ( m_UpToDateReady == false )
+    {
+        GenerateObjectsProject( "UpToDate", numFiles, "", bffFile );
+        if ( CleanBuild( bffFile ) == false )
+        {
+            Fail( "Initial build failed" );
+            return;
+        }
+        m_UpToDateReady = true;
+    }
+    else
+    {
+        GetTempDir( "UpToDate", bffFile );
+        bffFile += "fbuild.bff";
+    }
+
+    AStackString<> dbFile;
+    GetDBFile( bffFile, dbFile );
+    FBuildOptions options;
+    GetOptions( bffFile, false, options );
+    FBuild fBuild( options );
+    if ( fBuild.Initialize( dbFile.Get() ) == false )
+    {
+        Fail( "Initialize failed" );
+        return;
+    }
+
+    BenchmarkTimer timer( numFiles, "objects" );
+    if ( fBuild.Build( "all" ) == false )
+    {
+        Fail( "Build failed" );
+    }
+}
+
+// JobQueueThroughput
+//  - Many small jobs which don't spawn processes
+//------------------------------------------------------------------------------
+void BenchBuild::JobQueueThroughput() const
+{
+    const uint32_t numNodes = Scale( 20000, 2000 );
+
+    AStackString<> dir;
+    GetTempDir( "JobQueue", dir );
+    AString bff( numNodes * 128 );
+    for ( uint32_t i = 0; i < numNodes; ++i )
+    {
+        bff.AppendFormat( "TextFile( 'Text%u' ) { .TextFileOutput = '%sout/Text%u.txt' .TextFileInputStrings = { 'Text%u' } }\n", i, dir.Get(), i, i );
+    }
+    bff += "Alias( 'all' )\n{\n    .Targets = {}\n";
+    for ( uint32_t i = 0; i < numNodes; ++i )
+    {
+        bff.AppendFormat( "    .Targets + 'Text%u'\n", i );
+    }
+    bff += "}\n";
+    AStackString<> bffFile( dir );
+    bffFile += "fbuild.bff";
+    WriteFile( bffFile, bff );
+
+    FBuildOptions options;
+    GetOptions( bffFile, true, options );
+    FBuild fBuild( options );
+    if ( fBuild.Initialize() == false )
+    {
+        Fail( "Initialize failed" );
+        return;
+    }
+
+    BenchmarkTimer timer( numNodes, "jobs" );
+    if ( fBuild.Build( "all" ) == false )
+    {
+        Fail( "Build failed" );
+    }
+}
+
+// LightCacheHash
+//  - Hashing of objects with many shared includes (with an empty file cache)
+//------------------------------------------------------------------------------
+void BenchBuild::LightCacheHash() const
+{
+    const uint32_t numFiles = Scale( 2000, 200 );
+    const uint32_t numHeaders = Scale( 500, 50 );
+    const uint32_t includesPerFile = 20;
+
+    AStackString<> dir;
+    GetTempDir( "LightCache", dir );
+
+    // headers include other headers
+    Random r( 1234 );
+    for ( uint32_t i = 0; i < numHeaders; ++i )
+    {
+        AString header;
+        header.Format( "#pragma once\n" );
+        for ( uint32_t j = 0; j < 2; ++j )
+        {
+            if ( i > 0 )
+            {
+                header.AppendFormat( "#include \"Header%u.h\"\n", r.GetRandIndex( i ) );
+            }
+        }
+        header.AppendFormat( "inline int Header%u() { return %u; }\n", i, i );
+        AStackString<> fileName;
+        fileName.Format( "%sinclude/Header%u.h", dir.Get(), i );
+        WriteFile( fileName, header );
+    }
+
+    // sources include headers
+    AStackString<> bffFile;
+    GenerateObjectsProject( "LightCache", 0, "", bffFile );
+    for ( uint32_t i = 0; i < numFiles; ++i )
+    {
+        AString includes;
+        for ( uint32_t j = 0; j < includesPerFile; ++j )
+        {
+            includes.AppendFormat( "#include \"Header%u.h\"\n", r.GetRandIndex( numHeaders ) );
+        }
+        AStackString<> fileName;
+        fileName.Format( "%ssrc/File%u.cpp", dir.Get(), i );
+        GenerateSource( fileName, 0, includes.Get() );
+    }
+
+    // build to create object nodes
+    FBuildOptions options;
+    GetOptions( bffFile, true, options );
+    FBuildForBench fBuild( options );
+    if ( ( fBuild.Initialize() == false ) || ( fBuild.Build( "all" ) == false ) )
+    {
+        Fail( "Initial build failed" );
+        return;
+    }
+
+    Array< ObjectNode * > objects( numFiles, false );
+    const NodeGraph & ng = fBuild.GetGraph();
+    for ( size_t i = 0; i < ng.GetNodeCount(); ++i )
+    {
+        Node * node = ng.GetNodeByIndex( i );
+        if ( node->GetType() == Node::OBJECT_NODE )
+        {
+            objects.Append( node->CastTo< ObjectNode >() );
+        }
+    }
+    if ( objects.GetSize() != numFiles )
+    {
+        Fail( "Unexpected number of objects" );
+        return;
+    }
+
+    AStackString<> args;
+    args.Format( "-I\"%sinclude\"", dir.Get() );
+    LightCache::ClearCachedFiles();
+
+    BenchmarkTimer timer( numFiles, "objects" );
+    for ( ObjectNode * object : objects )
+    {
+        LightCache lc;
+        uint64_t hash = 0;
+        Array< AString > includes;
+        if ( lc.Hash( object, args, hash, includes ) == false )
+        {
+            Fail( "Hash failed" );
+            return;
+        }
+        Consume( hash );
+    }
+}
+
+// LibraryFullRebuild
+//------------------------------------------------------------------------------
+void BenchBuild::LibraryFullRebuild() const
+{
+    LibraryIncremental( LIBRARY_FULL );
+}
+
+// LibraryUpdateInPlace
+//------------------------------------------------------------------------------
+void BenchBuild::LibraryUpdateInPlace() const
+{
+    LibraryIncremental( LIBRARY_UPDATE_IN_PLACE );
+}
+
+// LibrarySharded
+//------------------------------------------------------------------------------
+void BenchBuild::LibrarySharded() const
+{
+    LibraryIncremental( LIBRARY_SHARDED );
+}
+
+// LibraryIncremental
+//  - A library with many objects, a few of which are modified
+//------------------------------------------------------------------------------
+void BenchBuild::LibraryIncremental( LibraryMode mode ) const
+{
+    // In-place and sharded builds are only supported for ar
+    #if defined( __WINDOWS__ )
+        const char * librarian = nullptr;
+    #else
+        const char * librarian = "/usr/bin/ar";
+    #endif
+    if ( ( librarian == nullptr ) || ( FileIO::FileExists( librarian ) == false ) )
+    {
+        return; // skip
+    }
+
+    const uint32_t numFiles = Scale( 10000, 1000 );
+    const uint32_t numModifiedFiles = 10;
+
+    static const char * const names[ NUM_LIBRARY_MODES ] = { "LibraryFull", "LibraryInPlace", "LibrarySharded" };
+    static const char * const settings[ NUM_LIBRARY_MODES ] = { "", ".LibrarianUpdateInPlace = true", ".LibrarianShards = 8" };
+
+    AStackString<> dir;
+    GetTempDir( names[ mode ], dir );
+    AStackString<> bffFile( dir );
+    bffFile += "fbuild.bff";
+    if ( m_LibraryReady[ mode ] == false )
+    {
+        AStackString<> extraSettings;
+        extraSettings.Format( ".Librarian = '%s'\n"
+                              ".LibrarianOptions = 'rcs \"%%2\" \"%%1\"'\n"
+                              ".LibrarianOutput = '%sout/lib.a'\n"
+                              "%s\n",
+                              librarian, dir.Get(), settings[ mode ] );
+        GenerateObjectsProject( names[ mode ], numFiles, extraSettings.Get(), bffFile );
+        if ( CleanBuild( bffFile ) == false )
+        {
+            Fail( "Initial build failed" );
+            return;
+        }
+        m_LibraryReady[ mode ] = true;
+    }
+
+    // modify some files
+    ++m_LibraryVersion;
+    for ( uint32_t i = 0; i < numModifiedFiles; ++i )
+    {
+        AStackString<> fileName;
+        fileName.Format( "%ssrc/File%u.cpp", dir.Get(), ( ( m_LibraryVersion * numModifiedFiles ) + i ) % numFiles );
+        GenerateSource( fileName, m_LibraryVersion );
+    }
+
+    AStackString<> dbFile;
+    GetDBFile( bffFile, dbFile );
+    FBuildOptions options;
+    GetOptions( bffFile, false, options );
+    FBuild fBuild( options );
+    if ( fBuild.Initialize( dbFile.Get() ) == false )
+    {
+        Fail( "Initialize failed" );
+        return;
+    }
+    {
+        BenchmarkTimer timer;
+        if ( fBuild.Build( "all" ) == false )
+        {
+            Fail( "Build failed" );
+            return;
+        }
+    }
+    if ( fBuild.SaveDependencyGraph( dbFile.Get() ) == false )
+    {
+        Fail( "SaveDependencyGraph failed" );
+    }
+}
+
+// GenerateObjectsProject
+//  - Files are compiled with the fake compiler (into a library if extraSettings
+//    specifies a librarian)
+//------------------------------------------------------------------------------
+/*static*/ void BenchBuild::GenerateObjectsProject( const char * name,
+                                                    uint32_t numFiles,
+                                                    const char * extraSettings,
+                                                    AString & outBFFFile )
+{
+    AStackString<> dir;
+    GetTempDir( name, dir );
+
+    for ( uint32_t i = 0; i < numFiles; ++i )
+    {
+        AStackString<> fileName;
+        fileName.Format( "%ssrc/File%u.cpp", dir.Get(), i );
+        GenerateSource( fileName, 0 );
+    }
+
+    AStackString<> compiler;
+    Env::GetExePath( compiler );
+    AStackString<> compilerOptions;
+    FakeCompiler::GetCompilerOptions( 0, compilerOptions );
+
+    const bool isLibrary = ( AString::StrLen( extraSettings ) > 0 );
+    AString bff;
+    bff.Format( "Compiler( 'FakeCompiler' )\n"
+                "{\n"
+                "    .Executable = '%s'\n"
+                "    .CompilerFamily = 'custom'\n"
+                "}\n"
+                "%s( 'Objects' )\n"
+                "{\n"
+                "    .Compiler = 'FakeCompiler'\n"
+                "    .CompilerOptions = '%s'\n"
+                "    .CompilerInputPath = '%ssrc/'\n"
+                "    .CompilerOutputPath = '%sout/'\n"
+                "    %s\n"
+                "}\n"
+                "Alias( 'all' ) { .Targets = { 'Objects' } }\n",
+                compiler.Get(),
+                isLibrary ? "Library" : "ObjectList",
+                compilerOptions.Get(),
+                dir.Get(),
+                dir.Get(),
+                extraSettings );
+
+    outBFFFile = dir;
+    outBFFFile += "fbuild.bff";
+    WriteFile( outBFFFile, bff );
+}
+
+// GenerateSource
+//------------------------------------------------------------------------------
+/*static*/ void BenchBuild::GenerateSource( const AString & fileName, uint32_t version, const char * includes )
+{
+    AString source;
+    source.Format( "%s"
+                   "int Function_%u() { return %u; }\n",
+                   includes,
+                   version,
+                   version );
+    WriteFile( fileName, source );
+}
+
+// GetOptions
+//------------------------------------------------------------------------------
+/*static*/ void BenchBuild::GetOptions( const AString & bffFile, bool clean, FBuildOptions & outOptions )
+{
+    outOptions.m_ConfigFile = bffFile;
+    outOptions.m_ForceCleanBuild = clean;
+    outOptions.m_ShowCommandSummary = false;
+    outOptions.m_ShowTotalTimeTaken = false;
+}
+
+// GetDBFile
+//------------------------------------------------------------------------------
+/*static*/ void BenchBuild::GetDBFile( const AString & bffFile, AString & outDBFile )
+{
+    outDBFile = bffFile;
+    outDBFile.Replace( ".bff", ".fdb" );
+}
+
+// CleanBuild
+//------------------------------------------------------------------------------
+/*static*/ bool BenchBuild::CleanBuild( const AString & bffFile )
+{
+    AStackString<> dbFile;
+    GetDBFile( bffFile, dbFile );
+    FBuildOptions options;
+    GetOptions( bffFile, true, options );
+    FBuild fBuild( options );
+    return fBuild.Initialize( dbFile.Get() ) &&
+           fBuild.Build( "all" ) &&
+           fBuild.SaveDependencyGraph( dbFile.Get() );
+}
+
+//------------------------------------------------------------------------------
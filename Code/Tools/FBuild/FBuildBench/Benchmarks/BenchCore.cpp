@@ -0,0 +1,485 @@
+// BenchCore.cpp - Core containers, strings and hashing
+//------------------------------------------------------------------------------
+
+// Includes
+//------------------------------------------------------------------------------
+#include "Tools/FBuild/FBuildBench/Benchmark.h"
+
+// FBuildCore
+#include "Tools/FBuild/FBuildCore/Helpers/Compressor.h"
+
+// Core
+#include "Core/Containers/Array.h"
+#include "Core/FileIO/FileStream.h"
+#include "Core/FileIO/MappedFile.h"
+#include "Core/Math/CRC32.h"
+#include "Core/Math/Conversions.h"
+#include "Core/Math/Random.h"
+#include "Core/Math/xxHash.h"
+#include "Core/Mem/Mem.h"
+#include "Core/Strings/AStackString.h"
+#include "Core/Strings/AString.h"
+
+// BenchCore
+//------------------------------------------------------------------------------
+class BenchCore : public Benchmark
+{
+private:
+    DECLARE_BENCHMARKS
+
+    void AStringAppend() const;
+    void AStringFormat() const;
+    void AStringFind() const;
+    void AStringSort() const;
+    void AStringCopyShort() const;
+    void AStringLookup() const;
+    void AStringLookupHashed() const;
+    void ArrayAppend() const;
+    void ArraySort() const;
+    void xxHash32Calc() const;
+    void xxHash64Calc() const;
+    void CRC32Calc() const;
+    void CompressLZ4() const;
+    void CompressLZ4HC_Level3() const;
+    void CompressLZ4HC_Level9() const;
+    void Decompress() const;
+    void FileHashRead() const;
+    void FileHashMapped() const;
+
+    // Helpers
+    static void GenerateText( uint32_t size, AString & outText );
+    static void GenerateNames( uint32_t numNames, Array< AString > & outNames );
+    static void GenerateFiles( Array< AString > & outFileNames, uint64_t & outTotalSize );
+    static void Compress( int32_t compressionLevel );
+};
+
+// Register Benchmarks
+//------------------------------------------------------------------------------
+REGISTER_BENCHMARKS_BEGIN( BenchCore )
+    REGISTER_BENCHMARK( AStringAppend )
+    REGISTER_BENCHMARK( AStringFormat )
+    REGISTER_BENCHMARK( AStringFind )
+    REGISTER_BENCHMARK( AStringSort )
+    REGISTER_BENCHMARK( AStringCopyShort )
+    REGISTER_BENCHMARK( AStringLookup )
+    REGISTER_BENCHMARK( AStringLookupHashed )
+    REGISTER_BENCHMARK( ArrayAppend )
+    REGISTER_BENCHMARK( ArraySort )
+    REGISTER_BENCHMARK( xxHash32Calc )
+    REGISTER_BENCHMARK( xxHash64Calc )
+    REGISTER_BENCHMARK( CRC32Calc )
+    REGISTER_BENCHMARK( CompressLZ4 )
+    REGISTER_BENCHMARK( CompressLZ4HC_Level3 )
+    REGISTER_BENCHMARK( CompressLZ4HC_Level9 )
+    REGISTER_BENCHMARK( Decompress )
+    REGISTER_BENCHMARK( FileHashRead )
+    REGISTER_BENCHMARK( FileHashMapped )
+REGISTER_BENCHMARKS_END
+
+// AStringAppend
+//------------------------------------------------------------------------------
+void BenchCore::AStringAppend() const
+{
+    const uint32_t numAppends = Scale( 4 * 1000 * 1000, 100 * 1000 );
+
+    BenchmarkTimer timer( numAppends, "appends" );
+    AString string;
+    for ( uint32_t i = 0; i < numAppends; ++i )
+    {
+        string += "path/to/file.cpp ";
+    }
+    Consume( string.GetLength() );
+}
+
+// AStringFormat
+//------------------------------------------------------------------------------
+void BenchCore::AStringFormat() const
+{
+    const uint32_t numFormats = Scale( 1000 * 1000, 50 * 1000 );
+
+    BenchmarkTimer timer( numFormats, "formats" );
+    AStackString<> string;
+    for ( uint32_t i = 0; i < numFormats; ++i )
+    {
+        string.Format( "%s/%s%u.%s", "C:/Code/Project", "File", i, "obj" );
+        Consume( string.GetLength() );
+    }
+}
+
+// AStringFind
+//------------------------------------------------------------------------------
+void BenchCore::AStringFind() const
+{
+    AString text;
+    GenerateText( Scale( 64 * MEGABYTE, 4 * MEGABYTE ), text );
+
+    BenchmarkTimer timer( text.GetLength(), "bytes" );
+    const char * pos = text.Find( "#include <DoesNotExist.h>" ); // never found, so whole string is searched
+    Consume( pos ? 1 : 0 );
+}
+
+// AStringSort
+//------------------------------------------------------------------------------
+void BenchCore::AStringSort() const
+{
+    const uint32_t numStrings = Scale( 200 * 1000, 20 * 1000 );
+    Array< AString > strings( numStrings, false );
+    Random r( 1234 );
+    for ( uint32_t i = 0; i < numStrings; ++i )
+    {
+        AStackString<> string;
+        string.Format( "C:/Code/Project/Module%u/Private/File%u.cpp", r.GetRandIndex( 100 ), r.GetRand() );
+        strings.Append( string );
+    }
+
+    BenchmarkTimer timer( numStrings, "strings" );
+    strings.Sort();
+    Consume( strings[ 0 ].GetLength() );
+}
+
+// AStringCopyShort
+//  - Short strings such as file extensions
+//------------------------------------------------------------------------------
+void BenchCore::AStringCopyShort() const
+{
+    // short strings, like extensions and small numbers
+    Array< AString > names( 1000, false );
+    for ( uint32_t i = 0; i < 1000; ++i )
+    {
+        AStackString<> name;
+        name.Format( ".%u", i );
+        names.EmplaceBack( name );
+    }
+    const uint32_t numCopies = Scale( 4 * 1000 * 1000, 200 * 1000 );
+
+    BenchmarkTimer timer( numCopies, "copies" );
+    Array< AString > copies( names.GetSize(), false );
+    for ( uint32_t i = 0; i < numCopies; ++i )
+    {
+        if ( copies.GetSize() == names.GetSize() )
+        {
+            Consume( copies.Top().GetLength() );
+            copies.Clear();
+        }
+        copies.EmplaceBack( names[ copies.GetSize() ] );
+    }
+}
+
+// AStringLookup
+//  - Find names in a list by comparing strings (like BFF variable lookup)
+//------------------------------------------------------------------------------
+void BenchCore::AStringLookup() const
+{
+    Array< AString > names;
+    GenerateNames( 256, names );
+    const uint32_t numLookups = Scale( 1000 * 1000, 50 * 1000 );
+
+    BenchmarkTimer timer( numLookups, "lookups" );
+    uint32_t numFound = 0;
+    for ( uint32_t i = 0; i < numLookups; ++i )
+    {
+        const AString & name = names[ ( i * 7 ) % names.GetSize() ];
+        for ( const AString & other : names )
+        {
+            if ( other == name )
+            {
+                ++numFound;
+                break;
+            }
+        }
+    }
+    Consume( numFound );
+}
+
+// AStringLookupHashed
+//  - As AStringLookup, but checking precalculated hashes first (like BFFVariable)
+//------------------------------------------------------------------------------
+void BenchCore::AStringLookupHashed() const
+{
+    Array< AString > names;
+    GenerateNames( 256, names );
+    Array< uint32_t > hashes( names.GetSize(), false );
+    for ( const AString & name : names )
+    {
+        hashes.Append( xxHash::Calc32( name ) );
+    }
+    const uint32_t numLookups = Scale( 1000 * 1000, 50 * 1000 );
+
+    BenchmarkTimer timer( numLookups, "lookups" );
+    uint32_t numFound = 0;
+    for ( uint32_t i = 0; i < numLookups; ++i )
+    {
+        const AString & name = names[ ( i * 7 ) % names.GetSize() ];
+        const uint32_t nameHash = xxHash::Calc32( name );
+        for ( size_t j = 0; j < names.GetSize(); ++j )
+        {
+            if ( ( hashes[ j ] == nameHash ) && ( names[ j ] == name ) )
+            {
+                ++numFound;
+                break;
+            }
+        }
+    }
+    Consume( numFound );
+}
+
+// ArrayAppend
+//------------------------------------------------------------------------------
+void BenchCore::ArrayAppend() const
+{
+    const uint32_t numItems = Scale( 16 * 1000 * 1000, 1000 * 1000 );
+
+    BenchmarkTimer timer( numItems, "items" );
+    Array< uint32_t > items( 0, true );
+    for ( uint32_t i = 0; i < numItems; ++i )
+    {
+        items.Append( i );
+    }
+    Consume( items.GetSize() );
+}
+
+// ArraySort
+//------------------------------------------------------------------------------
+void BenchCore::ArraySort() const
+{
+    const uint32_t numItems = Scale( 4 * 1000 * 1000, 200 * 1000 );
+    Array< uint32_t > items( numItems, false );
+    Random r( 1234 );
+    for ( uint32_t i = 0; i < numItems; ++i )
+    {
+        items.Append( r.GetRand() );
+    }
+
+    BenchmarkTimer timer( numItems, "items" );
+    items.Sort();
+    Consume( items[ 0 ] );
+}
+
+// xxHash32Calc
+//------------------------------------------------------------------------------
+void BenchCore::xxHash32Calc() const
+{
+    AString text;
+    GenerateText( Scale( 64 * MEGABYTE, 4 * MEGABYTE ), text );
+
+    BenchmarkTimer timer( text.GetLength(), "bytes" );
+    Consume( xxHash::Calc32( text ) );
+}
+
+// xxHash64Calc
+//------------------------------------------------------------------------------
+void BenchCore::xxHash64Calc() const
+{
+    AString text;
+    GenerateText( Scale( 64 * MEGABYTE, 4 * MEGABYTE ), text );
+
+    BenchmarkTimer timer( text.GetLength(), "bytes" );
+    Consume( xxHash::Calc64( text ) );
+}
+
+// CRC32Calc
+//------------------------------------------------------------------------------
+void BenchCore::CRC32Calc() const
+{
+    AString text;
+    GenerateText( Scale( 64 * MEGABYTE, 4 * MEGABYTE ), text );
+
+    BenchmarkTimer timer( text.GetLength(), "bytes" );
+    Consume( CRC32::Calc( text ) );
+}
+
+// CompressLZ4
+//------------------------------------------------------------------------------
+void BenchCore::CompressLZ4() const
+{
+    Compress( -1 ); // default LZ4 level
+}
+
+// CompressLZ4HC_Level3
+//------------------------------------------------------------------------------
+void BenchCore::CompressLZ4HC_Level3() const
+{
+    Compress( 3 );
+}
+
+// CompressLZ4HC_Level9
+//------------------------------------------------------------------------------
+void BenchCore::CompressLZ4HC_Level9() const
+{
+    Compress( 9 );
+}
+
+// Decompress
+//------------------------------------------------------------------------------
+void BenchCore::Decompress() const
+{
+    AString text;
+    GenerateText( Scale( 64 * MEGABYTE, 4 * MEGABYTE ), text );
+    Compressor c;
+    if ( c.Compress( text.Get(), text.GetLength() ) == false )
+    {
+        Fail( "Compress failed" );
+        return;
+    }
+
+    BenchmarkTimer timer( text.GetLength(), "bytes" );
+    Compressor d;
+    if ( d.Decompress( c.GetResult() ) == false )
+    {
+        Fail( "Decompress failed" );
+        return;
+    }
+    Consume( d.GetResultSize() );
+}
+
+// FileHashRead
+//  - Read files into memory and hash them (like cache retrieval and tool manifests)
+//------------------------------------------------------------------------------
+void BenchCore::FileHashRead() const
+{
+    Array< AString > fileNames;
+    uint64_t totalSize;
+    GenerateFiles( fileNames, totalSize );
+
+    BenchmarkTimer timer( totalSize, "bytes" );
+    for ( const AString & fileName : fileNames )
+    {
+        FileStream f;
+        if ( f.Open( fileName.Get(), FileStream::READ_ONLY ) == false )
+        {
+            Fail( "Open failed" );
+            return;
+        }
+        const size_t size = (size_t)f.GetFileSize();
+        void * mem = ALLOC( size );
+        const bool ok = ( f.ReadBuffer( mem, size ) == size );
+        Consume( xxHash::Calc64( mem, size ) );
+        FREE( mem );
+        if ( ok == false )
+        {
+            Fail( "Read failed" );
+            return;
+        }
+    }
+}
+
+// FileHashMapped
+//  - As FileHashRead, but accessing the file contents via a MappedFile
+//------------------------------------------------------------------------------
+void BenchCore::FileHashMapped() const
+{
+    Array< AString > fileNames;
+    uint64_t totalSize;
+    GenerateFiles( fileNames, totalSize );
+
+    BenchmarkTimer timer( totalSize, "bytes" );
+    for ( const AString & fileName : fileNames )
+    {
+        MappedFile f;
+        if ( f.Open( fileName.Get() ) == false )
+        {
+            Fail( "Open failed" );
+            return;
+        }
+        Consume( xxHash::Calc64( f.GetData(), f.GetSize() ) );
+    }
+}
+
+// GenerateText
+//  - Approximates preprocessed source code for hashing and compression
+//------------------------------------------------------------------------------
+/*static*/ void BenchCore::GenerateText( uint32_t size, AString & outText )
+{
+    static const char * const words[] =
+    {
+        "int", "void", "const", "char", "return", "if", "else", "for", "while",
+        "class", "struct", "template", "typename", "static", "inline", "{", "}",
+        "(", ")", ";", "=", "==", "+", "->", "::", "m_Size", "m_Data", "Array",
+        "AString", "uint32_t", "Process", "#include", "<stdio.h>", "\n", "\n    "
+    };
+    const uint32_t numWords = (uint32_t)( sizeof( words ) / sizeof( words[ 0 ] ) );
+
+    // generate a block of text
+    const uint32_t blockSize = Math::Min< uint32_t >( size, MEGABYTE );
+    outText.SetReserved( size + 32 );
+    Random r( 5678 );
+    while ( outText.GetLength() < blockSize )
+    {
+        outText += words[ r.GetRandIndex( numWords ) ];
+        outText += ' ';
+    }
+    outText.SetLength( blockSize );
+
+    // and repeat it (which is much quicker, and far enough apart not to
+    // affect compression)
+    while ( outText.GetLength() < size )
+    {
+        outText.Append( outText.Get(), Math::Min< uint32_t >( blockSize, size - outText.GetLength() ) );
+    }
+}
+
+// GenerateNames
+//  - Names of similar lengths, with common prefixes, like variable names
+//------------------------------------------------------------------------------
+/*static*/ void BenchCore::GenerateNames( uint32_t numNames, Array< AString > & outNames )
+{
+    static const char * const prefixes[] = { ".Compiler", ".Lib", ".Link", ".Out", ".Src" };
+    const uint32_t numPrefixes = (uint32_t)( sizeof( prefixes ) / sizeof( prefixes[ 0 ] ) );
+
+    outNames.SetCapacity( numNames );
+    for ( uint32_t i = 0; i < numNames; ++i )
+    {
+        AStackString<> name;
+        name.Format( "%s%u", prefixes[ i % numPrefixes ], i );
+        outNames.EmplaceBack( name );
+    }
+}
+
+// Compress
+//------------------------------------------------------------------------------
+/*static*/ void BenchCore::Compress( int32_t compressionLevel )
+{
+    AString text;
+    GenerateText( Scale( 64 * MEGABYTE, 4 * MEGABYTE ), text );
+
+    BenchmarkTimer timer( text.GetLength(), "bytes" );
+    Compressor c;
+    if ( c.Compress( text.Get(), text.GetLength(), compressionLevel ) == false )
+    {
+        Fail( "Compress failed" );
+        return;
+    }
+    Consume( c.GetResultSize() );
+}
+
+// GenerateFiles
+//  - A mix of file sizes, written to disk so they are resident in the file cache
+//------------------------------------------------------------------------------
+/*static*/ void BenchCore::GenerateFiles( Array< AString > & outFileNames, uint64_t & outTotalSize )
+{
+    AString text;
+    GenerateText( 4 * MEGABYTE, text );
+
+    AStackString<> path;
+    GetTempDir( "Files", path );
+
+    const uint32_t numFiles = Scale( 1000, 100 );
+    outFileNames.SetCapacity( numFiles );
+    outTotalSize = 0;
+    Random r( 1234 );
+    for ( uint32_t i = 0; i < numFiles; ++i )
+    {
+        // Mostly small files (like headers) with occasional large ones (like objects)
+        const uint32_t size = ( ( i % 10 ) == 0 ) ? ( MEGABYTE + r.GetRandIndex( MEGABYTE ) )
+                                                  : ( 1024 + r.GetRandIndex( 32 * 1024 ) );
+        const AString contents( text.Get(), text.Get() + size );
+
+        AStackString<> fileName;
+        fileName.Format( "%sfile%u.txt", path.Get(), i );
+        WriteFile( fileName, contents );
+        outFileNames.Append( fileName );
+        outTotalSize += size;
+    }
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,342 @@
+// BenchPath.cpp - Path cleaning and comparison
+//------------------------------------------------------------------------------
+
+// Includes
+//------------------------------------------------------------------------------
+#include "Tools/FBuild/FBuildBench/Benchmark.h"
+
+// FBuildCore
+#include "Tools/FBuild/FBuildCore/Graph/NodeGraph.h"
+
+// Core
+#include "Core/Containers/Array.h"
+#include "Core/FileIO/PathUtils.h"
+#include "Core/Strings/AStackString.h"
+#include "Core/Strings/AString.h"
+
+// BenchPath
+//------------------------------------------------------------------------------
+class BenchPath : public Benchmark
+{
+private:
+    DECLARE_BENCHMARKS
+
+    void CleanPath() const;
+    void CleanPathRelative() const;
+    void PathBeginsWith() const;
+    void ArePathsEqual() const;
+    void AStringBeginsWithI() const;
+    void AStringCompareI() const;
+    void AStringToLower() const;
+
+    // Helpers
+    static void GetRoot( AString & outRoot );
+    static void GenerateIncludePaths( Array< AString > & outPaths );
+    static void GenerateUncleanIncludePaths( Array< AString > & outPaths );
+};
+
+// Register Benchmarks
+//------------------------------------------------------------------------------
+REGISTER_BENCHMARKS_BEGIN( BenchPath )
+    REGISTER_BENCHMARK( CleanPath )
+    REGISTER_BENCHMARK( CleanPathRelative )
+    REGISTER_BENCHMARK( PathBeginsWith )
+    REGISTER_BENCHMARK( ArePathsEqual )
+    REGISTER_BENCHMARK( AStringBeginsWithI )
+    REGISTER_BENCHMARK( AStringCompareI )
+    REGISTER_BENCHMARK( AStringToLower )
+REGISTER_BENCHMARKS_END
+
+// Include paths from an Unreal Engine 4 build (relative to Engine/Source)
+//------------------------------------------------------------------------------
+static const char * const g_UE4IncludePaths[] =
+{
+    "Runtime/Core/Public/CoreMinimal.h",
+    "Runtime/Core/Public/CoreTypes.h",
+    "Runtime/Core/Public/HAL/Platform.h",
+    "Runtime/Core/Public/HAL/PlatformMemory.h",
+    "Runtime/Core/Public/HAL/UnrealMemory.h",
+    "Runtime/Core/Public/GenericPlatform/GenericPlatform.h",
+    "Runtime/Core/Public/GenericPlatform/GenericPlatformMemory.h",
+    "Runtime/Core/Public/Windows/WindowsPlatform.h",
+    "Runtime/Core/Public/Windows/WindowsPlatformCompilerSetup.h",
+    "Runtime/Core/Public/Misc/AssertionMacros.h",
+    "Runtime/Core/Public/Misc/CoreMiscDefines.h",
+    "Runtime/Core/Public/Containers/Array.h",
+    "Runtime/Core/Public/Containers/ContainerAllocationPolicies.h",
+    "Runtime/Core/Public/Containers/UnrealString.h",
+    "Runtime/Core/Public/Containers/Map.h",
+    "Runtime/Core/Public/Templates/UnrealTemplate.h",
+    "Runtime/Core/Public/Templates/IsPODType.h",
+    "Runtime/Core/Public/Math/UnrealMathUtility.h",
+    "Runtime/Core/Public/Math/Vector.h",
+    "Runtime/Core/Public/Math/UnrealMathSSE.h",
+    "Runtime/Core/Public/Delegates/Delegate.h",
+    "Runtime/Core/Public/UObject/NameTypes.h",
+    "Runtime/CoreUObject/Public/UObject/Object.h",
+    "Runtime/CoreUObject/Public/UObject/ObjectMacros.h",
+    "Runtime/CoreUObject/Public/UObject/UObjectBaseUtility.h",
+    "Runtime/CoreUObject/Public/UObject/Class.h",
+    "Runtime/Engine/Classes/Engine/EngineTypes.h",
+    "Runtime/Engine/Classes/Engine/World.h",
+    "Runtime/Engine/Classes/GameFramework/Actor.h",
+    "Runtime/Engine/Classes/GameFramework/Pawn.h",
+    "Runtime/Engine/Classes/Components/ActorComponent.h",
+    "Runtime/Engine/Classes/Components/SceneComponent.h",
+    "Runtime/Engine/Public/EngineGlobals.h",
+    "Runtime/Engine/Public/SceneTypes.h",
+    "Runtime/RenderCore/Public/RenderResource.h",
+    "Runtime/RenderCore/Public/RenderingThread.h",
+    "Runtime/RHI/Public/RHI.h",
+    "Runtime/RHI/Public/RHIDefinitions.h",
+    "Runtime/SlateCore/Public/Widgets/SWidget.h",
+    "Runtime/Slate/Public/Widgets/Input/SButton.h",
+};
+static const uint32_t g_NumUE4IncludePaths = (uint32_t)( sizeof( g_UE4IncludePaths ) / sizeof( g_UE4IncludePaths[ 0 ] ) );
+
+// CleanPath
+//  - Paths as they appear in BFF files and compiler output
+//------------------------------------------------------------------------------
+void BenchPath::CleanPath() const
+{
+    Array< AString > paths;
+    GenerateUncleanIncludePaths( paths );
+    const uint32_t numIterations = Scale( 2000, 100 );
+
+    BenchmarkTimer timer( (uint64_t)numIterations * paths.GetSize(), "paths" );
+    AStackString<> cleanPath;
+    for ( uint32_t i = 0; i < numIterations; ++i )
+    {
+        for ( const AString & path : paths )
+        {
+            NodeGraph::CleanPath( path, cleanPath, false );
+            Consume( cleanPath.GetLength() );
+        }
+    }
+}
+
+// CleanPathRelative
+//  - Relative paths with the wrong slashes (like those in BFF files)
+//------------------------------------------------------------------------------
+void BenchPath::CleanPathRelative() const
+{
+    Array< AString > paths( g_NumUE4IncludePaths, false );
+    for ( uint32_t i = 0; i < g_NumUE4IncludePaths; ++i )
+    {
+        AStackString<> path( "../../Source/" );
+        path += g_UE4IncludePaths[ i ];
+        path.Replace( '/', OTHER_SLASH );
+        paths.Append( path );
+    }
+    const uint32_t numIterations = Scale( 20000, 1000 );
+
+    BenchmarkTimer timer( (uint64_t)numIterations * paths.GetSize(), "paths" );
+    AStackString<> cleanPath;
+    for ( uint32_t i = 0; i < numIterations; ++i )
+    {
+        for ( const AString & path : paths )
+        {
+            NodeGraph::CleanPath( path, cleanPath, false );
+            Consume( cleanPath.GetLength() );
+        }
+    }
+}
+
+// PathBeginsWith
+//  - Check paths against folders (like excluded paths and system includes)
+//------------------------------------------------------------------------------
+void BenchPath::PathBeginsWith() const
+{
+    Array< AString > paths;
+    GenerateIncludePaths( paths );
+
+    AStackString<> root;
+    GetRoot( root );
+    const char * const subFolders[] = { "Runtime/Core/Private/", "Runtime/Engine/Classes/", "ThirdParty/", "Runtime/Slate/" };
+    Array< AString > folders( 4, false );
+    for ( const char * subFolder : subFolders )
+    {
+        AStackString<> folder( root );
+        folder += subFolder;
+        folder.Replace( '/', NATIVE_SLASH );
+        folders.Append( folder );
+    }
+    const uint32_t numIterations = Scale( 5000, 250 );
+
+    BenchmarkTimer timer( (uint64_t)numIterations * paths.GetSize() * folders.GetSize(), "checks" );
+    uint32_t numMatches = 0;
+    for ( uint32_t i = 0; i < numIterations; ++i )
+    {
+        for ( const AString & path : paths )
+        {
+            for ( const AString & folder : folders )
+            {
+                numMatches += PathUtils::PathBeginsWith( path, folder ) ? 1 : 0;
+            }
+        }
+    }
+    Consume( numMatches );
+}
+
+// ArePathsEqual
+//  - Compare paths which mostly share a long common prefix
+//------------------------------------------------------------------------------
+void BenchPath::ArePathsEqual() const
+{
+    Array< AString > paths;
+    GenerateIncludePaths( paths );
+    const uint32_t numIterations = Scale( 500, 25 );
+
+    BenchmarkTimer timer( (uint64_t)numIterations * paths.GetSize() * paths.GetSize(), "compares" );
+    uint32_t numEqual = 0;
+    for ( uint32_t i = 0; i < numIterations; ++i )
+    {
+        for ( const AString & a : paths )
+        {
+            for ( const AString & b : paths )
+            {
+                numEqual += PathUtils::ArePathsEqual( a, b ) ? 1 : 0;
+            }
+        }
+    }
+    Consume( numEqual );
+}
+
+// AStringBeginsWithI
+//  - Case insensitive prefix checks (as used for paths on Windows and OSX)
+//------------------------------------------------------------------------------
+void BenchPath::AStringBeginsWithI() const
+{
+    Array< AString > paths;
+    GenerateIncludePaths( paths );
+
+    AStackString<> folder;
+    GetRoot( folder );
+    folder.AppendFormat( "RUNTIME%cCORE%cPUBLIC%c", NATIVE_SLASH, NATIVE_SLASH, NATIVE_SLASH );
+    const uint32_t numIterations = Scale( 20000, 1000 );
+
+    BenchmarkTimer timer( (uint64_t)numIterations * paths.GetSize(), "checks" );
+    uint32_t numMatches = 0;
+    for ( uint32_t i = 0; i < numIterations; ++i )
+    {
+        for ( const AString & path : paths )
+        {
+            numMatches += path.BeginsWithI( folder ) ? 1 : 0;
+        }
+    }
+    Consume( numMatches );
+}
+
+// AStringCompareI
+//  - Case insensitive comparison (as used for paths on Windows and OSX)
+//------------------------------------------------------------------------------
+void BenchPath::AStringCompareI() const
+{
+    Array< AString > paths;
+    GenerateIncludePaths( paths );
+    Array< AString > upperPaths( paths );
+    for ( AString & path : upperPaths )
+    {
+        path.ToUpper();
+    }
+    const uint32_t numIterations = Scale( 500, 25 );
+
+    BenchmarkTimer timer( (uint64_t)numIterations * paths.GetSize() * paths.GetSize(), "compares" );
+    int32_t total = 0;
+    for ( uint32_t i = 0; i < numIterations; ++i )
+    {
+        for ( const AString & a : paths )
+        {
+            for ( const AString & b : upperPaths )
+            {
+                total += ( a.CompareI( b ) < 0 ) ? 1 : 0;
+            }
+        }
+    }
+    Consume( (uint64_t)total );
+}
+
+// AStringToLower
+//------------------------------------------------------------------------------
+void BenchPath::AStringToLower() const
+{
+    Array< AString > paths;
+    GenerateIncludePaths( paths );
+    const uint32_t numIterations = Scale( 20000, 1000 );
+
+    BenchmarkTimer timer( (uint64_t)numIterations * paths.GetSize(), "paths" );
+    AStackString<> lower;
+    for ( uint32_t i = 0; i < numIterations; ++i )
+    {
+        for ( const AString & path : paths )
+        {
+            lower = path;
+            lower.ToLower();
+            Consume( lower.GetLength() );
+        }
+    }
+}
+
+// GetRoot
+//------------------------------------------------------------------------------
+/*static*/ void BenchPath::GetRoot( AString & outRoot )
+{
+    #if defined( __WINDOWS__ )
+        outRoot = "C:\\UnrealEngine\\Engine\\Source\\";
+    #else
+        outRoot = "/home/build/UnrealEngine/Engine/Source/";
+    #endif
+}
+
+// GenerateIncludePaths
+//  - Clean, full paths
+//------------------------------------------------------------------------------
+/*static*/ void BenchPath::GenerateIncludePaths( Array< AString > & outPaths )
+{
+    AStackString<> root;
+    GetRoot( root );
+
+    outPaths.SetCapacity( g_NumUE4IncludePaths );
+    for ( uint32_t i = 0; i < g_NumUE4IncludePaths; ++i )
+    {
+        AStackString<> path( root );
+        path += g_UE4IncludePaths[ i ];
+        #if defined( __WINDOWS__ )
+            path.Replace( '/', NATIVE_SLASH );
+        #endif
+        outPaths.Append( path );
+    }
+}
+
+// GenerateUncleanIncludePaths
+//  - Full paths needing cleaning: wrong slashes and relative path components
+//    (as reported by compilers for headers found via "..\..\" include paths)
+//------------------------------------------------------------------------------
+/*static*/ void BenchPath::GenerateUncleanIncludePaths( Array< AString > & outPaths )
+{
+    Array< AString > paths;
+    GenerateIncludePaths( paths );
+
+    outPaths.SetCapacity( paths.GetSize() * 3 );
+    for ( const AString & path : paths )
+    {
+        // Already clean
+        outPaths.Append( path );
+
+        // Wrong slashes
+        AStackString<> otherSlashes( path );
+        otherSlashes.Replace( NATIVE_SLASH, OTHER_SLASH );
+        outPaths.Append( otherSlashes );
+
+        // Relative components
+        AStackString<> relative( path );
+        relative.Replace( "Public", "Private/.././Public", 1 );
+        relative.Replace( "Classes", "Private/.././Classes", 1 );
+        #if defined( __WINDOWS__ )
+            relative.Replace( '/', NATIVE_SLASH );
+        #endif
+        outPaths.Append( relative );
+    }
+}
+
+//------------------------------------------------------------------------------
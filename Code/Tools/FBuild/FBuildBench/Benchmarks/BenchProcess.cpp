@@ -0,0 +1,119 @@
+// BenchProcess.cpp - Spawning child processes (compilers, linkers etc)
+//------------------------------------------------------------------------------
+
+// Includes
+//------------------------------------------------------------------------------
+#include "Tools/FBuild/FBuildBench/Benchmark.h"
+
+// Core
+#include "Core/Mem/Mem.h"
+#include "Core/Process/Process.h"
+#include "Core/Strings/AString.h"
+
+// system
+#include <string.h> // for memset
+
+// BenchProcess
+//------------------------------------------------------------------------------
+class BenchProcess : public Benchmark
+{
+private:
+    DECLARE_BENCHMARKS
+
+    void Spawn() const;
+    void SpawnFork() const;
+    void SpawnLargeRSS() const;
+    void SpawnForkLargeRSS() const;
+
+    // Helpers
+    static void Spawn( bool useFork, bool largeRSS );
+};
+
+// Register Benchmarks
+//------------------------------------------------------------------------------
+REGISTER_BENCHMARKS_BEGIN( BenchProcess )
+    REGISTER_BENCHMARK( Spawn )
+    REGISTER_BENCHMARK( SpawnFork )
+    REGISTER_BENCHMARK( SpawnLargeRSS )
+    REGISTER_BENCHMARK( SpawnForkLargeRSS )
+REGISTER_BENCHMARKS_END
+
+// Spawn
+//  - posix_spawn
+//------------------------------------------------------------------------------
+void BenchProcess::Spawn() const
+{
+    Spawn( false, false );
+}
+
+// SpawnFork
+//  - fork/exec
+//------------------------------------------------------------------------------
+void BenchProcess::SpawnFork() const
+{
+    Spawn( true, false );
+}
+
+// SpawnLargeRSS
+//  - As Spawn, with lots of memory in use (like a large build)
+//------------------------------------------------------------------------------
+void BenchProcess::SpawnLargeRSS() const
+{
+    Spawn( false, true );
+}
+
+// SpawnForkLargeRSS
+//  - As SpawnFork, with lots of memory in use (fork cost grows with this)
+//------------------------------------------------------------------------------
+void BenchProcess::SpawnForkLargeRSS() const
+{
+    Spawn( true, true );
+}
+
+// Spawn
+//------------------------------------------------------------------------------
+/*static*/ void BenchProcess::Spawn( bool useFork, bool largeRSS )
+{
+    #if defined( __LINUX__ ) || defined( __APPLE__ )
+        const uint32_t numSpawns = Scale( 100, 20 );
+
+        // touch the memory so pages are mapped
+        const size_t size = largeRSS ? ( (size_t)Scale( 1024, 256 ) * MEGABYTE ) : 0;
+        char * mem = size ? (char *)ALLOC( size ) : nullptr;
+        if ( mem )
+        {
+            memset( mem, 1, size );
+        }
+
+        {
+            BenchmarkTimer timer( numSpawns, "spawns" );
+            for ( uint32_t i = 0; i < numSpawns; ++i )
+            {
+                Process p;
+                if ( useFork )
+                {
+                    p.SetUseFork();
+                }
+                if ( p.Spawn( "/bin/sh", "-c true", nullptr, nullptr ) == false )
+                {
+                    Fail( "Spawn failed" );
+                    break;
+                }
+                AString out;
+                AString err;
+                if ( ( p.ReadAllData( out, err ) == false ) || ( p.WaitForExit() != 0 ) )
+                {
+                    Fail( "Process failed" );
+                    break;
+                }
+            }
+        }
+
+        FREE( mem );
+    #else
+        (void)useFork;
+        (void)largeRSS; // not supported (skip benchmark)
+    #endif
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,125 @@
+// FakeCompiler.cpp
+//------------------------------------------------------------------------------
+
+// Includes
+//------------------------------------------------------------------------------
+#include "FakeCompiler.h"
+
+// Core
+#include "Core/FileIO/FileStream.h"
+#include "Core/Process/Thread.h"
+#include "Core/Strings/AString.h"
+
+// system
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Defines
+//------------------------------------------------------------------------------
+#define FAKE_COMPILER_ARG "-fakecompiler"
+#define FAKE_OBJECT_PADDING ( 4 * 1024 ) // approximate size of a small object file
+#define FAKE_DIRECTIVE "// fakecompiler:"
+
+// IsFakeCompilerArg
+//------------------------------------------------------------------------------
+/*static*/ bool FakeCompiler::IsFakeCompilerArg( const char * arg )
+{
+    return ( strcmp( arg, FAKE_COMPILER_ARG ) == 0 );
+}
+
+// Main
+//------------------------------------------------------------------------------
+/*static*/ int FakeCompiler::Main( int argc, char * argv[] )
+{
+    if ( argc != 5 )
+    {
+        fprintf( stderr, "Usage: FBuildBench %s <durationMS> <input> <output>\n", FAKE_COMPILER_ARG );
+        return 1;
+    }
+    uint32_t durationMS = (uint32_t)atoi( argv[ 2 ] );
+    const char * input = argv[ 3 ];
+    const char * output = argv[ 4 ];
+
+    // read input
+    AString contents;
+    {
+        FileStream f;
+        if ( f.Open( input, FileStream::READ_ONLY ) == false )
+        {
+            fprintf( stderr, "%s: error: cannot open '%s'\n", FAKE_COMPILER_ARG, input );
+            return 1;
+        }
+        contents.SetLength( (uint32_t)f.GetFileSize() );
+        if ( f.ReadBuffer( contents.Get(), contents.GetLength() ) != contents.GetLength() )
+        {
+            fprintf( stderr, "%s: error: cannot read '%s'\n", FAKE_COMPILER_ARG, input );
+            return 1;
+        }
+    }
+
+    // sources can override the duration and specify the output size
+    const uint32_t inputSize = contents.GetLength();
+    uint32_t outputSize = ( inputSize + FAKE_OBJECT_PADDING );
+    ParseDirective( contents, durationMS, outputSize );
+
+    // simulate compilation
+    if ( durationMS > 0 )
+    {
+        Thread::Sleep( durationMS );
+    }
+
+    // write "object" - output depends on input so changes propagate
+    contents.SetLength( outputSize );
+    if ( outputSize > inputSize )
+    {
+        memset( contents.Get() + inputSize, 'x', outputSize - inputSize );
+    }
+    FileStream f;
+    if ( ( f.Open( output, FileStream::WRITE_ONLY ) == false ) ||
+         ( f.WriteBuffer( contents.Get(), contents.GetLength() ) != contents.GetLength() ) )
+    {
+        fprintf( stderr, "%s: error: cannot write '%s'\n", FAKE_COMPILER_ARG, output );
+        return 1;
+    }
+
+    return 0;
+}
+
+// GetDirective
+//------------------------------------------------------------------------------
+/*static*/ void FakeCompiler::GetDirective( uint32_t durationMS, uint32_t outputSize, AString & outDirective )
+{
+    outDirective.Format( "%s time=%u output=%u\n", FAKE_DIRECTIVE, durationMS, outputSize );
+}
+
+// ParseDirective
+//------------------------------------------------------------------------------
+/*static*/ void FakeCompiler::ParseDirective( const AString & contents, uint32_t & inoutDurationMS, uint32_t & inoutOutputSize )
+{
+    if ( contents.BeginsWith( FAKE_DIRECTIVE ) == false )
+    {
+        return;
+    }
+
+    const char * timePos = strstr( contents.Get(), "time=" );
+    const char * outputPos = strstr( contents.Get(), "output=" );
+    const char * lineEnd = contents.Find( '\n' );
+    if ( timePos && ( ( lineEnd == nullptr ) || ( timePos < lineEnd ) ) )
+    {
+        inoutDurationMS = (uint32_t)atoi( timePos + 5 );
+    }
+    if ( outputPos && ( ( lineEnd == nullptr ) || ( outputPos < lineEnd ) ) )
+    {
+        inoutOutputSize = (uint32_t)atoi( outputPos + 7 );
+    }
+}
+
+// GetCompilerOptions
+//------------------------------------------------------------------------------
+/*static*/ void FakeCompiler::GetCompilerOptions( uint32_t durationMS, AString & outOptions )
+{
+    outOptions.Format( "%s %u \"%%1\" \"%%2\"", FAKE_COMPILER_ARG, durationMS );
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,38 @@
+// FakeCompiler - Stand-in for a compiler in end-to-end benchmarks
+//------------------------------------------------------------------------------
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+#include "Core/Env/Types.h"
+
+// Forward Declarations
+//------------------------------------------------------------------------------
+class AString;
+
+// FakeCompiler
+//  - FBuildBench is used as the compiler, invoked with:
+//      FBuildBench -fakecompiler <durationMS> <input> <output>
+//  - The input is read, the output is written (so objects can be consumed
+//    by librarians) and the process waits for the simulated compile time
+//  - A directive on the first line of the input overrides the duration and
+//    sets the output size, so each file can behave differently
+//  - Allows scheduling to be measured without a real toolchain
+//------------------------------------------------------------------------------
+class FakeCompiler
+{
+public:
+    static bool IsFakeCompilerArg( const char * arg );
+    static int Main( int argc, char * argv[] );
+
+    // Options for a Compiler() definition using the fake compiler
+    static void GetCompilerOptions( uint32_t durationMS, AString & outOptions );
+
+    // First line of a source to control how it is "compiled"
+    static void GetDirective( uint32_t durationMS, uint32_t outputSize, AString & outDirective );
+
+private:
+    static void ParseDirective( const AString & contents, uint32_t & inoutDurationMS, uint32_t & inoutOutputSize );
+};
+
+//------------------------------------------------------------------------------
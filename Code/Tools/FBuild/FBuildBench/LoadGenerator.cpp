@@ -0,0 +1,591 @@
+// LoadGenerator.cpp
+//------------------------------------------------------------------------------
+
+// Includes
+//------------------------------------------------------------------------------
+#include "LoadGenerator.h"
+#include "FakeCompiler.h"
+
+// FBuildCore
+#include "Tools/FBuild/FBuildCore/FBuild.h"
+#include "Tools/FBuild/FBuildCore/FBuildOptions.h"
+#include "Tools/FBuild/FBuildCore/Helpers/FBuildStats.h"
+#include "Tools/FBuild/FBuildCore/Protocol/Protocol.h"
+
+// Core
+#include "Core/Env/Env.h"
+#include "Core/FileIO/FileIO.h"
+#include "Core/FileIO/FileStream.h"
+#include "Core/FileIO/PathUtils.h"
+#include "Core/Math/Conversions.h"
+#include "Core/Network/TCPConnectionPool.h"
+#include "Core/Process/Atomic.h"
+#include "Core/Process/Process.h"
+#include "Core/Strings/AStackString.h"
+#include "Core/Time/Timer.h"
+#include "Core/Tracing/Tracing.h"
+
+// system
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Defines
+//------------------------------------------------------------------------------
+#define LOAD_GENERATOR_ARG "-loadgen"
+#define DEFAULT_BASE_PORT ( Protocol::PROTOCOL_PORT + 100 ) // avoid conflicts with real workers
+#define WORKER_STARTUP_TIMEOUT_S ( 10.0f )
+
+// CONSTRUCTOR
+//------------------------------------------------------------------------------
+LoadGenerator::LoadGenerator()
+    : m_NumObjects( 2000 )
+    , m_CompileTimeMS( { 20, 500 } )
+    , m_PreprocessedSizeKiB( { 50, 2000 } )
+    , m_OutputSizeKiB( { 10, 500 } )
+    , m_NumWorkers( 4 )
+    , m_WorkerCPUs( 0 )
+    , m_BasePort( DEFAULT_BASE_PORT )
+    , m_AllowLocal( false )
+    , m_Random( 1234 )
+    , m_Workers( 0, true )
+    , m_StopWorkers( false )
+{
+    // FBuildWorker from the same directory by default
+    AStackString<> exePath;
+    Env::GetExePath( exePath );
+    const char * lastSlash = exePath.FindLast( NATIVE_SLASH );
+    if ( lastSlash )
+    {
+        m_WorkerExe.Assign( exePath.Get(), lastSlash + 1 );
+    }
+    #if defined( __WINDOWS__ )
+        m_WorkerExe += "FBuildWorker.exe";
+    #else
+        m_WorkerExe += "FBuildWorker";
+    #endif
+}
+
+// DESTRUCTOR
+//------------------------------------------------------------------------------
+LoadGenerator::~LoadGenerator()
+{
+    StopWorkers();
+}
+
+// IsLoadGeneratorArg
+//------------------------------------------------------------------------------
+/*static*/ bool LoadGenerator::IsLoadGeneratorArg( const char * arg )
+{
+    return ( strcmp( arg, LOAD_GENERATOR_ARG ) == 0 );
+}
+
+// ProcessCommandLine
+//------------------------------------------------------------------------------
+bool LoadGenerator::ProcessCommandLine( int argc, char * argv[] )
+{
+    ASSERT( ( argc > 1 ) && IsLoadGeneratorArg( argv[ 1 ] ) );
+
+    for ( int i = 2; i < argc; ++i )
+    {
+        const AStackString<> arg( argv[ i ] );
+        const char * value = ( i + 1 < argc ) ? argv[ i + 1 ] : nullptr;
+        bool ok = true;
+        if ( arg == "-allowlocal" )
+        {
+            m_AllowLocal = true;
+            continue;
+        }
+        else if ( ( arg == "-help" ) || ( arg == "-?" ) )
+        {
+            DisplayHelp();
+            return false;
+        }
+        else if ( value == nullptr )
+        {
+            ok = false;
+        }
+        else if ( arg == "-objects" )
+        {
+            m_NumObjects = (uint32_t)atoi( value );
+            ok = ( m_NumObjects > 0 );
+        }
+        else if ( arg == "-compiletime" )
+        {
+            ok = ParseRange( value, m_CompileTimeMS );
+        }
+        else if ( arg == "-preprocsize" )
+        {
+            ok = ParseRange( value, m_PreprocessedSizeKiB ) && ( m_PreprocessedSizeKiB.m_Min > 0 );
+        }
+        else if ( arg == "-outputsize" )
+        {
+            ok = ParseRange( value, m_OutputSizeKiB ) && ( m_OutputSizeKiB.m_Min > 0 );
+        }
+        else if ( arg == "-workers" )
+        {
+            m_NumWorkers = (uint32_t)atoi( value );
+            ok = ( m_NumWorkers > 0 );
+        }
+        else if ( arg == "-workercpus" )
+        {
+            m_WorkerCPUs = (uint32_t)atoi( value );
+            ok = ( m_WorkerCPUs > 0 );
+        }
+        else if ( arg == "-port" )
+        {
+            const int port = atoi( value );
+            ok = ( port > 0 ) && ( port <= 0xFFFF );
+            m_BasePort = (uint16_t)port;
+        }
+        else if ( arg == "-seed" )
+        {
+            m_Random.SetSeed( (uint32_t)atoi( value ) );
+        }
+        else if ( arg == "-workerexe" )
+        {
+            m_WorkerExe = value;
+        }
+        else if ( arg == "-json" )
+        {
+            m_JSONFile = value;
+        }
+        else
+        {
+            OUTPUT( "FBuildBench: Error: Unknown argument '%s'\n", arg.Get() );
+            DisplayHelp();
+            return false;
+        }
+
+        if ( ok == false )
+        {
+            OUTPUT( "FBuildBench: Error: Invalid value for %s '%s'\n", arg.Get(), value ? value : "" );
+            return false;
+        }
+        ++i; // consume value
+    }
+
+    if ( ( (uint32_t)m_BasePort + m_NumWorkers ) > 0xFFFF )
+    {
+        OUTPUT( "FBuildBench: Error: Too many workers for port %u\n", m_BasePort );
+        return false;
+    }
+
+    return true;
+}
+
+// Run
+//------------------------------------------------------------------------------
+bool LoadGenerator::Run()
+{
+    VERIFY( FBuild::GetTempDir( m_Dir ) );
+    m_Dir.AppendFormat( "FBuildBench%cLoadGen%c", NATIVE_SLASH, NATIVE_SLASH );
+
+    AStackString<> bffFile;
+    if ( GenerateProject( bffFile ) == false )
+    {
+        return false;
+    }
+
+    if ( FileIO::FileExists( m_WorkerExe.Get() ) == false )
+    {
+        OUTPUT( "FBuildBench: Error: Worker not found '%s' (use -workerexe)\n", m_WorkerExe.Get() );
+        return false;
+    }
+    if ( ( StartWorkers() == false ) || ( WaitForWorkers() == false ) )
+    {
+        StopWorkers();
+        return false;
+    }
+
+    const bool ok = Build( bffFile );
+    StopWorkers();
+    return ok;
+}
+
+// ParseRange
+//  - "n" or "min-max"
+//------------------------------------------------------------------------------
+/*static*/ bool LoadGenerator::ParseRange( const char * value, Range & outRange )
+{
+    char * end = nullptr;
+    const long minValue = strtol( value, &end, 10 );
+    long maxValue = minValue;
+    if ( *end == '-' )
+    {
+        maxValue = strtol( end + 1, &end, 10 );
+    }
+    if ( ( *end != 0 ) || ( minValue < 0 ) || ( maxValue < minValue ) )
+    {
+        return false;
+    }
+    outRange.m_Min = (uint32_t)minValue;
+    outRange.m_Max = (uint32_t)maxValue;
+    return true;
+}
+
+// Sample
+//------------------------------------------------------------------------------
+uint32_t LoadGenerator::Sample( const Range & range )
+{
+    if ( range.m_Max <= range.m_Min )
+    {
+        return range.m_Min;
+    }
+
+    // log-uniform (shifted by 1 to allow a minimum of 0)
+    const double logMin = log( (double)range.m_Min + 1.0 );
+    const double logMax = log( (double)range.m_Max + 1.0 );
+    const double value = exp( logMin + ( logMax - logMin ) * (double)m_Random.GetRandFloat() ) - 1.0;
+    return Math::Clamp( (uint32_t)( value + 0.5 ), range.m_Min, range.m_Max );
+}
+
+// GenerateProject
+//------------------------------------------------------------------------------
+bool LoadGenerator::GenerateProject( AString & outBFFFile )
+{
+    OUTPUT( "Generating %u objects in '%s'\n", m_NumObjects, m_Dir.Get() );
+
+    // clean up previous runs
+    AStackString<> srcDir( m_Dir );
+    srcDir += "src";
+    Array< AString > oldFiles( 0, true );
+    FileIO::GetFiles( srcDir, AStackString<>( "*" ), true, &oldFiles );
+    for ( const AString & oldFile : oldFiles )
+    {
+        FileIO::FileDelete( oldFile.Get() );
+    }
+
+    // sources: directive to control the fake compiler, padded to the
+    // preprocessed size (sources are sent to workers as they are)
+    AString source( 2 * MEGABYTE );
+    for ( uint32_t i = 0; i < m_NumObjects; ++i )
+    {
+        const uint32_t compileTimeMS = Sample( m_CompileTimeMS );
+        const uint32_t size = ( Sample( m_PreprocessedSizeKiB ) * KILOBYTE );
+        const uint32_t outputSize = ( Sample( m_OutputSizeKiB ) * KILOBYTE );
+
+        FakeCompiler::GetDirective( compileTimeMS, outputSize, source );
+        uint32_t line = 0;
+        while ( source.GetLength() < size )
+        {
+            source.AppendFormat( "inline int Function_%u_%u( int a ) { return a * %u; }\n", i, line, line ^ i );
+            ++line;
+        }
+
+        AStackString<> fileName;
+        fileName.Format( "%s%cFile%u.cpp", srcDir.Get(), NATIVE_SLASH, i );
+        if ( !FileIO::EnsurePathExistsForFile( fileName ) || !WriteFile( fileName, source ) )
+        {
+            return false;
+        }
+    }
+
+    // bff: all objects can only be built by workers (unless -allowlocal)
+    AStackString<> compiler;
+    Env::GetExePath( compiler );
+    AStackString<> compilerOptions;
+    FakeCompiler::GetCompilerOptions( 0, compilerOptions );
+
+    AString bff;
+    bff.Format( "Settings\n"
+                "{\n"
+                "    .Workers = {}\n" );
+    for ( uint32_t i = 0; i < m_NumWorkers; ++i )
+    {
+        bff.AppendFormat( "    .Workers + '127.0.0.1:%u'\n", m_BasePort + i );
+    }
+    bff.AppendFormat( "}\n"
+                      "Compiler( 'FakeCompiler' )\n"
+                      "{\n"
+                      "    .Executable = '%s'\n"
+                      "    .CompilerFamily = 'custom'\n"
+                      "    .SimpleDistributionMode = true\n"
+                      "}\n"
+                      "ObjectList( 'Objects' )\n"
+                      "{\n"
+                      "    .Compiler = 'FakeCompiler'\n"
+                      "    .CompilerOptions = '%s'\n"
+                      "    .CompilerInputPath = '%s'\n"
+                      "    .CompilerOutputPath = '%sout'\n"
+                      "}\n"
+                      "Alias( 'all' ) { .Targets = { 'Objects' } }\n",
+                      compiler.Get(),
+                      compilerOptions.Get(),
+                      srcDir.Get(),
+                      m_Dir.Get() );
+
+    outBFFFile = m_Dir;
+    outBFFFile += "fbuild.bff";
+    return WriteFile( outBFFFile, bff );
+}
+
+// StartWorkers
+//------------------------------------------------------------------------------
+bool LoadGenerator::StartWorkers()
+{
+    OUTPUT( "Starting %u workers on ports %u-%u\n", m_NumWorkers, m_BasePort, m_BasePort + m_NumWorkers - 1 );
+
+    // Environment for workers (each has its own temp dir so toolchains etc
+    // are not shared)
+    static const char * const inheritedVariables[] = { "PATH", "HOME", "TMPDIR", "TMP", "TEMP", "SystemRoot" };
+    AString inheritedEnvironment;
+    for ( const char * variable : inheritedVariables )
+    {
+        AStackString<> value;
+        if ( Env::GetEnvVariable( variable, value ) )
+        {
+            inheritedEnvironment.AppendFormat( "%s=%s", variable, value.Get() );
+            inheritedEnvironment.Append( "", 1 ); // include null terminator
+        }
+    }
+
+    AtomicStoreRelaxed( &m_StopWorkers, false );
+    m_Workers.SetSize( m_NumWorkers ); // workers are referenced by their threads, so must not move
+    for ( uint32_t i = 0; i < m_NumWorkers; ++i )
+    {
+        WorkerProcess & worker = m_Workers[ i ];
+        worker.m_Owner = this;
+        worker.m_Port = (uint16_t)( m_BasePort + i );
+        worker.m_Exited = false;
+
+        worker.m_Args.Format( "-mode=dedicated -port=%u", worker.m_Port );
+        #if !defined( __LINUX__ )
+            worker.m_Args += " -console"; // Linux is always in console mode
+        #endif
+        if ( m_WorkerCPUs > 0 )
+        {
+            worker.m_Args.AppendFormat( " -cpus=%u", m_WorkerCPUs );
+        }
+
+        worker.m_Environment.Format( "FASTBUILD_TEMP_PATH=%sWorker%u%c", m_Dir.Get(), i, NATIVE_SLASH );
+        worker.m_Environment.Append( "", 1 ); // include null terminator
+        worker.m_Environment.Append( inheritedEnvironment.Get(), inheritedEnvironment.GetLength() );
+        worker.m_Environment.Append( "", 1 ); // double null terminate
+
+        worker.m_Thread = Thread::CreateThread( WorkerThreadFunc,
+                                                "LoadGenWorker",
+                                                ( 64 * KILOBYTE ),
+                                                &worker );
+        ASSERT( worker.m_Thread != INVALID_THREAD_HANDLE );
+    }
+    return true;
+}
+
+// WaitForWorkers
+//  - Client waits several seconds before retrying failed connections, so don't
+//    start until all workers are listening
+//------------------------------------------------------------------------------
+bool LoadGenerator::WaitForWorkers() const
+{
+    TCPConnectionPool probe;
+    bool allListening = true;
+    for ( const WorkerProcess & worker : m_Workers )
+    {
+        Timer t;
+        const ConnectionInfo * ci = nullptr;
+        while ( ci == nullptr )
+        {
+            if ( AtomicLoadAcquire( &worker.m_Exited ) || ( t.GetElapsed() > WORKER_STARTUP_TIMEOUT_S ) )
+            {
+                OUTPUT( "FBuildBench: Error: Worker on port %u failed to start\n", worker.m_Port );
+                if ( AtomicLoadAcquire( &worker.m_Exited ) && ( worker.m_Output.IsEmpty() == false ) )
+                {
+                    OUTPUT( "%s\n", worker.m_Output.Get() );
+                }
+                break;
+            }
+            ci = probe.Connect( AStackString<>( "127.0.0.1" ), worker.m_Port, 100 );
+            if ( ci == nullptr )
+            {
+                Thread::Sleep( 50 );
+            }
+        }
+        if ( ci == nullptr )
+        {
+            allListening = false;
+            break;
+        }
+        probe.Disconnect( ci );
+    }
+    probe.ShutdownAllConnections();
+    return allListening;
+}
+
+// StopWorkers
+//------------------------------------------------------------------------------
+void LoadGenerator::StopWorkers()
+{
+    AtomicStoreRelaxed( &m_StopWorkers, true );
+    for ( WorkerProcess & worker : m_Workers )
+    {
+        Thread::WaitForThread( worker.m_Thread );
+        Thread::CloseHandle( worker.m_Thread );
+    }
+    m_Workers.Clear();
+}
+
+// WorkerThreadFunc
+//------------------------------------------------------------------------------
+/*static*/ uint32_t LoadGenerator::WorkerThreadFunc( void * param )
+{
+    WorkerProcess & worker = *static_cast< WorkerProcess * >( param );
+
+    // Worker runs until aborted by StopWorkers
+    Process p( nullptr, &worker.m_Owner->m_StopWorkers );
+    if ( p.Spawn( worker.m_Owner->m_WorkerExe.Get(),
+                  worker.m_Args.Get(),
+                  nullptr, // default workingDir
+                  worker.m_Environment.Get() ) == false )
+    {
+        AtomicStoreRelease( &worker.m_Exited, true );
+        return 0;
+    }
+
+    AString out;
+    AString err;
+    p.ReadAllData( out, err );
+    p.WaitForExit();
+    if ( p.HasAborted() == false )
+    {
+        worker.m_Output = out;
+        worker.m_Output += err;
+        AtomicStoreRelease( &worker.m_Exited, true );
+    }
+    return 0;
+}
+
+// Build
+//------------------------------------------------------------------------------
+bool LoadGenerator::Build( const AString & bffFile ) const
+{
+    FBuildOptions options;
+    options.m_ConfigFile = bffFile;
+    options.m_ForceCleanBuild = true;
+    options.m_AllowDistributed = true;
+    options.m_NoLocalConsumptionOfRemoteJobs = !m_AllowLocal;
+    options.m_AllowLocalRace = m_AllowLocal;
+    options.m_ShowCommandSummary = false;
+    options.m_ShowTotalTimeTaken = false;
+
+    FBuild fBuild( options );
+    if ( fBuild.Initialize() == false )
+    {
+        return false;
+    }
+
+    Timer t;
+    if ( fBuild.Build( "all" ) == false )
+    {
+        OUTPUT( "FBuildBench: Error: Build failed\n" );
+        return false;
+    }
+    const float buildTime = t.GetElapsed();
+
+    ReportResults( buildTime, fBuild.GetStats() );
+    return m_JSONFile.IsEmpty() || WriteJSON( buildTime, fBuild.GetStats() );
+}
+
+// ReportResults
+//------------------------------------------------------------------------------
+void LoadGenerator::ReportResults( float buildTime, const FBuildStats & stats ) const
+{
+    uint32_t numRemoteJobs = 0;
+    for ( const FBuildStats::WorkerStats & ws : stats.GetWorkerStats() )
+    {
+        numRemoteJobs += ws.m_NumJobs;
+    }
+
+    OUTPUT( "------------------------------------------------------------------------------\n" );
+    OUTPUT( "Objects      : %u (%u built remotely)\n", m_NumObjects, numRemoteJobs );
+    OUTPUT( "Build Time   : %.3f s\n", (double)buildTime );
+    OUTPUT( "Throughput   : %.1f jobs/s\n", (double)( (float)m_NumObjects / Math::Max( buildTime, 0.001f ) ) );
+    OUTPUT( "Round Trip   : p50 %u ms, p95 %u ms, p99 %u ms, max %u ms\n",
+            stats.m_RemoteRoundTripP50MS,
+            stats.m_RemoteRoundTripP95MS,
+            stats.m_RemoteRoundTripP99MS,
+            stats.m_RemoteRoundTripMaxMS );
+    OUTPUT( "Network      : %.1f MiB sent, %.1f MiB received\n",
+            (double)( (float)stats.m_NetworkBytesSent / (float)MEGABYTE ),
+            (double)( (float)stats.m_NetworkBytesReceived / (float)MEGABYTE ) );
+    OUTPUT( "------------------------------------------------------------------------------\n" );
+    OUTPUT( "%-24s %8s %14s %10s\n", "Worker", "Jobs", "Avg Trip (ms)", "Jobs/s" );
+    for ( const FBuildStats::WorkerStats & ws : stats.GetWorkerStats() )
+    {
+        OUTPUT( "%-24s %8u %14.1f %10.1f\n",
+                ws.m_Name.Get(),
+                ws.m_NumJobs,
+                (double)ws.m_AvgRoundTripMS,
+                (double)ws.m_JobsPerSecond );
+    }
+    OUTPUT( "------------------------------------------------------------------------------\n" );
+}
+
+// WriteJSON
+//------------------------------------------------------------------------------
+bool LoadGenerator::WriteJSON( float buildTime, const FBuildStats & stats ) const
+{
+    AString json;
+    json.Format( "{\n"
+                 "\"objects\":%u,\"workers\":%u,\"workerCPUs\":%u,\"allowLocal\":%s,\n"
+                 "\"compileTimeMS\":[%u,%u],\"preprocessedSizeKiB\":[%u,%u],\"outputSizeKiB\":[%u,%u],\n"
+                 "\"buildTimeS\":%.3f,\"jobsPerSecond\":%.1f,\n"
+                 "\"roundTripMS\":{\"p50\":%u,\"p95\":%u,\"p99\":%u,\"max\":%u},\n"
+                 "\"networkBytes\":{\"sent\":%" PRIu64 ",\"received\":%" PRIu64 "},\n"
+                 "\"workerStats\":[",
+                 m_NumObjects, m_NumWorkers, m_WorkerCPUs, m_AllowLocal ? "true" : "false",
+                 m_CompileTimeMS.m_Min, m_CompileTimeMS.m_Max,
+                 m_PreprocessedSizeKiB.m_Min, m_PreprocessedSizeKiB.m_Max,
+                 m_OutputSizeKiB.m_Min, m_OutputSizeKiB.m_Max,
+                 (double)buildTime, (double)( (float)m_NumObjects / Math::Max( buildTime, 0.001f ) ),
+                 stats.m_RemoteRoundTripP50MS, stats.m_RemoteRoundTripP95MS, stats.m_RemoteRoundTripP99MS, stats.m_RemoteRoundTripMaxMS,
+                 stats.m_NetworkBytesSent, stats.m_NetworkBytesReceived );
+    const char * separator = "";
+    for ( const FBuildStats::WorkerStats & ws : stats.GetWorkerStats() )
+    {
+        json.AppendFormat( "%s\n{\"name\":\"%s\",\"jobs\":%u,\"avgRoundTripMS\":%.1f,\"jobsPerSecond\":%.1f}",
+                           separator, ws.m_Name.Get(), ws.m_NumJobs, (double)ws.m_AvgRoundTripMS, (double)ws.m_JobsPerSecond );
+        separator = ",";
+    }
+    json += "\n]\n}\n";
+
+    return WriteFile( m_JSONFile, json );
+}
+
+// WriteFile
+//------------------------------------------------------------------------------
+/*static*/ bool LoadGenerator::WriteFile( const AString & fileName, const AString & contents )
+{
+    FileStream f;
+    if ( ( f.Open( fileName.Get(), FileStream::WRITE_ONLY ) == false ) ||
+         ( f.WriteBuffer( contents.Get(), contents.GetLength() ) != contents.GetLength() ) )
+    {
+        OUTPUT( "FBuildBench: Error: Failed to write '%s'\n", fileName.Get() );
+        return false;
+    }
+    return true;
+}
+
+// DisplayHelp
+//------------------------------------------------------------------------------
+/*static*/ void LoadGenerator::DisplayHelp()
+{
+    OUTPUT( "FBuildBench -loadgen - Distributed build of a synthetic project\n"
+            "Usage: FBuildBench -loadgen [options]\n"
+            "Ranges are <n> or <min>-<max>, sampled log-uniformly.\n"
+            "Options:\n"
+            " -allowlocal          Allow jobs to be built (and raced) locally.\n"
+            " -compiletime <range> Compile time in ms. (Default: 20-500)\n"
+            " -json <file>         Write results to file as JSON.\n"
+            " -objects <n>         Number of objects. (Default: 2000)\n"
+            " -outputsize <range>  Object size in KiB. (Default: 10-500)\n"
+            " -port <n>            First worker port. (Default: %u)\n"
+            " -preprocsize <range> Preprocessed size in KiB. (Default: 50-2000)\n"
+            " -seed <n>            Seed for sampling ranges.\n"
+            " -workercpus <n>      CPUs each worker uses. (Default: worker default)\n"
+            " -workerexe <path>    FBuildWorker to launch. (Default: next to FBuildBench)\n"
+            " -workers <n>         Number of workers to launch. (Default: 4)\n",
+            DEFAULT_BASE_PORT );
+}
+
+//------------------------------------------------------------------------------
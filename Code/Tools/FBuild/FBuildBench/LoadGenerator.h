@@ -0,0 +1,89 @@
+// LoadGenerator - Distributed builds of synthetic projects on one machine
+//------------------------------------------------------------------------------
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+#include "Core/Containers/Array.h"
+#include "Core/Env/Types.h"
+#include "Core/Math/Random.h"
+#include "Core/Process/Thread.h"
+#include "Core/Strings/AString.h"
+
+// Forward Declarations
+//------------------------------------------------------------------------------
+struct FBuildStats;
+
+// LoadGenerator
+//  - Generates a project of many objects for the fake compiler, with compile
+//    time, preprocessed size and output size sampled from configurable ranges
+//  - Launches several FBuildWorkers listening on loopback ports and builds the
+//    project using only them (by default), so protocol and scheduling changes
+//    can be measured without real compilers or machines
+//  - Reports throughput, round trip latency percentiles and network traffic
+//------------------------------------------------------------------------------
+class LoadGenerator
+{
+public:
+    LoadGenerator();
+    ~LoadGenerator();
+
+    static bool IsLoadGeneratorArg( const char * arg );
+
+    bool ProcessCommandLine( int argc, char * argv[] );
+    bool Run();
+
+private:
+    // values are sampled log-uniformly between min and max, so most are
+    // small with a long tail of large ones (as with real code)
+    struct Range
+    {
+        uint32_t    m_Min;
+        uint32_t    m_Max;
+    };
+    static bool ParseRange( const char * value, Range & outRange );
+    uint32_t    Sample( const Range & range );
+
+    // a launched FBuildWorker
+    struct WorkerProcess
+    {
+        const LoadGenerator *   m_Owner;
+        uint16_t                m_Port;
+        AString                 m_Args;
+        AString                 m_Environment;  // null separated, double null terminated
+        Thread::ThreadHandle    m_Thread;
+        volatile bool           m_Exited;       // failed to start or exited before being stopped
+        AString                 m_Output;
+    };
+    static uint32_t WorkerThreadFunc( void * param );
+
+    bool GenerateProject( AString & outBFFFile );
+    bool StartWorkers();
+    bool WaitForWorkers() const;
+    void StopWorkers();
+    bool Build( const AString & bffFile ) const;
+    void ReportResults( float buildTime, const FBuildStats & stats ) const;
+    bool WriteJSON( float buildTime, const FBuildStats & stats ) const;
+    static bool WriteFile( const AString & fileName, const AString & contents );
+    static void DisplayHelp();
+
+    // settings
+    uint32_t    m_NumObjects;
+    Range       m_CompileTimeMS;
+    Range       m_PreprocessedSizeKiB;
+    Range       m_OutputSizeKiB;
+    uint32_t    m_NumWorkers;
+    uint32_t    m_WorkerCPUs;       // 0 = worker default
+    uint16_t    m_BasePort;
+    bool        m_AllowLocal;       // allow local builds and races of distributed jobs
+    AString     m_WorkerExe;
+    AString     m_JSONFile;
+
+    // state
+    Random                  m_Random;
+    AString                 m_Dir;
+    Array< WorkerProcess >  m_Workers;
+    volatile bool           m_StopWorkers;
+};
+
+//------------------------------------------------------------------------------
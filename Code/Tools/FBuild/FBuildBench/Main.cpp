@@ -0,0 +1,220 @@
+// Main.cpp : Defines the entry point for the benchmark application.
+//------------------------------------------------------------------------------
+
+// Includes
+//------------------------------------------------------------------------------
+#include "Benchmark.h"
+#include "BenchmarkManager.h"
+#include "FakeCompiler.h"
+#include "LoadGenerator.h"
+
+// Core
+#include "Core/FileIO/FileStream.h"
+#include "Core/Strings/AStackString.h"
+#include "Core/Strings/AString.h"
+#include "Core/Tracing/Tracing.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// Return Codes
+//------------------------------------------------------------------------------
+enum ReturnCodes
+{
+    FBUILDBENCH_OK                  = 0,
+    FBUILDBENCH_REGRESSION          = 1,
+    FBUILDBENCH_BAD_ARGS            = -1,
+    FBUILDBENCH_FILE_ERROR          = -2,
+    FBUILDBENCH_FAILED              = -3,
+};
+
+// Helpers
+//------------------------------------------------------------------------------
+void DisplayHelp();
+bool ReadFile( const char * fileName, AString & outContents );
+bool WriteFile( const char * fileName, const AString & contents );
+
+// main
+//------------------------------------------------------------------------------
+int main( int argc, char * argv[] )
+{
+    // Invoked as a compiler by the end-to-end benchmarks?
+    if ( ( argc > 1 ) && FakeCompiler::IsFakeCompilerArg( argv[ 1 ] ) )
+    {
+        return FakeCompiler::Main( argc, argv );
+    }
+
+    // Distributed build load generation?
+    if ( ( argc > 1 ) && LoadGenerator::IsLoadGeneratorArg( argv[ 1 ] ) )
+    {
+        LoadGenerator lg;
+        if ( lg.ProcessCommandLine( argc, argv ) == false )
+        {
+            return FBUILDBENCH_BAD_ARGS;
+        }
+        return lg.Run() ? FBUILDBENCH_OK : FBUILDBENCH_FAILED;
+    }
+
+    const char * filter = nullptr;
+    const char * jsonFile = nullptr;
+    const char * compareBaseline = nullptr;
+    const char * compareCurrent = nullptr;
+    uint32_t repetitions = 5;
+    uint32_t threshold = 5;
+    bool quick = false;
+    bool verbose = false;
+
+    for ( int i = 1; i < argc; ++i )
+    {
+        const AStackString<> arg( argv[ i ] );
+        const bool hasNext = ( i + 1 < argc );
+        if ( ( arg == "-filter" ) && hasNext )
+        {
+            filter = argv[ ++i ];
+        }
+        else if ( ( arg == "-json" ) && hasNext )
+        {
+            jsonFile = argv[ ++i ];
+        }
+        else if ( ( arg == "-repeat" ) && hasNext )
+        {
+            const int value = atoi( argv[ ++i ] );
+            if ( value <= 0 )
+            {
+                OUTPUT( "FBuildBench: Error: Invalid value for -repeat '%s'\n", argv[ i ] );
+                return FBUILDBENCH_BAD_ARGS;
+            }
+            repetitions = (uint32_t)value;
+        }
+        else if ( ( arg == "-threshold" ) && hasNext )
+        {
+            const int value = atoi( argv[ ++i ] );
+            if ( value <= 0 )
+            {
+                OUTPUT( "FBuildBench: Error: Invalid value for -threshold '%s'\n", argv[ i ] );
+                return FBUILDBENCH_BAD_ARGS;
+            }
+            threshold = (uint32_t)value;
+        }
+        else if ( ( arg == "-compare" ) && ( i + 2 < argc ) )
+        {
+            compareBaseline = argv[ ++i ];
+            compareCurrent = argv[ ++i ];
+        }
+        else if ( arg == "-quick" )
+        {
+            quick = true;
+        }
+        else if ( arg == "-verbose" )
+        {
+            verbose = true;
+        }
+        else if ( ( arg == "-help" ) || ( arg == "-?" ) )
+        {
+            DisplayHelp();
+            return FBUILDBENCH_OK;
+        }
+        else
+        {
+            OUTPUT( "FBuildBench: Error: Unknown argument '%s'\n", arg.Get() );
+            DisplayHelp();
+            return FBUILDBENCH_BAD_ARGS;
+        }
+    }
+
+    // Compare previous results?
+    if ( compareBaseline )
+    {
+        AString baseline;
+        AString current;
+        if ( !ReadFile( compareBaseline, baseline ) || !ReadFile( compareCurrent, current ) )
+        {
+            return FBUILDBENCH_FILE_ERROR;
+        }
+        return BenchmarkManager::Compare( baseline, current, threshold ) ? FBUILDBENCH_OK : FBUILDBENCH_REGRESSION;
+    }
+
+    BenchmarkManager bm;
+    bm.SetRepetitions( repetitions );
+    bm.SetQuick( quick );
+    bm.SetVerbose( verbose );
+
+    // benchmarks to run
+    REGISTER_BENCHMARKGROUP( BenchCore )
+    REGISTER_BENCHMARKGROUP( BenchBFF )
+    REGISTER_BENCHMARKGROUP( BenchPath )
+    REGISTER_BENCHMARKGROUP( BenchProcess )
+    REGISTER_BENCHMARKGROUP( BenchBuild )
+
+    bm.RunBenchmarks( filter );
+
+    if ( jsonFile )
+    {
+        AString json;
+        bm.WriteJSON( json );
+        if ( !WriteFile( jsonFile, json ) )
+        {
+            return FBUILDBENCH_FILE_ERROR;
+        }
+    }
+
+    return ( bm.GetNumFailures() == 0 ) ? FBUILDBENCH_OK : FBUILDBENCH_FAILED;
+}
+
+// DisplayHelp
+//------------------------------------------------------------------------------
+void DisplayHelp()
+{
+    OUTPUT( "FBuildBench - Benchmarks for FASTBuild\n"
+            "Usage: FBuildBench [options]\n"
+            "Options:\n"
+            " -compare <baseline.json> <current.json>\n"
+            "                   Compare results of two runs. Returns 1 if any\n"
+            "                   benchmark is slower than the threshold.\n"
+            " -filter <string>  Only run benchmarks whose Group.Name contains string.\n"
+            " -help             Show this help.\n"
+            " -json <file>      Write results to file as JSON.\n"
+            " -loadgen [...]    Distributed build of a synthetic project using\n"
+            "                   local workers. (See -loadgen -help)\n"
+            " -quick            Use smaller workloads and a single repetition.\n"
+            " -repeat <n>       Repetitions of each benchmark. (Default: 5)\n"
+            " -threshold <n>    Percentage slowdown considered a regression\n"
+            "                   when comparing. (Default: 5)\n"
+            " -verbose          Show output of benchmarked builds.\n" );
+}
+
+// ReadFile
+//------------------------------------------------------------------------------
+bool ReadFile( const char * fileName, AString & outContents )
+{
+    FileStream f;
+    if ( f.Open( fileName, FileStream::READ_ONLY ) == false )
+    {
+        OUTPUT( "FBuildBench: Error: Failed to open '%s'\n", fileName );
+        return false;
+    }
+    const uint32_t size = (uint32_t)f.GetFileSize();
+    outContents.SetLength( size );
+    if ( f.ReadBuffer( outContents.Get(), size ) != size )
+    {
+        OUTPUT( "FBuildBench: Error: Failed to read '%s'\n", fileName );
+        return false;
+    }
+    return true;
+}
+
+// WriteFile
+//------------------------------------------------------------------------------
+bool WriteFile( const char * fileName, const AString & contents )
+{
+    FileStream f;
+    if ( ( f.Open( fileName, FileStream::WRITE_ONLY ) == false ) ||
+         ( f.WriteBuffer( contents.Get(), contents.GetLength() ) != contents.GetLength() ) )
+    {
+        OUTPUT( "FBuildBench: Error: Failed to write '%s'\n", fileName );
+        return false;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
@@ -5,6 +5,7 @@
 //------------------------------------------------------------------------------
 #include "BFFStackFrame.h"
 #include "BFFVariable.h"
+#include "Core/Math/xxHash.h"
 #include "Core/Mem/Mem.h"
 #include "Core/Strings/AStackString.h"
 
@@ -288,10 +289,17 @@ BFFVariable * BFFStackFrame::ConcatVars( const AString & name,
 //------------------------------------------------------------------------------
 const BFFVariable * BFFStackFrame::GetVariableRecurse( const AString & name ) const
 {
-    // look at this scope level
+    return GetVariableRecurse( name, xxHash::Calc32( name ) );
+}
+
+// GetVariableRecurse
+//------------------------------------------------------------------------------
+const BFFVariable * BFFStackFrame::GetVariableRecurse( const AString & name, uint32_t nameHash ) const
+{
+    // look at this scope level (checking name hashes first to quickly skip other names)
     for ( const BFFVariable * var : m_Variables )
     {
-        if ( var->GetName() == name )
+        if ( ( var->GetNameHash() == nameHash ) && ( var->GetName() == name ) )
         {
             return var;
         }
@@ -300,7 +308,7 @@ const BFFVariable * BFFStackFrame::GetVariableRecurse( const AString & name ) co
     // look at parent
     if ( m_Next )
     {
-        return m_Next->GetVariableRecurse( name );
+        return m_Next->GetVariableRecurse( name, nameHash );
     }
 
     // not found
@@ -402,10 +410,11 @@ const BFFVariable * BFFStackFrame::GetVarNoRecurse( const AString & name ) const
 {
     ASSERT( s_StackHead ); // we shouldn't be calling this if there aren't any stack frames
 
-    // look at this scope level
+    // look at this scope level (checking name hashes first to quickly skip other names)
+    const uint32_t nameHash = xxHash::Calc32( name );
     for ( const BFFVariable * var : m_Variables )
     {
-        if ( var->GetName() == name )
+        if ( ( var->GetNameHash() == nameHash ) && ( var->GetName() == name ) )
         {
             return var;
         }
@@ -420,10 +429,11 @@ BFFVariable * BFFStackFrame::GetVarMutableNoRecurse( const AString & name )
 {
     ASSERT( s_StackHead ); // we shouldn't be calling this if there aren't any stack frames
 
-    // look at this scope level
+    // look at this scope level (checking name hashes first to quickly skip other names)
+    const uint32_t nameHash = xxHash::Calc32( name );
     for ( BFFVariable * var : m_Variables )
     {
-        if ( var->GetName() == name )
+        if ( ( var->GetNameHash() == nameHash ) && ( var->GetName() == name ) )
         {
             return var;
         }
@@ -440,11 +450,12 @@ void BFFStackFrame::CreateOrReplaceVarMutableNoRecurse( BFFVariable * var )
     ASSERT( var );
 
     // look at this scope level
+    const uint32_t nameHash = var->GetNameHash();
     Array< BFFVariable * >::Iter i = m_Variables.Begin();
     Array< BFFVariable * >::Iter end = m_Variables.End();
     for( ; i < end ; ++i )
     {
-        if ( ( *i )->GetName() == var->GetName() )
+        if ( ( ( *i )->GetNameHash() == nameHash ) && ( ( *i )->GetName() == var->GetName() ) )
         {
             FDELETE *i;
             *i = var;
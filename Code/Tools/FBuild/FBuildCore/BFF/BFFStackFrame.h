@@ -88,6 +88,7 @@ public:
     }
 
 private:
+    const BFFVariable * GetVariableRecurse( const AString & name, uint32_t nameHash ) const;
     const BFFVariable * GetVariableRecurse( const AString & nameOnly,
                                       BFFVariable::VarType type ) const;
 
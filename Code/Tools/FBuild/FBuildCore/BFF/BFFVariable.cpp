@@ -7,6 +7,7 @@
 #include "Tools/FBuild/FBuildCore/Error.h"
 #include "Tools/FBuild/FBuildCore/FLog.h"
 
+#include "Core/Math/xxHash.h"
 #include "Core/Mem/Mem.h"
 
 // Static Data
@@ -26,6 +27,7 @@
 //------------------------------------------------------------------------------
 BFFVariable::BFFVariable( const AString & name, VarType type )
     : m_Name( name )
+    , m_NameHash( xxHash::Calc32( name ) )
     , m_Type( type )
 {
 }
@@ -34,6 +36,7 @@ BFFVariable::BFFVariable( const AString & name, VarType type )
 //------------------------------------------------------------------------------
 BFFVariable::BFFVariable( const BFFVariable & other )
     : m_Name( other.m_Name )
+    , m_NameHash( other.m_NameHash )
     , m_Type( other.m_Type )
 {
     switch( m_Type )
@@ -53,6 +56,7 @@ BFFVariable::BFFVariable( const BFFVariable & other )
 //------------------------------------------------------------------------------
 BFFVariable::BFFVariable( const AString & name, const AString & value )
     : m_Name( name )
+    , m_NameHash( xxHash::Calc32( name ) )
     , m_Type( VAR_STRING )
     , m_StringValue( value )
 {
@@ -62,6 +66,7 @@ BFFVariable::BFFVariable( const AString & name, const AString & value )
 //------------------------------------------------------------------------------
 BFFVariable::BFFVariable( const AString & name, bool value )
     : m_Name( name )
+    , m_NameHash( xxHash::Calc32( name ) )
     , m_Type( VAR_BOOL )
     , m_BoolValue( value )
 {
@@ -71,6 +76,7 @@ BFFVariable::BFFVariable( const AString & name, bool value )
 //------------------------------------------------------------------------------
 BFFVariable::BFFVariable( const AString & name, const Array< AString > & values )
     : m_Name( name )
+    , m_NameHash( xxHash::Calc32( name ) )
     , m_Type( VAR_ARRAY_OF_STRINGS )
     , m_ArrayValues( values )
 {
@@ -80,6 +86,7 @@ BFFVariable::BFFVariable( const AString & name, const Array< AString > & values
 //------------------------------------------------------------------------------
 BFFVariable::BFFVariable( const AString & name, int32_t i )
     : m_Name( name )
+    , m_NameHash( xxHash::Calc32( name ) )
     , m_Type( VAR_INT )
     , m_IntValue( i )
 {
@@ -89,6 +96,7 @@ BFFVariable::BFFVariable( const AString & name, int32_t i )
 //------------------------------------------------------------------------------
 BFFVariable::BFFVariable( const AString & name, const Array< const BFFVariable * > & values )
     : m_Name( name )
+    , m_NameHash( xxHash::Calc32( name ) )
     , m_Type( VAR_STRUCT )
     , m_SubVariables( values.GetSize(), true )
 {
@@ -100,6 +108,7 @@ BFFVariable::BFFVariable( const AString & name, const Array< const BFFVariable *
 BFFVariable::BFFVariable( const AString & name,
                           Array<BFFVariable *> && values )
     : m_Name( name )
+    , m_NameHash( xxHash::Calc32( name ) )
     , m_Type( VAR_STRUCT )
     , m_SubVariables( Move( values ) )
 {
@@ -111,6 +120,7 @@ BFFVariable::BFFVariable( const AString & name,
                           const Array< const BFFVariable * > & structs,
                           VarType type ) // type for disambiguation
     : m_Name( name )
+    , m_NameHash( xxHash::Calc32( name ) )
     , m_Type( VAR_ARRAY_OF_STRUCTS )
     , m_SubVariables( structs.GetSize(), true )
 {
@@ -30,6 +30,7 @@ class BFFVariable
 {
 public:
     inline const AString & GetName() const { return m_Name; }
+    inline uint32_t GetNameHash() const { return m_NameHash; } // xxHash::Calc32 of name, to quickly reject mismatches
 
     const AString & GetString() const { ASSERT( IsString() ); return m_StringValue; }
     const Array< AString > & GetArrayOfStrings() const { ASSERT( IsArrayOfStrings() ); return m_ArrayValues; }
@@ -94,6 +95,7 @@ private:
     void SetValueArrayOfStructs( const Array< const BFFVariable * > & values );
 
     AString m_Name;
+    uint32_t m_NameHash;
     VarType m_Type;
 
     mutable uint8_t     m_FreezeCount   = 0;
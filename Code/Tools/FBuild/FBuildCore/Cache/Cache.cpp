@@ -148,6 +148,9 @@ public:
     AStackString<> fullPath;
     GetFullPathForCacheEntry( cacheId, fullPath );
 
+    // Read (rather than map) the entry. Mapped views of network shares fault
+    // (SIGBUS) if the file changes or the share drops while in use, and keep
+    // the entry from being trimmed on Windows until the view is released.
     FileStream cacheFile;
     if ( cacheFile.Open( fullPath.Get(), FileStream::READ_ONLY ) )
     {
@@ -660,6 +660,15 @@
     FormatError( iter, 1303u, function, "Precompiled Header option '%s' in '%s' invalid. Only allowed on Precompiled Header.", option, property );
 }
 
+// Error_1304_LibrarianOperationInvalidForUpdateInPlace
+//------------------------------------------------------------------------------
+/*static*/ void Error::Error_1304_LibrarianOperationInvalidForUpdateInPlace( const BFFToken * iter,
+                                                                             const Function * function,
+                                                                             const AString & operation )
+{
+    FormatError( iter, 1304u, function, "Librarian operation '%s' invalid with 'LibrarianUpdateInPlace'. Only 'r' (replace) is allowed.", operation.Get() );
+}
+
 // Error_1400_CopyDestMissingSlash
 //------------------------------------------------------------------------------
 /*static*/ void Error::Error_1400_CopyDestMissingSlash( const BFFToken * iter,
@@ -199,6 +199,9 @@ public:
                                                             const Function * function,
                                                             const char * option,
                                                             const char * property );
+    static void Error_1304_LibrarianOperationInvalidForUpdateInPlace( const BFFToken * iter,
+                                                                      const Function * function,
+                                                                      const AString & operation );
 
     // 1400-1499 : Copy specific errors
     //------------------------------------------------------------------------------
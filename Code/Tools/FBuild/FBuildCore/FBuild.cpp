@@ -16,7 +16,10 @@
 #include "Graph/NodeGraph.h"
 #include "Graph/NodeProxy.h"
 #include "Graph/SettingsNode.h"
+#include "Helpers/BuildHistory.h"
+#include "Helpers/BuildTrace.h"
 #include "Helpers/CompilationDatabase.h"
+#include "Helpers/MetricsServer.h"
 #include "Helpers/Report.h"
 #include "Protocol/Client.h"
 #include "Protocol/Protocol.h"
@@ -58,11 +61,13 @@ FBuild::FBuild( const FBuildOptions & options )
     : m_DependencyGraph( nullptr )
     , m_JobQueue( nullptr )
     , m_Client( nullptr )
+    , m_MetricsServer( nullptr )
     , m_Cache( nullptr )
     , m_LastProgressOutputTime( 0.0f )
     , m_LastProgressCalcTime( 0.0f )
     , m_SmoothedProgressCurrent( 0.0f )
     , m_SmoothedProgressTarget( 0.0f )
+    , m_LastMetricsTime( 0.0f )
     , m_EnvironmentString( nullptr )
     , m_EnvironmentStringSize( 0 )
     , m_ImportedEnvironmentVars( 0, true )
@@ -103,6 +108,7 @@ FBuild::~FBuild()
 
     FDELETE m_DependencyGraph;
     FDELETE m_Client;
+    FDELETE m_MetricsServer;
     FREE( m_EnvironmentString );
 
     if ( m_Cache )
@@ -157,6 +163,13 @@ bool FBuild::Initialize( const char * nodeGraphDBFile )
         #endif
     }
 
+    m_HistoryFile = m_DependencyGraphFile;
+    if ( m_HistoryFile.EndsWithI( ".fdb" ) )
+    {
+        m_HistoryFile.SetLength( m_HistoryFile.GetLength() - 4 );
+    }
+    m_HistoryFile += ".history";
+
     SmallBlockAllocator::SetSingleThreadedMode( true );
 
     m_DependencyGraph = NodeGraph::Initialize( bffFile, m_DependencyGraphFile.Get(), m_Options.m_ForceDBMigration_Debug );
@@ -399,7 +412,22 @@ bool FBuild::Build( Node * nodeToBuild )
     m_LastProgressCalcTime = 0.0f;
     m_SmoothedProgressCurrent = 0.0f;
     m_SmoothedProgressTarget = 0.0f;
+    m_LastMetricsTime = 0.0f;
+    if ( ( m_Options.m_MetricsPort != 0 ) && ( m_MetricsServer == nullptr ) )
+    {
+        m_MetricsServer = FNEW( MetricsServer() );
+        if ( m_MetricsServer->Start( m_Options.m_MetricsPort ) == false )
+        {
+            FLOG_WARN( "Failed to listen on port %u for -metrics", (uint32_t)m_Options.m_MetricsPort );
+            FDELETE m_MetricsServer;
+            m_MetricsServer = nullptr;
+        }
+    }
     FLog::StartBuild();
+    if ( m_Options.m_TraceFile.IsEmpty() == false )
+    {
+        BuildTrace::Start( m_Options.m_TraceFile );
+    }
 
     // create worker dir for main thread build case
     if ( m_Options.m_NumWorkerThreads == 0 )
@@ -413,14 +441,25 @@ bool FBuild::Build( Node * nodeToBuild )
     for ( ;; )
     {
         // process completed jobs
-        m_JobQueue->FinalizeCompletedJobs( *m_DependencyGraph );
+        {
+            BuildTraceSection traceSection( "main", "FinalizeCompletedJobs" );
+            m_JobQueue->FinalizeCompletedJobs( *m_DependencyGraph );
+        }
 
         if ( !stopping )
         {
             // do a sweep of the graph to create more jobs
+            BuildTraceSection traceSection( "main", "DoBuildPass" );
             m_DependencyGraph->DoBuildPass( nodeToBuild );
         }
 
+        if ( BuildTrace::IsEnabled() )
+        {
+            uint32_t numJobs, numJobsActive, numJobsDist, numJobsDistActive;
+            m_JobQueue->GetJobStats( numJobs, numJobsActive, numJobsDist, numJobsDistActive );
+            BuildTrace::AddJobQueueSample( numJobs, numJobsActive, numJobsDist, numJobsDistActive );
+        }
+
         if ( m_Options.m_NumWorkerThreads == 0 )
         {
             // no local threads - do build directly
@@ -435,6 +474,10 @@ bool FBuild::Build( Node * nodeToBuild )
             if ( stopping == false )
             {
                 // free the network distribution system (if there is one)
+                if ( m_Client )
+                {
+                    m_Client->GetWorkerStats( m_BuildStats );
+                }
                 FDELETE m_Client;
                 m_Client = nullptr;
 
@@ -475,14 +518,20 @@ bool FBuild::Build( Node * nodeToBuild )
 
         // update progress
         UpdateBuildStatus( nodeToBuild );
+        UpdateMetrics( nodeToBuild, false );
     }
 
     // wrap up/free any jobs that come from the last build pass
     m_JobQueue->FinalizeCompletedJobs( *m_DependencyGraph );
+    UpdateMetrics( nodeToBuild, true );
 
+    m_JobQueue->GetRaceStats( m_BuildStats );
     FDELETE m_JobQueue;
     m_JobQueue = nullptr;
 
+    // all threads have stopped, so the timeline is complete
+    BuildTrace::Stop();
+
     FLog::StopBuild();
 
     // even if the build has failed, we can still save the graph.
@@ -624,7 +673,7 @@ void FBuild::UpdateBuildStatus( const Node * node )
 
     if ( FBuild::Get().GetOptions().m_ShowProgress == false )
     {
-        if ( FBuild::Get().GetOptions().m_EnableMonitor == false )
+        if ( ( FBuild::Get().GetOptions().m_EnableMonitor == false ) && ( m_MetricsServer == nullptr ) )
         {
             return;
         }
@@ -684,6 +733,98 @@ void FBuild::UpdateBuildStatus( const Node * node )
     m_LastProgressOutputTime = timeNow;
 }
 
+// UpdateMetrics
+//------------------------------------------------------------------------------
+void FBuild::UpdateMetrics( const Node * node, bool force )
+{
+    if ( m_MetricsServer == nullptr )
+    {
+        return;
+    }
+
+    const float METRICS_FREQUENCY( 0.5f );
+
+    const float timeNow = m_Timer.GetElapsed();
+    if ( ( force == false ) && ( ( timeNow - m_LastMetricsTime ) < METRICS_FREQUENCY ) )
+    {
+        return;
+    }
+    m_LastMetricsTime = timeNow;
+
+    PROFILE_FUNCTION
+
+    // Everything here is cheap to gather, and the server threads only ever
+    // wait for the formatted result to be swapped in
+    const char * status = "building";
+    float progress = m_SmoothedProgressCurrent;
+    if ( force )
+    {
+        const bool ok = ( node->GetState() == Node::UP_TO_DATE );
+        status = ok ? "ok" : "failed";
+        progress = ok ? 100.0f : progress;
+    }
+
+    uint32_t numJobs, numJobsActive, numJobsDist, numJobsDistActive;
+    m_JobQueue->GetJobStats( numJobs, numJobsActive, numJobsDist, numJobsDistActive );
+    const JobQueue::CompletedStats & completed = m_JobQueue->GetCompletedStats();
+    const uint32_t numCacheLookups = ( completed.m_NumCacheHits + completed.m_NumCacheMisses );
+    const float cacheHitRate = numCacheLookups ? ( (float)completed.m_NumCacheHits * 100.0f / (float)numCacheLookups ) : 0.0f;
+
+    AString json( 4096 );
+    json.Format( "{\n"
+                 "\"status\":\"%s\",\n"
+                 "\"timeS\":%.1f,\n"
+                 "\"progress\":%.1f,\n"
+                 "\"nodes\":{\"completed\":%u,\"built\":%u,\"failed\":%u,\"builtRemote\":%u,\"cacheHits\":%u,\"cacheMisses\":%u,\"cacheHitRate\":%.1f},\n"
+                 "\"queue\":{\"remaining\":%u,\"local\":%u,\"localActive\":%u,\"distributable\":%u,\"distributableActive\":%u},\n",
+                 status,
+                 (double)timeNow,
+                 (double)progress,
+                 completed.m_NumCompleted,
+                 completed.m_NumBuilt,
+                 completed.m_NumFailed,
+                 completed.m_NumBuiltRemote,
+                 completed.m_NumCacheHits,
+                 completed.m_NumCacheMisses,
+                 (double)cacheHitRate,
+                 ( numJobs + numJobsActive + numJobsDist + numJobsDistActive ),
+                 numJobs,
+                 numJobsActive,
+                 numJobsDist,
+                 numJobsDistActive );
+
+    // per-thread activity
+    Array< JobQueue::ThreadActivity > threads( 64, true );
+    m_JobQueue->GetThreadActivity( threads );
+    json += "\"threads\":[";
+    for ( size_t i = 0; i < threads.GetSize(); ++i )
+    {
+        const JobQueue::ThreadActivity & thread = threads[ i ];
+        json.AppendFormat( "%s{\"index\":%u,\"active\":%s,\"jobs\":%u,\"busyMS\":%u}",
+                           ( i > 0 ) ? "," : "",
+                           (uint32_t)i,
+                           thread.m_Active ? "true" : "false",
+                           thread.m_NumJobs,
+                           thread.m_BusyTimeMS );
+    }
+    json += "],\n";
+
+    // remote workers
+    uint32_t numWorkers = 0;
+    uint32_t numWorkerCPUs = 0;
+    uint32_t numWorkerJobs = 0;
+    if ( m_Client )
+    {
+        m_Client->GetWorkerUtilization( numWorkers, numWorkerCPUs, numWorkerJobs );
+    }
+    json.AppendFormat( "\"workers\":{\"connected\":%u,\"cpus\":%u,\"jobsInProgress\":%u},\n",
+                       numWorkers, numWorkerCPUs, numWorkerJobs );
+
+    json.AppendFormat( "\"memoryBytes\":%" PRIu64 "\n}\n", Env::GetProcessMemoryUsage() );
+
+    m_MetricsServer->SetMetrics( json );
+}
+
 // GetDefaultBFFFileName
 //------------------------------------------------------------------------------
 /*static*/ const char * FBuild::GetDefaultBFFFileName()
@@ -818,6 +959,14 @@ bool FBuild::GenerateCompilationDatabase( const Array< AString > & targets ) con
     return FileIO::GetTempDir( outTempDir );
 }
 
+// GetDistributionCompressionLevel
+//------------------------------------------------------------------------------
+int32_t FBuild::GetDistributionCompressionLevel() const
+{
+    // The Client adapts the level to the connections it is sending over
+    return m_Client ? m_Client->GetPreferredCompressionLevel() : -1; // -1 = default LZ4 compression level
+}
+
 // CacheOutputInfo
 //------------------------------------------------------------------------------
 bool FBuild::CacheOutputInfo() const
@@ -846,4 +995,19 @@ bool FBuild::CacheTrim() const
     return false;
 }
 
+// DisplayHistory
+//------------------------------------------------------------------------------
+bool FBuild::DisplayHistory() const
+{
+    BuildHistory history;
+    if ( history.Load( m_HistoryFile ) == false )
+    {
+        OUTPUT( "No build history found in '%s'. Use -recordhistory to record builds.\n", m_HistoryFile.Get() );
+        return false;
+    }
+
+    history.OutputRegressions( m_Options.m_HistoryThreshold );
+    return true;
+}
+
 //------------------------------------------------------------------------------
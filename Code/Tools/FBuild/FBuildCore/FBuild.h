@@ -24,6 +24,7 @@ class FileStream;
 class ICache;
 class IOStream;
 class JobQueue;
+class MetricsServer;
 class Node;
 class NodeGraph;
 
@@ -104,15 +105,23 @@ public:
 
     inline ICache * GetCache() const { return m_Cache; }
 
+    // compression level (as per Compressor) for job data to be distributed
+    int32_t GetDistributionCompressionLevel() const;
+
     static bool GetTempDir( AString & outTempDir );
 
     bool CacheOutputInfo() const;
     bool CacheTrim() const;
 
+    // build history (stored alongside the dependency graph DB)
+    inline const AString & GetHistoryFile() const { return m_HistoryFile; }
+    bool DisplayHistory() const;
+
 protected:
     bool GetTargets( const Array< AString > & targets, Dependencies & outDeps ) const;
 
     void UpdateBuildStatus( const Node * node );
+    void UpdateMetrics( const Node * node, bool force );
 
     static bool s_StopBuild;
     static volatile bool s_AbortBuild;  // -fastcancel - TODO:C merge with StopBuild
@@ -120,8 +129,10 @@ protected:
     NodeGraph * m_DependencyGraph;
     JobQueue * m_JobQueue;
     Client * m_Client; // manage connections to worker servers
+    MetricsServer * m_MetricsServer; // live metrics (-metrics)
 
     AString m_DependencyGraphFile;
+    AString m_HistoryFile;
     ICache * m_Cache;
 
     Timer m_Timer;
@@ -129,6 +140,7 @@ protected:
     float m_LastProgressCalcTime;
     float m_SmoothedProgressCurrent;
     float m_SmoothedProgressTarget;
+    float m_LastMetricsTime;
 
     FBuildStats m_BuildStats;
 
@@ -211,6 +211,30 @@ FBuildOptions::OptionsResult FBuildOptions::ProcessCommandLine( int argc, char *
                 DisplayHelp( programName );
                 return OPTIONS_OK_AND_QUIT; // exit app
             }
+            else if ( thisArg == "-history" )
+            {
+                m_DisplayHistory = true;
+                continue;
+            }
+            else if ( thisArg == "-historythreshold" )
+            {
+                const int percentIndex = ( i + 1 );
+                PRAGMA_DISABLE_PUSH_MSVC( 4996 ) // This function or variable may be unsafe...
+                if ( ( percentIndex >= argc ) ||
+                     ( sscanf( argv[ percentIndex ], "%u", &m_HistoryThreshold ) ) != 1 ) // TODO:C Consider using sscanf_s
+                PRAGMA_DISABLE_POP_MSVC // 4996
+                {
+                    OUTPUT( "FBuild: Error: Missing or bad <percent> for '-historythreshold' argument\n" );
+                    OUTPUT( "Try \"%s -help\"\n", programName.Get() );
+                    return OPTIONS_ERROR;
+                }
+                i++; // skip extra arg we've consumed
+
+                // add to args we might pass to subprocess
+                m_Args += ' ';
+                m_Args += argv[ percentIndex ];
+                continue;
+            }
             else if ( ( thisArg == "-ide" ) || ( thisArg == "-vs" ) )
             {
                 m_ShowProgress = false;
@@ -232,6 +256,28 @@ FBuildOptions::OptionsResult FBuildOptions::ProcessCommandLine( int argc, char *
                     continue; // 'numWorkers' will contain value now
                 }
             }
+            else if ( thisArg == "-metrics" )
+            {
+                const int portIndex = ( i + 1 );
+                uint32_t port = 0;
+                PRAGMA_DISABLE_PUSH_MSVC( 4996 ) // This function or variable may be unsafe...
+                if ( ( portIndex >= argc ) ||
+                     ( sscanf( argv[ portIndex ], "%u", &port ) ) != 1 || // TODO:C Consider using sscanf_s
+                     ( port == 0 ) || ( port > 0xFFFF ) )
+                PRAGMA_DISABLE_POP_MSVC // 4996
+                {
+                    OUTPUT( "FBuild: Error: Missing or bad <port> for '-metrics' argument\n" );
+                    OUTPUT( "Try \"%s -help\"\n", programName.Get() );
+                    return OPTIONS_ERROR;
+                }
+                m_MetricsPort = (uint16_t)port;
+                i++; // skip extra arg we've consumed
+
+                // add to args we might pass to subprocess
+                m_Args += ' ';
+                m_Args += argv[ portIndex ];
+                continue;
+            }
             else if ( thisArg == "-monitor" )
             {
                 m_EnableMonitor = true;
@@ -270,6 +316,11 @@ FBuildOptions::OptionsResult FBuildOptions::ProcessCommandLine( int argc, char *
                 m_NoUnity = true;
                 continue;
             }
+            else if ( thisArg == "-profile" )
+            {
+                m_EnableProfiling = true;
+                continue;
+            }
             else if ( thisArg == "-progress" )
             {
                 m_ShowProgress = true;
@@ -283,6 +334,11 @@ FBuildOptions::OptionsResult FBuildOptions::ProcessCommandLine( int argc, char *
                 m_ShowVerbose = false;
                 continue;
             }
+            else if ( thisArg == "-recordhistory" )
+            {
+                m_RecordHistory = true;
+                continue;
+            }
             else if ( thisArg == "-report" )
             {
                 m_GenerateReport = true;
@@ -319,6 +375,25 @@ FBuildOptions::OptionsResult FBuildOptions::ProcessCommandLine( int argc, char *
                 m_ShowSummary = true;
                 continue;
             }
+            else if ( thisArg == "-trace" )
+            {
+                int pathIndex = ( i + 1 );
+                if ( pathIndex >= argc )
+                {
+                    OUTPUT( "FBuild: Error: Missing <path> for '-trace' argument\n" );
+                    OUTPUT( "Try \"%s -help\"\n", programName.Get() );
+                    return OPTIONS_ERROR;
+                }
+                m_TraceFile = argv[ pathIndex ];
+                i++; // skip extra arg we've consumed
+
+                // add to args we might pass to subprocess
+                m_Args += ' ';
+                m_Args += '"'; // surround trace file with quotes to avoid problems with spaces in the path
+                m_Args += m_TraceFile;
+                m_Args += '"';
+                continue;
+            }
             else if ( thisArg == "-verbose" )
             {
                 m_ShowVerbose = true;
@@ -540,19 +615,28 @@ void FBuildOptions::DisplayHelp( const AString & programName ) const
             " -fixuperrorpaths  Reformat error paths to be Visual Studio friendly.\n"
             " -forceremote      Force distributable jobs to only be built remotely.\n"
             " -help             Show this help.\n"
+            " -history          Show recent builds and regressions in the latest build.\n"
+            "                   (Requires builds made with -recordhistory)\n"
+            " -historythreshold <percent>\n"
+            "                   Percentage increase in build time or include count to\n"
+            "                   report as a regression with -history. (Default: 25)\n"
             " -ide              Enable multiple options when building from an IDE.\n"
             "                   Enables: -noprogress, -fixuperrorpaths &\n"
             "                   -wrapper (Windows)\n"
             " -j<x>             Explicitly set LOCAL worker thread count X, instead of\n"
             "                   default of hardware thread count.\n"
+            " -metrics <port>   Serve live build metrics as JSON over HTTP on <port>.\n"
+            "                   (Only accessible from the local machine)\n"
             " -monitor          Emit a machine-readable file while building.\n"
             " -nolocalrace      Disable local race of remotely started jobs.\n"
             " -noprogress       Don't show the progress bar while building.\n"
             " -nounity          (Experimental) Build files individually, ignoring Unity.\n"
             " -nostoponerror    On error, favor building as much as possible.\n"
             " -nosummaryonerror Hide the summary if the build fails. Implies -summary.\n"
+            " -profile          Write a profile of FASTBuild itself to profile.json.\n"
             " -progress         Show build progress bar even if stdout is redirected.\n"
             " -quiet            Don't show build output.\n"
+            " -recordhistory    Append statistics for this build to the build history.\n"
             " -report           Ouput report.html at build end. (Increases build time)\n"
             " -showcmds         Show command lines used to launch external processes.\n"
             " -showcmdoutput    Show output of external processes.\n"
@@ -560,6 +644,8 @@ void FBuildOptions::DisplayHelp( const AString & programName ) const
             " -showtargets      Display primary targets, excluding those marked \"Hidden\".\n"
             " -showalltargets   Display primary targets, including those marked \"Hidden\".\n"
             " -summary          Show a summary at the end of the build.\n"
+            " -trace <path>     Write a timeline of the build in Chrome Trace Event format.\n"
+            "                   (View with chrome://tracing or ui.perfetto.dev)\n"
             " -verbose          Show detailed diagnostic info. (Increases built time)\n"
             " -version          Print version and exit.\n"
             " -vs               VisualStudio mode. Same as -ide.\n"
@@ -87,6 +87,14 @@ public:
     bool        m_NoSummaryOnError                  = false;
     bool        m_GenerateReport                    = false;
     bool        m_EnableMonitor                     = false;
+    bool        m_EnableProfiling                   = false; // profile FASTBuild itself (-profile)
+    uint16_t    m_MetricsPort                       = 0; // serve live metrics on this port (-metrics)
+
+    // Build History
+    bool        m_RecordHistory                     = false;
+    bool        m_DisplayHistory                    = false;
+    uint32_t    m_HistoryThreshold                  = 25; // percent increase to report as a regression
+    AString     m_TraceFile;                        // Chrome Trace Event file to write (-trace)
 
     // DB loading/saving
     bool        m_SaveDBOnCompletion                = false;
@@ -12,7 +12,6 @@
 // Core
 #include "Core/FileIO/FileIO.h"
 #include "Core/FileIO/FileStream.h"
-#include "Core/FileIO/MemoryStream.h"
 #include "Core/FileIO/PathUtils.h"
 #include "Core/Math/xxHash.h"
 #include "Core/Strings/AStackString.h"
@@ -223,19 +222,21 @@ DirectoryListNode::~DirectoryListNode() = default;
     }
     else
     {
-        MemoryStream ms;
+        // Hash incrementally rather than gathering everything into a buffer
+        xxHash64Accumulator hash;
         for ( const FileIO::FileInfo & file : m_Files )
         {
             // Include filenames, so additions and removals will change the hash
-            ms.WriteBuffer( file.m_Name.Get(), file.m_Name.GetLength() );
+            hash.Update( file.m_Name.Get(), file.m_Name.GetLength() );
 
             // Include read-only status if desired
             if ( m_IncludeReadOnlyStatusInHash )
             {
-                ms.Write( file.IsReadOnly() );
+                const bool readOnly = file.IsReadOnly();
+                hash.Update( &readOnly, sizeof( readOnly ) );
             }
         }
-        m_Stamp = xxHash::Calc64( ms.GetData(), ms.GetSize() );
+        m_Stamp = hash.Digest();
     }
 
     return NODE_RESULT_OK;
@@ -8,12 +8,21 @@
 #include "Tools/FBuild/FBuildCore/BFF/Functions/Function.h"
 #include "Tools/FBuild/FBuildCore/FBuild.h"
 #include "Tools/FBuild/FBuildCore/FLog.h"
+#include "Tools/FBuild/FBuildCore/Graph/CompilerNode.h"
 #include "Tools/FBuild/FBuildCore/Graph/NodeGraph.h"
 #include "Tools/FBuild/FBuildCore/Graph/DirectoryListNode.h"
+#include "Tools/FBuild/FBuildCore/Graph/SettingsNode.h"
+#include "Tools/FBuild/FBuildCore/Helpers/Compressor.h"
+#include "Tools/FBuild/FBuildCore/Helpers/MultiBuffer.h"
+#include "Tools/FBuild/FBuildCore/Helpers/ToolManifest.h"
+#include "Tools/FBuild/FBuildCore/WorkerPool/Job.h"
+#include "Tools/FBuild/FBuildCore/WorkerPool/WorkerThread.h"
 
 #include "Core/Env/ErrorFormat.h"
 #include "Core/FileIO/FileIO.h"
 #include "Core/FileIO/FileStream.h"
+#include "Core/FileIO/IOStream.h"
+#include "Core/FileIO/PathUtils.h"
 #include "Core/Math/Conversions.h"
 #include "Core/Strings/AStackString.h"
 #include "Core/Process/Process.h"
@@ -21,7 +30,7 @@
 // Reflection
 //------------------------------------------------------------------------------
 REFLECT_NODE_BEGIN( ExecNode, Node, MetaName( "ExecOutput" ) + MetaFile() )
-    REFLECT(        m_ExecExecutable,           "ExecExecutable",           MetaFile() )
+    REFLECT(        m_ExecExecutable,           "ExecExecutable",           MetaFile() + MetaAllowNonFile( Node::COMPILER_NODE ) )
     REFLECT_ARRAY(  m_ExecInput,                "ExecInput",                MetaOptional() + MetaFile() )
     REFLECT_ARRAY(  m_ExecInputPath,            "ExecInputPath",            MetaOptional() + MetaPath() )
     REFLECT_ARRAY(  m_ExecInputPattern,         "ExecInputPattern",         MetaOptional() )
@@ -35,6 +44,7 @@ REFLECT_NODE_BEGIN( ExecNode, Node, MetaName( "ExecOutput" ) + MetaFile() )
     REFLECT(        m_ExecAlwaysShowOutput,     "ExecAlwaysShowOutput",     MetaOptional() )
     REFLECT(        m_ExecUseStdOutAsOutput,    "ExecUseStdOutAsOutput",    MetaOptional() )
     REFLECT(        m_ExecAlways,               "ExecAlways",               MetaOptional() )
+    REFLECT(        m_ExecAllowDistribution,    "ExecAllowDistribution",    MetaOptional() )
     REFLECT_ARRAY(  m_PreBuildDependencyNames,  "PreBuildDependencies",     MetaOptional() + MetaFile() + MetaAllowNonFile() )
 
     // Internal State
@@ -50,13 +60,40 @@ ExecNode::ExecNode()
     , m_ExecUseStdOutAsOutput( false )
     , m_ExecAlways( false )
     , m_ExecInputPathRecurse( true )
+    , m_ExecAllowDistribution( false )
     , m_NumExecInputFiles( 0 )
+    , m_Remote( false )
 {
     m_Type = EXEC_NODE;
 
     m_ExecInputPattern.EmplaceBack( "*.*" );
 }
 
+// CONSTRUCTOR (Remote)
+//------------------------------------------------------------------------------
+ExecNode::ExecNode( const AString & outputName,
+                    const AString & arguments,
+                    const AString & workingDir,
+                    const Array< AString > & inputFiles,
+                    int32_t returnCode,
+                    bool alwaysShowOutput,
+                    bool useStdOutAsOutput )
+    : FileNode( outputName, Node::FLAG_NONE )
+    , m_ExecInput( inputFiles )
+    , m_ExecArguments( arguments )
+    , m_ExecWorkingDir( workingDir )
+    , m_ExecReturnCode( returnCode )
+    , m_ExecAlwaysShowOutput( alwaysShowOutput )
+    , m_ExecUseStdOutAsOutput( useStdOutAsOutput )
+    , m_ExecAlways( false )
+    , m_ExecInputPathRecurse( false )
+    , m_ExecAllowDistribution( true )
+    , m_NumExecInputFiles( (uint32_t)inputFiles.GetSize() )
+    , m_Remote( true )
+{
+    m_Type = EXEC_NODE;
+}
+
 // Initialize
 //------------------------------------------------------------------------------
 /*virtual*/ bool ExecNode::Initialize( NodeGraph & nodeGraph, const BFFToken * iter, const Function * function )
@@ -68,8 +105,14 @@ ExecNode::ExecNode()
     }
 
     // .ExecExecutable
+    // (can be a Compiler(), whose manifest allows the process to be distributed)
     Dependencies executable;
-    if ( !Function::GetFileNode( nodeGraph, iter, function, m_ExecExecutable, "ExecExecutable", executable ) )
+    Node * compilerNode = nodeGraph.FindNode( m_ExecExecutable );
+    if ( compilerNode && ( compilerNode->GetType() == Node::COMPILER_NODE ) )
+    {
+        executable.EmplaceBack( compilerNode );
+    }
+    else if ( !Function::GetFileNode( nodeGraph, iter, function, m_ExecExecutable, "ExecExecutable", executable ) )
     {
         return false; // GetFileNode will have emitted an error
     }
@@ -172,21 +215,99 @@ ExecNode::~ExecNode() = default;
 //------------------------------------------------------------------------------
 /*virtual*/ Node::BuildResult ExecNode::DoBuild( Job * job )
 {
-    // If the workingDir is empty, use the current dir for the process
-    const char * workingDir = m_ExecWorkingDir.IsEmpty() ? nullptr : m_ExecWorkingDir.Get();
+    // can we do the work remotely?
+    const bool belowMemoryLimit = ( ( Job::GetTotalLocalDataMemoryUsage() / MEGABYTE ) < FBuild::Get().GetSettings()->GetDistributableJobMemoryLimitMiB() );
+    if ( CanBeDistributed() && belowMemoryLimit )
+    {
+        if ( PackInputFilesForDistribution( job ) == false )
+        {
+            return NODE_RESULT_FAILED; // PackInputFilesForDistribution will have emitted an error
+        }
+
+        // yes... re-queue for secondary build
+        return NODE_RESULT_NEED_SECOND_BUILD_PASS;
+    }
+
+    // can't do the work remotely, so do it right now
+    const bool stealingRemoteJob = false; // never queued
+    const bool racingRemoteJob = false;
+    return DoExec( job, stealingRemoteJob, racingRemoteJob );
+}
+
+// DoBuild2
+//------------------------------------------------------------------------------
+/*virtual*/ Node::BuildResult ExecNode::DoBuild2( Job * job, bool racingRemoteJob )
+{
+    if ( job->IsLocal() )
+    {
+        const bool stealingRemoteJob = true; // queued for distribution, but built locally
+        return DoExec( job, stealingRemoteJob, racingRemoteJob );
+    }
+
+    // write the inputs to the local temp dir
+    if ( ExtractRemoteInputFiles( job ) == false )
+    {
+        return NODE_RESULT_FAILED; // ExtractRemoteInputFiles will have emitted an error
+    }
+
+    const BuildResult result = DoExec( job, false, false );
+
+    // cleanup inputs
+    for ( const AString & inputFile : m_ExecInput )
+    {
+        FileIO::FileDelete( inputFile.Get() );
+    }
+
+    return result;
+}
+
+// DoExec
+//------------------------------------------------------------------------------
+Node::BuildResult ExecNode::DoExec( Job * job, bool stealingRemoteJob, bool racingRemoteJob )
+{
+    const bool isRemote = ( job->IsLocal() == false );
+
+    // Use the remotely synchronized executable if building remotely
+    AStackString<> executable;
+    AStackString<> workingDir( m_ExecWorkingDir );
+    const char * environmentString = nullptr;
+    if ( isRemote )
+    {
+        ASSERT( job->GetToolManifest() );
+        job->GetToolManifest()->GetRemoteFilePath( 0, executable );
+        environmentString = job->GetToolManifest()->GetRemoteEnvironmentString();
+
+        // Run from the job's temp dir (where the inputs are), recreating the
+        // working dir relative to it
+        WorkerThread::GetTempFileDirectory( workingDir );
+        workingDir += m_ExecWorkingDir;
+        if ( FileIO::EnsurePathExists( workingDir ) == false )
+        {
+            job->Error( "Failed to create working dir. Error: %s Dir: '%s' Target: '%s'", LAST_ERROR_STR, workingDir.Get(), GetName().Get() );
+            job->OnSystemError();
+            return NODE_RESULT_FAILED;
+        }
+    }
+    else
+    {
+        executable = GetExecutable();
+        const CompilerNode * compiler = GetCompiler();
+        environmentString = compiler ? compiler->GetEnvironmentString() : FBuild::Get().GetEnvironmentString();
+    }
 
     // Format compiler args string
     AStackString< 4 * KILOBYTE > fullArgs;
     GetFullArgs(fullArgs);
 
-    EmitCompilationMessage( fullArgs );
+    EmitCompilationMessage( executable, fullArgs, stealingRemoteJob, racingRemoteJob, isRemote );
 
     // spawn the process
-    Process p( FBuild::Get().GetAbortBuildPointer() );
-    bool spawnOK = p.Spawn( GetExecutable()->GetName().Get(),
+    // (If the workingDir is empty, use the current dir for the process)
+    Process p( FBuild::GetAbortBuildPointer(), job->GetAbortFlagPointer() );
+    bool spawnOK = p.Spawn( executable.Get(),
                             fullArgs.Get(),
-                            workingDir,
-                            FBuild::Get().GetEnvironmentString() );
+                            workingDir.IsEmpty() ? nullptr : workingDir.Get(),
+                            environmentString );
 
     if ( !spawnOK )
     {
@@ -195,7 +316,8 @@ ExecNode::~ExecNode() = default;
             return NODE_RESULT_FAILED;
         }
 
-        FLOG_ERROR( "Failed to spawn process for '%s'", GetName().Get() );
+        job->Error( "Failed to spawn process for '%s'", GetName().Get() );
+        job->OnSystemError();
         return NODE_RESULT_FAILED;
     }
 
@@ -211,11 +333,12 @@ ExecNode::~ExecNode() = default;
         return NODE_RESULT_FAILED;
     }
     const bool buildFailed = ( result != m_ExecReturnCode );
-    
+
     // Print output if appropriate
+    // (for remote jobs, output is returned with the job)
     if ( buildFailed ||
         m_ExecAlwaysShowOutput ||
-        FBuild::Get().GetOptions().m_ShowCommandOutput )
+        ( !isRemote && FBuild::Get().GetOptions().m_ShowCommandOutput ) )
     {
         Node::DumpOutput( job, memOut );
         Node::DumpOutput( job, memErr );
@@ -224,7 +347,7 @@ ExecNode::~ExecNode() = default;
     // did the executable fail?
     if ( buildFailed )
     {
-        FLOG_ERROR( "Execution failed. Error: %s Target: '%s'", ERROR_STR( result ), GetName().Get() );
+        job->Error( "Execution failed. Error: %s Target: '%s'", ERROR_STR( result ), GetName().Get() );
         return NODE_RESULT_FAILED;
     }
 
@@ -241,30 +364,226 @@ ExecNode::~ExecNode() = default;
     }
 
     // record new file time
-    RecordStampFromBuiltFile();
+    if ( !isRemote )
+    {
+        RecordStampFromBuiltFile();
+    }
 
     return NODE_RESULT_OK;
 }
 
+// CanBeDistributed
+//------------------------------------------------------------------------------
+bool ExecNode::CanBeDistributed() const
+{
+    // Only processes launched via a distributable Compiler() can be
+    // distributed, as the Compiler() manifest defines the files to sync
+    const CompilerNode * compiler = GetCompiler();
+    if ( ( m_ExecAllowDistribution == false ) ||
+         ( compiler == nullptr ) ||
+         ( compiler->CanBeDistributed() == false ) ||
+         ( FBuild::Get().GetOptions().m_AllowDistributed == false ) )
+    {
+        return false;
+    }
+
+    // All inputs must be sent with the job
+    Array< AString > inputFiles;
+    GetInputFileNames( inputFiles );
+    return ( inputFiles.GetSize() <= MultiBuffer::MAX_FILES );
+}
+
+// PackInputFilesForDistribution
+//------------------------------------------------------------------------------
+bool ExecNode::PackInputFilesForDistribution( Job * job ) const
+{
+    Array< AString > inputFiles;
+    GetInputFileNames( inputFiles );
+
+    MultiBuffer mb;
+    size_t problemFileIndex = 0;
+    if ( !mb.CreateFromFiles( inputFiles, &problemFileIndex ) )
+    {
+        job->Error( "Failed to read input file. Error: %s File: '%s' Target: '%s'", LAST_ERROR_STR, inputFiles[ problemFileIndex ].Get(), GetName().Get() );
+        return false;
+    }
+
+    // compress job data
+    const int32_t compressionLevel = FBuild::Get().GetDistributionCompressionLevel();
+    Compressor c;
+    c.Compress( mb.GetData(), (size_t)mb.GetDataSize(), compressionLevel );
+    size_t compressedSize = c.GetResultSize();
+    job->OwnData( c.ReleaseResult(), compressedSize, true, compressionLevel );
+    return true;
+}
+
+// ExtractRemoteInputFiles
+//------------------------------------------------------------------------------
+bool ExecNode::ExtractRemoteInputFiles( Job * job )
+{
+    ASSERT( m_Remote );
+
+    const void * data = job->GetData();
+    size_t dataSize = job->GetDataSize();
+
+    // handle compressed data
+    Compressor c; // scoped here so we can access decompression buffer
+    if ( job->IsDataCompressed() )
+    {
+        VERIFY( c.Decompress( data ) );
+        data = c.GetResult();
+        dataSize = c.GetResultSize();
+    }
+
+    // Inputs are written to the temp dir, prefixed with their index to avoid
+    // collisions between files with the same name, and the args are updated
+    // to reference the local copies
+    MultiBuffer mb( data, dataSize );
+    for ( size_t i = 0; i < m_ExecInput.GetSize(); ++i )
+    {
+        AString & inputFile = m_ExecInput[ i ];
+        const char * lastSlash = inputFile.FindLast( NATIVE_SLASH );
+
+        AStackString<> fileName;
+        fileName.Format( "%u_%s", (uint32_t)i, lastSlash ? ( lastSlash + 1 ) : inputFile.Get() );
+
+        AStackString<> tmpFileName;
+        WorkerThread::CreateTempFilePath( fileName.Get(), tmpFileName );
+        if ( mb.ExtractFile( i, tmpFileName ) == false )
+        {
+            job->Error( "Failed to write to temp file. Error: %s TmpFile: '%s' Target: '%s'", LAST_ERROR_STR, tmpFileName.Get(), GetName().Get() );
+            job->OnSystemError();
+            return false;
+        }
+        inputFile = tmpFileName;
+    }
+
+    // On remote workers, free compressed buffer as we don't need it anymore
+    job->OwnData( nullptr, 0, false );
+
+    return true;
+}
+
+// GetExecutable
+//------------------------------------------------------------------------------
+const AString & ExecNode::GetExecutable() const
+{
+    const Node * node = m_StaticDependencies[ 0 ].GetNode();
+    if ( node->GetType() == Node::COMPILER_NODE )
+    {
+        return node->CastTo< CompilerNode >()->GetExecutable();
+    }
+    return node->GetName();
+}
+
+// GetCompiler
+//------------------------------------------------------------------------------
+CompilerNode * ExecNode::GetCompiler() const
+{
+    // no dependencies if executing remotely
+    if ( m_StaticDependencies.IsEmpty() )
+    {
+        return nullptr;
+    }
+    Node * node = m_StaticDependencies[ 0 ].GetNode();
+    return ( node->GetType() == Node::COMPILER_NODE ) ? node->CastTo< CompilerNode >() : nullptr;
+}
+
+// GetRemoteToolManifest
+//------------------------------------------------------------------------------
+/*virtual*/ const ToolManifest * ExecNode::GetRemoteToolManifest() const
+{
+    const CompilerNode * compiler = GetCompiler();
+    return compiler ? &compiler->GetManifest() : nullptr;
+}
+
+// SaveRemote
+//------------------------------------------------------------------------------
+/*virtual*/ void ExecNode::SaveRemote( IOStream & stream ) const
+{
+    Array< AString > inputFiles;
+    GetInputFileNames( inputFiles );
+
+    // Output is only returned when it would be shown locally
+    const bool alwaysShowOutput = ( m_ExecAlwaysShowOutput || FBuild::Get().GetOptions().m_ShowCommandOutput );
+
+    // The working dir is recreated on the worker relative to the job's temp dir,
+    // so only the part within the current dir is meaningful there
+    AStackString<> workingDir;
+    if ( m_ExecWorkingDir.IsEmpty() == false )
+    {
+        AStackString<> currentDir;
+        VERIFY( FileIO::GetCurrentDir( currentDir ) );
+        PathUtils::GetRelativePath( currentDir, m_ExecWorkingDir, workingDir );
+        if ( workingDir.BeginsWith( ".." ) || PathUtils::IsFullPath( workingDir ) )
+        {
+            workingDir.Clear(); // outside of the current dir - use the temp dir itself
+        }
+    }
+
+    // Save minimal information for the remote worker
+    stream.Write( m_Name );
+    stream.Write( m_ExecArguments );
+    stream.Write( workingDir );
+    stream.Write( inputFiles );
+    stream.Write( m_ExecReturnCode );
+    stream.Write( alwaysShowOutput );
+    stream.Write( m_ExecUseStdOutAsOutput );
+}
+
+// LoadRemote
+//------------------------------------------------------------------------------
+/*static*/ Node * ExecNode::LoadRemote( IOStream & stream )
+{
+    AStackString<> name;
+    AStackString<> arguments;
+    AStackString<> workingDir;
+    Array< AString > inputFiles;
+    int32_t returnCode;
+    bool alwaysShowOutput;
+    bool useStdOutAsOutput;
+    if ( ( stream.Read( name ) == false ) ||
+         ( stream.Read( arguments ) == false ) ||
+         ( stream.Read( workingDir ) == false ) ||
+         ( stream.Read( inputFiles ) == false ) ||
+         ( stream.Read( returnCode ) == false ) ||
+         ( stream.Read( alwaysShowOutput ) == false ) ||
+         ( stream.Read( useStdOutAsOutput ) == false ) )
+    {
+        return nullptr;
+    }
+
+    return FNEW( ExecNode( name, arguments, workingDir, inputFiles, returnCode, alwaysShowOutput, useStdOutAsOutput ) );
+}
+
 // EmitCompilationMessage
 //------------------------------------------------------------------------------
-void ExecNode::EmitCompilationMessage( const AString & args ) const
+void ExecNode::EmitCompilationMessage( const AString & executable, const AString & args, bool stealingRemoteJob, bool racingRemoteJob, bool isRemote ) const
 {
     // basic info
+    // (FBuild is not available on remote workers)
     AStackString< 2048 > output;
-    if ( FBuild::Get().GetOptions().m_ShowCommandSummary )
+    if ( FBuild::IsValid() && FBuild::Get().GetOptions().m_ShowCommandSummary )
     {
         output += "Run: ";
         output += GetName();
+        if ( racingRemoteJob )
+        {
+            output += " <LOCAL RACE>";
+        }
+        else if ( stealingRemoteJob )
+        {
+            output += " <LOCAL>";
+        }
         output += '\n';
     }
 
     // verbose mode
-    if ( FBuild::Get().GetOptions().m_ShowCommandLines )
+    if ( ( FBuild::IsValid() && FBuild::Get().GetOptions().m_ShowCommandLines ) || isRemote )
     {
         AStackString< 1024 > verboseOutput;
         verboseOutput.Format( "%s %s\nWorkingDir: %s\nExpectedReturnCode: %i\n",
-                              GetExecutable()->GetName().Get(),
+                              executable.Get(),
                               args.Get(),
                               m_ExecWorkingDir.Get(),
                               m_ExecReturnCode );
@@ -339,7 +658,34 @@ void ExecNode::GetFullArgs(AString & fullArgs) const
 //------------------------------------------------------------------------------
 void ExecNode::GetInputFiles(AString & fullArgs, const AString & pre, const AString & post) const
 {
+    Array< AString > inputFiles;
+    GetInputFileNames( inputFiles );
+
     bool first = true; // Handle comma separation
+    for ( const AString & inputFile : inputFiles )
+    {
+        if ( !first )
+        {
+            fullArgs += ' ';
+        }
+        fullArgs += pre;
+        fullArgs += inputFile;
+        fullArgs += post;
+        first = false;
+    }
+}
+
+// GetInputFileNames
+//------------------------------------------------------------------------------
+void ExecNode::GetInputFileNames( Array< AString > & inputFiles ) const
+{
+    // remote jobs have no dependencies - inputs were sent with the job
+    if ( m_Remote )
+    {
+        inputFiles = m_ExecInput;
+        return;
+    }
+
     for ( size_t i=1; i < m_StaticDependencies.GetSize(); ++i ) // Note: Skip first dep (exectuable)
     {
         const Dependency & dep = m_StaticDependencies[ i ];
@@ -352,26 +698,12 @@ void ExecNode::GetInputFiles(AString & fullArgs, const AString & pre, const AStr
             const Array< FileIO::FileInfo > & files = dln->GetFiles();
             for ( const FileIO::FileInfo & file : files )
             {
-                if ( !first )
-                {
-                    fullArgs += ' ';
-                }
-                fullArgs += pre;
-                fullArgs += file.m_Name;
-                fullArgs += post;
-                first = false;
+                inputFiles.Append( file.m_Name );
             }
             continue;
         }
 
-        if ( !first )
-        {
-            fullArgs += ' ';
-        }
-        fullArgs += pre;
-        fullArgs += dep.GetNode()->GetName();
-        fullArgs += post;
-        first = false;
+        inputFiles.Append( n->GetName() );
     }
 }
 
@@ -9,6 +9,7 @@
 
 // Forward Declarations
 //------------------------------------------------------------------------------
+class CompilerNode;
 
 // ExecNode
 //------------------------------------------------------------------------------
@@ -18,20 +19,40 @@ class ExecNode : public FileNode
 public:
     explicit ExecNode();
     virtual bool Initialize( NodeGraph & nodeGraph, const BFFToken * iter, const Function * function ) override;
+    // simplified remote constructor
+    explicit ExecNode( const AString & outputName,
+                       const AString & arguments,
+                       const AString & workingDir,
+                       const Array< AString > & inputFiles,
+                       int32_t returnCode,
+                       bool alwaysShowOutput,
+                       bool useStdOutAsOutput );
     virtual ~ExecNode() override;
 
     static inline Node::Type GetTypeS() { return Node::EXEC_NODE; }
 
+    virtual void SaveRemote( IOStream & stream ) const override;
+    static Node * LoadRemote( IOStream & stream );
+    virtual const ToolManifest * GetRemoteToolManifest() const override;
+
 private:
     virtual bool DoDynamicDependencies( NodeGraph & nodeGraph, bool forceClean ) override;
     virtual bool DetermineNeedToBuild( const Dependencies & deps ) const override;
     virtual BuildResult DoBuild( Job * job ) override;
+    virtual BuildResult DoBuild2( Job * job, bool racingRemoteJob ) override;
+
+    BuildResult DoExec( Job * job, bool stealingRemoteJob, bool racingRemoteJob );
+    bool CanBeDistributed() const;
+    bool PackInputFilesForDistribution( Job * job ) const;
+    bool ExtractRemoteInputFiles( Job * job );
 
-    const FileNode * GetExecutable() const { return m_StaticDependencies[0].GetNode()->CastTo< FileNode >(); }
+    const AString & GetExecutable() const;
+    CompilerNode * GetCompiler() const;
+    void GetInputFileNames( Array< AString > & inputFiles ) const;
     void GetFullArgs(AString & fullArgs) const;
     void GetInputFiles(AString & fullArgs, const AString & pre, const AString & post) const;
 
-    void EmitCompilationMessage( const AString & args ) const;
+    void EmitCompilationMessage( const AString & executable, const AString & args, bool stealingRemoteJob, bool racingRemoteJob, bool isRemote ) const;
 
     // Exposed Properties
     AString             m_ExecExecutable;
@@ -48,10 +69,13 @@ private:
     bool                m_ExecUseStdOutAsOutput;
     bool                m_ExecAlways;
     bool                m_ExecInputPathRecurse;
+    bool                m_ExecAllowDistribution;
     Array< AString >    m_PreBuildDependencyNames;
 
     // Internal State
+    // (on remote workers, m_ExecWorkingDir is relative to the job's temp dir)
     uint32_t            m_NumExecInputFiles;
+    bool                m_Remote;
 };
 
 //------------------------------------------------------------------------------
@@ -19,15 +19,22 @@
 #include "Tools/FBuild/FBuildCore/Helpers/Args.h"
 #include "Tools/FBuild/FBuildCore/Helpers/ResponseFile.h"
 #include "Tools/FBuild/FBuildCore/WorkerPool/Job.h"
+#include "Tools/FBuild/FBuildCore/WorkerPool/JobQueue.h"
 
 // Core
 #include "Core/Env/ErrorFormat.h"
 #include "Core/FileIO/FileIO.h"
 #include "Core/FileIO/FileStream.h"
 #include "Core/FileIO/PathUtils.h"
+#include "Core/Math/xxHash.h"
+#include "Core/Process/Atomic.h"
 #include "Core/Process/Process.h"
 #include "Core/Strings/AStackString.h"
 
+// Defines
+//------------------------------------------------------------------------------
+#define LIBRARY_MAX_SHARDS  ( 64 )
+
 // Reflection
 //------------------------------------------------------------------------------
 REFLECT_NODE_BEGIN( LibraryNode, ObjectListNode, MetaName( "LibrarianOutput" ) + MetaFile() )
@@ -40,8 +47,28 @@ REFLECT_NODE_BEGIN( LibraryNode, ObjectListNode, MetaName( "LibrarianOutput" ) +
     REFLECT( m_NumLibrarianAdditionalInputs,    "NumLibrarianAdditionalInputs", MetaHidden() )
     REFLECT( m_LibrarianFlags,                  "LibrarianFlags",               MetaHidden() )
     REFLECT_ARRAY( m_Environment,               "Environment",                  MetaOptional() )
+    REFLECT( m_LibrarianUpdateInPlace,          "LibrarianUpdateInPlace",       MetaOptional() )
+    REFLECT( m_LibrarianShards,                 "LibrarianShards",              MetaOptional() + MetaRange( 1, LIBRARY_MAX_SHARDS ) )
+
+    REFLECT_ARRAY_OF_STRUCT( m_InputStamps,     "InputStamps",  LinkerInputStamp, MetaHidden() + MetaIgnoreForComparison() )
+    REFLECT_ARRAY_OF_STRUCT( m_ShardStamps,     "ShardStamps",  LinkerInputStamp, MetaHidden() + MetaIgnoreForComparison() )
 REFLECT_END( LibraryNode )
 
+// ShardContext - state shared by threads building shards (see RunWithIdleWorkers)
+//------------------------------------------------------------------------------
+struct LibraryNode::ShardContext
+{
+    const LibraryNode *                 m_Node          = nullptr;
+    const Array< Array< AString > > *   m_ShardInputs   = nullptr;
+    const Array< LinkerInputStamp > *   m_ShardStamps   = nullptr;
+    const Array< uint32_t > *           m_ShardsToBuild = nullptr;
+    Array< AString >                    m_StdOut;       // Output of each shard to build
+    Array< AString >                    m_StdErr;
+    Array< int32_t >                    m_Results;      // Exit code of each shard to build
+    volatile bool                       m_Failed        = false;
+    volatile uint32_t                   m_NextIndex     = 0;
+};
+
 // CONSTRUCTOR
 //------------------------------------------------------------------------------
 LibraryNode::LibraryNode()
@@ -101,6 +128,17 @@ LibraryNode::LibraryNode()
 
     m_LibrarianFlags = DetermineFlags( m_LibrarianType, m_Librarian, m_LibrarianOptions );
 
+    // .LibrarianUpdateInPlace
+    if ( m_LibrarianUpdateInPlace && GetFlag( LIB_FLAG_AR ) )
+    {
+        AStackString<> operation;
+        if ( IsReplaceOperation( m_LibrarianOptions, operation ) == false )
+        {
+            Error::Error_1304_LibrarianOperationInvalidForUpdateInPlace( iter, function, operation );
+            return false;
+        }
+    }
+
     return true;
 }
 
@@ -143,35 +181,263 @@ LibraryNode::~LibraryNode()
 //------------------------------------------------------------------------------
 /*virtual*/ Node::BuildResult LibraryNode::DoBuild( Job * job )
 {
+    // Large archives can be built as independent shards
+    if ( GetFlag( LIB_FLAG_AR ) && ( m_LibrarianShards > 1 ) )
+    {
+        return DoBuildShards( job );
+    }
+
+    // Archives can optionally be updated in place, replacing only changed members
+    Array< LinkerInputStamp > inputStamps;
+    Array< AString > changedInputs;
+    bool updateInPlace = false;
+    if ( GetFlag( LIB_FLAG_AR ) && m_LibrarianUpdateInPlace )
+    {
+        GetInputStamps( inputStamps );
+        updateInPlace = DetermineChangedInputs( inputStamps, changedInputs );
+    }
+
     // Delete library from previous build (if present) if:
     // - A clean build is being triggered
     // - A non-msvc librarian is used (librarians like ar can cause duplicate
     //                                symbols because of how they update archives)
+    //   and the archive is not being updated in place
     if ( FBuild::Get().GetOptions().m_ForceCleanBuild ||
-         ( GetFlag( Flag::LIB_FLAG_LIB ) == false ) )
+         ( ( GetFlag( Flag::LIB_FLAG_LIB ) == false ) && ( updateInPlace == false ) ) )
+    {
+        if ( DoPreBuildFileDeletion( GetName() ) == false )
+        {
+            return NODE_RESULT_FAILED; // HandleFileDeletion will have emitted an error
+        }
+    }
+
+    // nothing to update?
+    if ( ( updateInPlace == false ) || ( changedInputs.IsEmpty() == false ) )
+    {
+        // Format compiler args string
+        Args fullArgs;
+        if ( !BuildArgs( fullArgs, updateInPlace ? &changedInputs : nullptr, GetName() ) )
+        {
+            return NODE_RESULT_FAILED; // BuildArgs will have emitted an error
+        }
+
+        EmitCompilationMessage( fullArgs );
+
+        // spawn the process
+        Process p( FBuild::Get().GetAbortBuildPointer() );
+        if ( ( SpawnLibrarian( p, fullArgs ) == false ) ||
+             ( WaitForLibrarian( job, p, GetName() ) == false ) )
+        {
+            return NODE_RESULT_FAILED; // SpawnLibrarian/WaitForLibrarian will have emitted an error
+        }
+    }
+
+    // record members for the next in-place update
+    m_InputStamps.Swap( inputStamps );
+
+    // record new file time
+    RecordStampFromBuiltFile();
+
+    return NODE_RESULT_OK;
+}
+
+// DoBuildShards
+//------------------------------------------------------------------------------
+Node::BuildResult LibraryNode::DoBuildShards( Job * job )
+{
+    Array< LinkerInputStamp > inputStamps;
+    GetInputStamps( inputStamps );
+
+    // Members are assigned to shards by the hash of their name, so adding or
+    // removing members only affects the shards they belong to
+    const uint32_t numShards = m_LibrarianShards;
+    Array< Array< AString > > shardInputs( numShards, false );
+    Array< uint64_t > shardHashes( numShards, false );
+    for ( uint32_t i = 0; i < numShards; ++i )
+    {
+        shardInputs.EmplaceBack();
+        shardHashes.Append( 0 );
+    }
+    for ( const LinkerInputStamp & input : inputStamps )
+    {
+        const uint32_t shardIndex = ( xxHash::Calc32( input.GetFileName() ) % numShards );
+        shardInputs[ shardIndex ].Append( input.GetFileName() );
+        const uint64_t hashData[ 3 ] = { shardHashes[ shardIndex ], xxHash::Calc64( input.GetFileName() ), input.GetStamp() };
+        shardHashes[ shardIndex ] = xxHash::Calc64( hashData, sizeof( hashData ) );
+    }
+
+    // Determine which shards have changed
+    const bool forceClean = FBuild::Get().GetOptions().m_ForceCleanBuild;
+    Array< LinkerInputStamp > shardStamps( numShards, false );
+    Array< uint32_t > shardsToBuild( numShards, false );
+    for ( uint32_t i = 0; i < numShards; ++i )
+    {
+        AStackString<> shardName;
+        GetShardName( i, shardName );
+        shardStamps.EmplaceBack( shardName, shardHashes[ i ] );
+
+        if ( shardInputs[ i ].IsEmpty() )
+        {
+            continue; // nothing in this shard
+        }
+        const bool upToDate = ( forceClean == false ) &&
+                              ( i < m_ShardStamps.GetSize() ) &&
+                              ( m_ShardStamps[ i ].GetFileName() == shardName ) &&
+                              ( m_ShardStamps[ i ].GetStamp() == shardHashes[ i ] ) &&
+                              FileIO::FileExists( shardName.Get() );
+        if ( upToDate == false )
+        {
+            shardsToBuild.Append( i );
+        }
+    }
+    FLOG_VERBOSE( "Library '%s' : %u of %u shards changed\n", GetName().Get(), (uint32_t)shardsToBuild.GetSize(), numShards );
+
+    // Build changed shards in parallel, sharing the work with idle worker threads
+    ShardContext context;
+    context.m_Node = this;
+    context.m_ShardInputs = &shardInputs;
+    context.m_ShardStamps = &shardStamps;
+    context.m_ShardsToBuild = &shardsToBuild;
+    context.m_StdOut.SetSize( shardsToBuild.GetSize() );
+    context.m_StdErr.SetSize( shardsToBuild.GetSize() );
+    context.m_Results.SetSize( shardsToBuild.GetSize() );
+    if ( shardsToBuild.IsEmpty() == false )
+    {
+        if ( JobQueue::IsValid() )
+        {
+            JobQueue::Get().RunWithIdleWorkers( ShardHelperFunc, &context, (uint32_t)( shardsToBuild.GetSize() - 1 ) );
+        }
+        else
+        {
+            BuildShards( context );
+        }
+    }
+    if ( context.m_Failed )
+    {
+        return NODE_RESULT_FAILED; // BuildShard will have emitted an error
+    }
+    bool ok = true;
+    for ( size_t i = 0; i < shardsToBuild.GetSize(); ++i )
+    {
+        const AString & shardName = shardStamps[ shardsToBuild[ i ] ].GetFileName();
+        if ( HandleLibrarianResult( job, context.m_Results[ i ], context.m_StdOut[ i ], context.m_StdErr[ i ], shardName ) == false )
+        {
+            ok = false; // HandleLibrarianResult will have emitted an error
+        }
+    }
+    if ( ok == false )
+    {
+        return NODE_RESULT_FAILED;
+    }
+
+    // The output is a linker script referencing the shards, which GNU ld, gold
+    // and lld accept in place of an archive. GROUP searches the shards
+    // repeatedly, as for the members of a single archive.
+    if ( ( shardsToBuild.IsEmpty() == false ) || forceClean || ( FileIO::FileExists( GetName().Get() ) == false ) )
     {
         if ( DoPreBuildFileDeletion( GetName() ) == false )
         {
             return NODE_RESULT_FAILED; // HandleFileDeletion will have emitted an error
         }
+
+        AStackString< 4096 > script( "/* Auto-generated by FASTBuild - do not modify */\nGROUP(" );
+        for ( uint32_t i = 0; i < numShards; ++i )
+        {
+            if ( shardInputs[ i ].IsEmpty() == false )
+            {
+                script += " \"";
+                script += shardStamps[ i ].GetFileName();
+                script += '"';
+            }
+        }
+        script += " )\n";
+
+        FileStream f;
+        if ( ( f.Open( GetName().Get(), FileStream::WRITE_ONLY ) == false ) ||
+             ( f.WriteBuffer( script.Get(), script.GetLength() ) != script.GetLength() ) )
+        {
+            FLOG_ERROR( "Failed to write Library '%s'", GetName().Get() );
+            return NODE_RESULT_FAILED;
+        }
+        f.Close();
+    }
+
+    // record shard contents for the next build
+    m_ShardStamps.Swap( shardStamps );
+
+    // record new file time
+    RecordStampFromBuiltFile();
+
+    return NODE_RESULT_OK;
+}
+
+// ShardHelperFunc
+//------------------------------------------------------------------------------
+/*static*/ void LibraryNode::ShardHelperFunc( void * userData )
+{
+    ShardContext * context = static_cast< ShardContext * >( userData );
+    context->m_Node->BuildShards( *context );
+}
+
+// BuildShards
+//------------------------------------------------------------------------------
+void LibraryNode::BuildShards( ShardContext & context ) const
+{
+    for ( ;; )
+    {
+        const uint32_t index = ( AtomicIncU32( &context.m_NextIndex ) - 1 );
+        if ( ( index >= context.m_ShardsToBuild->GetSize() ) || AtomicLoadRelaxed( &context.m_Failed ) )
+        {
+            return;
+        }
+        if ( BuildShard( context, index ) == false )
+        {
+            AtomicStoreRelaxed( &context.m_Failed, true );
+            return;
+        }
+    }
+}
+
+// BuildShard
+//------------------------------------------------------------------------------
+bool LibraryNode::BuildShard( ShardContext & context, size_t index ) const
+{
+    const uint32_t shardIndex = ( *context.m_ShardsToBuild )[ index ];
+    const AString & shardName = ( *context.m_ShardStamps )[ shardIndex ].GetFileName();
+    if ( DoPreBuildFileDeletion( shardName ) == false )
+    {
+        return false; // HandleFileDeletion will have emitted an error
     }
 
-    // Format compiler args string
     Args fullArgs;
-    if ( !BuildArgs( fullArgs ) )
+    if ( BuildArgs( fullArgs, &( *context.m_ShardInputs )[ shardIndex ], shardName ) == false )
+    {
+        return false; // BuildArgs will have emitted an error
+    }
+
+    EmitCompilationMessage( fullArgs );
+
+    Process p( FBuild::Get().GetAbortBuildPointer() );
+    if ( SpawnLibrarian( p, fullArgs ) == false )
     {
-        return NODE_RESULT_FAILED; // BuildArgs will have emitted an error
+        return false; // SpawnLibrarian will have emitted an error
     }
 
+    // output is reported by the calling thread, which owns the job
+    p.ReadAllData( context.m_StdOut[ index ], context.m_StdErr[ index ] );
+    context.m_Results[ index ] = p.WaitForExit();
+    return ( p.HasAborted() == false );
+}
+
+// SpawnLibrarian
+//------------------------------------------------------------------------------
+bool LibraryNode::SpawnLibrarian( Process & p, const Args & fullArgs ) const
+{
     // use the exe launch dir as the working dir
     const char * workingDir = nullptr;
 
     const char * environment = Node::GetEnvironmentString( m_Environment, m_EnvironmentString );
 
-    EmitCompilationMessage( fullArgs );
-
-    // spawn the process
-    Process p( FBuild::Get().GetAbortBuildPointer() );
     bool spawnOK = p.Spawn( GetLibrarian()->GetName().Get(),
                             fullArgs.GetFinalArgs().Get(),
                             workingDir,
@@ -181,25 +447,38 @@ LibraryNode::~LibraryNode()
     {
         if ( p.HasAborted() )
         {
-            return NODE_RESULT_FAILED;
+            return false;
         }
 
         FLOG_ERROR( "Failed to spawn process for Library creation for '%s'", GetName().Get() );
-        return NODE_RESULT_FAILED;
+        return false;
     }
+    return true;
+}
 
+// WaitForLibrarian
+//------------------------------------------------------------------------------
+bool LibraryNode::WaitForLibrarian( Job * job, Process & p, const AString & output ) const
+{
     // capture all of the stdout and stderr
     AString memOut;
     AString memErr;
     p.ReadAllData( memOut, memErr );
 
     // Get result
-    int result = p.WaitForExit();
+    const int result = p.WaitForExit();
     if ( p.HasAborted() )
     {
-        return NODE_RESULT_FAILED;
+        return false;
     }
 
+    return HandleLibrarianResult( job, result, memOut, memErr, output );
+}
+
+// HandleLibrarianResult
+//------------------------------------------------------------------------------
+bool LibraryNode::HandleLibrarianResult( Job * job, int result, const AString & memOut, const AString & memErr, const AString & output ) const
+{
     // did the executable fail?
     if ( result != 0 )
     {
@@ -213,8 +492,8 @@ LibraryNode::~LibraryNode()
             job->ErrorPreformatted( memErr.Get() );
         }
 
-        FLOG_ERROR( "Failed to build Library. Error: %s Target: '%s'", ERROR_STR( result ), GetName().Get() );
-        return NODE_RESULT_FAILED;
+        FLOG_ERROR( "Failed to build Library. Error: %s Target: '%s'", ERROR_STR( result ), output.Get() );
+        return false;
     }
     else
     {
@@ -222,19 +501,15 @@ LibraryNode::~LibraryNode()
         // (since compilation will fail anyway, and the output will be shown)
         if ( GetFlag( LIB_FLAG_LIB ) && !GetFlag( LIB_FLAG_WARNINGS_AS_ERRORS_MSVC ) )
         {
-            FileNode::HandleWarningsMSVC( job, GetName(), memOut );
+            FileNode::HandleWarningsMSVC( job, output, memOut );
         }
     }
-
-    // record new file time
-    RecordStampFromBuiltFile();
-
-    return NODE_RESULT_OK;
+    return true;
 }
 
 // BuildArgs
 //------------------------------------------------------------------------------
-bool LibraryNode::BuildArgs( Args & fullArgs ) const
+bool LibraryNode::BuildArgs( Args & fullArgs, const Array< AString > * inputFiles, const AString & outputFile ) const
 {
     Array< AString > tokens( 1024, true );
     m_LibrarianOptions.Tokenize( tokens );
@@ -257,7 +532,19 @@ bool LibraryNode::BuildArgs( Args & fullArgs ) const
             }
 
             // concatenate files, unquoted
-            GetInputFiles( fullArgs, pre, AString::GetEmpty(), objectsInsteadOfLibs );
+            if ( inputFiles )
+            {
+                for ( const AString & inputFile : *inputFiles )
+                {
+                    fullArgs += pre;
+                    fullArgs += inputFile;
+                    fullArgs.AddDelimiter();
+                }
+            }
+            else
+            {
+                GetInputFiles( fullArgs, pre, AString::GetEmpty(), objectsInsteadOfLibs );
+            }
         }
         else if ( token.EndsWith( "\"%1\"" ) )
         {
@@ -266,7 +553,20 @@ bool LibraryNode::BuildArgs( Args & fullArgs ) const
             AStackString<> post( "\"" );
 
             // concatenate files, quoted
-            GetInputFiles( fullArgs, pre, post, objectsInsteadOfLibs );
+            if ( inputFiles )
+            {
+                for ( const AString & inputFile : *inputFiles )
+                {
+                    fullArgs += pre;
+                    fullArgs += inputFile;
+                    fullArgs += post;
+                    fullArgs.AddDelimiter();
+                }
+            }
+            else
+            {
+                GetInputFiles( fullArgs, pre, post, objectsInsteadOfLibs );
+            }
         }
         else if ( token.EndsWith( "%2" ) )
         {
@@ -275,14 +575,14 @@ bool LibraryNode::BuildArgs( Args & fullArgs ) const
             {
                 fullArgs += AStackString<>( token.Get(), token.GetEnd() - 2 );
             }
-            fullArgs += m_Name;
+            fullArgs += outputFile;
         }
         else if ( token.EndsWith( "\"%2\"" ) )
         {
             // handle /Option:"%2" -> /Option:"A"
             AStackString<> pre( token.Get(), token.GetEnd() - 3 ); // 3 instead of 4 to include quote
             fullArgs += pre;
-            fullArgs += m_Name;
+            fullArgs += outputFile;
             fullArgs += '"'; // post
         }
         else
@@ -300,7 +600,7 @@ bool LibraryNode::BuildArgs( Args & fullArgs ) const
     }
 
     // Handle all the special needs of args
-    if ( fullArgs.Finalize( GetLibrarian()->GetName(), GetName(), CanUseResponseFile() ) == false )
+    if ( fullArgs.Finalize( GetLibrarian()->GetName(), outputFile, CanUseResponseFile() ) == false )
     {
         return false; // Finalize will have emitted an error
     }
@@ -308,6 +608,163 @@ bool LibraryNode::BuildArgs( Args & fullArgs ) const
     return true;
 }
 
+// GetInputStamps
+//------------------------------------------------------------------------------
+void LibraryNode::GetInputStamps( Array< LinkerInputStamp > & stamps ) const
+{
+    stamps.SetCapacity( m_DynamicDependencies.GetSize() );
+    for ( Dependencies::Iter it = m_DynamicDependencies.Begin(); it != m_DynamicDependencies.End(); it++ )
+    {
+        GetInputStamps( it->GetNode(), stamps );
+    }
+}
+
+// GetInputStamps
+//------------------------------------------------------------------------------
+void LibraryNode::GetInputStamps( const Node * n, Array< LinkerInputStamp > & stamps ) const
+{
+    // objects from additional lists and libs are merged (see ObjectListNode::GetInputFiles)
+    if ( ( n->GetType() == Node::OBJECT_LIST_NODE ) || ( n->GetType() == Node::LIBRARY_NODE ) )
+    {
+        const Dependencies & objects = n->GetDynamicDependencies();
+        for ( Dependencies::Iter it = objects.Begin(); it != objects.End(); it++ )
+        {
+            GetInputStamps( it->GetNode(), stamps );
+        }
+        return;
+    }
+
+    // handle pch files - get path to matching object
+    if ( n->GetType() == Node::OBJECT_NODE )
+    {
+        const ObjectNode * on = n->CastTo< ObjectNode >();
+        if ( on->IsCreatingPCH() )
+        {
+            if ( on->IsMSVC() )
+            {
+                stamps.EmplaceBack( on->GetPCHObjectName(), n->GetStamp() );
+            }
+            return; // Clang/GCC/SNC don't have an object to link for a pch
+        }
+    }
+
+    stamps.EmplaceBack( n->GetName(), n->GetStamp() );
+}
+
+// DetermineChangedInputs
+//------------------------------------------------------------------------------
+bool LibraryNode::DetermineChangedInputs( const Array< LinkerInputStamp > & stamps, Array< AString > & outChangedInputs ) const
+{
+    // Is there an archive to update?
+    if ( FBuild::Get().GetOptions().m_ForceCleanBuild ||
+         m_InputStamps.IsEmpty() ||
+         ( FileIO::FileExists( GetName().Get() ) == false ) )
+    {
+        return false;
+    }
+
+    const size_t numPrevious = LinkerInputStamp::FindChanged( m_InputStamps, stamps, outChangedInputs );
+
+    // Removing members requires a rebuild
+    if ( numPrevious != m_InputStamps.GetSize() )
+    {
+        FLOG_VERBOSE( "Library '%s' : members removed, rebuilding\n", GetName().Get() );
+        return false;
+    }
+
+    // ar replaces members by file name, so names must be unique
+    Array< AString > memberNames( stamps.GetSize(), false );
+    for ( const LinkerInputStamp & stamp : stamps )
+    {
+        const char * lastSlash = stamp.GetFileName().FindLast( NATIVE_SLASH );
+        memberNames.EmplaceBack( lastSlash ? ( lastSlash + 1 ) : stamp.GetFileName().Get() );
+    }
+    memberNames.Sort();
+    for ( size_t i = 1; i < memberNames.GetSize(); ++i )
+    {
+        if ( memberNames[ i ] == memberNames[ i - 1 ] )
+        {
+            FLOG_VERBOSE( "Library '%s' : duplicate member '%s', rebuilding\n", GetName().Get(), memberNames[ i ].Get() );
+            return false;
+        }
+    }
+
+    FLOG_VERBOSE( "Library '%s' : updating %u of %u members in place\n", GetName().Get(), (uint32_t)outChangedInputs.GetSize(), (uint32_t)stamps.GetSize() );
+    return true;
+}
+
+// IsReplaceOperation
+//------------------------------------------------------------------------------
+/*static*/ bool LibraryNode::IsReplaceOperation( const AString & librarianOptions, AString & outOperation )
+{
+    // ar args start with the operation and its modifiers (e.g. "rcs" or "-rcs")
+    Array< AString > tokens;
+    librarianOptions.Tokenize( tokens );
+    if ( tokens.IsEmpty() )
+    {
+        return false;
+    }
+    outOperation = tokens[ 0 ];
+
+    // Updating in place passes only changed members, so they must replace the
+    // existing ones. Modifiers which don't affect that are allowed.
+    bool replace = false;
+    const char * pos = outOperation.Get();
+    if ( *pos == '-' )
+    {
+        ++pos;
+    }
+    for ( ; *pos; ++pos )
+    {
+        switch ( *pos )
+        {
+            case 'r':   replace = true; break;
+            case 'c':   // create
+            case 's':   // write symbol table
+            case 'S':   // no symbol table
+            case 'D':   // deterministic
+            case 'U':   // non-deterministic
+            case 'u':   // only replace newer members
+            case 'v':   // verbose
+                break;
+            default:    return false;
+        }
+    }
+    return replace;
+}
+
+// GetShardName
+//------------------------------------------------------------------------------
+void LibraryNode::GetShardName( uint32_t shardIndex, AString & shardName ) const
+{
+    // <name>.shard<N><ext> - e.g. libCore.shard1.a
+    const char * lastSlash = GetName().FindLast( NATIVE_SLASH );
+    const char * lastDot = GetName().FindLast( '.' );
+    if ( lastDot && lastSlash && ( lastDot < lastSlash ) )
+    {
+        lastDot = nullptr; // dot is in the path, not the file name
+    }
+    shardName.Assign( GetName().Get(), lastDot ? lastDot : GetName().GetEnd() );
+    shardName.AppendFormat( ".shard%u", shardIndex + 1 );
+    if ( lastDot )
+    {
+        shardName += lastDot;
+    }
+}
+
+// Migrate
+//------------------------------------------------------------------------------
+/*virtual*/ void LibraryNode::Migrate( const Node & oldNode )
+{
+    // Migrate Node level properties
+    ObjectListNode::Migrate( oldNode );
+
+    // Migrate state of previous build
+    const LibraryNode * oldLibraryNode = oldNode.CastTo< LibraryNode >();
+    m_InputStamps = oldLibraryNode->m_InputStamps;
+    m_ShardStamps = oldLibraryNode->m_ShardStamps;
+}
+
 // DetermineFlags
 //------------------------------------------------------------------------------
 /*static*/ uint32_t LibraryNode::DetermineFlags( const AString & librarianType, const AString & librarianName, const AString & args )
@@ -5,6 +5,7 @@
 // Includes
 //------------------------------------------------------------------------------
 #include "ObjectListNode.h"
+#include "LinkerNode.h"
 #include "Core/Containers/Array.h"
 
 // Forward Declarations
@@ -14,6 +15,7 @@ class CompilerNode;
 class Function;
 class NodeGraph;
 class ObjectNode;
+class Process;
 
 // LibraryNode
 //------------------------------------------------------------------------------
@@ -38,14 +40,31 @@ public:
         LIB_FLAG_WARNINGS_AS_ERRORS_MSVC = 0x10,
     };
     static uint32_t DetermineFlags( const AString & librarianType, const AString & librarianName, const AString & args );
+    static bool IsReplaceOperation( const AString & librarianOptions, AString & outOperation );
 private:
     friend class FunctionLibrary;
 
     virtual bool GatherDynamicDependencies( NodeGraph & nodeGraph, bool forceClean ) override;
     virtual BuildResult DoBuild( Job * job ) override;
+    virtual void Migrate( const Node & oldNode ) override;
+
+    BuildResult DoBuildShards( Job * job );
+    bool SpawnLibrarian( Process & p, const Args & fullArgs ) const;
+    bool WaitForLibrarian( Job * job, Process & p, const AString & output ) const;
+    bool HandleLibrarianResult( Job * job, int result, const AString & memOut, const AString & memErr, const AString & output ) const;
+
+    // shards are built by the calling thread and any idle worker threads
+    struct ShardContext;
+    static void ShardHelperFunc( void * userData );
+    void BuildShards( ShardContext & context ) const;
+    bool BuildShard( ShardContext & context, size_t index ) const;
 
     // internal helpers
-    bool BuildArgs( Args & fullArgs ) const;
+    bool BuildArgs( Args & fullArgs, const Array< AString > * inputFiles, const AString & outputFile ) const;
+    void GetInputStamps( Array< LinkerInputStamp > & stamps ) const;
+    void GetInputStamps( const Node * n, Array< LinkerInputStamp > & stamps ) const;
+    bool DetermineChangedInputs( const Array< LinkerInputStamp > & stamps, Array< AString > & outChangedInputs ) const;
+    void GetShardName( uint32_t shardIndex, AString & shardName ) const;
     void EmitCompilationMessage( const Args & fullArgs ) const;
     FileNode * GetLibrarian() const;
 
@@ -60,10 +79,14 @@ private:
     AString             m_LibrarianOutput;
     Array< AString >    m_LibrarianAdditionalInputs;
     Array< AString >    m_Environment;
+    bool                m_LibrarianUpdateInPlace        = false;
+    uint32_t            m_LibrarianShards               = 1;
 
     // Internal State
     uint32_t            m_NumLibrarianAdditionalInputs  = 0;
     uint32_t            m_LibrarianFlags                = 0;
+    Array< LinkerInputStamp > m_InputStamps;            // Members as of the last successful build (in-place updates)
+    Array< LinkerInputStamp > m_ShardStamps;            // Hash of the members of each shard
     mutable const char * m_EnvironmentString            = nullptr;
 };
 
@@ -23,9 +23,13 @@
 #include "Core/Env/ErrorFormat.h"
 #include "Core/FileIO/FileIO.h"
 #include "Core/FileIO/PathUtils.h"
+#include "Core/Math/xxHash.h"
 #include "Core/Process/Process.h"
 #include "Core/Profile/Profile.h"
 #include "Core/Strings/AStackString.h"
+#include "Core/Time/Timer.h"
+
+#include <string.h> // for memset
 
 // Reflection
 //------------------------------------------------------------------------------
@@ -46,8 +50,102 @@ REFLECT_NODE_BEGIN( LinkerNode, Node, MetaName( "LinkerOutput" ) + MetaFile() )
     REFLECT( m_AssemblyResourcesStartIndex,     "AssemblyResourcesStartIndex",  MetaHidden() )
     REFLECT( m_AssemblyResourcesNum,            "AssemblyResourcesNum",         MetaHidden() )
     REFLECT( m_ImportLibName,                   "ImportLibName",                MetaHidden() )
+    REFLECT_ARRAY_OF_STRUCT( m_InputStamps,     "InputStamps",  LinkerInputStamp, MetaHidden() + MetaIgnoreForComparison() )
+    REFLECT( m_FullLinkTimeMS,                  "FullLinkTimeMS",               MetaHidden() + MetaIgnoreForComparison() )
 REFLECT_END( LinkerNode )
 
+REFLECT_STRUCT_BEGIN( LinkerInputStamp, Struct, MetaNone() )
+    REFLECT( m_FileName,                        "FileName",                     MetaHidden() )
+    REFLECT( m_Stamp,                           "Stamp",                        MetaHidden() )
+REFLECT_END( LinkerInputStamp )
+
+// CONSTRUCTOR (LinkerInputStamp)
+//------------------------------------------------------------------------------
+LinkerInputStamp::LinkerInputStamp() = default;
+
+// CONSTRUCTOR (LinkerInputStamp)
+//------------------------------------------------------------------------------
+LinkerInputStamp::LinkerInputStamp( const AString & fileName, uint64_t stamp )
+    : m_FileName( fileName )
+    , m_Stamp( stamp )
+{
+}
+
+// DESTRUCTOR (LinkerInputStamp)
+//------------------------------------------------------------------------------
+LinkerInputStamp::~LinkerInputStamp() = default;
+
+// FindChanged
+//------------------------------------------------------------------------------
+/*static*/ size_t LinkerInputStamp::FindChanged( const Array< LinkerInputStamp > & previous,
+                                                 const Array< LinkerInputStamp > & current,
+                                                 Array< AString > & outChanged )
+{
+    // Previous inputs by file name, built only if the order has changed
+    // (open addressing, storing index + 1 with 0 for empty slots)
+    Array< uint32_t > slots;
+    size_t slotMask = 0;
+
+    size_t numPrevious = 0;
+    for ( size_t i = 0; i < current.GetSize(); ++i )
+    {
+        const LinkerInputStamp & stamp = current[ i ];
+        const LinkerInputStamp * prev = nullptr;
+
+        // Inputs are typically in the same order as the last build
+        if ( ( i < previous.GetSize() ) && ( previous[ i ].GetFileName() == stamp.GetFileName() ) )
+        {
+            prev = &previous[ i ];
+        }
+        else if ( previous.IsEmpty() == false )
+        {
+            if ( slots.IsEmpty() )
+            {
+                size_t numSlots = 16;
+                while ( numSlots < ( previous.GetSize() * 2 ) )
+                {
+                    numSlots *= 2;
+                }
+                slots.SetSize( numSlots );
+                memset( slots.Begin(), 0, numSlots * sizeof( uint32_t ) );
+                slotMask = ( numSlots - 1 );
+                for ( size_t j = 0; j < previous.GetSize(); ++j )
+                {
+                    size_t slot = ( xxHash::Calc32( previous[ j ].GetFileName() ) & slotMask );
+                    while ( slots[ slot ] != 0 )
+                    {
+                        slot = ( ( slot + 1 ) & slotMask );
+                    }
+                    slots[ slot ] = (uint32_t)( j + 1 );
+                }
+            }
+
+            size_t slot = ( xxHash::Calc32( stamp.GetFileName() ) & slotMask );
+            while ( slots[ slot ] != 0 )
+            {
+                const LinkerInputStamp & other = previous[ slots[ slot ] - 1 ];
+                if ( other.GetFileName() == stamp.GetFileName() )
+                {
+                    prev = &other;
+                    break;
+                }
+                slot = ( ( slot + 1 ) & slotMask );
+            }
+        }
+
+        if ( prev )
+        {
+            ++numPrevious;
+            if ( prev->GetStamp() == stamp.GetStamp() )
+            {
+                continue; // unchanged
+            }
+        }
+        outChanged.Append( stamp.GetFileName() );
+    }
+    return numPrevious;
+}
+
 // CONSTRUCTOR
 //------------------------------------------------------------------------------
 LinkerNode::LinkerNode()
@@ -166,6 +264,18 @@ LinkerNode::~LinkerNode()
 //------------------------------------------------------------------------------
 /*virtual*/ Node::BuildResult LinkerNode::DoBuild( Job * job )
 {
+    // Determine which inputs changed since the last successful link
+    Array< LinkerInputStamp > inputStamps;
+    GetInputStamps( inputStamps );
+    DetermineChangedInputs( inputStamps );
+
+    // An incremental link can reuse the state of the previous link, if there is one
+    m_LinkedIncrementally = ( GetFlag( LINK_FLAG_INCREMENTAL ) &&
+                              ( FBuild::Get().GetOptions().m_ForceCleanBuild == false ) &&
+                              ( m_InputStamps.IsEmpty() == false ) &&
+                              FileIO::FileExists( GetName().Get() ) );
+    m_IncrementalLinkTimeSavedMS = 0;
+
     if ( DoPreLinkCleanup() == false )
     {
         return NODE_RESULT_FAILED; // BuildArgs will have emitted an error
@@ -200,6 +310,7 @@ LinkerNode::~LinkerNode()
 
     // we retry if linker crashes
     uint32_t attempt( 0 );
+    const Timer linkTimer;
 
     for (;;)
     {
@@ -304,6 +415,18 @@ LinkerNode::~LinkerNode()
         }
     }
 
+    // Track the cost of full links to determine the savings of incremental ones
+    const uint32_t linkTimeMS = (uint32_t)linkTimer.GetElapsedMS();
+    if ( m_LinkedIncrementally )
+    {
+        m_IncrementalLinkTimeSavedMS = ( m_FullLinkTimeMS > linkTimeMS ) ? ( m_FullLinkTimeMS - linkTimeMS ) : 0;
+        FLOG_VERBOSE( "Incremental link of '%s' : %u ms (%u ms saved)\n", GetName().Get(), linkTimeMS, m_IncrementalLinkTimeSavedMS );
+    }
+    else
+    {
+        m_FullLinkTimeMS = linkTimeMS;
+    }
+
     // post-link stamp step
     if ( m_LinkerStampExe.IsEmpty() == false )
     {
@@ -361,6 +484,9 @@ LinkerNode::~LinkerNode()
     // record new file time
     RecordStampFromBuiltFile();
 
+    // Inputs are now up-to-date with the linked output
+    m_InputStamps.Swap( inputStamps );
+
     return NODE_RESULT_OK;
 }
 
@@ -371,6 +497,12 @@ bool LinkerNode::DoPreLinkCleanup() const
     // only for Microsoft compilers
     if ( GetFlag( LINK_FLAG_MSVC ) == false )
     {
+        // incremental linkers (such as gold) update the existing output, so
+        // remove it to force a full re-link
+        if ( GetFlag( LINK_FLAG_INCREMENTAL ) && FBuild::Get().GetOptions().m_ForceCleanBuild )
+        {
+            return DoPreBuildFileDeletion( GetName() );
+        }
         return true;
     }
 
@@ -454,6 +586,17 @@ bool LinkerNode::BuildArgs( Args & fullArgs ) const
             continue;
         }
 
+        // %4 -> Input files changed since the last link
+        found = token.Find( "%4" );
+        if ( found )
+        {
+            AStackString<> pre( token.Get(), found );
+            AStackString<> post( found + 2, token.GetEnd() );
+            GetChangedInputFiles( fullArgs, pre, post );
+            fullArgs.AddDelimiter();
+            continue;
+        }
+
         if ( GetFlag( LINK_FLAG_MSVC ) )
         {
             // %3 -> AssemblyResources
@@ -616,6 +759,100 @@ void LinkerNode::GetAssemblyResourceFiles( Args & fullArgs, const AString & pre,
     }
 }
 
+// GetChangedInputFiles
+//------------------------------------------------------------------------------
+void LinkerNode::GetChangedInputFiles( Args & fullArgs, const AString & pre, const AString & post ) const
+{
+    for ( const AString & changedInput : m_ChangedInputs )
+    {
+        fullArgs += pre;
+        fullArgs += changedInput;
+        fullArgs += post;
+        fullArgs.AddDelimiter();
+    }
+}
+
+// GetInputStamps
+//------------------------------------------------------------------------------
+void LinkerNode::GetInputStamps( Array< LinkerInputStamp > & stamps ) const
+{
+    // Regular inputs are after linker and before AssemblyResources
+    const Dependency * start = m_StaticDependencies.Begin() + 1; // Skip first item which is linker exe
+    const Dependency * end = m_StaticDependencies.Begin() + m_AssemblyResourcesStartIndex;
+    for ( const Dependency * i = start; i != end; ++i )
+    {
+        GetInputStamps( i->GetNode(), stamps );
+    }
+}
+
+// GetInputStamps
+//------------------------------------------------------------------------------
+void LinkerNode::GetInputStamps( const Node * n, Array< LinkerInputStamp > & stamps ) const
+{
+    // Track individual objects when they are linked directly
+    const bool linkObjects = ( n->GetType() == Node::OBJECT_LIST_NODE ) ||
+                             ( ( n->GetType() == Node::LIBRARY_NODE ) && m_LinkerLinkObjects );
+    if ( linkObjects )
+    {
+        const Dependencies & objects = n->GetDynamicDependencies();
+        stamps.SetCapacity( stamps.GetSize() + objects.GetSize() );
+        for ( Dependencies::Iter it = objects.Begin(); it != objects.End(); it++ )
+        {
+            GetInputStamps( it->GetNode(), stamps );
+        }
+        return;
+    }
+
+    if ( n->GetType() == Node::OBJECT_NODE )
+    {
+        // handle pch files - get path to matching object
+        const ObjectNode * on = n->CastTo< ObjectNode >();
+        if ( on->IsCreatingPCH() )
+        {
+            if ( on->IsMSVC() )
+            {
+                stamps.EmplaceBack( on->GetPCHObjectName(), n->GetStamp() );
+            }
+            return; // Clang/GCC/SNC don't have an object to link for a pch
+        }
+    }
+
+    if ( n->GetType() == Node::DLL_NODE )
+    {
+        // for a DLL, the import library is linked
+        AStackString<> importLibName;
+        n->CastTo< DLLNode >()->GetImportLibName( importLibName );
+        stamps.EmplaceBack( importLibName, n->GetStamp() );
+        return;
+    }
+
+    if ( n->GetType() == Node::COPY_FILE_NODE )
+    {
+        GetInputStamps( n->CastTo< CopyFileNode >()->GetSourceNode(), stamps );
+        return;
+    }
+
+    stamps.EmplaceBack( n->GetName(), n->GetStamp() );
+}
+
+// DetermineChangedInputs
+//------------------------------------------------------------------------------
+void LinkerNode::DetermineChangedInputs( const Array< LinkerInputStamp > & stamps )
+{
+    m_ChangedInputs.Clear();
+
+    const size_t numPrevious = LinkerInputStamp::FindChanged( m_InputStamps, stamps, m_ChangedInputs );
+
+    if ( m_InputStamps.IsEmpty() == false )
+    {
+        FLOG_VERBOSE( "Link '%s' : %u of %u inputs changed, %u removed\n",
+                      GetName().Get(),
+                      (uint32_t)m_ChangedInputs.GetSize(),
+                      (uint32_t)stamps.GetSize(),
+                      (uint32_t)( m_InputStamps.GetSize() - numPrevious ) );
+    }
+}
+
 // DetermineLinkerTypeFlags
 //------------------------------------------------------------------------------
 /*static*/ uint32_t LinkerNode::DetermineLinkerTypeFlags(const AString & linkerType, const AString & linkerName)
@@ -804,12 +1041,33 @@ void LinkerNode::GetAssemblyResourceFiles( Args & fullArgs, const AString & pre,
                 flags |= LinkerNode::LINK_FLAG_DLL;
                 continue;
             }
+
+            // gold incremental linking (--incremental, --incremental-update etc)
+            if ( token.BeginsWith( "--incremental" ) ||
+                 ( token.BeginsWith( "-Wl" ) && token.Find( "--incremental" ) ) )
+            {
+                flags |= LinkerNode::LINK_FLAG_INCREMENTAL;
+                continue;
+            }
         }
     }
 
     return flags;
 }
 
+// Migrate
+//------------------------------------------------------------------------------
+/*virtual*/ void LinkerNode::Migrate( const Node & oldNode )
+{
+    // Migrate Node level properties
+    Node::Migrate( oldNode );
+
+    // Migrate state of previous link
+    const LinkerNode & oldLinkerNode = static_cast< const LinkerNode & >( oldNode );
+    m_InputStamps = oldLinkerNode.m_InputStamps;
+    m_FullLinkTimeMS = oldLinkerNode.m_FullLinkTimeMS;
+}
+
 // IsLinkerArg_MSVC
 //------------------------------------------------------------------------------
 /*static*/ bool LinkerNode::IsLinkerArg_MSVC( const AString & token, const char * arg )
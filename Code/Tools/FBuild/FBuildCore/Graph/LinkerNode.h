@@ -11,6 +11,30 @@
 //------------------------------------------------------------------------------
 class Args;
 
+// LinkerInputStamp - an input to a link and its stamp when last linked
+//------------------------------------------------------------------------------
+class LinkerInputStamp : public Struct
+{
+    REFLECT_STRUCT_DECLARE( LinkerInputStamp )
+public:
+    LinkerInputStamp();
+    LinkerInputStamp( const AString & fileName, uint64_t stamp );
+    ~LinkerInputStamp();
+
+    inline const AString &      GetFileName() const     { return m_FileName; }
+    inline uint64_t             GetStamp() const        { return m_Stamp; }
+
+    // Find inputs which are new or whose stamp differs from the previous build,
+    // returning how many of the previous inputs are still present
+    static size_t FindChanged( const Array< LinkerInputStamp > & previous,
+                               const Array< LinkerInputStamp > & current,
+                               Array< AString > & outChanged );
+
+protected:
+    AString     m_FileName;
+    uint64_t    m_Stamp = 0;
+};
+
 // LinkerNode
 //------------------------------------------------------------------------------
 class LinkerNode : public FileNode
@@ -44,6 +68,13 @@ public:
 
     static bool IsStartOfLinkerArg( const AString & token, const char * arg );
 
+    virtual void Migrate( const Node & oldNode ) override;
+
+    // Incremental linking
+    inline bool WasLinkedIncrementally() const                  { return m_LinkedIncrementally; }
+    inline uint32_t GetIncrementalLinkTimeSavedMS() const       { return m_IncrementalLinkTimeSavedMS; }
+    inline const Array< AString > & GetChangedInputs() const    { return m_ChangedInputs; }
+
 protected:
     friend class TestLinker;
 
@@ -55,6 +86,10 @@ protected:
     void GetInputFiles( Args & fullArgs, const AString & pre, const AString & post ) const;
     void GetInputFiles( Node * n, Args & fullArgs, const AString & pre, const AString & post ) const;
     void GetAssemblyResourceFiles( Args & fullArgs, const AString & pre, const AString & post ) const;
+    void GetChangedInputFiles( Args & fullArgs, const AString & pre, const AString & post ) const;
+    void GetInputStamps( Array< LinkerInputStamp > & stamps ) const;
+    void GetInputStamps( const Node * n, Array< LinkerInputStamp > & stamps ) const;
+    void DetermineChangedInputs( const Array< LinkerInputStamp > & stamps );
     void EmitCompilationMessage( const Args & fullArgs ) const;
     void EmitStampMessage() const;
 
@@ -102,7 +137,14 @@ protected:
     uint32_t            m_AssemblyResourcesStartIndex   = 0;
     uint32_t            m_AssemblyResourcesNum          = 0;
     AString             m_ImportLibName;
+    Array< LinkerInputStamp > m_InputStamps;            // Inputs as of the last successful link
+    uint32_t            m_FullLinkTimeMS                = 0;
     mutable const char * m_EnvironmentString            = nullptr;
+
+    // Temporary Data (not serialized)
+    Array< AString >    m_ChangedInputs;                // Inputs changed since the last successful link
+    bool                m_LinkedIncrementally           = false;
+    uint32_t            m_IncrementalLinkTimeSavedMS    = 0;
 };
 
 //------------------------------------------------------------------------------
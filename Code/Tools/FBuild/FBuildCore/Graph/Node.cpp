@@ -45,7 +45,7 @@
 #include "Core/FileIO/FileIO.h"
 #include "Core/FileIO/IOStream.h"
 #include "Core/FileIO/PathUtils.h"
-#include "Core/Math/CRC32.h"
+#include "Core/Math/CRC32C.h"
 #include "Core/Process/Atomic.h"
 #include "Core/Process/Mutex.h"
 #include "Core/Profile/Profile.h"
@@ -464,8 +464,14 @@ void Node::SetLastBuildTime( uint32_t ms )
     }
 
     // read contents
-    ASSERT( (Node::Type)nodeType == Node::OBJECT_NODE );
-    return ObjectNode::LoadRemote( stream );
+    switch ( (Node::Type)nodeType )
+    {
+        case Node::OBJECT_NODE: return ObjectNode::LoadRemote( stream );
+        case Node::EXEC_NODE:   return ExecNode::LoadRemote( stream );
+        default:                break;
+    }
+    ASSERT( false ); // Unexpected type
+    return nullptr;
 }
 
 // SaveRemote
@@ -474,8 +480,8 @@ void Node::SetLastBuildTime( uint32_t ms )
 {
     ASSERT( node );
 
-    // only 1 type of node is ever serialized over the network
-    ASSERT( node->GetType() == Node::OBJECT_NODE );
+    // only distributable types of node are ever serialized over the network
+    ASSERT( ( node->GetType() == Node::OBJECT_NODE ) || ( node->GetType() == Node::EXEC_NODE ) );
 
     // save type
     uint32_t nodeType = (uint32_t)node->GetType();
@@ -495,6 +501,20 @@ void Node::SetLastBuildTime( uint32_t ms )
     ASSERT( false );
 }
 
+// GetRemoteToolManifest
+//------------------------------------------------------------------------------
+/*virtual*/ const ToolManifest * Node::GetRemoteToolManifest() const
+{
+    return nullptr; // Not distributable
+}
+
+// GetRemoteOutputFiles
+//------------------------------------------------------------------------------
+/*virtual*/ void Node::GetRemoteOutputFiles( Array< AString > & outputFiles ) const
+{
+    outputFiles.Append( m_Name );
+}
+
 // Serialize
 //------------------------------------------------------------------------------
 /*static*/ void Node::Serialize( IOStream & stream, const void * base, const ReflectionInfo & ri )
@@ -783,7 +803,7 @@ bool Node::Deserialize( NodeGraph & nodeGraph, IOStream & stream )
 void Node::SetName( const AString & name )
 {
     m_Name = name;
-    m_NameCRC = CRC32::CalcLower( name );
+    m_NameCRC = CRC32C::CalcLower( name );
 }
 
 // ReplaceDummyName
@@ -23,6 +23,7 @@ class IMetaData;
 class IOStream;
 class Job;
 class NodeGraph;
+class ToolManifest;
 
 // Defines
 //------------------------------------------------------------------------------
@@ -100,6 +101,8 @@ public:
         STATS_BUILT_REMOTE  = 0x40, // node was built remotely
         STATS_FAILED        = 0x80, // node needed building, but failed
         STATS_FIRST_BUILD   = 0x100,// node has never been built before
+        STATS_INCLUDES_PROCESSED = 0x1000, // seen during include cost processing
+        STATS_HISTORY_PROCESSED = 0x2000, // seen during build history processing
         STATS_REPORT_PROCESSED  = 0x4000, // seen during report processing
         STATS_STATS_PROCESSED   = 0x8000 // mark during stats gathering (leave this last)
     };
@@ -158,6 +161,11 @@ public:
     static Node *   LoadRemote( IOStream & stream );
     static void     SaveRemote( IOStream & stream, const Node * node );
 
+    // distributable nodes provide the toolchain to synchronize to workers and
+    // the list of files produced remotely (main output first, same order on both sides)
+    virtual const ToolManifest * GetRemoteToolManifest() const;
+    virtual void    GetRemoteOutputFiles( Array< AString > & outputFiles ) const;
+
     bool Deserialize( NodeGraph & nodeGraph, IOStream & stream );
 
     static bool EnsurePathExistsForFile( const AString & name );
@@ -43,7 +43,7 @@
 #include "Core/FileIO/FileIO.h"
 #include "Core/FileIO/FileStream.h"
 #include "Core/FileIO/PathUtils.h"
-#include "Core/Math/CRC32.h"
+#include "Core/Math/CRC32C.h"
 #include "Core/Math/xxHash.h"
 #include "Core/Mem/Mem.h"
 #include "Core/Process/Thread.h"
@@ -51,6 +51,7 @@
 #include "Core/Reflection/ReflectedProperty.h"
 #include "Core/Strings/AStackString.h"
 #include "Core/Strings/LevenshteinDistance.h"
+#include "Core/Strings/StringSIMD.h"
 #include "Core/Tracing/Tracing.h"
 
 #include <string.h>
@@ -1038,8 +1039,8 @@ void NodeGraph::AddNode( Node * node )
 
     ASSERT( FindNodeInternal( node->GetName() ) == nullptr ); // node name must be unique
 
-    // track in NodeMap
-    const uint32_t crc = CRC32::CalcLower( node->GetName() );
+    // track in NodeMap (using the name hash cached by the node)
+    const uint32_t crc = node->GetNameCRC();
     const size_t key = ( crc & 0xFFFF );
     node->m_Next = m_NodeMap[ key ];
     m_NodeMap[ key ] = node;
@@ -1382,6 +1383,16 @@ bool NodeGraph::CheckDependencies( Node * nodeToBuild, const Dependencies & depe
 
     while ( src < srcEnd )
     {
+        // copy (and fix slashes in) everything up to the next redundant slash or "." in bulk
+        const size_t numPlainChars = StringSIMD::CopyPath( dst, src, (size_t)( srcEnd - src ), ( lastChar == NATIVE_SLASH ) );
+        if ( numPlainChars > 0 )
+        {
+            dst += numPlainChars;
+            src += numPlainChars;
+            lastChar = *( dst - 1 );
+            continue;
+        }
+
         const char thisChar = *src;
 
         // hit a slash?
@@ -1475,7 +1486,7 @@ Node * NodeGraph::FindNodeInternal( const AString & fullPath ) const
 {
     ASSERT( Thread::IsMainThread() );
 
-    const uint32_t crc = CRC32::CalcLower( fullPath );
+    const uint32_t crc = CRC32C::CalcLower( fullPath );
     const size_t key = ( crc & 0xFFFF );
 
     Node * n = m_NodeMap[ key ];
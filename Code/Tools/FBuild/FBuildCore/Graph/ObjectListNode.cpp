@@ -401,6 +401,7 @@ ObjectListNode::~ObjectListNode() = default;
                 {
                     return false; // CreateDynamicObjectNode will have emitted error
                 }
+                un->AddObjectFileName( m_DynamicDependencies.Top().GetNode()->GetName() );
             }
 
             // files from unity to build individually
@@ -422,6 +423,7 @@ ObjectListNode::~ObjectListNode() = default;
                 {
                     return false; // CreateDynamicObjectNode will have emitted error
                 }
+                un->AddObjectFileName( m_DynamicDependencies.Top().GetNode()->GetName() );
             }
         }
         else if ( dep.GetNode()->IsAFile() )
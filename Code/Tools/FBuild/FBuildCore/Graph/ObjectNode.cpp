@@ -15,6 +15,7 @@
 #include "Tools/FBuild/FBuildCore/Graph/NodeProxy.h"
 #include "Tools/FBuild/FBuildCore/Graph/SettingsNode.h"
 #include "Tools/FBuild/FBuildCore/Helpers/Args.h"
+#include "Tools/FBuild/FBuildCore/Helpers/BuildTrace.h"
 #include "Tools/FBuild/FBuildCore/Helpers/CIncludeParser.h"
 #include "Tools/FBuild/FBuildCore/Helpers/Compressor.h"
 #include "Tools/FBuild/FBuildCore/Helpers/MultiBuffer.h"
@@ -31,6 +32,7 @@
 #include "Core/FileIO/FileIO.h"
 #include "Core/FileIO/FileStream.h"
 #include "Core/FileIO/PathUtils.h"
+#include "Core/Math/Conversions.h"
 #include "Core/Math/xxHash.h"
 #include "Core/Process/Process.h"
 #include "Core/Profile/Profile.h"
@@ -71,6 +73,7 @@ REFLECT_NODE_BEGIN( ObjectNode, Node, MetaNone() )
     REFLECT( m_Flags,                               "Flags",                            MetaHidden() )
     REFLECT( m_PreprocessorFlags,                   "PreprocessorFlags",                MetaHidden() )
     REFLECT( m_PCHCacheKey,                         "PCHCacheKey",                      MetaHidden() + MetaIgnoreForComparison() )
+    REFLECT( m_PreprocessedSize,                    "PreprocessedSize",                 MetaHidden() + MetaIgnoreForComparison() )
     REFLECT( m_OwnerObjectList,                     "OwnerObjectList",                  MetaHidden() )
 REFLECT_END( ObjectNode )
 
@@ -306,6 +309,9 @@ ObjectNode::~ObjectNode()
     // to prevent unnecessary rebuilds of object that depend on this one, if this
     // is a precompiled header object.
     m_PCHCacheKey = oldNode.CastTo< ObjectNode >()->m_PCHCacheKey;
+
+    // Size of preprocessed output is a hint for the next build
+    m_PreprocessedSize = oldNode.CastTo< ObjectNode >()->m_PreprocessedSize;
 }
 
 // DoBuildMSCL_NoCache
@@ -432,6 +438,9 @@ Node::BuildResult ObjectNode::DoBuildWithPreProcessor( Job * job, bool useDeopti
             return NODE_RESULT_FAILED; // BuildPreprocessedOutput will have emitted an error
         }
 
+        // remember size of output to size buffers next time
+        m_PreprocessedSize = (uint32_t)job->GetDataSize();
+
         // preprocessed ok, try to extract includes
         if ( ProcessIncludesWithPreProcessor( job ) == false )
         {
@@ -472,10 +481,11 @@ Node::BuildResult ObjectNode::DoBuildWithPreProcessor( Job * job, bool useDeopti
     if ( canDistribute && belowMemoryLimit )
     {
         // compress job data
+        const int32_t compressionLevel = FBuild::Get().GetDistributionCompressionLevel();
         Compressor c;
-        c.Compress( job->GetData(), job->GetDataSize() );
+        c.Compress( job->GetData(), job->GetDataSize(), compressionLevel );
         size_t compressedSize = c.GetResultSize();
-        job->OwnData( c.ReleaseResult(), compressedSize, true );
+        job->OwnData( c.ReleaseResult(), compressedSize, true, compressionLevel );
 
         // yes... re-queue for secondary build
         return NODE_RESULT_NEED_SECOND_BUILD_PASS;
@@ -753,7 +763,7 @@ bool ObjectNode::ProcessIncludesMSCL( const char * output, uint32_t outputSize )
         // (we need a flag because we can't use the array size
         // as a determinator, because the file might not include anything)
         m_Includes.Clear();
-        parser.SwapIncludes( m_Includes );
+        parser.TakeIncludes( m_Includes );
     }
 
     FLOG_VERBOSE( "Process Includes:\n - File: %s\n - Time: %u ms\n - Num : %u", m_Name.Get(), uint32_t( t.GetElapsedMS() ), uint32_t( m_Includes.GetSize() ) );
@@ -807,7 +817,7 @@ bool ObjectNode::ProcessIncludesWithPreProcessor( Job * job )
         // (we need a flag because we can't use the array size
         // as a determinator, because the file might not include anything)
         m_Includes.Clear();
-        parser.SwapIncludes( m_Includes );
+        parser.TakeIncludes( m_Includes );
     }
 
     FLOG_VERBOSE( "Process Includes:\n - File: %s\n - Time: %u ms\n - Num : %u", m_Name.Get(), uint32_t( t.GetElapsedMS() ), uint32_t( m_Includes.GetSize() ) );
@@ -1131,6 +1141,37 @@ void ObjectNode::GenerateDependenciesListFile()
     }
 }
 
+// GetRemoteToolManifest
+//------------------------------------------------------------------------------
+/*virtual*/ const ToolManifest * ObjectNode::GetRemoteToolManifest() const
+{
+    return &GetCompiler()->GetManifest();
+}
+
+// GetRemoteOutputFiles
+//------------------------------------------------------------------------------
+/*virtual*/ void ObjectNode::GetRemoteOutputFiles( Array< AString > & outputFiles ) const
+{
+    // 1. Object file
+    outputFiles.Append( m_Name );
+
+    // 2. PDB file (optional)
+    if ( IsUsingPDB() )
+    {
+        AStackString<> pdbName;
+        GetPDBName( pdbName );
+        outputFiles.Append( pdbName );
+    }
+
+    // 3. .nativecodeanalysis.xml file (optional)
+    if ( IsUsingStaticAnalysisMSVC() )
+    {
+        AStackString<> xmlFileName;
+        GetNativeAnalysisXMLPath( xmlFileName );
+        outputFiles.Append( xmlFileName );
+    }
+}
+
 // GetCompiler
 //-----------------------------------------------------------------------------
 CompilerNode * ObjectNode::GetCompiler() const
@@ -1216,7 +1257,12 @@ const AString & ObjectNode::GetCacheName( Job * job ) const
 
     // hash the pre-processed input data
     ASSERT( m_LightCacheKey || job->GetData() );
-    const uint64_t preprocessedSourceKey = m_LightCacheKey ? m_LightCacheKey : xxHash::Calc64( job->GetData(), job->GetDataSize() );
+    uint64_t preprocessedSourceKey = m_LightCacheKey;
+    if ( preprocessedSourceKey == 0 )
+    {
+        // use hash calculated when the data was retrieved if available
+        preprocessedSourceKey = job->GetDataHash() ? job->GetDataHash() : xxHash::Calc64( job->GetData(), job->GetDataSize() );
+    }
     ASSERT( preprocessedSourceKey );
 
     // hash the build "environment"
@@ -1261,6 +1307,7 @@ bool ObjectNode::RetrieveFromCache( Job * job )
     }
 
     PROFILE_FUNCTION
+    BuildTraceSection traceSection( "cache", "Cache Retrieve" );
 
     const AString & cacheFileName = GetCacheName(job);
 
@@ -1288,6 +1335,7 @@ bool ObjectNode::RetrieveFromCache( Job * job )
         Compressor c;
         if ( c.IsValidData( cacheData, cacheDataSize ) == false )
         {
+            cache->FreeMemory( cacheData, cacheDataSize );
             FLOG_WARN( "Cache returned invalid data (header)\n"
                        " - File: '%s'\n"
                        " - Key : %s\n",
@@ -1296,6 +1344,7 @@ bool ObjectNode::RetrieveFromCache( Job * job )
         }
         if ( c.Decompress( cacheData ) == false )
         {
+            cache->FreeMemory( cacheData, cacheDataSize );
             FLOG_WARN( "Cache returned invalid data (payload)\n"
                        " - File: '%s'\n"
                        " - Key : %s\n",
@@ -1359,6 +1408,7 @@ bool ObjectNode::RetrieveFromCache( Job * job )
         }
 
         SetStatFlag( Node::STATS_CACHE_HIT );
+        traceSection.GetArgs().Format( "\"hit\":true,\"bytes\":%zu", cacheDataSize );
 
         // Dependent objects need to know the PCH key to be able to pull from the cache
         if ( GetFlag( FLAG_CREATING_PCH ) && GetFlag( FLAG_MSVC ) )
@@ -1378,6 +1428,7 @@ bool ObjectNode::RetrieveFromCache( Job * job )
     }
 
     SetStatFlag( Node::STATS_CACHE_MISS );
+    traceSection.GetArgs() = "\"hit\":false";
     return false;
 }
 
@@ -1391,6 +1442,7 @@ void ObjectNode::WriteToCache( Job * job )
     }
 
     PROFILE_FUNCTION
+    BuildTraceSection traceSection( "cache", "Cache Store" );
 
     const AString & cacheFileName = GetCacheName(job);
     ASSERT(!cacheFileName.IsEmpty());
@@ -1423,6 +1475,7 @@ void ObjectNode::WriteToCache( Job * job )
             const uint32_t stopPublish( (uint32_t)t.GetElapsedMS() );
 
             SetStatFlag( Node::STATS_CACHE_STORE );
+            traceSection.GetArgs().Format( "\"bytes\":%zu", dataSize );
 
             // Dependent objects need to know the PCH key to be able to pull from the cache
             if ( GetFlag( FLAG_CREATING_PCH ) && GetFlag( FLAG_MSVC ) )
@@ -2100,11 +2153,16 @@ bool ObjectNode::BuildPreprocessedOutput( const Args & fullArgs, Job * job, bool
 
     // spawn the process
     CompileHelper ch( false ); // don't handle output (we'll do that)
+    if ( m_PreprocessedSize > 0 )
+    {
+        // output will be similar in size to last time (allow for some growth)
+        ch.SetOutputSizeHint( m_PreprocessedSize + ( m_PreprocessedSize / 8 ) );
+    }
     // TODO:A Add checks in BuildArgs for length of dedicated preprocessor
     if ( !ch.SpawnCompiler( job, GetName(),
          useDedicatedPreprocessor ? GetDedicatedPreprocessor() : GetCompiler(),
          useDedicatedPreprocessor ? GetDedicatedPreprocessor()->GetExecutable() : GetCompiler()->GetExecutable(),
-         fullArgs,m_WorkingDir.Get()) )
+         fullArgs, m_WorkingDir.IsEmpty() ? nullptr : m_WorkingDir.Get() ) )
     {
         // only output errors in failure case
         // (as preprocessed output goes to stdout, normal logging is pushed to
@@ -2127,7 +2185,7 @@ bool ObjectNode::BuildPreprocessedOutput( const Args & fullArgs, Job * job, bool
         return false; // SpawnCompiler will have emitted error
     }
 
-    // take a copy of the output because ReadAllData uses huge buffers to avoid re-sizing
+    // take a copy of the output because the buffer may be over-sized
     TransferPreprocessedData( ch.GetOut().Get(), ch.GetOut().GetLength(), job );
 
     return true;
@@ -2173,6 +2231,8 @@ void ObjectNode::TransferPreprocessedData( const char * data, size_t dataSize, J
     size_t outputBufferSize = dataSize;
     size_t newBufferSize = outputBufferSize;
     char * bufferCopy = nullptr;
+    xxHash64Accumulator dataHash;
+    bool hashCalculated = false;
 
     #if defined( __WINDOWS__ )
         // VS 2012 sometimes generates corrupted code when preprocessing an already preprocessed file when it encounters
@@ -2272,11 +2332,25 @@ void ObjectNode::TransferPreprocessedData( const char * data, size_t dataSize, J
     #endif
     {
         bufferCopy = (char *)ALLOC( newBufferSize + 1 ); // null terminator for include parser
-        memcpy( bufferCopy, outputBuffer, newBufferSize );
+
+        // Hash the data as it is copied (while it's in cache) rather than
+        // reading it all again later to determine the cache key
+        const size_t chunkSize = ( 64 * 1024 );
+        for ( size_t offset = 0; offset < newBufferSize; offset += chunkSize )
+        {
+            const size_t thisChunk = Math::Min( chunkSize, newBufferSize - offset );
+            memcpy( bufferCopy + offset, outputBuffer + offset, thisChunk );
+            dataHash.Update( bufferCopy + offset, thisChunk );
+        }
         bufferCopy[ newBufferSize ] = 0; // null terminator for include parser
+        hashCalculated = true;
     }
 
     job->OwnData( bufferCopy, newBufferSize );
+    if ( hashCalculated )
+    {
+        job->SetDataHash( dataHash.Digest() );
+    }
 }
 
 // WriteTmpFile
@@ -2887,6 +2961,9 @@ void ObjectNode::DoClangUnityFixup( Job * job ) const
     ASSERT( job->IsDataCompressed() == false ); // Can't fixup compressed data
     ASSERT( job->IsLocal() ); // Assuming we're doing this on the local machine (using FBuild singleton lower)
 
+    // Data is modified below, so any previously calculated hash is invalid
+    job->SetDataHash( 0 );
+
     // We'll walk the output and fix it up in-place
 
     AStackString<> srcFileName( GetSourceFile()->GetName() );
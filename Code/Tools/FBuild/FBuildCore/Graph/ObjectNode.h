@@ -80,6 +80,8 @@ public:
 
     virtual void SaveRemote( IOStream & stream ) const override;
     static Node * LoadRemote( IOStream & stream );
+    virtual const ToolManifest * GetRemoteToolManifest() const override;
+    virtual void GetRemoteOutputFiles( Array< AString > & outputFiles ) const override;
 
     CompilerNode * GetCompiler() const;
     inline Node * GetSourceFile() const { return m_StaticDependencies[ 1 ].GetNode(); }
@@ -176,6 +178,9 @@ private:
         inline const AString &          GetErr() const { return m_Err; }
         inline bool                     HasAborted() const { return m_Process.HasAborted(); }
 
+        // reserve space for output to avoid re-allocations as it is received
+        inline void                     SetOutputSizeHint( uint32_t size ) { m_Out.SetReserved( size ); }
+
     private:
         bool            m_HandleOutput;
         Process         m_Process;
@@ -209,6 +214,7 @@ private:
     uint32_t            m_PreprocessorFlags                 = 0;
     uint64_t            m_PCHCacheKey                       = 0;
     uint64_t            m_LightCacheKey                     = 0;
+    uint32_t            m_PreprocessedSize                  = 0; // size of last preprocessed output
     AString             m_OwnerObjectList; // TODO:C This could be a pointer to the node in the future
 
     // Not serialized
@@ -12,15 +12,25 @@
 #include "Tools/FBuild/FBuildCore/Graph/NodeGraph.h"
 #include "Tools/FBuild/FBuildCore/Graph/ObjectNode.h"
 #include "Tools/FBuild/FBuildCore/Graph/ObjectListNode.h"
+#include "Tools/FBuild/FBuildCore/WorkerPool/JobQueue.h"
 
 // Core
 #include "Core/FileIO/FileIO.h"
 #include "Core/FileIO/FileStream.h"
 #include "Core/FileIO/PathUtils.h"
 #include "Core/Math/xxHash.h"
+#include "Core/Process/Atomic.h"
 #include "Core/Process/Process.h"
 #include "Core/Strings/AStackString.h"
 
+// Defines
+//------------------------------------------------------------------------------
+#define UNITY_COST_DEFAULT_MS_PER_KB    ( 10.0f )   // Cost of files without history, when nothing can be calibrated from
+#define UNITY_COST_REBALANCE_TOLERANCE  ( 1.25f )   // Keep previous partitioning until a unity exceeds its share by this much
+#define UNITY_HASH_BUCKET_LOAD_FACTOR   ( 1.25f )   // Max files in a hash bucket relative to an even split
+#define UNITY_GENERATION_MAX_HELPERS        ( 7 )   // Idle worker threads to share generation with
+#define UNITY_GENERATION_FILES_PER_THREAD   ( 16 )  // Unity files to generate before using an extra thread
+
 // Reflection
 //------------------------------------------------------------------------------
 REFLECT_NODE_BEGIN( UnityNode, Node, MetaNone() )
@@ -43,10 +53,16 @@ REFLECT_NODE_BEGIN( UnityNode, Node, MetaNone() )
     REFLECT_ARRAY( m_PreBuildDependencyNames,   "PreBuildDependencies",         MetaOptional() + MetaFile() + MetaAllowNonFile() )
     REFLECT( m_Hidden,                  "Hidden",                               MetaOptional() )
     REFLECT( m_UseRelativePaths_Experimental, "UseRelativePaths_Experimental",  MetaOptional() )
+    REFLECT( m_BalanceByCost,           "UnityBalanceByCost",                   MetaOptional() )
+    REFLECT( m_BucketByHash,            "UnityBucketByHash",                    MetaOptional() )
 
     // Internal state
     REFLECT_ARRAY( m_UnityFileNames,    "UnityFileNames",                       MetaHidden() + MetaIgnoreForComparison() )
     REFLECT_ARRAY_OF_STRUCT( m_IsolatedFiles, "IsolatedFiles", UnityIsolatedFile, MetaHidden() + MetaIgnoreForComparison() )
+    REFLECT_ARRAY_OF_STRUCT( m_FileCosts, "FileCosts", UnityFileCost,         MetaHidden() + MetaIgnoreForComparison() )
+    REFLECT_ARRAY_OF_STRUCT( m_UnityFileCosts, "UnityFileCosts", UnityOutputFileCost, MetaHidden() + MetaIgnoreForComparison() )
+    REFLECT_ARRAY_OF_STRUCT( m_UnityFiles, "UnityFiles", UnityOutputFile,     MetaHidden() + MetaIgnoreForComparison() )
+    REFLECT_ARRAY( m_ObjectFileNames,   "ObjectFileNames",                      MetaHidden() + MetaIgnoreForComparison() )
 REFLECT_END( UnityNode )
 
 REFLECT_STRUCT_BEGIN( UnityIsolatedFile, Struct, MetaNone() )
@@ -54,6 +70,24 @@ REFLECT_STRUCT_BEGIN( UnityIsolatedFile, Struct, MetaNone() )
     REFLECT( m_DirListOriginPath,       "DirListOriginPath",                    MetaHidden() )
 REFLECT_END( UnityIsolatedFile )
 
+REFLECT_STRUCT_BEGIN( UnityFileCost, Struct, MetaNone() )
+    REFLECT( m_FileName,                "FileName",                             MetaHidden() )
+    REFLECT( m_UnityIndex,              "UnityIndex",                           MetaHidden() )
+    REFLECT( m_CostMS,                  "CostMS",                               MetaHidden() )
+REFLECT_END( UnityFileCost )
+
+REFLECT_STRUCT_BEGIN( UnityOutputFile, Struct, MetaNone() )
+    REFLECT( m_FileName,                "FileName",                             MetaHidden() )
+    REFLECT( m_ContentHash,             "ContentHash",                          MetaHidden() )
+    REFLECT( m_LastWriteTime,           "LastWriteTime",                        MetaHidden() )
+REFLECT_END( UnityOutputFile )
+
+REFLECT_STRUCT_BEGIN( UnityOutputFileCost, Struct, MetaNone() )
+    REFLECT( m_UnityFileName,           "UnityFileName",                        MetaHidden() )
+    REFLECT( m_NumFiles,                "NumFiles",                             MetaHidden() )
+    REFLECT( m_PredictedCostMS,         "PredictedCostMS",                      MetaHidden() )
+REFLECT_END( UnityOutputFileCost )
+
 // CONSTRUCTOR (UnityIsolatedFile)
 //------------------------------------------------------------------------------
 UnityIsolatedFile::UnityIsolatedFile() = default;
@@ -70,6 +104,73 @@ UnityIsolatedFile::UnityIsolatedFile( const AString & fileName, const DirectoryL
 //------------------------------------------------------------------------------
 UnityIsolatedFile::~UnityIsolatedFile() = default;
 
+// CONSTRUCTOR (UnityFileCost)
+//------------------------------------------------------------------------------
+UnityFileCost::UnityFileCost() = default;
+
+// CONSTRUCTOR (UnityFileCost)
+//------------------------------------------------------------------------------
+UnityFileCost::UnityFileCost( const AString & fileName, uint32_t unityIndex, uint32_t costMS )
+    : m_FileName( fileName )
+    , m_UnityIndex( unityIndex )
+    , m_CostMS( costMS )
+{
+}
+
+// DESTRUCTOR (UnityFileCost)
+//------------------------------------------------------------------------------
+UnityFileCost::~UnityFileCost() = default;
+
+// CONSTRUCTOR (UnityOutputFile)
+//------------------------------------------------------------------------------
+UnityOutputFile::UnityOutputFile() = default;
+
+// CONSTRUCTOR (UnityOutputFile)
+//------------------------------------------------------------------------------
+UnityOutputFile::UnityOutputFile( const AString & fileName, uint64_t contentHash, uint64_t lastWriteTime )
+    : m_FileName( fileName )
+    , m_ContentHash( contentHash )
+    , m_LastWriteTime( lastWriteTime )
+{
+}
+
+// DESTRUCTOR (UnityOutputFile)
+//------------------------------------------------------------------------------
+UnityOutputFile::~UnityOutputFile() = default;
+
+// CONSTRUCTOR (UnityOutputFileCost)
+//------------------------------------------------------------------------------
+UnityOutputFileCost::UnityOutputFileCost() = default;
+
+// CONSTRUCTOR (UnityOutputFileCost)
+//------------------------------------------------------------------------------
+UnityOutputFileCost::UnityOutputFileCost( const AString & unityFileName, uint32_t numFiles, uint32_t predictedCostMS )
+    : m_UnityFileName( unityFileName )
+    , m_NumFiles( numFiles )
+    , m_PredictedCostMS( predictedCostMS )
+{
+}
+
+// DESTRUCTOR (UnityOutputFileCost)
+//------------------------------------------------------------------------------
+UnityOutputFileCost::~UnityOutputFileCost() = default;
+
+// GenerationContext - state shared by threads generating unity files (see RunWithIdleWorkers)
+//------------------------------------------------------------------------------
+struct UnityNode::GenerationContext
+{
+    const UnityNode *                   m_Node          = nullptr;
+    const Array< UnityFileAndOrigin > * m_Files         = nullptr;
+    Array< uint32_t >                   m_FirstFiles;   // First file in each unity
+    Array< uint32_t >                   m_NumFiles;     // Number of files in each unity
+    Array< UnityOutputFile >            m_Results;
+    AStackString<>                      m_IncludeBasePath;
+    bool                                m_ForceClean    = false;
+    volatile bool                       m_Failed        = false;
+    volatile uint32_t                   m_NextUnityIndex = 0;
+    volatile uint32_t                   m_NumChanged    = 0;
+};
+
 // CONSTRUCTOR (UnityFileAndOrigin)
 //------------------------------------------------------------------------------
 UnityNode::UnityFileAndOrigin::UnityFileAndOrigin() = default;
@@ -155,8 +256,17 @@ UnityNode::UnityNode()
     , m_MaxIsolatedFiles( 0 )
     , m_ExcludePatterns( 0, true )
     , m_UseRelativePaths_Experimental( false )
+    , m_BalanceByCost( false )
+    , m_BucketByHash( false )
+    , m_MeasuredUnityCostsMS( 0, true )
+    , m_MeasuredFileCosts( 0, true )
+    , m_NumUnityFilesChanged( 0 )
     , m_IsolatedFiles( 0, true )
     , m_UnityFileNames( 0, true )
+    , m_FileCosts( 0, true )
+    , m_UnityFileCosts( 0, true )
+    , m_UnityFiles( 0, true )
+    , m_ObjectFileNames( 0, true )
 {
     m_InputPattern.EmplaceBack( "*.cpp" );
     m_LastBuildTimeMs = 100; // higher default than a file node
@@ -269,6 +379,58 @@ UnityNode::~UnityNode()
     return Node::DetermineNeedToBuild( deps );
 }
 
+// DoDynamicDependencies
+//------------------------------------------------------------------------------
+/*virtual*/ bool UnityNode::DoDynamicDependencies( NodeGraph & nodeGraph, bool /*forceClean*/ )
+{
+    m_MeasuredUnityCostsMS.Clear();
+    m_MeasuredFileCosts.Clear();
+
+    // When balancing by cost, gather how long the objects built from our previous
+    // output took to compile so estimates can be refined. This is done here because
+    // the graph can only be accessed from the main thread.
+    if ( ( IsBalancedByCost() == false ) || m_UnityFileCosts.IsEmpty() )
+    {
+        return true;
+    }
+
+    m_MeasuredUnityCostsMS.SetCapacity( m_UnityFileCosts.GetSize() );
+    for ( size_t i = 0; i < m_UnityFileCosts.GetSize(); ++i )
+    {
+        m_MeasuredUnityCostsMS.Append( 0 );
+    }
+
+    // Objects built from our previous output were recorded by the ObjectLists/Libraries
+    // which consume this node (see AddObjectFileName), so can be looked up directly
+    for ( const AString & objectFileName : m_ObjectFileNames )
+    {
+        const Node * objNode = nodeGraph.FindNodeExact( objectFileName );
+        if ( ( objNode == nullptr ) || ( objNode->GetType() != Node::OBJECT_NODE ) )
+        {
+            continue; // Object no longer exists (e.g. after a BFF change)
+        }
+        const AString & sourceFile = objNode->CastTo< ObjectNode >()->GetSourceFile()->GetName();
+        const uint32_t buildTimeMS = objNode->GetLastBuildTime();
+
+        bool found = false;
+        for ( size_t j = 0; j < m_UnityFileCosts.GetSize(); ++j )
+        {
+            if ( m_UnityFileCosts[ j ].GetUnityFileName() == sourceFile )
+            {
+                m_MeasuredUnityCostsMS[ j ] = buildTimeMS;
+                found = true;
+                break;
+            }
+        }
+        if ( found == false )
+        {
+            m_MeasuredFileCosts.EmplaceBack( sourceFile, 0, buildTimeMS ); // Isolated file
+        }
+    }
+
+    return true;
+}
+
 // DoBuild
 //------------------------------------------------------------------------------
 /*virtual*/ Node::BuildResult UnityNode::DoBuild( Job * /*job*/ )
@@ -285,6 +447,7 @@ UnityNode::~UnityNode()
     // Clear lists of files as we'll regenerate them
     m_UnityFileNames.Destruct();
     m_IsolatedFiles.Destruct();
+    m_ObjectFileNames.Destruct(); // Recorded again by consumers of the new files
 
     // Ensure dest path exists
     // NOTE: Normally a node doesn't need to worry about this, but because
@@ -320,56 +483,54 @@ UnityNode::~UnityNode()
     float numFilesPerUnity = (float)numFiles / m_NumUnityFilesToCreate;
     float remainingInThisUnity( 0.0 );
 
+    // when bucketing by hash or balancing by cost, the number of files varies per unity file
+    const bool balanceByCost = IsBalancedByCost();
+    Array< float > fileCosts;
+    Array< uint32_t > numFilesInUnity;
+    if ( m_BucketByHash )
+    {
+        AssignByHash( files, numFilesInUnity );
+    }
+    else if ( balanceByCost )
+    {
+        PartitionByCost( files, fileCosts, numFilesInUnity );
+    }
+    Array< UnityFileCost > newFileCosts( balanceByCost ? numFiles : 0, false );
+    Array< UnityOutputFileCost > newUnityFileCosts( balanceByCost ? m_NumUnityFilesToCreate : 0, false );
+    m_NumUnityFilesChanged = 0;
+
     uint32_t numFilesWritten( 0 );
 
     size_t index = 0;
 
     const bool noUnity = FBuild::Get().GetOptions().m_NoUnity;
 
-    AString output;
-    output.SetReserved( 32 * 1024 );
-
-    Array< uint64_t > stamps( m_NumUnityFilesToCreate, false );
+    GenerationContext context;
+    context.m_Node = this;
+    context.m_Files = &files;
+    context.m_FirstFiles.SetCapacity( m_NumUnityFilesToCreate );
+    context.m_NumFiles.SetCapacity( m_NumUnityFilesToCreate );
+    context.m_Results.SetCapacity( m_NumUnityFilesToCreate );
+    context.m_ForceClean = FBuild::Get().GetOptions().m_ForceCleanBuild;
 
     // Includes will be relative to root
-    AStackString<> includeBasePath;
     if ( m_UseRelativePaths_Experimental )
     {
-        includeBasePath = FBuild::Get().GetOptions().GetWorkingDir();
-        PathUtils::EnsureTrailingSlash( includeBasePath );
+        context.m_IncludeBasePath = FBuild::Get().GetOptions().GetWorkingDir();
+        PathUtils::EnsureTrailingSlash( context.m_IncludeBasePath );
     }
 
-    // create each unity file
+    // allocate files to each unity file
     for ( size_t i=0; i<m_NumUnityFilesToCreate; ++i )
     {
         // add allocation to this unity
-        remainingInThisUnity += numFilesPerUnity;
-
-        // header
-        output = "// Auto-generated Unity file - do not modify\r\n\r\n";
-
-        // precompiled header
-        if ( !m_PrecompiledHeader.IsEmpty() )
-        {
-            output += "#include \"";
-            if ( m_UseRelativePaths_Experimental )
-            {
-                AStackString<> relativePath;
-                PathUtils::GetRelativePath( includeBasePath, m_PrecompiledHeader, relativePath );
-                output += relativePath;
-            }
-            else
-            {
-                output += m_PrecompiledHeader;
-            }
-            output += "\"\r\n\r\n";
-        }
+        remainingInThisUnity += numFilesInUnity.IsEmpty() ? numFilesPerUnity : (float)numFilesInUnity[ i ];
+        const size_t firstFileInThisUnity = index;
 
         // make sure any remaining files are added to the last unity to account
         // for floating point imprecision
 
         // determine allocation of includes for this unity file
-        Array< UnityFileAndOrigin > filesInThisUnity( 256, true );
         uint32_t numIsolated( 0 );
         const bool lastUnity = ( i == ( m_NumUnityFilesToCreate - 1 ) );
         while ( ( remainingInThisUnity > 0.0f ) || lastUnity )
@@ -382,8 +543,6 @@ UnityNode::~UnityNode()
                 break;
             }
 
-            filesInThisUnity.Append( files[index ] );
-
             // files which are modified (writable) can optionally be excluded from the unity
             bool isolate = noUnity;
             if ( m_IsolateWritableFiles )
@@ -404,7 +563,7 @@ UnityNode::~UnityNode()
             if ( isolate )
             {
                 numIsolated++;
-                filesInThisUnity.Top().SetIsolated( true );
+                files[ index ].SetIsolated( true );
 
                 FLOG_VERBOSE( "Isolate file '%s' from unity\n", files[ index ].GetName().Get() );
             }
@@ -414,71 +573,44 @@ UnityNode::~UnityNode()
             numFilesWritten++;
         }
 
-        // write allocation of includes for this unity file
-        const UnityFileAndOrigin * const end = filesInThisUnity.End();
+        // finalize isolation of files in this unity file
         size_t numFilesActuallyIsolatedInThisUnity( 0 );
-        for ( const UnityFileAndOrigin * file = filesInThisUnity.Begin(); file != end; ++file )
+        float predictedCost( 0.0f );
+        for ( size_t fileIndex = firstFileInThisUnity; fileIndex < index; ++fileIndex )
         {
+            UnityFileAndOrigin & file = files[ fileIndex ];
+
             // files which are modified can optionally be excluded from the unity
             bool isolateThisFile = noUnity;
             if ( ( m_MaxIsolatedFiles == 0 ) || ( numIsolated <= m_MaxIsolatedFiles ) )
             {
                 // is the file writable?
-                if ( file->IsIsolated() )
+                if ( file.IsIsolated() )
                 {
                     isolateThisFile = true;
                 }
             }
+            file.SetIsolated( isolateThisFile );
 
             if ( isolateThisFile )
             {
                 // disable compilation of this file (comment it out)
-                m_IsolatedFiles.EmplaceBack( file->GetName(), file->GetDirListOrigin() );
+                m_IsolatedFiles.EmplaceBack( file.GetName(), file.GetDirListOrigin() );
                 numFilesActuallyIsolatedInThisUnity++;
             }
 
-            // Get relative file path
-            AStackString<> relativePath;
-            if ( m_UseRelativePaths_Experimental )
+            // record estimated cost for use by the next build
+            if ( balanceByCost )
             {
-                PathUtils::GetRelativePath( includeBasePath, file->GetName(), relativePath );
-            }
-
-            // write pragma showing cpp file being compiled to assist resolving compilation errors
-            AStackString<> buffer( m_UseRelativePaths_Experimental ? relativePath : file->GetName() );
-            buffer.Replace( BACK_SLASH, FORWARD_SLASH ); // avoid problems with slashes in generated code
-            #if defined( __LINUX__ )
-                output += "//"; // TODO:LINUX - Find how to avoid GCC spamming "note:" about use of pragma
-            #else
-                if ( isolateThisFile )
+                const float cost = fileCosts[ fileIndex ];
+                newFileCosts.EmplaceBack( file.GetName(), (uint32_t)i, (uint32_t)cost );
+                if ( isolateThisFile == false )
                 {
-                    output += "//";
+                    predictedCost += cost;
                 }
-            #endif
-            output += "#pragma message( \"";
-            output += buffer;
-            output += "\" )\r\n";
-
-            // write include
-            if ( isolateThisFile )
-            {
-                output += "//"; // TODO:C Do this only for "real" isolation (not -nounity)
-                                // (this would reduce rebuilds, but currently doensn't work
-                                //  because the generated unity.cpp changing is critical
-                                //  to triggering the rebuild when switching -nounity on/off)
-            }
-            output += "#include \"";
-            if ( m_UseRelativePaths_Experimental )
-            {
-                output += relativePath;
-            }
-            else
-            {
-                output += file->GetName();
             }
-            output += "\"\r\n\r\n";
         }
-        output += "\r\n";
+        const uint32_t numFilesInThisUnity = (uint32_t)( index - firstFileInThisUnity );
 
         // generate the destination unity file name
         AStackString<> unityName( m_OutputPath );
@@ -490,91 +622,264 @@ UnityNode::~UnityNode()
         }
 
         // only keep track of non-empty unity files (to avoid link errors with empty objects)
-        if ( filesInThisUnity.GetSize() != numFilesActuallyIsolatedInThisUnity )
+        if ( numFilesInThisUnity != numFilesActuallyIsolatedInThisUnity )
         {
             m_UnityFileNames.Append( unityName );
         }
+        if ( balanceByCost )
+        {
+            newUnityFileCosts.EmplaceBack( unityName, numFilesInThisUnity, (uint32_t)predictedCost );
+            FLOG_VERBOSE( "Unity '%s' : %u files, predicted cost %u ms\n", unityName.Get(), numFilesInThisUnity, (uint32_t)predictedCost );
+        }
+
+        context.m_FirstFiles.Append( (uint32_t)firstFileInThisUnity );
+        context.m_NumFiles.Append( numFilesInThisUnity );
+        context.m_Results.EmplaceBack( unityName, 0, 0 );
+    }
+
+    // generate the unity files, sharing the work with idle worker threads when there are many
+    const uint32_t numHelpers = Math::Min( (uint32_t)UNITY_GENERATION_MAX_HELPERS,
+                                           ( m_NumUnityFilesToCreate / UNITY_GENERATION_FILES_PER_THREAD ) );
+    if ( JobQueue::IsValid() )
+    {
+        JobQueue::Get().RunWithIdleWorkers( GenerationHelperFunc, &context, numHelpers );
+    }
+    else
+    {
+        GenerateUnityFiles( context );
+    }
+    if ( context.m_Failed )
+    {
+        return NODE_RESULT_FAILED; // GenerateUnityFile will have emitted an error
+    }
+    m_NumUnityFilesChanged = context.m_NumChanged;
+
+    // Sanity check that all files were written
+    ASSERT( numFilesWritten == numFiles );
+
+    // Keep costs for partitioning the next build
+    m_FileCosts.Swap( newFileCosts );
+    m_UnityFileCosts.Swap( newUnityFileCosts );
+
+    FLOG_VERBOSE( "Unity '%s' : %u of %u unity files changed\n", GetName().Get(), m_NumUnityFilesChanged, m_NumUnityFilesToCreate );
+
+    // Keep content hashes to avoid reading unity files in the next build
+    m_UnityFiles.Swap( context.m_Results );
+
+    // Calculate final hash to represent generation of Unity files
+    Array< uint64_t > stamps( m_NumUnityFilesToCreate, false );
+    for ( const UnityOutputFile & unityFile : m_UnityFiles )
+    {
+        stamps.Append( unityFile.GetContentHash() );
+    }
+    ASSERT( stamps.GetSize() == m_NumUnityFilesToCreate );
+    m_Stamp = xxHash::Calc64( &stamps[ 0 ], stamps.GetSize() * sizeof( uint64_t ) );
+
+    // cleanup extra FileInfo structures
+    for ( FileIO::FileInfo * info : m_FilesInfo )
+    {
+        FDELETE info;
+    }
+    m_FilesInfo.Destruct();
+
+    return NODE_RESULT_OK;
+}
+
+// GenerationHelperFunc
+//------------------------------------------------------------------------------
+/*static*/ void UnityNode::GenerationHelperFunc( void * userData )
+{
+    GenerationContext * context = static_cast< GenerationContext * >( userData );
+    context->m_Node->GenerateUnityFiles( *context );
+}
+
+// GenerateUnityFiles
+//------------------------------------------------------------------------------
+void UnityNode::GenerateUnityFiles( GenerationContext & context ) const
+{
+    AString output;
+    output.SetReserved( 32 * 1024 );
+
+    for ( ;; )
+    {
+        const uint32_t unityIndex = ( AtomicIncU32( &context.m_NextUnityIndex ) - 1 );
+        if ( ( unityIndex >= context.m_Results.GetSize() ) || AtomicLoadRelaxed( &context.m_Failed ) )
+        {
+            return;
+        }
+        if ( GenerateUnityFile( context, unityIndex, output ) == false )
+        {
+            AtomicStoreRelaxed( &context.m_Failed, true );
+            return;
+        }
+    }
+}
+
+// GenerateUnityFile
+//------------------------------------------------------------------------------
+bool UnityNode::GenerateUnityFile( GenerationContext & context, size_t unityIndex, AString & output ) const
+{
+    const AString & includeBasePath = context.m_IncludeBasePath;
+
+    // header
+    output = "// Auto-generated Unity file - do not modify\r\n\r\n";
+
+    // precompiled header
+    if ( !m_PrecompiledHeader.IsEmpty() )
+    {
+        output += "#include \"";
+        if ( m_UseRelativePaths_Experimental )
+        {
+            AStackString<> relativePath;
+            PathUtils::GetRelativePath( includeBasePath, m_PrecompiledHeader, relativePath );
+            output += relativePath;
+        }
+        else
+        {
+            output += m_PrecompiledHeader;
+        }
+        output += "\"\r\n\r\n";
+    }
+
+    // write allocation of includes for this unity file
+    const UnityFileAndOrigin * file = context.m_Files->Begin() + context.m_FirstFiles[ unityIndex ];
+    const UnityFileAndOrigin * const end = file + context.m_NumFiles[ unityIndex ];
+    for ( ; file != end; ++file )
+    {
+        const bool isolateThisFile = file->IsIsolated();
 
-        stamps.Append( xxHash::Calc64( output.Get(), output.GetLength() ) );
+        // Get relative file path
+        AStackString<> relativePath;
+        if ( m_UseRelativePaths_Experimental )
+        {
+            PathUtils::GetRelativePath( includeBasePath, file->GetName(), relativePath );
+        }
+
+        // write pragma showing cpp file being compiled to assist resolving compilation errors
+        AStackString<> buffer( m_UseRelativePaths_Experimental ? relativePath : file->GetName() );
+        buffer.Replace( BACK_SLASH, FORWARD_SLASH ); // avoid problems with slashes in generated code
+        #if defined( __LINUX__ )
+            output += "//"; // TODO:LINUX - Find how to avoid GCC spamming "note:" about use of pragma
+        #else
+            if ( isolateThisFile )
+            {
+                output += "//";
+            }
+        #endif
+        output += "#pragma message( \"";
+        output += buffer;
+        output += "\" )\r\n";
 
-        // need to write the unity file?
-        bool needToWrite = false;
-        FileStream f;
-        if ( FBuild::Get().GetOptions().m_ForceCleanBuild )
+        // write include
+        if ( isolateThisFile )
+        {
+            output += "//"; // TODO:C Do this only for "real" isolation (not -nounity)
+                            // (this would reduce rebuilds, but currently doensn't work
+                            //  because the generated unity.cpp changing is critical
+                            //  to triggering the rebuild when switching -nounity on/off)
+        }
+        output += "#include \"";
+        if ( m_UseRelativePaths_Experimental )
         {
-            needToWrite = true; // clean build forces regeneration
+            output += relativePath;
         }
         else
         {
-            if ( f.Open( unityName.Get(), FileStream::READ_ONLY ) )
+            output += file->GetName();
+        }
+        output += "\"\r\n\r\n";
+    }
+    output += "\r\n";
+
+    const AString & unityName = context.m_Results[ unityIndex ].GetFileName();
+    const uint64_t contentHash = xxHash::Calc64( output.Get(), output.GetLength() );
+
+    // The hash of what we wrote last time avoids reading the existing file, unless
+    // the file has been modified since
+    const UnityOutputFile * previous = nullptr;
+    if ( ( unityIndex < m_UnityFiles.GetSize() ) && ( m_UnityFiles[ unityIndex ].GetFileName() == unityName ) )
+    {
+        previous = &m_UnityFiles[ unityIndex ];
+    }
+
+    // need to write the unity file?
+    bool needToWrite = false;
+    uint64_t lastWriteTime = 0;
+    FileStream f;
+    if ( context.m_ForceClean )
+    {
+        needToWrite = true; // clean build forces regeneration
+    }
+    else if ( previous && ( previous->GetContentHash() != contentHash ) )
+    {
+        needToWrite = true; // contents differ from what was written last time
+    }
+    else
+    {
+        lastWriteTime = FileIO::GetFileLastWriteTime( unityName );
+        if ( previous && ( lastWriteTime != 0 ) && ( lastWriteTime == previous->GetLastWriteTime() ) )
+        {
+            // unchanged since we wrote it
+        }
+        else if ( f.Open( unityName.Get(), FileStream::READ_ONLY ) )
+        {
+            const size_t fileSize( (size_t)f.GetFileSize() );
+            if ( output.GetLength() != fileSize )
             {
-                const size_t fileSize( (size_t)f.GetFileSize() );
-                if ( output.GetLength() != fileSize )
+                // output not the same size as the file on disc
+                needToWrite = true;
+            }
+            else
+            {
+                // files the same size - are the contents the same?
+                AutoPtr< char > mem( (char *)ALLOC( fileSize ) );
+                if ( f.Read( mem.Get(), fileSize ) != fileSize )
                 {
-                    // output not the same size as the file on disc
+                    // problem reading file - try to write it again
                     needToWrite = true;
                 }
                 else
                 {
-                    // files the same size - are the contents the same?
-                    AutoPtr< char > mem( (char *)ALLOC( fileSize ) );
-                    if ( f.Read( mem.Get(), fileSize ) != fileSize )
+                    if ( AString::StrNCmp( mem.Get(), output.Get(), fileSize ) != 0 )
                     {
-                        // problem reading file - try to write it again
+                        // contents differ
                         needToWrite = true;
                     }
-                    else
-                    {
-                        if ( AString::StrNCmp( mem.Get(), output.Get(), fileSize ) != 0 )
-                        {
-                            // contents differ
-                            needToWrite = true;
-                        }
-                    }
                 }
-                f.Close();
-            }
-            else
-            {
-                // file missing - must create
-                needToWrite = true;
             }
+            f.Close();
         }
-
-        // needs updating?
-        if ( needToWrite )
+        else
         {
-            if ( f.Open( unityName.Get(), FileStream::WRITE_ONLY ) == false )
-            {
-                FLOG_ERROR( "Failed to create Unity file '%s'", unityName.Get() );
-                return NODE_RESULT_FAILED;
-            }
+            // file missing - must create
+            needToWrite = true;
+        }
+    }
 
-            if ( f.Write( output.Get(), output.GetLength() ) != output.GetLength() )
-            {
-                FLOG_ERROR( "Error writing Unity file '%s'", unityName.Get() );
-                return NODE_RESULT_FAILED;
-            }
+    // needs updating?
+    if ( needToWrite )
+    {
+        AtomicIncU32( &context.m_NumChanged );
 
-            f.Close();
+        if ( f.Open( unityName.Get(), FileStream::WRITE_ONLY ) == false )
+        {
+            FLOG_ERROR( "Failed to create Unity file '%s'", unityName.Get() );
+            return false;
         }
-    }
 
-    // Sanity check that all files were written
-    ASSERT( numFilesWritten == numFiles );
+        if ( f.Write( output.Get(), output.GetLength() ) != output.GetLength() )
+        {
+            FLOG_ERROR( "Error writing Unity file '%s'", unityName.Get() );
+            return false;
+        }
 
-    // Calculate final hash to represent generation of Unity files
-    ASSERT( stamps.GetSize() == m_NumUnityFilesToCreate );
-    m_Stamp = xxHash::Calc64( &stamps[ 0 ], stamps.GetSize() * sizeof( uint64_t ) );
+        f.Close();
 
-    // cleanup extra FileInfo structures
-    for ( FileIO::FileInfo * info : m_FilesInfo )
-    {
-        FDELETE info;
+        lastWriteTime = FileIO::GetFileLastWriteTime( unityName );
     }
-    m_FilesInfo.Destruct();
 
-    return NODE_RESULT_OK;
+    context.m_Results[ unityIndex ] = UnityOutputFile( unityName, contentHash, lastWriteTime );
+    return true;
 }
 
 // Migrate
@@ -588,6 +893,20 @@ UnityNode::~UnityNode()
     const UnityNode * oldUnityNode = oldNode.CastTo< UnityNode >();
     m_IsolatedFiles = oldUnityNode->m_IsolatedFiles;
     m_UnityFileNames = oldUnityNode->m_UnityFileNames;
+    m_FileCosts = oldUnityNode->m_FileCosts;
+    m_UnityFileCosts = oldUnityNode->m_UnityFileCosts;
+    m_UnityFiles = oldUnityNode->m_UnityFiles;
+    m_ObjectFileNames = oldUnityNode->m_ObjectFileNames;
+}
+
+// AddObjectFileName
+//------------------------------------------------------------------------------
+void UnityNode::AddObjectFileName( const AString & objectFileName )
+{
+    if ( m_ObjectFileNames.Find( objectFileName ) == nullptr )
+    {
+        m_ObjectFileNames.Append( objectFileName );
+    }
 }
 
 // GetFiles
@@ -733,6 +1052,291 @@ void UnityNode::FilterForceIsolated( Array< UnityFileAndOrigin > & files, Array<
     files.SetSize( (uint64_t)( writeIt - files.Begin() ) );
 }
 
+// PartitionByCost
+//------------------------------------------------------------------------------
+void UnityNode::PartitionByCost( const Array< UnityFileAndOrigin > & files, Array< float > & outCosts, Array< uint32_t > & outNumFilesPerUnity ) const
+{
+    // Lookups by file name for the costs recorded in previous builds
+    class CostCompare
+    {
+    public:
+        bool operator () ( const UnityFileCost * a, const UnityFileCost * b ) const
+        {
+            return ( AString::StrNCmpI( a->GetFileName().Get(), b->GetFileName().Get(), Math::Max( a->GetFileName().GetLength(), b->GetFileName().GetLength() ) ) < 0 );
+        }
+        static const UnityFileCost * Find( const Array< const UnityFileCost * > & costs, const AString & fileName )
+        {
+            size_t low = 0;
+            size_t high = costs.GetSize();
+            while ( low < high )
+            {
+                const size_t mid = ( low + high ) / 2;
+                const AString & midName = costs[ mid ]->GetFileName();
+                const int32_t order = AString::StrNCmpI( midName.Get(), fileName.Get(), Math::Max( midName.GetLength(), fileName.GetLength() ) );
+                if ( order == 0 )
+                {
+                    return costs[ mid ];
+                }
+                if ( order < 0 )
+                {
+                    low = mid + 1;
+                }
+                else
+                {
+                    high = mid;
+                }
+            }
+            return nullptr;
+        }
+    };
+    Array< const UnityFileCost * > previousCosts( m_FileCosts.GetSize(), false );
+    for ( const UnityFileCost & cost : m_FileCosts )
+    {
+        previousCosts.Append( &cost );
+    }
+    previousCosts.Sort( CostCompare() );
+    Array< const UnityFileCost * > measuredCosts( m_MeasuredFileCosts.GetSize(), false );
+    for ( const UnityFileCost & cost : m_MeasuredFileCosts )
+    {
+        measuredCosts.Append( &cost );
+    }
+    measuredCosts.Sort( CostCompare() );
+
+    // The files in each previous unity share its measured build time in proportion
+    // to their previous estimates
+    const size_t numPreviousUnity = m_UnityFileCosts.GetSize();
+    StackArray< float > previousScales;
+    previousScales.SetCapacity( numPreviousUnity );
+    for ( size_t i = 0; i < numPreviousUnity; ++i )
+    {
+        const uint32_t predictedMS = m_UnityFileCosts[ i ].GetPredictedCostMS();
+        const uint32_t measuredMS = ( i < m_MeasuredUnityCostsMS.GetSize() ) ? m_MeasuredUnityCostsMS[ i ] : 0;
+        previousScales.Append( ( ( predictedMS > 0 ) && ( measuredMS > 0 ) ) ? ( (float)measuredMS / (float)predictedMS ) : 1.0f );
+    }
+
+    // Estimate the cost of files with history
+    const size_t numFiles = files.GetSize();
+    outCosts.SetSize( numFiles );
+    Array< const UnityFileCost * > previousCostPerFile( numFiles, false );
+    double knownCost = 0.0;
+    double knownSize = 0.0;
+    for ( size_t i = 0; i < numFiles; ++i )
+    {
+        const UnityFileAndOrigin & file = files[ i ];
+        const UnityFileCost * previousCost = CostCompare::Find( previousCosts, file.GetName() );
+        previousCostPerFile.Append( previousCost );
+
+        float cost = -1.0f;
+        if ( previousCost )
+        {
+            const uint32_t unityIndex = previousCost->GetUnityIndex();
+            const float scale = ( unityIndex < numPreviousUnity ) ? previousScales[ unityIndex ] : 1.0f;
+            cost = ( (float)previousCost->GetCostMS() * scale );
+        }
+        else if ( const UnityFileCost * measuredCost = CostCompare::Find( measuredCosts, file.GetName() ) )
+        {
+            cost = (float)measuredCost->GetCostMS(); // Previously compiled in isolation
+        }
+        outCosts[ i ] = cost;
+
+        if ( ( cost >= 0.0f ) && ( file.GetSize() > 0 ) )
+        {
+            knownCost += (double)cost;
+            knownSize += (double)file.GetSize();
+        }
+    }
+
+    // Files without history are estimated from their size, calibrated against files
+    // with history where possible. Files of unknown size (from object lists) get the
+    // average cost.
+    const double costPerByte = ( knownSize > 0.0 ) ? ( knownCost / knownSize ) : ( (double)UNITY_COST_DEFAULT_MS_PER_KB / 1024.0 );
+    double totalCost = 0.0;
+    size_t numCosted = 0;
+    for ( size_t i = 0; i < numFiles; ++i )
+    {
+        if ( ( outCosts[ i ] < 0.0f ) && ( files[ i ].GetSize() > 0 ) )
+        {
+            outCosts[ i ] = (float)( (double)files[ i ].GetSize() * costPerByte );
+        }
+        if ( outCosts[ i ] >= 0.0f )
+        {
+            totalCost += (double)outCosts[ i ];
+            numCosted++;
+        }
+    }
+    const float averageCost = ( numCosted > 0 ) ? (float)( totalCost / (double)numCosted ) : 1.0f;
+    totalCost = 0.0;
+    for ( size_t i = 0; i < numFiles; ++i )
+    {
+        if ( outCosts[ i ] < 0.0f )
+        {
+            outCosts[ i ] = averageCost;
+        }
+        outCosts[ i ] = Math::Max( outCosts[ i ], 1.0f ); // Every file has some cost
+        totalCost += (double)outCosts[ i ];
+    }
+
+    const uint32_t numUnity = m_NumUnityFilesToCreate;
+    const double targetCost = ( totalCost / numUnity );
+
+    // Assign files in order, moving to the next unity once the cumulative cost
+    // reaches the end of this unity's share. A file is placed on whichever side
+    // of the boundary the middle of it falls.
+    outNumFilesPerUnity.SetSize( numUnity );
+    StackArray< double > unityCosts;
+    unityCosts.SetSize( numUnity );
+    for ( uint32_t i = 0; i < numUnity; ++i )
+    {
+        outNumFilesPerUnity[ i ] = 0;
+        unityCosts[ i ] = 0.0;
+    }
+    uint32_t unityIndex = 0;
+    double cumulativeCost = 0.0;
+    for ( size_t i = 0; i < numFiles; ++i )
+    {
+        const double cost = (double)outCosts[ i ];
+        while ( ( unityIndex < ( numUnity - 1 ) ) &&
+                ( outNumFilesPerUnity[ unityIndex ] > 0 ) &&
+                ( ( cumulativeCost + ( cost * 0.5 ) ) > ( targetCost * ( unityIndex + 1 ) ) ) )
+        {
+            unityIndex++;
+        }
+        outNumFilesPerUnity[ unityIndex ]++;
+        unityCosts[ unityIndex ] += cost;
+        cumulativeCost += cost;
+    }
+    double balancedMaxCost = 0.0;
+    for ( const double unityCost : unityCosts )
+    {
+        balancedMaxCost = Math::Max( balancedMaxCost, unityCost );
+    }
+
+    // Keep the previous partitioning unless it is much worse than the above, so
+    // small changes don't move files between unity files (causing extra rebuilds).
+    // New files join the unity of the file preceding them.
+    if ( numPreviousUnity != numUnity )
+    {
+        return;
+    }
+    StackArray< uint32_t > previousNumFilesPerUnity;
+    previousNumFilesPerUnity.SetSize( numUnity );
+    for ( uint32_t i = 0; i < numUnity; ++i )
+    {
+        previousNumFilesPerUnity[ i ] = 0;
+        unityCosts[ i ] = 0.0;
+    }
+    unityIndex = 0;
+    for ( size_t i = 0; i < numFiles; ++i )
+    {
+        const UnityFileCost * previousCost = previousCostPerFile[ i ];
+        if ( previousCost )
+        {
+            // Files must remain contiguous
+            if ( ( previousCost->GetUnityIndex() < unityIndex ) || ( previousCost->GetUnityIndex() >= numUnity ) )
+            {
+                return;
+            }
+            unityIndex = previousCost->GetUnityIndex();
+        }
+        previousNumFilesPerUnity[ unityIndex ]++;
+        unityCosts[ unityIndex ] += (double)outCosts[ i ];
+    }
+    double previousMaxCost = 0.0;
+    for ( const double unityCost : unityCosts )
+    {
+        previousMaxCost = Math::Max( previousMaxCost, unityCost );
+    }
+    if ( previousMaxCost > ( Math::Max( targetCost, balancedMaxCost ) * (double)UNITY_COST_REBALANCE_TOLERANCE ) )
+    {
+        FLOG_VERBOSE( "Rebalancing unity '%s'\n", GetName().Get() );
+        return;
+    }
+    outNumFilesPerUnity = previousNumFilesPerUnity;
+}
+
+
+// AssignByHash
+//------------------------------------------------------------------------------
+void UnityNode::AssignByHash( Array< UnityFileAndOrigin > & files, Array< uint32_t > & outNumFilesPerUnity ) const
+{
+    // Each file goes in a unity file chosen by a hash of its path, so adding or
+    // removing a file leaves the contents of the other unity files unchanged. The
+    // path is made relative to the input path (or working dir) so the assignment
+    // is the same in every workspace.
+    const size_t numFiles = files.GetSize();
+    const uint32_t numUnity = m_NumUnityFilesToCreate;
+    const AString & workingDir = FBuild::Get().GetOptions().GetWorkingDir();
+
+    struct HashedFile
+    {
+        uint32_t    m_Hash;
+        uint32_t    m_Index;
+        bool operator < ( const HashedFile & other ) const
+        {
+            return ( m_Hash != other.m_Hash ) ? ( m_Hash < other.m_Hash ) : ( m_Index < other.m_Index );
+        }
+    };
+    Array< HashedFile > hashedFiles( numFiles, false );
+    for ( size_t i = 0; i < numFiles; ++i )
+    {
+        const AString & name = files[ i ].GetName();
+        const DirectoryListNode * dirListOrigin = files[ i ].GetDirListOrigin();
+        const AString & basePath = dirListOrigin ? dirListOrigin->GetPath() : workingDir;
+        const char * relativePath = name.BeginsWithI( basePath ) ? ( name.Get() + basePath.GetLength() ) : name.Get();
+        while ( ( *relativePath == NATIVE_SLASH ) || ( *relativePath == OTHER_SLASH ) )
+        {
+            relativePath++;
+        }
+
+        AStackString<> key( relativePath );
+        key.ToLower();
+        key.Replace( BACK_SLASH, FORWARD_SLASH );
+
+        HashedFile hashedFile;
+        hashedFile.m_Hash = xxHash::Calc32( key );
+        hashedFile.m_Index = (uint32_t)i;
+        hashedFiles.Append( hashedFile );
+    }
+
+    // Bound the number of files per unity. Files whose unity is full move to the
+    // next one. Files are considered in hash order so the overflow is deterministic
+    // and only affects the few files beyond the bound.
+    hashedFiles.Sort();
+    const uint32_t maxFilesPerUnity = Math::Max( 1u, (uint32_t)( ( (float)numFiles / (float)numUnity ) * UNITY_HASH_BUCKET_LOAD_FACTOR + 0.999f ) );
+    outNumFilesPerUnity.SetSize( numUnity );
+    for ( uint32_t i = 0; i < numUnity; ++i )
+    {
+        outNumFilesPerUnity[ i ] = 0;
+    }
+    Array< uint32_t > unityIndices( numFiles, false );
+    unityIndices.SetSize( numFiles );
+    for ( const HashedFile & hashedFile : hashedFiles )
+    {
+        uint32_t unityIndex = ( hashedFile.m_Hash % numUnity );
+        while ( outNumFilesPerUnity[ unityIndex ] >= maxFilesPerUnity )
+        {
+            unityIndex = ( ( unityIndex + 1 ) % numUnity );
+        }
+        outNumFilesPerUnity[ unityIndex ]++;
+        unityIndices[ hashedFile.m_Index ] = unityIndex;
+    }
+
+    // Group files by unity, keeping the sorted order within each
+    Array< uint32_t > writeIndices( numUnity, false );
+    uint32_t offset = 0;
+    for ( uint32_t i = 0; i < numUnity; ++i )
+    {
+        writeIndices.Append( offset );
+        offset += outNumFilesPerUnity[ i ];
+    }
+    Array< UnityFileAndOrigin > groupedFiles( numFiles, false );
+    groupedFiles.SetSize( numFiles );
+    for ( size_t i = 0; i < numFiles; ++i )
+    {
+        groupedFiles[ writeIndices[ unityIndices[ i ] ]++ ] = files[ i ];
+    }
+    files.Swap( groupedFiles );
+}
 
 // EnumerateInputFiles
 //------------------------------------------------------------------------------
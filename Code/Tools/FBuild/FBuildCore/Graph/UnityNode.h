@@ -32,6 +32,66 @@ protected:
     AString m_DirListOriginPath;
 };
 
+// UnityFileCost - estimated cost of compiling an input file
+//------------------------------------------------------------------------------
+class UnityFileCost : public Struct
+{
+    REFLECT_STRUCT_DECLARE( UnityFileCost )
+public:
+    UnityFileCost();
+    UnityFileCost( const AString & fileName, uint32_t unityIndex, uint32_t costMS );
+    ~UnityFileCost();
+
+    inline const AString &      GetFileName() const     { return m_FileName; }
+    inline uint32_t             GetUnityIndex() const   { return m_UnityIndex; }
+    inline uint32_t             GetCostMS() const       { return m_CostMS; }
+
+protected:
+    AString     m_FileName;
+    uint32_t    m_UnityIndex    = 0; // Unity file the input was allocated to
+    uint32_t    m_CostMS        = 0;
+};
+
+// UnityOutputFile - a generated unity file
+//------------------------------------------------------------------------------
+class UnityOutputFile : public Struct
+{
+    REFLECT_STRUCT_DECLARE( UnityOutputFile )
+public:
+    UnityOutputFile();
+    UnityOutputFile( const AString & fileName, uint64_t contentHash, uint64_t lastWriteTime );
+    ~UnityOutputFile();
+
+    inline const AString &      GetFileName() const         { return m_FileName; }
+    inline uint64_t             GetContentHash() const      { return m_ContentHash; }
+    inline uint64_t             GetLastWriteTime() const    { return m_LastWriteTime; }
+
+protected:
+    AString     m_FileName;
+    uint64_t    m_ContentHash   = 0;
+    uint64_t    m_LastWriteTime = 0; // When we last wrote (or verified) the file
+};
+
+// UnityOutputFileCost - predicted cost of compiling a generated unity file
+//------------------------------------------------------------------------------
+class UnityOutputFileCost : public Struct
+{
+    REFLECT_STRUCT_DECLARE( UnityOutputFileCost )
+public:
+    UnityOutputFileCost();
+    UnityOutputFileCost( const AString & unityFileName, uint32_t numFiles, uint32_t predictedCostMS );
+    ~UnityOutputFileCost();
+
+    inline const AString &      GetUnityFileName() const    { return m_UnityFileName; }
+    inline uint32_t             GetNumFiles() const         { return m_NumFiles; }
+    inline uint32_t             GetPredictedCostMS() const  { return m_PredictedCostMS; }
+
+protected:
+    AString     m_UnityFileName;
+    uint32_t    m_NumFiles          = 0;
+    uint32_t    m_PredictedCostMS   = 0;
+};
+
 // UnityNode
 //------------------------------------------------------------------------------
 class UnityNode : public Node
@@ -48,11 +108,20 @@ public:
 
     inline const Array< AString > & GetUnityFileNames() const { return m_UnityFileNames; }
     inline const Array< UnityIsolatedFile > & GetIsolatedFileNames() const { return m_IsolatedFiles; }
+    inline bool IsBalancedByCost() const { return ( m_BalanceByCost && !m_BucketByHash ); }
+    inline bool IsBucketedByHash() const { return m_BucketByHash; }
+    inline uint32_t GetNumUnityFilesToCreate() const { return m_NumUnityFilesToCreate; }
+    inline uint32_t GetNumUnityFilesChanged() const { return m_NumUnityFilesChanged; }
+    inline const Array< UnityOutputFileCost > & GetUnityFileCosts() const { return m_UnityFileCosts; }
 
     void EnumerateInputFiles( void (*callback)( const AString & inputFile, const AString & baseDir, void * userData ), void * userData ) const;
 
+    // Record an object compiled from our output (by an ObjectList/Library on the main thread)
+    void AddObjectFileName( const AString & objectFileName );
+
 protected:
     virtual bool DetermineNeedToBuild( const Dependencies & deps ) const override;
+    virtual bool DoDynamicDependencies( NodeGraph & nodeGraph, bool forceClean ) override;
     virtual BuildResult DoBuild( Job * job ) override;
     virtual void Migrate( const Node & oldNode ) override;
 
@@ -66,6 +135,7 @@ protected:
 
         inline const AString &              GetName() const             { return m_Info->m_Name; }
         inline bool                         IsReadOnly() const          { return m_Info->IsReadOnly(); }
+        inline uint64_t                     GetSize() const             { return m_Info->m_Size; }
         inline const DirectoryListNode *    GetDirListOrigin() const    { return m_DirListOrigin; }
 
         inline bool                         IsIsolated() const          { return m_Isolated; }
@@ -83,6 +153,13 @@ protected:
     bool GetFiles( Array< UnityFileAndOrigin > & files );
     bool GetIsolatedFilesFromList( Array< AString > & files ) const;
     void FilterForceIsolated( Array< UnityFileAndOrigin > & files, Array< UnityIsolatedFile > & isolatedFiles );
+    void PartitionByCost( const Array< UnityFileAndOrigin > & files, Array< float > & outCosts, Array< uint32_t > & outNumFilesPerUnity ) const;
+    void AssignByHash( Array< UnityFileAndOrigin > & files, Array< uint32_t > & outNumFilesPerUnity ) const;
+
+    struct GenerationContext;
+    static void GenerationHelperFunc( void * userData );
+    void GenerateUnityFiles( GenerationContext & context ) const;
+    bool GenerateUnityFile( GenerationContext & context, size_t unityIndex, AString & output ) const;
 
     // Exposed properties
     Array< AString > m_InputPaths;
@@ -103,13 +180,22 @@ protected:
     Array< AString > m_ExcludePatterns;
     Array< AString > m_PreBuildDependencyNames;
     bool m_UseRelativePaths_Experimental;
+    bool m_BalanceByCost;
+    bool m_BucketByHash;
 
     // Temporary data
     Array< FileIO::FileInfo* > m_FilesInfo;
+    Array< uint32_t > m_MeasuredUnityCostsMS;   // Last build time of each previous unity file
+    Array< UnityFileCost > m_MeasuredFileCosts; // Last build time of previously isolated files
+    uint32_t m_NumUnityFilesChanged;            // Unity files written by the last DoBuild
 
     // Internal data persisted between builds
     Array< UnityIsolatedFile > m_IsolatedFiles;
     Array< AString > m_UnityFileNames;
+    Array< UnityFileCost > m_FileCosts;
+    Array< UnityOutputFileCost > m_UnityFileCosts;
+    Array< UnityOutputFile > m_UnityFiles;
+    Array< AString > m_ObjectFileNames;         // Objects compiled from our output files
 };
 
 //------------------------------------------------------------------------------
@@ -21,11 +21,15 @@
 Args::Args()
     : m_Args()
     , m_ResponseFileArgs()
-    , m_DelimiterIndices( 64, true )
+    , m_DelimiterIndices()
     #if defined( ASSERTS_ENABLED )
         , m_Finalized( false )
     #endif
 {
+    // Args only live as long as the job building them, so use its arena
+    m_Args.UseThreadArena();
+    m_DelimiterIndices.UseThreadArena();
+    m_DelimiterIndices.SetCapacity( 64 );
 }
 
 // DESTRUCTOR
@@ -0,0 +1,766 @@
+// BuildHistory
+//------------------------------------------------------------------------------
+
+// Includes
+//------------------------------------------------------------------------------
+#include "BuildHistory.h"
+
+// FBuild
+#include "Tools/FBuild/FBuildCore/FLog.h"
+#include "Tools/FBuild/FBuildCore/Graph/Dependencies.h"
+#include "Tools/FBuild/FBuildCore/Graph/Node.h"
+#include "Tools/FBuild/FBuildCore/Helpers/Compressor.h"
+#include "Tools/FBuild/FBuildCore/Helpers/FBuildStats.h"
+
+// Core
+#include "Core/Env/ErrorFormat.h"
+#include "Core/FileIO/ConstMemoryStream.h"
+#include "Core/FileIO/FileIO.h"
+#include "Core/FileIO/FileStream.h"
+#include "Core/FileIO/MemoryStream.h"
+#include "Core/Math/xxHash.h"
+#include "Core/Mem/Mem.h"
+#include "Core/Profile/Profile.h"
+#include "Core/Strings/AStackString.h"
+#include "Core/Tracing/Tracing.h"
+
+// system
+#include <string.h>
+#include <time.h>
+
+// Defines
+//------------------------------------------------------------------------------
+#define BUILD_HISTORY_VERSION           ( 1 )
+#define BUILD_HISTORY_MAX_FILE_SIZE     ( 64 * MEGABYTE )   // trimmed to half this size when exceeded
+#define BUILD_HISTORY_MAX_RECORD_SIZE   ( BUILD_HISTORY_MAX_FILE_SIZE ) // larger compressed records are corrupt
+#define BUILD_HISTORY_NUM_TREND_BUILDS  ( 10 )              // number of builds to show
+#define BUILD_HISTORY_BASELINE_BUILDS   ( 10 )              // number of previous builds to compare against
+#define BUILD_HISTORY_MIN_TIME_DELTA_MS ( 100 )             // ignore smaller increases in time
+#define BUILD_HISTORY_MAX_REGRESSIONS   ( 50 )              // max items to list per category
+
+// Header
+//------------------------------------------------------------------------------
+static const char g_BuildHistoryHeader[ 4 ] = { 'F', 'B', 'H', BUILD_HISTORY_VERSION };
+
+// NameHashIndex - find a node or library from one record in another
+//------------------------------------------------------------------------------
+struct NameHashIndex
+{
+    uint64_t    m_Hash;
+    uint32_t    m_Index;
+
+    bool operator < ( const NameHashIndex & other ) const { return m_Hash < other.m_Hash; }
+};
+
+// Regression
+//------------------------------------------------------------------------------
+struct Regression
+{
+    const AString * m_Name;
+    uint32_t        m_Baseline;
+    uint32_t        m_Latest;
+
+    // biggest increase first
+    bool operator < ( const Regression & other ) const
+    {
+        return ( (uint64_t)m_Latest * other.m_Baseline ) > ( (uint64_t)other.m_Latest * m_Baseline );
+    }
+};
+
+// Helpers
+//------------------------------------------------------------------------------
+template < class T >
+static void BuildNameHashIndex( const Array< T > & items, Array< NameHashIndex > & outIndex )
+{
+    outIndex.SetCapacity( items.GetSize() );
+    for ( size_t i = 0; i < items.GetSize(); ++i )
+    {
+        outIndex.EmplaceBack();
+        NameHashIndex & entry = outIndex.Top();
+        entry.m_Hash = xxHash::Calc64( items[ i ].m_Name );
+        entry.m_Index = (uint32_t)i;
+    }
+    outIndex.Sort();
+}
+
+static const NameHashIndex * FindNameHash( const Array< NameHashIndex > & index, uint64_t hash )
+{
+    size_t low = 0;
+    size_t high = index.GetSize();
+    while ( low < high )
+    {
+        const size_t mid = ( low + high ) / 2;
+        if ( index[ mid ].m_Hash < hash )
+        {
+            low = mid + 1;
+        }
+        else
+        {
+            high = mid;
+        }
+    }
+    return ( ( low < index.GetSize() ) && ( index[ low ].m_Hash == hash ) ) ? &index[ low ] : nullptr;
+}
+
+static uint32_t GetMedian( uint32_t * values, uint32_t numValues )
+{
+    ASSERT( numValues > 0 );
+    // insertion sort (there are never many values)
+    for ( uint32_t i = 1; i < numValues; ++i )
+    {
+        const uint32_t v = values[ i ];
+        uint32_t j = i;
+        while ( ( j > 0 ) && ( values[ j - 1 ] > v ) )
+        {
+            values[ j ] = values[ j - 1 ];
+            --j;
+        }
+        values[ j ] = v;
+    }
+    return values[ numValues / 2 ];
+}
+
+static bool IsRegression( uint32_t baseline, uint32_t latest, uint32_t thresholdPercent, uint32_t minDelta )
+{
+    if ( latest <= baseline )
+    {
+        return false;
+    }
+    if ( ( latest - baseline ) < minDelta )
+    {
+        return false;
+    }
+    return ( ( (uint64_t)latest * 100 ) > ( (uint64_t)baseline * ( 100 + thresholdPercent ) ) );
+}
+
+static void OutputRegressionList( const char * title, Array< Regression > & regressions, bool isTime )
+{
+    if ( regressions.IsEmpty() )
+    {
+        return;
+    }
+
+    regressions.Sort();
+
+    AStackString< 4096 > output;
+    output.Format( "%s:\n", title );
+    const size_t numToDisplay = Math::Min( regressions.GetSize(), (size_t)BUILD_HISTORY_MAX_REGRESSIONS );
+    for ( size_t i = 0; i < numToDisplay; ++i )
+    {
+        const Regression & r = regressions[ i ];
+        AStackString<> change;
+        if ( r.m_Baseline > 0 )
+        {
+            change.Format( "+%u%%", (uint32_t)( ( (uint64_t)( r.m_Latest - r.m_Baseline ) * 100 ) / r.m_Baseline ) );
+        }
+        else
+        {
+            change = "new";
+        }
+        if ( isTime )
+        {
+            output.AppendFormat( " %-7s %9.3fs (was %.3fs) %s\n", change.Get(), (double)r.m_Latest / 1000.0, (double)r.m_Baseline / 1000.0, r.m_Name->Get() );
+        }
+        else
+        {
+            output.AppendFormat( " %-7s %9u  (was %u) %s\n", change.Get(), r.m_Latest, r.m_Baseline, r.m_Name->Get() );
+        }
+        if ( output.GetLength() > 3072 )
+        {
+            OUTPUT( "%s", output.Get() );
+            output.Clear();
+        }
+    }
+    if ( regressions.GetSize() > numToDisplay )
+    {
+        output.AppendFormat( " ...and %u more\n", (uint32_t)( regressions.GetSize() - numToDisplay ) );
+    }
+    OUTPUT( "%s", output.Get() );
+}
+
+// CONSTRUCTOR
+//------------------------------------------------------------------------------
+BuildHistory::BuildHistory()
+    : m_Records( 256, true )
+{
+}
+
+// DESTRUCTOR
+//------------------------------------------------------------------------------
+BuildHistory::~BuildHistory()
+{
+    for ( BuildRecord * record : m_Records )
+    {
+        FDELETE record;
+    }
+}
+
+// Record
+//------------------------------------------------------------------------------
+/*static*/ bool BuildHistory::Record( const FBuildStats & stats, const AString & historyFile )
+{
+    PROFILE_FUNCTION
+
+    BuildRecord record;
+    GatherRecord( stats, record );
+    return AppendRecord( record, historyFile );
+}
+
+// AppendRecord
+//------------------------------------------------------------------------------
+/*static*/ bool BuildHistory::AppendRecord( const BuildRecord & record, const AString & historyFile )
+{
+    PROFILE_FUNCTION
+
+    // Serialize and compress the record
+    MemoryStream ms;
+    WriteRecord( record, ms );
+    Compressor c;
+    VERIFY( c.Compress( ms.GetData(), ms.GetSize() ) );
+    const uint32_t compressedSize = (uint32_t)c.GetResultSize();
+
+    // Append to the existing history if it's compatible
+    bool append = false;
+    {
+        FileStream existing;
+        if ( existing.Open( historyFile.Get(), FileStream::READ_ONLY ) )
+        {
+            char header[ sizeof( g_BuildHistoryHeader ) ];
+            append = ( existing.ReadBuffer( header, sizeof( header ) ) == sizeof( header ) ) &&
+                     ( memcmp( header, g_BuildHistoryHeader, sizeof( header ) ) == 0 );
+        }
+    }
+
+    FileStream f;
+    if ( f.Open( historyFile.Get(), append ? FileStream::APPEND : FileStream::WRITE_ONLY ) == false )
+    {
+        FLOG_WARN( "Failed to open build history '%s'", historyFile.Get() );
+        return false;
+    }
+    bool ok = true;
+    if ( append == false )
+    {
+        ok = ( f.WriteBuffer( g_BuildHistoryHeader, sizeof( g_BuildHistoryHeader ) ) == sizeof( g_BuildHistoryHeader ) );
+    }
+    ok = ok && f.Write( compressedSize );
+    ok = ok && ( f.WriteBuffer( c.GetResult(), compressedSize ) == compressedSize );
+    const uint64_t fileSize = f.GetFileSize();
+    f.Close();
+
+    if ( ok == false )
+    {
+        FLOG_WARN( "Failed to write build history '%s'", historyFile.Get() );
+        return false;
+    }
+
+    // Discard old records if the history is too big
+    if ( fileSize > BUILD_HISTORY_MAX_FILE_SIZE )
+    {
+        return TrimFile( historyFile );
+    }
+    return true;
+}
+
+// Load
+//------------------------------------------------------------------------------
+bool BuildHistory::Load( const AString & historyFile )
+{
+    PROFILE_FUNCTION
+
+    FileStream f;
+    if ( f.Open( historyFile.Get(), FileStream::READ_ONLY ) == false )
+    {
+        return false;
+    }
+
+    char header[ sizeof( g_BuildHistoryHeader ) ];
+    if ( ( f.ReadBuffer( header, sizeof( header ) ) != sizeof( header ) ) ||
+         ( memcmp( header, g_BuildHistoryHeader, sizeof( header ) ) != 0 ) )
+    {
+        FLOG_WARN( "Build history '%s' is from an incompatible version", historyFile.Get() );
+        return false;
+    }
+
+    const uint64_t fileSize = f.GetFileSize();
+    Array< char > compressed( 0, true );
+    uint32_t compressedSize;
+    while ( f.Read( compressedSize ) )
+    {
+        // validate the size before allocating, as the file may be corrupt
+        if ( ( compressedSize > BUILD_HISTORY_MAX_RECORD_SIZE ) ||
+             ( compressedSize > ( fileSize - f.Tell() ) ) )
+        {
+            FLOG_WARN( "Build history '%s' is truncated", historyFile.Get() );
+            break; // keep the records loaded so far
+        }
+
+        compressed.SetSize( compressedSize );
+        Compressor c;
+        if ( ( f.ReadBuffer( compressed.Begin(), compressedSize ) != compressedSize ) ||
+             ( c.IsValidData( compressed.Begin(), compressedSize ) == false ) ||
+             ( c.Decompress( compressed.Begin() ) == false ) )
+        {
+            FLOG_WARN( "Build history '%s' is truncated", historyFile.Get() );
+            break; // keep the records loaded so far
+        }
+
+        ConstMemoryStream ms( c.GetResult(), c.GetResultSize() );
+        BuildRecord * record = FNEW( BuildRecord );
+        if ( ReadRecord( ms, *record ) == false )
+        {
+            FDELETE record;
+            FLOG_WARN( "Build history '%s' is corrupt", historyFile.Get() );
+            break; // keep the records loaded so far
+        }
+        m_Records.Append( record );
+    }
+
+    return true;
+}
+
+// OutputRegressions
+//------------------------------------------------------------------------------
+void BuildHistory::OutputRegressions( uint32_t thresholdPercent ) const
+{
+    PROFILE_FUNCTION
+
+    if ( m_Records.IsEmpty() )
+    {
+        OUTPUT( "No build history.\n" );
+        return;
+    }
+
+    // Recent builds
+    {
+        AStackString< 4096 > output;
+        output += "--- Recent Builds -----------------------------------------------\n";
+        output += "Date                      Result Time      Local CPU Remote Cache Hits  Built\n";
+        const size_t numRecords = m_Records.GetSize();
+        const size_t first = ( numRecords > BUILD_HISTORY_NUM_TREND_BUILDS ) ? ( numRecords - BUILD_HISTORY_NUM_TREND_BUILDS ) : 0;
+        for ( size_t i = first; i < numRecords; ++i )
+        {
+            const BuildRecord & r = *m_Records[ i ];
+
+            char timeBuffer[ 64 ];
+            const time_t rawTime = (time_t)r.m_Time;
+            const struct tm * timeInfo = localtime( &rawTime ); // TODO:C Consider using localtime_s
+            if ( ( timeInfo == nullptr ) || ( strftime( timeBuffer, sizeof( timeBuffer ), "%a %d-%b-%Y %H:%M:%S", timeInfo ) == 0 ) )
+            {
+                AString::Copy( "?", timeBuffer, 1 );
+            }
+
+            const uint32_t cacheLookups = ( r.m_NumCacheHits + r.m_NumCacheMisses );
+            const float cacheHitPerc = ( cacheLookups > 0 ) ? ( (float)r.m_NumCacheHits * 100.0f / (float)cacheLookups ) : 0.0f;
+            const float remotePerc = ( r.m_NumNodesBuilt > 0 ) ? ( (float)r.m_NumBuiltRemote * 100.0f / (float)r.m_NumNodesBuilt ) : 0.0f;
+
+            output.AppendFormat( "%-25s %-6s %8.3fs %8.3fs %5.1f%% %9.1f%% %6u\n",
+                                 timeBuffer,
+                                 r.m_BuildOK ? "OK" : "FAILED",
+                                 (double)r.m_BuildTimeMS / 1000.0,
+                                 (double)r.m_LocalCPUTimeMS / 1000.0,
+                                 (double)remotePerc,
+                                 (double)cacheHitPerc,
+                                 r.m_NumNodesBuilt );
+        }
+        OUTPUT( "%s", output.Get() );
+    }
+
+    // Compare latest build to the previous builds
+    const BuildRecord & latest = *m_Records.Top();
+    const size_t numBaselineRecords = Math::Min( m_Records.GetSize() - 1, (size_t)BUILD_HISTORY_BASELINE_BUILDS );
+    OUTPUT( "--- Regressions (vs median of %u previous builds, threshold %u%%) ---\n", (uint32_t)numBaselineRecords, thresholdPercent );
+    if ( numBaselineRecords == 0 )
+    {
+        OUTPUT( "No previous builds to compare against.\n" );
+        return;
+    }
+    const BuildRecord * const * baselineBegin = m_Records.End() - 1 - numBaselineRecords;
+    const BuildRecord * const * baselineEnd = m_Records.End() - 1;
+
+    // Nodes
+    Array< Regression > timeRegressions( 0, true );
+    Array< Regression > includeRegressions( 0, true );
+    {
+        const size_t numNodes = latest.m_Nodes.GetSize();
+        Array< NameHashIndex > index( 0, true );
+        BuildNameHashIndex( latest.m_Nodes, index );
+
+        // Gather samples from previous builds for every node in the latest
+        Array< uint32_t > timeSamples( 0, true );
+        Array< uint32_t > includeSamples( 0, true );
+        Array< uint32_t > numTimeSamples( 0, true );
+        Array< uint32_t > numIncludeSamples( 0, true );
+        timeSamples.SetSize( numNodes * BUILD_HISTORY_BASELINE_BUILDS );
+        includeSamples.SetSize( numNodes * BUILD_HISTORY_BASELINE_BUILDS );
+        numTimeSamples.SetSize( numNodes );
+        numIncludeSamples.SetSize( numNodes );
+        memset( numTimeSamples.Begin(), 0, numNodes * sizeof( uint32_t ) );
+        memset( numIncludeSamples.Begin(), 0, numNodes * sizeof( uint32_t ) );
+        for ( const BuildRecord * const * it = baselineBegin; it != baselineEnd; ++it )
+        {
+            for ( const NodeRecord & node : ( *it )->m_Nodes )
+            {
+                const NameHashIndex * found = FindNameHash( index, xxHash::Calc64( node.m_Name ) );
+                if ( found == nullptr )
+                {
+                    continue;
+                }
+                const uint32_t i = found->m_Index;
+                if ( ( node.m_Flags & NodeRecord::FLAG_CACHE_HIT ) == 0 )
+                {
+                    timeSamples[ ( i * BUILD_HISTORY_BASELINE_BUILDS ) + numTimeSamples[ i ]++ ] = node.m_TimeMS;
+                }
+                if ( node.m_NumIncludes > 0 )
+                {
+                    includeSamples[ ( i * BUILD_HISTORY_BASELINE_BUILDS ) + numIncludeSamples[ i ]++ ] = node.m_NumIncludes;
+                }
+            }
+        }
+
+        for ( size_t i = 0; i < numNodes; ++i )
+        {
+            const NodeRecord & node = latest.m_Nodes[ i ];
+            if ( ( numTimeSamples[ i ] > 0 ) && ( ( node.m_Flags & NodeRecord::FLAG_CACHE_HIT ) == 0 ) )
+            {
+                const uint32_t baseline = GetMedian( &timeSamples[ i * BUILD_HISTORY_BASELINE_BUILDS ], numTimeSamples[ i ] );
+                if ( IsRegression( baseline, node.m_TimeMS, thresholdPercent, BUILD_HISTORY_MIN_TIME_DELTA_MS ) )
+                {
+                    timeRegressions.Append( Regression{ &node.m_Name, baseline, node.m_TimeMS } );
+                }
+            }
+            if ( ( numIncludeSamples[ i ] > 0 ) && ( node.m_NumIncludes > 0 ) )
+            {
+                const uint32_t baseline = GetMedian( &includeSamples[ i * BUILD_HISTORY_BASELINE_BUILDS ], numIncludeSamples[ i ] );
+                if ( IsRegression( baseline, node.m_NumIncludes, thresholdPercent, 1 ) )
+                {
+                    includeRegressions.Append( Regression{ &node.m_Name, baseline, node.m_NumIncludes } );
+                }
+            }
+        }
+    }
+
+    // Libraries, compared by average CPU time per object built
+    Array< Regression > libraryRegressions( 0, true );
+    {
+        const size_t numLibs = latest.m_Libraries.GetSize();
+        Array< NameHashIndex > index( 0, true );
+        BuildNameHashIndex( latest.m_Libraries, index );
+
+        Array< uint32_t > samples( 0, true );
+        Array< uint32_t > numSamples( 0, true );
+        samples.SetSize( numLibs * BUILD_HISTORY_BASELINE_BUILDS );
+        numSamples.SetSize( numLibs );
+        memset( numSamples.Begin(), 0, numLibs * sizeof( uint32_t ) );
+        for ( const BuildRecord * const * it = baselineBegin; it != baselineEnd; ++it )
+        {
+            for ( const LibraryRecord & lib : ( *it )->m_Libraries )
+            {
+                if ( lib.m_NumObjectsBuilt == 0 )
+                {
+                    continue;
+                }
+                const NameHashIndex * found = FindNameHash( index, xxHash::Calc64( lib.m_Name ) );
+                if ( found )
+                {
+                    const uint32_t i = found->m_Index;
+                    samples[ ( i * BUILD_HISTORY_BASELINE_BUILDS ) + numSamples[ i ]++ ] = ( lib.m_CPUTimeMS / lib.m_NumObjectsBuilt );
+                }
+            }
+        }
+
+        for ( size_t i = 0; i < numLibs; ++i )
+        {
+            const LibraryRecord & lib = latest.m_Libraries[ i ];
+            if ( ( numSamples[ i ] == 0 ) || ( lib.m_NumObjectsBuilt == 0 ) )
+            {
+                continue;
+            }
+            const uint32_t baseline = GetMedian( &samples[ i * BUILD_HISTORY_BASELINE_BUILDS ], numSamples[ i ] );
+            const uint32_t perObject = ( lib.m_CPUTimeMS / lib.m_NumObjectsBuilt );
+            if ( IsRegression( baseline, perObject, thresholdPercent, BUILD_HISTORY_MIN_TIME_DELTA_MS ) )
+            {
+                libraryRegressions.Append( Regression{ &lib.m_Name, baseline, perObject } );
+            }
+        }
+    }
+
+    if ( timeRegressions.IsEmpty() && includeRegressions.IsEmpty() && libraryRegressions.IsEmpty() )
+    {
+        OUTPUT( "No regressions.\n" );
+        return;
+    }
+    OutputRegressionList( "Build Time", timeRegressions, true );
+    OutputRegressionList( "Include Count", includeRegressions, false );
+    OutputRegressionList( "Library CPU Time (per object)", libraryRegressions, true );
+}
+
+// GatherRecord
+//------------------------------------------------------------------------------
+/*static*/ void BuildHistory::GatherRecord( const FBuildStats & stats, BuildRecord & outRecord )
+{
+    const Node * rootNode = stats.GetRootNode();
+
+    outRecord.m_Time = (uint64_t)time( nullptr );
+    outRecord.m_BuildTimeMS = (uint32_t)( stats.m_TotalBuildTime * 1000.0f );
+    outRecord.m_LocalCPUTimeMS = stats.m_TotalLocalCPUTimeMS;
+    outRecord.m_RemoteCPUTimeMS = stats.m_TotalRemoteCPUTimeMS;
+    outRecord.m_NumCacheHits = stats.GetCacheHits();
+    outRecord.m_NumCacheMisses = stats.GetCacheMisses();
+    outRecord.m_NumCacheStores = stats.GetCacheStores();
+    outRecord.m_BuildOK = ( rootNode->GetState() == Node::UP_TO_DATE );
+
+    // Nodes which did some work
+    const Array< const Node * > & nodes = stats.GetNodesByTime();
+    outRecord.m_Nodes.SetCapacity( nodes.GetSize() );
+    for ( const Node * node : nodes )
+    {
+        if ( node->GetStatFlag( Node::STATS_BUILT ) == false )
+        {
+            continue;
+        }
+
+        outRecord.m_Nodes.EmplaceBack();
+        NodeRecord & nr = outRecord.m_Nodes.Top();
+        nr.m_Name = node->GetName();
+        nr.m_TimeMS = node->GetProcessingTime();
+        if ( node->GetType() == Node::OBJECT_NODE )
+        {
+            nr.m_NumIncludes = (uint32_t)node->GetDynamicDependencies().GetSize();
+        }
+        if ( node->GetStatFlag( Node::STATS_CACHE_HIT ) )
+        {
+            nr.m_Flags |= NodeRecord::FLAG_CACHE_HIT;
+        }
+        if ( node->GetStatFlag( Node::STATS_BUILT_REMOTE ) )
+        {
+            nr.m_Flags |= NodeRecord::FLAG_BUILT_REMOTE;
+            outRecord.m_NumBuiltRemote++;
+        }
+    }
+    outRecord.m_NumNodesBuilt = (uint32_t)outRecord.m_Nodes.GetSize();
+
+    // CPU time per library
+    GatherLibrariesRecurse( rootNode, nullptr, outRecord );
+}
+
+// GatherLibrariesRecurse
+//------------------------------------------------------------------------------
+/*static*/ void BuildHistory::GatherLibrariesRecurse( const Node * node, LibraryRecord * currentLib, BuildRecord & outRecord )
+{
+    // skip nodes we've already seen
+    if ( node->GetStatFlag( Node::STATS_HISTORY_PROCESSED ) )
+    {
+        return;
+    }
+    node->SetStatFlag( Node::STATS_HISTORY_PROCESSED );
+
+    const Node::Type type = node->GetType();
+    if ( type == Node::OBJECT_NODE )
+    {
+        if ( currentLib && node->GetStatFlag( Node::STATS_BUILT ) )
+        {
+            currentLib->m_NumObjectsBuilt++;
+            currentLib->m_CPUTimeMS += node->GetProcessingTime();
+        }
+        return; // Stop recursing at Objects
+    }
+
+    if ( ( type == Node::LIBRARY_NODE ) || ( type == Node::DLL_NODE ) || ( type == Node::OBJECT_LIST_NODE ) )
+    {
+        const size_t libIndex = outRecord.m_Libraries.GetSize();
+        outRecord.m_Libraries.EmplaceBack();
+        outRecord.m_Libraries.Top().m_Name = node->GetName();
+
+        // Accumulate locally, as recursing can grow the array (invalidating references)
+        LibraryRecord local;
+        if ( node->GetStatFlag( Node::STATS_BUILT ) )
+        {
+            local.m_CPUTimeMS += node->GetProcessingTime();
+        }
+        GatherLibrariesRecurse( node->GetPreBuildDependencies(), &local, outRecord );
+        GatherLibrariesRecurse( node->GetStaticDependencies(), &local, outRecord );
+        GatherLibrariesRecurse( node->GetDynamicDependencies(), &local, outRecord );
+        outRecord.m_Libraries[ libIndex ].m_CPUTimeMS = local.m_CPUTimeMS;
+        outRecord.m_Libraries[ libIndex ].m_NumObjectsBuilt = local.m_NumObjectsBuilt;
+        return;
+    }
+
+    GatherLibrariesRecurse( node->GetPreBuildDependencies(), currentLib, outRecord );
+    GatherLibrariesRecurse( node->GetStaticDependencies(), currentLib, outRecord );
+    GatherLibrariesRecurse( node->GetDynamicDependencies(), currentLib, outRecord );
+}
+
+// GatherLibrariesRecurse
+//------------------------------------------------------------------------------
+/*static*/ void BuildHistory::GatherLibrariesRecurse( const Dependencies & dependencies, LibraryRecord * currentLib, BuildRecord & outRecord )
+{
+    const Dependency * const end = dependencies.End();
+    for ( const Dependency * it = dependencies.Begin(); it != end; ++it )
+    {
+        GatherLibrariesRecurse( it->GetNode(), currentLib, outRecord );
+    }
+}
+
+// WriteRecord
+//------------------------------------------------------------------------------
+/*static*/ void BuildHistory::WriteRecord( const BuildRecord & record, IOStream & stream )
+{
+    stream.Write( record.m_Time );
+    stream.Write( record.m_BuildTimeMS );
+    stream.Write( record.m_LocalCPUTimeMS );
+    stream.Write( record.m_RemoteCPUTimeMS );
+    stream.Write( record.m_NumNodesBuilt );
+    stream.Write( record.m_NumBuiltRemote );
+    stream.Write( record.m_NumCacheHits );
+    stream.Write( record.m_NumCacheMisses );
+    stream.Write( record.m_NumCacheStores );
+    stream.Write( record.m_BuildOK );
+
+    stream.Write( (uint32_t)record.m_Libraries.GetSize() );
+    for ( const LibraryRecord & lib : record.m_Libraries )
+    {
+        stream.Write( lib.m_Name );
+        stream.Write( lib.m_CPUTimeMS );
+        stream.Write( lib.m_NumObjectsBuilt );
+    }
+
+    stream.Write( (uint32_t)record.m_Nodes.GetSize() );
+    for ( const NodeRecord & node : record.m_Nodes )
+    {
+        stream.Write( node.m_Name );
+        stream.Write( node.m_TimeMS );
+        stream.Write( node.m_NumIncludes );
+        stream.Write( node.m_Flags );
+    }
+}
+
+// ReadRecord
+//------------------------------------------------------------------------------
+/*static*/ bool BuildHistory::ReadRecord( IOStream & stream, BuildRecord & outRecord )
+{
+    if ( ( stream.Read( outRecord.m_Time ) == false ) ||
+         ( stream.Read( outRecord.m_BuildTimeMS ) == false ) ||
+         ( stream.Read( outRecord.m_LocalCPUTimeMS ) == false ) ||
+         ( stream.Read( outRecord.m_RemoteCPUTimeMS ) == false ) ||
+         ( stream.Read( outRecord.m_NumNodesBuilt ) == false ) ||
+         ( stream.Read( outRecord.m_NumBuiltRemote ) == false ) ||
+         ( stream.Read( outRecord.m_NumCacheHits ) == false ) ||
+         ( stream.Read( outRecord.m_NumCacheMisses ) == false ) ||
+         ( stream.Read( outRecord.m_NumCacheStores ) == false ) ||
+         ( stream.Read( outRecord.m_BuildOK ) == false ) )
+    {
+        return false;
+    }
+
+    uint32_t numLibs;
+    if ( stream.Read( numLibs ) == false )
+    {
+        return false;
+    }
+    outRecord.m_Libraries.SetCapacity( numLibs );
+    for ( uint32_t i = 0; i < numLibs; ++i )
+    {
+        outRecord.m_Libraries.EmplaceBack();
+        LibraryRecord & lib = outRecord.m_Libraries.Top();
+        if ( ( stream.Read( lib.m_Name ) == false ) ||
+             ( stream.Read( lib.m_CPUTimeMS ) == false ) ||
+             ( stream.Read( lib.m_NumObjectsBuilt ) == false ) )
+        {
+            return false;
+        }
+    }
+
+    uint32_t numNodes;
+    if ( stream.Read( numNodes ) == false )
+    {
+        return false;
+    }
+    outRecord.m_Nodes.SetCapacity( numNodes );
+    for ( uint32_t i = 0; i < numNodes; ++i )
+    {
+        outRecord.m_Nodes.EmplaceBack();
+        NodeRecord & node = outRecord.m_Nodes.Top();
+        if ( ( stream.Read( node.m_Name ) == false ) ||
+             ( stream.Read( node.m_TimeMS ) == false ) ||
+             ( stream.Read( node.m_NumIncludes ) == false ) ||
+             ( stream.Read( node.m_Flags ) == false ) )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// TrimFile
+//------------------------------------------------------------------------------
+/*static*/ bool BuildHistory::TrimFile( const AString & historyFile )
+{
+    PROFILE_FUNCTION
+
+    // Load the whole file
+    MemoryStream contents;
+    {
+        FileStream f;
+        if ( f.Open( historyFile.Get(), FileStream::READ_ONLY ) == false )
+        {
+            return false;
+        }
+        const uint64_t fileSize = f.GetFileSize();
+        if ( contents.WriteBuffer( f, fileSize ) != fileSize )
+        {
+            return false;
+        }
+    }
+
+    // Find the first record to keep, so that the file is half the max size
+    const char * data = static_cast< const char * >( contents.GetData() );
+    const size_t dataSize = contents.GetSize();
+    size_t keepPos = sizeof( g_BuildHistoryHeader );
+    while ( ( dataSize - keepPos ) > ( BUILD_HISTORY_MAX_FILE_SIZE / 2 ) )
+    {
+        uint32_t recordSize;
+        if ( ( keepPos + sizeof( recordSize ) ) > dataSize )
+        {
+            break;
+        }
+        memcpy( &recordSize, data + keepPos, sizeof( recordSize ) );
+        if ( ( keepPos + sizeof( recordSize ) + recordSize ) >= dataSize )
+        {
+            break; // always keep the latest record
+        }
+        keepPos += ( sizeof( recordSize ) + recordSize );
+    }
+
+    // Rewrite to a tmp file first, so the history is never left half written
+    AStackString<> tmpFileName( historyFile );
+    tmpFileName += ".tmp";
+    {
+        FileStream f;
+        if ( f.Open( tmpFileName.Get(), FileStream::WRITE_ONLY ) == false )
+        {
+            FLOG_WARN( "Failed to trim build history '%s'", historyFile.Get() );
+            return false;
+        }
+        const uint64_t keepSize = ( dataSize - keepPos );
+        if ( ( f.WriteBuffer( g_BuildHistoryHeader, sizeof( g_BuildHistoryHeader ) ) != sizeof( g_BuildHistoryHeader ) ) ||
+             ( f.WriteBuffer( data + keepPos, keepSize ) != keepSize ) )
+        {
+            f.Close();
+            FileIO::FileDelete( tmpFileName.Get() );
+            FLOG_WARN( "Failed to trim build history '%s'", historyFile.Get() );
+            return false;
+        }
+    }
+
+    // replace the history
+    if ( FileIO::FileMove( tmpFileName, historyFile ) == false )
+    {
+        FileIO::FileDelete( tmpFileName.Get() );
+        FLOG_WARN( "Failed to trim build history '%s'. Error: %s", historyFile.Get(), LAST_ERROR_STR );
+        return false;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,93 @@
+// BuildHistory - Store of per-build statistics for tracking regressions
+//------------------------------------------------------------------------------
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+#include "Core/Containers/Array.h"
+#include "Core/Env/Types.h"
+#include "Core/Strings/AString.h"
+
+// Forward Declarations
+//------------------------------------------------------------------------------
+struct FBuildStats;
+class Dependencies;
+class IOStream;
+class Node;
+
+// BuildHistory
+//  - Each build appends a compressed record to the history file
+//  - The oldest records are discarded once the file exceeds a size limit
+//------------------------------------------------------------------------------
+class BuildHistory
+{
+public:
+    explicit BuildHistory();
+    ~BuildHistory();
+
+    // Append a record of a completed build (stats must have been gathered)
+    static bool Record( const FBuildStats & stats, const AString & historyFile );
+
+    // Load all records from the history file
+    bool Load( const AString & historyFile );
+
+    // Output recent builds, and items in the latest build which are slower or
+    // have more includes than in previous builds by more than thresholdPercent
+    void OutputRegressions( uint32_t thresholdPercent ) const;
+
+    // A node built (or retrieved from the cache) during a build
+    struct NodeRecord
+    {
+        enum Flags : uint8_t
+        {
+            FLAG_CACHE_HIT      = 0x1,
+            FLAG_BUILT_REMOTE   = 0x2,
+        };
+
+        AString     m_Name;
+        uint32_t    m_TimeMS        = 0;
+        uint32_t    m_NumIncludes   = 0;    // objects only
+        uint8_t     m_Flags         = 0;
+    };
+
+    // CPU time for a library (and the objects built for it)
+    struct LibraryRecord
+    {
+        AString     m_Name;
+        uint32_t    m_CPUTimeMS         = 0;
+        uint32_t    m_NumObjectsBuilt   = 0;
+    };
+
+    struct BuildRecord
+    {
+        uint64_t    m_Time              = 0; // seconds since epoch
+        uint32_t    m_BuildTimeMS       = 0;
+        uint32_t    m_LocalCPUTimeMS    = 0;
+        uint32_t    m_RemoteCPUTimeMS   = 0;
+        uint32_t    m_NumNodesBuilt     = 0;
+        uint32_t    m_NumBuiltRemote    = 0;
+        uint32_t    m_NumCacheHits      = 0;
+        uint32_t    m_NumCacheMisses    = 0;
+        uint32_t    m_NumCacheStores    = 0;
+        bool        m_BuildOK           = false;
+        Array< LibraryRecord > m_Libraries;
+        Array< NodeRecord > m_Nodes;
+    };
+
+    const Array< BuildRecord * > & GetRecords() const { return m_Records; }
+
+    // Append a previously gathered (or loaded) record to the history file
+    static bool AppendRecord( const BuildRecord & record, const AString & historyFile );
+
+private:
+    static void GatherRecord( const FBuildStats & stats, BuildRecord & outRecord );
+    static void GatherLibrariesRecurse( const Node * node, LibraryRecord * currentLib, BuildRecord & outRecord );
+    static void GatherLibrariesRecurse( const Dependencies & dependencies, LibraryRecord * currentLib, BuildRecord & outRecord );
+    static void WriteRecord( const BuildRecord & record, IOStream & stream );
+    static bool ReadRecord( IOStream & stream, BuildRecord & outRecord );
+    static bool TrimFile( const AString & historyFile );
+
+    Array< BuildRecord * > m_Records; // oldest first
+};
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,419 @@
+// BuildTrace - Record a timeline of the build as a Chrome Trace Event file
+//------------------------------------------------------------------------------
+
+// Includes
+//------------------------------------------------------------------------------
+#include "BuildTrace.h"
+
+// FBuildCore
+#include "Tools/FBuild/FBuildCore/FLog.h"
+#include "Tools/FBuild/FBuildCore/WorkerPool/WorkerThread.h"
+
+// Core
+#include "Core/Containers/Array.h"
+#include "Core/Env/ErrorFormat.h"
+#include "Core/FileIO/FileStream.h"
+#include "Core/Process/Atomic.h"
+#include "Core/Process/Mutex.h"
+#include "Core/Process/Thread.h"
+#include "Core/Profile/Profile.h"
+#include "Core/Strings/AStackString.h"
+#include "Core/Time/Timer.h"
+
+// Defines
+//------------------------------------------------------------------------------
+#define BUILD_TRACE_PID_LOCAL           ( 1 )
+#define BUILD_TRACE_PID_FIRST_REMOTE    ( 2 )
+#define BUILD_TRACE_LANE_MAIN           ( 0 )
+#define BUILD_TRACE_LANE_FIRST_OTHER    ( 10000 )   // threads other than main and worker threads
+#define BUILD_TRACE_LANE_INVALID        ( 0xFFFFFFFF )
+#define BUILD_TRACE_WRITE_CHUNK_SIZE    ( 1024 * 1024 )
+
+// BuildTraceEvent
+//------------------------------------------------------------------------------
+struct BuildTraceEvent
+{
+    AString         m_Name;
+    AString         m_Args;
+    const char *    m_Category;
+    int64_t         m_StartTime;
+    int64_t         m_EndTime;
+    uint32_t        m_Lane;         // Local lane, or remote worker index
+    char            m_Phase;        // 'X' : span, 'i' : instant, 'C' : counter
+    bool            m_Remote;
+};
+
+// BuildTraceRemoteLane
+//------------------------------------------------------------------------------
+struct BuildTraceRemoteLane
+{
+    uint32_t        m_Worker;
+    uint32_t        m_Lane;
+    int64_t         m_EndTime;
+};
+
+// BuildTraceEventSorter
+//------------------------------------------------------------------------------
+class BuildTraceEventSorter
+{
+public:
+    inline bool operator () ( const BuildTraceEvent * a, const BuildTraceEvent * b ) const
+    {
+        return ( a->m_StartTime < b->m_StartTime );
+    }
+};
+
+// Static Data
+//------------------------------------------------------------------------------
+/*static*/ bool BuildTrace::s_Enabled = false;
+static Mutex g_BuildTraceMutex;
+static AString g_BuildTraceFileName;
+static int64_t g_BuildTraceStartTime = 0;
+static Array< BuildTraceEvent > g_BuildTraceEvents;
+static Array< AString > g_BuildTraceRemoteWorkers;
+static uint32_t g_BuildTraceNextOtherLane = BUILD_TRACE_LANE_FIRST_OTHER;
+static THREAD_LOCAL uint32_t t_BuildTraceLane = BUILD_TRACE_LANE_INVALID;
+
+// JSONEscape
+//------------------------------------------------------------------------------
+static void JSONEscape( const AString & string, AString & outEscaped )
+{
+    for ( const char * pos = string.Get(); pos != string.GetEnd(); ++pos )
+    {
+        const char c = *pos;
+        if ( ( c == '"' ) || ( c == '\\' ) )
+        {
+            outEscaped += '\\';
+            outEscaped += c;
+        }
+        else if ( (unsigned char)c < 0x20 )
+        {
+            outEscaped.AppendFormat( "\\u%04x", (uint32_t)(unsigned char)c );
+        }
+        else
+        {
+            outEscaped += c;
+        }
+    }
+}
+
+// GetTimeUS
+//------------------------------------------------------------------------------
+static double GetTimeUS( int64_t time )
+{
+    return ( (double)( time - g_BuildTraceStartTime ) * 1000000.0 / (double)Timer::GetFrequency() );
+}
+
+// Start
+//------------------------------------------------------------------------------
+/*static*/ void BuildTrace::Start( const AString & fileName )
+{
+    MutexHolder mh( g_BuildTraceMutex );
+
+    g_BuildTraceFileName = fileName;
+    g_BuildTraceStartTime = Timer::GetNow();
+    g_BuildTraceEvents.SetCapacity( 16 * 1024 );
+    g_BuildTraceRemoteWorkers.Clear();
+
+    // (enabled before any threads are started)
+    s_Enabled = true;
+}
+
+// Stop
+//------------------------------------------------------------------------------
+/*static*/ bool BuildTrace::Stop()
+{
+    PROFILE_FUNCTION
+
+    if ( s_Enabled == false )
+    {
+        return true;
+    }
+
+    // (disabled after all threads have stopped)
+    s_Enabled = false;
+
+    MutexHolder mh( g_BuildTraceMutex );
+
+    // Sort by start time. This determines the lanes used by remote workers
+    // and keeps the file readable.
+    Array< const BuildTraceEvent * > events( g_BuildTraceEvents.GetSize(), false );
+    for ( const BuildTraceEvent & event : g_BuildTraceEvents )
+    {
+        events.Append( &event );
+    }
+    events.Sort( BuildTraceEventSorter() );
+
+    FileStream f;
+    bool ok = f.Open( g_BuildTraceFileName.Get(), FileStream::WRITE_ONLY );
+
+    AString buffer( BUILD_TRACE_WRITE_CHUNK_SIZE + 4096 );
+    buffer += "{\"traceEvents\":[\n";
+
+    // Process and thread names
+    buffer.AppendFormat( "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%u,\"args\":{\"name\":\"Local\"}},\n", BUILD_TRACE_PID_LOCAL );
+    buffer.AppendFormat( "{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":%u,\"args\":{\"sort_index\":0}},\n", BUILD_TRACE_PID_LOCAL );
+    for ( size_t i = 0; i < g_BuildTraceRemoteWorkers.GetSize(); ++i )
+    {
+        AStackString<> workerName;
+        JSONEscape( g_BuildTraceRemoteWorkers[ i ], workerName );
+        buffer.AppendFormat( "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%u,\"args\":{\"name\":\"Remote: %s\"}},\n", (uint32_t)( BUILD_TRACE_PID_FIRST_REMOTE + i ), workerName.Get() );
+        buffer.AppendFormat( "{\"name\":\"process_sort_index\",\"ph\":\"M\",\"pid\":%u,\"args\":{\"sort_index\":%u}},\n", (uint32_t)( BUILD_TRACE_PID_FIRST_REMOTE + i ), (uint32_t)( 1 + i ) );
+    }
+    Array< uint32_t > namedLanes( 64, true );
+    Array< BuildTraceRemoteLane > remoteLanes( 64, true );
+
+    AStackString<> name;
+    for ( const BuildTraceEvent * event : events )
+    {
+        uint32_t pid = BUILD_TRACE_PID_LOCAL;
+        uint32_t tid = event->m_Lane;
+        if ( event->m_Remote )
+        {
+            // Use the first lane of this worker which is free, or add one
+            pid = ( BUILD_TRACE_PID_FIRST_REMOTE + event->m_Lane );
+            BuildTraceRemoteLane * freeLane = nullptr;
+            uint32_t numLanes = 0;
+            for ( BuildTraceRemoteLane & lane : remoteLanes )
+            {
+                if ( lane.m_Worker != event->m_Lane )
+                {
+                    continue;
+                }
+                ++numLanes;
+                if ( ( freeLane == nullptr ) && ( lane.m_EndTime <= event->m_StartTime ) )
+                {
+                    freeLane = &lane;
+                }
+            }
+            if ( freeLane == nullptr )
+            {
+                remoteLanes.Append( BuildTraceRemoteLane{ event->m_Lane, numLanes, 0 } );
+                freeLane = &remoteLanes.Top();
+                buffer.AppendFormat( "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":\"Job Slot %u\"}},\n", pid, numLanes, numLanes );
+            }
+            freeLane->m_EndTime = event->m_EndTime;
+            tid = freeLane->m_Lane;
+        }
+        else if ( ( event->m_Phase != 'C' ) && ( namedLanes.Find( tid ) == nullptr ) )
+        {
+            namedLanes.Append( tid );
+            if ( tid == BUILD_TRACE_LANE_MAIN )
+            {
+                name = "Main Thread";
+            }
+            else if ( tid < BUILD_TRACE_LANE_FIRST_OTHER )
+            {
+                name.Format( "Worker Thread %u", tid );
+            }
+            else
+            {
+                name.Format( "Thread %u", tid - BUILD_TRACE_LANE_FIRST_OTHER );
+            }
+            buffer.AppendFormat( "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":\"%s\"}},\n", pid, tid, name.Get() );
+            buffer.AppendFormat( "{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"sort_index\":%u}},\n", pid, tid, tid );
+        }
+
+        name.Clear();
+        JSONEscape( event->m_Name, name );
+
+        buffer.AppendFormat( "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":%u,\"tid\":%u",
+                             name.Get(),
+                             event->m_Category,
+                             event->m_Phase,
+                             GetTimeUS( event->m_StartTime ),
+                             pid,
+                             tid );
+        if ( event->m_Phase == 'X' )
+        {
+            buffer.AppendFormat( ",\"dur\":%.3f", GetTimeUS( event->m_EndTime ) - GetTimeUS( event->m_StartTime ) );
+        }
+        else if ( event->m_Phase == 'i' )
+        {
+            buffer += ",\"s\":\"t\"";
+        }
+        if ( event->m_Args.IsEmpty() == false )
+        {
+            buffer += ",\"args\":{";
+            buffer += event->m_Args;
+            buffer += '}';
+        }
+        buffer += "},\n";
+
+        // Flush periodically to avoid holding the whole file in memory
+        if ( buffer.GetLength() >= BUILD_TRACE_WRITE_CHUNK_SIZE )
+        {
+            ok = ok && ( f.WriteBuffer( buffer.Get(), buffer.GetLength() ) == buffer.GetLength() );
+            buffer.Clear();
+        }
+    }
+
+    // Terminate the array with an event, to avoid a trailing comma
+    buffer.AppendFormat( "{\"name\":\"Build\",\"cat\":\"build\",\"ph\":\"X\",\"ts\":0,\"dur\":%.3f,\"pid\":%u,\"tid\":%u}\n",
+                         GetTimeUS( Timer::GetNow() ),
+                         BUILD_TRACE_PID_LOCAL,
+                         BUILD_TRACE_LANE_MAIN );
+    buffer += "],\"displayTimeUnit\":\"ms\"}\n";
+    ok = ok && ( f.WriteBuffer( buffer.Get(), buffer.GetLength() ) == buffer.GetLength() );
+    if ( f.IsOpen() )
+    {
+        f.Close();
+    }
+
+    if ( ok == false )
+    {
+        FLOG_ERROR( "Failed to write trace file. Error: %s File: '%s'", LAST_ERROR_STR, g_BuildTraceFileName.Get() );
+    }
+
+    g_BuildTraceEvents.Destruct();
+    g_BuildTraceRemoteWorkers.Destruct();
+
+    return ok;
+}
+
+// AddSpan
+//------------------------------------------------------------------------------
+/*static*/ void BuildTrace::AddSpan( const char * category, const char * name, int64_t startTime, int64_t endTime, const char * args )
+{
+    if ( s_Enabled == false )
+    {
+        return;
+    }
+
+    const uint32_t lane = GetLane();
+
+    MutexHolder mh( g_BuildTraceMutex );
+    g_BuildTraceEvents.EmplaceBack();
+    BuildTraceEvent & event = g_BuildTraceEvents.Top();
+    event.m_Name = name;
+    event.m_Args = args ? args : "";
+    event.m_Category = category;
+    event.m_StartTime = startTime;
+    event.m_EndTime = endTime;
+    event.m_Lane = lane;
+    event.m_Phase = 'X';
+    event.m_Remote = false;
+}
+
+// AddRemoteSpan
+//------------------------------------------------------------------------------
+/*static*/ void BuildTrace::AddRemoteSpan( const AString & workerName, const char * category, const char * name, int64_t startTime, int64_t endTime, const char * args )
+{
+    if ( s_Enabled == false )
+    {
+        return;
+    }
+
+    MutexHolder mh( g_BuildTraceMutex );
+
+    const AString * worker = g_BuildTraceRemoteWorkers.Find( workerName );
+    if ( worker == nullptr )
+    {
+        g_BuildTraceRemoteWorkers.Append( workerName );
+        worker = &g_BuildTraceRemoteWorkers.Top();
+    }
+
+    g_BuildTraceEvents.EmplaceBack();
+    BuildTraceEvent & event = g_BuildTraceEvents.Top();
+    event.m_Name = name;
+    event.m_Args = args ? args : "";
+    event.m_Category = category;
+    event.m_StartTime = startTime;
+    event.m_EndTime = endTime;
+    event.m_Lane = (uint32_t)( worker - g_BuildTraceRemoteWorkers.Begin() );
+    event.m_Phase = 'X';
+    event.m_Remote = true;
+}
+
+// AddInstant
+//------------------------------------------------------------------------------
+/*static*/ void BuildTrace::AddInstant( const char * category, const char * name, const char * args )
+{
+    if ( s_Enabled == false )
+    {
+        return;
+    }
+
+    const uint32_t lane = GetLane();
+    const int64_t now = Timer::GetNow();
+
+    MutexHolder mh( g_BuildTraceMutex );
+    g_BuildTraceEvents.EmplaceBack();
+    BuildTraceEvent & event = g_BuildTraceEvents.Top();
+    event.m_Name = name;
+    event.m_Args = args ? args : "";
+    event.m_Category = category;
+    event.m_StartTime = now;
+    event.m_EndTime = now;
+    event.m_Lane = lane;
+    event.m_Phase = 'i';
+    event.m_Remote = false;
+}
+
+// AddJobQueueSample
+//------------------------------------------------------------------------------
+/*static*/ void BuildTrace::AddJobQueueSample( uint32_t numJobs, uint32_t numJobsActive, uint32_t numJobsDist, uint32_t numJobsDistActive )
+{
+    if ( s_Enabled == false )
+    {
+        return;
+    }
+
+    const int64_t now = Timer::GetNow();
+
+    MutexHolder mh( g_BuildTraceMutex );
+    g_BuildTraceEvents.EmplaceBack();
+    BuildTraceEvent & event = g_BuildTraceEvents.Top();
+    event.m_Name = "Job Queue";
+    event.m_Args.Format( "\"Queued\":%u,\"Active\":%u,\"Distributable Queued\":%u,\"Distributable Active\":%u",
+                         numJobs, numJobsActive, numJobsDist, numJobsDistActive );
+    event.m_Category = "queue";
+    event.m_StartTime = now;
+    event.m_EndTime = now;
+    event.m_Lane = BUILD_TRACE_LANE_MAIN;
+    event.m_Phase = 'C';
+    event.m_Remote = false;
+}
+
+// GetLane
+//------------------------------------------------------------------------------
+/*static*/ uint32_t BuildTrace::GetLane()
+{
+    if ( t_BuildTraceLane == BUILD_TRACE_LANE_INVALID )
+    {
+        if ( Thread::IsMainThread() )
+        {
+            t_BuildTraceLane = BUILD_TRACE_LANE_MAIN;
+        }
+        else if ( WorkerThread::GetThreadIndex() != 0 )
+        {
+            t_BuildTraceLane = WorkerThread::GetThreadIndex();
+        }
+        else
+        {
+            t_BuildTraceLane = ( AtomicIncU32( &g_BuildTraceNextOtherLane ) - 1 );
+        }
+    }
+    return t_BuildTraceLane;
+}
+
+// CONSTRUCTOR
+//------------------------------------------------------------------------------
+BuildTraceSection::BuildTraceSection( const char * category, const char * name )
+    : m_Category( category )
+    , m_Name( name )
+    , m_StartTime( BuildTrace::IsEnabled() ? Timer::GetNow() : 0 )
+{
+}
+
+// DESTRUCTOR
+//------------------------------------------------------------------------------
+BuildTraceSection::~BuildTraceSection()
+{
+    if ( m_StartTime != 0 )
+    {
+        BuildTrace::AddSpan( m_Category, m_Name, m_StartTime, Timer::GetNow(), m_Args.IsEmpty() ? nullptr : m_Args.Get() );
+    }
+}
+
+//------------------------------------------------------------------------------
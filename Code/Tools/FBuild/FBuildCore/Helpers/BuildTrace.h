@@ -0,0 +1,60 @@
+// BuildTrace - Record a timeline of the build as a Chrome Trace Event file
+//------------------------------------------------------------------------------
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+#include "Core/Env/Types.h"
+#include "Core/Strings/AString.h"
+
+// BuildTrace
+//  - Events are recorded on "lanes" (Chrome tids) within a process (pid). The
+//    local build uses one lane per thread; each remote worker gets its own
+//    process, with overlapping jobs spread over as many lanes as required.
+//  - Times are Timer::GetNow() values
+//------------------------------------------------------------------------------
+class BuildTrace
+{
+public:
+    static void Start( const AString & fileName );
+    static bool Stop(); // write the trace file
+
+    inline static bool IsEnabled() { return s_Enabled; }
+
+    // Add a span on the calling thread's lane
+    static void AddSpan( const char * category, const char * name, int64_t startTime, int64_t endTime, const char * args = nullptr );
+
+    // Add a span for a job built by a remote worker
+    static void AddRemoteSpan( const AString & workerName, const char * category, const char * name, int64_t startTime, int64_t endTime, const char * args = nullptr );
+
+    // Add an instantaneous event on the calling thread's lane
+    static void AddInstant( const char * category, const char * name, const char * args = nullptr );
+
+    // Add a sample to the job queue counters
+    static void AddJobQueueSample( uint32_t numJobs, uint32_t numJobsActive, uint32_t numJobsDist, uint32_t numJobsDistActive );
+
+private:
+    static uint32_t GetLane();
+
+    static bool s_Enabled;
+};
+
+// BuildTraceSection - Add a span covering a scope on the calling thread
+//------------------------------------------------------------------------------
+class BuildTraceSection
+{
+public:
+    BuildTraceSection( const char * category, const char * name );
+    ~BuildTraceSection();
+
+    // optional extra properties to attach (JSON members, without braces)
+    inline AString & GetArgs() { return m_Args; }
+
+private:
+    const char *    m_Category;
+    const char *    m_Name;
+    int64_t         m_StartTime;
+    AString         m_Args;
+};
+
+//------------------------------------------------------------------------------
@@ -19,14 +19,22 @@
 //------------------------------------------------------------------------------
 CIncludeParser::CIncludeParser()
     : m_LastCRC1( 0 )
-    , m_CRCs1( 4096, true )
+    , m_CRCs1()
     , m_LastCRC2( 0 )
-    , m_CRCs2( 4096, true )
-    , m_Includes( 4096, true )
+    , m_CRCs2()
+    , m_Includes()
 #ifdef DEBUG
     , m_NonUniqueCount( 0 )
 #endif
 {
+    // Working data is transient, so use the job's arena
+    // (the include strings themselves are kept by the caller, so are not)
+    m_CRCs1.UseThreadArena();
+    m_CRCs1.SetCapacity( 4096 );
+    m_CRCs2.UseThreadArena();
+    m_CRCs2.SetCapacity( 4096 );
+    m_Includes.UseThreadArena();
+    m_Includes.SetCapacity( 4096 );
 }
 
 // DESTRUCTOR
@@ -356,11 +364,13 @@ bool CIncludeParser::ParseGCC_Preprocessed( const char * compilerOutput,
     return true;
 }
 
-// SwapIncludes
+// TakeIncludes
 //------------------------------------------------------------------------------
-void CIncludeParser::SwapIncludes( Array< AString > & includes )
+void CIncludeParser::TakeIncludes( Array< AString > & includes )
 {
-    m_Includes.Swap( includes );
+    // Moves the strings into storage of exactly the right size (if not already big
+    // enough), rather than handing over the generously sized working array
+    includes = Move( m_Includes );
 }
 
 // AddInclude
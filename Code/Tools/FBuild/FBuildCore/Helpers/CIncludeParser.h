@@ -22,8 +22,8 @@ public:
 
     const Array< AString > & GetIncludes() const { return m_Includes; }
 
-    // take ownership of includes array to avoid re-allocations
-    void SwapIncludes( Array< AString > & includes );
+    // take ownership of includes to avoid re-allocations
+    void TakeIncludes( Array< AString > & includes );
     #ifdef DEBUG
         inline size_t GetNonUniqueCount() const { return m_NonUniqueCount; }
     #endif
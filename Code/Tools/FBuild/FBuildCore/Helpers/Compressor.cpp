@@ -40,6 +40,10 @@ Compressor::~Compressor()
 //------------------------------------------------------------------------------
 bool Compressor::IsValidData( const void * data, size_t dataSize ) const
 {
+    if ( dataSize < sizeof( Header ) )
+    {
+        return false;
+    }
     const Header * header = (const Header *)data;
     if ( header->m_CompressionType > 1 )
     {
@@ -56,6 +60,14 @@ bool Compressor::IsValidData( const void * data, size_t dataSize ) const
     return true;
 }
 
+// GetUncompressedSize
+//------------------------------------------------------------------------------
+/*static*/ uint32_t Compressor::GetUncompressedSize( const void * data )
+{
+    ASSERT( data );
+    return ( (const Header *)data )->m_UncompressedSize;
+}
+
 // Compress
 //------------------------------------------------------------------------------
 bool Compressor::Compress( const void * data, size_t dataSize, int32_t compressionLevel )
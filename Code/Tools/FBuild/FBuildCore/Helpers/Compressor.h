@@ -23,6 +23,9 @@ public:
     bool Compress( const void * data, size_t dataSize, int32_t compressionLevel = -1 ); // -1 = default LZ4 compression level
     bool Decompress( const void * data );
 
+    // inspect the header of previously compressed data
+    static uint32_t GetUncompressedSize( const void * data );
+
     const void *    GetResult() const       { return m_Result; }
     size_t          GetResultSize() const   { return m_ResultSize; }
 
@@ -7,6 +7,8 @@
 
 // FBuild
 #include "Tools/FBuild/FBuildCore/FBuild.h"
+#include "Tools/FBuild/FBuildCore/Graph/LinkerNode.h"
+#include "Tools/FBuild/FBuildCore/Helpers/BuildHistory.h"
 #include "Tools/FBuild/FBuildCore/Helpers/Report.h"
 
 // Core
@@ -38,8 +40,21 @@ FBuildStats::FBuildStats()
     , m_TotalBuildTime( 0.0f )
     , m_TotalLocalCPUTimeMS( 0 )
     , m_TotalRemoteCPUTimeMS( 0 )
+    , m_NumRaces( 0 )
+    , m_NumRacesWon( 0 )
+    , m_RaceTimeWonMS( 0 )
+    , m_RaceTimeWastedMS( 0 )
+    , m_NumIncrementalLinks( 0 )
+    , m_IncrementalLinkTimeSavedMS( 0 )
+    , m_RemoteRoundTripP50MS( 0 )
+    , m_RemoteRoundTripP95MS( 0 )
+    , m_RemoteRoundTripP99MS( 0 )
+    , m_RemoteRoundTripMaxMS( 0 )
+    , m_NetworkBytesSent( 0 )
+    , m_NetworkBytesReceived( 0 )
     , m_RootNode( nullptr )
     , m_NodesByTime( 100 * 1000, true )
+    , m_WorkerStats( 0, true )
 {}
 
 // CONSTRUCTOR - FBuildStats::Stats
@@ -56,6 +71,23 @@ FBuildStats::Stats::Stats()
     , m_CachingTimeMS( 0 )
 {}
 
+// CONSTRUCTOR - FBuildStats::WorkerStats
+//------------------------------------------------------------------------------
+FBuildStats::WorkerStats::WorkerStats()
+    : m_NumCPUs( 0 )
+    , m_NumJobs( 0 )
+    , m_NumFailures( 0 )
+    , m_AvgRoundTripMS( 0.0f )
+    , m_JobsPerSecond( 0.0f )
+    , m_MBPerSecond( 0.0f )
+    , m_Score( -1.0f )
+    , m_Replaced( false )
+    , m_NumJobsUncompressed( 0 )
+    , m_NumJobsLZ4( 0 )
+    , m_NumJobsLZ4HC( 0 )
+    , m_PayloadBytesSaved( 0 )
+{}
+
 // OnBuildStop
 //------------------------------------------------------------------------------
 void FBuildStats::OnBuildStop( Node * node )
@@ -67,19 +99,26 @@ void FBuildStats::OnBuildStop( Node * node )
     const FBuildOptions & options = FBuild::Get().GetOptions();
     const bool showSummary = options.m_ShowSummary && ( !options.m_NoSummaryOnError || buildOk );
     const bool generateReport = options.m_GenerateReport;
+    const bool recordHistory = options.m_RecordHistory;
 
     // Any output required?
-    if ( showSummary || generateReport )
+    if ( showSummary || generateReport || recordHistory )
     {
-        // do work common to -summary and -report
+        // do work common to -summary, -report and -recordhistory
         GatherPostBuildStatistics( node );
 
+        // append to build history
+        if ( recordHistory )
+        {
+            BuildHistory::Record( *this, FBuild::Get().GetHistoryFile() );
+        }
+
         // detailed build report
         if ( generateReport )
         {
             Report r;
             r.Generate( *this );
-            r.Save();
+            r.Save( AStackString<>( "report.html" ) );
         }
 
         // stdout summary
@@ -203,6 +242,22 @@ void FBuildStats::OutputSummary() const
     FormatTime( totalRemoteCPUInSeconds, buffer );
     float remoteRatio = ( totalRemoteCPUInSeconds / m_TotalBuildTime );
     output.AppendFormat( " - Remote CPU : %s (%2.1f:1)\n", buffer.Get(), (double)remoteRatio );
+    if ( m_NumRaces > 0 )
+    {
+        AStackString<> wastedBuffer;
+        FormatTime( (float)( (double)m_RaceTimeWonMS / (double)1000 ), buffer );
+        FormatTime( (float)( (double)m_RaceTimeWastedMS / (double)1000 ), wastedBuffer );
+        output += "Races:\n";
+        output.AppendFormat( " - Won        : %u / %u (%s)\n", m_NumRacesWon, m_NumRaces, buffer.Get() );
+        output.AppendFormat( " - Wasted     : %s\n", wastedBuffer.Get() );
+    }
+    if ( m_NumIncrementalLinks > 0 )
+    {
+        FormatTime( (float)( (double)m_IncrementalLinkTimeSavedMS / (double)1000 ), buffer );
+        output += "Incremental Links:\n";
+        output.AppendFormat( " - Links      : %u\n", m_NumIncrementalLinks );
+        output.AppendFormat( " - Time Saved : %s\n", buffer.Get() );
+    }
     output += "-----------------------------------------------------------------\n";
 
     OUTPUT( "%s", output.Get() );
@@ -245,6 +300,16 @@ void FBuildStats::GatherPostBuildStatisticsRecurse( Node * node )
         if ( node->GetStatFlag( Node::STATS_BUILT ) )
         {
             stats.m_NumBuilt++;
+
+            if ( ( nodeType == Node::EXE_NODE ) || ( nodeType == Node::DLL_NODE ) )
+            {
+                const LinkerNode * linkerNode = static_cast< const LinkerNode * >( node );
+                if ( linkerNode->WasLinkedIncrementally() )
+                {
+                    m_NumIncrementalLinks++;
+                    m_IncrementalLinkTimeSavedMS += linkerNode->GetIncrementalLinkTimeSavedMS();
+                }
+            }
         }
         if ( node->GetStatFlag( Node::STATS_FAILED ) )
         {
@@ -5,6 +5,7 @@
 // Includes
 //------------------------------------------------------------------------------
 #include "Core/Env/Types.h"
+#include "Core/Strings/AString.h"
 #include "Tools/FBuild/FBuildCore/Graph/Node.h"
 
 // Forward Declarations
@@ -32,6 +33,16 @@ public:
     uint32_t    m_TotalLocalCPUTimeMS;  // Total CPU time on local host
     uint32_t    m_TotalRemoteCPUTimeMS; // Total CPU time on remote workers
 
+    // local racing of remote jobs
+    uint32_t    m_NumRaces;
+    uint32_t    m_NumRacesWon;          // local build finished first
+    uint32_t    m_RaceTimeWonMS;        // local CPU time spent on races won
+    uint32_t    m_RaceTimeWastedMS;     // local CPU time spent on races lost
+
+    // Incremental Links
+    uint32_t    m_NumIncrementalLinks;
+    uint32_t    m_IncrementalLinkTimeSavedMS; // vs the last full link of each target
+
     // after the build it complete, accumulate all the stats
     void GatherPostBuildStatistics( Node * node );
 
@@ -66,6 +77,38 @@ public:
         uint32_t m_CachingTimeMS;
     };
 
+    // per remote worker stats (captured from the Client when distribution ends)
+    struct WorkerStats
+    {
+        WorkerStats();
+
+        AString  m_Name;
+        uint32_t m_NumCPUs;             // as reported by the worker
+        uint32_t m_NumJobs;             // jobs completed
+        uint32_t m_NumFailures;         // system failures
+        float    m_AvgRoundTripMS;      // smoothed time from send to result
+        float    m_JobsPerSecond;       // completed jobs per second connected
+        float    m_MBPerSecond;         // payload throughput while transferring
+        float    m_Score;               // relative worker quality (<0 if unknown)
+        bool     m_Replaced;            // connection was dropped in favor of another worker
+        uint32_t m_NumJobsUncompressed; // jobs sent without compression
+        uint32_t m_NumJobsLZ4;          // jobs sent with LZ4
+        uint32_t m_NumJobsLZ4HC;        // jobs sent with LZ4HC
+        uint64_t m_PayloadBytesSaved;   // job data bytes saved by compression
+
+        bool operator < ( const WorkerStats & other ) const { return m_Score > other.m_Score; }
+    };
+    Array< WorkerStats > & GetWorkerStatsMutable()      { return m_WorkerStats; }
+    const Array< WorkerStats > & GetWorkerStats() const { return m_WorkerStats; }
+
+    // remote job latency (send to result) and network traffic, captured with WorkerStats
+    uint32_t    m_RemoteRoundTripP50MS;
+    uint32_t    m_RemoteRoundTripP95MS;
+    uint32_t    m_RemoteRoundTripP99MS;
+    uint32_t    m_RemoteRoundTripMaxMS;
+    uint64_t    m_NetworkBytesSent;
+    uint64_t    m_NetworkBytesReceived;
+
     void FormatTime( float timeInSeconds , AString & buffer  ) const;
 
     const Node * GetRootNode() const { return m_RootNode; }
@@ -82,6 +125,8 @@ private:
     Stats m_PerTypeStats[ Node::NUM_NODE_TYPES ];
     Stats m_Totals;
 
+    Array< WorkerStats > m_WorkerStats;
+
     static bool s_IgnoreCompilerNodeDeps;
 };
 
@@ -0,0 +1,231 @@
+// IncludeCost
+//------------------------------------------------------------------------------
+
+// Includes
+//------------------------------------------------------------------------------
+#include "IncludeCost.h"
+
+// FBuild
+#include "Tools/FBuild/FBuildCore/Graph/Dependencies.h"
+#include "Tools/FBuild/FBuildCore/Graph/ObjectNode.h"
+#include "Tools/FBuild/FBuildCore/Helpers/CompilationDatabase.h"
+
+// Core
+#include "Core/FileIO/FileIO.h"
+#include "Core/Math/Conversions.h"
+#include "Core/Profile/Profile.h"
+#include "Core/Strings/AStackString.h"
+
+// system
+#include <string.h>
+
+// Defines
+//------------------------------------------------------------------------------
+#define INCLUDE_COST_PCH_CANDIDATE_RATIO    ( 4 )   // included by at least 1/4 of objects
+#define INCLUDE_COST_IWYU_CANDIDATE_FACTOR  ( 2 )   // more than twice the average cost per include
+
+// CONSTRUCTOR
+//------------------------------------------------------------------------------
+IncludeCost::IncludeCost()
+    : m_Objects( 0, true )
+    , m_Headers( 0, true )
+    , m_HeaderIndices( 0, true )
+    , m_NumObjects( 0 )
+    , m_TotalParsedBytes( 0 )
+    , m_TotalTimeMS( 0.0 )
+    , m_TotalHeaderTimeMS( 0.0 )
+    , m_TotalIncludes( 0 )
+{
+}
+
+// DESTRUCTOR
+//------------------------------------------------------------------------------
+IncludeCost::~IncludeCost() = default;
+
+// Gather
+//------------------------------------------------------------------------------
+void IncludeCost::Gather( const Node * rootNode )
+{
+    PROFILE_FUNCTION
+
+    // Find all the objects
+    GatherObjectsRecurse( rootNode );
+
+    // Attribute the cost of each one to its includes
+    for ( const Node * obj : m_Objects )
+    {
+        ProcessObject( obj );
+    }
+    m_NumObjects = (uint32_t)m_Objects.GetSize();
+
+    m_Headers.Sort();
+}
+
+// IsPCHCandidate
+//------------------------------------------------------------------------------
+bool IncludeCost::IsPCHCandidate( const HeaderCost & header ) const
+{
+    return ( header.m_InPCH == false ) &&
+           ( header.m_Count > 1 ) &&
+           ( ( header.m_Count * INCLUDE_COST_PCH_CANDIDATE_RATIO ) >= m_NumObjects );
+}
+
+// IsIWYUCandidate
+//------------------------------------------------------------------------------
+bool IncludeCost::IsIWYUCandidate( const HeaderCost & header ) const
+{
+    if ( ( header.m_InPCH ) || ( m_TotalIncludes == 0 ) || IsPCHCandidate( header ) )
+    {
+        return false;
+    }
+    const double averageCostPerInclude = ( m_TotalHeaderTimeMS / (double)m_TotalIncludes );
+    const double costPerInclude = ( header.m_TimeMS / (double)header.m_Count );
+    return ( costPerInclude > ( averageCostPerInclude * INCLUDE_COST_IWYU_CANDIDATE_FACTOR ) );
+}
+
+// WriteJSON
+//------------------------------------------------------------------------------
+void IncludeCost::WriteJSON( AString & outJSON ) const
+{
+    outJSON.Format( "{\n\"objects\":%u,\n\"parsedBytes\":%" PRIu64 ",\n\"timeMS\":%.1f,\n\"headers\":[\n",
+                    m_NumObjects, m_TotalParsedBytes, m_TotalTimeMS );
+
+    AStackString<> name;
+    const size_t numHeaders = m_Headers.GetSize();
+    for ( size_t i = 0; i < numHeaders; ++i )
+    {
+        const HeaderCost & h = m_Headers[ i ];
+        name = h.m_Node->GetName();
+        CompilationDatabase::JSONEscape( name );
+        outJSON.AppendFormat( "{\"name\":\"%s\",\"size\":%" PRIu64 ",\"count\":%u,\"parsedBytes\":%" PRIu64 ",\"timeMS\":%.1f,\"pch\":%s,\"pchCandidate\":%s,\"iwyuCandidate\":%s}%s\n",
+                              name.Get(),
+                              h.m_Size,
+                              h.m_Count,
+                              h.m_ParsedBytes,
+                              h.m_TimeMS,
+                              h.m_InPCH ? "true" : "false",
+                              IsPCHCandidate( h ) ? "true" : "false",
+                              IsIWYUCandidate( h ) ? "true" : "false",
+                              ( i + 1 < numHeaders ) ? "," : "" );
+    }
+
+    outJSON += "]\n}\n";
+}
+
+// GatherObjectsRecurse
+//------------------------------------------------------------------------------
+void IncludeCost::GatherObjectsRecurse( const Node * node )
+{
+    // skip nodes we've already seen
+    if ( node->GetStatFlag( Node::STATS_INCLUDES_PROCESSED ) )
+    {
+        return;
+    }
+    node->SetStatFlag( Node::STATS_INCLUDES_PROCESSED );
+
+    if ( node->GetType() == Node::OBJECT_NODE )
+    {
+        m_Objects.Append( node );
+
+        // Objects can depend on other objects (precompiled headers), but not via includes
+        GatherObjectsRecurse( node->GetStaticDependencies() );
+        return;
+    }
+
+    GatherObjectsRecurse( node->GetPreBuildDependencies() );
+    GatherObjectsRecurse( node->GetStaticDependencies() );
+    GatherObjectsRecurse( node->GetDynamicDependencies() );
+}
+
+// GatherObjectsRecurse
+//------------------------------------------------------------------------------
+void IncludeCost::GatherObjectsRecurse( const Dependencies & dependencies )
+{
+    const Dependency * const end = dependencies.End();
+    for ( const Dependency * it = dependencies.Begin(); it != end; ++it )
+    {
+        GatherObjectsRecurse( it->GetNode() );
+    }
+}
+
+// ProcessObject
+//------------------------------------------------------------------------------
+void IncludeCost::ProcessObject( const Node * objectNode )
+{
+    const ObjectNode * obj = objectNode->CastTo< ObjectNode >();
+    const Dependencies & includes = obj->GetDynamicDependencies();
+
+    // Total size of everything parsed for this object
+    uint64_t objectBytes = 0;
+    FileIO::FileInfo sourceInfo;
+    if ( FileIO::GetFileInfo( obj->GetSourceFile()->GetName(), sourceInfo ) )
+    {
+        objectBytes += sourceInfo.m_Size;
+    }
+    const bool creatingPCH = obj->IsCreatingPCH();
+    for ( const Dependency & dep : includes )
+    {
+        HeaderCost & header = GetHeader( dep.GetNode() );
+        header.m_Count++;
+        header.m_ParsedBytes += header.m_Size;
+        header.m_InPCH |= creatingPCH;
+        objectBytes += header.m_Size;
+    }
+    m_TotalParsedBytes += objectBytes;
+    m_TotalIncludes += includes.GetSize();
+
+    // Split the time taken between files, based on size
+    const double timeMS = (double)obj->GetLastBuildTime();
+    m_TotalTimeMS += timeMS;
+    if ( ( objectBytes == 0 ) || ( timeMS == 0.0 ) )
+    {
+        return; // never built, or files are missing
+    }
+    const double msPerByte = ( timeMS / (double)objectBytes );
+    for ( const Dependency & dep : includes )
+    {
+        HeaderCost & header = m_Headers[ m_HeaderIndices[ dep.GetNode()->GetIndex() ] ];
+        const double headerTimeMS = ( (double)header.m_Size * msPerByte );
+        header.m_TimeMS += headerTimeMS;
+        m_TotalHeaderTimeMS += headerTimeMS;
+    }
+}
+
+// GetHeader
+//------------------------------------------------------------------------------
+IncludeCost::HeaderCost & IncludeCost::GetHeader( const Node * node )
+{
+    // Nodes are looked up by index, as there can be a great many of them
+    const uint32_t nodeIndex = node->GetIndex();
+    ASSERT( nodeIndex != INVALID_NODE_INDEX );
+    if ( nodeIndex >= m_HeaderIndices.GetSize() )
+    {
+        const size_t oldSize = m_HeaderIndices.GetSize();
+        const size_t newSize = Math::Max( (size_t)nodeIndex + 1, oldSize * 2 );
+        m_HeaderIndices.SetSize( newSize );
+        memset( m_HeaderIndices.Begin() + oldSize, 0xFF, ( newSize - oldSize ) * sizeof( uint32_t ) );
+    }
+
+    uint32_t & headerIndex = m_HeaderIndices[ nodeIndex ];
+    if ( headerIndex == INVALID_NODE_INDEX )
+    {
+        headerIndex = (uint32_t)m_Headers.GetSize();
+        m_Headers.EmplaceBack();
+        HeaderCost & header = m_Headers.Top();
+        header.m_Node = node;
+        header.m_Size = 0;
+        header.m_ParsedBytes = 0;
+        header.m_TimeMS = 0.0;
+        header.m_Count = 0;
+        header.m_InPCH = false;
+
+        FileIO::FileInfo info;
+        if ( FileIO::GetFileInfo( node->GetName(), info ) )
+        {
+            header.m_Size = info.m_Size;
+        }
+    }
+    return m_Headers[ headerIndex ];
+}
+
+//------------------------------------------------------------------------------
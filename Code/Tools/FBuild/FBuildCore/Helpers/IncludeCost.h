@@ -0,0 +1,72 @@
+// IncludeCost - Attribute compilation cost to included files
+//------------------------------------------------------------------------------
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+#include "Core/Containers/Array.h"
+#include "Core/Env/Types.h"
+
+// Forward Declarations
+//------------------------------------------------------------------------------
+class AString;
+class Dependencies;
+class Node;
+
+// IncludeCost
+//  - Uses the includes discovered for each object (its dynamic dependencies)
+//  - The last build time of each object is split between the source file and
+//    its includes in proportion to their size, then summed for each include
+//------------------------------------------------------------------------------
+class IncludeCost
+{
+public:
+    explicit IncludeCost();
+    ~IncludeCost();
+
+    void Gather( const Node * rootNode );
+
+    struct HeaderCost
+    {
+        const Node *    m_Node;
+        uint64_t        m_Size;         // size of file
+        uint64_t        m_ParsedBytes;  // size * number of includes
+        double          m_TimeMS;       // estimated share of compilation time
+        uint32_t        m_Count;        // number of objects including it
+        bool            m_InPCH;        // included by a precompiled header
+
+        bool operator < ( const HeaderCost & other ) const { return m_TimeMS > other.m_TimeMS; }
+    };
+
+    // sorted by estimated time (most expensive first)
+    const Array< HeaderCost > & GetHeaders() const  { return m_Headers; }
+    uint32_t GetNumObjects() const                  { return m_NumObjects; }
+    uint64_t GetTotalParsedBytes() const            { return m_TotalParsedBytes; }
+    double   GetTotalTimeMS() const                 { return m_TotalTimeMS; }
+
+    // Candidates for adding to a precompiled header are included by many objects,
+    // while others are expensive but only included by a few (so including them
+    // only where needed, or not at all, is more beneficial)
+    bool IsPCHCandidate( const HeaderCost & header ) const;
+    bool IsIWYUCandidate( const HeaderCost & header ) const;
+
+    // machine readable output
+    void WriteJSON( AString & outJSON ) const;
+
+private:
+    void GatherObjectsRecurse( const Node * node );
+    void GatherObjectsRecurse( const Dependencies & dependencies );
+    void ProcessObject( const Node * objectNode );
+    HeaderCost & GetHeader( const Node * node );
+
+    Array< const Node * >   m_Objects;
+    Array< HeaderCost >     m_Headers;
+    Array< uint32_t >       m_HeaderIndices;    // by Node index
+    uint32_t                m_NumObjects;
+    uint64_t                m_TotalParsedBytes;
+    double                  m_TotalTimeMS;
+    double                  m_TotalHeaderTimeMS;
+    uint64_t                m_TotalIncludes;
+};
+
+//------------------------------------------------------------------------------
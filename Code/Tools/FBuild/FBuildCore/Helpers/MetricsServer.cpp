@@ -0,0 +1,123 @@
+// MetricsServer
+//------------------------------------------------------------------------------
+
+// Includes
+//------------------------------------------------------------------------------
+#include "MetricsServer.h"
+
+// Core
+#include "Core/Containers/Move.h"
+#include "Core/Mem/Mem.h"
+#include "Core/Profile/Profile.h"
+
+// Defines
+//------------------------------------------------------------------------------
+#define MAX_REQUEST_SIZE ( 8 * 1024 ) // requests are small, so anything bigger is discarded
+
+// CONSTRUCTOR
+//------------------------------------------------------------------------------
+MetricsServer::MetricsServer()
+    : TCPConnectionPool()
+    , m_Metrics( "{}" )
+{
+    SetUnframed(); // HTTP
+}
+
+// DESTRUCTOR
+//------------------------------------------------------------------------------
+MetricsServer::~MetricsServer()
+{
+    ShutdownAllConnections();
+}
+
+// Start
+//------------------------------------------------------------------------------
+bool MetricsServer::Start( uint16_t port )
+{
+    return Listen( port, true ); // loopback only
+}
+
+// SetMetrics
+//------------------------------------------------------------------------------
+void MetricsServer::SetMetrics( AString & json )
+{
+    MutexHolder mh( m_MetricsMutex );
+    m_Metrics = Move( json );
+}
+
+// OnConnected
+//------------------------------------------------------------------------------
+/*virtual*/ void MetricsServer::OnConnected( const ConnectionInfo * connection )
+{
+    // accumulate request until complete
+    connection->SetUserData( FNEW( AString ) );
+}
+
+// OnDisconnected
+//------------------------------------------------------------------------------
+/*virtual*/ void MetricsServer::OnDisconnected( const ConnectionInfo * connection )
+{
+    AString * request = static_cast< AString * >( connection->GetUserData() );
+    FDELETE request;
+    connection->SetUserData( nullptr );
+}
+
+// OnReceive
+//------------------------------------------------------------------------------
+/*virtual*/ void MetricsServer::OnReceive( const ConnectionInfo * connection, void * data, uint32_t size, bool & /*keepMemory*/ )
+{
+    AString * request = static_cast< AString * >( connection->GetUserData() );
+    ASSERT( request );
+
+    request->Append( static_cast< const char * >( data ), size );
+    if ( request->GetLength() > MAX_REQUEST_SIZE )
+    {
+        Disconnect( connection );
+        return;
+    }
+
+    // wait for end of headers
+    if ( request->Find( "\r\n\r\n" ) || request->Find( "\n\n" ) )
+    {
+        SendResponse( connection, *request );
+        Disconnect( connection );
+    }
+}
+
+// SendResponse
+//------------------------------------------------------------------------------
+void MetricsServer::SendResponse( const ConnectionInfo * connection, const AString & request )
+{
+    PROFILE_FUNCTION
+
+    const char * status = "200 OK";
+    AString body;
+    if ( request.BeginsWith( "GET " ) == false )
+    {
+        status = "405 Method Not Allowed";
+    }
+    else if ( request.BeginsWith( "GET / " ) || request.BeginsWith( "GET /metrics " ) || request.BeginsWith( "GET /metrics?" ) )
+    {
+        MutexHolder mh( m_MetricsMutex );
+        body = m_Metrics;
+    }
+    else
+    {
+        status = "404 Not Found";
+    }
+
+    AString response( (uint32_t)body.GetLength() + 256 );
+    response.Format( "HTTP/1.1 %s\r\n"
+                     "Content-Type: application/json\r\n"
+                     "Content-Length: %u\r\n"
+                     "Cache-Control: no-cache\r\n"
+                     "Connection: close\r\n"
+                     "\r\n",
+                     status,
+                     body.GetLength() );
+    response += body;
+
+    Send( connection, response.Get(), response.GetLength() );
+}
+
+//------------------------------------------------------------------------------
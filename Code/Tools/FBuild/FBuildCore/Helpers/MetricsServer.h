@@ -0,0 +1,38 @@
+// MetricsServer - Serve live build metrics over HTTP
+//------------------------------------------------------------------------------
+#pragma once
+
+// Includes
+//------------------------------------------------------------------------------
+#include "Core/Network/TCPConnectionPool.h"
+#include "Core/Process/Mutex.h"
+#include "Core/Strings/AString.h"
+
+// MetricsServer
+//  - Listens on the loopback interface only
+//  - Responds to "GET /metrics" (or "GET /") with the most recent JSON metrics
+//  - Metrics are provided by the main thread and served from network threads
+//------------------------------------------------------------------------------
+class MetricsServer : public TCPConnectionPool
+{
+public:
+    explicit MetricsServer();
+    virtual ~MetricsServer();
+
+    bool Start( uint16_t port );
+
+    // Replace the metrics being served (contents of json are moved)
+    void SetMetrics( AString & json );
+
+private:
+    virtual void OnConnected( const ConnectionInfo * connection );
+    virtual void OnDisconnected( const ConnectionInfo * connection );
+    virtual void OnReceive( const ConnectionInfo * connection, void * data, uint32_t size, bool & keepMemory );
+
+    void SendResponse( const ConnectionInfo * connection, const AString & request );
+
+    mutable Mutex   m_MetricsMutex;
+    AString         m_Metrics;
+};
+
+//------------------------------------------------------------------------------
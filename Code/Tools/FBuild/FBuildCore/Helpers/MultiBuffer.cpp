@@ -9,6 +9,7 @@
 #include "Core/FileIO/ConstMemoryStream.h"
 #include "Core/FileIO/FileIO.h"
 #include "Core/FileIO/FileStream.h"
+#include "Core/FileIO/MappedFile.h"
 #include "Core/FileIO/MemoryStream.h"
 #include "Core/Strings/AString.h"
 
@@ -43,16 +44,15 @@ bool MultiBuffer::CreateFromFiles( const Array< AString > & fileNames, size_t *
     ASSERT( fileNames.GetSize() <= MAX_FILES );
     ASSERT( ( m_ReadStream == nullptr ) && ( m_WriteStream == nullptr ) );
 
-    uint64_t fileSizes[ MAX_FILES ];
-    FileStream fileStreams[ MAX_FILES ];
+    MappedFile files[ MAX_FILES ];
     const size_t numFiles = fileNames.GetSize();
 
-    // Open all the files and determine their size
+    // Map all the files and determine their size
     uint64_t memSize = sizeof( uint32_t ); // write number of files
     for ( size_t i = 0; i <numFiles; ++i )
     {
-        FileStream& fs = fileStreams[ i ];
-        if ( fs.Open( fileNames[ i ].Get(), FileStream::READ_ONLY ) == false )
+        MappedFile & file = files[ i ];
+        if ( file.Open( fileNames[ i ].Get() ) == false )
         {
             if ( outproblemFileIndex )
             {
@@ -60,9 +60,7 @@ bool MultiBuffer::CreateFromFiles( const Array< AString > & fileNames, size_t *
             }
             return false;
         }
-        const uint64_t fileSize = fs.GetFileSize();
-        memSize += ( sizeof( uint64_t ) + fileSize );
-        fileSizes[ i ] = fileSize;
+        memSize += ( sizeof( uint64_t ) + file.GetSize() );
     }
 
     // Allocate enough space for the concatenated output
@@ -74,21 +72,14 @@ bool MultiBuffer::CreateFromFiles( const Array< AString > & fileNames, size_t *
     // Write size of each file
     for ( size_t i = 0; i <numFiles; ++i )
     {
-        m_WriteStream->Write( (uint64_t)fileSizes[ i ] );
+        m_WriteStream->Write( (uint64_t)files[ i ].GetSize() );
     }
 
-    // Read data for each file
+    // Copy data for each file
     for ( size_t i = 0; i <numFiles; ++i )
     {
-        FileStream & fs = fileStreams[ i ];
-        if ( m_WriteStream->WriteBuffer( fs, fileSizes[ i ] ) != fileSizes[ i ] )
-        {
-            if ( outproblemFileIndex )
-            {
-                *outproblemFileIndex = i;
-            }
-            return false;
-        }
+        const MappedFile & file = files[ i ];
+        m_WriteStream->WriteBuffer( file.GetData(), file.GetSize() );
     }
 
     // Check we wrote as much as we originaly calculated
@@ -23,6 +23,8 @@ public:
     explicit MultiBuffer( const void * data, size_t dataSize );
     ~MultiBuffer();
 
+    enum : uint32_t { MAX_FILES = 4 };
+
     bool CreateFromFiles( const Array< AString > & fileNames, size_t * outProblemFileIndex = nullptr );
     bool ExtractFile( size_t index, const AString& fileName ) const;
 
@@ -32,8 +34,6 @@ public:
     void *          Release( size_t & outSize );
 
 private:
-    enum : uint32_t { MAX_FILES = 4 };
-
     ConstMemoryStream * m_ReadStream;
     MemoryStream *      m_WriteStream;
 };
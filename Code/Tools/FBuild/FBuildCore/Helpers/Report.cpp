@@ -9,11 +9,14 @@
 #include "Tools/FBuild/FBuildCore/FBuild.h"
 #include "Tools/FBuild/FBuildCore/FBuildVersion.h"
 #include "Tools/FBuild/FBuildCore/Graph/ObjectNode.h"
+#include "Tools/FBuild/FBuildCore/Graph/UnityNode.h"
 #include "Tools/FBuild/FBuildCore/Helpers/FBuildStats.h"
 
 // Core
 #include "Core/Env/Env.h"
 #include "Core/FileIO/FileStream.h"
+#include "Core/FileIO/PathUtils.h"
+#include "Core/Math/Conversions.h"
 #include "Core/Strings/AStackString.h"
 
 // system
@@ -53,6 +56,8 @@ uint32_t g_ReportNodeColors[] = {
 //------------------------------------------------------------------------------
 Report::Report()
     : m_LibraryStats( 512, true )
+    , m_UnityNodes( 0, true )
+    , m_UnityStats( 0, true )
     , m_NumPieCharts( 0 )
 {
     // Compile time check to ensure color vector is in sync
@@ -82,6 +87,8 @@ void Report::Generate( const FBuildStats & stats )
 
     // generate some common data used in reporting
     GetLibraryStats( stats );
+    GetUnityStats();
+    m_IncludeCost.Gather( stats.GetRootNode() );
 
     // build the report
     CreateHeader();
@@ -92,10 +99,14 @@ void Report::Generate( const FBuildStats & stats )
 
     DoCPUTimeByType( stats );
     DoCacheStats( stats );
+    DoWorkerStats( stats );
     DoCPUTimeByLibrary();
+    DoUnityFiles();
+    DoUnityBalance();
     DoCPUTimeByItem( stats );
 
     DoIncludes();
+    DoIncludeCost();
 
     CreateFooter();
 
@@ -110,13 +121,39 @@ void Report::Generate( const FBuildStats & stats )
 
 // Save
 //------------------------------------------------------------------------------
-void Report::Save() const
+void Report::Save( const AString & reportFileName ) const
 {
     FileStream f;
-    if ( f.Open( "report.html", FileStream::WRITE_ONLY ) )
+    if ( f.Open( reportFileName.Get(), FileStream::WRITE_ONLY ) )
     {
         f.Write( m_Output.Get(), m_Output.GetLength() );
     }
+
+    // machine readable include costs
+    AString json( 64 * 1024 );
+    m_IncludeCost.WriteJSON( json );
+    AStackString<> jsonFileName;
+    GetIncludeCostFileName( reportFileName, jsonFileName );
+    FileStream jsonFile;
+    if ( jsonFile.Open( jsonFileName.Get(), FileStream::WRITE_ONLY ) )
+    {
+        jsonFile.Write( json.Get(), json.GetLength() );
+    }
+}
+
+// GetIncludeCostFileName
+//------------------------------------------------------------------------------
+/*static*/ void Report::GetIncludeCostFileName( const AString & reportFileName, AString & outFileName )
+{
+    // same directory as the report
+    const char * lastSlash = reportFileName.FindLast( NATIVE_SLASH );
+    const char * lastOtherSlash = reportFileName.FindLast( OTHER_SLASH );
+    if ( ( lastSlash == nullptr ) || ( lastOtherSlash && ( lastOtherSlash > lastSlash ) ) )
+    {
+        lastSlash = lastOtherSlash;
+    }
+    outFileName.Assign( reportFileName.Get(), lastSlash ? ( lastSlash + 1 ) : reportFileName.Get() );
+    outFileName += "includecost.json";
 }
 
 // CreateHeader
@@ -323,6 +360,24 @@ void Report::CreateOverview( const FBuildStats & stats )
     float localRatio = ( totalLocalCPUInSeconds / totalBuildTime );
     Write( "<tr><td>CPU Time</td><td>%s (%2.1f:1)</td></tr>\n", buffer.Get(), (double)localRatio );
 
+    // Local Races
+    if ( stats.m_NumRaces > 0 )
+    {
+        AStackString<> wastedBuffer;
+        stats.FormatTime( (float)( (double)stats.m_RaceTimeWonMS / (double)1000 ), buffer );
+        stats.FormatTime( (float)( (double)stats.m_RaceTimeWastedMS / (double)1000 ), wastedBuffer );
+        Write( "<tr><td>Local Races</td><td>%u won / %u raced - %s won, %s wasted</td></tr>\n",
+               stats.m_NumRacesWon, stats.m_NumRaces, buffer.Get(), wastedBuffer.Get() );
+    }
+
+    // Incremental Links
+    if ( stats.m_NumIncrementalLinks > 0 )
+    {
+        stats.FormatTime( (float)( (double)stats.m_IncrementalLinkTimeSavedMS / (double)1000 ), buffer );
+        Write( "<tr><td>Incremental Links</td><td>%u - %s saved</td></tr>\n",
+               stats.m_NumIncrementalLinks, buffer.Get() );
+    }
+
     // version info
     Write( "<tr><td>Version</td><td>%s %s</td></tr>\n", FBUILD_VERSION_STRING, FBUILD_VERSION_PLATFORM );
 
@@ -450,6 +505,75 @@ void Report::DoCacheStats( const FBuildStats & stats )
     }
 }
 
+// DoWorkerStats
+//------------------------------------------------------------------------------
+void Report::DoWorkerStats( const FBuildStats & stats )
+{
+    const FBuildOptions & options = FBuild::Get().GetOptions();
+    if ( options.m_AllowDistributed == false )
+    {
+        return;
+    }
+
+    DoSectionTitle( "Remote Workers", "remoteWorkers" );
+
+    const Array< FBuildStats::WorkerStats > & workerStats = stats.GetWorkerStats();
+    if ( workerStats.IsEmpty() )
+    {
+        Write( "No jobs were built remotely.\n" );
+        return;
+    }
+
+    DoTableStart();
+
+    // Headings
+    Write( "<tr><th>Worker</th><th style=\"width:60px;\">Score</th><th style=\"width:50px;\">CPUs</th><th style=\"width:60px;\">Jobs</th><th style=\"width:70px;\">Failures</th><th style=\"width:100px;\">Round Trip</th><th style=\"width:70px;\">Jobs/s</th><th style=\"width:70px;\">MiB/s</th><th style=\"width:70px;\">Replaced</th><th style=\"width:150px;\">Compression (None/LZ4/HC)</th><th style=\"width:70px;\">Saved</th></tr>\n" );
+
+    size_t numOutput( 0 );
+    for ( const FBuildStats::WorkerStats & ws : workerStats )
+    {
+        // start collapsable section
+        if ( numOutput == 10 )
+        {
+            DoToggleSection( workerStats.GetSize() - 10 );
+        }
+
+        AStackString<> score;
+        if ( ws.m_Score < 0.0f )
+        {
+            score = "-"; // not enough results to score
+        }
+        else
+        {
+            score.Format( "%2.2f", (double)ws.m_Score );
+        }
+
+        Write( ( numOutput == 10 ) ? "<tr></tr><tr><td>%s</td><td style=\"width:60px;\">%s</td><td style=\"width:50px;\">%u</td><td style=\"width:60px;\">%u</td><td style=\"width:70px;\">%u</td><td style=\"width:100px;\">%2.3fs</td><td style=\"width:70px;\">%2.2f</td><td style=\"width:70px;\">%2.2f</td><td style=\"width:70px;\">%s</td><td style=\"width:150px;\">%u / %u / %u</td><td style=\"width:70px;\">%2.2f MiB</td></tr>\n"
+                                   : "<tr><td>%s</td><td>%s</td><td>%u</td><td>%u</td><td>%u</td><td>%2.3fs</td><td>%2.2f</td><td>%2.2f</td><td>%s</td><td>%u / %u / %u</td><td>%2.2f MiB</td></tr>\n",
+                    ws.m_Name.Get(),
+                    score.Get(),
+                    ws.m_NumCPUs,
+                    ws.m_NumJobs,
+                    ws.m_NumFailures,
+                    (double)( ws.m_AvgRoundTripMS * 0.001f ),
+                    (double)ws.m_JobsPerSecond,
+                    (double)ws.m_MBPerSecond,
+                    ws.m_Replaced ? "YES" : "no",
+                    ws.m_NumJobsUncompressed,
+                    ws.m_NumJobsLZ4,
+                    ws.m_NumJobsLZ4HC,
+                    (double)ws.m_PayloadBytesSaved / (double)MEGABYTE );
+        numOutput++;
+    }
+
+    DoTableStop();
+
+    if ( numOutput > 10 )
+    {
+        Write( "</details>\n" );
+    }
+}
+
 // DoCPUTimeByType
 //------------------------------------------------------------------------------
 void Report::DoCPUTimeByType( const FBuildStats & stats )
@@ -644,6 +768,101 @@ void Report::DoCPUTimeByLibrary()
     }
 }
 
+// DoUnityFiles
+//------------------------------------------------------------------------------
+void Report::DoUnityFiles()
+{
+    // Show how many generated unity files changed, as each change invalidates
+    // the cache entries for the object built from it
+    size_t numBuilt = 0;
+    for ( const UnityNode * unity : m_UnityNodes )
+    {
+        numBuilt += unity->GetStatFlag( Node::STATS_BUILT ) ? 1 : 0;
+    }
+    if ( numBuilt == 0 )
+    {
+        return;
+    }
+
+    DoSectionTitle( "Unity Files", "unityFiles" );
+
+    DoTableStart();
+
+    // Headings
+    Write( "<tr><th style=\"width:80px;\">Changed</th><th style=\"width:80px;\">Total</th><th style=\"width:80px;\">Mode</th><th>Name</th></tr>\n" );
+
+    size_t numOutput( 0 );
+    for ( const UnityNode * unity : m_UnityNodes )
+    {
+        if ( unity->GetStatFlag( Node::STATS_BUILT ) == false )
+        {
+            continue;
+        }
+
+        // start collapsable section
+        if ( numOutput == 10 )
+        {
+            DoToggleSection();
+        }
+
+        const char * mode = unity->IsBucketedByHash() ? "Hash" : unity->IsBalancedByCost() ? "Cost" : "Count";
+        Write( ( numOutput == 10 ) ? "<tr></tr><tr><td style=\"width:80px;\">%u</td><td style=\"width:80px;\">%u</td><td style=\"width:80px;\">%s</td><td>%s</td></tr>\n"
+                                   : "<tr><td>%u</td><td>%u</td><td>%s</td><td>%s</td></tr>\n",
+                                        unity->GetNumUnityFilesChanged(), unity->GetNumUnityFilesToCreate(), mode, unity->GetName().Get() );
+        numOutput++;
+    }
+
+    DoTableStop();
+
+    if ( numOutput > 10 )
+    {
+        Write( "</details>\n" );
+    }
+}
+
+// DoUnityBalance
+//------------------------------------------------------------------------------
+void Report::DoUnityBalance()
+{
+    // Only shown for Unity() nodes using .UnityBalanceByCost
+    if ( m_UnityStats.IsEmpty() )
+    {
+        return;
+    }
+
+    DoSectionTitle( "Unity Balance", "unityBalance" );
+
+    DoTableStart();
+
+    // Headings
+    Write( "<tr><th style=\"width:80px;\">Predicted</th><th style=\"width:80px;\">Actual</th><th style=\"width:60px;\">Error</th><th style=\"width:50px;\">Files</th><th style=\"width:60px;\">Includes</th><th style=\"width:50px;\">Built</th><th>Name</th></tr>\n" );
+
+    size_t numOutput( 0 );
+    for ( const UnityStats & us : m_UnityStats )
+    {
+        // start collapsable section
+        if ( numOutput == 10 )
+        {
+            DoToggleSection();
+        }
+
+        const float predicted = ( (float)us.predictedMS * 0.001f ); // ms to s
+        const float actual = ( (float)us.actualMS * 0.001f ); // ms to s
+        const float error = ( us.predictedMS > 0 ) ? (float)( ( (double)us.actualMS - (double)us.predictedMS ) / (double)us.predictedMS * 100.0 ) : 0.0f;
+        Write( ( numOutput == 10 ) ? "<tr></tr><tr><td style=\"width:80px;\">%2.3fs</td><td style=\"width:80px;\">%2.3fs</td><td style=\"width:60px;\">%+2.1f%%</td><td style=\"width:50px;\">%u</td><td style=\"width:60px;\">%u</td><td style=\"width:50px;\">%s</td><td>%s</td></tr>\n"
+                                   : "<tr><td>%2.3fs</td><td>%2.3fs</td><td>%+2.1f%%</td><td>%u</td><td>%u</td><td>%s</td><td>%s</td></tr>\n",
+                                        (double)predicted, (double)actual, (double)error, us.numFiles, us.numIncludes, us.built ? "Yes" : "No", us.unityFile->Get() );
+        numOutput++;
+    }
+
+    DoTableStop();
+
+    if ( numOutput > 10 )
+    {
+        Write( "</details>\n" );
+    }
+}
+
 // DoIncludes
 //------------------------------------------------------------------------------
 PRAGMA_DISABLE_PUSH_MSVC( 6262 ) // warning C6262: Function uses '262212' bytes of stack
@@ -729,6 +948,105 @@ void Report::DoIncludes()
 }
 PRAGMA_DISABLE_POP_MSVC // warning C6262: Function uses '262212' bytes of stack
 
+// DoIncludeCost
+//------------------------------------------------------------------------------
+void Report::DoIncludeCost()
+{
+    DoSectionTitle( "Include Cost", "includeCost" );
+
+    const Array< IncludeCost::HeaderCost > & headers = m_IncludeCost.GetHeaders();
+    if ( headers.IsEmpty() )
+    {
+        Write( "No includes.\n" );
+        return;
+    }
+
+    const double totalParsedMiB = ( (double)m_IncludeCost.GetTotalParsedBytes() / (double)MEGABYTE );
+    Write( "<p>%u objects parsed %2.1f MiB. Compilation time is attributed to each include in proportion to its size.</p>\n",
+           m_IncludeCost.GetNumObjects(), totalParsedMiB );
+
+    DoTableStart();
+    Write( "<tr><th style=\"width:80px;\">Est. Time</th><th style=\"width:80px;\">Parsed</th><th style=\"width:70px;\">Included</th><th style=\"width:80px;\">Size</th><th style=\"width:50px;\">PCH</th><th>Name</th></tr>\n" );
+
+    // output the most expensive
+    const size_t maxOutput = 100;
+    const size_t numIncludes = Math::Min( headers.GetSize(), maxOutput );
+    for ( size_t i = 0; i < numIncludes; ++i )
+    {
+        const IncludeCost::HeaderCost & h = headers[ i ];
+
+        // start collapsable section
+        if ( i == 10 )
+        {
+            DoToggleSection( numIncludes - 10 );
+        }
+
+        Write( ( i == 10 ) ? "<tr></tr><tr><td style=\"width:80px;\">%2.3fs</td><td style=\"width:80px;\">%2.1f MiB</td><td style=\"width:70px;\">%u</td><td style=\"width:80px;\">%2.1f KiB</td><td style=\"width:50px;\">%s</td><td>%s</td></tr>\n"
+                           : "<tr><td>%2.3fs</td><td>%2.1f MiB</td><td>%u</td><td>%2.1f KiB</td><td>%s</td><td>%s</td></tr>\n",
+                    h.m_TimeMS * 0.001,
+                    (double)h.m_ParsedBytes / (double)MEGABYTE,
+                    h.m_Count,
+                    (double)h.m_Size / (double)KILOBYTE,
+                    h.m_InPCH ? "YES" : "no",
+                    h.m_Node->GetName().Get() );
+    }
+
+    DoTableStop();
+
+    // end collpsable section
+    if ( numIncludes > 10 )
+    {
+        Write( "</details>\n" );
+    }
+
+    DoIncludeCostCandidates( "Precompiled Header Candidates", true );
+    DoIncludeCostCandidates( "Include-What-You-Use Candidates", false );
+}
+
+// DoIncludeCostCandidates
+//------------------------------------------------------------------------------
+void Report::DoIncludeCostCandidates( const char * title, bool pchCandidates )
+{
+    Write( "<h3>%s</h3>\n", title );
+
+    size_t numOutput = 0;
+    const size_t maxOutput = 20;
+    for ( const IncludeCost::HeaderCost & h : m_IncludeCost.GetHeaders() )
+    {
+        const bool candidate = pchCandidates ? m_IncludeCost.IsPCHCandidate( h )
+                                             : m_IncludeCost.IsIWYUCandidate( h );
+        if ( candidate == false )
+        {
+            continue;
+        }
+
+        if ( numOutput == 0 )
+        {
+            DoTableStart();
+            Write( "<tr><th style=\"width:80px;\">Est. Time</th><th style=\"width:70px;\">Included</th><th style=\"width:80px;\">Per Object</th><th>Name</th></tr>\n" );
+        }
+
+        Write( "<tr><td>%2.3fs</td><td>%u</td><td>%2.1fms</td><td>%s</td></tr>\n",
+               h.m_TimeMS * 0.001,
+               h.m_Count,
+               h.m_TimeMS / (double)h.m_Count,
+               h.m_Node->GetName().Get() );
+
+        if ( ++numOutput == maxOutput )
+        {
+            break;
+        }
+    }
+
+    if ( numOutput == 0 )
+    {
+        Write( "None.\n" );
+        return;
+    }
+
+    DoTableStop();
+}
+
 // DoPieChart
 //------------------------------------------------------------------------------
 void Report::DoPieChart( const Array< PieItem > & items, const char * units )
@@ -981,6 +1299,63 @@ void Report::GetLibraryStatsRecurse( Array< LibraryStats * > & libStats, const D
     }
 }
 
+// GetUnityStats
+//------------------------------------------------------------------------------
+void Report::GetUnityStats()
+{
+    // Find the Unity nodes, and compare the predicted cost of each unity file
+    // with the actual time taken to compile the object built from it
+    for ( const LibraryStats * ls : m_LibraryStats )
+    {
+        const Node * library = ls->library;
+        if ( ( library->GetType() != Node::OBJECT_LIST_NODE ) && ( library->GetType() != Node::LIBRARY_NODE ) )
+        {
+            continue;
+        }
+
+        for ( const Dependency & dep : library->GetStaticDependencies() )
+        {
+            if ( dep.GetNode()->GetType() != Node::UNITY_NODE )
+            {
+                continue;
+            }
+            const UnityNode * unity = dep.GetNode()->CastTo< UnityNode >();
+            if ( m_UnityNodes.Find( unity ) )
+            {
+                continue; // Already seen via another ObjectList/Library
+            }
+            m_UnityNodes.Append( unity );
+            if ( unity->IsBalancedByCost() == false )
+            {
+                continue;
+            }
+
+            for ( const UnityOutputFileCost & cost : unity->GetUnityFileCosts() )
+            {
+                for ( const Dependency & objDep : library->GetDynamicDependencies() )
+                {
+                    const Node * obj = objDep.GetNode();
+                    if ( ( obj->GetType() != Node::OBJECT_NODE ) ||
+                         ( obj->CastTo< ObjectNode >()->GetSourceFile()->GetName() != cost.GetUnityFileName() ) )
+                    {
+                        continue;
+                    }
+
+                    UnityStats us;
+                    us.unityFile = &cost.GetUnityFileName();
+                    us.numFiles = cost.GetNumFiles();
+                    us.numIncludes = (uint32_t)obj->GetDynamicDependencies().GetSize();
+                    us.predictedMS = cost.GetPredictedCostMS();
+                    us.actualMS = obj->GetLastBuildTime();
+                    us.built = obj->GetStatFlag( Node::STATS_BUILT );
+                    m_UnityStats.Append( us );
+                    break;
+                }
+            }
+        }
+    }
+}
+
 // GetIncludeFilesRecurse
 //------------------------------------------------------------------------------
 void Report::GetIncludeFilesRecurse( IncludeStatsMap & incStats, const Node * node ) const
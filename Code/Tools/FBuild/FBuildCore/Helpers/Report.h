@@ -4,6 +4,8 @@
 
 // Includes
 //------------------------------------------------------------------------------
+#include "IncludeCost.h"
+
 #include "Core/Containers/Array.h"
 #include "Core/Env/MSVCStaticAnalysis.h"
 #include "Core/Mem/MemPoolBlock.h"
@@ -14,6 +16,7 @@
 struct FBuildStats;
 class Dependencies;
 class Node;
+class UnityNode;
 
 // Report
 //------------------------------------------------------------------------------
@@ -24,7 +27,10 @@ public:
     ~Report();
 
     void Generate( const FBuildStats & stats );
-    void Save() const;
+    void Save( const AString & reportFileName ) const;
+
+    // machine readable include costs are saved alongside the report
+    static void GetIncludeCostFileName( const AString & reportFileName, AString & outFileName );
 
 private:
     // Report sections
@@ -32,10 +38,15 @@ private:
     void CreateTitle();
     void CreateOverview( const FBuildStats & stats );
     void DoCacheStats( const FBuildStats & stats );
+    void DoWorkerStats( const FBuildStats & stats );
     void DoCPUTimeByType( const FBuildStats & stats );
     void DoCPUTimeByItem( const FBuildStats & stats );
     void DoCPUTimeByLibrary();
+    void DoUnityFiles();
+    void DoUnityBalance();
     void DoIncludes();
+    void DoIncludeCost();
+    void DoIncludeCostCandidates( const char * title, bool pchCandidates );
 
     void CreateFooter();
 
@@ -71,6 +82,16 @@ private:
         bool operator < ( const LibraryStats & other ) const { return cpuTimeMS > other.cpuTimeMS; }
     };
 
+    struct UnityStats
+    {
+        const AString * unityFile;
+        uint32_t        numFiles;
+        uint32_t        numIncludes;
+        uint32_t        predictedMS;
+        uint32_t        actualMS;
+        bool            built;
+    };
+
     struct IncludeStats
     {
         const Node *    node;
@@ -113,12 +134,16 @@ private:
     void GetLibraryStats( const FBuildStats & stats );
     void GetLibraryStatsRecurse( Array< LibraryStats * > & libStats, const Node * node, LibraryStats * currentLib ) const;
     void GetLibraryStatsRecurse( Array< LibraryStats * > & libStats, const Dependencies & dependencies, LibraryStats * currentLib ) const;
+    void GetUnityStats();
     void GetIncludeFilesRecurse( IncludeStatsMap & incStats, const Node * node) const;
     void AddInclude( IncludeStatsMap & incStats, const Node * node, const Node * parentNode) const;
 
     // intermediate collected data
     Array< LibraryStats * > m_LibraryStats;
+    Array< const UnityNode * > m_UnityNodes;
+    Array< UnityStats > m_UnityStats;
     uint32_t m_NumPieCharts;
+    IncludeCost m_IncludeCost;
 
     // final output
     AString m_Output;
@@ -11,6 +11,7 @@
 #include "Core/FileIO/ConstMemoryStream.h"
 #include "Core/FileIO/FileIO.h"
 #include "Core/FileIO/FileStream.h"
+#include "Core/FileIO/MappedFile.h"
 #include "Core/FileIO/MemoryStream.h"
 #include "Core/FileIO/PathUtils.h"
 #include "Core/Math/xxHash.h"
@@ -129,28 +130,25 @@ bool ToolManifestFile::DoBuild()
     }
 
     // Load the file content
-    void * uncompressedContent;
-    uint32_t uncompressedContentSize;
-    if ( LoadFile( uncompressedContent, uncompressedContentSize ) == false )
+    MappedFile file;
+    if ( LoadFile( file ) == false )
     {
         return false; // LoadFile emits an error
     }
 
     // Take note of the uncompressed size
-    m_UncompressedContentSize = uncompressedContentSize;
+    m_UncompressedContentSize = (uint32_t)file.GetSize();
 
     // Store the hash and timestamp
-    m_Hash = xxHash::Calc32( uncompressedContent, uncompressedContentSize ); // TODO:C Switch to 64 bit hash
+    m_Hash = xxHash::Calc32( file.GetData(), file.GetSize() ); // TODO:C Switch to 64 bit hash
     m_TimeStamp = FileIO::GetFileLastWriteTime( m_Name );
 
     // Compress and keep the data if it might be useful
     if ( FBuild::Get().GetOptions().m_AllowDistributed )
     {
-        StoreCompressedContent( uncompressedContent, uncompressedContentSize );
+        StoreCompressedContent( file.GetData(), (uint32_t)file.GetSize() );
     }
 
-    FREE( uncompressedContent );
-
     return true;
 }
 
@@ -337,12 +335,13 @@ void ToolManifest::DeserializeFromRemote( IOStream & ms )
         {
             continue; // file is not complete
         }
-        AutoPtr< char > mem( (char *)ALLOC( (size_t)f.GetFileSize() ) );
-        if ( f.Read( mem.Get(), (size_t)f.GetFileSize() ) != f.GetFileSize() )
+        MappedFile mappedFile;
+        if ( ( mappedFile.Open( localFile.Get() ) == false ) ||
+             ( mappedFile.GetSize() != f.GetFileSize() ) )
         {
             continue; // problem reading file
         }
-        if ( xxHash::Calc32( mem.Get(), (size_t)f.GetFileSize() ) != m_Files[ i ].GetHash() )
+        if ( xxHash::Calc32( mappedFile.GetData(), mappedFile.GetSize() ) != m_Files[ i ].GetHash() )
         {
             continue; // file contents unexpected
         }
@@ -512,19 +511,17 @@ const void * ToolManifestFile::GetFileData( size_t & outDataSize ) const
     if ( m_CompressedContent == nullptr )
     {
         // Load the file content
-        void * uncompressedContent;
-        uint32_t uncompressedContentSize;
-        if ( LoadFile( uncompressedContent, uncompressedContentSize ) == false )
+        MappedFile file;
+        if ( LoadFile( file ) == false )
         {
             return nullptr; // LoadFile emits an error
         }
 
         // We should have previously recorded the uncompressed size
-        ASSERT( uncompressedContentSize == m_UncompressedContentSize );
+        ASSERT( file.GetSize() == m_UncompressedContentSize );
 
         // Store the compressed version
-        StoreCompressedContent( uncompressedContent, uncompressedContentSize );
-        FREE( uncompressedContent );
+        StoreCompressedContent( file.GetData(), (uint32_t)file.GetSize() );
     }
     outDataSize = m_CompressedContentSize;
     return m_CompressedContent;
@@ -677,25 +674,20 @@ void ToolManifest::GetRemotePath( AString & path ) const
 
 // LoadFile (ToolManifestFile)
 //------------------------------------------------------------------------------
-bool ToolManifestFile::LoadFile( void * & uncompressedContent, uint32_t & uncompressedContentSize ) const
+bool ToolManifestFile::LoadFile( MappedFile & file ) const
 {
-    // read the file into memory
-    FileStream fs;
-    if ( fs.Open( m_Name.Get(), FileStream::READ_ONLY ) == false )
+    // map the file into memory (it's only hashed and compressed)
+    if ( file.Open( m_Name.Get() ) == false )
     {
         FLOG_ERROR( "Error: opening file '%s' in Compiler ToolManifest\n", m_Name.Get() );
         return false;
     }
-    uncompressedContentSize = (uint32_t)fs.GetFileSize();
-    AutoPtr< void > mem( ALLOC( uncompressedContentSize ) );
-    if ( fs.Read( mem.Get(), uncompressedContentSize ) != uncompressedContentSize )
+    if ( file.GetSize() > 0xFFFFFFFF )
     {
-        FLOG_ERROR( "Error: reading file '%s' in Compiler ToolManifest\n", m_Name.Get() );
+        FLOG_ERROR( "Error: file '%s' in Compiler ToolManifest is too large\n", m_Name.Get() );
         return false;
     }
 
-    uncompressedContent = mem.Release();
-
     return true;
 }
 
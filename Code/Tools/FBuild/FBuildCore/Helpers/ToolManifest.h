@@ -7,6 +7,7 @@
 class Dependencies;
 class FileStream;
 class IOStream;
+class MappedFile;
 class Node;
 
 // Includes
@@ -54,7 +55,7 @@ public:
     void                SetFileLock( FileStream * fileLock )    { m_FileLock = fileLock; }
 
 protected:
-    bool                LoadFile( void * & uncompressedContent, uint32_t & uncompressedContentSize ) const;
+    bool                LoadFile( MappedFile & file ) const;
 
     // common members
     AString          m_Name;
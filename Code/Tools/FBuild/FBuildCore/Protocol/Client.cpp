@@ -12,7 +12,8 @@
 #include "Tools/FBuild/FBuildCore/Graph/FileNode.h"
 #include "Tools/FBuild/FBuildCore/Graph/Node.h"
 #include "Tools/FBuild/FBuildCore/Graph/ObjectNode.h"
-#include <Tools/FBuild/FBuildCore/Helpers/MultiBuffer.h>
+#include "Tools/FBuild/FBuildCore/Helpers/BuildTrace.h"
+#include "Tools/FBuild/FBuildCore/Helpers/FBuildStats.h"
 #include "Tools/FBuild/FBuildCore/WorkerPool/Job.h"
 #include "Tools/FBuild/FBuildCore/WorkerPool/JobQueue.h"
 #include "Tools/FBuild/FBuildCore/Helpers/Compressor.h"
@@ -22,6 +23,7 @@
 #include "Core/FileIO/FileIO.h"
 #include "Core/FileIO/FileStream.h"
 #include "Core/FileIO/MemoryStream.h"
+#include "Core/Math/Conversions.h"
 #include "Core/Math/Random.h"
 #include "Core/Process/Atomic.h"
 #include "Core/Profile/Profile.h"
@@ -30,7 +32,25 @@
 //------------------------------------------------------------------------------
 #define CLIENT_STATUS_UPDATE_FREQUENCY_SECONDS ( 0.1f )
 #define CONNECTION_REATTEMPT_DELAY_TIME ( 10.0f )
+#define CONNECTION_REPLACED_REATTEMPT_DELAY_TIME ( 120.0f )
 #define SYSTEM_ERROR_ATTEMPT_COUNT ( 3 )
+#define WORKER_MIN_JOBS_FOR_SCORE ( 4 )             // results needed before a worker is scored
+#define WORKER_ROUND_TRIP_SMOOTHING ( 0.2f )        // weight of newest sample in round trip average
+#define WORKER_SLOW_SCORE_RATIO ( 0.25f )           // workers scoring below this fraction of the best are "slow"
+#define WORKER_REPLACE_INTERVAL_SECONDS ( 10.0f )   // limit how often slow workers are swapped out
+#define RESULT_TMP_FILE_EXTENSION ".fbtmp"          // results are streamed here, then moved into place
+#define INVALID_RESULT_FILE_KEY ( (uint64_t)-1 )
+#define COMPRESSION_ESTIMATE_SMOOTHING ( 0.1f )     // weight of newest sample in compression estimates
+#define SEND_MIN_SAMPLE_SIZE ( 64 * KILOBYTE )      // smaller sends complete without waiting on the link
+
+// Compression levels (as per Compressor) for each CompressionType
+//------------------------------------------------------------------------------
+static const int32_t s_CompressionLevels[] =
+{
+    0,  // COMPRESSION_NONE
+    -1, // COMPRESSION_LZ4 (default acceleration)
+    9,  // COMPRESSION_LZ4HC (default LZ4HC level)
+};
 #define DIST_INFO( ... ) if ( m_DetailedLogging ) { FLOG_OUTPUT( __VA_ARGS__ ); }
 
 // CONSTRUCTOR
@@ -42,9 +62,20 @@ Client::Client( const Array< AString > & workerList,
     : m_WorkerList( workerList )
     , m_ShouldExit( false )
     , m_DetailedLogging( detailedLogging )
+    , m_PreferredCompressionLevel( s_CompressionLevels[ COMPRESSION_LZ4 ] )
+    , m_NumConnectedWorkers( 0 )
+    , m_NumConnectedWorkerCPUs( 0 )
+    , m_NumRemoteJobsInProgress( 0 )
     , m_WorkerConnectionLimit( workerConnectionLimit )
     , m_Port( port )
 {
+    static_assert( ( sizeof( s_CompressionLevels ) / sizeof( int32_t ) ) == NUM_COMPRESSION_TYPES, "s_CompressionLevels item count doesn't match NUM_COMPRESSION_TYPES" );
+
+    // Initial estimates for preprocessed code, refined as jobs are sent
+    m_CompressionEstimates[ COMPRESSION_NONE ]  = { 1.0f,  2000.0f };
+    m_CompressionEstimates[ COMPRESSION_LZ4 ]   = { 0.35f, 400.0f };
+    m_CompressionEstimates[ COMPRESSION_LZ4HC ] = { 0.25f, 30.0f };
+
     // allocate space for server states
     m_ServerList.SetSize( workerList.GetSize() );
 
@@ -78,6 +109,7 @@ Client::~Client()
 
     MutexHolder mh( ss->m_Mutex );
     DIST_INFO( "Disconnected: %s\n", ss->m_RemoteName.Get() );
+    ss->m_TimeConnected += ss->m_ConnectionTimer.GetElapsed();
     if ( ss->m_Jobs.IsEmpty() == false )
     {
         Job ** it = ss->m_Jobs.Begin();
@@ -88,6 +120,7 @@ Client::~Client()
             JobQueue::Get().ReturnUnfinishedDistributableJob( *it );
             ++it;
         }
+        AtomicSubU32( &m_NumRemoteJobsInProgress, (int32_t)ss->m_Jobs.GetSize() );
         ss->m_Jobs.Clear();
     }
 
@@ -95,8 +128,19 @@ Client::~Client()
     // we had the connection drop between message and payload
     FREE( (void *)( ss->m_CurrentMessage ) );
 
+    // discard partially received results
+    ss->CloseResultFile();
+    ss->m_ResultFileKey = INVALID_RESULT_FILE_KEY;
+    for ( const AString & tmpFileName : ss->m_ResultTmpFiles )
+    {
+        FileIO::FileDelete( tmpFileName.Get() );
+    }
+    ss->m_ResultTmpFiles.Clear();
+
     ss->m_RemoteName.Clear();
     AtomicStoreRelaxed( &ss->m_Connection, static_cast< const ConnectionInfo * >( nullptr ) );
+    AtomicDecU32( &m_NumConnectedWorkers );
+    AtomicSubU32( &m_NumConnectedWorkerCPUs, (int32_t)ss->m_NumCPUs );
     ss->m_CurrentMessage = nullptr;
 }
 
@@ -134,6 +178,12 @@ void Client::ThreadFunc()
             break;
         }
 
+        CancelRemoteJobs();
+        if ( AtomicLoadRelaxed( &m_ShouldExit ) )
+        {
+            break;
+        }
+
         Thread::Sleep( 1 );
         if ( AtomicLoadRelaxed( &m_ShouldExit ) )
         {
@@ -165,6 +215,11 @@ void Client::LookForWorkers()
     // limit maximum concurrent connections
     if ( numConnections >= m_WorkerConnectionLimit )
     {
+        // at the limit, but a slow worker might be swapped for another one
+        if ( numConnections < numWorkers )
+        {
+            ReplaceSlowestWorker();
+        }
         return;
     }
 
@@ -202,17 +257,21 @@ void Client::LookForWorkers()
 
         ASSERT( ss.m_Jobs.IsEmpty() );
 
-        if ( ss.m_DelayTimer.GetElapsed() < CONNECTION_REATTEMPT_DELAY_TIME )
+        if ( ss.m_DelayTimer.GetElapsed() < ss.m_ReattemptDelay )
         {
             continue;
         }
 
         DIST_INFO( "Connecting to: %s\n", m_WorkerList[ i ].Get() );
-        const ConnectionInfo * ci = Connect( m_WorkerList[ i ], m_Port, 2000, &ss ); // 2000ms connection timeout
+        AStackString<> host;
+        uint16_t port;
+        GetWorkerHostAndPort( m_WorkerList[ i ], m_Port, host, port );
+        const ConnectionInfo * ci = Connect( host, port, 2000, &ss ); // 2000ms connection timeout
         if ( ci == nullptr )
         {
             DIST_INFO( " - connection: %s (FAILED)\n", m_WorkerList[ i ].Get() );
             ss.m_DelayTimer.Start(); // reset connection attempt delay
+            ss.m_ReattemptDelay = CONNECTION_REATTEMPT_DELAY_TIME;
         }
         else
         {
@@ -221,7 +280,10 @@ void Client::LookForWorkers()
 
             ss.m_RemoteName = m_WorkerList[ i ];
             AtomicStoreRelaxed( &ss.m_Connection, ci ); // success!
+            AtomicIncU32( &m_NumConnectedWorkers );
+            AtomicAddU32( &m_NumConnectedWorkerCPUs, (int32_t)ss.m_NumCPUs ); // refreshed when the worker next requests a job
             ss.m_NumJobsAvailable = numJobsAvailable;
+            ss.m_ConnectionTimer.Start();
 
             // send connection msg
             Protocol::MsgConnection msg( numJobsAvailable );
@@ -233,6 +295,354 @@ void Client::LookForWorkers()
     }
 }
 
+// GetWorkerHostAndPort
+//  - Workers can be specified as "host:port" to connect to a non-default port
+//    (several workers on one machine for example)
+//------------------------------------------------------------------------------
+/*static*/ void Client::GetWorkerHostAndPort( const AString & worker, uint16_t defaultPort, AString & outHost, uint16_t & outPort )
+{
+    outHost = worker;
+    outPort = defaultPort;
+
+    const char * colon = worker.FindLast( ':' );
+    if ( ( colon == nullptr ) || ( colon[ 1 ] == 0 ) )
+    {
+        return;
+    }
+    uint32_t port = 0;
+    for ( const char * pos = ( colon + 1 ); *pos; ++pos )
+    {
+        if ( ( *pos < '0' ) || ( *pos > '9' ) || ( port > 0xFFFF ) )
+        {
+            return; // not a port
+        }
+        port = ( port * 10 ) + (uint32_t)( *pos - '0' );
+    }
+    if ( ( port == 0 ) || ( port > 0xFFFF ) )
+    {
+        return;
+    }
+
+    outHost.Assign( worker.Get(), colon );
+    outPort = (uint16_t)port;
+}
+
+// ReplaceSlowestWorker
+//------------------------------------------------------------------------------
+void Client::ReplaceSlowestWorker()
+{
+    // m_ServerListMutex must be held by caller
+
+    if ( m_ReplaceWorkerTimer.GetElapsed() < WORKER_REPLACE_INTERVAL_SECONDS )
+    {
+        return;
+    }
+
+    // is there someone to replace a slow worker with?
+    bool haveCandidate = false;
+    for ( ServerState & ss : m_ServerList )
+    {
+        if ( AtomicLoadRelaxed( &ss.m_Connection ) || ss.m_Blacklisted )
+        {
+            continue;
+        }
+        MutexHolder mhSS( ss.m_Mutex );
+        if ( ss.m_DelayTimer.GetElapsed() >= ss.m_ReattemptDelay )
+        {
+            haveCandidate = true;
+            break;
+        }
+    }
+    if ( haveCandidate == false )
+    {
+        return;
+    }
+
+    // find the best and worst of the scored connections
+    float bestScore = 0.0f;
+    float worstScore = 0.0f;
+    ServerState * worst = nullptr;
+    for ( ServerState & ss : m_ServerList )
+    {
+        if ( AtomicLoadRelaxed( &ss.m_Connection ) == nullptr )
+        {
+            continue;
+        }
+        float score;
+        {
+            MutexHolder mhSS( ss.m_Mutex );
+            score = ss.GetScore();
+        }
+        if ( score < 0.0f )
+        {
+            continue; // not enough data
+        }
+        bestScore = Math::Max( bestScore, score );
+        if ( ( worst == nullptr ) || ( score < worstScore ) )
+        {
+            worst = &ss;
+            worstScore = score;
+        }
+    }
+    if ( ( worst == nullptr ) || ( worstScore >= ( bestScore * WORKER_SLOW_SCORE_RATIO ) ) )
+    {
+        return; // nobody is consistently slow
+    }
+
+    MutexHolder mhSS( worst->m_Mutex );
+
+    // don't abandon in-flight work - we'll try again later
+    if ( worst->m_Jobs.IsEmpty() == false )
+    {
+        return;
+    }
+
+    const ConnectionInfo * ci = AtomicLoadRelaxed( &worst->m_Connection );
+    if ( ci == nullptr )
+    {
+        return;
+    }
+
+    DIST_INFO( "Replacing slow worker: %s (Score: %2.2f, Best: %2.2f)\n", worst->m_RemoteName.Get(), (double)worstScore, (double)bestScore );
+
+    worst->m_Replaced = true;
+    worst->m_ReattemptDelay = CONNECTION_REPLACED_REATTEMPT_DELAY_TIME;
+    worst->m_DelayTimer.Start();
+    m_ReplaceWorkerTimer.Start();
+
+    // OnDisconnected will clear the connection and LookForWorkers will
+    // connect to another worker
+    Disconnect( ci );
+}
+
+// ShouldHoldBackJobs
+//------------------------------------------------------------------------------
+bool Client::ShouldHoldBackJobs( const ServerState * ss ) const
+{
+    // m_ServerListMutex must be held by caller
+
+    float score;
+    {
+        MutexHolder mh( ss->m_Mutex );
+        score = ss->GetScore();
+    }
+    if ( score < 0.0f )
+    {
+        return false; // not scored yet - give it work so it can be measured
+    }
+
+    // find the best score
+    float bestScore = 0.0f;
+    for ( const ServerState & other : m_ServerList )
+    {
+        if ( AtomicLoadRelaxed( &other.m_Connection ) )
+        {
+            MutexHolder mh( other.m_Mutex );
+            bestScore = Math::Max( bestScore, other.GetScore() );
+        }
+    }
+    const float slowThreshold = ( bestScore * WORKER_SLOW_SCORE_RATIO );
+    if ( score >= slowThreshold )
+    {
+        return false; // not slow
+    }
+
+    // how many more jobs could the faster workers take right now?
+    size_t fasterCapacity = 0;
+    for ( const ServerState & other : m_ServerList )
+    {
+        if ( ( &other == ss ) || ( AtomicLoadRelaxed( &other.m_Connection ) == nullptr ) )
+        {
+            continue;
+        }
+        MutexHolder mh( other.m_Mutex );
+        if ( other.GetScore() < slowThreshold )
+        {
+            continue; // also slow (unscored workers count as fast)
+        }
+        const size_t numCPUs = Math::Max< size_t >( other.m_NumCPUs, 1 );
+        const size_t inFlight = other.m_Jobs.GetSize();
+        if ( numCPUs > inFlight )
+        {
+            fasterCapacity += ( numCPUs - inFlight );
+        }
+    }
+
+    // only hold back when the faster workers can absorb all remaining work
+    return ( JobQueue::Get().GetNumDistributableJobsAvailable() <= fasterCapacity );
+}
+
+// GetWorkerStats
+//------------------------------------------------------------------------------
+void Client::GetWorkerStats( FBuildStats & stats ) const
+{
+    MutexHolder mh( m_ServerListMutex );
+
+    Array< FBuildStats::WorkerStats > & workerStats = stats.GetWorkerStatsMutable();
+    RoundTripHistogram roundTripTimes;
+    const size_t numWorkers = m_ServerList.GetSize();
+    for ( size_t i = 0; i < numWorkers; ++i )
+    {
+        const ServerState & ss = m_ServerList[ i ];
+        MutexHolder mhSS( ss.m_Mutex );
+
+        // ignore workers that never returned anything
+        if ( ( ss.m_NumJobsCompleted == 0 ) && ( ss.m_NumSystemErrors == 0 ) )
+        {
+            continue;
+        }
+
+        workerStats.EmplaceBack();
+        FBuildStats::WorkerStats & ws = workerStats.Top();
+        ws.m_Name = m_WorkerList[ i ];
+        ws.m_NumCPUs = ss.m_NumCPUs;
+        ws.m_NumJobs = ss.m_NumJobsCompleted;
+        ws.m_NumFailures = ss.m_NumSystemErrors;
+        ws.m_AvgRoundTripMS = ss.m_SmoothedRoundTripMS;
+        ws.m_JobsPerSecond = ss.GetJobsPerSecond();
+        ws.m_MBPerSecond = ss.GetMBPerSecond();
+        ws.m_Score = ss.GetScore();
+        ws.m_Replaced = ss.m_Replaced;
+        ws.m_NumJobsUncompressed = ss.m_NumJobsCompressed[ COMPRESSION_NONE ];
+        ws.m_NumJobsLZ4 = ss.m_NumJobsCompressed[ COMPRESSION_LZ4 ];
+        ws.m_NumJobsLZ4HC = ss.m_NumJobsCompressed[ COMPRESSION_LZ4HC ];
+        ws.m_PayloadBytesSaved = ss.m_PayloadBytesSaved;
+
+        roundTripTimes.Add( ss.m_RoundTripTimes );
+    }
+    workerStats.Sort();
+
+    // latency over all workers
+    if ( roundTripTimes.GetNumSamples() > 0 )
+    {
+        stats.m_RemoteRoundTripP50MS = roundTripTimes.GetPercentileMS( 50 );
+        stats.m_RemoteRoundTripP95MS = roundTripTimes.GetPercentileMS( 95 );
+        stats.m_RemoteRoundTripP99MS = roundTripTimes.GetPercentileMS( 99 );
+        stats.m_RemoteRoundTripMaxMS = roundTripTimes.GetMaxMS();
+    }
+    stats.m_NetworkBytesSent = GetBytesSent();
+    stats.m_NetworkBytesReceived = GetBytesReceived();
+}
+
+// GetWorkerUtilization
+//------------------------------------------------------------------------------
+void Client::GetWorkerUtilization( uint32_t & outNumConnected, uint32_t & outNumCPUs, uint32_t & outNumJobsInProgress ) const
+{
+    // Counters are maintained by the network threads as connections and jobs
+    // change, so sampling doesn't contend with them for the server locks
+    outNumConnected = AtomicLoadRelaxed( &m_NumConnectedWorkers );
+    outNumCPUs = AtomicLoadRelaxed( &m_NumConnectedWorkerCPUs );
+    outNumJobsInProgress = AtomicLoadRelaxed( &m_NumRemoteJobsInProgress );
+}
+
+// GetPreferredCompressionLevel
+//------------------------------------------------------------------------------
+int32_t Client::GetPreferredCompressionLevel() const
+{
+    // Data compressed at this level can usually be sent without re-compression
+    return AtomicLoadRelaxed( &m_PreferredCompressionLevel );
+}
+
+// ChooseCompressionLevel
+//------------------------------------------------------------------------------
+int32_t Client::ChooseCompressionLevel( const ServerState * ss, const Job * job, int32_t & outIdealLevel ) const
+{
+    const int32_t storedLevel = job->GetDataCompressionLevel();
+    outIdealLevel = GetPreferredCompressionLevel();
+
+    // send data as it is until throughput to this worker is known
+    float linkMBPerSecond;
+    {
+        MutexHolder mh( ss->m_Mutex );
+        linkMBPerSecond = ss->m_SendMBPerSecond;
+    }
+    if ( linkMBPerSecond <= 0.0f )
+    {
+        return storedLevel;
+    }
+
+    // Estimate the time to get the data to the worker at each level. Fast links
+    // favor less compression and slow links favor more.
+    // - the best level for this job must account for re-compressing data that
+    //   is not already stored at that level
+    // - the ideal level (used to store future jobs) accounts for compressing
+    //   from scratch, so data isn't compressed needlessly for fast links
+    const float uncompressedMB = ( (float)Compressor::GetUncompressedSize( job->GetData() ) / (float)MEGABYTE );
+    const CompressionType storedType = GetCompressionType( storedLevel );
+
+    MutexHolder mh( m_CompressionMutex );
+    int32_t bestLevel = storedLevel;
+    float bestTime = ( ( uncompressedMB * m_CompressionEstimates[ storedType ].m_Ratio ) / linkMBPerSecond );
+    float idealTime = -1.0f;
+    for ( uint32_t type = 0; type < NUM_COMPRESSION_TYPES; ++type )
+    {
+        const CompressionEstimate & estimate = m_CompressionEstimates[ type ];
+        const float sendTime = ( ( uncompressedMB * estimate.m_Ratio ) / linkMBPerSecond );
+        const float compressTime = ( uncompressedMB / estimate.m_MBPerSecond );
+        if ( ( idealTime < 0.0f ) || ( ( sendTime + compressTime ) < idealTime ) )
+        {
+            idealTime = ( sendTime + compressTime );
+            outIdealLevel = s_CompressionLevels[ type ];
+        }
+        if ( type == storedType )
+        {
+            continue;
+        }
+
+        // a copy kept from an earlier send needs no re-compression
+        size_t recompressedSize;
+        const float recompressTime = job->GetRecompressedData( s_CompressionLevels[ type ], recompressedSize ) ? 0.0f : compressTime;
+        if ( ( sendTime + recompressTime ) < bestTime )
+        {
+            bestTime = ( sendTime + recompressTime );
+            bestLevel = s_CompressionLevels[ type ];
+        }
+    }
+    return bestLevel;
+}
+
+// RecompressJobData
+//------------------------------------------------------------------------------
+bool Client::RecompressJobData( Job * job, int32_t compressionLevel )
+{
+    PROFILE_FUNCTION
+
+    const Timer timer;
+
+    Compressor uncompressed;
+    if ( uncompressed.Decompress( job->GetData() ) == false )
+    {
+        return false;
+    }
+    Compressor recompressed;
+    recompressed.Compress( uncompressed.GetResult(), uncompressed.GetResultSize(), compressionLevel );
+    const size_t recompressedSize = recompressed.GetResultSize();
+    job->OwnRecompressedData( recompressed.ReleaseResult(), recompressedSize, compressionLevel );
+
+    // refine throughput estimate for this level
+    const float elapsed = timer.GetElapsed();
+    if ( elapsed > 0.0f )
+    {
+        const float mbPerSecond = ( ( (float)uncompressed.GetResultSize() / (float)MEGABYTE ) / elapsed );
+
+        MutexHolder mh( m_CompressionMutex );
+        CompressionEstimate & estimate = m_CompressionEstimates[ GetCompressionType( compressionLevel ) ];
+        estimate.m_MBPerSecond += ( mbPerSecond - estimate.m_MBPerSecond ) * COMPRESSION_ESTIMATE_SMOOTHING;
+    }
+    return true;
+}
+
+// GetCompressionType
+//------------------------------------------------------------------------------
+/*static*/ Client::CompressionType Client::GetCompressionType( int32_t compressionLevel )
+{
+    if ( compressionLevel == 0 )
+    {
+        return COMPRESSION_NONE;
+    }
+    return ( compressionLevel < 0 ) ? COMPRESSION_LZ4 : COMPRESSION_LZ4HC;
+}
+
 // CommunicateJobAvailability
 //------------------------------------------------------------------------------
 void Client::CommunicateJobAvailability()
@@ -279,6 +689,56 @@ void Client::CommunicateJobAvailability()
     }
 }
 
+// CancelRemoteJobs
+//------------------------------------------------------------------------------
+void Client::CancelRemoteJobs()
+{
+    PROFILE_FUNCTION
+
+    // any jobs where local races won?
+    Array< uint32_t > jobIds( 0, true );
+    JobQueue::Get().GetRemoteJobsToCancel( jobIds );
+    if ( jobIds.IsEmpty() )
+    {
+        return;
+    }
+
+    MutexHolder mh( m_ServerListMutex );
+    for ( const uint32_t jobId : jobIds )
+    {
+        for ( ServerState & ss : m_ServerList )
+        {
+            MutexHolder ssMH( ss.m_Mutex );
+            Job ** it = ss.m_Jobs.FindDeref( jobId );
+            if ( it == nullptr )
+            {
+                continue;
+            }
+
+            // tell the worker to stop building it, and stop tracking it so any
+            // result already on its way is ignored
+            Job * job = *it;
+            ss.m_Jobs.Erase( it );
+            AtomicDecU32( &m_NumRemoteJobsInProgress );
+            if ( job == ss.m_JobBeingSent )
+            {
+                // not sent yet - SendJob will return it instead of sending it
+                ss.m_JobBeingSentCancelled = true;
+                break;
+            }
+            if ( const ConnectionInfo * connection = AtomicLoadRelaxed( &ss.m_Connection ) )
+            {
+                DIST_INFO( "Cancel: %s - %s (Lost Race)\n", ss.m_RemoteName.Get(), job->GetNode()->GetName().Get() );
+                Protocol::MsgCancelJob msg( jobId );
+                SendMessageInternal( connection, msg );
+            }
+            JobQueue::Get().ReturnUnfinishedDistributableJob( job ); // frees job
+            break;
+        }
+        // Not found if the result was already received
+    }
+}
+
 // SendMessageInternal
 //------------------------------------------------------------------------------
 void Client::SendMessageInternal( const ConnectionInfo * connection, const Protocol::IMessage & msg )
@@ -316,121 +776,217 @@ void Client::SendMessageInternal( const ConnectionInfo * connection, const Proto
 {
     keepMemory = true; // we'll take care of freeing the memory
 
-    MutexHolder mh( m_ServerListMutex );
-
     ServerState * ss = (ServerState *)connection->GetUserData();
     ASSERT( ss );
 
-    // are we expecting a msg, or the payload for a msg?
-    void * payload = nullptr;
-    size_t payloadSize = 0;
-    if ( ss->m_CurrentMessage == nullptr )
     {
-        // message
-        ss->m_CurrentMessage = static_cast< const Protocol::IMessage * >( data );
-        if ( ss->m_CurrentMessage->HasPayload() )
-        {
-            return;
-        }
-    }
-    else
-    {
-        // payload
-        ASSERT( ss->m_CurrentMessage->HasPayload() );
-        payload = data;
-        payloadSize = size;
-    }
-
-    // determine message type
-    const Protocol::IMessage * imsg = ss->m_CurrentMessage;
-    Protocol::MessageType messageType = imsg->GetType();
+        MutexHolder mh( m_ServerListMutex );
 
-    PROTOCOL_DEBUG( "Server -> Client : %u (%s)\n", messageType, GetProtocolMessageDebugName( messageType ) );
-
-    switch ( messageType )
-    {
-        case Protocol::MSG_REQUEST_JOB:
-        {
-            const Protocol::MsgRequestJob * msg = static_cast< const Protocol::MsgRequestJob * >( imsg );
-            Process( connection, msg );
-            break;
-        }
-        case Protocol::MSG_JOB_RESULT:
+        // are we expecting a msg, or the payload for a msg?
+        void * payload = nullptr;
+        size_t payloadSize = 0;
+        if ( ss->m_CurrentMessage == nullptr )
         {
-            const Protocol::MsgJobResult * msg = static_cast< const Protocol::MsgJobResult * >( imsg );
-            Process( connection, msg, payload, payloadSize );
-            break;
-        }
-        case Protocol::MSG_REQUEST_MANIFEST:
-        {
-            const Protocol::MsgRequestManifest * msg = static_cast< const Protocol::MsgRequestManifest * >( imsg );
-            Process( connection, msg );
-            break;
+            // message
+            ss->m_CurrentMessage = static_cast< const Protocol::IMessage * >( data );
+            if ( ss->m_CurrentMessage->HasPayload() )
+            {
+                return;
+            }
         }
-        case Protocol::MSG_REQUEST_FILE:
+        else
         {
-            const Protocol::MsgRequestFile * msg = static_cast< const Protocol::MsgRequestFile * >( imsg );
-            Process( connection, msg );
-            break;
+            // payload
+            ASSERT( ss->m_CurrentMessage->HasPayload() );
+            payload = data;
+            payloadSize = size;
         }
-        default:
+
+        // determine message type
+        const Protocol::IMessage * imsg = ss->m_CurrentMessage;
+        Protocol::MessageType messageType = imsg->GetType();
+
+        PROTOCOL_DEBUG( "Server -> Client : %u (%s)\n", messageType, GetProtocolMessageDebugName( messageType ) );
+
+        switch ( messageType )
         {
-            // unknown message type
-            ASSERT( false ); // this indicates a protocol bug
-            DIST_INFO( "Protocol Error: %s\n", ss->m_RemoteName.Get() );
-            Disconnect( connection );
-            break;
+            case Protocol::MSG_REQUEST_JOB:
+            {
+                const Protocol::MsgRequestJob * msg = static_cast< const Protocol::MsgRequestJob * >( imsg );
+                Process( connection, msg );
+                break;
+            }
+            case Protocol::MSG_JOB_RESULT:
+            {
+                const Protocol::MsgJobResult * msg = static_cast< const Protocol::MsgJobResult * >( imsg );
+                Process( connection, msg, payload, payloadSize );
+                break;
+            }
+            case Protocol::MSG_JOB_RESULT_CHUNK:
+            {
+                const Protocol::MsgJobResultChunk * msg = static_cast< const Protocol::MsgJobResultChunk * >( imsg );
+                Process( connection, msg, payload, payloadSize );
+                break;
+            }
+            case Protocol::MSG_REQUEST_MANIFEST:
+            {
+                const Protocol::MsgRequestManifest * msg = static_cast< const Protocol::MsgRequestManifest * >( imsg );
+                Process( connection, msg );
+                break;
+            }
+            case Protocol::MSG_REQUEST_FILE:
+            {
+                const Protocol::MsgRequestFile * msg = static_cast< const Protocol::MsgRequestFile * >( imsg );
+                Process( connection, msg );
+                break;
+            }
+            default:
+            {
+                // unknown message type
+                ASSERT( false ); // this indicates a protocol bug
+                DIST_INFO( "Protocol Error: %s\n", ss->m_RemoteName.Get() );
+                Disconnect( connection );
+                break;
+            }
         }
+
+        // free everything
+        FREE( (void *)( ss->m_CurrentMessage ) );
+        FREE( payload );
+        ss->m_CurrentMessage = nullptr;
     }
 
-    // free everything
-    FREE( (void *)( ss->m_CurrentMessage ) );
-    FREE( payload );
-    ss->m_CurrentMessage = nullptr;
+    // Send any job picked by MsgRequestJob. Re-compression and serialization can
+    // be slow for large jobs, so this is done without holding m_ServerListMutex.
+    if ( ss->m_JobBeingSent )
+    {
+        SendJob( connection, ss );
+    }
 }
 
 // Process( MsgRequestJob )
 //------------------------------------------------------------------------------
-void Client::Process( const ConnectionInfo * connection, const Protocol::MsgRequestJob * )
+void Client::Process( const ConnectionInfo * connection, const Protocol::MsgRequestJob * msg )
 {
     PROFILE_SECTION( "MsgRequestJob" )
 
     ServerState * ss = (ServerState *)connection->GetUserData();
     ASSERT( ss );
 
-    // no jobs for blacklisted workers
-    if ( ss->m_Blacklisted )
+    float timeScale;
+    {
+        MutexHolder mh( ss->m_Mutex );
+        AtomicAddU32( &m_NumConnectedWorkerCPUs, (int32_t)( msg->GetNumCPUs() - ss->m_NumCPUs ) );
+        ss->m_NumCPUs = msg->GetNumCPUs();
+        timeScale = ss->m_SmoothedTimeScale;
+    }
+
+    // no jobs for blacklisted workers, and hold jobs back from slow
+    // workers when faster ones can take them
+    if ( ss->m_Blacklisted || ShouldHoldBackJobs( ss ) )
     {
         MutexHolder mh( ss->m_Mutex );
-        Protocol::MsgNoJobAvailable msg;
-        SendMessageInternal( connection, msg );
+        Protocol::MsgNoJobAvailable noJobMsg;
+        SendMessageInternal( connection, noJobMsg );
         return;
     }
 
-    Job * job = JobQueue::Get().GetDistributableJobToProcess( true );
+    Job * job = JobQueue::Get().GetDistributableJobToProcess( true, timeScale );
     if ( job == nullptr )
     {
         PROFILE_SECTION( "NoJob" )
         // tell the client we don't have anything right now
         // (we completed or gave away the job already)
         MutexHolder mh( ss->m_Mutex );
-        Protocol::MsgNoJobAvailable msg;
-        SendMessageInternal( connection, msg );
+        Protocol::MsgNoJobAvailable noJobMsg;
+        SendMessageInternal( connection, noJobMsg );
         return;
     }
 
+    // Track the job now, so a local race won while it's being sent can cancel it.
+    // OnReceive sends it (SendJob) once m_ServerListMutex is released.
+    MutexHolder mh( ss->m_Mutex );
+    ss->m_Jobs.Append( job ); // Track in-flight job
+    AtomicIncU32( &m_NumRemoteJobsInProgress );
+    ss->m_JobBeingSent = job;
+    ss->m_JobBeingSentCancelled = false;
+}
+
+// SendJob
+//------------------------------------------------------------------------------
+void Client::SendJob( const ConnectionInfo * connection, ServerState * ss )
+{
+    PROFILE_FUNCTION
+
+    // The job can't be freed while being prepared, as CancelRemoteJobs leaves
+    // it for us to return, and disconnection is handled by this thread
+    Job * job = ss->m_JobBeingSent;
+    ASSERT( job );
+
+    // pick the compression that gets the job to this worker soonest
+    // (the job data is unchanged, as it may be raced locally)
+    const void * recompressedData = nullptr;
+    size_t recompressedSize = 0;
+    CompressionType compressionType = COMPRESSION_NONE;
+    uint32_t uncompressedSize = 0;
+    if ( job->IsDataCompressed() )
+    {
+        int32_t idealLevel;
+        int32_t compressionLevel = ChooseCompressionLevel( ss, job, idealLevel );
+        if ( compressionLevel != job->GetDataCompressionLevel() )
+        {
+            // re-use a copy from an earlier send at this level if possible
+            recompressedData = job->GetRecompressedData( compressionLevel, recompressedSize );
+            if ( ( recompressedData == nullptr ) && RecompressJobData( job, compressionLevel ) )
+            {
+                recompressedData = job->GetRecompressedData( compressionLevel, recompressedSize );
+            }
+            if ( recompressedData == nullptr )
+            {
+                ASSERT( false ); // job data is corrupt
+                compressionLevel = job->GetDataCompressionLevel(); // send it as it is
+            }
+        }
+        AtomicStoreRelaxed( &m_PreferredCompressionLevel, idealLevel );
+        compressionType = GetCompressionType( compressionLevel );
+        uncompressedSize = Compressor::GetUncompressedSize( job->GetData() );
+    }
+    const size_t dataSize = recompressedData ? recompressedSize : job->GetDataSize();
+    if ( ( compressionType != COMPRESSION_NONE ) && ( uncompressedSize > 0 ) )
+    {
+        MutexHolder mh( m_CompressionMutex );
+        CompressionEstimate & estimate = m_CompressionEstimates[ compressionType ];
+        const float ratio = ( (float)dataSize / (float)uncompressedSize );
+        estimate.m_Ratio += ( ratio - estimate.m_Ratio ) * COMPRESSION_ESTIMATE_SMOOTHING;
+    }
+
     // send the job to the client
     MemoryStream stream;
-    job->Serialize( stream );
+    job->Serialize( stream, recompressedData, recompressedSize );
 
     MutexHolder mh( ss->m_Mutex );
 
-    ss->m_Jobs.Append( job ); // Track in-flight job
+    ss->m_JobBeingSent = nullptr;
+    if ( ss->m_JobBeingSentCancelled )
+    {
+        // A local race was won while preparing it (and CancelRemoteJobs
+        // has stopped tracking it), so there's no need to send it
+        DIST_INFO( "Cancel: %s - %s (Lost Race)\n", ss->m_RemoteName.Get(), job->GetNode()->GetName().Get() );
+        JobQueue::Get().ReturnUnfinishedDistributableJob( job ); // frees job
+        return;
+    }
+
+    ss->m_BytesTransferred += stream.GetSize();
+    if ( job->IsDataCompressed() )
+    {
+        ss->m_NumJobsCompressed[ compressionType ]++;
+        ss->m_PayloadBytesSaved += ( uncompressedSize > dataSize ) ? ( uncompressedSize - dataSize ) : 0;
+    }
 
     // if tool is explicity specified, get the id of the tool manifest
-    Node * n = job->GetNode()->CastTo< ObjectNode >()->GetCompiler();
-    const ToolManifest & manifest = n->CastTo< CompilerNode >()->GetManifest();
-    uint64_t toolId = manifest.GetToolId();
+    const ToolManifest * manifest = job->GetNode()->GetRemoteToolManifest();
+    ASSERT( manifest );
+    uint64_t toolId = manifest->GetToolId();
     ASSERT( toolId );
 
     // output to signify remote start
@@ -442,8 +998,15 @@ void Client::Process( const ConnectionInfo * connection, const Protocol::MsgRequ
 
     {
         PROFILE_SECTION( "SendJob" )
-        Protocol::MsgJob msg( toolId );
-        SendMessageInternal( connection, msg, stream );
+        BuildTraceSection traceSection( "network", "Send Job" );
+        const Timer sendTimer;
+        Protocol::MsgJob jobMsg( toolId );
+        SendMessageInternal( connection, jobMsg, stream );
+        ss->OnJobSent( (size_t)stream.GetSize(), sendTimer.GetElapsed() );
+        if ( BuildTrace::IsEnabled() )
+        {
+            traceSection.GetArgs().Format( "\"bytes\":%u", (uint32_t)stream.GetSize() );
+        }
     }
 }
 
@@ -457,8 +1020,126 @@ void Client::Process( const ConnectionInfo * connection, const Protocol::MsgJobR
     ServerState * ss = (ServerState *)connection->GetUserData();
     ASSERT( ss );
 
+    // all output files for these results have been streamed ahead of this message
+    ss->CloseResultFile();
+    ss->m_ResultFileKey = INVALID_RESULT_FILE_KEY;
+
+    // results are batched by the worker
     ConstMemoryStream ms( payload, payloadSize );
+    uint32_t numResults = 0;
+    ms.Read( numResults );
+    for ( uint32_t i = 0; i < numResults; ++i )
+    {
+        ProcessJobResult( ss, ms );
+    }
+
+    // cleanup files for jobs which were cancelled or could not be moved into place
+    for ( const AString & tmpFileName : ss->m_ResultTmpFiles )
+    {
+        if ( FileIO::FileExists( tmpFileName.Get() ) )
+        {
+            FileIO::FileDelete( tmpFileName.Get() );
+        }
+    }
+    ss->m_ResultTmpFiles.Clear();
+}
+
+// Process( MsgJobResultChunk )
+//------------------------------------------------------------------------------
+void Client::Process( const ConnectionInfo * connection, const Protocol::MsgJobResultChunk * msg, const void * payload, size_t payloadSize )
+{
+    PROFILE_SECTION( "MsgJobResultChunk" )
+    BuildTraceSection traceSection( "network", "Receive Result Chunk" );
+    if ( BuildTrace::IsEnabled() )
+    {
+        traceSection.GetArgs().Format( "\"bytes\":%u", (uint32_t)payloadSize );
+    }
 
+    // find server
+    ServerState * ss = (ServerState *)connection->GetUserData();
+    ASSERT( ss );
+
+    // the chunk header must describe exactly the payload we received
+    Compressor c;
+    if ( ( payload == nullptr ) || ( c.IsValidData( payload, payloadSize ) == false ) )
+    {
+        FLOG_ERROR( "Invalid result chunk (%u bytes) from '%s'", (uint32_t)payloadSize, ss->m_RemoteName.Get() );
+        ASSERT( false ); // this indicates a protocol bug
+
+        // the job will fail due to the missing file
+        if ( ss->m_ResultFile )
+        {
+            const AString & tmpFileName = ss->m_ResultTmpFiles.Top();
+            ss->CloseResultFile();
+            FileIO::FileDelete( tmpFileName.Get() );
+        }
+        Disconnect( connection );
+        return;
+    }
+
+    // chunks for each file arrive contiguously, so a new key means the
+    // previous file is complete
+    const uint64_t key = ( ( (uint64_t)msg->GetJobId() << 32 ) | msg->GetFileIndex() );
+    if ( key != ss->m_ResultFileKey )
+    {
+        ss->CloseResultFile();
+        ss->m_ResultFileKey = key;
+
+        AStackString<> tmpFileName;
+        {
+            MutexHolder mh( ss->m_Mutex );
+            Job ** it = ss->m_Jobs.FindDeref( msg->GetJobId() );
+            if ( it == nullptr )
+            {
+                // job was cancelled after a local race won (see CancelRemoteJobs)
+                return;
+            }
+
+            Array< AString > outputFiles( 3, false );
+            ( *it )->GetNode()->GetRemoteOutputFiles( outputFiles );
+            if ( msg->GetFileIndex() >= outputFiles.GetSize() )
+            {
+                ASSERT( false ); // this indicates a protocol bug
+                return; // job will fail due to missing file
+            }
+            tmpFileName = outputFiles[ msg->GetFileIndex() ];
+            tmpFileName += RESULT_TMP_FILE_EXTENSION;
+        }
+
+        ss->m_ResultTmpFiles.Append( tmpFileName );
+
+        FileStream * fs = FNEW( FileStream );
+        if ( ( Node::EnsurePathExistsForFile( tmpFileName ) == false ) ||
+             ( fs->Open( tmpFileName.Get(), FileStream::WRITE_ONLY ) == false ) )
+        {
+            FLOG_ERROR( "Failed to create file. Error: %s File: '%s'", LAST_ERROR_STR, tmpFileName.Get() );
+            FDELETE fs;
+            return; // job will fail due to missing file
+        }
+        ss->m_ResultFile = fs;
+    }
+
+    if ( ss->m_ResultFile == nullptr )
+    {
+        return; // file is being ignored (see above)
+    }
+
+    const bool ok = c.Decompress( payload ) &&
+                    ( ss->m_ResultFile->WriteBuffer( c.GetResult(), c.GetResultSize() ) == c.GetResultSize() );
+    if ( ok == false )
+    {
+        // remove the incomplete file so the job fails when the result arrives
+        const AString & tmpFileName = ss->m_ResultTmpFiles.Top();
+        FLOG_ERROR( "Failed to write file. Error: %s File: '%s'", LAST_ERROR_STR, tmpFileName.Get() );
+        ss->CloseResultFile();
+        FileIO::FileDelete( tmpFileName.Get() );
+    }
+}
+
+// ProcessJobResult
+//------------------------------------------------------------------------------
+void Client::ProcessJobResult( ServerState * ss, ConstMemoryStream & ms )
+{
     uint32_t jobId = 0;
     ms.Read( jobId );
 
@@ -477,17 +1158,40 @@ void Client::Process( const ConnectionInfo * connection, const Protocol::MsgJobR
     uint32_t buildTime;
     ms.Read( buildTime );
 
-    bool isDataCompressed = false;
-    ms.Read(isDataCompressed);
+    uint32_t numFiles = 0;
+    ms.Read( numFiles );
 
-    // get result data (built data or errors if failed)
-    uint32_t size = 0;
-    ms.Read( size );
-    const void * data = (const char *)ms.GetData() + ms.Tell();
+    uint32_t resultBytes = 0; // compressed size of streamed output files
+    ms.Read( resultBytes );
 
     {
         MutexHolder mh( ss->m_Mutex );
-        VERIFY( ss->m_Jobs.FindDerefAndErase( jobId ) );
+        Job ** it = ss->m_Jobs.FindDeref( jobId );
+        if ( it == nullptr )
+        {
+            // job was cancelled after a local race won (see CancelRemoteJobs)
+            return;
+        }
+
+        // update worker performance tracking
+        const int64_t dispatchTime = ( *it )->GetRemoteDispatchTime();
+        const uint32_t roundTripMS = (uint32_t)( (float)( Timer::GetNow() - dispatchTime ) * Timer::GetFrequencyInvFloatMS() );
+        const uint32_t previousBuildTimeMS = ( *it )->GetNode()->GetLastBuildTime();
+        ss->OnJobResult( roundTripMS, buildTime, previousBuildTimeMS, resultBytes, systemError );
+
+        if ( BuildTrace::IsEnabled() )
+        {
+            // round trip as seen from here, including transfer and the worker's queue
+            const int64_t queuedTime = ( *it )->GetQueuedTime();
+            const float queueWaitMS = ( ( queuedTime != 0 ) && ( dispatchTime > queuedTime ) ) ? ( (float)( dispatchTime - queuedTime ) * Timer::GetFrequencyInvFloatMS() ) : 0.0f;
+            AStackString<> args;
+            args.Format( "\"result\":\"%s\",\"build_ms\":%u,\"queue_ms\":%.3f,\"result_bytes\":%u",
+                         systemError ? "system error" : result ? "built" : "failed", buildTime, (double)queueWaitMS, resultBytes );
+            BuildTrace::AddRemoteSpan( ss->m_RemoteName, ( *it )->GetNode()->GetTypeName(), ( *it )->GetNode()->GetName().Get(), dispatchTime, Timer::GetNow(), args.Get() );
+        }
+
+        ss->m_Jobs.Erase( it );
+        AtomicDecU32( &m_NumRemoteJobsInProgress );
     }
 
     // Has the job been cancelled in the interim?
@@ -507,72 +1211,52 @@ void Client::Process( const ConnectionInfo * connection, const Protocol::MsgJobR
 
     if ( result == true )
     {
+        FileNode * fileNode = job->GetNode()->CastTo< FileNode >();
 
-
-
-        ObjectNode * objectNode = job->GetNode()->CastTo< ObjectNode >();
-        const AString & nodeName = objectNode->GetName();
-        if ( Node::EnsurePathExistsForFile( nodeName ) == false )
+        // Output files are in the same order they were packed by the worker
+        Array< AString > outputFiles( 3, false );
+        fileNode->GetRemoteOutputFiles( outputFiles );
+        if ( numFiles != outputFiles.GetSize() )
         {
-            FLOG_ERROR( "Failed to create path for '%s'", nodeName.Get() );
+            FLOG_ERROR( "Unexpected number of output files (%u, expected %u) for '%s'", numFiles, (uint32_t)outputFiles.GetSize(), fileNode->GetName().Get() );
             result = false;
         }
         else
         {
-            Compressor c;
-			if (isDataCompressed)
-			{				
-				c.Decompress(data);
-				data = c.GetResult();
-				size = (uint32_t)c.GetResultSize();
-			}
-
-			// built ok - serialize to disc
-			MultiBuffer mb(data, size);
-
-            size_t fileIndex = 0;
-
-            const ObjectNode * on = job->GetNode()->CastTo< ObjectNode >();
-
-            // 1. Object file
-            result = WriteFileToDisk( nodeName, mb, fileIndex++ );
-
-            // 2. PDB file (optional)
-            if ( result && on->IsUsingPDB() )
+            // move streamed files into place
+            for ( size_t fileIndex = 0; result && ( fileIndex < outputFiles.GetSize() ); ++fileIndex )
             {
-                AStackString<> pdbName;
-                on->GetPDBName( pdbName );
-                result = WriteFileToDisk( pdbName, mb, fileIndex++ );
-            }
-
-            // 3. .nativecodeanalysis.xml (optional)
-            if ( result && on->IsUsingStaticAnalysisMSVC() )
-            {
-                AStackString<> xmlFileName;
-                on->GetNativeAnalysisXMLPath( xmlFileName );
-                result = WriteFileToDisk( xmlFileName, mb, fileIndex++ );
+                const AString & fileName = outputFiles[ fileIndex ];
+                AStackString<> tmpFileName( fileName );
+                tmpFileName += RESULT_TMP_FILE_EXTENSION;
+                if ( FileIO::FileMove( tmpFileName, fileName ) == false )
+                {
+                    FLOG_ERROR( "Failed to create file. Error: %s File: '%s'", LAST_ERROR_STR, fileName.Get() );
+                    result = false;
+                }
             }
 
             if ( result )
             {
                 // record new file time
-                objectNode->RecordStampFromBuiltFile();
+                fileNode->RecordStampFromBuiltFile();
 
                 // record time taken to build
-                objectNode->SetLastBuildTime( buildTime );
-                objectNode->SetStatFlag(Node::STATS_BUILT);
-                objectNode->SetStatFlag(Node::STATS_BUILT_REMOTE);
+                fileNode->SetLastBuildTime( buildTime );
+                fileNode->SetStatFlag(Node::STATS_BUILT);
+                fileNode->SetStatFlag(Node::STATS_BUILT_REMOTE);
 
                 // commit to cache?
-                if ( FBuild::Get().GetOptions().m_UseCacheWrite &&
-                        objectNode->ShouldUseCache() )
+                if ( ( fileNode->GetType() == Node::OBJECT_NODE ) &&
+                     FBuild::Get().GetOptions().m_UseCacheWrite &&
+                     fileNode->CastTo< ObjectNode >()->ShouldUseCache() )
                 {
-                    objectNode->WriteToCache( job );
+                    fileNode->CastTo< ObjectNode >()->WriteToCache( job );
                 }
             }
             else
             {
-                objectNode->GetStatFlag( Node::STATS_FAILED );
+                fileNode->SetStatFlag( Node::STATS_FAILED );
             }
         }
 
@@ -580,20 +1264,29 @@ void Client::Process( const ConnectionInfo * connection, const Protocol::MsgJobR
         AStackString<> msgBuffer;
         job->GetMessagesForLog( msgBuffer );
 
-        if ( objectNode->IsMSVC())
+        if ( fileNode->GetType() == Node::OBJECT_NODE )
         {
-            if ( objectNode->GetFlag( ObjectNode::FLAG_WARNINGS_AS_ERRORS_MSVC ) == false )
+            const ObjectNode * objectNode = fileNode->CastTo< ObjectNode >();
+            if ( objectNode->IsMSVC())
             {
-                FileNode::HandleWarningsMSVC( job, objectNode->GetName(), msgBuffer );
+                if ( objectNode->GetFlag( ObjectNode::FLAG_WARNINGS_AS_ERRORS_MSVC ) == false )
+                {
+                    FileNode::HandleWarningsMSVC( job, objectNode->GetName(), msgBuffer );
+                }
             }
-        }
-        else if ( objectNode->IsClang() || objectNode->IsGCC() )
-        {
-            if ( !objectNode->GetFlag( ObjectNode::FLAG_WARNINGS_AS_ERRORS_CLANGGCC ) )
+            else if ( objectNode->IsClang() || objectNode->IsGCC() )
             {
-                FileNode::HandleWarningsClangGCC( job, objectNode->GetName(), msgBuffer );
+                if ( !objectNode->GetFlag( ObjectNode::FLAG_WARNINGS_AS_ERRORS_CLANGGCC ) )
+                {
+                    FileNode::HandleWarningsClangGCC( job, objectNode->GetName(), msgBuffer );
+                }
             }
         }
+        else if ( msgBuffer.IsEmpty() == false )
+        {
+            // other nodes only return output when it was requested (e.g. ExecAlwaysShowOutput)
+            FLOG_OUTPUT( msgBuffer );
+        }
     }
     else
     {
@@ -728,6 +1421,11 @@ void Client::Process( const ConnectionInfo * connection, const Protocol::MsgRequ
     ConstMemoryStream ms( data, dataSize );
 
     // Send file to worker
+    BuildTraceSection traceSection( "network", "Send Tool File" );
+    if ( BuildTrace::IsEnabled() )
+    {
+        traceSection.GetArgs().Format( "\"bytes\":%u", (uint32_t)dataSize );
+    }
     Protocol::MsgFile resultMsg( toolId, fileId );
     resultMsg.Send( connection, ms );
 }
@@ -745,28 +1443,108 @@ const ToolManifest * Client::FindManifest( const ConnectionInfo * connection, ui
           it != ss->m_Jobs.End();
           ++it )
     {
-        Node * n = ( *it )->GetNode()->CastTo< ObjectNode >()->GetCompiler();
-        const ToolManifest & m = n->CastTo< CompilerNode >()->GetManifest();
-        if ( m.GetToolId() == toolId )
+        const ToolManifest * m = ( *it )->GetNode()->GetRemoteToolManifest();
+        if ( m->GetToolId() == toolId )
         {
             // found a job with the same toolid
-            return &m;
+            return m;
         }
     }
 
     return nullptr;
 }
 
-// WriteFileToDisk
+// CONSTRUCTOR( RoundTripHistogram )
 //------------------------------------------------------------------------------
-bool Client::WriteFileToDisk( const AString & fileName, const MultiBuffer & multiBuffer, size_t index ) const
+Client::RoundTripHistogram::RoundTripHistogram()
+    : m_Counts()
+    , m_NumSamples( 0 )
+    , m_MaxMS( 0 )
 {
-    if ( multiBuffer.ExtractFile( index, fileName ) == false )
+}
+
+// RoundTripHistogram::Add
+//------------------------------------------------------------------------------
+void Client::RoundTripHistogram::Add( uint32_t timeMS )
+{
+    m_Counts[ GetBucket( timeMS ) ]++;
+    m_NumSamples++;
+    m_MaxMS = Math::Max( m_MaxMS, timeMS );
+}
+
+// RoundTripHistogram::Add
+//------------------------------------------------------------------------------
+void Client::RoundTripHistogram::Add( const RoundTripHistogram & other )
+{
+    for ( uint32_t i = 0; i < NUM_BUCKETS; ++i )
     {
-        FLOG_ERROR( "Failed to create file. Error: %s File: '%s'", LAST_ERROR_STR, fileName.Get() );
-        return false;
+        m_Counts[ i ] += other.m_Counts[ i ];
     }
-    return true;
+    m_NumSamples += other.m_NumSamples;
+    m_MaxMS = Math::Max( m_MaxMS, other.m_MaxMS );
+}
+
+// RoundTripHistogram::GetPercentileMS
+//------------------------------------------------------------------------------
+uint32_t Client::RoundTripHistogram::GetPercentileMS( uint32_t percent ) const
+{
+    ASSERT( percent <= 100 );
+    if ( m_NumSamples == 0 )
+    {
+        return 0;
+    }
+
+    // find the bucket containing the sample of this rank
+    const uint32_t rank = (uint32_t)( ( (uint64_t)( m_NumSamples - 1 ) * percent ) / 100 );
+    uint32_t numSamples = 0;
+    for ( uint32_t i = 0; i < NUM_BUCKETS; ++i )
+    {
+        numSamples += m_Counts[ i ];
+        if ( numSamples > rank )
+        {
+            return Math::Min( GetBucketTimeMS( i ), m_MaxMS );
+        }
+    }
+    ASSERT( false ); // should be impossible
+    return m_MaxMS;
+}
+
+// RoundTripHistogram::GetBucket
+//------------------------------------------------------------------------------
+/*static*/ uint32_t Client::RoundTripHistogram::GetBucket( uint32_t timeMS )
+{
+    if ( timeMS < NUM_EXACT_BUCKETS )
+    {
+        return timeMS;
+    }
+
+    // position of highest bit (5 to 31) selects the power of 2, and the bits
+    // below it select the sub-bucket
+    uint32_t highBit = 5;
+    while ( ( highBit < 31 ) && ( ( timeMS >> ( highBit + 1 ) ) != 0 ) )
+    {
+        ++highBit;
+    }
+    const uint32_t subBucket = ( ( timeMS >> ( highBit - SUB_BUCKET_BITS ) ) & ( NUM_SUB_BUCKETS - 1 ) );
+    return NUM_EXACT_BUCKETS + ( ( highBit - 5 ) * NUM_SUB_BUCKETS ) + subBucket;
+}
+
+// RoundTripHistogram::GetBucketTimeMS
+//  - Time representing all samples in a bucket (the middle of its range)
+//------------------------------------------------------------------------------
+/*static*/ uint32_t Client::RoundTripHistogram::GetBucketTimeMS( uint32_t bucket )
+{
+    if ( bucket < NUM_EXACT_BUCKETS )
+    {
+        return bucket;
+    }
+
+    const uint32_t highBit = 5 + ( ( bucket - NUM_EXACT_BUCKETS ) / NUM_SUB_BUCKETS );
+    const uint32_t subBucket = ( ( bucket - NUM_EXACT_BUCKETS ) % NUM_SUB_BUCKETS );
+    const uint32_t shift = ( highBit - SUB_BUCKET_BITS );
+    const uint64_t start = ( (uint64_t)( NUM_SUB_BUCKETS + subBucket ) << shift );
+    const uint64_t width = ( (uint64_t)1 << shift );
+    return (uint32_t)( start + ( width / 2 ) );
 }
 
 // CONSTRUCTOR( ServerState )
@@ -774,11 +1552,156 @@ bool Client::WriteFileToDisk( const AString & fileName, const MultiBuffer & mult
 Client::ServerState::ServerState()
     : m_Connection( nullptr )
     , m_CurrentMessage( nullptr )
+    , m_ReattemptDelay( CONNECTION_REATTEMPT_DELAY_TIME )
     , m_NumJobsAvailable( 0 )
     , m_Jobs( 16, true )
+    , m_JobBeingSent( nullptr )
+    , m_JobBeingSentCancelled( false )
+    , m_ResultFile( nullptr )
+    , m_ResultFileKey( INVALID_RESULT_FILE_KEY )
+    , m_ResultTmpFiles( 0, true )
+    , m_SendMBPerSecond( 0.0f )
+    , m_NumJobsCompressed()
+    , m_PayloadBytesSaved( 0 )
+    , m_NumCPUs( 0 )
+    , m_NumJobsCompleted( 0 )
+    , m_NumSystemErrors( 0 )
+    , m_SmoothedRoundTripMS( 0.0f )
+    , m_SmoothedTimeScale( 0.0f )
+    , m_BytesTransferred( 0 )
+    , m_TransferTimeMS( 0 )
+    , m_TimeConnected( 0.0f )
     , m_Blacklisted( false )
+    , m_Replaced( false )
 {
     m_DelayTimer.Start( 999.0f );
 }
 
+// ServerState::OnJobSent
+//------------------------------------------------------------------------------
+void Client::ServerState::OnJobSent( size_t size, float sendTime )
+{
+    // Small sends are buffered by the OS, so don't reflect the link
+    if ( ( size < SEND_MIN_SAMPLE_SIZE ) || ( sendTime <= 0.0f ) )
+    {
+        return;
+    }
+
+    const float mbPerSecond = ( ( (float)size / (float)MEGABYTE ) / sendTime );
+    if ( m_SendMBPerSecond == 0.0f )
+    {
+        m_SendMBPerSecond = mbPerSecond;
+    }
+    else
+    {
+        m_SendMBPerSecond += ( mbPerSecond - m_SendMBPerSecond ) * COMPRESSION_ESTIMATE_SMOOTHING;
+    }
+}
+
+// ServerState::CloseResultFile
+//------------------------------------------------------------------------------
+void Client::ServerState::CloseResultFile()
+{
+    FDELETE m_ResultFile;
+    m_ResultFile = nullptr;
+}
+
+// ServerState::OnJobResult
+//------------------------------------------------------------------------------
+void Client::ServerState::OnJobResult( uint32_t roundTripMS, uint32_t remoteBuildTimeMS, uint32_t previousBuildTimeMS, size_t resultSize, bool systemError )
+{
+    if ( systemError )
+    {
+        ++m_NumSystemErrors;
+        return;
+    }
+
+    ++m_NumJobsCompleted;
+    if ( m_NumJobsCompleted == 1 )
+    {
+        m_SmoothedRoundTripMS = (float)roundTripMS;
+    }
+    else
+    {
+        m_SmoothedRoundTripMS += ( (float)roundTripMS - m_SmoothedRoundTripMS ) * WORKER_ROUND_TRIP_SMOOTHING;
+    }
+
+    // how much longer than a normal build this worker takes to return a result
+    // (used to predict round trips of future jobs when deciding what to race)
+    if ( previousBuildTimeMS > 0 )
+    {
+        const float timeScale = ( (float)roundTripMS / (float)previousBuildTimeMS );
+        if ( m_SmoothedTimeScale == 0.0f )
+        {
+            m_SmoothedTimeScale = timeScale;
+        }
+        else
+        {
+            m_SmoothedTimeScale += ( timeScale - m_SmoothedTimeScale ) * WORKER_ROUND_TRIP_SMOOTHING;
+        }
+    }
+
+    m_RoundTripTimes.Add( roundTripMS );
+
+    // time not spent compiling was spent in transit or queued on the worker
+    m_BytesTransferred += resultSize;
+    m_TransferTimeMS += ( roundTripMS > remoteBuildTimeMS ) ? ( roundTripMS - remoteBuildTimeMS ) : 0;
+}
+
+// ServerState::GetScore
+//------------------------------------------------------------------------------
+float Client::ServerState::GetScore() const
+{
+    if ( m_NumJobsCompleted < WORKER_MIN_JOBS_FOR_SCORE )
+    {
+        return -1.0f;
+    }
+
+    // Each CPU completes one job per round trip
+    const float numCPUs = (float)Math::Max< uint32_t >( m_NumCPUs, 1 );
+    const float roundTripS = Math::Max( m_SmoothedRoundTripMS, 1.0f ) * 0.001f;
+    float jobsPerSecond = ( numCPUs / roundTripS );
+
+    // but can't receive jobs (and return results) faster than the link allows
+    if ( ( m_SendMBPerSecond > 0.0f ) && ( m_BytesTransferred > 0 ) )
+    {
+        const float mbPerJob = (float)( ( (double)m_BytesTransferred / (double)MEGABYTE ) / (double)m_NumJobsCompleted );
+        jobsPerSecond = Math::Min( jobsPerSecond, ( m_SendMBPerSecond / mbPerJob ) );
+    }
+
+    // scaled down by failures
+    return jobsPerSecond * ( 1.0f - GetFailureRate() );
+}
+
+// ServerState::GetFailureRate
+//------------------------------------------------------------------------------
+float Client::ServerState::GetFailureRate() const
+{
+    const uint32_t total = ( m_NumJobsCompleted + m_NumSystemErrors );
+    return ( total > 0 ) ? ( (float)m_NumSystemErrors / (float)total ) : 0.0f;
+}
+
+// ServerState::GetJobsPerSecond
+//------------------------------------------------------------------------------
+float Client::ServerState::GetJobsPerSecond() const
+{
+    float timeConnected = m_TimeConnected;
+    if ( AtomicLoadRelaxed( &m_Connection ) )
+    {
+        timeConnected += m_ConnectionTimer.GetElapsed();
+    }
+    return ( timeConnected > 0.0f ) ? ( (float)m_NumJobsCompleted / timeConnected ) : 0.0f;
+}
+
+// ServerState::GetMBPerSecond
+//------------------------------------------------------------------------------
+float Client::ServerState::GetMBPerSecond() const
+{
+    if ( m_TransferTimeMS == 0 )
+    {
+        return 0.0f;
+    }
+    return (float)( ( (double)m_BytesTransferred / (double)MEGABYTE ) / ( (double)m_TransferTimeMS * 0.001 ) );
+}
+
 //------------------------------------------------------------------------------
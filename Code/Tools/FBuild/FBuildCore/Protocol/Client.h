@@ -12,13 +12,16 @@
 
 // Forward Declarations
 //------------------------------------------------------------------------------
+struct FBuildStats;
+class ConstMemoryStream;
+class FileStream;
 class Job;
 class MemoryStream;
-class MultiBuffer;
 namespace Protocol
 {
     class IMessage;
     class MsgJobResult;
+    class MsgJobResultChunk;
     class MsgRequestJob;
     class MsgRequestManifest;
     class MsgRequestFile;
@@ -37,23 +40,35 @@ public:
             bool detailedLogging );
     ~Client();
 
+    // capture per-worker performance for -report (call before destruction)
+    void GetWorkerStats( FBuildStats & stats ) const;
+
+    // current use of connected workers for -metrics
+    void GetWorkerUtilization( uint32_t & outNumConnected, uint32_t & outNumCPUs, uint32_t & outNumJobsInProgress ) const;
+
+    // compression level (as per Compressor) most recently chosen for job data
+    int32_t GetPreferredCompressionLevel() const;
+
 private:
     virtual void OnDisconnected( const ConnectionInfo * connection );
     virtual void OnReceive( const ConnectionInfo * connection, void * data, uint32_t size, bool & keepMemory );
 
     void Process( const ConnectionInfo * connection, const Protocol::MsgRequestJob * msg );
     void Process( const ConnectionInfo * connection, const Protocol::MsgJobResult *, const void * payload, size_t payloadSize );
+    void Process( const ConnectionInfo * connection, const Protocol::MsgJobResultChunk * msg, const void * payload, size_t payloadSize );
     void Process( const ConnectionInfo * connection, const Protocol::MsgRequestManifest * msg );
     void Process( const ConnectionInfo * connection, const Protocol::MsgRequestFile * msg );
 
     const ToolManifest * FindManifest( const ConnectionInfo * connection, uint64_t toolId ) const;
-    bool WriteFileToDisk( const AString& fileName, const MultiBuffer & multiBuffer, size_t index ) const;
 
     static uint32_t ThreadFuncStatic( void * param );
     void            ThreadFunc();
 
     void            LookForWorkers();
+    static void     GetWorkerHostAndPort( const AString & worker, uint16_t defaultPort, AString & outHost, uint16_t & outPort );
+    void            ReplaceSlowestWorker();
     void            CommunicateJobAvailability();
+    void            CancelRemoteJobs();
 
     // More verbose name to avoid conflict with windows.h SendMessage
     void            SendMessageInternal( const ConnectionInfo * connection, const Protocol::IMessage & msg );
@@ -66,23 +81,120 @@ private:
 
     // state
     Timer               m_StatusUpdateTimer;
+    Timer               m_ReplaceWorkerTimer;   // rate limit replacement of slow workers
+
+    // compression of job data, adapted to each connection
+    enum CompressionType : uint32_t
+    {
+        COMPRESSION_NONE,
+        COMPRESSION_LZ4,
+        COMPRESSION_LZ4HC,
+        NUM_COMPRESSION_TYPES
+    };
+    struct CompressionEstimate
+    {
+        float               m_Ratio;                // compressed size / uncompressed size
+        float               m_MBPerSecond;          // throughput when compressing
+    };
+    mutable Mutex           m_CompressionMutex;
+    CompressionEstimate     m_CompressionEstimates[ NUM_COMPRESSION_TYPES ];
+    volatile int32_t        m_PreferredCompressionLevel;
+
+    // for GetWorkerUtilization (updated under the relevant ServerState lock)
+    volatile uint32_t       m_NumConnectedWorkers;
+    volatile uint32_t       m_NumConnectedWorkerCPUs;
+    volatile uint32_t       m_NumRemoteJobsInProgress;
+
+    // Fixed size histogram of round trip times, for latency percentiles
+    // (exact below 32ms, then 16 buckets per power of 2, so within ~3%)
+    class RoundTripHistogram
+    {
+    public:
+        explicit RoundTripHistogram();
+
+        void        Add( uint32_t timeMS );
+        void        Add( const RoundTripHistogram & other );
+
+        inline uint32_t GetNumSamples() const { return m_NumSamples; }
+        inline uint32_t GetMaxMS() const { return m_MaxMS; }
+        uint32_t        GetPercentileMS( uint32_t percent ) const;
+
+    private:
+        enum : uint32_t
+        {
+            NUM_EXACT_BUCKETS   = 32,
+            SUB_BUCKET_BITS     = 4,
+            NUM_SUB_BUCKETS     = ( 1 << SUB_BUCKET_BITS ),
+            NUM_BUCKETS         = NUM_EXACT_BUCKETS + ( ( 32 - 5 ) * NUM_SUB_BUCKETS ), // powers of 2 from 32 to 2^31
+        };
+        static uint32_t GetBucket( uint32_t timeMS );
+        static uint32_t GetBucketTimeMS( uint32_t bucket );
+
+        uint32_t    m_Counts[ NUM_BUCKETS ];
+        uint32_t    m_NumSamples;
+        uint32_t    m_MaxMS;
+    };
 
     struct ServerState
     {
         explicit ServerState();
 
+        // Estimated jobs/sec this worker can sustain (limited by its CPUs and round
+        // trip time, and by the send throughput of its link), or < 0 if not enough data yet
+        // (performance tracking members are protected by m_Mutex, which must be held)
+        float                   GetScore() const;
+        float                   GetFailureRate() const;
+        float                   GetJobsPerSecond() const;
+        float                   GetMBPerSecond() const;
+        void                    OnJobResult( uint32_t roundTripMS, uint32_t remoteBuildTimeMS, uint32_t previousBuildTimeMS, size_t resultSize, bool systemError );
+        void                    OnJobSent( size_t size, float sendTime );
+        void                    CloseResultFile();
+
         const ConnectionInfo *  m_Connection;
         AString                 m_RemoteName;
 
-        Mutex                   m_Mutex;
+        mutable Mutex           m_Mutex;
         const Protocol::IMessage * m_CurrentMessage;
         Timer                   m_DelayTimer;
+        float                   m_ReattemptDelay;       // seconds to wait before reconnecting
         uint32_t                m_NumJobsAvailable;     // num jobs we've told this server we have available
         Array< Job * >          m_Jobs;                 // jobs we've sent to this server
+        Job *                   m_JobBeingSent;         // in m_Jobs, but still being prepared by SendJob
+        bool                    m_JobBeingSentCancelled; // m_JobBeingSent lost a local race (and left m_Jobs)
+
+        // output files streamed ahead of job results
+        FileStream *            m_ResultFile;           // file currently being received
+        uint64_t                m_ResultFileKey;        // jobId and file index of m_ResultFile
+        Array< AString >        m_ResultTmpFiles;       // files received since the last results
+
+        // job data compression
+        float                   m_SendMBPerSecond;      // smoothed throughput of job sends (0 if unknown)
+        uint32_t                m_NumJobsCompressed[ NUM_COMPRESSION_TYPES ];
+        uint64_t                m_PayloadBytesSaved;    // uncompressed size minus size sent
+
+        // performance tracking (persists across connections)
+        uint32_t                m_NumCPUs;              // as reported by the worker when requesting jobs
+        uint32_t                m_NumJobsCompleted;
+        uint32_t                m_NumSystemErrors;
+        float                   m_SmoothedRoundTripMS;  // send to result, including remote build time
+        float                   m_SmoothedTimeScale;    // round trip relative to previous build time (0 if unknown)
+        uint64_t                m_BytesTransferred;     // job payloads sent + results received
+        uint64_t                m_TransferTimeMS;       // round trip time not spent building
+        RoundTripHistogram      m_RoundTripTimes;       // every successful job, for latency percentiles
+        Timer                   m_ConnectionTimer;      // time since current connection established
+        float                   m_TimeConnected;        // accumulated from previous connections
 
         bool                    m_Blacklisted;
+        bool                    m_Replaced;             // disconnected in favor of a faster worker
     };
-    Mutex                   m_ServerListMutex;
+
+    void                    ProcessJobResult( ServerState * ss, ConstMemoryStream & ms );
+    void                    SendJob( const ConnectionInfo * connection, ServerState * ss );
+    int32_t                 ChooseCompressionLevel( const ServerState * ss, const Job * job, int32_t & outIdealLevel ) const;
+    bool                    RecompressJobData( Job * job, int32_t compressionLevel );
+    static CompressionType  GetCompressionType( int32_t compressionLevel );
+    bool                    ShouldHoldBackJobs( const ServerState * ss ) const;
+    mutable Mutex           m_ServerListMutex;
     Array< ServerState >    m_ServerList;
     uint32_t                m_WorkerConnectionLimit;
     uint16_t                m_Port;
@@ -35,7 +35,8 @@
             "Manifest",
             "RequestFile",
             "File",
-            "ServerStatus"
+            "CancelJob",
+            "JobResultChunk"
         };
         static_assert( ( sizeof( msgNames ) / sizeof(const char *) ) == Protocol::NUM_MESSAGES, "msgNames item count doesn't match NUM_MESSAGES" );
 
@@ -124,8 +125,9 @@ Protocol::MsgStatus::MsgStatus( uint32_t numJobsAvailable )
 
 // MsgRequestJob
 //------------------------------------------------------------------------------
-Protocol::MsgRequestJob::MsgRequestJob()
+Protocol::MsgRequestJob::MsgRequestJob( uint32_t numCPUs )
     : Protocol::IMessage( Protocol::MSG_REQUEST_JOB, sizeof( MsgRequestJob ), false )
+    , m_NumCPUs( numCPUs )
 {
 }
 
@@ -153,6 +155,15 @@ Protocol::MsgJobResult::MsgJobResult()
 {
 }
 
+// MsgJobResultChunk
+//------------------------------------------------------------------------------
+Protocol::MsgJobResultChunk::MsgJobResultChunk( uint32_t jobId, uint32_t fileIndex )
+    : Protocol::IMessage( Protocol::MSG_JOB_RESULT_CHUNK, sizeof( MsgJobResultChunk ), true )
+    , m_JobId( jobId )
+    , m_FileIndex( fileIndex )
+{
+}
+
 // MsgRequestManifest
 //------------------------------------------------------------------------------
 Protocol::MsgRequestManifest::MsgRequestManifest( uint64_t toolId )
@@ -189,4 +200,12 @@ Protocol::MsgFile::MsgFile( uint64_t toolId, uint32_t fileId )
 {
 }
 
+// MsgCancelJob
+//------------------------------------------------------------------------------
+Protocol::MsgCancelJob::MsgCancelJob( uint32_t jobId )
+    : Protocol::IMessage( Protocol::MSG_CANCEL_JOB, sizeof( MsgCancelJob ), false )
+    , m_JobId( jobId )
+{
+}
+
 //------------------------------------------------------------------------------
@@ -29,7 +29,7 @@ class TCPConnectionPool;
 namespace Protocol
 {
     enum : uint16_t { PROTOCOL_PORT = 31264 }; // Arbitrarily chosen port
-    enum { PROTOCOL_VERSION = 22 };
+    enum { PROTOCOL_VERSION = 27 };
 
     enum { PROTOCOL_TEST_PORT = PROTOCOL_PORT + 1 }; // Different port for use by tests
 
@@ -52,6 +52,10 @@ namespace Protocol
         MSG_REQUEST_FILE        = 9, // Server -> Client : Ask client for a file
         MSG_FILE                = 10,// Server <- Client : Send a requested file
 
+        MSG_CANCEL_JOB          = 11,// Server <- Client : Result no longer needed (race won locally)
+
+        MSG_JOB_RESULT_CHUNK    = 12,// Server -> Client : Part of an output file for a completed job (precedes MSG_JOB_RESULT)
+
         NUM_MESSAGES            // leave last
     };
 };
@@ -125,9 +129,13 @@ namespace Protocol
     class MsgRequestJob : public IMessage
     {
     public:
-        MsgRequestJob();
+        explicit MsgRequestJob( uint32_t numCPUs );
+
+        inline uint32_t GetNumCPUs() const { return m_NumCPUs; }
+    private:
+        uint32_t        m_NumCPUs; // CPUs the worker is currently offering
     };
-    static_assert( sizeof( MsgRequestJob ) == sizeof( IMessage ), "MsgRequestJob message has incorrect size" );
+    static_assert( sizeof( MsgRequestJob ) == sizeof( IMessage ) + 4, "MsgRequestJob message has incorrect size" );
 
     // MsgNoJobAvailable
     //------------------------------------------------------------------------------
@@ -161,6 +169,21 @@ namespace Protocol
     };
     static_assert( sizeof( MsgJobResult ) == sizeof( IMessage ), "MsgJobResult message has incorrect size" );
 
+    // MsgJobResultChunk
+    //------------------------------------------------------------------------------
+    class MsgJobResultChunk : public IMessage
+    {
+    public:
+        MsgJobResultChunk( uint32_t jobId, uint32_t fileIndex );
+
+        inline uint32_t GetJobId() const { return m_JobId; }
+        inline uint32_t GetFileIndex() const { return m_FileIndex; }
+    private:
+        uint32_t m_JobId;
+        uint32_t m_FileIndex;
+    };
+    static_assert( sizeof( MsgJobResultChunk ) == sizeof( IMessage ) + 8, "MsgJobResultChunk message has incorrect size" );
+
     // MsgRequestManifest
     //------------------------------------------------------------------------------
     class MsgRequestManifest : public IMessage
@@ -219,6 +242,19 @@ namespace Protocol
     };
     static_assert( sizeof( MsgFile ) == sizeof( IMessage ) + 12, "MsgFile message has incorrect size" );
 
+    // MsgCancelJob
+    //------------------------------------------------------------------------------
+    class MsgCancelJob : public IMessage
+    {
+    public:
+        explicit MsgCancelJob( uint32_t jobId );
+
+        inline uint32_t GetJobId() const { return m_JobId; }
+    private:
+        uint32_t m_JobId;
+    };
+    static_assert( sizeof( MsgCancelJob ) == sizeof( IMessage ) + 4, "MsgCancelJob message has incorrect size" );
+
     // MsgServerStatus
     //------------------------------------------------------------------------------
     class MsgServerStatus : public IMessage
@@ -153,10 +153,27 @@ bool Server::IsSynchingTool( AString & statusStr ) const
     }
 
     // free the serverstate structure
+    {
+        MutexHolder mh( m_ClientListMutex );
+        ClientState ** iter = m_ClientList.Find( cs );
+        ASSERT( iter );
+        m_ClientList.Erase( iter );
+    }
+
+    // wait for any results still being sent to this client (see FinalizeCompletedJobs)
+    for ( ;; )
+    {
+        {
+            MutexHolder mh( m_ClientListMutex );
+            if ( cs->m_NumResultSends == 0 )
+            {
+                break;
+            }
+        }
+        Thread::Sleep( 1 );
+    }
+
     MutexHolder mh( m_ClientListMutex );
-    ClientState ** iter = m_ClientList.Find( cs );
-    ASSERT( iter );
-    m_ClientList.Erase( iter );
 
     // because we cancelled manifest syncrhonization, we need to check if other
     // connections are waiting for the same manifest
@@ -269,6 +286,12 @@ bool Server::IsSynchingTool( AString & statusStr ) const
             Process( connection, msg, payload, payloadSize );
             break;
         }
+        case Protocol::MSG_CANCEL_JOB:
+        {
+            const Protocol::MsgCancelJob * msg = static_cast< const Protocol::MsgCancelJob * >( imsg );
+            Process( connection, msg );
+            break;
+        }
         default:
         {
             // unknown message type
@@ -462,6 +485,22 @@ void Server::Process( const ConnectionInfo * connection, const Protocol::MsgFile
     CheckWaitingJobs( manifest );
 }
 
+// Process( MsgCancelJob )
+//------------------------------------------------------------------------------
+void Server::Process( const ConnectionInfo * connection, const Protocol::MsgCancelJob * msg )
+{
+    // Client no longer needs the result (it finished the job locally first)
+    // NOTE: Jobs waiting for a ToolChain sync are left to complete, as they
+    //       are needed to confirm the sync and their result is ignored by the Client
+    ClientState * cs = (ClientState *)connection->GetUserData();
+    if ( JobQueueRemote::Get().CancelJob( cs, msg->GetJobId() ) )
+    {
+        MutexHolder mh( cs->m_Mutex );
+        ASSERT( cs->m_NumJobsActive );
+        cs->m_NumJobsActive--;
+    }
+}
+
 // CheckWaitingJobs
 //------------------------------------------------------------------------------
 void Server::CheckWaitingJobs( const ToolManifest * manifest )
@@ -574,7 +613,7 @@ void Server::FindNeedyClients()
     // sort clients to find neediest first
     m_ClientList.SortDeref();
 
-    Protocol::MsgRequestJob msg;
+    Protocol::MsgRequestJob msg( WorkerThreadRemote::GetNumCPUsToUse() );
 
     while ( availableJobs > 0 )
     {
@@ -615,50 +654,132 @@ void Server::FinalizeCompletedJobs()
 {
     PROFILE_FUNCTION
 
+    // gather everything that has completed since the last update so results
+    // can be batched into a single message per client
+    Array< Job * > completedJobs( 32, true );
     JobQueueRemote & jcr = JobQueueRemote::Get();
     while ( Job * job = jcr.GetCompletedJob() )
     {
-        // get associated connection
-        ClientState * cs = (ClientState *)job->GetUserData();
+        completedJobs.Append( job );
+    }
+    if ( completedJobs.IsEmpty() )
+    {
+        return;
+    }
 
+    // find the clients still connected for these results
+    // (we might not find the connection for some jobs if the connection
+    // was lost before we completed)
+    Array< ClientState * > clients( 8, true );
+    {
         MutexHolder mh( m_ClientListMutex );
+        for ( ClientState * cs : m_ClientList )
+        {
+            for ( const Job * job : completedJobs )
+            {
+                if ( job->GetUserData() == cs )
+                {
+                    // keep the ClientState alive while we send (see OnDisconnected)
+                    ++cs->m_NumResultSends;
+                    clients.Append( cs );
+                    break;
+                }
+            }
+        }
+    }
+
+    // send results outside of the lock so large transfers don't stall other connections
+    for ( ClientState * cs : clients )
+    {
+        MemoryStream ms;
+        uint32_t numResults = 0;
+        ms.Write( numResults ); // placeholder, patched below
 
-        bool connectionStillActive = ( m_ClientList.Find( cs ) != nullptr );
-        if ( connectionStillActive )
+        for ( Job * job : completedJobs )
         {
+            if ( job->GetUserData() != cs )
+            {
+                continue;
+            }
+
             Node::State result = job->GetNode()->GetState();
             ASSERT( ( result == Node::UP_TO_DATE ) || ( result == Node::FAILED ) );
 
-            MemoryStream ms;
+            // stream output files ahead of the result
+            uint32_t numFiles = 0;
+            uint32_t resultBytes = 0;
+            if ( result == Node::UP_TO_DATE )
+            {
+                SendJobResultChunks( cs->m_Connection, job, numFiles, resultBytes );
+            }
+
             ms.Write( job->GetJobId() );
             ms.Write( job->GetNode()->GetName() );
             ms.Write( result == Node::UP_TO_DATE );
             ms.Write( job->GetSystemErrorCount() > 0 );
             ms.Write( job->GetMessages() );
             ms.Write( job->GetNode()->GetLastBuildTime() );
-            ms.Write( job->IsDataCompressed() );
-
-            // write the data - build result for success, or output+errors for failure
-            ms.Write( (uint32_t)job->GetDataSize() );
-            ms.WriteBuffer( job->GetData(), job->GetDataSize() );
+            ms.Write( numFiles );
+            ms.Write( resultBytes );
+            ++numResults;
+        }
+        ASSERT( numResults > 0 );
 
+        {
             MutexHolder mh2( cs->m_Mutex );
-            ASSERT( cs->m_NumJobsActive );
-            cs->m_NumJobsActive--;
-
-            Protocol::MsgJobResult msg;
-            msg.Send( cs->m_Connection, ms );
+            ASSERT( cs->m_NumJobsActive >= numResults );
+            cs->m_NumJobsActive -= numResults;
         }
-        else
+
+        *( (uint32_t *)ms.GetDataMutable() ) = numResults;
+
+        Protocol::MsgJobResult msg;
+        msg.Send( cs->m_Connection, ms );
+    }
+
+    if ( clients.IsEmpty() == false )
+    {
+        MutexHolder mh( m_ClientListMutex );
+        for ( ClientState * cs : clients )
         {
-            // we might get here without finding the connection
-            // (if the connection was lost before we completed)
+            ASSERT( cs->m_NumResultSends > 0 );
+            --cs->m_NumResultSends;
         }
+    }
 
+    for ( Job * job : completedJobs )
+    {
         FDELETE job;
     }
 }
 
+// SendJobResultChunks
+//------------------------------------------------------------------------------
+void Server::SendJobResultChunks( const ConnectionInfo * connection, const Job * job, uint32_t & outNumFiles, uint32_t & outResultBytes ) const
+{
+    // See JobQueueRemote::ReadResults for layout
+    ConstMemoryStream ms( job->GetData(), job->GetDataSize() );
+    uint32_t numFiles = 0;
+    VERIFY( ms.Read( numFiles ) );
+    for ( uint32_t fileIndex = 0; fileIndex < numFiles; ++fileIndex )
+    {
+        uint32_t numChunks = 0;
+        VERIFY( ms.Read( numChunks ) );
+        for ( uint32_t i = 0; i < numChunks; ++i )
+        {
+            uint32_t chunkSize = 0;
+            VERIFY( ms.Read( chunkSize ) );
+            const void * chunk = (const char *)ms.GetData() + ms.Tell();
+            ms.Seek( ms.Tell() + chunkSize );
+
+            Protocol::MsgJobResultChunk msg( job->GetJobId(), fileIndex );
+            msg.Send( connection, ConstMemoryStream( chunk, chunkSize ) );
+            outResultBytes += chunkSize;
+        }
+    }
+    outNumFiles = numFiles;
+}
+
 // TouchToolchains
 //------------------------------------------------------------------------------
 void Server::TouchToolchains()
@@ -20,6 +20,7 @@ namespace Protocol
     class MsgNoJobAvailable;
     class MsgStatus;
     class MsgFile;
+    class MsgCancelJob;
 }
 class ToolManifest;
 
@@ -48,12 +49,14 @@ private:
     void Process( const ConnectionInfo * connection, const Protocol::MsgJob * msg, const void * payload, size_t payloadSize );
     void Process( const ConnectionInfo * connection, const Protocol::MsgManifest * msg, const void * payload, size_t payloadSize );
     void Process( const ConnectionInfo * connection, const Protocol::MsgFile * msg, const void * payload, size_t payloadSize );
+    void Process( const ConnectionInfo * connection, const Protocol::MsgCancelJob * msg );
 
     static uint32_t ThreadFuncStatic( void * param );
     void            ThreadFunc();
 
     void            FindNeedyClients();
     void            FinalizeCompletedJobs();
+    void            SendJobResultChunks( const ConnectionInfo * connection, const Job * job, uint32_t & outNumFiles, uint32_t & outResultBytes ) const;
     void            TouchToolchains();
     void            CheckWaitingJobs( const ToolManifest * manifest );
 
@@ -61,7 +64,7 @@ private:
 
     struct ClientState
     {
-        explicit ClientState( const ConnectionInfo * ci ) : m_CurrentMessage( nullptr ), m_Connection( ci ), m_NumJobsAvailable( 0 ), m_NumJobsRequested( 0 ), m_NumJobsActive( 0 ), m_WaitingJobs( 16, true ) {}
+        explicit ClientState( const ConnectionInfo * ci ) : m_CurrentMessage( nullptr ), m_Connection( ci ), m_NumJobsAvailable( 0 ), m_NumJobsRequested( 0 ), m_NumJobsActive( 0 ), m_NumResultSends( 0 ), m_WaitingJobs( 16, true ) {}
 
         inline bool operator < ( const ClientState & other ) const { return ( m_NumJobsAvailable > other.m_NumJobsAvailable ); }
 
@@ -72,6 +75,7 @@ private:
         uint32_t                m_NumJobsAvailable;
         uint32_t                m_NumJobsRequested;
         uint32_t                m_NumJobsActive;
+        uint32_t                m_NumResultSends;   // protected by m_ClientListMutex
 
         AString                 m_HostName;
 
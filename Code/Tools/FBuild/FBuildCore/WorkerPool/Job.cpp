@@ -56,19 +56,19 @@ Job::~Job()
 //------------------------------------------------------------------------------
 void Job::Cancel()
 {
-    ASSERT( m_IsLocal ); // Cancellation should only occur locally
     ASSERT( m_Abort == false ); // Job must be not already be cancelled
     AtomicStoreRelaxed( &m_Abort, true );
 }
 
 // OwnData
 //------------------------------------------------------------------------------
-void Job::OwnData( void * data, size_t size, bool compressed )
+void Job::OwnData( void * data, size_t size, bool compressed, int32_t compressionLevel )
 {
     ASSERT( size <= 0xFFFFFFFF ); // only 32bit data supported
     ASSERT( data != m_Data ); // Invalid to set redundantly
 
     // Free any old data
+    FreeRecompressedData();
     if ( m_Data )
     {
         FREE( m_Data );
@@ -85,6 +85,8 @@ void Job::OwnData( void * data, size_t size, bool compressed )
     m_Data = data;
     m_DataSize = (uint32_t)size;
     m_DataIsCompressed = compressed;
+    m_DataCompressionLevel = compressed ? compressionLevel : 0;
+    m_DataHash = 0;
 
     // Update total memory use tracking
     if ( m_IsLocal )
@@ -93,6 +95,69 @@ void Job::OwnData( void * data, size_t size, bool compressed )
     }
 }
 
+// GetRecompressedData
+//------------------------------------------------------------------------------
+const void * Job::GetRecompressedData( int32_t compressionLevel, size_t & outSize ) const
+{
+    for ( const RecompressedData & rd : m_RecompressedData )
+    {
+        if ( rd.m_Data && ( rd.m_CompressionLevel == compressionLevel ) )
+        {
+            outSize = rd.m_DataSize;
+            return rd.m_Data;
+        }
+    }
+    return nullptr;
+}
+
+// OwnRecompressedData
+//------------------------------------------------------------------------------
+void Job::OwnRecompressedData( void * data, size_t size, int32_t compressionLevel )
+{
+    ASSERT( m_IsLocal );
+    ASSERT( m_DataIsCompressed );
+    ASSERT( compressionLevel != m_DataCompressionLevel );
+    ASSERT( size <= 0xFFFFFFFF ); // only 32bit data supported
+
+    // use a free slot (or replace the first one if somehow full)
+    RecompressedData * slot = &m_RecompressedData[ 0 ];
+    for ( RecompressedData & rd : m_RecompressedData )
+    {
+        ASSERT( ( rd.m_Data == nullptr ) || ( rd.m_CompressionLevel != compressionLevel ) ); // Invalid to set redundantly
+        if ( rd.m_Data == nullptr )
+        {
+            slot = &rd;
+            break;
+        }
+    }
+    if ( slot->m_Data )
+    {
+        FREE( slot->m_Data );
+        AtomicSub64( &s_TotalLocalDataMemoryUsage, (int32_t)slot->m_DataSize );
+    }
+
+    slot->m_Data = data;
+    slot->m_DataSize = (uint32_t)size;
+    slot->m_CompressionLevel = compressionLevel;
+    AtomicAdd64( &s_TotalLocalDataMemoryUsage, (int32_t)slot->m_DataSize );
+}
+
+// FreeRecompressedData
+//------------------------------------------------------------------------------
+void Job::FreeRecompressedData()
+{
+    for ( RecompressedData & rd : m_RecompressedData )
+    {
+        if ( rd.m_Data )
+        {
+            FREE( rd.m_Data );
+            AtomicSub64( &s_TotalLocalDataMemoryUsage, (int32_t)rd.m_DataSize );
+            rd.m_Data = nullptr;
+            rd.m_DataSize = 0;
+        }
+    }
+}
+
 // Error
 //------------------------------------------------------------------------------
 void Job::Error( MSVC_SAL_PRINTF const char * format, ... )
@@ -147,7 +212,7 @@ void Job::SetMessages( const Array< AString > & messages )
 
 // Serialize
 //------------------------------------------------------------------------------
-void Job::Serialize( IOStream & stream )
+void Job::Serialize( IOStream & stream, const void * dataOverride, size_t dataOverrideSize )
 {
     PROFILE_FUNCTION
 
@@ -163,8 +228,10 @@ void Job::Serialize( IOStream & stream )
 
     stream.Write( IsDataCompressed() );
 
-    stream.Write( m_DataSize );
-    stream.Write( m_Data, m_DataSize );
+    const void * data = dataOverride ? dataOverride : m_Data;
+    const uint32_t dataSize = dataOverride ? (uint32_t)dataOverrideSize : m_DataSize;
+    stream.Write( dataSize );
+    stream.Write( data, dataSize );
 }
 
 // Deserialize
@@ -37,18 +37,46 @@ public:
     void Cancel();
 
     // associate some data with this object, and destroy it when freed
-    void    OwnData( void * data, size_t size, bool compressed = false );
+    // (compressionLevel is as per Compressor, and only relevant for compressed data)
+    void    OwnData( void * data, size_t size, bool compressed = false, int32_t compressionLevel = -1 );
 
     inline void *   GetData() const     { return m_Data; }
     inline size_t   GetDataSize() const { return m_DataSize; }
 
+    // copies of the data re-compressed at other levels for sending to remote workers,
+    // kept so retried or raced sends don't repeat the work (freed when the data changes)
+    const void *    GetRecompressedData( int32_t compressionLevel, size_t & outSize ) const;
+    void            OwnRecompressedData( void * data, size_t size, int32_t compressionLevel );
+
+    // xxHash::Calc64 of the data, if calculated while it was produced (0 if not)
+    // (reset by OwnData, and must be reset by anything modifying the data in-place)
+    inline void     SetDataHash( uint64_t hash )    { m_DataHash = hash; }
+    inline uint64_t GetDataHash() const             { return m_DataHash; }
+
     inline void     SetUserData( void * data )  { m_UserData = data; }
     inline void *   GetUserData() const         { return m_UserData; }
 
     inline void             SetToolManifest( ToolManifest * manifest )  { m_ToolManifest = manifest; }
     inline ToolManifest *   GetToolManifest() const                     { return m_ToolManifest; }
 
+    // time (Timer::GetNow) when the job was last made available to be processed
+    inline void     SetQueuedTime( int64_t t )  { m_QueuedTime = t; }
+    inline int64_t  GetQueuedTime() const       { return m_QueuedTime; }
+
+    // time (Timer::GetNow) when the job was sent to a remote worker
+    inline void     SetRemoteDispatchTime( int64_t t )  { m_RemoteDispatchTime = t; }
+    inline int64_t  GetRemoteDispatchTime() const       { return m_RemoteDispatchTime; }
+
+    // expected round trip for the remote build (0 if unknown)
+    inline void     SetRemotePredictedTimeMS( uint32_t t )  { m_RemotePredictedTimeMS = t; }
+    inline uint32_t GetRemotePredictedTimeMS() const        { return m_RemotePredictedTimeMS; }
+
+    // time (Timer::GetNow) when a local thread started racing the remote build (0 if never raced)
+    inline void     SetRaceStartTime( int64_t t )   { m_RaceStartTime = t; }
+    inline int64_t  GetRaceStartTime() const        { return m_RaceStartTime; }
+
     inline bool     IsDataCompressed() const { return m_DataIsCompressed; }
+    inline int32_t  GetDataCompressionLevel() const { return m_DataCompressionLevel; }
     inline bool     IsLocal() const     { return m_IsLocal; }
 
     inline const Array< AString > & GetMessages() const { return m_Messages; }
@@ -63,7 +91,8 @@ public:
     inline uint8_t GetSystemErrorCount() const { return m_SystemErrorCount; }
 
     // serialization for remote distribution
-    void Serialize( IOStream & stream );
+    // (data can be replaced, e.g. by a re-compressed copy, leaving the job unchanged)
+    void Serialize( IOStream & stream, const void * dataOverride = nullptr, size_t dataOverrideSize = 0 );
     void Deserialize( IOStream & stream );
 
     void                GetMessagesForLog( AString & buffer ) const;
@@ -92,6 +121,15 @@ public:
     static uint64_t             GetTotalLocalDataMemoryUsage();
 
 private:
+    void                FreeRecompressedData();
+
+    struct RecompressedData
+    {
+        void *      m_Data              = nullptr;
+        uint32_t    m_DataSize          = 0;
+        int32_t     m_CompressionLevel  = 0;
+    };
+
     uint32_t            m_JobId             = 0;
     uint32_t            m_DataSize          = 0;
     Node *              m_Node              = nullptr;
@@ -102,6 +140,13 @@ private:
     bool                m_IsLocal           = true;
     uint8_t             m_SystemErrorCount  = 0; // On client, the total error count, on the worker a flag for the current attempt
     DistributionState   m_DistributionState = DIST_NONE;
+    int64_t             m_QueuedTime        = 0;
+    int64_t             m_RemoteDispatchTime = 0;
+    int64_t             m_RaceStartTime     = 0;
+    uint32_t            m_RemotePredictedTimeMS = 0;
+    int32_t             m_DataCompressionLevel = 0;
+    uint64_t            m_DataHash          = 0;
+    RecompressedData    m_RecompressedData[ 2 ]; // one per compression type other than the stored one
     AString             m_RemoteName;
     AString             m_RemoteSourceRoot;
     AString             m_CacheName;
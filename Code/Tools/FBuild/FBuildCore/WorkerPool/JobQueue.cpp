@@ -11,6 +11,8 @@
 #include "Tools/FBuild/FBuildCore/FLog.h"
 #include "Tools/FBuild/FBuildCore/Graph/Node.h"
 #include "Tools/FBuild/FBuildCore/Graph/ObjectNode.h"
+#include "Tools/FBuild/FBuildCore/Helpers/BuildTrace.h"
+#include "Tools/FBuild/FBuildCore/Helpers/FBuildStats.h"
 
 #include "Core/Time/Timer.h"
 #include "Core/FileIO/FileIO.h"
@@ -18,6 +20,14 @@
 #include "Core/Process/Thread.h"
 #include "Core/Profile/Profile.h"
 
+// system
+#include <string.h> // for memset
+
+// Defines
+//------------------------------------------------------------------------------
+#define RACE_MIN_GAIN_MS ( 100 )        // only race if expected to finish at least this much sooner
+#define RACE_OVERDUE_FACTOR ( 2.0f )    // remote builds taking this much longer than predicted are raced
+
 // JobCostSorter
 //------------------------------------------------------------------------------
 class JobCostSorter
@@ -58,9 +68,11 @@ void JobSubQueue::QueueJobs( Array< Node * > & nodes )
 {
     // Create wrapper Jobs around Nodes
     Array< Job * > jobs( nodes.GetSize() );
+    const int64_t now = Timer::GetNow();
     for ( Node * node : nodes )
     {
         Job * job = FNEW( Job( node ) );
+        job->SetQueuedTime( now );
         jobs.Append( job );
     }
 
@@ -115,16 +127,29 @@ Job * JobSubQueue::RemoveJob()
 //------------------------------------------------------------------------------
 JobQueue::JobQueue( uint32_t numWorkerThreads ) :
     m_NumLocalJobsActive( 0 ),
+    m_HelperWork( 8, true ),
+    m_NumHelperWork( 0 ),
     m_DistributableJobs_Available( 1024, true ),
     m_DistributableJobs_InProgress( 1024, true ),
+    m_RemoteJobsToCancel( 64, true ),
+    m_NumRacesWon( 0 ),
+    m_NumRacesLost( 0 ),
+    m_RaceTimeWonMS( 0 ),
+    m_RaceTimeWastedMS( 0 ),
     m_CompletedJobs( 1024, true ),
     m_CompletedJobsFailed( 1024, true ),
     m_CompletedJobs2( 1024, true ),
     m_CompletedJobsFailed2( 1024, true ),
+    m_ThreadActivity( nullptr ),
+    m_NumThreadActivity( numWorkerThreads + 1 ),
     m_Workers( numWorkerThreads, false )
 {
     PROFILE_FUNCTION
 
+    memset( &m_CompletedStats, 0, sizeof( m_CompletedStats ) );
+    m_ThreadActivity = FNEW_ARRAY( ThreadActivity[ m_NumThreadActivity ] );
+    memset( m_ThreadActivity, 0, sizeof( ThreadActivity ) * m_NumThreadActivity );
+
     WorkerThread::InitTmpDir();
 
     for ( uint32_t i=0; i<numWorkerThreads; ++i )
@@ -175,6 +200,8 @@ JobQueue::~JobQueue()
     ASSERT( m_CompletedJobs.IsEmpty() );
     ASSERT( m_CompletedJobsFailed.IsEmpty() );
     ASSERT( Job::GetTotalLocalDataMemoryUsage() == 0 );
+
+    FDELETE_ARRAY m_ThreadActivity;
 }
 
 // SignalStopWorkers (Main Thread)
@@ -230,6 +257,155 @@ void JobQueue::GetJobStats( uint32_t & numJobs,
     numJobsDistActive = (uint32_t)m_DistributableJobs_InProgress.GetSize();
 }
 
+// GetRaceStats
+//------------------------------------------------------------------------------
+void JobQueue::GetRaceStats( FBuildStats & stats ) const
+{
+    MutexHolder m( m_DistributedJobsMutex );
+
+    stats.m_NumRaces            = ( m_NumRacesWon + m_NumRacesLost );
+    stats.m_NumRacesWon         = m_NumRacesWon;
+    stats.m_RaceTimeWonMS       = m_RaceTimeWonMS;
+    stats.m_RaceTimeWastedMS    = m_RaceTimeWastedMS;
+}
+
+// GetThreadActivity
+//------------------------------------------------------------------------------
+void JobQueue::GetThreadActivity( Array< ThreadActivity > & outActivity ) const
+{
+    outActivity.SetSize( m_NumThreadActivity );
+    for ( uint32_t i = 0; i < m_NumThreadActivity; ++i )
+    {
+        const ThreadActivity & src = m_ThreadActivity[ i ];
+        ThreadActivity & dst = outActivity[ i ];
+        dst.m_Active        = AtomicLoadRelaxed( &src.m_Active );
+        dst.m_NumJobs       = AtomicLoadRelaxed( &src.m_NumJobs );
+        dst.m_BusyTimeMS    = AtomicLoadRelaxed( &src.m_BusyTimeMS );
+        dst.m_StartTime     = 0;
+    }
+}
+
+// OnThreadJobStarted
+//------------------------------------------------------------------------------
+void JobQueue::OnThreadJobStarted()
+{
+    const uint32_t threadIndex = WorkerThread::GetThreadIndex();
+    if ( threadIndex >= m_NumThreadActivity )
+    {
+        return; // not a local worker thread
+    }
+    ThreadActivity & activity = m_ThreadActivity[ threadIndex ];
+    activity.m_StartTime = Timer::GetNow();
+    AtomicStoreRelaxed( &activity.m_Active, 1 );
+}
+
+// OnThreadJobFinished
+//------------------------------------------------------------------------------
+void JobQueue::OnThreadJobFinished()
+{
+    const uint32_t threadIndex = WorkerThread::GetThreadIndex();
+    if ( threadIndex >= m_NumThreadActivity )
+    {
+        return; // not a local worker thread
+    }
+    ThreadActivity & activity = m_ThreadActivity[ threadIndex ];
+    const float timeMS = ( (float)( Timer::GetNow() - activity.m_StartTime ) * Timer::GetFrequencyInvFloatMS() );
+    AtomicAddU32( &activity.m_BusyTimeMS, (int32_t)timeMS );
+    AtomicIncU32( &activity.m_NumJobs );
+    AtomicStoreRelaxed( &activity.m_Active, 0 );
+}
+
+// RunWithIdleWorkers
+//------------------------------------------------------------------------------
+void JobQueue::RunWithIdleWorkers( HelperFunc func, void * userData, uint32_t maxHelpers )
+{
+    // the calling thread is one of the workers (or the main thread if there are none)
+    const uint32_t numOtherWorkers = m_Workers.IsEmpty() ? 0 : (uint32_t)( m_Workers.GetSize() - 1 );
+    if ( maxHelpers > numOtherWorkers )
+    {
+        maxHelpers = numOtherWorkers;
+    }
+    if ( maxHelpers == 0 )
+    {
+        func( userData );
+        return;
+    }
+
+    // make work available to idle threads
+    HelperWork work;
+    work.m_Func = func;
+    work.m_UserData = userData;
+    work.m_NumHelpersAllowed = maxHelpers;
+    work.m_NumHelpersActive = 0;
+    {
+        MutexHolder mh( m_HelperWorkMutex );
+        m_HelperWork.Append( &work );
+        AtomicIncU32( &m_NumHelperWork );
+    }
+    m_WorkerThreadSemaphore.Signal( maxHelpers );
+
+    func( userData );
+
+    // prevent more threads joining, and wait for those still working
+    {
+        MutexHolder mh( m_HelperWorkMutex );
+        VERIFY( m_HelperWork.FindAndErase( &work ) );
+        AtomicDecU32( &m_NumHelperWork );
+    }
+    while ( AtomicLoadAcquire( &work.m_NumHelpersActive ) > 0 )
+    {
+        Thread::Sleep( 1 );
+    }
+}
+
+// DoHelperWork (Worker Thread)
+//------------------------------------------------------------------------------
+bool JobQueue::DoHelperWork()
+{
+    // lock-free early out if there is no work to help with
+    if ( AtomicLoadRelaxed( &m_NumHelperWork ) == 0 )
+    {
+        return false;
+    }
+
+    HelperWork * work = nullptr;
+    {
+        MutexHolder mh( m_HelperWorkMutex );
+        for ( HelperWork * w : m_HelperWork )
+        {
+            if ( w->m_NumHelpersAllowed > 0 )
+            {
+                --w->m_NumHelpersAllowed;
+                AtomicIncU32( &w->m_NumHelpersActive );
+                work = w;
+                break;
+            }
+        }
+    }
+    if ( work == nullptr )
+    {
+        return false;
+    }
+
+    work->m_Func( work->m_UserData );
+
+    AtomicDecU32( &work->m_NumHelpersActive );
+    return true;
+}
+
+// UpdateCompletedStats
+//------------------------------------------------------------------------------
+void JobQueue::UpdateCompletedStats( const Node * node )
+{
+    CompletedStats & stats = m_CompletedStats;
+    stats.m_NumCompleted++;
+    stats.m_NumFailed       += ( node->GetState() == Node::FAILED ) ? 1u : 0u;
+    stats.m_NumBuilt        += node->GetStatFlag( Node::STATS_BUILT ) ? 1u : 0u;
+    stats.m_NumBuiltRemote  += node->GetStatFlag( Node::STATS_BUILT_REMOTE ) ? 1u : 0u;
+    stats.m_NumCacheHits    += node->GetStatFlag( Node::STATS_CACHE_HIT ) ? 1u : 0u;
+    stats.m_NumCacheMisses  += node->GetStatFlag( Node::STATS_CACHE_MISS ) ? 1u : 0u;
+}
+
 // AddJobToBatch (Main Thread)
 //------------------------------------------------------------------------------
 void JobQueue::AddJobToBatch( Node * node )
@@ -269,6 +445,7 @@ void JobQueue::QueueDistributableJob( Job * job )
         m_DistributableJobs_Available.Append( job );
 
         job->SetDistributionState( Job::DIST_AVAILABLE );
+        job->SetQueuedTime( Timer::GetNow() );
     }
 
     ASSERT( m_NumLocalJobsActive > 0 );
@@ -279,7 +456,7 @@ void JobQueue::QueueDistributableJob( Job * job )
 
 // GetDistributableJobToProcess
 //------------------------------------------------------------------------------
-Job * JobQueue::GetDistributableJobToProcess( bool remote )
+Job * JobQueue::GetDistributableJobToProcess( bool remote, float remoteTimeScale )
 {
     MutexHolder m( m_DistributedJobsMutex );
 
@@ -297,6 +474,17 @@ Job * JobQueue::GetDistributableJobToProcess( bool remote )
     // Tag job as in-use
     job->SetDistributionState( remote ? Job::DIST_BUILDING_REMOTELY : Job::DIST_BUILDING_LOCALLY );
     m_DistributableJobs_InProgress.Append( job );
+
+    // Predict remote round trip from the previous build time, scaled by the
+    // worker's observed overhead if known. This is used to decide what to race.
+    if ( remote )
+    {
+        const uint32_t lastBuildTimeMS = job->GetNode()->GetLastBuildTime();
+        const float predictedTimeMS = ( remoteTimeScale > 0.0f ) ? ( (float)lastBuildTimeMS * remoteTimeScale ) : (float)lastBuildTimeMS;
+        job->SetRemoteDispatchTime( Timer::GetNow() );
+        job->SetRemotePredictedTimeMS( (uint32_t)predictedTimeMS );
+    }
+
     return job;
 }
 
@@ -310,8 +498,14 @@ Job * JobQueue::GetDistributableJobToRace()
         return nullptr;
     }
 
-    // take newest job, which is least likely to finish first
-    // compared to older distributed jobs
+    const int64_t now = Timer::GetNow();
+    const float freqInvMS = Timer::GetFrequencyInvFloatMS();
+
+    // Race the job we expect to gain the most time on, using the previous build
+    // time of the node and the predicted remote round trip
+    Job * bestJob = nullptr;
+    int32_t bestGainMS = RACE_MIN_GAIN_MS;
+    Job * newestJobWithoutHistory = nullptr;
     const int32_t numJobs = (int32_t)m_DistributableJobs_InProgress.GetSize();
     for ( int32_t i = ( numJobs - 1 ); i >= 0; --i )
     {
@@ -319,14 +513,57 @@ Job * JobQueue::GetDistributableJobToRace()
 
         // Don't Race jobs already building locally
         const Job::DistributionState distState = job->GetDistributionState();
-        if ( distState == Job::DIST_BUILDING_REMOTELY )
+        if ( distState != Job::DIST_BUILDING_REMOTELY )
         {
-            job->SetDistributionState( Job::DIST_RACING );
-            return job;
+            continue;
+        }
+
+        const int32_t localTimeMS = (int32_t)job->GetNode()->GetLastBuildTime();
+        const int32_t predictedMS = (int32_t)job->GetRemotePredictedTimeMS();
+        if ( ( localTimeMS == 0 ) || ( predictedMS == 0 ) )
+        {
+            // no history - prefer newest job, which is least likely to finish first
+            // compared to older distributed jobs
+            if ( newestJobWithoutHistory == nullptr )
+            {
+                newestJobWithoutHistory = job;
+            }
+            continue;
+        }
+
+        const int32_t elapsedMS = (int32_t)( (float)( now - job->GetRemoteDispatchTime() ) * freqInvMS );
+        int32_t gainMS;
+        if ( elapsedMS < predictedMS )
+        {
+            // still on schedule - only worth racing if we'd finish sooner
+            gainMS = ( predictedMS - elapsedMS ) - localTimeMS;
+        }
+        else if ( (float)elapsedMS > ( (float)predictedMS * RACE_OVERDUE_FACTOR ) )
+        {
+            // well overdue (slow or stuck worker) - assume it needs as long again
+            gainMS = elapsedMS - localTimeMS;
+        }
+        else
+        {
+            continue; // a little late, so probably about to come back
+        }
+
+        if ( gainMS > bestGainMS )
+        {
+            bestGainMS = gainMS;
+            bestJob = job;
         }
     }
 
-    return nullptr; // No job found to race (all were local or races already)
+    Job * job = bestJob ? bestJob : newestJobWithoutHistory;
+    if ( job == nullptr )
+    {
+        return nullptr; // No job worth racing (all were local, races already or due back soon)
+    }
+
+    job->SetDistributionState( Job::DIST_RACING );
+    job->SetRaceStartTime( now );
+    return job;
 }
 
 // OnReturnRemoteJob
@@ -439,6 +676,7 @@ void JobQueue::ReturnUnfinishedDistributableJob( Job * job )
             // Put back in available queue
             m_DistributableJobs_Available.Append( job );
             job->SetDistributionState( Job::DIST_AVAILABLE );
+            job->SetQueuedTime( Timer::GetNow() );
         }
     }
 
@@ -446,6 +684,15 @@ void JobQueue::ReturnUnfinishedDistributableJob( Job * job )
     m_WorkerThreadSemaphore.Signal();
 }
 
+// GetRemoteJobsToCancel
+//------------------------------------------------------------------------------
+void JobQueue::GetRemoteJobsToCancel( Array< uint32_t > & jobIds )
+{
+    MutexHolder m( m_DistributedJobsMutex );
+    jobIds.Swap( m_RemoteJobsToCancel );
+    m_RemoteJobsToCancel.Clear();
+}
+
 // FinalizeCompletedJobs (Main Thread)
 //------------------------------------------------------------------------------
 void JobQueue::FinalizeCompletedJobs( NodeGraph & nodeGraph )
@@ -470,6 +717,7 @@ void JobQueue::FinalizeCompletedJobs( NodeGraph & nodeGraph )
         {
             n->SetState( Node::FAILED );
         }
+        UpdateCompletedStats( n );
 
         // Free normal jobs
         if ( job->GetDistributionState() == Job::DIST_NONE )
@@ -498,7 +746,8 @@ void JobQueue::FinalizeCompletedJobs( NodeGraph & nodeGraph )
             job->SetDistributionState( Job::DIST_RACE_WON_LOCALLY );
 
             // We can't delete the job yet, because it's still in use by the remote
-            // job. It will be freed when the remote job completes
+            // job. It will be freed when the remote job completes or is cancelled
+            m_RemoteJobsToCancel.Append( job->GetJobId() );
         }
     }
     m_CompletedJobs2.Clear();
@@ -507,6 +756,7 @@ void JobQueue::FinalizeCompletedJobs( NodeGraph & nodeGraph )
     for ( Job * job : m_CompletedJobsFailed2 )
     {
         job->GetNode()->SetState( Node::FAILED );
+        UpdateCompletedStats( job->GetNode() );
 
         // Free normal jobs
         if ( job->GetDistributionState() == Job::DIST_NONE )
@@ -535,7 +785,8 @@ void JobQueue::FinalizeCompletedJobs( NodeGraph & nodeGraph )
             job->SetDistributionState( Job::DIST_RACE_WON_LOCALLY );
 
             // We can't delete the job yet, because it's still in use by the remote
-            // job. It will be freed when the remote job completes
+            // job. It will be freed when the remote job completes or is cancelled
+            m_RemoteJobsToCancel.Append( job->GetJobId() );
         }
     }
     m_CompletedJobsFailed2.Clear();
@@ -598,6 +849,7 @@ void JobQueue::FinishedProcessingJob( Job * job, bool success, bool wasARemoteJo
             if ( success == false )
             {
                 // Allow remote job to win race
+                OnRaceFinished( job, false );
                 job->SetDistributionState( Job::DIST_RACE_WON_REMOTELY );
                 return; // Remote job will complete processing
             }
@@ -607,7 +859,7 @@ void JobQueue::FinishedProcessingJob( Job * job, bool success, bool wasARemoteJo
             // never happened
             m_DistributableJobs_InProgress.Erase( it );
             job->SetDistributionState( Job::DIST_COMPLETED_LOCALLY ); // Cancellation has failed
-
+            OnRaceFinished( job, true );
         }
         else if ( ( distState == Job::DIST_COMPLETED_REMOTELY ) ||
                   ( distState == Job::DIST_RACE_WON_REMOTELY ) )
@@ -620,11 +872,19 @@ void JobQueue::FinishedProcessingJob( Job * job, bool success, bool wasARemoteJo
             // Normal local build of a distributable job
             m_DistributableJobs_InProgress.Erase( it );
             job->SetDistributionState( Job::DIST_COMPLETED_LOCALLY );
+
+            // A race which reverted to a local build when the worker was lost
+            // (see ReturnUnfinishedDistributableJob) is decided by the local result
+            if ( job->GetRaceStartTime() != 0 )
+            {
+                OnRaceFinished( job, success );
+            }
         }
         else
         {
             // A race was completed locally
             ASSERT( distState == Job::DIST_RACING );
+            OnRaceFinished( job, success ); // a failed local build doesn't win
 
             // Leave in InProgress and leave state as-is (will be set to
             // DIST_RACE_WON_LOCALLY after Finalize)
@@ -652,11 +912,33 @@ void JobQueue::FinishedProcessingJob( Job * job, bool success, bool wasARemoteJo
     WakeMainThread();
 }
 
+// OnRaceFinished (Worker Thread)
+//------------------------------------------------------------------------------
+void JobQueue::OnRaceFinished( const Job * job, bool wonLocally )
+{
+    // NOTE: m_DistributedJobsMutex is held by caller
+    const uint32_t raceTimeMS = (uint32_t)( (float)( Timer::GetNow() - job->GetRaceStartTime() ) * Timer::GetFrequencyInvFloatMS() );
+    if ( wonLocally )
+    {
+        ++m_NumRacesWon;
+        m_RaceTimeWonMS += raceTimeMS;
+    }
+    else
+    {
+        ++m_NumRacesLost;
+        m_RaceTimeWastedMS += raceTimeMS;
+    }
+}
+
 // DoBuild
 //------------------------------------------------------------------------------
 /*static*/ Node::BuildResult JobQueue::DoBuild( Job * job )
 {
+    // Transient allocations made while processing the job are released in one step when it completes
+    MemArenaScope arenaScope( WorkerThread::GetJobArena() );
+
     Timer timer; // track how long the item takes
+    const int64_t startTime = BuildTrace::IsEnabled() ? Timer::GetNow() : 0;
 
     Node * node = job->GetNode();
 
@@ -750,6 +1032,11 @@ void JobQueue::FinishedProcessingJob( Job * job, bool success, bool wasARemoteJo
     // log processing time
     node->AddProcessingTime( timeTakenMS );
 
+    if ( BuildTrace::IsEnabled() )
+    {
+        AddBuildTraceSpan( job, result, startTime, false );
+    }
+
     if ( nodeRelevantToMonitorLog && FLog::IsMonitorEnabled() )
     {
         const char * resultString = nullptr;
@@ -773,4 +1060,28 @@ void JobQueue::FinishedProcessingJob( Job * job, bool success, bool wasARemoteJo
     return result;
 }
 
+// AddBuildTraceSpan
+//------------------------------------------------------------------------------
+/*static*/ void JobQueue::AddBuildTraceSpan( const Job * job, Node::BuildResult result, int64_t startTime, bool racing )
+{
+    const char * resultString = nullptr;
+    switch ( result )
+    {
+        case Node::NODE_RESULT_OK:                      resultString = "built";         break;
+        case Node::NODE_RESULT_NEED_SECOND_BUILD_PASS:  resultString = "preprocessed";  break;
+        case Node::NODE_RESULT_OK_CACHE:                resultString = "cache";         break;
+        case Node::NODE_RESULT_FAILED:                  resultString = "failed";        break;
+    }
+
+    // time spent waiting for a worker thread once available to build
+    const int64_t queuedTime = job->GetQueuedTime();
+    const float queueWaitMS = ( ( queuedTime != 0 ) && ( startTime > queuedTime ) ) ? ( (float)( startTime - queuedTime ) * Timer::GetFrequencyInvFloatMS() ) : 0.0f;
+
+    AStackString<> args;
+    args.Format( "\"result\":\"%s\",\"queue_ms\":%.3f%s", resultString, (double)queueWaitMS, racing ? ",\"race\":true" : "" );
+
+    const Node * node = job->GetNode();
+    BuildTrace::AddSpan( node->GetTypeName(), node->GetName().Get(), startTime, Timer::GetNow(), args.Get() );
+}
+
 //------------------------------------------------------------------------------
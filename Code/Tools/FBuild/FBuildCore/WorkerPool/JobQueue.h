@@ -13,6 +13,7 @@
 
 // Forward Declarations
 //------------------------------------------------------------------------------
+struct FBuildStats;
 class Node;
 class Job;
 class WorkerThread;
@@ -66,6 +67,41 @@ public:
     void GetJobStats( uint32_t & numJobs, uint32_t & numJobsActive,
                       uint32_t & numJobsDist, uint32_t & numJobsDistActive ) const;
 
+    // capture local racing outcomes for -summary/-report (call before destruction)
+    void GetRaceStats( FBuildStats & stats ) const;
+
+    // live activity of each local thread for -metrics (index 0 is the main thread)
+    struct ThreadActivity
+    {
+        volatile uint32_t   m_Active;       // 1 while processing a job
+        volatile uint32_t   m_NumJobs;      // jobs processed
+        volatile uint32_t   m_BusyTimeMS;   // time spent processing jobs
+        int64_t             m_StartTime;    // start of current job (owning thread only)
+    };
+    void GetThreadActivity( Array< ThreadActivity > & outActivity ) const;
+
+    // outcome of jobs finalized so far (main thread only)
+    struct CompletedStats
+    {
+        uint32_t    m_NumCompleted;
+        uint32_t    m_NumFailed;
+        uint32_t    m_NumBuilt;
+        uint32_t    m_NumBuiltRemote;
+        uint32_t    m_NumCacheHits;
+        uint32_t    m_NumCacheMisses;
+    };
+    const CompletedStats & GetCompletedStats() const { return m_CompletedStats; }
+
+    // record a completed local build for -trace (worker threads)
+    static void AddBuildTraceSpan( const Job * job, Node::BuildResult result, int64_t startTime, bool racing );
+
+    // a job being processed can share its work with idle worker threads
+    // - func is called by the calling thread and by up to maxHelpers idle worker
+    //   threads, and must take work items until none remain
+    // - returns once all calls of func have returned
+    typedef void (*HelperFunc)( void * userData );
+    void RunWithIdleWorkers( HelperFunc func, void * userData, uint32_t maxHelpers );
+
 private:
     // worker threads call these
     friend class WorkerThread;
@@ -74,14 +110,19 @@ private:
     Job *       GetDistributableJobToRace();
     static Node::BuildResult DoBuild( Job * job );
     void        FinishedProcessingJob( Job * job, bool result, bool wasARemoteJob );
+    void        OnRaceFinished( const Job * job, bool wonLocally );
+    void        OnThreadJobStarted();
+    void        OnThreadJobFinished();
+    bool        DoHelperWork();
 
     void        QueueDistributableJob( Job * job );
 
     // client side of protocol consumes jobs via this interface
     friend class Client;
-    Job *       GetDistributableJobToProcess( bool remote );
+    Job *       GetDistributableJobToProcess( bool remote, float remoteTimeScale = 0.0f );
     Job *       OnReturnRemoteJob( uint32_t jobId );
     void        ReturnUnfinishedDistributableJob( Job * job );
+    void        GetRemoteJobsToCancel( Array< uint32_t > & jobIds );
 
     // Semaphore to manage work
     Semaphore           m_WorkerThreadSemaphore;
@@ -93,10 +134,29 @@ private:
     // Jobs in progress locally
     uint32_t            m_NumLocalJobsActive;
 
+    // Work shared by jobs in progress locally (see RunWithIdleWorkers)
+    struct HelperWork
+    {
+        HelperFunc          m_Func;
+        void *              m_UserData;
+        uint32_t            m_NumHelpersAllowed;    // protected by m_HelperWorkMutex
+        volatile uint32_t   m_NumHelpersActive;
+    };
+    Mutex                   m_HelperWorkMutex;
+    Array< HelperWork * >   m_HelperWork;
+    volatile uint32_t       m_NumHelperWork;        // for lock-free early out
+
     // Jobs available for distributed processing (can also be done locally)
     mutable Mutex       m_DistributedJobsMutex;
     Array< Job * >      m_DistributableJobs_Available;  // Available, not in progress anywhere
     Array< Job * >      m_DistributableJobs_InProgress; // In progress remotely, locally or both
+    Array< uint32_t >   m_RemoteJobsToCancel;           // Remote builds no longer needed (race won locally)
+
+    // Local racing outcomes (protected by m_DistributedJobsMutex)
+    uint32_t            m_NumRacesWon;
+    uint32_t            m_NumRacesLost;
+    uint32_t            m_RaceTimeWonMS;
+    uint32_t            m_RaceTimeWastedMS;
 
     // Semaphore to manage thread idle
     Semaphore           m_MainThreadSemaphore;
@@ -109,6 +169,11 @@ private:
     // we have pair of arrays to enable a swap, avoiding locking the mutex too long
     Array< Job * >      m_CompletedJobs2;
     Array< Job * >      m_CompletedJobsFailed2;
+    CompletedStats      m_CompletedStats;
+    void                UpdateCompletedStats( const Node * node );
+
+    ThreadActivity *    m_ThreadActivity;   // by thread index
+    uint32_t            m_NumThreadActivity;
 
     Array< WorkerThread * > m_Workers;
 };
@@ -5,13 +5,14 @@
 //------------------------------------------------------------------------------
 #include "JobQueueRemote.h"
 #include "Job.h"
+#include "JobQueue.h"
 #include "WorkerThreadRemote.h"
 
 #include "Tools/FBuild/FBuildCore/FBuild.h"
 #include "Tools/FBuild/FBuildCore/FLog.h"
 #include "Tools/FBuild/FBuildCore/Graph/Node.h"
-#include "Tools/FBuild/FBuildCore/Graph/ObjectNode.h"
-#include "Tools/FBuild/FBuildCore/Helpers/MultiBuffer.h"
+#include "Tools/FBuild/FBuildCore/Graph/FileNode.h"
+#include "Tools/FBuild/FBuildCore/Helpers/BuildTrace.h"
 #include "Tools/FBuild/FBuildCore/Helpers/Compressor.h"
 
 // Core
@@ -19,11 +20,17 @@
 #include "Core/Containers/AutoPtr.h"
 #include "Core/FileIO/FileIO.h"
 #include "Core/FileIO/FileStream.h"
+#include "Core/FileIO/MemoryStream.h"
 #include "Core/FileIO/PathUtils.h"
+#include "Core/Math/Conversions.h"
 #include "Core/Profile/Profile.h"
 #include "Core/Time/Timer.h"
 #include "Core/Tracing/Tracing.h"
 
+// Defines
+//------------------------------------------------------------------------------
+#define JOB_RESULT_CHUNK_SIZE ( 1 * MEGABYTE ) // uncompressed size of each streamed piece of a result file
+
 // CONSTRUCTOR
 //------------------------------------------------------------------------------
 JobQueueRemote::JobQueueRemote( uint32_t numWorkerThreads ) :
@@ -215,6 +222,59 @@ void JobQueueRemote::CancelJobsWithUserData( void * userData )
     }
 }
 
+// CancelJob
+//------------------------------------------------------------------------------
+bool JobQueueRemote::CancelJob( void * userData, uint32_t jobId )
+{
+    // delete if not yet started
+    {
+        MutexHolder m( m_PendingJobsMutex );
+        for ( Job ** it = m_PendingJobs.Begin(); it != m_PendingJobs.End(); ++it )
+        {
+            if ( ( ( *it )->GetUserData() == userData ) && ( ( *it )->GetJobId() == jobId ) )
+            {
+                FDELETE *it;
+                m_PendingJobs.Erase( it );
+                return true;
+            }
+        }
+    }
+
+    // abort if in-flight
+    // (the job is deleted upon completion - see FinishedProcessingJob)
+    {
+        MutexHolder mh( m_InFlightJobsMutex );
+        for ( Job * job : m_InFlightJobs )
+        {
+            if ( ( job->GetUserData() == userData ) && ( job->GetJobId() == jobId ) )
+            {
+                job->SetUserData( nullptr );
+                job->Cancel();
+                return true;
+            }
+        }
+    }
+
+    // delete if completed but not yet returned
+    MutexHolder m( m_CompletedJobsMutex );
+    Array< Job * > * const completedLists[] = { &m_CompletedJobs, &m_CompletedJobsFailed };
+    for ( Array< Job * > * jobs : completedLists )
+    {
+        for ( Job ** it = jobs->Begin(); it != jobs->End(); ++it )
+        {
+            if ( ( ( *it )->GetUserData() == userData ) && ( ( *it )->GetJobId() == jobId ) )
+            {
+                FDELETE *it;
+                jobs->Erase( it );
+                return true;
+            }
+        }
+    }
+
+    // job has already been returned
+    return false;
+}
+
 // GetJobToProcess (Worker Thread)
 //------------------------------------------------------------------------------
 Job * JobQueueRemote::GetJobToProcess()
@@ -276,9 +336,13 @@ void JobQueueRemote::FinishedProcessingJob( Job * job, bool success )
 //------------------------------------------------------------------------------
 /*static*/ Node::BuildResult JobQueueRemote::DoBuild( Job * job, bool racingRemoteJob )
 {
+    // Transient allocations made while processing the job are released in one step when it completes
+    MemArenaScope arenaScope( WorkerThread::GetJobArena() );
+
     Timer timer; // track how long the item takes
+    const int64_t startTime = BuildTrace::IsEnabled() ? Timer::GetNow() : 0;
 
-    ObjectNode * node = job->GetNode()->CastTo< ObjectNode >();
+    FileNode * node = job->GetNode()->CastTo< FileNode >();
 
     if ( job->IsLocal() )
     {
@@ -307,12 +371,16 @@ void JobQueueRemote::FinishedProcessingJob( Job * job, bool success )
         return Node::NODE_RESULT_FAILED;
     }
 
-    // Delete any left over PDB from a previous run (to be sure we have a clean pdb)
-    if ( node->IsUsingPDB() && ( job->IsLocal() == false ) )
+    // Delete any left over secondary outputs (pdb etc) from a previous run
+    // (to be sure we have clean files)
+    Array< AString > outputFiles;
+    if ( job->IsLocal() == false )
     {
-        AStackString<> pdbName;
-        node->GetPDBName( pdbName );
-        FileIO::FileDelete( pdbName.Get() );
+        node->GetRemoteOutputFiles( outputFiles );
+        for ( size_t i = 1; i < outputFiles.GetSize(); ++i )
+        {
+            FileIO::FileDelete( outputFiles[ i ].Get() );
+        }
     }
 
     Node::BuildResult result;
@@ -369,21 +437,21 @@ void JobQueueRemote::FinishedProcessingJob( Job * job, bool success )
     // if compiling to a tmp file, do cleanup
     if ( job->IsLocal() == false )
     {
-        // Cleanup obj file
-        FileIO::FileDelete( node->GetName().Get() );
-
-        // Cleanup PDB file
-        if ( node->IsUsingPDB() )
+        // Cleanup output file(s)
+        for ( const AString & outputFile : outputFiles )
         {
-            AStackString<> pdbName;
-            node->GetPDBName( pdbName );
-            FileIO::FileDelete( pdbName.Get() );
+            FileIO::FileDelete( outputFile.Get() );
         }
     }
 
     // log processing time
     node->AddProcessingTime( timeTakenMS );
 
+    if ( job->IsLocal() && BuildTrace::IsEnabled() )
+    {
+        JobQueue::AddBuildTraceSpan( job, result, startTime, racingRemoteJob );
+    }
+
     if ( job->IsLocal() && FLog::IsMonitorEnabled() )
     {
         AStackString<> msgBuffer;
@@ -402,50 +470,49 @@ void JobQueueRemote::FinishedProcessingJob( Job * job, bool success )
 //------------------------------------------------------------------------------
 /*static*/ bool JobQueueRemote::ReadResults( Job * job )
 {
-    const ObjectNode * node = job->GetNode()->CastTo< ObjectNode >();
-    const bool includePDB = node->IsUsingPDB();
-    const bool usingStaticAnalysis = node->IsUsingStaticAnalysisMSVC();
-
-    // Detemine list of files to send
-
-    // 1. Object file
-    //---------------
+    // Detemine list of files to send (main output first)
     Array< AString > fileNames( 3, false );
-    fileNames.Append( node->GetName() );
-
-    // 2. PDB file (optional)
-    //-----------------------
-    if ( includePDB )
+    job->GetNode()->GetRemoteOutputFiles( fileNames );
+
+    // Each file is split into independently compressed chunks, so the client
+    // can write them as they arrive instead of holding the entire result:
+    //   uint32_t numFiles
+    //   per file : uint32_t numChunks
+    //   per chunk: uint32_t size, compressed data
+    MemoryStream ms;
+    ms.Write( (uint32_t)fileNames.GetSize() );
+    AutoPtr< char > buffer( (char *)ALLOC( JOB_RESULT_CHUNK_SIZE ) );
+    for ( const AString & fileName : fileNames )
     {
-        AStackString<> pdbFileName;
-        node->GetPDBName( pdbFileName );
-        fileNames.Append( pdbFileName );
-    }
-
-    // 3. .nativecodeanalysis.xml file (optional)
-    //--------------------------------------------
-    if ( usingStaticAnalysis )
-    {
-        AStackString<> xmlFileName;
-        node->GetNativeAnalysisXMLPath( xmlFileName );
-        fileNames.Append( xmlFileName );
-    }
+        FileStream fs;
+        if ( fs.Open( fileName.Get(), FileStream::READ_ONLY ) == false )
+        {
+            job->Error( "Error reading file: '%s'", fileName.Get() );
+            FLOG_ERROR( "Error reading file: '%s'", fileName.Get() );
+            return false;
+        }
+        const uint64_t fileSize = fs.GetFileSize();
+        const uint32_t numChunks = (uint32_t)Math::Max< uint64_t >( 1, ( fileSize + JOB_RESULT_CHUNK_SIZE - 1 ) / JOB_RESULT_CHUNK_SIZE );
+        ms.Write( numChunks );
+        for ( uint32_t i = 0; i < numChunks; ++i )
+        {
+            const uint32_t chunkSize = (uint32_t)Math::Min< uint64_t >( JOB_RESULT_CHUNK_SIZE, fileSize - ( (uint64_t)i * JOB_RESULT_CHUNK_SIZE ) );
+            if ( fs.ReadBuffer( buffer.Get(), chunkSize ) != chunkSize )
+            {
+                job->Error( "Error reading file: '%s'", fileName.Get() );
+                FLOG_ERROR( "Error reading file: '%s'", fileName.Get() );
+                return false;
+            }
 
-    MultiBuffer mb;
-    size_t problemFileIndex = 0;
-    if ( !mb.CreateFromFiles( fileNames, &problemFileIndex ) )
-    {
-        job->Error( "Error reading file: '%s'", fileNames[ problemFileIndex ].Get() );
-        FLOG_ERROR( "Error reading file: '%s'", fileNames[ problemFileIndex ].Get() );
+            Compressor c;
+            c.Compress( buffer.Get(), chunkSize );
+            ms.Write( (uint32_t)c.GetResultSize() );
+            ms.WriteBuffer( c.GetResult(), c.GetResultSize() );
+        }
     }
 
-   
-
-    Compressor c;
-    bool compressed = c.Compress(mb.GetData(), mb.GetDataSize());
-    job->OwnData(c.ReleaseResult(), c.GetResultSize(), compressed);
-
-   
+    const size_t size = ms.GetSize();
+    job->OwnData( ms.Release(), size, false );
     return true;
 }
 
@@ -29,6 +29,7 @@ public:
     void QueueJob( Job * job );
     Job * GetCompletedJob();
     void CancelJobsWithUserData( void * userData );
+    bool CancelJob( void * userData, uint32_t jobId );
 
     // handle shutting down
     void SignalStopWorkers();
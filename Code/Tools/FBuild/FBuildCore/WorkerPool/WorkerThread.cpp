@@ -23,6 +23,7 @@
 // Static
 //------------------------------------------------------------------------------
 static THREAD_LOCAL uint32_t s_WorkerThreadThreadIndex = 0;
+static THREAD_LOCAL MemArena * s_WorkerThreadJobArena = nullptr;
 Mutex WorkerThread::s_TmpRootMutex;
 AStackString<> WorkerThread::s_TmpRoot;
 
@@ -110,12 +111,20 @@ void WorkerThread::WaitForStop()
     return s_WorkerThreadThreadIndex;
 }
 
+// GetJobArena
+//------------------------------------------------------------------------------
+/*static*/ MemArena * WorkerThread::GetJobArena()
+{
+    return s_WorkerThreadJobArena;
+}
+
 // MainWrapper
 //------------------------------------------------------------------------------
 /*static*/ uint32_t WorkerThread::ThreadWrapperFunc( void * param )
 {
     WorkerThread * wt = static_cast< WorkerThread * >( param );
     s_WorkerThreadThreadIndex = wt->m_ThreadIndex;
+    s_WorkerThreadJobArena = &wt->m_JobArena;
 
     #if defined( PROFILING_ENABLED )
         AStackString<> threadName;
@@ -171,7 +180,9 @@ void WorkerThread::WaitForStop()
         ASSERT( job->GetNode()->GetState() == Node::BUILDING );
 
         // process the work
+        JobQueue::Get().OnThreadJobStarted();
         Node::BuildResult result = JobQueue::DoBuild( job );
+        JobQueue::Get().OnThreadJobFinished();
 
         if ( result == Node::NODE_RESULT_FAILED )
         {
@@ -198,7 +209,9 @@ void WorkerThread::WaitForStop()
         if ( job != nullptr )
         {
             // process the work
+            JobQueue::Get().OnThreadJobStarted();
             Node::BuildResult result = JobQueueRemote::DoBuild( job, false );
+            JobQueue::Get().OnThreadJobFinished();
 
             if ( result == Node::NODE_RESULT_FAILED )
             {
@@ -211,6 +224,12 @@ void WorkerThread::WaitForStop()
         }
     }
 
+    // help a job in progress which is sharing its work
+    if ( JobQueue::IsValid() && JobQueue::Get().DoHelperWork() )
+    {
+        return true; // did some work
+    }
+
     // race remote jobs
     if ( FBuild::Get().GetOptions().m_AllowLocalRace )
     {
@@ -218,7 +237,9 @@ void WorkerThread::WaitForStop()
         if ( job != nullptr )
         {
             // process the work
+            JobQueue::Get().OnThreadJobStarted();
             Node::BuildResult result = JobQueueRemote::DoBuild( job, true );
+            JobQueue::Get().OnThreadJobFinished();
 
             if ( result == Node::NODE_RESULT_FAILED )
             {
@@ -5,6 +5,7 @@
 // Includes
 //------------------------------------------------------------------------------
 #include "Core/Env/Types.h"
+#include "Core/Mem/MemArena.h"
 #include "Core/Process/Mutex.h"
 #include "Core/Process/Semaphore.h"
 #include "Core/Strings/AStackString.h"
@@ -31,6 +32,9 @@ public:
 
     static uint32_t GetThreadIndex();
 
+    // Arena for transient allocations while processing a job (nullptr if not a worker thread)
+    static MemArena * GetJobArena();
+
     static void GetTempFileDirectory( AString & tmpFileDirectory );
 
     static void CreateTempFilePath( const char * fileName,
@@ -52,6 +56,7 @@ protected:
     volatile bool m_Exited;
     uint32_t      m_ThreadIndex;
     Semaphore     m_MainThreadWaitForExit; // Used by main thread to wait for exit of worker
+    MemArena      m_JobArena;              // Reset after each job (see JobQueue::DoBuild)
 
     static Mutex s_TmpRootMutex; // s_TmpRoot is shared by local and remote queues in tests
     static AStackString<> s_TmpRoot;
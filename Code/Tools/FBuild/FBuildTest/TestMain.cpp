@@ -31,12 +31,14 @@ int main( int, char *[] )
     REGISTER_TESTGROUP( TestIncludeParser )
     REGISTER_TESTGROUP( TestLibrary )
     REGISTER_TESTGROUP( TestLinker )
+    REGISTER_TESTGROUP( TestMetrics )
     REGISTER_TESTGROUP( TestNodeReflection )
     REGISTER_TESTGROUP( TestObject )
     REGISTER_TESTGROUP( TestObjectList )
     REGISTER_TESTGROUP( TestPrecompiledHeaders )
     REGISTER_TESTGROUP( TestProjectGeneration )
     REGISTER_TESTGROUP( TestRemoveDir )
+    REGISTER_TESTGROUP( TestReport )
     REGISTER_TESTGROUP( TestTest )
     REGISTER_TESTGROUP( TestTextFile )
     REGISTER_TESTGROUP( TestUnity )
@@ -6,6 +6,7 @@
 #include "FBuildTest.h"
 
 #include "Tools/FBuild/FBuildCore/FBuild.h"
+#include "Tools/FBuild/FBuildCore/Helpers/BuildHistory.h"
 
 #include "Core/FileIO/FileIO.h"
 #include "Core/Strings/AStackString.h"
@@ -21,6 +22,7 @@ private:
     void TestBuildLib() const;
     void TestBuildLib_NoRebuild() const;
     void TestBuildLib_NoRebuild_BFFChange() const;
+    void TestBuildLib_History() const;
     void TestLibMerge() const;
     void TestLibMerge_NoRebuild() const;
     void TestLibMerge_NoRebuild_BFFChange() const;
@@ -37,6 +39,7 @@ REGISTER_TESTS_BEGIN( TestBuildAndLinkLibrary )
     REGISTER_TEST( TestBuildLib )
     REGISTER_TEST( TestBuildLib_NoRebuild )
     REGISTER_TEST( TestBuildLib_NoRebuild_BFFChange )
+    REGISTER_TEST( TestBuildLib_History )
     REGISTER_TEST( TestLibMerge )
     REGISTER_TEST( TestLibMerge_NoRebuild )
     REGISTER_TEST( TestLibMerge_NoRebuild_BFFChange )
@@ -153,6 +156,58 @@ void TestBuildAndLinkLibrary::TestBuildLib_NoRebuild_BFFChange() const
     CheckStatsTotal( 13,    8 );
 }
 
+// TestBuildLib_History
+//------------------------------------------------------------------------------
+void TestBuildAndLinkLibrary::TestBuildLib_History() const
+{
+    FBuildTestOptions options;
+    options.m_ConfigFile = "Tools/FBuild/FBuildTest/Data/TestBuildAndLinkLibrary/fbuild.bff";
+    options.m_ForceCleanBuild = true;
+    options.m_RecordHistory = true;
+
+    const AStackString<> lib( "../tmp/Test/BuildAndLinkLibrary/test.lib" );
+    const AStackString<> historyFile( "../tmp/Test/BuildAndLinkLibrary/buildlib.history" );
+    EnsureFileDoesNotExist( historyFile );
+
+    // Record a couple of clean builds
+    for ( uint32_t i = 0; i < 2; ++i )
+    {
+        FBuild fBuild( options );
+        TEST_ASSERT( fBuild.Initialize( GetBuildLibDBFileName() ) );
+        TEST_ASSERT( fBuild.GetHistoryFile() == historyFile );
+        TEST_ASSERT( fBuild.Build( lib ) );
+    }
+    EnsureFileExists( historyFile );
+
+    // Check the records
+    {
+        BuildHistory history;
+        TEST_ASSERT( history.Load( historyFile ) );
+        TEST_ASSERT( history.GetRecords().GetSize() == 2 );
+        BuildHistory::BuildRecord & record = *history.GetRecords().Top();
+        TEST_ASSERT( record.m_BuildOK );
+        TEST_ASSERT( record.m_Libraries.GetSize() == 1 );
+        TEST_ASSERT( record.m_Libraries[ 0 ].m_Name.EndsWith( "test.lib" ) );
+        TEST_ASSERT( record.m_Libraries[ 0 ].m_NumObjectsBuilt == 3 );
+
+        // Append a copy of the latest build where the library is much slower
+        BuildHistory::LibraryRecord & libRecord = record.m_Libraries[ 0 ];
+        libRecord.m_CPUTimeMS += ( libRecord.m_NumObjectsBuilt * 10 * 1000 ); // +10s per object
+        TEST_ASSERT( BuildHistory::AppendRecord( record, historyFile ) );
+    }
+
+    // The slower library should be reported
+    BuildHistory history;
+    TEST_ASSERT( history.Load( historyFile ) );
+    TEST_ASSERT( history.GetRecords().GetSize() == 3 );
+    history.OutputRegressions( 25 );
+    const AString & output = GetRecordedOutput();
+    const char * libRegressions = output.Find( "Library CPU Time (per object):" );
+    TEST_ASSERT( libRegressions );
+    TEST_ASSERT( output.Find( "test.lib", libRegressions ) );
+    TEST_ASSERT( output.Find( "No regressions." ) == nullptr );
+}
+
 // TestLibMerge
 //------------------------------------------------------------------------------
 void TestBuildAndLinkLibrary::TestLibMerge() const
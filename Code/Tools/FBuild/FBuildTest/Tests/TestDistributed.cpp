@@ -6,6 +6,7 @@
 #include "Tools/FBuild/FBuildTest/Tests/FBuildTest.h"
 
 #include "Tools/FBuild/FBuildCore/FBuild.h"
+#include "Tools/FBuild/FBuildCore/Helpers/FBuildStats.h"
 #include "Tools/FBuild/FBuildCore/Protocol/Protocol.h"
 #include "Tools/FBuild/FBuildCore/Protocol/Server.h"
 #include "Tools/FBuild/FBuildCore/WorkerPool/Job.h"
@@ -45,6 +46,11 @@ private:
     void TestZiDebugFormat() const;
     void TestZiDebugFormat_Local() const;
     void D8049_ToolLongDebugRecord() const;
+    void WorkerStats() const;
+    void LocalRaceStats() const;
+    void DistributedExec() const;
+    void StreamedResultsMovedIntoPlace() const;
+    void TraceFile() const;
 
     void TestHelper( const char * target,
                      uint32_t numRemoteWorkers,
@@ -63,6 +69,11 @@ REGISTER_TESTS_BEGIN( TestDistributed )
     REGISTER_TEST( RemoteRaceWinRemote )
     REGISTER_TEST( AnonymousNamespaces )
     REGISTER_TEST( ShutdownMemoryLeak )
+    REGISTER_TEST( WorkerStats )
+    REGISTER_TEST( LocalRaceStats )
+    REGISTER_TEST( DistributedExec )
+    REGISTER_TEST( StreamedResultsMovedIntoPlace )
+    REGISTER_TEST( TraceFile )
     #if defined( __WINDOWS__ )
         REGISTER_TEST( ErrorsAreCorrectlyReported_MSVC ) // TODO:B Enable for OSX and Linux
         REGISTER_TEST( ErrorsAreCorrectlyReported_Clang ) // TODO:B Enable for OSX and Linux
@@ -462,4 +473,163 @@ void TestDistributed::D8049_ToolLongDebugRecord() const
     TEST_ASSERT( fBuild.Build( "D8049" ) );
 }
 
+// WorkerStats
+//------------------------------------------------------------------------------
+void TestDistributed::WorkerStats() const
+{
+    // Check that per-worker performance is captured for the report
+    FBuildTestOptions options;
+    options.m_ConfigFile = "Tools/FBuild/FBuildTest/Data/TestDistributed/fbuild.bff";
+    options.m_AllowDistributed = true;
+    options.m_NumWorkerThreads = 1;
+    options.m_NoLocalConsumptionOfRemoteJobs = true; // ensure all jobs happen on the remote worker
+    options.m_ForceCleanBuild = true;
+    options.m_DistributionPort = TEST_PROTOCOL_PORT;
+    FBuild fBuild( options );
+
+    TEST_ASSERT( fBuild.Initialize() );
+
+    // start a client to emulate the other end
+    Server s( 4 );
+    s.Listen( TEST_PROTOCOL_PORT );
+
+    TEST_ASSERT( fBuild.Build( "../tmp/Test/Distributed/dist.lib" ) );
+
+    // A single worker should have returned all the jobs
+    const Array< FBuildStats::WorkerStats > & workerStats = fBuild.GetStats().GetWorkerStats();
+    TEST_ASSERT( workerStats.GetSize() == 1 );
+    const FBuildStats::WorkerStats & ws = workerStats[ 0 ];
+    TEST_ASSERT( ws.m_NumJobs > 0 );
+    TEST_ASSERT( ws.m_NumFailures == 0 );
+    TEST_ASSERT( ws.m_NumCPUs == 4 );
+    TEST_ASSERT( ws.m_AvgRoundTripMS > 0.0f );
+    TEST_ASSERT( ws.m_Replaced == false );
+
+    // Every job sent records the compression chosen for it
+    TEST_ASSERT( ( ws.m_NumJobsUncompressed + ws.m_NumJobsLZ4 + ws.m_NumJobsLZ4HC ) >= ws.m_NumJobs );
+}
+
+// LocalRaceStats
+//------------------------------------------------------------------------------
+void TestDistributed::LocalRaceStats() const
+{
+    // Check that the outcome of local races is captured for the summary/report
+    FBuildTestOptions options;
+    options.m_ConfigFile = "Tools/FBuild/FBuildTest/Data/TestDistributed/fbuild.bff";
+    options.m_AllowDistributed = true;
+    options.m_NumWorkerThreads = 1;
+    options.m_NoLocalConsumptionOfRemoteJobs = true; // local thread can only race
+    options.m_AllowLocalRace = true;
+    options.m_ForceCleanBuild = true;
+    options.m_DistributionPort = TEST_PROTOCOL_PORT;
+    FBuild fBuild( options );
+
+    TEST_ASSERT( fBuild.Initialize() );
+
+    // start a client to emulate the other end
+    Server s( 1 );
+    s.Listen( TEST_PROTOCOL_PORT );
+
+    TEST_ASSERT( fBuild.Build( "../tmp/Test/Distributed/dist.lib" ) );
+
+    // Whether the otherwise idle local thread gets to race depends on timing,
+    // but any races must be consistently accounted as won or lost
+    const FBuildStats & stats = fBuild.GetStats();
+    TEST_ASSERT( stats.m_NumRacesWon <= stats.m_NumRaces );
+    if ( stats.m_NumRaces == 0 )
+    {
+        TEST_ASSERT( stats.m_RaceTimeWonMS == 0 );
+    }
+    if ( stats.m_NumRacesWon == stats.m_NumRaces )
+    {
+        TEST_ASSERT( stats.m_RaceTimeWastedMS == 0 );
+    }
+}
+
+// DistributedExec
+//------------------------------------------------------------------------------
+void TestDistributed::DistributedExec() const
+{
+    // Check that an Exec() using a Compiler() with .ExecAllowDistribution is
+    // built remotely, with inputs sent to the worker and outputs returned
+    FBuildTestOptions options;
+    options.m_ConfigFile = "Tools/FBuild/FBuildTest/Data/TestDistributed/Exec/fbuild.bff";
+    options.m_AllowDistributed = true;
+    options.m_NumWorkerThreads = 1;
+    options.m_NoLocalConsumptionOfRemoteJobs = true; // ensure all jobs happen on the remote worker
+    options.m_ForceCleanBuild = true;
+    options.m_DistributionPort = TEST_PROTOCOL_PORT;
+    FBuild fBuild( options );
+
+    TEST_ASSERT( fBuild.Initialize() );
+
+    // start a client to emulate the other end
+    Server s( 1 );
+    s.Listen( TEST_PROTOCOL_PORT );
+
+    const AStackString<> output( "../tmp/Test/Distributed/Exec/output.txt" );
+    EnsureFileDoesNotExist( output );
+
+    TEST_ASSERT( fBuild.Build( "Exec" ) );
+
+    // Output should have been returned by the worker
+    EnsureFileExists( output );
+
+    // Check stats
+    //               Seen,  Built,  Type
+    CheckStatsNode ( 1,     1,      Node::EXEC_NODE );
+    CheckStatsNode ( 1,     1,      Node::COMPILER_NODE );
+    TEST_ASSERT( fBuild.GetStats().GetWorkerStats().IsEmpty() == false );
+}
+
+// StreamedResultsMovedIntoPlace
+//------------------------------------------------------------------------------
+void TestDistributed::StreamedResultsMovedIntoPlace() const
+{
+    // Several remote threads ensure results are returned in batches
+    const char * target( "../tmp/Test/Distributed/dist.lib" );
+    TestHelper( target, 4 );
+
+    // Output files are streamed to temp files, which should all be moved into place
+    Array< AString > tmpFiles;
+    FileIO::GetFiles( AStackString<>( "../tmp/Test/Distributed" ), AStackString<>( "*.fbtmp" ), true, &tmpFiles );
+    TEST_ASSERT( tmpFiles.IsEmpty() );
+}
+
+// TraceFile
+//------------------------------------------------------------------------------
+void TestDistributed::TraceFile() const
+{
+    // Check that remote jobs are recorded in the -trace timeline
+    const char * traceFile( "../tmp/Test/Distributed/trace.json" );
+
+    FBuildTestOptions options;
+    options.m_ConfigFile = "Tools/FBuild/FBuildTest/Data/TestDistributed/fbuild.bff";
+    options.m_AllowDistributed = true;
+    options.m_NumWorkerThreads = 1;
+    options.m_NoLocalConsumptionOfRemoteJobs = true; // ensure all jobs happen on the remote worker
+    options.m_ForceCleanBuild = true;
+    options.m_DistributionPort = TEST_PROTOCOL_PORT;
+    options.m_TraceFile = traceFile;
+    FBuild fBuild( options );
+
+    TEST_ASSERT( fBuild.Initialize() );
+
+    // start a client to emulate the other end
+    Server s( 1 );
+    s.Listen( TEST_PROTOCOL_PORT );
+
+    EnsureFileDoesNotExist( traceFile );
+
+    TEST_ASSERT( fBuild.Build( "../tmp/Test/Distributed/dist.lib" ) );
+
+    AString trace;
+    LoadFileContentsAsString( traceFile, trace );
+    TEST_ASSERT( trace.BeginsWith( "{\"traceEvents\":[" ) );
+    TEST_ASSERT( trace.Find( "\"name\":\"DoBuildPass\"" ) );     // main thread
+    TEST_ASSERT( trace.Find( "\"name\":\"Worker Thread 1\"" ) ); // preprocessing
+    TEST_ASSERT( trace.Find( "\"name\":\"Remote: " ) );           // remote compilation
+    TEST_ASSERT( trace.Find( "\"name\":\"Send Job\"" ) );        // network
+}
+
 //------------------------------------------------------------------------------
@@ -429,6 +429,17 @@ void TestGraph::TestCleanPath() const
     CHECK( "subdir\\\\..\\\\.file", "C:\\Windows\\System32\\.file",             "/tmp/subDir/.file" )
     CHECK( "subdir//..//.file",     "C:\\Windows\\System32\\.file",             "/tmp/subDir/.file" )
 
+    // long paths (cleaned in blocks)
+    CHECK( "LongFolderName0123456789/AnotherLongFolderName\\File.dat",
+           "C:\\Windows\\System32\\LongFolderName0123456789\\AnotherLongFolderName\\File.dat",
+           "/tmp/subDir/LongFolderName0123456789/AnotherLongFolderName/File.dat" )
+    CHECK( "LongFolderName0123456789/Private/../Public/./File.dat",
+           "C:\\Windows\\System32\\LongFolderName0123456789\\Public\\File.dat",
+           "/tmp/subDir/LongFolderName0123456789/Public/File.dat" )
+    CHECK( "LongFolderName0123456789//AnotherLongFolderName\\\\..//File.dat",
+           "C:\\Windows\\System32\\LongFolderName0123456789\\File.dat",
+           "/tmp/subDir/LongFolderName0123456789/File.dat" )
+
     // edge cases/regressions
     #if defined( __WINDOWS__ )
         // - There was a bug with folders beginning with a slash on Windows
@@ -526,6 +537,17 @@ void TestGraph::TestCleanPathPartial() const
     CHECK_RELATIVE( "subdir\\\\..\\\\.file", ".file", ".file" )
     CHECK_RELATIVE( "subdir//..//.file", ".file", ".file" )
 
+    // long paths (cleaned in blocks)
+    CHECK_RELATIVE( "LongFolderName0123456789/AnotherLongFolderName\\File.dat",
+                    "LongFolderName0123456789\\AnotherLongFolderName\\File.dat",
+                    "LongFolderName0123456789/AnotherLongFolderName/File.dat" )
+    CHECK_RELATIVE( "LongFolderName0123456789/Private/../Public/./File.dat",
+                    "LongFolderName0123456789\\Public\\File.dat",
+                    "LongFolderName0123456789/Public/File.dat" )
+    CHECK_RELATIVE( "LongFolderName0123456789//AnotherLongFolderName\\\\..//File.dat",
+                    "LongFolderName0123456789\\File.dat",
+                    "LongFolderName0123456789/File.dat" )
+
     // edge cases/regressions
     #if defined( __WINDOWS__ )
         // - There was a bug with folders beginning with a slash on Windows
@@ -6,9 +6,14 @@
 #include "FBuildTest.h"
 
 // FBuildCore
+#include "Tools/FBuild/FBuildCore/FBuild.h"
 #include "Tools/FBuild/FBuildCore/Graph/LibraryNode.h"
+#include "Tools/FBuild/FBuildCore/Helpers/FBuildStats.h"
 
 // Core
+#include "Core/FileIO/FileIO.h"
+#include "Core/Process/Process.h"
+#include "Core/Process/Thread.h"
 #include <Core/Strings/AStackString.h>
 
 // TestLibrary
@@ -20,12 +25,26 @@ private:
 
     // Tests
     void LibraryType() const;
+    void UpdateInPlaceOptions() const;
+    void ShardedArchive() const;
+    void UpdateInPlace() const;
+
+    // Helpers
+    void MakeSources() const;
+    void ChangeSource() const;
+    FBuildStats BuildArchive( const char * target, bool useDB ) const;
+    void CheckExeResult( const char * exeName, int expectedResult ) const;
 };
 
 // Register Tests
 //------------------------------------------------------------------------------
 REGISTER_TESTS_BEGIN( TestLibrary )
     REGISTER_TEST( LibraryType )    // Test library detection code
+    #if !defined( __WINDOWS__ )
+        REGISTER_TEST( UpdateInPlaceOptions )   // Only 'r' can be used to update in place
+        REGISTER_TEST( ShardedArchive )         // Only changed shards are rebuilt, and the output can be linked
+        REGISTER_TEST( UpdateInPlace )          // Changed members are replaced in the existing archive
+    #endif
 REGISTER_TESTS_END
 
 // LibraryType
@@ -49,4 +68,197 @@ void TestLibrary::LibraryType() const
     #undef TEST_LIBRARYTYPE
 }
 
+// UpdateInPlaceOptions
+//------------------------------------------------------------------------------
+void TestLibrary::UpdateInPlaceOptions() const
+{
+    const char * const bffFormat = "Compiler( 'Compiler' ) { .Executable = '/usr/bin/gcc' }\n"
+                                   "Library( 'Lib' )\n"
+                                   "{\n"
+                                   "    .Compiler               = 'Compiler'\n"
+                                   "    .CompilerOptions        = '-c %%1 -o %%2'\n"
+                                   "    .CompilerInputFiles     = 'File.c'\n"
+                                   "    .CompilerOutputPath     = 'Out/'\n"
+                                   "    .Librarian              = '/usr/bin/ar'\n"
+                                   "    .LibrarianOptions       = '%s %%2 %%1'\n"
+                                   "    .LibrarianOutput        = 'Out/lib.a'\n"
+                                   "    .LibrarianUpdateInPlace = true\n"
+                                   "}\n";
+
+    #define TEST_OPERATION( operation, expectedOK ) \
+    { \
+        AStackString< 1024 > bff; \
+        bff.Format( bffFormat, operation ); \
+        if ( expectedOK ) \
+        { \
+            TEST_PARSE_OK( bff.Get() ); \
+        } \
+        else \
+        { \
+            TEST_PARSE_FAIL( bff.Get(), "Error #1304" ); \
+        } \
+    }
+
+    TEST_OPERATION( "r",        true );
+    TEST_OPERATION( "rcs",      true );
+    TEST_OPERATION( "-rcsD",    true );
+    TEST_OPERATION( "qcs",      false ); // append
+    TEST_OPERATION( "rcsT",     false ); // thin
+    TEST_OPERATION( "cs",       false ); // no operation
+    TEST_OPERATION( "rab",      false ); // positioning needs another arg
+
+    #undef TEST_OPERATION
+}
+
+// ShardedArchive
+//------------------------------------------------------------------------------
+void TestLibrary::ShardedArchive() const
+{
+    MakeSources();
+
+    // Clean build
+    {
+        const FBuildStats stats = BuildArchive( "ShardsExe", false );
+        //               Seen,  Built,  Type
+        CheckStatsNode ( stats, 9,  9,  Node::OBJECT_NODE );
+        CheckStatsNode ( stats, 1,  1,  Node::LIBRARY_NODE );
+        CheckStatsNode ( stats, 1,  1,  Node::EXE_NODE );
+    }
+    CheckExeResult( "../tmp/Test/Library/Archives/Shards/exe", 36 );
+
+    // Output references the non-empty shards
+    AString output;
+    LoadFileContentsAsString( "../tmp/Test/Library/Archives/Shards/libShards.a", output );
+    TEST_ASSERT( output.Find( "GROUP(" ) );
+    Array< uint64_t > shardTimes;
+    for ( uint32_t i = 1; i <= 4; ++i )
+    {
+        AStackString<> shardName;
+        shardName.Format( "../tmp/Test/Library/Archives/Shards/libShards.shard%u.a", i );
+        shardTimes.Append( FileIO::GetFileLastWriteTime( shardName ) );
+        TEST_ASSERT( ( output.Find( shardName.FindLast( '/' ) + 1 ) != nullptr ) == ( shardTimes.Top() != 0 ) );
+    }
+
+    // No changes
+    {
+        const FBuildStats stats = BuildArchive( "ShardsExe", true );
+        CheckStatsNode ( stats, 1,  0,  Node::LIBRARY_NODE );
+        CheckStatsNode ( stats, 1,  0,  Node::EXE_NODE );
+    }
+
+    // Change one member, which only rebuilds the shard containing it
+    ChangeSource();
+    {
+        const FBuildStats stats = BuildArchive( "ShardsExe", true );
+        CheckStatsNode ( stats, 9,  1,  Node::OBJECT_NODE );
+        CheckStatsNode ( stats, 1,  1,  Node::LIBRARY_NODE );
+        CheckStatsNode ( stats, 1,  1,  Node::EXE_NODE );
+    }
+    CheckExeResult( "../tmp/Test/Library/Archives/Shards/exe", 63 );
+    uint32_t numShardsChanged = 0;
+    for ( uint32_t i = 1; i <= 4; ++i )
+    {
+        AStackString<> shardName;
+        shardName.Format( "../tmp/Test/Library/Archives/Shards/libShards.shard%u.a", i );
+        numShardsChanged += ( FileIO::GetFileLastWriteTime( shardName ) != shardTimes[ i - 1 ] ) ? 1 : 0;
+    }
+    TEST_ASSERT( numShardsChanged == 1 );
+}
+
+// UpdateInPlace
+//------------------------------------------------------------------------------
+void TestLibrary::UpdateInPlace() const
+{
+    MakeSources();
+
+    // Clean build
+    {
+        const FBuildStats stats = BuildArchive( "InPlaceExe", false );
+        CheckStatsNode ( stats, 1,  1,  Node::LIBRARY_NODE );
+    }
+    CheckExeResult( "../tmp/Test/Library/Archives/InPlace/exe", 36 );
+
+    // Change one member
+    ChangeSource();
+    {
+        const FBuildStats stats = BuildArchive( "InPlaceExe", true );
+        CheckStatsNode ( stats, 9,  1,  Node::OBJECT_NODE );
+        CheckStatsNode ( stats, 1,  1,  Node::LIBRARY_NODE );
+        CheckStatsNode ( stats, 1,  1,  Node::EXE_NODE );
+    }
+    CheckExeResult( "../tmp/Test/Library/Archives/InPlace/exe", 63 );
+
+    // Member was replaced, not added
+    Process p;
+    TEST_ASSERT( p.Spawn( "/usr/bin/ar", "t ../tmp/Test/Library/Archives/InPlace/libInPlace.a", nullptr, nullptr ) );
+    AString memOut;
+    AString memErr;
+    p.ReadAllData( memOut, memErr );
+    TEST_ASSERT( p.WaitForExit() == 0 );
+    Array< AString > members;
+    memOut.Tokenize( members, '\n' );
+    TEST_ASSERT( members.GetSize() == 8 );
+    TEST_ASSERT( memOut.Find( "File3.o" ) == memOut.FindLast( "File3.o" ) );
+}
+
+// MakeSources
+//------------------------------------------------------------------------------
+void TestLibrary::MakeSources() const
+{
+    TEST_ASSERT( FileIO::EnsurePathExists( AStackString<>( "../tmp/Test/Library/Archives/Src/Lib/" ) ) );
+
+    // main returns the sum of the library functions
+    AStackString< 1024 > main;
+    for ( uint32_t i = 1; i <= 8; ++i )
+    {
+        main.AppendFormat( "int Function%u( void );\n", i );
+
+        AStackString<> fileName;
+        AStackString<> contents;
+        fileName.Format( "../tmp/Test/Library/Archives/Src/Lib/File%u.c", i );
+        contents.Format( "int Function%u( void ) { return %u; }\n", i, i );
+        MakeFile( fileName.Get(), contents.Get() );
+    }
+    main += "int main( void ) { return Function1() + Function2() + Function3() + Function4() +\n"
+            "                          Function5() + Function6() + Function7() + Function8(); }\n";
+    MakeFile( "../tmp/Test/Library/Archives/Src/main.c", main.Get() );
+}
+
+// ChangeSource
+//------------------------------------------------------------------------------
+void TestLibrary::ChangeSource() const
+{
+    Thread::Sleep( 1000 ); // ensure the file time changes, regardless of file system resolution
+    MakeFile( "../tmp/Test/Library/Archives/Src/Lib/File3.c", "int Function3( void ) { return 30; }\n" );
+}
+
+// BuildArchive
+//------------------------------------------------------------------------------
+FBuildStats TestLibrary::BuildArchive( const char * target, bool useDB ) const
+{
+    FBuildTestOptions options;
+    options.m_ConfigFile = "Tools/FBuild/FBuildTest/Data/TestLibrary/Archives/fbuild.bff";
+    options.m_ShowSummary = true; // required to generate stats for node count checks
+    options.m_ForceCleanBuild = ( useDB == false );
+
+    AStackString<> dbFile;
+    dbFile.Format( "../tmp/Test/Library/Archives/%s.fdb", target );
+
+    FBuild fBuild( options );
+    TEST_ASSERT( fBuild.Initialize( useDB ? dbFile.Get() : nullptr ) );
+    TEST_ASSERT( fBuild.Build( target ) );
+    TEST_ASSERT( fBuild.SaveDependencyGraph( dbFile.Get() ) );
+
+    return fBuild.GetStats();
+}
+
+// CheckExeResult
+//------------------------------------------------------------------------------
+void TestLibrary::CheckExeResult( const char * exeName, int expectedResult ) const
+{
+    Process p;
+    TEST_ASSERT( p.Spawn( exeName, nullptr, nullptr, nullptr ) );
+    TEST_ASSERT( p.WaitForExit() == expectedResult );
+}
+
 //------------------------------------------------------------------------------
@@ -10,6 +10,7 @@
 #include "Tools/FBuild/FBuildCore/Graph/Dependencies.h"
 #include "Tools/FBuild/FBuildCore/Graph/LinkerNode.h"
 #include "Tools/FBuild/FBuildCore/Graph/NodeGraph.h"
+#include "Tools/FBuild/FBuildCore/Helpers/Args.h"
 
 // Core
 #include "Core/FileIO/FileIO.h"
@@ -27,7 +28,11 @@ private:
     void ArgHelpers_MSVC() const;
     void LibrariesOnCommandLine() const;
     void IncrementalLinking_MSVC() const;
+    void IncrementalLinkingFlags() const;
     void LinkerType() const;
+    void ChangedInputs() const;
+    void ChangedInputsArg() const;
+    void Migrate() const;
 };
 
 // Register Tests
@@ -39,7 +44,11 @@ REGISTER_TESTS_BEGIN( TestLinker )
     #if defined( __WINDOWS__ )
         REGISTER_TEST( IncrementalLinking_MSVC )
     #endif
+    REGISTER_TEST( IncrementalLinkingFlags )    // Detection of incremental linking from args
     REGISTER_TEST( LinkerType )                 // Test linker detection code
+    REGISTER_TEST( ChangedInputs )              // Detection of inputs changed since the last link
+    REGISTER_TEST( ChangedInputsArg )           // %4 substitution of changed inputs
+    REGISTER_TEST( Migrate )                    // State of the previous link is kept
 REGISTER_TESTS_END
 
 // ArgHelpers
@@ -315,6 +324,34 @@ void TestLinker::IncrementalLinking_MSVC() const
     #endif
 }
 
+// IncrementalLinkingFlags
+//------------------------------------------------------------------------------
+void TestLinker::IncrementalLinkingFlags() const
+{
+    #define TEST_INCREMENTAL( exeName, args, expected ) \
+    { \
+        const uint32_t flags = LinkerNode::DetermineFlags( AStackString<>( "auto" ), \
+                                                           AStackString<>( exeName ), \
+                                                           AStackString<>( args ) ); \
+        TEST_ASSERT( ( ( flags & LinkerNode::LINK_FLAG_INCREMENTAL ) != 0 ) == expected ); \
+    }
+
+    // MSVC
+    TEST_INCREMENTAL( "link", "%1 /OUT:%2",                         false );
+    TEST_INCREMENTAL( "link", "%1 /OUT:%2 /DEBUG",                  true );
+    TEST_INCREMENTAL( "link", "%1 /OUT:%2 /INCREMENTAL",            true );
+    TEST_INCREMENTAL( "link", "%1 /OUT:%2 /DEBUG /INCREMENTAL:NO",  false );
+    TEST_INCREMENTAL( "link", "%1 /OUT:%2 /DEBUG /OPT:REF",         false );
+
+    // gold
+    TEST_INCREMENTAL( "gcc",  "%1 -o %2",                           false );
+    TEST_INCREMENTAL( "gcc",  "%1 -o %2 -Wl,--incremental",         true );
+    TEST_INCREMENTAL( "gcc",  "%1 -o %2 -Wl,--no-incremental",      false );
+    TEST_INCREMENTAL( "ld",   "%1 -o %2 --incremental-update",      true );
+
+    #undef TEST_INCREMENTAL
+}
+
 // LinkerType
 //------------------------------------------------------------------------------
 void TestLinker::LinkerType() const
@@ -336,4 +373,117 @@ void TestLinker::LinkerType() const
     #undef TEST_LINKERTYPE
 }
 
+// ChangedInputs
+//------------------------------------------------------------------------------
+void TestLinker::ChangedInputs() const
+{
+    Array< LinkerInputStamp > previous;
+    previous.EmplaceBack( AStackString<>( "a.o" ), 1 );
+    previous.EmplaceBack( AStackString<>( "b.o" ), 2 );
+    previous.EmplaceBack( AStackString<>( "c.o" ), 3 );
+    previous.EmplaceBack( AStackString<>( "d.o" ), 4 );
+
+    // Nothing changed
+    {
+        Array< AString > changed;
+        TEST_ASSERT( LinkerInputStamp::FindChanged( previous, previous, changed ) == 4 );
+        TEST_ASSERT( changed.IsEmpty() );
+    }
+
+    // No previous link
+    {
+        Array< AString > changed;
+        TEST_ASSERT( LinkerInputStamp::FindChanged( Array< LinkerInputStamp >(), previous, changed ) == 0 );
+        TEST_ASSERT( changed.GetSize() == 4 );
+    }
+
+    // Reordered, with one removed, one added and one modified
+    {
+        Array< LinkerInputStamp > current;
+        current.EmplaceBack( AStackString<>( "d.o" ), 4 );
+        current.EmplaceBack( AStackString<>( "e.o" ), 5 );
+        current.EmplaceBack( AStackString<>( "a.o" ), 1 );
+        current.EmplaceBack( AStackString<>( "b.o" ), 6 );
+
+        Array< AString > changed;
+        TEST_ASSERT( LinkerInputStamp::FindChanged( previous, current, changed ) == 3 );
+        TEST_ASSERT( changed.GetSize() == 2 );
+        TEST_ASSERT( changed[ 0 ] == "e.o" );
+        TEST_ASSERT( changed[ 1 ] == "b.o" );
+    }
+
+    // Many inputs, all reordered
+    {
+        Array< LinkerInputStamp > many;
+        Array< LinkerInputStamp > reversed;
+        for ( uint32_t i = 0; i < 1000; ++i )
+        {
+            AStackString<> name;
+            name.Format( "file%u.o", i );
+            many.EmplaceBack( name, i );
+            name.Format( "file%u.o", ( 999 - i ) );
+            reversed.EmplaceBack( name, ( ( 999 - i ) == 500 ) ? 0 : ( 999 - i ) );
+        }
+
+        Array< AString > changed;
+        TEST_ASSERT( LinkerInputStamp::FindChanged( many, reversed, changed ) == 1000 );
+        TEST_ASSERT( changed.GetSize() == 1 );
+        TEST_ASSERT( changed[ 0 ] == "file500.o" );
+    }
+}
+
+// ChangedInputsArg
+//------------------------------------------------------------------------------
+void TestLinker::ChangedInputsArg() const
+{
+    FBuild fBuild; // needed for args finalization
+
+    LinkerNode node;
+    node.m_Name = "out.elf";
+    node.m_Linker = "ld";
+    node.m_LinkerOptions = "-o %2 --update=%4.tmp";
+    node.m_InputStamps.EmplaceBack( AStackString<>( "a.o" ), 1 );
+    node.m_InputStamps.EmplaceBack( AStackString<>( "b.o" ), 2 );
+
+    Array< LinkerInputStamp > current;
+    current.EmplaceBack( AStackString<>( "a.o" ), 1 );
+    current.EmplaceBack( AStackString<>( "b.o" ), 3 );
+    current.EmplaceBack( AStackString<>( "c.o" ), 4 );
+    node.DetermineChangedInputs( current );
+
+    Args fullArgs;
+    TEST_ASSERT( node.BuildArgs( fullArgs ) );
+    TEST_ASSERT( fullArgs.GetRawArgs().Find( "-o out.elf --update=b.o.tmp --update=c.o.tmp" ) );
+    TEST_ASSERT( fullArgs.GetRawArgs().Find( "a.o" ) == nullptr );
+
+    // Nothing changed
+    node.m_InputStamps = current;
+    node.DetermineChangedInputs( current );
+    Args unchangedArgs;
+    TEST_ASSERT( node.BuildArgs( unchangedArgs ) );
+    TEST_ASSERT( unchangedArgs.GetRawArgs().Find( "--update" ) == nullptr );
+}
+
+// Migrate
+//------------------------------------------------------------------------------
+void TestLinker::Migrate() const
+{
+    LinkerNode oldNode;
+    oldNode.m_InputStamps.EmplaceBack( AStackString<>( "a.o" ), 1 );
+    oldNode.m_InputStamps.EmplaceBack( AStackString<>( "b.o" ), 2 );
+    oldNode.m_FullLinkTimeMS = 1234;
+
+    LinkerNode newNode;
+    newNode.Migrate( oldNode );
+    TEST_ASSERT( newNode.m_InputStamps.GetSize() == 2 );
+    TEST_ASSERT( newNode.m_InputStamps[ 1 ].GetFileName() == "b.o" );
+    TEST_ASSERT( newNode.m_InputStamps[ 1 ].GetStamp() == 2 );
+    TEST_ASSERT( newNode.m_FullLinkTimeMS == 1234 );
+
+    // Unchanged inputs are not relinked after migration
+    Array< LinkerInputStamp > current( oldNode.m_InputStamps );
+    newNode.DetermineChangedInputs( current );
+    TEST_ASSERT( newNode.GetChangedInputs().IsEmpty() );
+}
+
 //------------------------------------------------------------------------------
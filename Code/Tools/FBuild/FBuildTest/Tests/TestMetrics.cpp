@@ -0,0 +1,111 @@
+// TestMetrics.cpp
+//------------------------------------------------------------------------------
+
+// Includes
+//------------------------------------------------------------------------------
+#include "FBuildTest.h"
+#include "Tools/FBuild/FBuildCore/FBuild.h"
+
+#include "Core/Network/TCPConnectionPool.h"
+#include "Core/Process/Semaphore.h"
+#include "Core/Strings/AStackString.h"
+
+// Defines
+//------------------------------------------------------------------------------
+// unique port for test in all configs so the tests can run in parallel
+#ifdef WIN64
+    #ifdef DEBUG
+        #define TEST_PORT uint16_t( 21951 ) // arbitrarily chosen
+    #else
+        #define TEST_PORT uint16_t( 22951 ) // arbitrarily chosen
+    #endif
+#else
+    #ifdef DEBUG
+        #define TEST_PORT uint16_t( 23951 ) // arbitrarily chosen
+    #else
+        #define TEST_PORT uint16_t( 24951 ) // arbitrarily chosen
+    #endif
+#endif
+
+// TestMetrics
+//------------------------------------------------------------------------------
+class TestMetrics : public FBuildTest
+{
+private:
+    DECLARE_TESTS
+
+    void Request() const;
+
+    // Helper functions
+    static void Get( const char * path, AString & outResponse );
+};
+
+// Register Tests
+//------------------------------------------------------------------------------
+REGISTER_TESTS_BEGIN( TestMetrics )
+    REGISTER_TEST( Request )
+REGISTER_TESTS_END
+
+// Request
+//------------------------------------------------------------------------------
+void TestMetrics::Request() const
+{
+    FBuildTestOptions options;
+    options.m_ConfigFile = "Tools/FBuild/FBuildTest/Data/TestCopy/copy.bff";
+    options.m_MetricsPort = TEST_PORT;
+    FBuild fBuild( options );
+    TEST_ASSERT( fBuild.Initialize() );
+
+    // build (via alias)
+    TEST_ASSERT( fBuild.Build( "TestCopyFileToFile" ) );
+
+    // metrics remain available until FBuild is destroyed
+    AString response;
+    Get( "/metrics", response );
+    TEST_ASSERT( response.BeginsWith( "HTTP/1.1 200 OK\r\n" ) );
+    TEST_ASSERT( response.Find( "Content-Type: application/json" ) );
+    TEST_ASSERT( response.Find( "\"status\":\"ok\"" ) );
+    TEST_ASSERT( response.Find( "\"failed\":0," ) );
+    TEST_ASSERT( response.Find( "\"threads\":[" ) );
+    TEST_ASSERT( response.EndsWith( "}\n" ) );
+
+    // unknown paths
+    Get( "/unknown", response );
+    TEST_ASSERT( response.BeginsWith( "HTTP/1.1 404 Not Found\r\n" ) );
+}
+
+// Get
+//------------------------------------------------------------------------------
+/*static*/ void TestMetrics::Get( const char * path, AString & outResponse )
+{
+    // a client which collects the response until the server disconnects
+    class TestClient : public TCPConnectionPool
+    {
+    public:
+        TestClient() { SetUnframed(); }
+        ~TestClient() { ShutdownAllConnections(); }
+        virtual void OnReceive( const ConnectionInfo *, void * data, uint32_t size, bool & )
+        {
+            m_Response.Append( (const char *)data, size );
+        }
+        virtual void OnDisconnected( const ConnectionInfo * )
+        {
+            m_Disconnected.Signal();
+        }
+        AString m_Response;
+        Semaphore m_Disconnected;
+    };
+
+    TestClient client;
+    const ConnectionInfo * ci = client.Connect( AStackString<>( "127.0.0.1" ), TEST_PORT );
+    TEST_ASSERT( ci );
+
+    AStackString<> request;
+    request.Format( "GET %s HTTP/1.1\r\nHost: localhost\r\n\r\n", path );
+    TEST_ASSERT( client.Send( ci, request.Get(), request.GetLength() ) );
+
+    client.m_Disconnected.Wait();
+    outResponse = client.m_Response;
+}
+
+//------------------------------------------------------------------------------
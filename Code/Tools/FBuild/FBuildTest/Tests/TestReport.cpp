@@ -0,0 +1,81 @@
+// TestReport.cpp
+//------------------------------------------------------------------------------
+
+// Includes
+//------------------------------------------------------------------------------
+#include "FBuildTest.h"
+
+// FBuildCore
+#include "Tools/FBuild/FBuildCore/Helpers/Report.h"
+
+// Core
+#include "Core/FileIO/FileIO.h"
+#include "Core/Strings/AStackString.h"
+
+// TestReport
+//------------------------------------------------------------------------------
+class TestReport : public FBuildTest
+{
+private:
+    DECLARE_TESTS
+
+    void IncludeCostFileName() const;
+    void Save() const;
+};
+
+// Register Tests
+//------------------------------------------------------------------------------
+REGISTER_TESTS_BEGIN( TestReport )
+    REGISTER_TEST( IncludeCostFileName )    // Include costs are written alongside the report
+    REGISTER_TEST( Save )
+REGISTER_TESTS_END
+
+// IncludeCostFileName
+//------------------------------------------------------------------------------
+void TestReport::IncludeCostFileName() const
+{
+    #define TEST_INCLUDECOST_FILENAME( reportFileName, expected ) \
+    { \
+        AStackString<> fileName; \
+        Report::GetIncludeCostFileName( AStackString<>( reportFileName ), fileName ); \
+        TEST_ASSERT( fileName == expected ); \
+    }
+
+    TEST_INCLUDECOST_FILENAME( "report.html",               "includecost.json" );
+    TEST_INCLUDECOST_FILENAME( "../tmp/report.html",        "../tmp/includecost.json" );
+    TEST_INCLUDECOST_FILENAME( "dir.ext/report",            "dir.ext/includecost.json" );
+    #if defined( __WINDOWS__ )
+        TEST_INCLUDECOST_FILENAME( "C:\\Build\\report.html",    "C:\\Build\\includecost.json" );
+        TEST_INCLUDECOST_FILENAME( "C:\\Build/Sub\\report.html","C:\\Build/Sub\\includecost.json" );
+    #else
+        TEST_INCLUDECOST_FILENAME( "/build/report.html",        "/build/includecost.json" );
+    #endif
+
+    #undef TEST_INCLUDECOST_FILENAME
+}
+
+// Save
+//------------------------------------------------------------------------------
+void TestReport::Save() const
+{
+    const char * const reportFile = "../tmp/Test/Report/Output/report.html";
+    const char * const includeCostFile = "../tmp/Test/Report/Output/includecost.json";
+
+    // clean up anything left over from previous runs
+    EnsureDirExists( "../tmp/Test/Report/Output/" );
+    FileIO::FileDelete( reportFile );
+    FileIO::FileDelete( includeCostFile );
+
+    // Save an empty report
+    const Report report;
+    report.Save( AStackString<>( reportFile ) );
+
+    // Both are written to the report location, not the working dir
+    EnsureFileExists( reportFile );
+    EnsureFileExists( includeCostFile );
+    AString json;
+    LoadFileContentsAsString( includeCostFile, json );
+    TEST_ASSERT( json.BeginsWith( '{' ) );
+}
+
+//------------------------------------------------------------------------------
@@ -16,6 +16,108 @@
 #include "Core/Process/Thread.h"
 #include "Core/Strings/AStackString.h"
 
+// UnityNodeTestHelper
+//------------------------------------------------------------------------------
+// Allows access to UnityNode sorting, partitioning and bucketing functionality
+class UnityNodeTestHelper : public UnityNode
+{
+public:
+    explicit UnityNodeTestHelper( uint32_t numUnityFiles = 1 )
+    {
+        m_NumUnityFilesToCreate = numUnityFiles;
+    }
+    ~UnityNodeTestHelper()
+    {
+        for ( FileIO::FileInfo * info : m_FileInfos )
+        {
+            FDELETE info;
+        }
+    }
+
+    void AddFile( const char * fileName, uint64_t sizeKB = 0 )
+    {
+        // Create dummy FileIO::FileInfo structure
+        FileIO::FileInfo * info = FNEW( FileIO::FileInfo );
+        info->m_Name = fileName;
+        #if defined( __WINDOWS__ )
+            info->m_Name.Replace( '/', '\\' ); // Allow test to specify unix style slashes
+        #endif
+        info->m_Size = ( sizeKB * KILOBYTE );
+        m_FileInfos.Append( info );
+
+        // Add entry
+        m_Files.EmplaceBack( info, nullptr );
+    }
+
+    void AddFiles( uint32_t first, uint32_t last, uint32_t skip = 0 )
+    {
+        for ( uint32_t i = first; i <= last; ++i )
+        {
+            if ( i == skip )
+            {
+                continue;
+            }
+            AStackString<> fileName;
+            fileName.Format( "File%u.cpp", i );
+            AddFile( fileName.Get() );
+        }
+    }
+
+    void Sort()
+    {
+        m_Files.Sort();
+        #if defined( __WINDOWS__ )
+            for ( FileIO::FileInfo * info : m_FileInfos )
+            {
+                info->m_Name.Replace( '\\', '/' ); // Allow test to specify unix style slashes
+            }
+        #endif
+    }
+
+    // Emulate the state persisted by a previous build
+    void AddPreviousFile( const char * fileName, uint32_t unityIndex, uint32_t costMS )
+    {
+        m_FileCosts.EmplaceBack( AStackString<>( fileName ), unityIndex, costMS );
+    }
+    void AddPreviousUnity( const char * unityFileName, uint32_t numFiles, uint32_t predictedMS, uint32_t measuredMS )
+    {
+        m_UnityFileCosts.EmplaceBack( AStackString<>( unityFileName ), numFiles, predictedMS );
+        m_MeasuredUnityCostsMS.Append( measuredMS );
+    }
+
+    void Partition()
+    {
+        m_Files.Sort();
+        Array< float > costs;
+        PartitionByCost( m_Files, costs, m_NumFilesPerUnity );
+    }
+
+    // Get a description of the files in each unity
+    void Assign( Array< AString > & outUnityContents )
+    {
+        m_Files.Sort();
+        Array< uint32_t > numFilesPerUnity;
+        AssignByHash( m_Files, numFilesPerUnity );
+        size_t index = 0;
+        for ( const uint32_t numFiles : numFilesPerUnity )
+        {
+            AStackString<> contents;
+            for ( uint32_t i = 0; i < numFiles; ++i )
+            {
+                contents += m_Files[ index++ ].GetName();
+                contents += ' ';
+            }
+            outUnityContents.Append( contents );
+        }
+    }
+
+    const AString & operator[] ( size_t index ) const { return m_Files[ index ].GetName(); }
+
+    Array< UnityNode::UnityFileAndOrigin >  m_Files;
+    Array< FileIO::FileInfo * >             m_FileInfos;
+    Array< uint32_t >                       m_NumFilesPerUnity;
+};
+
 // TestUnity
 //------------------------------------------------------------------------------
 class TestUnity : public FBuildTest
@@ -34,6 +136,7 @@ private:
     void TestGenerate_NoRebuild() const;
     void TestGenerate_NoRebuild_BFFChange() const;
     void DetectDeletedUnityFiles() const;
+    void OnlyChangedFilesWritten() const;
     void TestCompile() const;
     void TestCompile_NoRebuild() const;
     void TestCompile_NoRebuild_BFFChange() const;
@@ -48,6 +151,8 @@ private:
     void LinkMultiple_InputFiles() const;
     void SortFiles() const;
     void CacheUsingRelativePaths() const;
+    void BalanceByCost() const;
+    void BucketByHash() const;
 };
 
 // Register Tests
@@ -57,6 +162,7 @@ REGISTER_TESTS_BEGIN( TestUnity )
     REGISTER_TEST( TestGenerate_NoRebuild ) // check nothing rebuilds
     REGISTER_TEST( TestGenerate_NoRebuild_BFFChange ) // check nothing rebuilds after a BFF change
     REGISTER_TEST( DetectDeletedUnityFiles )
+    REGISTER_TEST( OnlyChangedFilesWritten ) // check unchanged unity files are not rewritten
     REGISTER_TEST( TestCompile )            // compile a library using unity inputs
     REGISTER_TEST( TestCompile_NoRebuild )  // check nothing rebuilds
     REGISTER_TEST( TestCompile_NoRebuild_BFFChange )  // check nothing rebuilds after a BFF change
@@ -71,6 +177,8 @@ REGISTER_TESTS_BEGIN( TestUnity )
     REGISTER_TEST( LinkMultiple_InputFiles )
     REGISTER_TEST( SortFiles )
     REGISTER_TEST( CacheUsingRelativePaths )
+    REGISTER_TEST( BalanceByCost )
+    REGISTER_TEST( BucketByHash )
 REGISTER_TESTS_END
 
 // BuildGenerate
@@ -226,6 +334,43 @@ void TestUnity::DetectDeletedUnityFiles() const
     CheckStatsTotal( stats, 2,      2 );
 }
 
+// OnlyChangedFilesWritten
+//------------------------------------------------------------------------------
+void TestUnity::OnlyChangedFilesWritten() const
+{
+    // When a Unity is rebuilt, only the unity files which changed should be written
+    AStackString<> unity1( "../tmp/Test/Unity/Unity1.cpp" );
+    AStackString<> unity2( "../tmp/Test/Unity/Unity2.cpp" );
+
+    // Build
+    FBuildTestOptions options;
+    BuildGenerate( options, false ); // don't load DB
+    EnsureFileExists( unity1 );
+    EnsureFileExists( unity2 );
+
+    // Delete one of the generated files to force the Unity to rebuild
+    EnsureFileDoesNotExist( unity2 );
+    const uint64_t dateTime1 = FileIO::GetFileLastWriteTime( unity1 );
+
+    // Sleep long enough to ensure an invalid write would modify the time
+    #if defined( __WINDOWS__ )
+        Thread::Sleep( 1 ); // 1ms
+    #else
+        Thread::Sleep( 1000 ); // Work around low time resolution of some file systems
+    #endif
+
+    // Build again
+    FBuildStats stats = BuildGenerate( options, true ); // load DB
+
+    // Only the missing file should have been written
+    EnsureFileExists( unity2 );
+    TEST_ASSERT( dateTime1 == FileIO::GetFileLastWriteTime( unity1 ) );
+
+    // Check stats
+    //                      Seen,   Built,  Type
+    CheckStatsNode ( stats, 1,      1,      Node::UNITY_NODE );
+}
+
 // BuildCompile
 //------------------------------------------------------------------------------
 FBuildStats TestUnity::BuildCompile( FBuildTestOptions options, bool useDB, bool forceMigration ) const
@@ -724,54 +869,11 @@ void TestUnity::SortFiles() const
     //  - case insensitive (consistent regardless of file system or OS)
     //  - files before directories
 
-    // Helper which allows access to UnityNode sorting functionality
-    class Helper : public UnityNode
-    {
-    public:
-        ~Helper()
-        {
-            for ( FileIO::FileInfo * info : m_FileInfos )
-            {
-                FDELETE info;
-            }
-        }
-
-        void AddFile( const char * fileName )
-        {
-            // Create dummy FileIO::FileInfo structure
-            FileIO::FileInfo * info = FNEW( FileIO::FileInfo );
-            info->m_Name = fileName; // Only the name is important
-            #if defined( __WINDOWS__ )
-                info->m_Name.Replace( '/', '\\' ); // Allow test to specify unix style slashes
-            #endif
-            m_FileInfos.Append( info );
-
-            // Add entry
-            m_Files.EmplaceBack( info, nullptr );
-        }
-
-        void Sort()
-        {
-            m_Files.Sort();
-            #if defined( __WINDOWS__ )
-                for ( FileIO::FileInfo * info : m_FileInfos )
-                {
-                    info->m_Name.Replace( '\\', '/' ); // Allow test to specify unix style slashes
-                }
-            #endif
-        }
-
-        const AString & operator[] ( size_t index ) const { return m_Files[ index ].GetName(); }
-
-        Array< UnityNode::UnityFileAndOrigin >  m_Files;
-        Array< FileIO::FileInfo * >             m_FileInfos;
-    };
-
     // Helper marcos to reduce boilerplate code
     #define SORT( ... )                                                         \
     {                                                                           \
         const char * inputs[] = { __VA_ARGS__ };                                \
-        Helper h;                                                               \
+        UnityNodeTestHelper h;                                                  \
         for ( const char * input : inputs )                                     \
         {                                                                       \
             h.AddFile( input );                                                 \
@@ -958,4 +1060,92 @@ void TestUnity::CacheUsingRelativePaths() const
 
 }
 
+// BalanceByCost
+//------------------------------------------------------------------------------
+void TestUnity::BalanceByCost() const
+{
+    // Files without history are balanced by size
+    {
+        UnityNodeTestHelper h( 2 );
+        h.AddFile( "a.cpp", 1 );
+        h.AddFile( "b.cpp", 1 );
+        h.AddFile( "c.cpp", 1 );
+        h.AddFile( "d.cpp", 1 );
+        h.AddFile( "e.cpp", 4 );
+        h.Partition();
+        TEST_ASSERT( h.m_NumFilesPerUnity.GetSize() == 2 );
+        TEST_ASSERT( h.m_NumFilesPerUnity[ 0 ] == 4 );
+        TEST_ASSERT( h.m_NumFilesPerUnity[ 1 ] == 1 );
+    }
+
+    // Measured build times which deviate too far from the prediction cause a rebalance
+    {
+        UnityNodeTestHelper h( 2 );
+        const char * files[] = { "a.cpp", "b.cpp", "c.cpp", "d.cpp", "e.cpp", "f.cpp" };
+        for ( size_t i = 0; i < 6; ++i )
+        {
+            h.AddFile( files[ i ], 10 );
+            h.AddPreviousFile( files[ i ], ( i < 3 ) ? 0 : 1, 100 );
+        }
+        h.AddPreviousUnity( "Unity1.cpp", 3, 300, 900 );
+        h.AddPreviousUnity( "Unity2.cpp", 3, 300, 300 );
+        h.Partition();
+        TEST_ASSERT( h.m_NumFilesPerUnity[ 0 ] == 2 );
+        TEST_ASSERT( h.m_NumFilesPerUnity[ 1 ] == 4 );
+    }
+
+    // Small deviations keep the previous partitioning, with new files joining the
+    // unity of the file before them
+    {
+        UnityNodeTestHelper h( 2 );
+        const char * files[] = { "a.cpp", "b.cpp", "c.cpp", "d.cpp", "e.cpp", "f.cpp" };
+        for ( size_t i = 0; i < 6; ++i )
+        {
+            h.AddFile( files[ i ], 10 );
+            h.AddPreviousFile( files[ i ], ( i < 3 ) ? 0 : 1, 100 );
+        }
+        h.AddFile( "g.cpp", 10 );
+        h.AddPreviousUnity( "Unity1.cpp", 3, 300, 330 );
+        h.AddPreviousUnity( "Unity2.cpp", 3, 300, 300 );
+        h.Partition();
+        TEST_ASSERT( h.m_NumFilesPerUnity[ 0 ] == 3 );
+        TEST_ASSERT( h.m_NumFilesPerUnity[ 1 ] == 4 );
+    }
+}
+
+// BucketByHash
+//------------------------------------------------------------------------------
+void TestUnity::BucketByHash() const
+{
+    FBuildTestOptions options;
+    FBuild fBuild( options ); // Provides working dir
+
+    Array< AString > before;
+    {
+        UnityNodeTestHelper h( 8 );
+        h.AddFiles( 1, 40 );
+        h.Assign( before );
+    }
+
+    // Adding one file and removing another should change at most 2 unity files
+    Array< AString > after;
+    {
+        UnityNodeTestHelper h( 8 );
+        h.AddFiles( 1, 41, 7 );
+        h.Assign( after );
+    }
+
+    TEST_ASSERT( before.GetSize() == 8 );
+    TEST_ASSERT( after.GetSize() == 8 );
+    size_t numChanged = 0;
+    for ( size_t i = 0; i < 8; ++i )
+    {
+        numChanged += ( before[ i ] == after[ i ] ) ? 0 : 1;
+
+        // Bounded to 25% more files than an even split
+        TEST_ASSERT( before[ i ].GetLength() <= ( 7 * sizeof( "File00.cpp" ) ) );
+    }
+    TEST_ASSERT( numChanged <= 2 );
+}
+
 //------------------------------------------------------------------------------
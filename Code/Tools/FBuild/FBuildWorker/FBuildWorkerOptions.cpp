@@ -7,6 +7,7 @@
 
 // FBuildCore
 #include "Tools/FBuild/FBuildCore/FBuildVersion.h"
+#include "Tools/FBuild/FBuildCore/Protocol/Protocol.h"
 
 // Core
 #include "Core/Containers/Array.h"
@@ -31,6 +32,7 @@ FBuildWorkerOptions::FBuildWorkerOptions() :
     m_OverrideWorkMode( false ),
     m_WorkMode( WorkerSettings::WHEN_IDLE ),
     m_MinimumFreeMemoryMiB( 0 ),
+    m_Port( Protocol::PROTOCOL_PORT ),
     m_ConsoleMode( false )
 {
     #ifdef __LINUX__
@@ -116,6 +118,18 @@ bool FBuildWorkerOptions::ProcessCommandLine( const AString & commandLine )
             m_OverrideWorkMode = true;
             continue;
         }
+        else if ( token.BeginsWith( "-port=" ) )
+        {
+            uint32_t num( 0 );
+            PRAGMA_DISABLE_PUSH_MSVC( 4996 ) // This function or variable may be unsafe...
+            if ( ( sscanf( token.Get() + 6, "%u", &num ) == 1 ) && ( num > 0 ) && ( num <= 0xFFFF ) ) // TODO:C consider sscanf_s
+            PRAGMA_DISABLE_POP_MSVC // 4996
+            {
+                m_Port = (uint16_t)num;
+                continue;
+            }
+            // problem... fall through
+        }
         #if defined( __WINDOWS__ )
             else if ( token.BeginsWith( "-minfreememory=" ) )
             {
@@ -179,6 +193,9 @@ void FBuildWorkerOptions::ShowUsageError()
                        "        Set minimum free memory (MiB) required to accept work.\n"
                        " -nosubprocess\n"
                        "        (Windows) Don't spawn a sub-process worker copy.\n"
+                       " -port=<n>\n"
+                       "        Listen on a non-default port. Clients must list the worker\n"
+                       "        as host:port, as it is not advertised via the brokerage.\n"
                        "---------------------------------------------------------------------------\n"
                        ;
 
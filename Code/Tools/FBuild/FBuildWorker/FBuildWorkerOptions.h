@@ -36,6 +36,9 @@ public:
     WorkerSettings::Mode m_WorkMode;
     uint32_t m_MinimumFreeMemoryMiB; // Minimum OS free memory including virtual memory to let worker do its work
 
+    // Network
+    uint16_t m_Port; // non-default ports allow several workers per machine
+
     // Console mode
     bool m_ConsoleMode;
 
@@ -8,6 +8,9 @@
 #include "Tools/FBuild/FBuildWorker/FBuildWorkerOptions.h"
 #include "Tools/FBuild/FBuildWorker/Worker/Worker.h"
 
+// FBuildCore
+#include "Tools/FBuild/FBuildCore/Protocol/Protocol.h"
+
 // Core
 #include "Core/Env/Assert.h"
 #include "Core/Env/Env.h"
@@ -33,7 +36,7 @@ SystemMutex g_OneProcessMutex( "Global\\FBuildWorker" );
 //------------------------------------------------------------------------------
 int MainCommon( const AString & args );
 #if defined( __WINDOWS__ )
-    int LaunchSubProcess( const AString & args );
+    int LaunchSubProcess( const AString & args, SystemMutex & oneProcessMutex );
 #endif
 
 //------------------------------------------------------------------------------
@@ -81,9 +84,13 @@ int MainCommon( const AString & args )
         return -3;
     }
 
-    // only allow 1 worker per system
+    // only allow 1 worker per system (or per port, when using a non-default port)
+    AStackString<> portMutexName;
+    portMutexName.Format( "Global\\FBuildWorker_%u", options.m_Port );
+    SystemMutex portMutex( portMutexName.Get() );
+    SystemMutex & oneProcessMutex = ( options.m_Port == Protocol::PROTOCOL_PORT ) ? g_OneProcessMutex : portMutex;
     Timer t;
-    while ( g_OneProcessMutex.TryLock() == false )
+    while ( oneProcessMutex.TryLock() == false )
     {
         // retry for upto 2 seconds, to allow some time for old worker to close
         if ( t.GetElapsed() > 5.0f )
@@ -97,7 +104,7 @@ int MainCommon( const AString & args )
     #if defined( __WINDOWS__ )
         if ( options.m_UseSubprocess && !options.m_IsSubprocess )
         {
-            return LaunchSubProcess( args );
+            return LaunchSubProcess( args, oneProcessMutex );
         }
     #endif
 
@@ -119,7 +126,7 @@ int MainCommon( const AString & args )
     // start the worker and wait for it to be closed
     int ret;
     {
-        Worker worker( args, options.m_ConsoleMode );
+        Worker worker( args, options.m_ConsoleMode, options.m_Port );
         if ( options.m_OverrideCPUAllocation )
         {
             WorkerSettings::Get().SetNumCPUsToUse( options.m_CPUAllocation );
@@ -141,7 +148,7 @@ int MainCommon( const AString & args )
 // LaunchSubProcess
 //------------------------------------------------------------------------------
 #if defined( __WINDOWS__ )
-    int LaunchSubProcess( const AString & args )
+    int LaunchSubProcess( const AString & args, SystemMutex & oneProcessMutex )
     {
         // try to make a copy of our exe
         AStackString<> exeName;
@@ -165,7 +172,7 @@ int MainCommon( const AString & args )
         argsCopy += " -subprocess";
 
         // allow subprocess to access the mutex
-        g_OneProcessMutex.Unlock();
+        oneProcessMutex.Unlock();
 
         Process p;
         #if defined( __WINDOWS__ )
@@ -40,8 +40,9 @@
 
 // CONSTRUCTOR
 //------------------------------------------------------------------------------
-Worker::Worker( const AString & args, bool consoleMode )
+Worker::Worker( const AString & args, bool consoleMode, uint16_t port )
     : m_ConsoleMode( consoleMode )
+    , m_Port( port )
     , m_MainWindow( nullptr )
     , m_ConnectionPool( nullptr )
     , m_NetworkStartupHelper( nullptr )
@@ -158,10 +159,10 @@ uint32_t Worker::WorkThread()
     StatusMessage( "FBuildWorker %s", FBUILD_VERSION_STRING );
 
     // start listening
-    StatusMessage( "Listening on port %u\n", Protocol::PROTOCOL_PORT );
-    if ( m_ConnectionPool->Listen( Protocol::PROTOCOL_PORT ) == false )
+    StatusMessage( "Listening on port %u\n", m_Port );
+    if ( m_ConnectionPool->Listen( m_Port ) == false )
     {
-        ErrorMessage( "Failed to listen on port %u.  Check port is not in use.", Protocol::PROTOCOL_PORT );
+        ErrorMessage( "Failed to listen on port %u.  Check port is not in use.", m_Port );
         return (uint32_t)-1;
     }
 
@@ -358,7 +359,9 @@ void Worker::UpdateAvailability()
 
     WorkerThreadRemote::SetNumCPUsToUse( numCPUsToUse );
 
-    m_WorkerBrokerage.SetAvailability( numCPUsToUse > 0 );
+    // Clients only find workers on the default port via the brokerage
+    const bool advertise = ( m_Port == Protocol::PROTOCOL_PORT );
+    m_WorkerBrokerage.SetAvailability( advertise && ( numCPUsToUse > 0 ) );
 }
 
 // UpdateUI
@@ -27,7 +27,7 @@ class WorkerSettings;
 class Worker
 {
 public:
-    explicit Worker( const AString & args, bool consoleMode );
+    explicit Worker( const AString & args, bool consoleMode, uint16_t port );
     ~Worker();
 
     int32_t Work();
@@ -48,6 +48,7 @@ private:
     void ErrorMessage( MSVC_SAL_PRINTF const char * fmtString, ... ) const FORMAT_STRING( 2, 3 );
 
     bool                m_ConsoleMode;
+    uint16_t            m_Port;
     WorkerWindow        * m_MainWindow;
     Server              * m_ConnectionPool;
     NetworkStartupHelper * m_NetworkStartupHelper;